@@ -108,6 +108,21 @@
 #define DB_CTCONF_SETTING_FEATURE_CREATE_TABLE 1
 #endif
 
+/**
+@brief		If @c 1, relation files are memory mapped while they are
+		scanned, so tuples are copied out of the mapping rather than
+		read through the storage layer.  Only available on POSIX
+		systems using the standard target.
+*/
+#ifndef DB_CTCONF_SETTING_FEATURE_MMAP
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_STD && \
+    (defined(__unix__) || defined(__APPLE__))
+#define DB_CTCONF_SETTING_FEATURE_MMAP 1
+#else
+#define DB_CTCONF_SETTING_FEATURE_MMAP 0
+#endif
+#endif
+
 /**
 @brief		If this is equal to @c 1, error messages will be displayed
 		appropriately.
@@ -131,6 +146,84 @@
 #ifndef DB_CTCONF_SETTING_MAXSTRINGLENGTH
 #define DB_CTCONF_SETTING_MAXSTRINGLENGTH 200
 #endif
+
+/**
+@brief		The number of bytes of query memory that operators sizing
+		their buffers from free memory (sorts, hash joins) leave
+		unused, so that expressions can still be evaluated while they
+		run.
+*/
+#ifndef DB_CTCONF_SETTING_OPERATOR_RESERVE
+#define DB_CTCONF_SETTING_OPERATOR_RESERVE 128
+#endif
+
+/**
+@brief		The most tuples moved between operators in one batch.  Fewer
+		are moved when there is too little free query memory.
+*/
+#ifndef DB_CTCONF_SETTING_BATCH_SIZE
+#define DB_CTCONF_SETTING_BATCH_SIZE 16
+#endif
+
+/**
+@brief		The number of file pages the storage layer's buffer pool keeps
+		in memory.  Pages stay cached across queries.  If @c 0, files
+		are read and written directly.
+*/
+#ifndef DB_CTCONF_SETTING_BUFFERPOOL_PAGES
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_STD
+#define DB_CTCONF_SETTING_BUFFERPOOL_PAGES 16
+#else
+#define DB_CTCONF_SETTING_BUFFERPOOL_PAGES 0
+#endif
+#endif
+
+/**
+@brief		The number of bytes in each page of the buffer pool.
+*/
+#ifndef DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE
+#define DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE 512
+#endif
+
+/**
+@brief		The most open files whose reads and writes go through the
+		buffer pool at once.  Files opened beyond this are read and
+		written directly.
+*/
+#ifndef DB_CTCONF_SETTING_BUFFERPOOL_MAXFILES
+#define DB_CTCONF_SETTING_BUFFERPOOL_MAXFILES 8
+#endif
+
+/**
+@brief		The longest file name, including the null-byte, whose pages
+		can be kept in the buffer pool.
+*/
+#ifndef DB_CTCONF_SETTING_BUFFERPOOL_NAMELENGTH
+#define DB_CTCONF_SETTING_BUFFERPOOL_NAMELENGTH 32
+#endif
+
+/**
+@brief		The number of bytes in each page of a B+tree index.  Each node
+		of the tree fills one page, and updating the tree needs about
+		two pages of query memory.
+*/
+#ifndef DB_CTCONF_SETTING_INDEX_PAGESIZE
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_STD
+#define DB_CTCONF_SETTING_INDEX_PAGESIZE 512
+#else
+#define DB_CTCONF_SETTING_INDEX_PAGESIZE 128
+#endif
+#endif
+
+/**
+@brief		The most bytes in the key of a B+tree, skip list or hash index.
+		String keys are as wide as their attribute, so an index can
+		only be made on a string attribute no wider than this.  Each
+		index cursor holds two keys this wide.
+*/
+#ifndef DB_CTCONF_SETTING_INDEX_MAXKEYSIZE
+#define DB_CTCONF_SETTING_INDEX_MAXKEYSIZE 16
+#endif
 /******************************************************************************/
 
 #define USE_DELETE_FUNCTIONAL 1
@@ -0,0 +1,491 @@
+/******************************************************************************/
+/**
+@file		btree.c
+@author		Graeme Douglas
+@brief		A disk-resident B+tree mapping fixed-width keys to tuple
+		offsets.
+@see		For more information, please refer to @ref btree.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "btree.h"
+#include <string.h>
+
+/* Where the header starts, just after the index's type. */
+#define BTREE_HEADER_OFFSET 1
+
+/* The most levels a tree may have. */
+#define BTREE_MAXDEPTH 32
+
+/* The number of bytes an entry takes, given the width of what follows its
+   value. */
+#define BTREE_ENTRYSIZE(width) (sizeof(long) + (size_t)(width))
+
+/* The tree's header, at the start of the first page. */
+typedef struct {
+  db_int pagesize;    /* The number of bytes in each page. */
+  db_uint8 keysize;   /* The number of bytes in each key. */
+  db_int payloadsize; /* The number of bytes stored after each key in the
+                         leaves. */
+  long root;          /* The page of the root node. */
+  long numpages;      /* The number of pages, including the header's. */
+  long numentries;    /* The number of entries in the leaves. */
+} btree_header_t;
+
+/* The start of every node. */
+typedef struct {
+  db_int count;      /* The number of entries in the node. */
+  db_uint8 isleaf;   /* 1 if the node is a leaf, 0 otherwise. */
+  long link;         /* For a leaf, the page of the next leaf, or 0 if
+                        it is the last.  Otherwise, the page of the child
+                        holding keys before the first entry's. */
+} btree_nodehead_t;
+
+/* Each entry of a node is a value followed by a key, packed one after the
+   other.  In a leaf, the value is a tuple offset, and the key is followed by
+   the entry's payload.  Otherwise, the value is the page of the child
+   holding keys from this entry's up to the next entry's. */
+
+/* Find how many bytes each entry of a leaf or inner node takes. */
+static size_t btree_entrysize(btree_header_t *headerp, db_uint8 isleaf) {
+  return BTREE_ENTRYSIZE((db_int)(headerp->keysize) +
+                         (isleaf ? headerp->payloadsize : 0));
+}
+
+/* Find how many entries of some size fit in a page. */
+static db_int btree_capacity(db_int pagesize, size_t entrysize) {
+  return (pagesize - (db_int)sizeof(btree_nodehead_t)) / (db_int)entrysize;
+}
+
+/* Find how many bytes a node's entries may take, with room for one more
+   entry than fits. */
+static size_t btree_nodebytes(btree_header_t *headerp) {
+  return (size_t)(headerp->pagesize - (db_int)sizeof(btree_nodehead_t)) +
+         btree_entrysize(headerp, 1);
+}
+
+/* Find where an entry of a node is. */
+static unsigned char *btree_entry(unsigned char *entries, size_t entrysize,
+                                  db_int i) {
+  return entries + (size_t)i * entrysize;
+}
+
+static long btree_getvalue(unsigned char *entryp) {
+  long value;
+  memcpy(&value, entryp, sizeof(long));
+  return value;
+}
+
+static void btree_setentry(unsigned char *entryp, size_t entrysize,
+                           unsigned char *key, long value) {
+  memcpy(entryp, &value, sizeof(long));
+  memcpy(entryp + sizeof(long), key, entrysize - sizeof(long));
+}
+
+/* Compare an entry's key to a key. */
+static int btree_cmpkey(unsigned char *entryp, db_uint8 keysize,
+                        unsigned char *key) {
+  return memcmp(entryp + sizeof(long), key, (size_t)keysize);
+}
+
+/* Move a file's position to some offset from its start. */
+static void btree_seekto(db_fileref_t f, long offset) {
+  db_filerewind(f);
+  db_fileseek(f, (size_t)offset);
+}
+
+/* Write zeroes up to the end of a page. */
+static db_int btree_pad(db_fileref_t f, db_int numbytes) {
+  unsigned char zeroes[16];
+  db_int towrite;
+  memset(zeroes, 0, sizeof(zeroes));
+  while (numbytes > 0) {
+    towrite = numbytes < (db_int)sizeof(zeroes) ? numbytes
+                                                : (db_int)sizeof(zeroes);
+    if ((size_t)towrite != db_filewrite(f, zeroes, (size_t)towrite))
+      return 0;
+    numbytes -= towrite;
+  }
+  return 1;
+}
+
+static db_int btree_readheader(db_fileref_t f, btree_header_t *headerp) {
+  btree_seekto(f, BTREE_HEADER_OFFSET);
+  return sizeof(btree_header_t) ==
+             db_fileread(f, (unsigned char *)headerp,
+                         sizeof(btree_header_t)) &&
+         headerp->keysize > 0 &&
+         headerp->keysize <= DB_CTCONF_SETTING_INDEX_MAXKEYSIZE &&
+         headerp->payloadsize >= 0;
+}
+
+static db_int btree_writeheader(db_fileref_t f, btree_header_t *headerp) {
+  btree_seekto(f, BTREE_HEADER_OFFSET);
+  return sizeof(btree_header_t) ==
+         db_filewrite(f, headerp, sizeof(btree_header_t));
+}
+
+/* Read the head of a node. */
+static db_int btree_readhead(db_fileref_t f, db_int pagesize, long page,
+                             btree_nodehead_t *headp) {
+  btree_seekto(f, page * pagesize);
+  return sizeof(btree_nodehead_t) ==
+         db_fileread(f, (unsigned char *)headp, sizeof(btree_nodehead_t));
+}
+
+/* Read a node. */
+static db_int btree_readnode(db_fileref_t f, btree_header_t *headerp,
+                             long page, btree_nodehead_t *headp,
+                             unsigned char *entries) {
+  size_t size;
+  if (1 != btree_readhead(f, headerp->pagesize, page, headp))
+    return 0;
+  if (0 == headp->count)
+    return 1;
+  size = (size_t)headp->count * btree_entrysize(headerp, headp->isleaf);
+  return size == db_fileread(f, entries, size);
+}
+
+/* Write a node, filling the rest of its page. */
+static db_int btree_writenode(db_fileref_t f, btree_header_t *headerp,
+                              long page, btree_nodehead_t *headp,
+                              unsigned char *entries) {
+  size_t size =
+      (size_t)headp->count * btree_entrysize(headerp, headp->isleaf);
+  btree_seekto(f, page * headerp->pagesize);
+  if (sizeof(btree_nodehead_t) !=
+          db_filewrite(f, headp, sizeof(btree_nodehead_t)) ||
+      (size > 0 && size != db_filewrite(f, entries, size)))
+    return 0;
+  return btree_pad(f, headerp->pagesize - (db_int)sizeof(btree_nodehead_t) -
+                          (db_int)size);
+}
+
+/* Find the first entry whose key is bigger than a key, or, if strict is 0,
+   at least as big. */
+static db_int btree_bound(unsigned char *entries, size_t entrysize,
+                          db_uint8 keysize, db_int count, unsigned char *key,
+                          db_uint8 strict) {
+  db_int imin = 0, imax = count, imid, result;
+  while (imin < imax) {
+    imid = imin + (imax - imin) / 2;
+    result = btree_cmpkey(btree_entry(entries, entrysize, imid), keysize, key);
+    if (result < 0 || (strict && 0 == result))
+      imin = imid + 1;
+    else
+      imax = imid;
+  }
+  return imin;
+}
+
+/* Find the child of an inner node a key is under, given the key's bound. */
+static long btree_child(btree_nodehead_t *headp, unsigned char *entries,
+                        size_t entrysize, db_int i) {
+  return 0 == i ? headp->link
+                : btree_getvalue(btree_entry(entries, entrysize, i - 1));
+}
+
+db_int btree_create(db_fileref_t f, db_int pagesize, db_uint8 keysize,
+                    db_int payloadsize) {
+  btree_header_t header;
+  btree_nodehead_t head;
+
+  memset(&header, 0, sizeof(header));
+  header.pagesize = pagesize;
+  header.keysize = keysize;
+  header.payloadsize = payloadsize;
+  if (0 == keysize || keysize > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE ||
+      payloadsize < 0 ||
+      btree_capacity(pagesize, btree_entrysize(&header, 1)) < 3 ||
+      pagesize < BTREE_HEADER_OFFSET + (db_int)sizeof(btree_header_t))
+    return 0;
+
+  header.root = 1;
+  header.numpages = 2;
+  header.numentries = 0;
+  if (sizeof(btree_header_t) != db_filewrite(f, &header, sizeof(header)) ||
+      1 != btree_pad(f, pagesize - BTREE_HEADER_OFFSET -
+                            (db_int)sizeof(btree_header_t)))
+    return 0;
+
+  head.count = 0;
+  head.isleaf = 1;
+  head.link = 0;
+  return btree_writenode(f, &header, 1, &head, NULL);
+}
+
+/* Add an entry to a tree, using space for one more entry than a node holds
+   to split nodes that overflow. */
+static db_int btree_insertinto(db_fileref_t f, btree_header_t *headerp,
+                               unsigned char *entries, unsigned char *key,
+                               long value) {
+  btree_nodehead_t head, righthead;
+  unsigned char separator[DB_CTCONF_SETTING_INDEX_MAXKEYSIZE];
+  long path[BTREE_MAXDEPTH];
+  long page, newpage;
+  db_int depth = 0, i, mid;
+  db_uint8 keysize = headerp->keysize, islast = 1;
+  size_t entrysize;
+
+  /* Find the leaf, remembering the way down.  Equal keys go after those
+     already there. */
+  page = headerp->root;
+  while (1) {
+    if (1 != btree_readnode(f, headerp, page, &head, entries))
+      return 0;
+    entrysize = btree_entrysize(headerp, head.isleaf);
+    if (head.count > btree_capacity(headerp->pagesize, entrysize))
+      return 0;
+    if (head.isleaf)
+      break;
+    if (BTREE_MAXDEPTH == depth)
+      return 0;
+    path[depth++] = page;
+    i = btree_bound(entries, entrysize, keysize, head.count, key, 1);
+    islast = islast && i == head.count;
+    page = btree_child(&head, entries, entrysize, i);
+  }
+
+  while (1) {
+    entrysize = btree_entrysize(headerp, head.isleaf);
+    i = btree_bound(entries, entrysize, keysize, head.count, key, 1);
+    islast = islast && i == head.count;
+    memmove(btree_entry(entries, entrysize, i + 1),
+            btree_entry(entries, entrysize, i),
+            (size_t)(head.count - i) * entrysize);
+    btree_setentry(btree_entry(entries, entrysize, i), entrysize, key, value);
+    head.count++;
+
+    if (head.count <= btree_capacity(headerp->pagesize, entrysize))
+      return btree_writenode(f, headerp, page, &head, entries);
+
+    /* Split the node, moving its upper half to a new page.  An entry after
+       every other in the tree, as when keys are loaded in order, only moves
+       itself, so the pages left behind stay full. */
+    newpage = headerp->numpages++;
+    if (islast)
+      mid = head.isleaf ? head.count - 1 : head.count - 2;
+    else
+      mid = head.count / 2;
+    righthead.isleaf = head.isleaf;
+    memcpy(separator, btree_entry(entries, entrysize, mid) + sizeof(long),
+           (size_t)keysize);
+    key = separator;
+    if (head.isleaf) {
+      righthead.count = head.count - mid;
+      righthead.link = head.link;
+      head.link = newpage;
+      if (1 != btree_writenode(f, headerp, newpage, &righthead,
+                               btree_entry(entries, entrysize, mid)))
+        return 0;
+    } else {
+      /* The middle entry moves up, and its child starts the new node. */
+      righthead.count = head.count - mid - 1;
+      righthead.link = btree_getvalue(btree_entry(entries, entrysize, mid));
+      if (1 != btree_writenode(f, headerp, newpage, &righthead,
+                               btree_entry(entries, entrysize, mid + 1)))
+        return 0;
+    }
+    head.count = mid;
+    if (1 != btree_writenode(f, headerp, page, &head, entries))
+      return 0;
+    value = newpage;
+
+    if (0 == depth) {
+      /* The root was split, so the tree grows a level. */
+      head.count = 1;
+      head.isleaf = 0;
+      head.link = page;
+      btree_setentry(entries, btree_entrysize(headerp, 0), key, value);
+      headerp->root = headerp->numpages++;
+      return btree_writenode(f, headerp, headerp->root, &head, entries);
+    }
+
+    page = path[--depth];
+    if (1 != btree_readnode(f, headerp, page, &head, entries))
+      return 0;
+  }
+}
+
+db_int btree_insert(db_fileref_t f, unsigned char *key, long value,
+                    db_query_mm_t *mmp) {
+  btree_header_t header;
+  unsigned char *entries;
+  db_int retval;
+
+  if (1 != btree_readheader(f, &header))
+    return 0;
+
+  entries = DB_QMM_BALLOC(mmp, btree_nodebytes(&header));
+  if (NULL == entries)
+    return 0;
+
+  retval = btree_insertinto(f, &header, entries, key, value);
+  DB_QMM_BFREE(mmp, entries);
+  if (1 != retval)
+    return 0;
+
+  header.numentries++;
+  return btree_writeheader(f, &header);
+}
+
+/* Take an entry out of a tree.  Nodes are never merged, so a leaf may be
+   left empty. */
+static db_int btree_deletefrom(db_fileref_t f, btree_header_t *headerp,
+                               unsigned char *entries, unsigned char *key,
+                               long value) {
+  btree_nodehead_t head;
+  db_int depth, i;
+  db_uint8 keysize = headerp->keysize;
+  unsigned char *entryp;
+  size_t entrysize;
+  long page;
+
+  /* Equal keys may be on either side of an equal separator, so go left of
+     it. */
+  page = headerp->root;
+  for (depth = 0;; ++depth) {
+    if (BTREE_MAXDEPTH == depth ||
+        1 != btree_readnode(f, headerp, page, &head, entries))
+      return 0;
+    entrysize = btree_entrysize(headerp, head.isleaf);
+    i = btree_bound(entries, entrysize, keysize, head.count, key, 0);
+    if (head.isleaf)
+      break;
+    page = btree_child(&head, entries, entrysize, i);
+  }
+
+  /* Entries with the key may go on over several leaves. */
+  while (1) {
+    for (; i < head.count; ++i) {
+      entryp = btree_entry(entries, entrysize, i);
+      if (0 != btree_cmpkey(entryp, keysize, key))
+        break;
+      if (btree_getvalue(entryp) == value) {
+        memmove(entryp, btree_entry(entries, entrysize, i + 1),
+                (size_t)(head.count - i - 1) * entrysize);
+        head.count--;
+        return btree_writenode(f, headerp, page, &head, entries);
+      }
+    }
+    if (i < head.count || 0 == head.link)
+      return 0;
+    page = head.link;
+    if (1 != btree_readnode(f, headerp, page, &head, entries))
+      return 0;
+    i = 0;
+  }
+}
+
+db_int btree_delete(db_fileref_t f, unsigned char *key, long value,
+                    db_query_mm_t *mmp) {
+  btree_header_t header;
+  unsigned char *entries;
+  db_int retval;
+
+  if (1 != btree_readheader(f, &header))
+    return 0;
+
+  entries = DB_QMM_BALLOC(mmp, btree_nodebytes(&header));
+  if (NULL == entries)
+    return 0;
+
+  retval = btree_deletefrom(f, &header, entries, key, value);
+  DB_QMM_BFREE(mmp, entries);
+  if (1 != retval)
+    return 0;
+
+  header.numentries--;
+  return btree_writeheader(f, &header);
+}
+
+long btree_numentries(db_fileref_t f) {
+  btree_header_t header;
+  if (1 != btree_readheader(f, &header))
+    return -1;
+  return header.numentries;
+}
+
+db_int btree_seek(db_index_cursor_t *cp, db_query_mm_t *mmp) {
+  btree_header_t header;
+  btree_nodehead_t head;
+  unsigned char *entries;
+  size_t entrysize;
+  db_int depth, i;
+  long page;
+
+  if (1 != btree_readheader(cp->indexref, &header))
+    return 0;
+  cp->pagesize = header.pagesize;
+  cp->keysize = header.keysize;
+  cp->payloadsize = header.payloadsize;
+
+  entries = DB_QMM_BALLOC(mmp, btree_nodebytes(&header));
+  if (NULL == entries)
+    return 0;
+
+  /* Equal keys may be on either side of an equal separator, so go left of
+     it. */
+  page = header.root;
+  for (depth = 0; depth < BTREE_MAXDEPTH; ++depth) {
+    if (1 != btree_readnode(cp->indexref, &header, page, &head, entries))
+      break;
+    entrysize = btree_entrysize(&header, head.isleaf);
+    i = btree_bound(entries, entrysize, header.keysize, head.count,
+                    cp->low.bytes, 0);
+    if (head.isleaf) {
+      cp->page = page;
+      cp->slot = i;
+      DB_QMM_BFREE(mmp, entries);
+      return 1;
+    }
+    page = btree_child(&head, entries, entrysize, i);
+  }
+
+  DB_QMM_BFREE(mmp, entries);
+  return 0;
+}
+
+db_int btree_next(db_index_cursor_t *cp, long *valuep,
+                  unsigned char *entryp) {
+  btree_nodehead_t head;
+  size_t entrysize = BTREE_ENTRYSIZE((db_int)(cp->keysize) + cp->payloadsize);
+  unsigned char entry[entrysize];
+
+  while (0 != cp->page) {
+    if (1 != btree_readhead(cp->indexref, cp->pagesize, cp->page, &head))
+      break;
+    if (cp->slot < head.count) {
+      btree_seekto(cp->indexref, cp->page * cp->pagesize +
+                                     (long)sizeof(btree_nodehead_t) +
+                                     cp->slot * (long)entrysize);
+      if (entrysize != db_fileread(cp->indexref, entry, entrysize) ||
+          btree_cmpkey(entry, cp->keysize, cp->high.bytes) > 0)
+        break;
+      cp->slot++;
+      *valuep = btree_getvalue(entry);
+      if (NULL != entryp)
+        memcpy(entryp, entry + sizeof(long), entrysize - sizeof(long));
+      return 1;
+    }
+    cp->page = head.link;
+    cp->slot = 0;
+  }
+
+  cp->page = 0;
+  return 0;
+}
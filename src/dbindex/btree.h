@@ -0,0 +1,128 @@
+/******************************************************************************/
+/**
+@file		btree.h
+@author		Graeme Douglas
+@brief		A disk-resident B+tree mapping fixed-width keys to tuple
+		offsets.
+@details	The tree lives in an index file after the byte giving the
+		index's type.  The file is split into pages of equal size.
+		The first page holds the tree's header, and every other page
+		holds one node.  Leaves are chained together in key order, so
+		a range is read by finding its first entry and following the
+		chain.  Keys are compared a byte at a time, and equal keys may
+		appear any number of times.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef BTREE_H
+#define BTREE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../ref.h"
+#include "../dbmm/db_query_mm.h"
+#include "../dbstorage/dbstorage.h"
+#include "dbindex_types.h"
+
+/**
+@brief		Write out an empty tree.
+@param		f		The index file, open for writing and
+				positioned just after the index's type.
+@param		pagesize	The number of bytes in each page.  A page
+				must hold at least three entries.
+@param		keysize		The number of bytes in each key, no more than
+				@ref DB_CTCONF_SETTING_INDEX_MAXKEYSIZE.
+@param		payloadsize	The number of bytes stored after each key
+				in the tree's leaves.
+@returns	@c 1 if the tree was written, @c 0 otherwise.
+*/
+db_int btree_create(db_fileref_t f,
+		db_int pagesize,
+		db_uint8 keysize,
+		db_int payloadsize);
+
+/**
+@brief		Add an entry to a tree.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the tree's keys,
+				followed by its payload.
+@param		value		The offset of the tuple the entry is for.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the entry was added, @c 0 otherwise.
+*/
+db_int btree_insert(db_fileref_t f,
+		unsigned char *key,
+		long value,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Take an entry out of a tree.
+@details	Nodes are not merged as they empty, so the tree's pages are
+		never given back.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the tree's keys.
+@param		value		The offset of the tuple the entry is for.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the entry was found and taken out, @c 0 otherwise.
+*/
+db_int btree_delete(db_fileref_t f,
+		unsigned char *key,
+		long value,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Find the number of entries in a tree.
+@param		f		The index file.
+@returns	The number of entries, or @c -1 if the file could not be read.
+*/
+long btree_numentries(db_fileref_t f);
+
+/**
+@brief		Position a cursor at the first entry whose key is no smaller
+		than the cursor's @p low key.
+@param		cp		A pointer to the cursor.  Its index file and
+				bounds must be set.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the cursor was positioned, @c 0 otherwise.
+*/
+db_int btree_seek(db_index_cursor_t *cp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Read the entry a cursor is at and move past it.
+@param		cp		A pointer to the cursor.
+@param		valuep		A pointer to where the entry's tuple offset
+				will be written.
+@param		entryp		Where the entry's key and payload will be
+				written, or @c NULL if they are not needed.
+@returns	@c 1 if there was an entry, @c 0 once past the last.
+*/
+db_int btree_next(db_index_cursor_t *cp,
+		long *valuep,
+		unsigned char *entryp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
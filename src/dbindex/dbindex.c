@@ -23,36 +23,1090 @@
 /******************************************************************************/
 
 #include "dbindex.h"
+#include "btree.h"
+#include "hashindex.h"
+#include "skiplist.h"
+#include <string.h>
 
-db_int init_index(db_index_t *indexp, char *name) {
+/* Open an index's file and read its type. */
+static db_int db_index_open(db_index_t *indexp, char *name,
+                            db_uint8 forupdate) {
   /* Prepare for ugly. */
   char realname[8 + strlen(name)];
   sprintf(realname, "DB_IDX_%s", name);
 
-  indexp->indexref = db_openreadfile(realname);
-  if (DB_STORAGE_NOFILE == indexp->indexref ||
-      1 != db_fileread(indexp->indexref, &(indexp->type), 1)) {
+  if (forupdate)
+    indexp->indexref = db_openreadfile_plus(realname);
+  else
+    indexp->indexref = db_openreadfile(realname);
+  if (DB_STORAGE_NOFILE == indexp->indexref)
+    return 0;
+  if (1 != db_fileread(indexp->indexref, &(indexp->type), 1)) {
+    db_fileclose(indexp->indexref);
     return 0;
   }
 
   return 1;
 }
 
+db_int init_index(db_index_t *indexp, char *name) {
+  return db_index_open(indexp, name, 0);
+}
+
+db_int init_index_forupdate(db_index_t *indexp, char *name) {
+  return db_index_open(indexp, name, 1);
+}
+
 db_int close_index(db_index_t *indexp) {
   return db_fileclose(indexp->indexref);
 }
 
+db_int db_index_readmeta(db_index_meta_t *metap, char *relationname,
+                         db_query_mm_t *mmp) {
+  char metaname[9 + strlen(relationname)];
+  sprintf(metaname, "DB_IDXM_%s", relationname);
+  db_fileref_t idxmetafile = db_openreadfile(metaname);
+
+  if (DB_STORAGE_NOFILE == idxmetafile) {
+    metap->num_idx = 0;
+    return 1;
+  }
+
+  db_fileread(idxmetafile, &(metap->num_idx), sizeof(db_uint8));
+  metap->len_names = DB_QMM_BALLOC(mmp, sizeof(db_uint8) * (metap->num_idx));
+  metap->names = DB_QMM_BALLOC(mmp, sizeof(char *) * (metap->num_idx));
+  metap->num_expr = DB_QMM_BALLOC(mmp, sizeof(db_uint8) * (metap->num_idx));
+  metap->exprs = DB_QMM_BALLOC(mmp, sizeof(db_eet_t *) * (metap->num_idx));
+  metap->num_include =
+      DB_QMM_BALLOC(mmp, sizeof(db_uint8) * (metap->num_idx));
+  metap->include = DB_QMM_BALLOC(mmp, sizeof(db_uint8 *) * (metap->num_idx));
+
+  int i, j;
+  for (i = 0; i < metap->num_idx; ++i) {
+    // TODO: Make sure all pointers passed to read function make sense.
+    db_fileread(idxmetafile, &(metap->len_names[i]), sizeof(db_uint8));
+    metap->names[i] = DB_QMM_BALLOC(mmp, metap->len_names[i]);
+    db_fileread(idxmetafile, (unsigned char *)(metap->names[i]),
+                metap->len_names[i]);
+    db_fileread(idxmetafile, &(metap->num_expr[i]), sizeof(db_uint8));
+    metap->exprs[i] =
+        DB_QMM_BALLOC(mmp, sizeof(db_eet_t) * (metap->num_expr[i]));
+    db_fileread(idxmetafile, (unsigned char *)(metap->exprs[i]),
+                sizeof(db_eet_t) * (metap->num_expr[i]));
+
+    for (j = 0; j < metap->num_expr[i]; ++j) {
+      metap->exprs[i][j].nodes = DB_QMM_BALLOC(mmp, (metap->exprs[i][j].size));
+      db_fileread(idxmetafile, (unsigned char *)(metap->exprs[i][j].nodes),
+                  (metap->exprs[i][j].size));
+    }
+
+    db_fileread(idxmetafile, &(metap->num_include[i]), sizeof(db_uint8));
+    metap->include[i] = NULL;
+    if (metap->num_include[i] > 0) {
+      metap->include[i] = DB_QMM_BALLOC(mmp, metap->num_include[i]);
+      db_fileread(idxmetafile, metap->include[i], metap->num_include[i]);
+    }
+  }
+
+  db_fileclose(idxmetafile);
+
+  return 1;
+}
+
+void db_index_freemeta(db_index_meta_t *metap, db_query_mm_t *mmp) {
+  if (metap->num_idx > 0) {
+    int i, j;
+    for (i = 0; i < (db_int)metap->num_idx; i++) {
+      DB_QMM_BFREE(mmp, metap->names[i]);
+      for (j = 0; j < (db_int)metap->num_expr[i]; j++)
+        DB_QMM_BFREE(mmp, metap->exprs[i][j].nodes);
+      DB_QMM_BFREE(mmp, metap->exprs[i]);
+      if (NULL != metap->include[i])
+        DB_QMM_BFREE(mmp, metap->include[i]);
+    }
+    DB_QMM_BFREE(mmp, metap->len_names);
+    DB_QMM_BFREE(mmp, metap->names);
+    DB_QMM_BFREE(mmp, metap->num_expr);
+    DB_QMM_BFREE(mmp, metap->exprs);
+    DB_QMM_BFREE(mmp, metap->num_include);
+    DB_QMM_BFREE(mmp, metap->include);
+  }
+  metap->num_idx = 0;
+}
+
+/* Check if an index of some type is followed by a cursor, rather than
+   keeping its relation in order. */
+static db_int db_index_hascursor(db_int type) {
+  return DB_INDEX_TYPE_BTREE == type || DB_INDEX_TYPE_SKIPLIST == type ||
+         DB_INDEX_TYPE_HASH == type;
+}
+
+db_int db_index_keysize(db_eet_t *exprp, relation_header_t *hp,
+                        db_query_mm_t *mmp) {
+  db_int type = evaluate_eet(exprp, NULL, NULL, &hp, 0, mmp), size = 0;
+
+  /* Only a string read straight from an attribute has a known width. */
+  if (DB_EETNODE_CONST_DBINT == type)
+    size = (db_int)sizeof(db_int);
+  else if (DB_EETNODE_CONST_DBSTRING == type &&
+           sizeof(db_eetnode_attr_t) == exprp->size &&
+           (db_uint8)DB_EETNODE_ATTR == exprp->nodes->type)
+    size = (db_int)(hp->sizes[((db_eetnode_attr_t *)(exprp->nodes))->pos]);
+  if (size > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE)
+    return 0;
+  return size;
+}
+
+void db_index_intkey(db_index_key_t *keyp, db_int value) {
+  unsigned long bits = (unsigned long)value;
+  db_int i;
+
+  memset(keyp, 0, sizeof(db_index_key_t));
+  for (i = (db_int)sizeof(db_int) - 1; i >= 0; --i) {
+    keyp->bytes[i] = (unsigned char)(bits & 0xff);
+    bits >>= 8;
+  }
+  keyp->bytes[0] ^= 0x80;
+}
+
+db_int db_index_stringkey(db_index_key_t *keyp, char *value, db_int size) {
+  size_t length = strlen(value);
+
+  /* Strings are stored with their null-byte, so a longer one can not
+     equal any of them. */
+  memset(keyp, 0, sizeof(db_index_key_t));
+  if (size > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE || length >= (size_t)size)
+    return 0;
+  memcpy(keyp->bytes, value, length);
+  return 1;
+}
+
+db_int db_index_evalkey(db_eet_t *exprp, db_tuple_t *tp,
+                        relation_header_t *hp, db_int keysize,
+                        db_index_key_t *keyp, db_query_mm_t *mmp) {
+  db_int type = evaluate_eet(exprp, NULL, NULL, &hp, 0, mmp), result;
+  db_int integer;
+  char *string = NULL;
+
+  if (DB_EETNODE_CONST_DBINT == type) {
+    result = evaluate_eet(exprp, &integer, &tp, &hp, 0, mmp);
+    if (1 == result)
+      db_index_intkey(keyp, integer);
+    return result;
+  }
+  if (DB_EETNODE_CONST_DBSTRING == type) {
+    result = evaluate_eet(exprp, &string, &tp, &hp, 0, mmp);
+    if (1 == result)
+      return db_index_stringkey(keyp, string, keysize);
+    return result;
+  }
+  return -1;
+}
+
+/* Find the attribute an index's expression reads, or -1 if it is not a
+   lone attribute. */
+static db_int db_index_keyattr(db_eet_t *exprp) {
+  if (sizeof(db_eetnode_attr_t) == exprp->size &&
+      (db_uint8)DB_EETNODE_ATTR == exprp->nodes->type)
+    return (db_int)(((db_eetnode_attr_t *)(exprp->nodes))->pos);
+  return -1;
+}
+
+db_int db_index_payloadsize(relation_header_t *hp, db_uint8 *include,
+                            db_uint8 num_include) {
+  db_int i, size;
+
+  if (0 == num_include)
+    return 0;
+  size = ((db_int)num_include + 7) / 8;
+  for (i = 0; i < (db_int)num_include; ++i)
+    size += (db_int)(hp->sizes[include[i]]);
+  return size;
+}
+
+/* Write the payload of a tuple's entry: a bit for each included attribute,
+   set where it is NULL, then the attributes' bytes. */
+static void db_index_setpayload(unsigned char *payloadp, db_tuple_t *tp,
+                                relation_header_t *hp, db_uint8 *include,
+                                db_uint8 num_include) {
+  db_int i, pos, numbits = ((db_int)num_include + 7) / 8;
+  unsigned char *bytesp = payloadp + numbits;
+
+  memset(payloadp, 0, (size_t)numbits);
+  for (i = 0; i < (db_int)num_include; ++i) {
+    pos = (db_int)include[i];
+    if (1 == ((tp->isnull[pos / 8] >> (pos % 8)) & 1))
+      payloadp[i / 8] |= (unsigned char)(1 << (i % 8));
+    memcpy(bytesp, tp->bytes + hp->offsets[pos], (size_t)(hp->sizes[pos]));
+    bytesp += hp->sizes[pos];
+  }
+}
+
+db_int db_index_covers(db_index_meta_t *metap, db_uint8 indexon,
+                       db_uint8 pos) {
+  db_int i;
+
+  if (metap->num_idx <= indexon)
+    return 0;
+  if ((db_int)pos == db_index_keyattr(&(metap->exprs[indexon][0])))
+    return 1;
+  for (i = 0; i < (db_int)metap->num_include[indexon]; ++i)
+    if (pos == metap->include[indexon][i])
+      return 1;
+  return 0;
+}
+
+db_int db_index_create(char *name, db_uint8 type, db_int keysize,
+                       db_int payloadsize) {
+  char realname[8 + strlen(name)];
+  db_fileref_t f;
+  db_int retval;
+
+  if (!db_index_hascursor(type) || keysize <= 0 ||
+      keysize > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE || payloadsize < 0)
+    return 0;
+
+  sprintf(realname, "DB_IDX_%s", name);
+  f = db_openwritefile(realname);
+  if (DB_STORAGE_NOFILE == f)
+    return 0;
+
+  retval = 1 == db_filewrite(f, &type, 1);
+  if (DB_INDEX_TYPE_BTREE == type)
+    retval = retval && 1 == btree_create(f, DB_CTCONF_SETTING_INDEX_PAGESIZE,
+                                         (db_uint8)keysize, payloadsize);
+  else if (DB_INDEX_TYPE_HASH == type)
+    retval = retval && 1 == hashindex_create(f,
+                                             DB_CTCONF_SETTING_INDEX_PAGESIZE,
+                                             (db_uint8)keysize, payloadsize);
+  else
+    retval = retval && 1 == skiplist_create(f, (db_uint8)keysize,
+                                            payloadsize);
+  db_fileclose(f);
+  return retval;
+}
+
+db_int db_index_insert(db_index_t *indexp, unsigned char *entryp,
+                       db_index_offset_t offset, db_query_mm_t *mmp) {
+  if (DB_INDEX_TYPE_BTREE == indexp->type)
+    return btree_insert(indexp->indexref, entryp, offset, mmp);
+  if (DB_INDEX_TYPE_SKIPLIST == indexp->type)
+    return skiplist_insert(indexp->indexref, entryp, offset);
+  if (DB_INDEX_TYPE_HASH == indexp->type)
+    return hashindex_insert(indexp->indexref, entryp, offset, mmp);
+  return 0;
+}
+
+db_int db_index_delete(db_index_t *indexp, db_index_key_t *keyp,
+                       db_index_offset_t offset, db_query_mm_t *mmp) {
+  if (DB_INDEX_TYPE_BTREE == indexp->type)
+    return btree_delete(indexp->indexref, keyp->bytes, offset, mmp);
+  if (DB_INDEX_TYPE_SKIPLIST == indexp->type)
+    return skiplist_delete(indexp->indexref, keyp->bytes, offset);
+  if (DB_INDEX_TYPE_HASH == indexp->type)
+    return hashindex_delete(indexp->indexref, keyp->bytes, offset);
+  return 0;
+}
+
+db_int init_index_writer(db_index_writer_t *wp, char *relationname,
+                         relation_header_t *hp, db_query_mm_t *mmp) {
+  db_int i;
+
+  wp->relationname = relationname;
+  wp->hp = hp;
+  wp->tuple_start = gettuplestart(hp);
+  wp->recordsize = (db_int)(hp->num_attr) / 8 + (db_int)(hp->tuple_size);
+  if ((db_int)(hp->num_attr) % 8 > 0)
+    wp->recordsize++;
+  wp->relation = DB_STORAGE_NOFILE;
+  wp->indexes = NULL;
+  wp->unordered = NULL;
+
+  if (1 != db_index_readmeta(&(wp->meta), relationname, mmp))
+    return 0;
+  if (0 == wp->meta.num_idx)
+    return 1;
+
+  wp->indexes =
+      DB_QMM_BALLOC(mmp, (size_t)wp->meta.num_idx * sizeof(db_index_t));
+  if (NULL == wp->indexes) {
+    db_index_freemeta(&(wp->meta), mmp);
+    return 0;
+  }
+  wp->unordered = DB_QMM_BALLOC(mmp, (size_t)wp->meta.num_idx);
+  if (NULL == wp->unordered) {
+    DB_QMM_BFREE(mmp, wp->indexes);
+    db_index_freemeta(&(wp->meta), mmp);
+    return 0;
+  }
+
+  /* Indexes that can not be kept up are left closed. */
+  for (i = 0; i < (db_int)wp->meta.num_idx; ++i) {
+    wp->unordered[i] = 0;
+    if (1 != init_index_forupdate(&(wp->indexes[i]), wp->meta.names[i])) {
+      wp->indexes[i].type = DB_INDEX_TYPE_NONE;
+    } else if (DB_INDEX_TYPE_INLINE != wp->indexes[i].type &&
+               (!db_index_hascursor(wp->indexes[i].type) ||
+                1 != wp->meta.num_expr[i])) {
+      close_index(&(wp->indexes[i]));
+      wp->indexes[i].type = DB_INDEX_TYPE_NONE;
+    } else if (DB_INDEX_TYPE_INLINE == wp->indexes[i].type &&
+               DB_STORAGE_NOFILE == wp->relation) {
+      wp->relation = db_openreadfile(relationname);
+    }
+  }
+  return 1;
+}
+
+/* Read the tuple whose record is at some offset of a relation. */
+static db_int db_index_readrecord(db_index_writer_t *wp, long offset,
+                                  db_tuple_t *tp) {
+  db_int isnullsize = wp->recordsize - (db_int)(wp->hp->tuple_size);
+  db_filerewind(wp->relation);
+  db_fileseek(wp->relation, (size_t)offset);
+  return (size_t)isnullsize == db_fileread(wp->relation,
+                                           (unsigned char *)tp->isnull,
+                                           (size_t)isnullsize) &&
+         (size_t)(wp->hp->tuple_size) ==
+             db_fileread(wp->relation, (unsigned char *)tp->bytes,
+                         (size_t)(wp->hp->tuple_size));
+}
+
+/* Check a tuple written at some offset keeps its relation in the order of
+   an inline index.  If it replaced a tuple with the same keys, or the
+   tuples around it are still no bigger before it and no smaller after it,
+   the order holds. */
+static db_int db_index_staysinorder(db_index_writer_t *wp, db_int i,
+                                    db_tuple_t *oldtp, db_tuple_t *tp,
+                                    long offset, db_query_mm_t *mmp) {
+  db_uint8 order[wp->meta.num_expr[i]];
+  db_tuple_t neighbour;
+  long size;
+  db_int j, retval = 1;
+
+  if (DB_STORAGE_NOFILE == wp->relation)
+    return 0;
+  for (j = 0; j < (db_int)wp->meta.num_expr[i]; ++j)
+    order[j] = DB_TUPLE_ORDER_ASC;
+  if (NULL != oldtp &&
+      0 == cmp_tuple(oldtp, tp, wp->hp, wp->hp, wp->meta.exprs[i],
+                     wp->meta.exprs[i], wp->meta.num_expr[i], order, 1, mmp))
+    return 1;
+  size = db_filesize(wp->relation);
+
+  init_tuple(&neighbour, wp->hp->tuple_size, wp->hp->num_attr, mmp);
+  if (offset > wp->tuple_start) {
+    retval = 1 == db_index_readrecord(wp, offset - wp->recordsize,
+                                      &neighbour) &&
+             0 >= cmp_tuple(&neighbour, tp, wp->hp, wp->hp,
+                            wp->meta.exprs[i], wp->meta.exprs[i],
+                            wp->meta.num_expr[i], order, 1, mmp);
+  }
+  if (1 == retval && offset + 2 * wp->recordsize <= size) {
+    retval = 1 == db_index_readrecord(wp, offset + wp->recordsize,
+                                      &neighbour) &&
+             0 <= cmp_tuple(&neighbour, tp, wp->hp, wp->hp,
+                            wp->meta.exprs[i], wp->meta.exprs[i],
+                            wp->meta.num_expr[i], order, 1, mmp);
+  }
+  close_tuple(&neighbour, mmp);
+  return retval;
+}
+
+db_int db_index_writetuple(db_index_writer_t *wp, db_tuple_t *oldtp,
+                           db_tuple_t *newtp, db_index_offset_t offset,
+                           db_query_mm_t *mmp) {
+  db_index_t *indexp;
+  db_index_key_t oldkey, newkey;
+  db_int i, keysize, payloadsize, oldresult, newresult, retval = 1;
+
+  for (i = 0; i < (db_int)wp->meta.num_idx && 1 == retval; ++i) {
+    indexp = &(wp->indexes[i]);
+
+    /* An inline index only needs the tuple to land in order.  Once it
+       does not, the index is dealt with when the writer is closed. */
+    if (DB_INDEX_TYPE_INLINE == indexp->type) {
+      if (!wp->unordered[i] &&
+          1 != db_index_staysinorder(wp, i, oldtp, newtp, offset, mmp))
+        wp->unordered[i] = 1;
+      continue;
+    }
+    if (!db_index_hascursor(indexp->type))
+      continue;
+
+    /* NULL keys never match a search, so they are left out. */
+    keysize = db_index_keysize(&(wp->meta.exprs[i][0]), wp->hp, mmp);
+    oldresult = 2;
+    if (NULL != oldtp)
+      oldresult = db_index_evalkey(&(wp->meta.exprs[i][0]), oldtp, wp->hp,
+                                   keysize, &oldkey, mmp);
+    newresult = db_index_evalkey(&(wp->meta.exprs[i][0]), newtp, wp->hp,
+                                 keysize, &newkey, mmp);
+    if (0 == keysize || (1 != oldresult && 2 != oldresult) ||
+        (1 != newresult && 2 != newresult)) {
+      retval = 0;
+      break;
+    }
+
+    /* Each entry holds its key, then any attributes stored with it. */
+    payloadsize = db_index_payloadsize(wp->hp, wp->meta.include[i],
+                                       wp->meta.num_include[i]);
+    unsigned char oldentry[keysize + payloadsize];
+    unsigned char newentry[keysize + payloadsize];
+    if (1 == oldresult) {
+      memcpy(oldentry, oldkey.bytes, (size_t)keysize);
+      db_index_setpayload(oldentry + keysize, oldtp, wp->hp,
+                          wp->meta.include[i], wp->meta.num_include[i]);
+    }
+    if (1 == newresult) {
+      memcpy(newentry, newkey.bytes, (size_t)keysize);
+      db_index_setpayload(newentry + keysize, newtp, wp->hp,
+                          wp->meta.include[i], wp->meta.num_include[i]);
+    }
+
+    /* Most changes leave most entries as they were. */
+    if (oldresult == newresult &&
+        (2 == newresult ||
+         0 == memcmp(oldentry, newentry, (size_t)(keysize + payloadsize))))
+      continue;
+    if (1 == oldresult)
+      retval = db_index_delete(indexp, &oldkey, offset, mmp);
+    if (1 == newresult && 1 == retval)
+      retval = db_index_insert(indexp, newentry, offset, mmp);
+  }
+
+  return retval;
+}
+
+/* Replace an inline index whose relation is no longer in order.  An index
+   on a single expression becomes a B+tree, so lookups on it stay fast. */
+static db_int db_index_replaceinline(db_index_writer_t *wp, db_int i,
+                                     db_query_mm_t *mmp) {
+  scan_t scan;
+  db_int retval = 0;
+
+  if (1 == wp->meta.num_expr[i] &&
+      1 == init_scan(&scan, wp->relationname, mmp)) {
+    retval = db_index_build(wp->meta.names[i], DB_INDEX_TYPE_BTREE, &scan,
+                            wp->meta.exprs[i], 1, wp->meta.include[i],
+                            wp->meta.num_include[i], mmp);
+    close_scan(&scan, mmp);
+  }
+  if (1 != retval) {
+    retval = db_index_drop(wp->relationname, wp->meta.names[i], mmp) ||
+             !db_index_exists(wp->meta.names[i]);
+  }
+  return retval;
+}
+
+db_int close_index_writer(db_index_writer_t *wp, db_query_mm_t *mmp) {
+  long count = 0, size;
+  db_int i, retval = 1;
+
+  if (DB_STORAGE_NOFILE != wp->relation) {
+    size = db_filesize(wp->relation);
+    if (size > wp->tuple_start)
+      count = (size - wp->tuple_start) / wp->recordsize;
+    db_fileclose(wp->relation);
+  }
+
+  for (i = 0; i < (db_int)wp->meta.num_idx; ++i) {
+    if (DB_INDEX_TYPE_NONE == wp->indexes[i].type)
+      continue;
+
+    /* An inline index still in order covers every record. */
+    if (DB_INDEX_TYPE_INLINE == wp->indexes[i].type && !wp->unordered[i]) {
+      db_filerewind(wp->indexes[i].indexref);
+      db_fileseek(wp->indexes[i].indexref, 1);
+      if (sizeof(long) !=
+          db_filewrite(wp->indexes[i].indexref, &count, sizeof(long)))
+        retval = 0;
+    }
+    close_index(&(wp->indexes[i]));
+  }
+
+  for (i = 0; i < (db_int)wp->meta.num_idx; ++i)
+    if (wp->unordered[i] && 1 != db_index_replaceinline(wp, i, mmp))
+      retval = 0;
+
+  if (NULL != wp->indexes) {
+    DB_QMM_BFREE(mmp, wp->unordered);
+    DB_QMM_BFREE(mmp, wp->indexes);
+  }
+  db_index_freemeta(&(wp->meta), mmp);
+  return retval;
+}
+
+db_int db_index_addtuple(char *relationname, relation_header_t *hp,
+                         db_tuple_t *tp, db_index_offset_t offset,
+                         db_query_mm_t *mmp) {
+  db_index_writer_t writer;
+  db_int retval;
+
+  if (1 != init_index_writer(&writer, relationname, hp, mmp))
+    return 0;
+  retval = db_index_writetuple(&writer, NULL, tp, offset, mmp);
+  return 1 == close_index_writer(&writer, mmp) && 1 == retval;
+}
+
+db_int db_index_exists(char *name) {
+  char realname[8 + strlen(name)];
+  sprintf(realname, "DB_IDX_%s", name);
+  return db_fileexists(realname);
+}
+
+db_int db_index_remove(char *name) {
+  char realname[8 + strlen(name)];
+  sprintf(realname, "DB_IDX_%s", name);
+  return db_fileremove(realname);
+}
+
+/* A key gathered to build an index, and the offset of its tuple.  The
+   key's payload, if the index has one, follows it. */
+typedef struct {
+  db_index_offset_t offset;
+  db_index_key_t key;
+} db_index_entry_t;
+
+/* Find where one of the gathered entries is, given how many bytes apart
+   they are. */
+static db_index_entry_t *db_index_entryat(db_index_entry_t *entries,
+                                          size_t stride, db_int i) {
+  return (db_index_entry_t *)((unsigned char *)entries + (size_t)i * stride);
+}
+
+/* Check if one gathered entry goes before another.  Keys are padded with
+   null-bytes past their width, so they compare the same over all their
+   bytes.  Equal keys keep the order of their tuples. */
+static db_int db_index_entrybefore(db_index_entry_t *a, db_index_entry_t *b) {
+  int result = memcmp(a->key.bytes, b->key.bytes, sizeof(a->key.bytes));
+  return result < 0 || (0 == result && a->offset < b->offset);
+}
+
+/* Swap two gathered entries. */
+static void db_index_swapentries(db_index_entry_t *a, db_index_entry_t *b,
+                                 size_t stride) {
+  unsigned char temp[stride];
+  memcpy(temp, a, stride);
+  memcpy(a, b, stride);
+  memcpy(b, temp, stride);
+}
+
+/* Move an entry down a max-heap of entries until the heap is valid again. */
+static void db_index_siftdown(db_index_entry_t *entries, size_t stride,
+                              db_int root, db_int count) {
+  db_int child;
+  while ((child = 2 * root + 1) < count) {
+    if (child + 1 < count &&
+        db_index_entrybefore(db_index_entryat(entries, stride, child),
+                             db_index_entryat(entries, stride, child + 1)))
+      child++;
+    if (!db_index_entrybefore(db_index_entryat(entries, stride, root),
+                              db_index_entryat(entries, stride, child)))
+      return;
+    db_index_swapentries(db_index_entryat(entries, stride, root),
+                         db_index_entryat(entries, stride, child), stride);
+    root = child;
+  }
+}
+
+/* Sort a run of gathered entries, then add them to an index in order. */
+static db_int db_index_loadrun(db_index_t *indexp, db_index_entry_t *entries,
+                               size_t stride, db_int count, db_int keysize,
+                               db_int payloadsize, db_query_mm_t *mmp) {
+  unsigned char entry[keysize + payloadsize];
+  db_index_entry_t *entryp;
+  db_int i;
+
+  for (i = count / 2 - 1; i >= 0; --i)
+    db_index_siftdown(entries, stride, i, count);
+  for (i = count - 1; i > 0; --i) {
+    db_index_swapentries(entries, db_index_entryat(entries, stride, i),
+                         stride);
+    db_index_siftdown(entries, stride, 0, i);
+  }
+
+  for (i = 0; i < count; ++i) {
+    entryp = db_index_entryat(entries, stride, i);
+    memcpy(entry, entryp->key.bytes, (size_t)keysize);
+    memcpy(entry + keysize, entryp + 1, (size_t)payloadsize);
+    if (1 != db_index_insert(indexp, entry, entryp->offset, mmp))
+      return 0;
+  }
+  return 1;
+}
+
+/* Build a B+tree, skip list or hash index.  Keys are gathered in runs as
+   large as memory allows, and each run is sorted before it is added, so
+   the index is filled from one end to the other instead of at random. */
+static db_int db_index_buildsorted(char *name, db_uint8 type, scan_t *sp,
+                                   db_eet_t *exprp, db_uint8 *include,
+                                   db_uint8 num_include, db_query_mm_t *mmp) {
+  relation_header_t *hp = sp->base.header;
+  db_index_t index;
+  db_index_entry_t *entries = NULL, *entryp;
+  db_tuple_t tuple, *tp = &tuple;
+  db_index_offset_t offset = sp->tuple_start;
+  db_int reserve, capacity, count = 0, keysize, payloadsize, result;
+  db_int retval = 1;
+  long recordsize = (long)hp->tuple_size + hp->num_attr / 8 +
+                    (hp->num_attr % 8 > 0 ? 1 : 0);
+  size_t stride;
+
+  keysize = db_index_keysize(exprp, hp, mmp);
+  payloadsize = db_index_payloadsize(hp, include, num_include);
+  if (1 != db_index_create(name, type, keysize, payloadsize))
+    return 0;
+  if (1 != init_index_forupdate(&index, name)) {
+    db_index_remove(name);
+    return 0;
+  }
+  init_tuple(&tuple, hp->tuple_size, hp->num_attr, mmp);
+
+  /* Entries stay aligned however wide their payloads are. */
+  stride = sizeof(db_index_entry_t) + (size_t)payloadsize;
+  stride = (stride + sizeof(long) - 1) / sizeof(long) * sizeof(long);
+
+  /* Adding an entry to a hash index needs about two pages, and to a B+tree
+     about one. */
+  reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE + exprp->stack_size +
+            keysize + payloadsize +
+            (DB_INDEX_TYPE_HASH == type ? 2 : 1) *
+                DB_CTCONF_SETTING_INDEX_PAGESIZE;
+  capacity = (POINTERBYTEDIST(mmp->last_back, mmp->next_front) - reserve) /
+             (db_int)stride;
+  if (capacity > 0)
+    entries = DB_QMM_BALLOC(mmp, (size_t)capacity * stride);
+  if (NULL == entries)
+    retval = 0;
+
+  /* NULL keys never match a search, so they are left out. */
+  rewind_scan(sp, mmp);
+  while (1 == retval && 1 == next_scan(sp, tp, mmp)) {
+    entryp = db_index_entryat(entries, stride, count);
+    result = db_index_evalkey(exprp, tp, hp, keysize, &(entryp->key), mmp);
+    if (1 == result) {
+      entryp->offset = offset;
+      db_index_setpayload((unsigned char *)(entryp + 1), tp, hp, include,
+                          num_include);
+      if (++count == capacity) {
+        retval = db_index_loadrun(&index, entries, stride, count, keysize,
+                                  payloadsize, mmp);
+        count = 0;
+      }
+    } else if (2 != result) {
+      retval = 0;
+    }
+    offset += recordsize;
+  }
+  if (1 == retval && count > 0)
+    retval = db_index_loadrun(&index, entries, stride, count, keysize,
+                              payloadsize, mmp);
+
+  if (NULL != entries)
+    DB_QMM_BFREE(mmp, entries);
+  close_tuple(&tuple, mmp);
+  close_index(&index);
+  if (1 != retval)
+    db_index_remove(name);
+  return retval;
+}
+
+/* Write an inline index, after checking its relation is already in order. */
+static db_int db_index_buildinline(char *name, scan_t *sp, db_eet_t *exprs,
+                                   db_uint8 num_expr, db_query_mm_t *mmp) {
+  relation_header_t *hp = sp->base.header;
+  char realname[8 + strlen(name)];
+  db_uint8 type = DB_INDEX_TYPE_INLINE;
+  db_uint8 order[num_expr];
+  db_tuple_t tuples[2];
+  db_fileref_t f;
+  long count = 0;
+  db_int i, retval = 1;
+
+  for (i = 0; i < (db_int)num_expr; ++i)
+    order[i] = DB_TUPLE_ORDER_ASC;
+
+  init_tuple(&(tuples[0]), hp->tuple_size, hp->num_attr, mmp);
+  init_tuple(&(tuples[1]), hp->tuple_size, hp->num_attr, mmp);
+  rewind_scan(sp, mmp);
+  while (1 == next_scan(sp, &(tuples[count % 2]), mmp)) {
+    if (count > 0 &&
+        0 < cmp_tuple(&(tuples[(count - 1) % 2]), &(tuples[count % 2]), hp,
+                      hp, exprs, exprs, num_expr, order, 1, mmp)) {
+      retval = -1;
+      break;
+    }
+    count++;
+  }
+  close_tuple(&(tuples[1]), mmp);
+  close_tuple(&(tuples[0]), mmp);
+  if (1 != retval)
+    return retval;
+
+  sprintf(realname, "DB_IDX_%s", name);
+  f = db_openwritefile(realname);
+  if (DB_STORAGE_NOFILE == f)
+    return 0;
+  retval = 1 == db_filewrite(f, &type, 1) &&
+           sizeof(long) == db_filewrite(f, &count, sizeof(long));
+  db_fileclose(f);
+  if (1 != retval)
+    db_fileremove(realname);
+  return retval;
+}
+
+db_int db_index_build(char *name, db_uint8 type, scan_t *sp, db_eet_t *exprs,
+                      db_uint8 num_expr, db_uint8 *include,
+                      db_uint8 num_include, db_query_mm_t *mmp) {
+  if (DB_INDEX_TYPE_INLINE == type && num_expr > 0 && 0 == num_include)
+    return db_index_buildinline(name, sp, exprs, num_expr, mmp);
+  if (!db_index_hascursor(type) || 1 != num_expr)
+    return 0;
+  return db_index_buildsorted(name, type, sp, exprs, include, num_include,
+                              mmp);
+}
+
+/* Write one index's entry of its relation's index metadata. */
+static db_int db_index_writemetaentry(db_fileref_t f, char *name,
+                                      db_eet_t *exprs, db_uint8 num_expr,
+                                      db_uint8 *include,
+                                      db_uint8 num_include) {
+  db_uint8 length = (db_uint8)(strlen(name) + 1);
+  size_t size = sizeof(db_eet_t) * (size_t)num_expr;
+  db_int i;
+
+  if (1 != db_filewrite(f, &length, 1) ||
+      (size_t)length != db_filewrite(f, name, (size_t)length) ||
+      1 != db_filewrite(f, &num_expr, 1) ||
+      size != db_filewrite(f, exprs, size))
+    return 0;
+  for (i = 0; i < (db_int)num_expr; ++i)
+    if ((size_t)(exprs[i].size) !=
+        db_filewrite(f, exprs[i].nodes, (size_t)(exprs[i].size)))
+      return 0;
+  return 1 == db_filewrite(f, &num_include, 1) &&
+         (0 == num_include ||
+          (size_t)num_include == db_filewrite(f, include,
+                                              (size_t)num_include));
+}
+
+/* Rewrite a relation's index metadata, leaving out the index at position
+   skip, if it is not -1, and adding the index called name, if it is not
+   NULL. */
+static db_int db_index_writemeta(char *relationname, db_index_meta_t *metap,
+                                 db_int skip, char *name, db_eet_t *exprs,
+                                 db_uint8 num_expr, db_uint8 *include,
+                                 db_uint8 num_include) {
+  char metaname[9 + strlen(relationname)];
+  db_uint8 num_idx = metap->num_idx;
+  db_fileref_t f;
+  db_int i, retval;
+
+  if (-1 != skip)
+    num_idx--;
+  if (NULL != name)
+    num_idx++;
+
+  sprintf(metaname, "DB_IDXM_%s", relationname);
+  if (0 == num_idx)
+    return db_fileremove(metaname);
+
+  f = db_openwritefile(metaname);
+  if (DB_STORAGE_NOFILE == f)
+    return 0;
+  retval = 1 == db_filewrite(f, &num_idx, 1);
+  for (i = 0; i < (db_int)metap->num_idx && 1 == retval; ++i)
+    if (i != skip)
+      retval = db_index_writemetaentry(f, metap->names[i], metap->exprs[i],
+                                       metap->num_expr[i],
+                                       metap->include[i],
+                                       metap->num_include[i]);
+  if (NULL != name && 1 == retval)
+    retval = db_index_writemetaentry(f, name, exprs, num_expr, include,
+                                     num_include);
+  db_fileclose(f);
+  return retval;
+}
+
+db_int db_index_register(char *relationname, char *name, db_eet_t *exprs,
+                         db_uint8 num_expr, db_uint8 *include,
+                         db_uint8 num_include, db_query_mm_t *mmp) {
+  db_index_meta_t meta;
+  db_int retval = 0;
+
+  if (1 != db_index_readmeta(&meta, relationname, mmp))
+    return 0;
+  if (meta.num_idx < 255)
+    retval = db_index_writemeta(relationname, &meta, -1, name, exprs,
+                                num_expr, include, num_include);
+  db_index_freemeta(&meta, mmp);
+  return retval;
+}
+
+db_int db_index_drop(char *relationname, char *name, db_query_mm_t *mmp) {
+  db_index_meta_t meta;
+  db_int i, retval = 0;
+
+  if (1 != db_index_readmeta(&meta, relationname, mmp))
+    return 0;
+  for (i = 0; i < (db_int)meta.num_idx; ++i) {
+    if (0 == strcmp(meta.names[i], name)) {
+      retval = db_index_writemeta(relationname, &meta, i, NULL, NULL, 0,
+                                  NULL, 0) &&
+               db_index_remove(name);
+      break;
+    }
+  }
+  db_index_freemeta(&meta, mmp);
+  return retval;
+}
+
+db_int db_index_seekcursor(db_index_cursor_t *cp, db_query_mm_t *mmp) {
+  if (DB_INDEX_TYPE_BTREE == cp->type)
+    return btree_seek(cp, mmp);
+  if (DB_INDEX_TYPE_SKIPLIST == cp->type)
+    return skiplist_seek(cp);
+  if (DB_INDEX_TYPE_HASH == cp->type)
+    return hashindex_seek(cp);
+  return 0;
+}
+
+/* Read the next entry a cursor is at.  Its key and payload are written to
+   entryp, if it is not NULL. */
+static db_int db_index_nextentry(db_index_cursor_t *cp,
+                                 db_index_offset_t *offsetp,
+                                 unsigned char *entryp) {
+  if (DB_INDEX_TYPE_BTREE == cp->type)
+    return btree_next(cp, offsetp, entryp);
+  if (DB_INDEX_TYPE_SKIPLIST == cp->type)
+    return skiplist_next(cp, offsetp, entryp);
+  if (DB_INDEX_TYPE_HASH == cp->type)
+    return hashindex_next(cp, offsetp, entryp);
+  return 0;
+}
+
+db_int db_index_nextoffset(db_index_cursor_t *cp, db_index_offset_t *offsetp) {
+  return db_index_nextentry(cp, offsetp, NULL);
+}
+
+/* Find the integer an index key was made from. */
+static db_int db_index_keyint(unsigned char *bytes) {
+  unsigned long bits = (unsigned long)(bytes[0] ^ 0x80);
+  db_int i;
+
+  for (i = 1; i < (db_int)sizeof(db_int); ++i)
+    bits = (bits << 8) | bytes[i];
+  return (db_int)bits;
+}
+
+db_int db_index_nextcovered(scan_t *sp, db_tuple_t *tp,
+                            db_index_offset_t *offsetp) {
+  db_index_cursor_t *cp = &(sp->cursor);
+  relation_header_t *hp = sp->base.header;
+  db_uint8 *include = sp->idx_meta_data.include[cp->indexon];
+  db_uint8 num_include = sp->idx_meta_data.num_include[cp->indexon];
+  unsigned char entry[(db_int)(cp->keysize) + cp->payloadsize];
+  unsigned char *payloadp = entry + cp->keysize, *bytesp;
+  db_int i, pos, value, isnullsize = ((db_int)(hp->num_attr) + 7) / 8;
+
+  if (1 != db_index_nextentry(cp, offsetp, entry))
+    return 0;
+
+  /* Attributes the index does not hold are left NULL.  Entries are only
+     made for keys that are not. */
+  memset(tp->isnull, 0xff, (size_t)isnullsize);
+  pos = db_index_keyattr(&(sp->idx_meta_data.exprs[cp->indexon][0]));
+  if (pos >= 0) {
+    if (DB_INT == hp->types[pos]) {
+      value = db_index_keyint(entry);
+      memcpy(tp->bytes + hp->offsets[pos], &value, sizeof(db_int));
+    } else {
+      memcpy(tp->bytes + hp->offsets[pos], entry, (size_t)(cp->keysize));
+    }
+    tp->isnull[pos / 8] &= (char)~(1 << (pos % 8));
+  }
+
+  bytesp = payloadp + ((db_int)num_include + 7) / 8;
+  for (i = 0; i < (db_int)num_include; ++i) {
+    pos = (db_int)include[i];
+    memcpy(tp->bytes + hp->offsets[pos], bytesp, (size_t)(hp->sizes[pos]));
+    bytesp += hp->sizes[pos];
+    if (0 == ((payloadp[i / 8] >> (i % 8)) & 1))
+      tp->isnull[pos / 8] &= (char)~(1 << (pos % 8));
+  }
+  return 1;
+}
+
+void db_index_closecursor(db_index_cursor_t *cp) {
+  if (DB_STORAGE_NOFILE != cp->indexref)
+    db_fileclose(cp->indexref);
+  cp->indexref = DB_STORAGE_NOFILE;
+  cp->indexon = -1;
+}
+
+db_int scan_findrange(scan_t *sp, db_uint8 indexon, db_index_key_t *lowp,
+                      db_index_key_t *highp, db_query_mm_t *mmp) {
+  db_index_t index;
+  db_index_cursor_t *cp = &(sp->cursor);
+
+  if (sp->idx_meta_data.num_idx <= indexon)
+    return 0;
+
+  /* Keep the index open between searches.  Hash indexes only find single
+     keys. */
+  if (DB_STORAGE_NOFILE == cp->indexref || indexon != cp->indexon) {
+    db_index_closecursor(cp);
+    if (1 != init_index(&index, sp->idx_meta_data.names[indexon]))
+      return 0;
+    if (!db_index_hascursor(index.type)) {
+      close_index(&index);
+      return 0;
+    }
+    cp->indexref = index.indexref;
+    cp->type = index.type;
+    cp->indexon = (db_int8)indexon;
+  }
+  if (DB_INDEX_TYPE_HASH == cp->type &&
+      0 != memcmp(lowp->bytes, highp->bytes, sizeof(lowp->bytes)))
+    return 0;
+
+  cp->low = *lowp;
+  cp->high = *highp;
+  if (1 != db_index_seekcursor(cp, mmp)) {
+    db_index_closecursor(cp);
+    return 0;
+  }
+  return 1;
+}
+
+/* Find how many records of a relation kept in order by an inline index come
+   before a key.  If strict is 1, those with the key come before it too. */
+static long db_index_searchinline(scan_t *sp, db_uint8 indexon,
+                                  db_tuple_t *keytp, db_uint8 num_expr,
+                                  db_uint8 strict, long count,
+                                  db_int recordsize, db_query_mm_t *mmp) {
+  db_uint8 order[num_expr];
+  db_tuple_t temp;
+  long imin = 0, imax = count, imid;
+  db_int result;
+
+  memset(order, DB_TUPLE_ORDER_ASC, num_expr);
+  init_tuple(&temp, sp->base.header->tuple_size, sp->base.header->num_attr,
+             mmp);
+  while (imin < imax) {
+    imid = imin + ((imax - imin) / 2);
+    seek_scan(sp, sp->first_record + imid * recordsize);
+    if (1 != next_scan(sp, &temp, mmp))
+      break;
+    result = cmp_tuple(&temp, keytp, sp->base.header, sp->base.header,
+                       sp->idx_meta_data.exprs[indexon],
+                       sp->idx_meta_data.exprs[indexon], num_expr, order, 1,
+                       mmp);
+    if (result < 0 || (strict && 0 == result))
+      imin = imid + 1;
+    else
+      imax = imid;
+  }
+  close_tuple(&temp, mmp);
+  return imin;
+}
+
+db_int scan_findkeyrange(scan_t *sp, db_uint8 indexon, db_tuple_t *lowtp,
+                         db_uint8 numlow, db_tuple_t *hightp,
+                         db_uint8 numhigh, db_query_mm_t *mmp) {
+  db_index_t index;
+  long count, start = 0;
+  db_int recordsize = ((db_int)(sp->base.header->num_attr)) / 8;
+  if (((db_int)(sp->base.header->num_attr)) % 8 > 0)
+    recordsize++;
+  recordsize += (db_int)(sp->base.header->tuple_size);
+
+  if (sp->idx_meta_data.num_idx <= indexon ||
+      sp->idx_meta_data.num_expr[indexon] < numlow ||
+      sp->idx_meta_data.num_expr[indexon] < numhigh ||
+      1 != init_index(&index, sp->idx_meta_data.names[indexon]))
+    return 0;
+  if (DB_INDEX_TYPE_INLINE != index.type ||
+      sizeof(long) !=
+          db_fileread(index.indexref, (unsigned char *)&count, sizeof(long))) {
+    close_index(&index);
+    return 0;
+  }
+  close_index(&index);
+
+  /* The whole relation is searched, wherever the scan was to start and
+     stop before. */
+  sp->tuple_start = sp->first_record;
+  sp->tuple_end = -1;
+  if (numlow > 0)
+    start = db_index_searchinline(sp, indexon, lowtp, numlow, 0, count,
+                                  recordsize, mmp);
+  if (numhigh > 0)
+    sp->tuple_end = sp->first_record +
+                    db_index_searchinline(sp, indexon, hightp, numhigh, 1,
+                                          count, recordsize, mmp) *
+                        recordsize;
+  sp->tuple_start = sp->first_record + start * recordsize;
+  rewind_scan(sp, mmp);
+  return 1;
+}
+
+/* Find the key to search one of a relation's indexes for.  A string too
+   long to be one of the index's keys finds nothing. */
+static db_int db_index_searchkey(scan_t *sp, db_uint8 indexon,
+                                 db_eet_t *searchfor,
+                                 db_tuple_t *comparator_tp,
+                                 relation_header_t *comparator_hp,
+                                 db_index_key_t *keyp, db_query_mm_t *mmp) {
+  db_int keysize = db_index_keysize(&(sp->idx_meta_data.exprs[indexon][0]),
+                                    sp->base.header, mmp);
+
+  /* FIXME: quick hack to let indexed scans work. */
+  if (NULL == comparator_hp) {
+    db_index_intkey(keyp, (db_int)(long)comparator_tp);
+    return 1;
+  }
+  return 1 == db_index_evalkey(searchfor, comparator_tp, comparator_hp,
+                               keysize, keyp, mmp);
+}
+
+/* Find the type of one of a relation's indexes, or -1 if it can't be
+   opened. */
+static db_int db_index_gettype(scan_t *sp, db_uint8 indexon) {
+  db_index_t index;
+
+  if (sp->idx_meta_data.num_idx <= indexon)
+    return -1;
+  if (DB_STORAGE_NOFILE != sp->cursor.indexref && indexon == sp->cursor.indexon)
+    return sp->cursor.type;
+  if (1 != init_index(&index, sp->idx_meta_data.names[indexon]))
+    return -1;
+  close_index(&index);
+  return index.type;
+}
+
 db_int scan_find(scan_t *sp, db_uint8 indexon, db_eet_t *searchfor,
                  db_tuple_t *comparator_tp, relation_header_t *comparator_hp,
                  db_query_mm_t *mmp) {
+  db_index_key_t key;
+
+  /* B+trees, skip lists and hash tables do not keep the relation in order,
+     so the scan follows the index's entries instead. */
+  if (db_index_hascursor(db_index_gettype(sp, indexon))) {
+    if (1 != db_index_searchkey(sp, indexon, searchfor, comparator_tp,
+                                comparator_hp, &key, mmp))
+      return 0;
+    return scan_findrange(sp, indexon, &key, &key, mmp);
+  }
+
   db_index_offset_t offset = db_index_getoffset(
       sp, indexon, searchfor, comparator_tp, comparator_hp, mmp);
 
   if (-1 >= offset) {
     return 0;
   } else {
-    db_filerewind(sp->relation);
-    db_fileseek(sp->relation, offset);
+    seek_scan(sp, offset);
     return 1;
   }
 }
@@ -71,6 +1125,26 @@ db_index_offset_t db_index_getoffset(scan_t *sp, db_uint8 indexon,
     return -1;
   }
 
+  if (db_index_hascursor(index.type)) {
+    db_index_cursor_t cursor;
+    db_index_offset_t offset = -1;
+    db_index_key_t key;
+
+    if (1 == db_index_searchkey(sp, indexon, searchfor, comparator_tp,
+                                comparator_hp, &key, mmp)) {
+      cursor.indexref = index.indexref;
+      cursor.type = index.type;
+      cursor.low = key;
+      cursor.high = key;
+      if (1 != db_index_seekcursor(&cursor, mmp) ||
+          1 != db_index_nextoffset(&cursor, &offset))
+        offset = -1;
+    }
+
+    close_index(&index);
+    return offset;
+  }
+
   if (DB_INDEX_TYPE_INLINE == index.type) {
     long first = sp->tuple_start;
     size_t total_size =
@@ -105,8 +1179,7 @@ db_index_offset_t db_index_getoffset(scan_t *sp, db_uint8 indexon,
     while (imin <= imax) {
       imid = imin + ((imax - imin) / 2);
 
-      db_filerewind(sp->relation);
-      db_fileseek(sp->relation, (imid * (total_size)) + first);
+      seek_scan(sp, (imid * (total_size)) + first);
       next_scan(sp, &temp, mmp);
 
       /* arr[imid], key */
@@ -136,8 +1209,7 @@ db_index_offset_t db_index_getoffset(scan_t *sp, db_uint8 indexon,
       i = imin;
     i = (first + (i * total_size));
 
-    db_filerewind(sp->relation);
-    db_fileseek(sp->relation, i);
+    seek_scan(sp, i);
     next_scan(sp, &temp, mmp);
 
     /* FIXME: quick hack to let indexed scans work. (first part of the
@@ -58,7 +58,13 @@ typedef enum
 {
 	DB_INDEX_TYPE_NONE = 0,		/**< No index. */
 	DB_INDEX_TYPE_INLINE = 1,	/**< Inline index (sorted as it comes in). */
-	DB_INDEX_TYPE_SKIPLIST,		/**< Skip list index. */
+	DB_INDEX_TYPE_SKIPLIST,		/**< Skip list index, which does
+					     not depend on the relation's
+					     order. */
+	DB_INDEX_TYPE_BTREE,		/**< B+tree index, which does not
+					     depend on the relation's order. */
+	DB_INDEX_TYPE_HASH,		/**< Linear hash index, which only
+					     finds single keys. */
 	DB_INDEX_TYPE_COUNT		/**< Count of all index types. */
 } db_index_type_t;
 
@@ -72,11 +78,490 @@ typedef struct db_index
 					     index data. */
 } db_index_t;
 
+/**
+@brief		Read the metadata of all of a relation's indexes.
+@param		metap		A pointer to where the metadata will be
+				written.
+@param		relationname	The name of the relation.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the metadata was read, or the relation has no indexes,
+		@c 0 otherwise.
+*/
+db_int db_index_readmeta(db_index_meta_t *metap,
+		char *relationname,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Free the metadata read by @ref db_index_readmeta.
+@param		metap		A pointer to the metadata.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+*/
+void db_index_freemeta(db_index_meta_t *metap,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Open an index and read its type.
+@param		indexp		A pointer to the index to initialize.
+@param		name		The name of the index.
+@returns	@c 1 if the index was opened, @c 0 otherwise.
+*/
+db_int init_index(db_index_t *indexp,
+		char *name);
+
+/**
+@brief		Open an index for reading and writing, and read its type.
+@param		indexp		A pointer to the index to initialize.
+@param		name		The name of the index.
+@returns	@c 1 if the index was opened, @c 0 otherwise.
+*/
+db_int init_index_forupdate(db_index_t *indexp,
+		char *name);
+
+/**
+@brief		Close an index opened by @ref init_index.
+@param		indexp		A pointer to the index to close.
+@returns	The result of closing the index's file.
+*/
+db_int close_index(db_index_t *indexp);
+
 /**
 @brief		An index offset type.
 */
 typedef long db_index_offset_t;
 
+/**
+@brief		Find how wide the keys of a B+tree, skip list or hash index on
+		an expression are.
+@details	An integer key is as wide as an integer, and a string
+		attribute as wide as the attribute.  Other string expressions
+		can not be keys, since their width is not known.
+@param		exprp		A pointer to the indexed expression.
+@param		hp		The header of the relation the expression is
+				over.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	The number of bytes in each key, or @c 0 if the expression
+		can not be a key or its keys would be wider than
+		@ref DB_CTCONF_SETTING_INDEX_MAXKEYSIZE.
+*/
+db_int db_index_keysize(db_eet_t *exprp,
+		relation_header_t *hp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Make the index key for an integer.
+@param		keyp		A pointer to where the key will be written.
+@param		value		The integer.
+*/
+void db_index_intkey(db_index_key_t *keyp,
+		db_int value);
+
+/**
+@brief		Make the index key for a string.
+@param		keyp		A pointer to where the key will be written.
+@param		value		The string.
+@param		size		The width of the index's keys.
+@returns	@c 1 if the key was made, @c 0 if the string, with its
+		null-byte, is wider than the keys, so no key can equal it.
+*/
+db_int db_index_stringkey(db_index_key_t *keyp,
+		char *value,
+		db_int size);
+
+/**
+@brief		Make the index key for the value of an expression over a
+		tuple.
+@param		exprp		A pointer to the expression.
+@param		tp		A pointer to the tuple.
+@param		hp		The header of the tuple's relation.
+@param		keysize		The width of the index's keys.
+@param		keyp		A pointer to where the key will be written.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the key was made, @c 2 if the value is NULL, @c 0 if
+		it is a string no key can equal, and @c -1 if it could not be
+		found.
+*/
+db_int db_index_evalkey(db_eet_t *exprp,
+		db_tuple_t *tp,
+		relation_header_t *hp,
+		db_int keysize,
+		db_index_key_t *keyp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Find how many bytes of attributes stored with an index's keys
+		each of its entries holds.
+@details	Each entry's payload is a bit for each attribute, set where
+		it is NULL, followed by the attributes' bytes.
+@param		hp		The header of the indexed relation.
+@param		include		The positions of the attributes.
+@param		num_include	The number of attributes in @p include.
+@returns	The number of bytes in each entry's payload.
+*/
+db_int db_index_payloadsize(relation_header_t *hp,
+		db_uint8 *include,
+		db_uint8 num_include);
+
+/**
+@brief		Check if an index holds an attribute, either as its key or
+		stored with it.
+@param		metap		A pointer to the relation's index metadata.
+@param		indexon		Which index to check.
+@param		pos		The position of the attribute.
+@returns	@c 1 if the index holds the attribute, @c 0 otherwise.
+*/
+db_int db_index_covers(db_index_meta_t *metap,
+		db_uint8 indexon,
+		db_uint8 pos);
+
+/**
+@brief		Create an empty index, replacing any index of the same name.
+@details	Only B+tree, skip list and hash indexes can be created this
+		way.  The index must
+		still be listed in its relation's index metadata to be used.
+@param		name		The name of the index.
+@param		type		The type of index to create.
+@param		keysize		The number of bytes in each key, found by
+				@ref db_index_keysize.
+@param		payloadsize	The number of bytes stored after each key,
+				found by @ref db_index_payloadsize.
+@returns	@c 1 if the index was created, @c 0 otherwise.
+*/
+db_int db_index_create(char *name,
+		db_uint8 type,
+		db_int keysize,
+		db_int payloadsize);
+
+/**
+@brief		Check if an index of some name exists.
+@param		name		The name of the index.
+@returns	@c 1 if the index exists, @c 0 otherwise.
+*/
+db_int db_index_exists(char *name);
+
+/**
+@brief		Delete an index.
+@details	The index must not be listed in any relation's index metadata.
+@param		name		The name of the index.
+@returns	@c 1 if the index was deleted, @c 0 otherwise.
+*/
+db_int db_index_remove(char *name);
+
+/**
+@brief		Build an index over all of a relation's tuples, replacing any
+		index of the same name.
+@details	For a B+tree, skip list or hash index, the keys are gathered
+		as many at a time as query memory allows, and each batch is
+		sorted before it is added, so a B+tree's pages are filled in
+		order.  These indexes take a single expression, and may
+		store some of the relation's attributes with each key, so
+		queries needing nothing else never read the relation.  An
+		inline index is only written if the relation is already in
+		order on its expressions, and stores nothing more.  The
+		index must still be listed in its relation's index metadata
+		to be used.
+@param		name		The name of the index.
+@param		type		The type of index to build.
+@param		sp		A pointer to a scan of the relation.  It is
+				rewound, and left past its last tuple.
+@param		exprs		The indexed expressions, set up to be
+				evaluated over the scan's tuples.
+@param		num_expr	The number of expressions in @p exprs.
+@param		include		The positions of the attributes to store
+				with each key.
+@param		num_include	The number of attributes in @p include.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the index was built, @c -1 if an inline index was
+		asked for but the relation is not in order, @c 0 otherwise.
+*/
+db_int db_index_build(char *name,
+		db_uint8 type,
+		scan_t *sp,
+		db_eet_t *exprs,
+		db_uint8 num_expr,
+		db_uint8 *include,
+		db_uint8 num_include,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Add an index to a relation's index metadata, so that queries
+		over the relation can use it.
+@param		relationname	The name of the relation.
+@param		name		The name of the index.
+@param		exprs		The indexed expressions.
+@param		num_expr	The number of expressions in @p exprs.
+@param		include		The positions of the attributes stored with
+				each key.
+@param		num_include	The number of attributes in @p include.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the index was added, @c 0 otherwise.
+*/
+db_int db_index_register(char *relationname,
+		char *name,
+		db_eet_t *exprs,
+		db_uint8 num_expr,
+		db_uint8 *include,
+		db_uint8 num_include,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Remove an index from a relation's index metadata and delete
+		it.
+@param		relationname	The name of the relation.
+@param		name		The name of the index.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the index was dropped, @c 0 if the relation has no
+		such index or it could not be removed.
+*/
+db_int db_index_drop(char *relationname,
+		char *name,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Add an entry for a tuple to an index.
+@param		indexp		A pointer to the index, opened by
+				@ref init_index_forupdate.
+@param		entryp		The key of the indexed expression's value for
+				the tuple, as wide as the index's keys, then
+				the payload of the attributes stored with it.
+@param		offset		The offset of the tuple's record in its
+				relation's file.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the entry was added, @c 0 otherwise.
+*/
+db_int db_index_insert(db_index_t *indexp,
+		unsigned char *entryp,
+		db_index_offset_t offset,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Take a tuple's entry out of an index.
+@param		indexp		A pointer to the index, opened by
+				@ref init_index_forupdate.
+@param		keyp		A pointer to the key of the indexed
+				expression's value for the tuple when its
+				entry was added.
+@param		offset		The offset of the tuple's record in its
+				relation's file.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the entry was found and taken out, @c 0 otherwise.
+*/
+db_int db_index_delete(db_index_t *indexp,
+		db_index_key_t *keyp,
+		db_index_offset_t offset,
+		db_query_mm_t *mmp);
+
+/**
+@brief		All of a relation's indexes, kept open while a batch of its
+		tuples are written.
+*/
+typedef struct db_index_writer
+{
+	char		*relationname;	/**< The name of the relation. */
+	relation_header_t *hp;		/**< The relation's header. */
+	long		tuple_start;	/**< The offset of the relation's
+					     first record. */
+	db_int		recordsize;	/**< The number of bytes in each
+					     record. */
+	db_fileref_t	relation;	/**< The relation's file, open for
+					     reading if it has inline indexes,
+					     or @c DB_STORAGE_NOFILE. */
+	db_index_meta_t	meta;		/**< The relation's index metadata. */
+	db_index_t	*indexes;	/**< Each index, open for update, or
+					     with type @c DB_INDEX_TYPE_NONE
+					     if it can not be kept up. */
+	db_uint8	*unordered;	/**< For each index, @c 1 if it is
+					     inline and a write has put the
+					     relation out of its order. */
+} db_index_writer_t;
+
+/**
+@brief		Open all of a relation's indexes, so that tuples written to
+		the relation can be reflected in them.
+@details	The index metadata is read and each index opened once, however
+		many tuples are written before the writer is closed.
+@param		wp		A pointer to the writer to initialize.
+@param		relationname	The name of the relation.  It must stay valid
+				until the writer is closed.
+@param		hp		A pointer to the relation's header.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the writer was initialized, @c 0 otherwise.
+*/
+db_int init_index_writer(db_index_writer_t *wp,
+		char *relationname,
+		relation_header_t *hp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Bring a relation's indexes up to date with a tuple that has
+		just been written to its file.
+@details	For B+tree, skip list and hash indexes, an entry whose key
+		changed is taken out and added again, and entries whose key
+		did not change are left alone.  For inline indexes, the tuple
+		is checked against the records around it.
+@param		wp		A pointer to the writer.
+@param		oldtp		A pointer to the tuple the record held before,
+				or @c NULL if the record is new.
+@param		newtp		A pointer to the tuple the record now holds.
+@param		offset		The offset of the record in the relation's
+				file.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if every index that could be kept up was, @c 0 otherwise.
+*/
+db_int db_index_writetuple(db_index_writer_t *wp,
+		db_tuple_t *oldtp,
+		db_tuple_t *newtp,
+		db_index_offset_t offset,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Finish writing to a relation's indexes and close them.
+@details	Inline indexes still in order are made to cover every record.
+		An inline index the relation is no longer in order for is
+		rebuilt as a B+tree if it has a single integer expression, and
+		dropped otherwise, so the relation must no longer be open for
+		writing.
+@param		wp		A pointer to the writer.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if every index was left up to date or replaced, @c 0
+		otherwise.
+*/
+db_int close_index_writer(db_index_writer_t *wp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Add entries for a new tuple to each of its relation's indexes.
+@details	The tuple's record must already be at the end of the
+		relation's file.  See @ref db_index_writetuple for how each
+		index is kept up.
+@param		relationname	The name of the tuple's relation.
+@param		hp		A pointer to the relation's header.
+@param		tp		A pointer to the tuple.
+@param		offset		The offset of the tuple's record in the
+				relation's file.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if every index that could take the tuple did, @c 0
+		otherwise.
+*/
+db_int db_index_addtuple(char *relationname,
+		relation_header_t *hp,
+		db_tuple_t *tp,
+		db_index_offset_t offset,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Position a cursor at the first entry of an index whose key is
+		no smaller than a given key.
+@param		cp		A pointer to the cursor.  Its index file,
+				type and bounds must already be set.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the cursor was positioned, @c 0 otherwise.
+*/
+db_int db_index_seekcursor(db_index_cursor_t *cp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Find the offset of the tuple of the next entry a cursor is at.
+@param		cp		A pointer to the cursor.
+@param		offsetp		A pointer to where the offset will be written.
+@returns	@c 1 if there was another entry within the cursor's bounds,
+		@c 0 otherwise.
+*/
+db_int db_index_nextoffset(db_index_cursor_t *cp,
+		db_index_offset_t *offsetp);
+
+/**
+@brief		Make the next tuple of a scan following an index straight
+		from the index's entry, without reading the relation.
+@details	Only the attributes the index holds are set, and the rest
+		are left NULL, so the scan's tuples must not be asked for any
+		other.
+@param		sp		The scan operator.  It must be following an
+				index, set up by @ref scan_findrange.
+@param		tp		A pointer to where the tuple will be written.
+@param		offsetp		A pointer to where the offset of the tuple's
+				record will be written.
+@returns	@c 1 if there was another entry within the cursor's bounds,
+		@c 0 otherwise.
+*/
+db_int db_index_nextcovered(scan_t *sp,
+		db_tuple_t *tp,
+		db_index_offset_t *offsetp);
+
+/**
+@brief		Close a cursor's index, if it has one open.
+@param		cp		A pointer to the cursor.
+*/
+void db_index_closecursor(db_index_cursor_t *cp);
+
+/**
+@brief		Make a scan return only the tuples whose indexed value lies in
+		a range, in the order of the index.
+@details	The scan follows the index's entries until it is closed or
+		given another range, and rewinding it starts the range over.  Only
+		indexes that do not depend on the relation's order can be
+		used this way, and hash indexes only for ranges of one key.
+@param		sp		The scan operator.
+@param		indexon		Which index to use.
+@param		lowp		A pointer to the key of the smallest value to
+				return.
+@param		highp		A pointer to the key of the largest value to
+				return.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the scan now follows the index, @c 0 otherwise.
+*/
+db_int scan_findrange(scan_t *sp,
+		db_uint8 indexon,
+		db_index_key_t *lowp,
+		db_index_key_t *highp,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Make a scan of a relation kept in order by an inline index
+		return only the tuples whose keys lie in a range.
+@details	A key is compared on its first few expressions only, so a
+		range can be given on a prefix of the key, with a range on
+		the expression after it, like all the readings of one device
+		over some time.  Both ends of the range are found by binary
+		search, so the scan starts at the first tuple whose key is no
+		smaller than @p lowtp's, and stops before the first whose
+		key is bigger than @p hightp's, even after it is rewound.
+@param		sp		The scan operator.
+@param		indexon		Which index to use.
+@param		lowtp		A tuple of the relation holding the low key.
+@param		numlow		How many of the key's expressions to compare
+				to the low key, or @c 0 to start at the first
+				tuple.
+@param		hightp		A tuple of the relation holding the high key.
+@param		numhigh		How many of the key's expressions to compare
+				to the high key, or @c 0 to read until the
+				last tuple.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the scan now reads the range, @c 0 otherwise.
+*/
+db_int scan_findkeyrange(scan_t *sp,
+		db_uint8 indexon,
+		db_tuple_t *lowtp,
+		db_uint8 numlow,
+		db_tuple_t *hightp,
+		db_uint8 numhigh,
+		db_query_mm_t *mmp);
+
 /**
 @brief		Find the next tuple from an indexed scan based on another
 		tuple.
@@ -28,6 +28,10 @@
 extern "C" {
 #endif
 
+#include "../ref.h"
+#include "../dbstorage/dbstorage.h"
+#include "../dblogic/eet.h"
+
 /**
 @brief		In-memory metadata for all indexing information of a
 		relation.
@@ -42,8 +46,58 @@ typedef struct db_index_meta
 					     each index. */
 	db_eet_t	**exprs;	/**< Array of expressions for each
 					     index. */
+	db_uint8	*num_include;	/**< The number of attributes stored
+					     with each index's keys. */
+	db_uint8	**include;	/**< The positions of the attributes
+					     stored with each index's keys,
+					     or @c NULL where there are
+					     none. */
 } db_index_meta_t;
 
+/**
+@brief		A key of a B+tree, skip list or hash index.
+@details	Keys are compared a byte at a time, and only as many bytes as
+		the index's keys are wide are used.  An integer is written most
+		significant byte first, with its sign bit flipped, so integers
+		compare in the same order as their values.  A string is padded
+		with null-bytes to the width of its attribute.
+*/
+typedef struct db_index_key
+{
+	unsigned char	bytes[DB_CTCONF_SETTING_INDEX_MAXKEYSIZE];
+					/**< The key's bytes. */
+} db_index_key_t;
+
+/**
+@brief		A position in an index's entries, in key order.
+@details	Entries are returned while their keys lie between @p low and
+		@p high.
+*/
+typedef struct db_index_cursor
+{
+	db_fileref_t	indexref;	/**< The open index file, or
+					     @c DB_STORAGE_NOFILE if the
+					     cursor is not in use. */
+	db_int8		indexon;	/**< Which of the relation's indexes
+					     is open. */
+	db_uint8	type;		/**< The type of the open index. */
+	db_int		pagesize;	/**< The number of bytes in each page
+					     of the index. */
+	long		page;		/**< Where the next entry is, or @c 0
+					     once past the last.  For a
+					     B+tree, this is the page holding
+					     it, and for a skip list, the
+					     offset of its node. */
+	db_int		slot;		/**< The position of the next entry in
+					     its page, for a B+tree. */
+	db_uint8	keysize;	/**< The number of bytes in each of
+					     the index's keys. */
+	db_int		payloadsize;	/**< The number of bytes stored
+					     after each key. */
+	db_index_key_t	low;		/**< The smallest key to return. */
+	db_index_key_t	high;		/**< The largest key to return. */
+} db_index_cursor_t;
+
 #ifdef __cplusplus
 }
 #endif
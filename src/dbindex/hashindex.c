@@ -0,0 +1,528 @@
+/******************************************************************************/
+/**
+@file		hashindex.c
+@author		Graeme Douglas
+@brief		A disk-resident linear hash table mapping fixed-width keys to
+		tuple offsets.
+@see		For more information, please refer to @ref hashindex.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+#include "hashindex.h"
+#include <string.h>
+
+/* Where the header starts, just after the index's type. */
+#define HASHINDEX_HEADER_OFFSET 1
+
+/* The number of buckets a new table has. */
+#define HASHINDEX_FIRSTBUCKETS 4
+
+/* The most times the number of buckets may double. */
+#define HASHINDEX_MAXLEVEL 24
+
+/* The number of bytes an entry takes, given the width of what follows its
+   value. */
+#define HASHINDEX_ENTRYSIZE(width) (sizeof(long) + (size_t)(width))
+
+/* The table's header, at the start of the first pages.  Buckets are added in
+   groups, each as big as all those before it, and each group's pages are
+   kept together so a bucket's page can be worked out directly. */
+typedef struct {
+  db_int pagesize;    /* The number of bytes in each page. */
+  db_uint8 keysize;   /* The number of bytes in each key. */
+  db_int payloadsize; /* The number of bytes stored after each key. */
+  db_uint8 level;     /* The number of times the buckets have doubled. */
+  long split;         /* The next bucket to split. */
+  long numentries;    /* The number of entries. */
+  long numpages;      /* The number of pages, including the header's. */
+  long freepage;      /* The first overflow page no longer used, or 0. */
+  long groups[HASHINDEX_MAXLEVEL + 1]; /* The first page of each group of
+                                          buckets. */
+} hashindex_header_t;
+
+/* The start of every page of a bucket.  The page's entries follow, each a
+   value followed by a key and the entry's payload. */
+typedef struct {
+  db_int count; /* The number of entries in the page. */
+  long link;    /* The next overflow page of the bucket, or 0. */
+} hashindex_pagehead_t;
+
+/* Find how many bytes each entry of a table takes. */
+static size_t hashindex_entrysize(hashindex_header_t *headerp) {
+  return HASHINDEX_ENTRYSIZE((db_int)(headerp->keysize) +
+                             headerp->payloadsize);
+}
+
+/* Find how many entries fit in a page. */
+static db_int hashindex_capacity(hashindex_header_t *headerp) {
+  return (headerp->pagesize - (db_int)sizeof(hashindex_pagehead_t)) /
+         (db_int)hashindex_entrysize(headerp);
+}
+
+/* Find where an entry of a page is. */
+static unsigned char *hashindex_entry(unsigned char *entries,
+                                      size_t entrysize, db_int i) {
+  return entries + (size_t)i * entrysize;
+}
+
+static long hashindex_getvalue(unsigned char *entryp) {
+  long value;
+  memcpy(&value, entryp, sizeof(long));
+  return value;
+}
+
+/* Find where an entry is in the file. */
+static long hashindex_entryat(hashindex_header_t *headerp, long page,
+                              db_int i) {
+  return page * headerp->pagesize + (long)sizeof(hashindex_pagehead_t) +
+         i * (long)hashindex_entrysize(headerp);
+}
+
+/* Move a file's position to some offset from its start. */
+static void hashindex_seekto(db_fileref_t f, long offset) {
+  db_filerewind(f);
+  db_fileseek(f, (size_t)offset);
+}
+
+/* Write zeroes up to the end of a page. */
+static db_int hashindex_pad(db_fileref_t f, db_int numbytes) {
+  unsigned char zeroes[16];
+  db_int towrite;
+  memset(zeroes, 0, sizeof(zeroes));
+  while (numbytes > 0) {
+    towrite = numbytes < (db_int)sizeof(zeroes) ? numbytes
+                                                : (db_int)sizeof(zeroes);
+    if ((size_t)towrite != db_filewrite(f, zeroes, (size_t)towrite))
+      return 0;
+    numbytes -= towrite;
+  }
+  return 1;
+}
+
+static db_int hashindex_readheader(db_fileref_t f,
+                                   hashindex_header_t *headerp) {
+  hashindex_seekto(f, HASHINDEX_HEADER_OFFSET);
+  return sizeof(hashindex_header_t) ==
+             db_fileread(f, (unsigned char *)headerp,
+                         sizeof(hashindex_header_t)) &&
+         headerp->keysize > 0 &&
+         headerp->keysize <= DB_CTCONF_SETTING_INDEX_MAXKEYSIZE &&
+         headerp->payloadsize >= 0;
+}
+
+static db_int hashindex_writeheader(db_fileref_t f,
+                                    hashindex_header_t *headerp) {
+  hashindex_seekto(f, HASHINDEX_HEADER_OFFSET);
+  return sizeof(hashindex_header_t) ==
+         db_filewrite(f, headerp, sizeof(hashindex_header_t));
+}
+
+static db_int hashindex_readhead(db_fileref_t f, db_int pagesize, long page,
+                                 hashindex_pagehead_t *headp) {
+  hashindex_seekto(f, page * pagesize);
+  return sizeof(hashindex_pagehead_t) ==
+         db_fileread(f, (unsigned char *)headp, sizeof(hashindex_pagehead_t));
+}
+
+/* Write a page, filling the rest of it. */
+static db_int hashindex_writepage(db_fileref_t f, hashindex_header_t *headerp,
+                                  long page, hashindex_pagehead_t *headp,
+                                  unsigned char *entries) {
+  size_t size = (size_t)headp->count * hashindex_entrysize(headerp);
+  hashindex_seekto(f, page * headerp->pagesize);
+  if (sizeof(hashindex_pagehead_t) !=
+          db_filewrite(f, headp, sizeof(hashindex_pagehead_t)) ||
+      (size > 0 && size != db_filewrite(f, entries, size)))
+    return 0;
+  return hashindex_pad(f, headerp->pagesize -
+                              (db_int)sizeof(hashindex_pagehead_t) -
+                              (db_int)size);
+}
+
+/* Hash a key's bytes, then spread the bits out, so keys that differ only a
+   little land in different buckets. */
+static db_uint32 hashindex_hash(unsigned char *key, db_uint8 keysize) {
+  db_uint32 h = 2166136261u;
+  db_int i;
+  for (i = 0; i < (db_int)keysize; ++i)
+    h = (h ^ key[i]) * 16777619u;
+  h ^= h >> 16;
+  h *= 0x45d9f3bu;
+  h ^= h >> 16;
+  return h;
+}
+
+/* Find which bucket a key belongs in. */
+static long hashindex_bucket(hashindex_header_t *headerp,
+                             unsigned char *key) {
+  db_uint32 h = hashindex_hash(key, headerp->keysize);
+  long bucket = (long)(h % ((db_uint32)HASHINDEX_FIRSTBUCKETS << headerp->level));
+  if (bucket < headerp->split)
+    bucket = (long)(h % ((db_uint32)HASHINDEX_FIRSTBUCKETS
+                         << (headerp->level + 1)));
+  return bucket;
+}
+
+/* Find the first page of a bucket. */
+static long hashindex_bucketpage(hashindex_header_t *headerp, long bucket) {
+  db_int group = 0;
+  long first = 0, size = HASHINDEX_FIRSTBUCKETS;
+  while (bucket >= first + size) {
+    first += size;
+    size = first;
+    group++;
+  }
+  return headerp->groups[group] + bucket - first;
+}
+
+/* Get a page to hold more of a bucket's entries. */
+static long hashindex_newpage(db_fileref_t f, hashindex_header_t *headerp) {
+  hashindex_pagehead_t head;
+  long page = headerp->freepage;
+
+  if (0 != page) {
+    if (1 != hashindex_readhead(f, headerp->pagesize, page, &head))
+      return 0;
+    headerp->freepage = head.link;
+  } else {
+    page = headerp->numpages++;
+  }
+
+  head.count = 0;
+  head.link = 0;
+  if (1 != hashindex_writepage(f, headerp, page, &head, NULL))
+    return 0;
+  return page;
+}
+
+/* Add an entry to the end of a bucket. */
+static db_int hashindex_append(db_fileref_t f, hashindex_header_t *headerp,
+                               long bucket, unsigned char *entryp) {
+  hashindex_pagehead_t head;
+  size_t entrysize = hashindex_entrysize(headerp);
+  long page = hashindex_bucketpage(headerp, bucket), newpage;
+
+  while (1) {
+    if (1 != hashindex_readhead(f, headerp->pagesize, page, &head))
+      return 0;
+    if (head.count < hashindex_capacity(headerp))
+      break;
+    if (0 == head.link) {
+      newpage = hashindex_newpage(f, headerp);
+      if (0 == newpage)
+        return 0;
+      head.link = newpage;
+      hashindex_seekto(f, page * headerp->pagesize);
+      if (sizeof(hashindex_pagehead_t) !=
+          db_filewrite(f, &head, sizeof(hashindex_pagehead_t)))
+        return 0;
+    }
+    page = head.link;
+  }
+
+  hashindex_seekto(f, hashindex_entryat(headerp, page, head.count));
+  if (entrysize != db_filewrite(f, entryp, entrysize))
+    return 0;
+  head.count++;
+  hashindex_seekto(f, page * headerp->pagesize);
+  return sizeof(hashindex_pagehead_t) ==
+         db_filewrite(f, &head, sizeof(hashindex_pagehead_t));
+}
+
+/* Start the next round of splits once every bucket has been split. */
+static db_int hashindex_endround(hashindex_header_t *headerp) {
+  if (headerp->split == ((long)HASHINDEX_FIRSTBUCKETS << headerp->level)) {
+    headerp->level++;
+    headerp->split = 0;
+  }
+  return 1;
+}
+
+/* Split the next bucket in two, moving the entries that now belong in the
+   new bucket.  The entries that stay are packed into the bucket's first
+   pages, and its pages left over are freed. */
+static db_int hashindex_split(db_fileref_t f, hashindex_header_t *headerp,
+                              unsigned char *keep, unsigned char *move) {
+  hashindex_pagehead_t head, keephead, movehead;
+  size_t entrysize = hashindex_entrysize(headerp);
+  unsigned char entry[entrysize];
+  db_int capacity = hashindex_capacity(headerp), i;
+  long bucket = headerp->split;
+  long newbucket = bucket + ((long)HASHINDEX_FIRSTBUCKETS << headerp->level);
+  long page, keeppage, movepage, newpage;
+
+  /* The first split of a round makes room for the whole next group. */
+  if (0 == bucket) {
+    if (HASHINDEX_MAXLEVEL == headerp->level)
+      return 1;
+    headerp->groups[headerp->level + 1] = headerp->numpages;
+    movehead.count = 0;
+    movehead.link = 0;
+    for (i = 0; i < (db_int)(newbucket - bucket); ++i)
+      if (1 != hashindex_writepage(f, headerp, headerp->numpages++,
+                                   &movehead, NULL))
+        return 0;
+  }
+
+  headerp->split++;
+  page = keeppage = hashindex_bucketpage(headerp, bucket);
+  movepage = hashindex_bucketpage(headerp, newbucket);
+  keephead.count = 0;
+  movehead.count = 0;
+
+  while (0 != page) {
+    if (1 != hashindex_readhead(f, headerp->pagesize, page, &head))
+      return 0;
+    for (i = 0; i < head.count; ++i) {
+      hashindex_seekto(f, hashindex_entryat(headerp, page, i));
+      if (entrysize != db_fileread(f, entry, entrysize))
+        return 0;
+
+      if (newbucket == hashindex_bucket(headerp, entry + sizeof(long))) {
+        memcpy(hashindex_entry(move, entrysize, movehead.count++), entry,
+               entrysize);
+        if (capacity == movehead.count) {
+          newpage = hashindex_newpage(f, headerp);
+          movehead.link = newpage;
+          if (0 == newpage ||
+              1 != hashindex_writepage(f, headerp, movepage, &movehead,
+                                       move))
+            return 0;
+          movepage = newpage;
+          movehead.count = 0;
+        }
+      } else {
+        memcpy(hashindex_entry(keep, entrysize, keephead.count++), entry,
+               entrysize);
+        /* Every entry of the page written over has been read by now. */
+        if (capacity == keephead.count) {
+          if (1 != hashindex_readhead(f, headerp->pagesize, keeppage,
+                                      &keephead))
+            return 0;
+          keephead.count = capacity;
+          if (1 != hashindex_writepage(f, headerp, keeppage, &keephead,
+                                       keep))
+            return 0;
+          keeppage = keephead.link;
+          keephead.count = 0;
+        }
+      }
+    }
+    page = head.link;
+  }
+
+  movehead.link = 0;
+  if (1 != hashindex_writepage(f, headerp, movepage, &movehead, move))
+    return 0;
+
+  /* Pages after the last one kept are no longer needed.  If the kept
+     entries filled every page, there are none. */
+  if (0 == keeppage)
+    return hashindex_endround(headerp);
+  if (1 != hashindex_readhead(f, headerp->pagesize, keeppage, &head))
+    return 0;
+  page = head.link;
+  keephead.link = 0;
+  if (1 != hashindex_writepage(f, headerp, keeppage, &keephead, keep))
+    return 0;
+  while (0 != page) {
+    if (1 != hashindex_readhead(f, headerp->pagesize, page, &head))
+      return 0;
+    newpage = head.link;
+    head.count = 0;
+    head.link = headerp->freepage;
+    if (1 != hashindex_writepage(f, headerp, page, &head, NULL))
+      return 0;
+    headerp->freepage = page;
+    page = newpage;
+  }
+
+  return hashindex_endround(headerp);
+}
+
+db_int hashindex_create(db_fileref_t f, db_int pagesize, db_uint8 keysize,
+                        db_int payloadsize) {
+  hashindex_header_t header;
+  hashindex_pagehead_t head;
+  long page, headerpages;
+
+  memset(&header, 0, sizeof(header));
+  header.pagesize = pagesize;
+  header.keysize = keysize;
+  header.payloadsize = payloadsize;
+  if (0 == keysize || keysize > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE ||
+      payloadsize < 0 || hashindex_capacity(&header) < 2)
+    return 0;
+
+  /* Small pages may need several to hold the header. */
+  headerpages = (HASHINDEX_HEADER_OFFSET + (long)sizeof(hashindex_header_t) +
+                 pagesize - 1) /
+                pagesize;
+  header.groups[0] = headerpages;
+  header.numpages = headerpages + HASHINDEX_FIRSTBUCKETS;
+  if (sizeof(hashindex_header_t) !=
+          db_filewrite(f, &header, sizeof(hashindex_header_t)) ||
+      1 != hashindex_pad(f, (db_int)(headerpages * pagesize -
+                                     HASHINDEX_HEADER_OFFSET -
+                                     (long)sizeof(hashindex_header_t))))
+    return 0;
+
+  head.count = 0;
+  head.link = 0;
+  for (page = headerpages; page < header.numpages; ++page)
+    if (1 != hashindex_writepage(f, &header, page, &head, NULL))
+      return 0;
+  return 1;
+}
+
+db_int hashindex_insert(db_fileref_t f, unsigned char *key, long value,
+                        db_query_mm_t *mmp) {
+  hashindex_header_t header;
+  unsigned char *keep, *move;
+  db_int capacity, retval = 1;
+  long numbuckets;
+
+  if (1 != hashindex_readheader(f, &header))
+    return 0;
+  capacity = hashindex_capacity(&header);
+
+  unsigned char entry[hashindex_entrysize(&header)];
+  memcpy(entry, &value, sizeof(long));
+  memcpy(entry + sizeof(long), key,
+         hashindex_entrysize(&header) - sizeof(long));
+  if (1 != hashindex_append(f, &header, hashindex_bucket(&header, key),
+                            entry))
+    return 0;
+  header.numentries++;
+
+  /* Keep buckets about three quarters full. */
+  numbuckets = ((long)HASHINDEX_FIRSTBUCKETS << header.level) + header.split;
+  if (4 * header.numentries > 3 * numbuckets * capacity) {
+    keep = DB_QMM_BALLOC(mmp, 2 * (size_t)capacity *
+                                  hashindex_entrysize(&header));
+    if (NULL == keep)
+      return 0;
+    move = hashindex_entry(keep, hashindex_entrysize(&header), capacity);
+    retval = hashindex_split(f, &header, keep, move);
+    DB_QMM_BFREE(mmp, keep);
+  }
+
+  return 1 == hashindex_writeheader(f, &header) && 1 == retval;
+}
+
+db_int hashindex_delete(db_fileref_t f, unsigned char *key, long value) {
+  hashindex_header_t header;
+  hashindex_pagehead_t head;
+  size_t entrysize;
+  db_int i;
+  long page;
+
+  if (1 != hashindex_readheader(f, &header))
+    return 0;
+  entrysize = hashindex_entrysize(&header);
+  unsigned char entry[entrysize];
+
+  /* The page's last entry takes the place of the one taken out.  Pages
+     left empty stay in the bucket. */
+  for (page = hashindex_bucketpage(&header, hashindex_bucket(&header, key));
+       0 != page; page = head.link) {
+    if (1 != hashindex_readhead(f, header.pagesize, page, &head))
+      return 0;
+    for (i = 0; i < head.count; ++i) {
+      hashindex_seekto(f, hashindex_entryat(&header, page, i));
+      if (entrysize != db_fileread(f, entry, entrysize))
+        return 0;
+      if (hashindex_getvalue(entry) != value ||
+          0 != memcmp(entry + sizeof(long), key, (size_t)header.keysize))
+        continue;
+
+      head.count--;
+      if (i < head.count) {
+        hashindex_seekto(f, hashindex_entryat(&header, page, head.count));
+        if (entrysize != db_fileread(f, entry, entrysize))
+          return 0;
+        hashindex_seekto(f, hashindex_entryat(&header, page, i));
+        if (entrysize != db_filewrite(f, entry, entrysize))
+          return 0;
+      }
+      hashindex_seekto(f, page * header.pagesize);
+      if (sizeof(hashindex_pagehead_t) !=
+          db_filewrite(f, &head, sizeof(hashindex_pagehead_t)))
+        return 0;
+
+      header.numentries--;
+      return hashindex_writeheader(f, &header);
+    }
+  }
+
+  return 0;
+}
+
+long hashindex_numentries(db_fileref_t f) {
+  hashindex_header_t header;
+  if (1 != hashindex_readheader(f, &header))
+    return -1;
+  return header.numentries;
+}
+
+db_int hashindex_seek(db_index_cursor_t *cp) {
+  hashindex_header_t header;
+
+  if (1 != hashindex_readheader(cp->indexref, &header))
+    return 0;
+  cp->pagesize = header.pagesize;
+  cp->keysize = header.keysize;
+  cp->payloadsize = header.payloadsize;
+  cp->page = hashindex_bucketpage(&header,
+                                  hashindex_bucket(&header, cp->low.bytes));
+  cp->slot = 0;
+  return 1;
+}
+
+db_int hashindex_next(db_index_cursor_t *cp, long *valuep,
+                      unsigned char *entryp) {
+  hashindex_pagehead_t head;
+  size_t entrysize =
+      HASHINDEX_ENTRYSIZE((db_int)(cp->keysize) + cp->payloadsize);
+  unsigned char entry[entrysize];
+
+  while (0 != cp->page) {
+    if (1 != hashindex_readhead(cp->indexref, cp->pagesize, cp->page, &head))
+      break;
+    hashindex_seekto(cp->indexref, cp->page * cp->pagesize +
+                                       (long)sizeof(hashindex_pagehead_t) +
+                                       cp->slot * (long)entrysize);
+    while (cp->slot < head.count) {
+      if (entrysize != db_fileread(cp->indexref, entry, entrysize)) {
+        cp->page = 0;
+        return 0;
+      }
+      cp->slot++;
+      if (0 == memcmp(entry + sizeof(long), cp->low.bytes,
+                      (size_t)cp->keysize)) {
+        *valuep = hashindex_getvalue(entry);
+        if (NULL != entryp)
+          memcpy(entryp, entry + sizeof(long), entrysize - sizeof(long));
+        return 1;
+      }
+    }
+    cp->page = head.link;
+    cp->slot = 0;
+  }
+
+  cp->page = 0;
+  return 0;
+}
@@ -0,0 +1,124 @@
+/******************************************************************************/
+/**
+@file		hashindex.h
+@author		Graeme Douglas
+@brief		A disk-resident linear hash table mapping fixed-width keys to
+		tuple offsets.
+@details	The table lives in an index file after the byte giving the
+		index's type.  The file is split into pages of equal size.
+		The first pages hold the table's header, and every other page
+		holds one bucket, or an overflow page of one.  Buckets are
+		split one at a time as the table fills, so looking up a key
+		reads one bucket page, plus any overflow pages, no matter how
+		big the table grows.  Keys are hashed and compared a byte at a
+		time, and equal keys may appear any number of times.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef HASHINDEX_H
+#define HASHINDEX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../ref.h"
+#include "../dbmm/db_query_mm.h"
+#include "../dbstorage/dbstorage.h"
+#include "dbindex_types.h"
+
+/**
+@brief		Write out an empty hash table.
+@param		f		The index file, open for writing and
+				positioned just after the index's type.
+@param		pagesize	The number of bytes in each page.  A page
+				must hold at least two entries.
+@param		keysize		The number of bytes in each key, no more than
+				@ref DB_CTCONF_SETTING_INDEX_MAXKEYSIZE.
+@param		payloadsize	The number of bytes stored after each key.
+@returns	@c 1 if the table was written, @c 0 otherwise.
+*/
+db_int hashindex_create(db_fileref_t f,
+		db_int pagesize,
+		db_uint8 keysize,
+		db_int payloadsize);
+
+/**
+@brief		Add an entry to a hash table.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the table's keys,
+				followed by its payload.
+@param		value		The offset of the tuple the entry is for.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if the entry was added, @c 0 otherwise.
+*/
+db_int hashindex_insert(db_fileref_t f,
+		unsigned char *key,
+		long value,
+		db_query_mm_t *mmp);
+
+/**
+@brief		Take an entry out of a hash table.
+@details	Buckets never shrink, so a bucket's pages are kept even
+		once they are empty.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the table's keys.
+@param		value		The offset of the tuple the entry is for.
+@returns	@c 1 if the entry was found and taken out, @c 0 otherwise.
+*/
+db_int hashindex_delete(db_fileref_t f,
+		unsigned char *key,
+		long value);
+
+/**
+@brief		Find the number of entries in a hash table.
+@param		f		The index file.
+@returns	The number of entries, or @c -1 if the file could not be read.
+*/
+long hashindex_numentries(db_fileref_t f);
+
+/**
+@brief		Position a cursor at the bucket holding the cursor's @p low
+		key.
+@details	Only entries whose key is exactly @p low are returned, so
+		@p high is ignored.
+@param		cp		A pointer to the cursor.  Its index file and
+				bounds must be set.
+@returns	@c 1 if the cursor was positioned, @c 0 otherwise.
+*/
+db_int hashindex_seek(db_index_cursor_t *cp);
+
+/**
+@brief		Read the next entry with a cursor's key and move past it.
+@param		cp		A pointer to the cursor.
+@param		valuep		A pointer to where the entry's tuple offset
+				will be written.
+@param		entryp		Where the entry's key and payload will be
+				written, or @c NULL if they are not needed.
+@returns	@c 1 if there was an entry, @c 0 once past the last.
+*/
+db_int hashindex_next(db_index_cursor_t *cp,
+		long *valuep,
+		unsigned char *entryp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,330 @@
+/******************************************************************************/
+/**
+@file		skiplist.c
+@author		Graeme Douglas
+@brief		A file-backed skip list mapping fixed-width keys to tuple
+		offsets.
+@see		For more information, please refer to @ref skiplist.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "skiplist.h"
+#include <string.h>
+
+/* Where the header starts, just after the index's type. */
+#define SKIPLIST_HEADER_OFFSET 1
+
+/* The most levels a node may be on. */
+#define SKIPLIST_MAXLEVEL 16
+
+/* The list's header. */
+typedef struct {
+  long numentries;              /* The number of entries. */
+  db_uint32 seed;               /* Where picking levels for new nodes is
+                                   up to. */
+  db_uint8 level;               /* The most levels any node is on. */
+  db_uint8 keysize;             /* The number of bytes in each key. */
+  db_int payloadsize;           /* The number of bytes stored after each
+                                   key. */
+  long head[SKIPLIST_MAXLEVEL]; /* The first node on each level, or 0 if
+                                   there is none. */
+} skiplist_header_t;
+
+/* The start of every node.  Its key and payload follow, then the offset of
+   the next node on each of its levels, or 0 where it is the last. */
+typedef struct {
+  db_uint8 levels; /* The number of levels the node is on. */
+  long value;      /* The offset of the tuple the entry is for. */
+} skiplist_nodehead_t;
+
+/* Find how many bytes a node's key and payload take. */
+static db_int skiplist_width(skiplist_header_t *headerp) {
+  return (db_int)(headerp->keysize) + headerp->payloadsize;
+}
+
+/* Find where a node's link on some level is. */
+static long skiplist_linkat(long node, db_int width, db_int level) {
+  return node + (long)sizeof(skiplist_nodehead_t) + width +
+         level * (long)sizeof(long);
+}
+
+/* Move a file's position to some offset from its start. */
+static void skiplist_seekto(db_fileref_t f, long offset) {
+  db_filerewind(f);
+  db_fileseek(f, (size_t)offset);
+}
+
+static db_int skiplist_readheader(db_fileref_t f, skiplist_header_t *headerp) {
+  skiplist_seekto(f, SKIPLIST_HEADER_OFFSET);
+  return sizeof(skiplist_header_t) ==
+             db_fileread(f, (unsigned char *)headerp,
+                         sizeof(skiplist_header_t)) &&
+         headerp->keysize > 0 &&
+         headerp->keysize <= DB_CTCONF_SETTING_INDEX_MAXKEYSIZE &&
+         headerp->payloadsize >= 0;
+}
+
+static db_int skiplist_writeheader(db_fileref_t f,
+                                   skiplist_header_t *headerp) {
+  skiplist_seekto(f, SKIPLIST_HEADER_OFFSET);
+  return sizeof(skiplist_header_t) ==
+         db_filewrite(f, headerp, sizeof(skiplist_header_t));
+}
+
+/* Find the node after another on some level.  Node 0 is the header. */
+static db_int skiplist_getnext(db_fileref_t f, skiplist_header_t *headerp,
+                               long node, db_int level, long *nextp) {
+  if (0 == node) {
+    *nextp = headerp->head[level];
+    return 1;
+  }
+  skiplist_seekto(f, skiplist_linkat(node, skiplist_width(headerp), level));
+  return sizeof(long) == db_fileread(f, (unsigned char *)nextp, sizeof(long));
+}
+
+/* Set the node after another on some level.  The header is only changed in
+   memory. */
+static db_int skiplist_setnext(db_fileref_t f, skiplist_header_t *headerp,
+                               long node, db_int level, long next) {
+  if (0 == node) {
+    headerp->head[level] = next;
+    return 1;
+  }
+  skiplist_seekto(f, skiplist_linkat(node, skiplist_width(headerp), level));
+  return sizeof(long) == db_filewrite(f, &next, sizeof(long));
+}
+
+/* Read a node's key. */
+static db_int skiplist_getkey(db_fileref_t f, db_uint8 keysize, long node,
+                              unsigned char *key) {
+  skiplist_seekto(f, node + (long)sizeof(skiplist_nodehead_t));
+  return (size_t)keysize == db_fileread(f, key, (size_t)keysize);
+}
+
+/* Find, on each level, the last node whose key is smaller than a key, or,
+   if strict is 0, no bigger.  Node 0 is the header. */
+static db_int skiplist_find(db_fileref_t f, skiplist_header_t *headerp,
+                            unsigned char *key, db_uint8 strict,
+                            long *before) {
+  unsigned char nextkey[DB_CTCONF_SETTING_INDEX_MAXKEYSIZE];
+  long node = 0, next;
+  db_int level, result;
+
+  for (level = (db_int)headerp->level - 1; level >= 0; --level) {
+    while (1) {
+      if (1 != skiplist_getnext(f, headerp, node, level, &next))
+        return 0;
+      if (0 == next)
+        break;
+      if (1 != skiplist_getkey(f, headerp->keysize, next, nextkey))
+        return 0;
+      result = memcmp(nextkey, key, (size_t)headerp->keysize);
+      if (result > 0 || (strict && 0 == result))
+        break;
+      node = next;
+    }
+    before[level] = node;
+  }
+  return 1;
+}
+
+/* Pick how many levels a new node is on. */
+static db_uint8 skiplist_picklevels(skiplist_header_t *headerp) {
+  db_uint8 levels = 1;
+  while (levels < SKIPLIST_MAXLEVEL) {
+    headerp->seed = headerp->seed * 1103515245u + 12345u;
+    if (0 != ((headerp->seed >> 16) & 3))
+      break;
+    levels++;
+  }
+  return levels;
+}
+
+db_int skiplist_create(db_fileref_t f, db_uint8 keysize, db_int payloadsize) {
+  skiplist_header_t header;
+  if (0 == keysize || keysize > DB_CTCONF_SETTING_INDEX_MAXKEYSIZE ||
+      payloadsize < 0)
+    return 0;
+  memset(&header, 0, sizeof(header));
+  header.seed = 1;
+  header.level = 1;
+  header.keysize = keysize;
+  header.payloadsize = payloadsize;
+  return sizeof(skiplist_header_t) ==
+         db_filewrite(f, &header, sizeof(skiplist_header_t));
+}
+
+db_int skiplist_insert(db_fileref_t f, unsigned char *key, long value) {
+  skiplist_header_t header;
+  skiplist_nodehead_t head;
+  long before[SKIPLIST_MAXLEVEL];
+  long next, node;
+  db_int level;
+
+  if (1 != skiplist_readheader(f, &header) || 0 == header.level ||
+      header.level > SKIPLIST_MAXLEVEL)
+    return 0;
+
+  /* Equal keys go after those already there. */
+  if (1 != skiplist_find(f, &header, key, 0, before))
+    return 0;
+
+  memset(&head, 0, sizeof(head));
+  head.value = value;
+  head.levels = skiplist_picklevels(&header);
+  for (level = header.level; level < head.levels; ++level)
+    before[level] = 0;
+  if (head.levels > header.level)
+    header.level = head.levels;
+
+  /* The new node goes at the end of the file, pointing where the nodes
+     before it did. */
+  node = db_filesize(f);
+  if (node <= 0)
+    return 0;
+  skiplist_seekto(f, node);
+  if (sizeof(skiplist_nodehead_t) !=
+          db_filewrite(f, &head, sizeof(skiplist_nodehead_t)) ||
+      (size_t)skiplist_width(&header) !=
+          db_filewrite(f, key, (size_t)skiplist_width(&header)))
+    return 0;
+  for (level = 0; level < head.levels; ++level) {
+    if (1 != skiplist_getnext(f, &header, before[level], level, &next))
+      return 0;
+    skiplist_seekto(f, skiplist_linkat(node, skiplist_width(&header), level));
+    if (sizeof(long) != db_filewrite(f, &next, sizeof(long)))
+      return 0;
+  }
+
+  /* Only then do the nodes before it point to it. */
+  for (level = 0; level < head.levels; ++level)
+    if (1 != skiplist_setnext(f, &header, before[level], level, node))
+      return 0;
+
+  header.numentries++;
+  return skiplist_writeheader(f, &header);
+}
+
+db_int skiplist_delete(db_fileref_t f, unsigned char *key, long value) {
+  skiplist_header_t header;
+  skiplist_nodehead_t head;
+  unsigned char nextkey[DB_CTCONF_SETTING_INDEX_MAXKEYSIZE];
+  long before[SKIPLIST_MAXLEVEL];
+  long node, next, after;
+  db_int level;
+
+  if (1 != skiplist_readheader(f, &header) || 0 == header.level ||
+      header.level > SKIPLIST_MAXLEVEL ||
+      1 != skiplist_find(f, &header, key, 1, before))
+    return 0;
+
+  /* Find the node among those with the key. */
+  if (1 != skiplist_getnext(f, &header, before[0], 0, &node))
+    return 0;
+  while (1) {
+    if (0 == node)
+      return 0;
+    skiplist_seekto(f, node);
+    if (sizeof(skiplist_nodehead_t) !=
+            db_fileread(f, (unsigned char *)&head,
+                        sizeof(skiplist_nodehead_t)) ||
+        (size_t)header.keysize !=
+            db_fileread(f, nextkey, (size_t)header.keysize))
+      return 0;
+    if (0 != memcmp(nextkey, key, (size_t)header.keysize))
+      return 0;
+    if (head.value == value)
+      break;
+    if (1 != skiplist_getnext(f, &header, node, 0, &node))
+      return 0;
+  }
+
+  /* Nodes are only ever added at the end of the file, and equal keys after
+     those already there, so on every level the nodes with the key before
+     this one are at smaller offsets. */
+  for (level = 0; level < head.levels; ++level) {
+    while (1) {
+      if (1 != skiplist_getnext(f, &header, before[level], level, &next))
+        return 0;
+      if (0 == next || next >= node)
+        break;
+      if (1 != skiplist_getkey(f, header.keysize, next, nextkey))
+        return 0;
+      if (0 != memcmp(nextkey, key, (size_t)header.keysize))
+        break;
+      before[level] = next;
+    }
+    if (next != node)
+      return 0;
+    if (1 != skiplist_getnext(f, &header, node, level, &after) ||
+        1 != skiplist_setnext(f, &header, before[level], level, after))
+      return 0;
+  }
+
+  header.numentries--;
+  return skiplist_writeheader(f, &header);
+}
+
+long skiplist_numentries(db_fileref_t f) {
+  skiplist_header_t header;
+  if (1 != skiplist_readheader(f, &header))
+    return -1;
+  return header.numentries;
+}
+
+db_int skiplist_seek(db_index_cursor_t *cp) {
+  skiplist_header_t header;
+  long before[SKIPLIST_MAXLEVEL];
+
+  if (1 != skiplist_readheader(cp->indexref, &header) || 0 == header.level ||
+      header.level > SKIPLIST_MAXLEVEL ||
+      1 != skiplist_find(cp->indexref, &header, cp->low.bytes, 1, before) ||
+      1 != skiplist_getnext(cp->indexref, &header, before[0], 0, &(cp->page)))
+    return 0;
+  cp->keysize = header.keysize;
+  cp->payloadsize = header.payloadsize;
+  return 1;
+}
+
+db_int skiplist_next(db_index_cursor_t *cp, long *valuep,
+                     unsigned char *entryp) {
+  skiplist_nodehead_t head;
+  size_t width = (size_t)(cp->keysize) + (size_t)(cp->payloadsize);
+  unsigned char key[width];
+  long next;
+
+  if (0 == cp->page)
+    return 0;
+
+  skiplist_seekto(cp->indexref, cp->page);
+  if (sizeof(skiplist_nodehead_t) != db_fileread(cp->indexref,
+                                                 (unsigned char *)&head,
+                                                 sizeof(skiplist_nodehead_t)) ||
+      width != db_fileread(cp->indexref, key, width) ||
+      memcmp(key, cp->high.bytes, (size_t)cp->keysize) > 0 ||
+      sizeof(long) !=
+          db_fileread(cp->indexref, (unsigned char *)&next, sizeof(long))) {
+    cp->page = 0;
+    return 0;
+  }
+
+  cp->page = next;
+  *valuep = head.value;
+  if (NULL != entryp)
+    memcpy(entryp, key, width);
+  return 1;
+}
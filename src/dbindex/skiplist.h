@@ -0,0 +1,116 @@
+/******************************************************************************/
+/**
+@file		skiplist.h
+@author		Graeme Douglas
+@brief		A file-backed skip list mapping fixed-width keys to tuple
+		offsets.
+@details	The list lives in an index file after the byte giving the
+		index's type.  A header holding the first node of every level
+		comes first, and nodes are appended after it as entries are
+		added, so nothing already written moves.  Each node is on a
+		random number of levels, a quarter as many on each level as on
+		the one below, so finding where an entry goes takes a
+		logarithmic number of reads on average.  Keys are compared a
+		byte at a time, and equal keys may appear any number of times,
+		in the order they were added.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../ref.h"
+#include "../dbstorage/dbstorage.h"
+#include "dbindex_types.h"
+
+/**
+@brief		Write out an empty skip list.
+@param		f		The index file, open for writing and
+				positioned just after the index's type.
+@param		keysize		The number of bytes in each key, no more than
+				@ref DB_CTCONF_SETTING_INDEX_MAXKEYSIZE.
+@param		payloadsize	The number of bytes stored after each key.
+@returns	@c 1 if the list was written, @c 0 otherwise.
+*/
+db_int skiplist_create(db_fileref_t f,
+		db_uint8 keysize,
+		db_int payloadsize);
+
+/**
+@brief		Add an entry to a skip list.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the list's keys,
+				followed by its payload.
+@param		value		The offset of the tuple the entry is for.
+@returns	@c 1 if the entry was added, @c 0 otherwise.
+*/
+db_int skiplist_insert(db_fileref_t f,
+		unsigned char *key,
+		long value);
+
+/**
+@brief		Take an entry out of a skip list.
+@details	The entry's node is unlinked from every level, but its bytes
+		stay in the file.
+@param		f		The index file, open for reading and
+				writing.
+@param		key		The entry's key, as wide as the list's keys.
+@param		value		The offset of the tuple the entry is for.
+@returns	@c 1 if the entry was found and taken out, @c 0 otherwise.
+*/
+db_int skiplist_delete(db_fileref_t f,
+		unsigned char *key,
+		long value);
+
+/**
+@brief		Find the number of entries in a skip list.
+@param		f		The index file.
+@returns	The number of entries, or @c -1 if the file could not be read.
+*/
+long skiplist_numentries(db_fileref_t f);
+
+/**
+@brief		Position a cursor at the first entry whose key is no smaller
+		than the cursor's @p low key.
+@param		cp		A pointer to the cursor.  Its index file and
+				bounds must be set.
+@returns	@c 1 if the cursor was positioned, @c 0 otherwise.
+*/
+db_int skiplist_seek(db_index_cursor_t *cp);
+
+/**
+@brief		Read the entry a cursor is at and move past it.
+@param		cp		A pointer to the cursor.
+@param		valuep		A pointer to where the entry's tuple offset
+				will be written.
+@param		entryp		Where the entry's key and payload will be
+				written, or @c NULL if they are not needed.
+@returns	@c 1 if there was an entry, @c 0 once past the last.
+*/
+db_int skiplist_next(db_index_cursor_t *cp,
+		long *valuep,
+		unsigned char *entryp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
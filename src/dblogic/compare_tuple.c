@@ -86,9 +86,11 @@ db_int8 cmp_tuple(db_tuple_t *a, db_tuple_t *b, relation_header_t *hp_a,
       else if (2 != a_retval && 2 == b_retval) {
         cmp_result = 1;
       }
-      /* Case where neither are NULL. */
-      else {
-        cmp_result = a_int - b_int;
+      /* Case where neither are NULL.  Subtracting could overflow. */
+      else if (a_int < b_int) {
+        cmp_result = -1;
+      } else if (a_int > b_int) {
+        cmp_result = 1;
       }
     } else if (DB_EETNODE_CONST_DBSTRING == type) {
       char *a_string = NULL, *b_string = NULL;
@@ -137,14 +139,20 @@ db_int8 cmp_tuple(db_tuple_t *a, db_tuple_t *b, relation_header_t *hp_a,
       // TODO: Perhaps move this comparison to tuple.c?
       switch ((attr_type)hp_a->types[i]) {
       case DB_INT:
-        cmp_result = getintbypos(a, i, hp_a) - getintbypos(b, i, hp_a);
+        if (getintbypos(a, i, hp_a) < getintbypos(b, i, hp_a))
+          cmp_result = -1;
+        else if (getintbypos(a, i, hp_a) > getintbypos(b, i, hp_a))
+          cmp_result = 1;
         break;
       case DB_STRING:
         cmp_result =
             strcmp(getstringbypos(a, i, hp_a), getstringbypos(b, i, hp_a));
         break;
       case DB_DECIMAL:
-        cmp_result = getdecimalbypos(a, i, hp_a) - getdecimalbypos(b, i, hp_a);
+        if (getdecimalbypos(a, i, hp_a) < getdecimalbypos(b, i, hp_a))
+          cmp_result = -1;
+        else if (getdecimalbypos(a, i, hp_a) > getdecimalbypos(b, i, hp_a))
+          cmp_result = 1;
         break;
       default:
         break;
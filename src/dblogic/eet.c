@@ -928,6 +928,41 @@ db_int evaluate_eet(db_eet_t *exprp, void *rp, db_tuple_t **tp,
                              hp[((db_eetnode_attr_t *)cursor)->tuple_pos]);
         numvals++;
       }
+    } else if ((db_uint8)DB_EETNODE_AGGR_TEMP == cursor->type) {
+      /* In postfix order, the aggregate's argument has already been
+         evaluated.  It is replaced with the value aggregated so far. */
+      db_eetnode_aggr_temp_t *aggrp = (db_eetnode_aggr_temp_t *)cursor;
+      if (numvals < 1) {
+        db_qmm_bfree(mmp, stack_top);
+        return -1;
+      }
+
+      /* Outside of an aggregate operator, there is nothing to evaluate. */
+      if (NULL != rp && 1 != aggrp->aggr_isnull && NULL == aggrp->value_p) {
+        db_qmm_bfree(mmp, stack_top);
+        return -1;
+      }
+
+      db_uint8 type = stack_top->type;
+      if (NULL != rp && 1 == aggrp->aggr_isnull)
+        type = DB_EETNODE_CONST_NULL;
+      else if (NULL != rp || (db_uint8)DB_AGGR_COUNTROWS == aggrp->aggr_type)
+        type = DB_EETNODE_CONST_DBINT;
+
+      db_eetnode_t *freeto = stack_top;
+      advanceeetnodepointer(&freeto, 1);
+      if ((db_uint8)DB_EETNODE_CONST_DBINT == type) {
+        stack_top = db_qmm_bextend(mmp, POINTERBYTEDIST(stack_top, freeto) +
+                                            sizeof(db_eetnode_dbint_t));
+        stack_top->type = DB_EETNODE_CONST_DBINT;
+        ((db_eetnode_dbint_t *)stack_top)->integer =
+            NULL == rp ? 1 : *((db_int *)(aggrp->value_p));
+      } else if ((db_uint8)DB_EETNODE_CONST_NULL == type) {
+        stack_top = db_qmm_bextend(mmp, POINTERBYTEDIST(stack_top, freeto) +
+                                            sizeof(db_eetnode_t));
+        stack_top->type = DB_EETNODE_CONST_NULL;
+      }
+      /* Otherwise, only the type was wanted, and it is the argument's. */
     } else /* It is an operator. */
     {
       numreqvals = eet_numrequiredvals(cursor->type);
@@ -993,7 +1028,6 @@ db_int evaluate_eet(db_eet_t *exprp, void *rp, db_tuple_t **tp,
     advanceeetnodepointer(&cursor, 1);
   }
 
-  // TODO: Handle aggregates.
   if (numvals > 1) {
     db_qmm_bfree(mmp, stack_top);
     return -1;
@@ -1015,3 +1049,848 @@ db_int evaluate_eet(db_eet_t *exprp, void *rp, db_tuple_t **tp,
   db_qmm_bfree(mmp, stack_top);
   return 1;
 }
+
+/* Decide a predicate that is a single constant node. */
+db_int evaluate_eet_constant(db_eet_t *exprp, db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = exprp->nodes;
+  db_int result;
+
+  if (NULL == cursor || exprp->size <= 0 ||
+      (db_uint8)DB_EETNODE_CONST_NULL > cursor->type ||
+      (db_uint8)DB_EETNODE_CONST_DBDECIMAL < cursor->type)
+    return -1;
+  advanceeetnodepointer(&cursor, 1);
+  if (POINTERBYTEDIST(cursor, exprp->nodes) != exprp->size)
+    return -1;
+
+  if (1 == evaluate_eet(exprp, &result, NULL, NULL, 0, mmp) && 1 == result)
+    return 1;
+  return 0;
+}
+
+/* Mark an expression program as not yet compiled. */
+void init_eetprog(db_eetprog_t *progp) {
+  progp->code = NULL;
+  progp->stack = NULL;
+  progp->length = 0;
+  progp->type = DB_EETNODE_CONST_NULL;
+}
+
+/* Find the instruction for an operator whose operands have been promoted to a
+   given type, or -1 if the operator is not defined for that type. */
+static db_int eet_progop(db_uint8 type, db_uint8 promotedto) {
+  if ((db_uint8)DB_EETNODE_CONST_DBINT == promotedto) {
+    switch (type) {
+    case (db_uint8)DB_EETNODE_OP_UNARYNEG:
+      return DB_EETPROG_INT_UNARYNEG;
+    case (db_uint8)DB_EETNODE_OP_NOT:
+      return DB_EETPROG_INT_NOT;
+    case (db_uint8)DB_EETNODE_OP_BAND:
+      return DB_EETPROG_INT_BAND;
+    case (db_uint8)DB_EETNODE_OP_BOR:
+      return DB_EETPROG_INT_BOR;
+    case (db_uint8)DB_EETNODE_OP_BXOR:
+      return DB_EETPROG_INT_BXOR;
+    case (db_uint8)DB_EETNODE_OP_AND:
+      return DB_EETPROG_INT_AND;
+    case (db_uint8)DB_EETNODE_OP_OR:
+      return DB_EETPROG_INT_OR;
+    case (db_uint8)DB_EETNODE_OP_XOR:
+      return DB_EETPROG_INT_XOR;
+    case (db_uint8)DB_EETNODE_OP_MOD:
+      return DB_EETPROG_INT_MOD;
+    case (db_uint8)DB_EETNODE_OP_ADD:
+      return DB_EETPROG_INT_ADD;
+    case (db_uint8)DB_EETNODE_OP_SUB:
+      return DB_EETPROG_INT_SUB;
+    case (db_uint8)DB_EETNODE_OP_MULT:
+      return DB_EETPROG_INT_MULT;
+    case (db_uint8)DB_EETNODE_OP_DIV:
+      return DB_EETPROG_INT_DIV;
+    case (db_uint8)DB_EETNODE_OP_LT:
+      return DB_EETPROG_INT_LT;
+    case (db_uint8)DB_EETNODE_OP_GT:
+      return DB_EETPROG_INT_GT;
+    case (db_uint8)DB_EETNODE_OP_LTE:
+      return DB_EETPROG_INT_LTE;
+    case (db_uint8)DB_EETNODE_OP_GTE:
+      return DB_EETPROG_INT_GTE;
+    case (db_uint8)DB_EETNODE_OP_NEQ:
+      return DB_EETPROG_INT_NEQ;
+    case (db_uint8)DB_EETNODE_OP_EQ:
+      return DB_EETPROG_INT_EQ;
+    }
+  } else if ((db_uint8)DB_EETNODE_CONST_DBDECIMAL == promotedto) {
+    switch (type) {
+    case (db_uint8)DB_EETNODE_OP_UNARYNEG:
+      return DB_EETPROG_DECIMAL_UNARYNEG;
+    case (db_uint8)DB_EETNODE_OP_NOT:
+      return DB_EETPROG_DECIMAL_NOT;
+    case (db_uint8)DB_EETNODE_OP_AND:
+      return DB_EETPROG_DECIMAL_AND;
+    case (db_uint8)DB_EETNODE_OP_OR:
+      return DB_EETPROG_DECIMAL_OR;
+    case (db_uint8)DB_EETNODE_OP_XOR:
+      return DB_EETPROG_DECIMAL_XOR;
+    case (db_uint8)DB_EETNODE_OP_ADD:
+      return DB_EETPROG_DECIMAL_ADD;
+    case (db_uint8)DB_EETNODE_OP_SUB:
+      return DB_EETPROG_DECIMAL_SUB;
+    case (db_uint8)DB_EETNODE_OP_MULT:
+      return DB_EETPROG_DECIMAL_MULT;
+    case (db_uint8)DB_EETNODE_OP_DIV:
+      return DB_EETPROG_DECIMAL_DIV;
+    case (db_uint8)DB_EETNODE_OP_LT:
+      return DB_EETPROG_DECIMAL_LT;
+    case (db_uint8)DB_EETNODE_OP_GT:
+      return DB_EETPROG_DECIMAL_GT;
+    case (db_uint8)DB_EETNODE_OP_LTE:
+      return DB_EETPROG_DECIMAL_LTE;
+    case (db_uint8)DB_EETNODE_OP_GTE:
+      return DB_EETPROG_DECIMAL_GTE;
+    case (db_uint8)DB_EETNODE_OP_NEQ:
+      return DB_EETPROG_DECIMAL_NEQ;
+    case (db_uint8)DB_EETNODE_OP_EQ:
+      return DB_EETPROG_DECIMAL_EQ;
+    }
+  } else if ((db_uint8)DB_EETNODE_CONST_DBSTRING == promotedto) {
+    switch (type) {
+    case (db_uint8)DB_EETNODE_FUNC_LENGTH_DBSTRING:
+      return DB_EETPROG_STRING_LENGTH;
+    case (db_uint8)DB_EETNODE_OP_LT:
+      return DB_EETPROG_STRING_LT;
+    case (db_uint8)DB_EETNODE_OP_GT:
+      return DB_EETPROG_STRING_GT;
+    case (db_uint8)DB_EETNODE_OP_LTE:
+      return DB_EETPROG_STRING_LTE;
+    case (db_uint8)DB_EETNODE_OP_GTE:
+      return DB_EETPROG_STRING_GTE;
+    case (db_uint8)DB_EETNODE_OP_NEQ:
+      return DB_EETPROG_STRING_NEQ;
+    case (db_uint8)DB_EETNODE_OP_EQ:
+      return DB_EETPROG_STRING_EQ;
+    }
+  }
+  return -1;
+}
+
+/* Compile an expression for a given set of schemas.  The value stack is
+   walked as evaluate_eet would walk it, but with only the type of each value
+   on it, so every operator's promotion is settled here. */
+db_int compile_eet(db_eetprog_t *progp, db_eet_t *exprp, relation_header_t **hp,
+                   db_query_mm_t *mmp) {
+  db_eetnode_t *cursor;
+  db_eetinstr_t *instr;
+  db_uint8 *types, promotedto, attr_type;
+  db_int *starts;
+  db_int length = 0, depth = 0, maxdepth = 0, numjumps = 0, numreqvals, op;
+  db_int rightlength;
+
+  init_eetprog(progp);
+  progp->length = -1;
+
+  /* Size the program and its stack. */
+  cursor = exprp->nodes;
+  while (POINTERBYTEDIST(cursor, exprp->nodes) < exprp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type ||
+        ((db_uint8)DB_EETNODE_CONST_NULL <= cursor->type &&
+         (db_uint8)DB_EETNODE_CONST_DBSTRING >= cursor->type)) {
+      depth++;
+    } else if ((db_uint8)DB_EETNODE_OP_UNARYNEG <= cursor->type &&
+               (db_uint8)DB_EETNODE_FUNC_LENGTH_DBSTRING >= cursor->type) {
+      numreqvals = eet_numrequiredvals(cursor->type);
+      if (numreqvals > depth)
+        return 0;
+      depth = depth - numreqvals + 1;
+      if ((db_uint8)DB_EETNODE_OP_AND == cursor->type ||
+          (db_uint8)DB_EETNODE_OP_OR == cursor->type)
+        numjumps++;
+    } else {
+      return 0;
+    }
+    if (depth > maxdepth)
+      maxdepth = depth;
+    length++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  if (1 != depth)
+    return 0;
+
+  length += numjumps;
+  progp->code = DB_QMM_BALLOC(mmp, (size_t)length * sizeof(db_eetinstr_t) +
+                                       (size_t)maxdepth * sizeof(db_eetvalue_t));
+  if (NULL == progp->code)
+    return 0;
+  progp->stack = (db_eetvalue_t *)(progp->code + length);
+
+  /* While compiling, the stack holds only the type of each value, and where
+     its instructions start. */
+  starts = (db_int *)progp->stack;
+  types = (db_uint8 *)(starts + maxdepth);
+  depth = 0;
+  length = 0;
+  cursor = exprp->nodes;
+  while (POINTERBYTEDIST(cursor, exprp->nodes) < exprp->size) {
+    instr = progp->code + length;
+    if ((db_uint8)DB_EETNODE_OP_UNARYNEG > cursor->type)
+      starts[depth] = length;
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type) {
+      instr->tuple_pos = ((db_eetnode_attr_t *)cursor)->tuple_pos;
+      instr->pos = ((db_eetnode_attr_t *)cursor)->pos;
+      instr->offset = getoffsetbypos(hp[instr->tuple_pos], instr->pos);
+      attr_type = gettypebypos(hp[instr->tuple_pos], instr->pos);
+      if ((db_uint8)DB_INT == attr_type) {
+        instr->op = DB_EETPROG_INTATTR;
+        types[depth] = DB_EETNODE_CONST_DBINT;
+      } else if ((db_uint8)DB_DECIMAL == attr_type) {
+        instr->op = DB_EETPROG_DECIMALATTR;
+        types[depth] = DB_EETNODE_CONST_DBDECIMAL;
+      } else if ((db_uint8)DB_STRING == attr_type) {
+        instr->op = DB_EETPROG_STRINGATTR;
+        types[depth] = DB_EETNODE_CONST_DBSTRING;
+      } else {
+        close_eetprog(progp, mmp);
+        progp->length = -1;
+        return 0;
+      }
+      depth++;
+      length++;
+    } else if ((db_uint8)DB_EETNODE_CONST_NULL == cursor->type) {
+      instr->op = DB_EETPROG_NULL;
+      types[depth++] = DB_EETNODE_CONST_NULL;
+      length++;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBINT == cursor->type) {
+      instr->op = DB_EETPROG_INT;
+      instr->value.integer = ((db_eetnode_dbint_t *)cursor)->integer;
+      types[depth++] = DB_EETNODE_CONST_DBINT;
+      length++;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBDECIMAL == cursor->type) {
+      instr->op = DB_EETPROG_DECIMAL;
+      instr->value.decimal = ((db_eetnode_dbdecimal_t *)cursor)->decimal;
+      types[depth++] = DB_EETNODE_CONST_DBDECIMAL;
+      length++;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBSTRING == cursor->type) {
+      instr->op = DB_EETPROG_STRING;
+      instr->value.string = ((db_eetnode_dbstring_t *)cursor)->string;
+      types[depth++] = DB_EETNODE_CONST_DBSTRING;
+      length++;
+    } else /* It is an operator. */
+    {
+      numreqvals = eet_numrequiredvals(cursor->type);
+      promotedto = types[depth - 1];
+      op = 0;
+      if (2 == numreqvals) {
+        /* Operands of different types are left to evaluate_eet. */
+        if ((db_uint8)DB_EETNODE_CONST_NULL != types[depth - 2] &&
+            (db_uint8)DB_EETNODE_CONST_NULL != promotedto &&
+            types[depth - 2] != promotedto)
+          op = -1;
+        else if (types[depth - 2] > promotedto)
+          promotedto = types[depth - 2];
+      }
+
+      if (op < 0) {
+        /* Not compiled. */
+      } else if ((db_uint8)DB_EETNODE_OP_ISNULL == cursor->type) {
+        /* A decimal's NULL check is a decimal only if it is not NULL. */
+        if ((db_uint8)DB_EETNODE_CONST_DBDECIMAL == promotedto)
+          op = -1;
+        else
+          op = DB_EETPROG_ISNULL;
+        promotedto = DB_EETNODE_CONST_DBINT;
+      } else if ((db_uint8)DB_EETNODE_CONST_NULL == promotedto) {
+        /* Every operand is NULL, so the result is too. */
+        op = 2 == numreqvals ? DB_EETPROG_POP : DB_EETPROG_NULL;
+      } else {
+        op = eet_progop(cursor->type, promotedto);
+        if ((db_uint8)DB_EETNODE_CONST_DBSTRING == promotedto)
+          promotedto = DB_EETNODE_CONST_DBINT;
+      }
+
+      if (op < 0) {
+        close_eetprog(progp, mmp);
+        progp->length = -1;
+        return 0;
+      }
+
+      /* Jump over the right operand when the left one decides the result,
+         unless there is nothing much to jump over. */
+      rightlength = length - starts[depth - 1];
+      if ((DB_EETPROG_INT_AND == op || DB_EETPROG_INT_OR == op ||
+           DB_EETPROG_DECIMAL_AND == op || DB_EETPROG_DECIMAL_OR == op) &&
+          (db_uint8)DB_EETNODE_CONST_NULL != types[depth - 2] &&
+          1 < rightlength) {
+        instr = progp->code + starts[depth - 1];
+        memmove(instr + 1, instr, (size_t)rightlength * sizeof(db_eetinstr_t));
+        if ((db_uint8)DB_EETNODE_CONST_DBINT == types[depth - 2])
+          instr->op = DB_EETPROG_INT_AND == op ? DB_EETPROG_INT_ANDJUMP
+                                               : DB_EETPROG_INT_ORJUMP;
+        else
+          instr->op = DB_EETPROG_DECIMAL_AND == op ? DB_EETPROG_DECIMAL_ANDJUMP
+                                                   : DB_EETPROG_DECIMAL_ORJUMP;
+        instr->value.integer = rightlength + 1;
+        length++;
+        instr = progp->code + length;
+      }
+
+      /* A NULL operand of a unary operator is already the result. */
+      if (DB_EETPROG_NULL != op) {
+        instr->op = (db_uint8)op;
+        length++;
+      }
+      depth = depth - numreqvals + 1;
+      types[depth - 1] = promotedto;
+    }
+
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  progp->type = types[0];
+  progp->length = length;
+  return 1;
+}
+
+/* Run a compiled expression. */
+db_int evaluate_eetprog(db_eetprog_t *progp, void *rp, db_tuple_t **tp) {
+  db_eetinstr_t *instr = progp->code;
+  db_eetinstr_t *end = progp->code + progp->length;
+  db_eetvalue_t *top = progp->stack - 1;
+  db_tuple_t *t;
+  db_int result;
+
+  for (; instr < end; ++instr) {
+    switch (instr->op) {
+    case DB_EETPROG_NULL:
+      ++top;
+      top->isnull = 1;
+      break;
+    case DB_EETPROG_INT:
+      ++top;
+      top->isnull = 0;
+      top->value.integer = instr->value.integer;
+      break;
+    case DB_EETPROG_DECIMAL:
+      ++top;
+      top->isnull = 0;
+      top->value.decimal = instr->value.decimal;
+      break;
+    case DB_EETPROG_STRING:
+      ++top;
+      top->isnull = 0;
+      top->value.string = instr->value.string;
+      break;
+    case DB_EETPROG_INTATTR:
+    case DB_EETPROG_DECIMALATTR:
+    case DB_EETPROG_STRINGATTR:
+      ++top;
+      t = tp[instr->tuple_pos];
+      top->isnull = (t->isnull[instr->pos / 8] >> (instr->pos % 8)) & 1;
+      if (DB_EETPROG_INTATTR == instr->op)
+        top->value.integer = *((db_int *)(&(t->bytes[instr->offset])));
+      else if (DB_EETPROG_DECIMALATTR == instr->op)
+        top->value.decimal = *((db_decimal *)(&(t->bytes[instr->offset])));
+      else
+        top->value.string = (char *)(&(t->bytes[instr->offset]));
+      break;
+    case DB_EETPROG_POP:
+      --top;
+      top->isnull = 1;
+      break;
+    case DB_EETPROG_ISNULL:
+      top->value.integer = top->isnull;
+      top->isnull = 0;
+      break;
+    case DB_EETPROG_INT_ANDJUMP:
+      if (!top->isnull && 0 == top->value.integer)
+        instr += instr->value.integer;
+      break;
+    case DB_EETPROG_INT_ORJUMP:
+      if (!top->isnull && 1 == top->value.integer)
+        instr += instr->value.integer;
+      break;
+    case DB_EETPROG_DECIMAL_ANDJUMP:
+      if (!top->isnull && 0 == top->value.decimal)
+        instr += instr->value.integer;
+      break;
+    case DB_EETPROG_DECIMAL_ORJUMP:
+      if (!top->isnull && 1 == top->value.decimal)
+        instr += instr->value.integer;
+      break;
+    case DB_EETPROG_INT_UNARYNEG:
+      top->value.integer = -1 * (top->value.integer);
+      break;
+    case DB_EETPROG_INT_NOT:
+      top->value.integer = !(top->value.integer);
+      break;
+    case DB_EETPROG_DECIMAL_UNARYNEG:
+      top->value.decimal = -1 * (top->value.decimal);
+      break;
+    case DB_EETPROG_DECIMAL_NOT:
+      top->value.decimal = !(top->value.decimal);
+      break;
+    case DB_EETPROG_STRING_LENGTH:
+      if (!top->isnull)
+        top->value.integer = strlen(top->value.string);
+      break;
+    case DB_EETPROG_INT_AND:
+      --top;
+      if ((!top->isnull && 0 == top->value.integer) ||
+          (!top[1].isnull && 0 == top[1].value.integer)) {
+        top->isnull = 0;
+        top->value.integer = 0;
+      } else if (top->isnull || top[1].isnull) {
+        top->isnull = 1;
+      } else {
+        top->value.integer = 1;
+      }
+      break;
+    case DB_EETPROG_INT_OR:
+      --top;
+      if ((!top->isnull && 1 == top->value.integer) ||
+          (!top[1].isnull && 1 == top[1].value.integer)) {
+        top->isnull = 0;
+        top->value.integer = 1;
+      } else if (top->isnull || top[1].isnull) {
+        top->isnull = 1;
+      } else {
+        top->value.integer = (top->value.integer) || (top[1].value.integer);
+      }
+      break;
+    case DB_EETPROG_DECIMAL_AND:
+      --top;
+      if ((!top->isnull && 0 == top->value.decimal) ||
+          (!top[1].isnull && 0 == top[1].value.decimal)) {
+        top->isnull = 0;
+        top->value.decimal = 0;
+      } else if (top->isnull || top[1].isnull) {
+        top->isnull = 1;
+      } else {
+        top->value.decimal = 1;
+      }
+      break;
+    case DB_EETPROG_DECIMAL_OR:
+      --top;
+      if ((!top->isnull && 1 == top->value.decimal) ||
+          (!top[1].isnull && 1 == top[1].value.decimal)) {
+        top->isnull = 0;
+        top->value.decimal = 1;
+      } else if (top->isnull || top[1].isnull) {
+        top->isnull = 1;
+      } else {
+        top->value.decimal = (top->value.decimal) || (top[1].value.decimal);
+      }
+      break;
+    default:
+      /* Every other operator takes two values, and is NULL if either is. */
+      --top;
+      top->isnull |= top[1].isnull;
+      if (top->isnull)
+        break;
+
+      switch (instr->op) {
+      case DB_EETPROG_INT_BAND:
+        top->value.integer = (top->value.integer) & (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_BOR:
+        top->value.integer = (top->value.integer) | (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_BXOR:
+        top->value.integer = (top->value.integer) ^ (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_XOR:
+        top->value.integer =
+            ((top->value.integer) || (top[1].value.integer)) &&
+            ((top->value.integer) != (top[1].value.integer));
+        break;
+      case DB_EETPROG_INT_MOD:
+        if (0 == top[1].value.integer)
+          top->isnull = 1;
+        else
+          top->value.integer = (top->value.integer) % (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_ADD:
+        top->value.integer = (top->value.integer) + (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_SUB:
+        top->value.integer = (top->value.integer) - (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_MULT:
+        top->value.integer = (top->value.integer) * (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_DIV:
+        if (0 == top[1].value.integer)
+          top->isnull = 1;
+        else
+          top->value.integer = (top->value.integer) / (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_LT:
+        top->value.integer = (top->value.integer) < (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_GT:
+        top->value.integer = (top->value.integer) > (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_LTE:
+        top->value.integer = (top->value.integer) <= (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_GTE:
+        top->value.integer = (top->value.integer) >= (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_NEQ:
+        top->value.integer = (top->value.integer) != (top[1].value.integer);
+        break;
+      case DB_EETPROG_INT_EQ:
+        top->value.integer = (top->value.integer) == (top[1].value.integer);
+        break;
+      case DB_EETPROG_DECIMAL_XOR:
+        top->value.decimal =
+            ((top->value.decimal) || (top[1].value.decimal)) &&
+            ((top->value.decimal) != (top[1].value.decimal));
+        break;
+      case DB_EETPROG_DECIMAL_ADD:
+        top->value.decimal = (top->value.decimal) + (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_SUB:
+        top->value.decimal = (top->value.decimal) - (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_MULT:
+        top->value.decimal = (top->value.decimal) * (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_DIV:
+        if (0 == top[1].value.decimal)
+          top->isnull = 1;
+        else
+          top->value.decimal = (top->value.decimal) / (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_LT:
+        top->value.decimal = (top->value.decimal) < (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_GT:
+        top->value.decimal = (top->value.decimal) > (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_LTE:
+        top->value.decimal = (top->value.decimal) <= (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_GTE:
+        top->value.decimal = (top->value.decimal) >= (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_NEQ:
+        top->value.decimal = (top->value.decimal) != (top[1].value.decimal);
+        break;
+      case DB_EETPROG_DECIMAL_EQ:
+        top->value.decimal = (top->value.decimal) == (top[1].value.decimal);
+        break;
+      default: /* The string comparisons. */
+        result = strcmp(top->value.string, top[1].value.string);
+        if (DB_EETPROG_STRING_LT == instr->op)
+          top->value.integer = 0 > result;
+        else if (DB_EETPROG_STRING_GT == instr->op)
+          top->value.integer = 0 < result;
+        else if (DB_EETPROG_STRING_LTE == instr->op)
+          top->value.integer = 0 >= result;
+        else if (DB_EETPROG_STRING_GTE == instr->op)
+          top->value.integer = 0 <= result;
+        else if (DB_EETPROG_STRING_NEQ == instr->op)
+          top->value.integer = 0 != result;
+        else
+          top->value.integer = 0 == result;
+        break;
+      }
+      break;
+    }
+  }
+
+  /* The result is handed back as evaluate_eet hands it back. */
+  if (top->isnull)
+    return 2;
+  else if ((db_uint8)DB_EETNODE_CONST_DBINT == progp->type)
+    *((db_int *)rp) = top->value.integer;
+  else if ((db_uint8)DB_EETNODE_CONST_DBDECIMAL == progp->type)
+    *((db_int *)rp) = top->value.decimal;
+  else
+    *((char **)rp) = top->value.string;
+  return 1;
+}
+
+/* Evaluate an expression through its program, if it has one. */
+db_int evaluate_eet_compiled(db_eetprog_t *progp, db_eet_t *exprp, void *rp,
+                             db_tuple_t **tp, relation_header_t **hp,
+                             db_query_mm_t *mmp) {
+  if (NULL != progp->code)
+    return evaluate_eetprog(progp, rp, tp);
+  return evaluate_eet(exprp, rp, tp, hp, 0, mmp);
+}
+
+/* Free a compiled expression. */
+void close_eetprog(db_eetprog_t *progp, db_query_mm_t *mmp) {
+  if (NULL != progp->code)
+    DB_QMM_BFREE(mmp, progp->code);
+  init_eetprog(progp);
+}
+
+/* Find how many columns deep the value stack gets when evaluating an
+   expression over a batch.  Returns 0 if the expression is not made up only of
+   integer attributes of the first tuple, integer and NULL constants, and
+   operators on integers, since those are all the batch evaluator handles. */
+static db_int eet_batchdepth(db_eet_t *exprp, relation_header_t *hp) {
+  db_eetnode_t *cursor = exprp->nodes;
+  db_int depth = 0, maxdepth = 0;
+
+  while (POINTERBYTEDIST(cursor, exprp->nodes) < exprp->size) {
+    switch (cursor->type) {
+    case (db_uint8)DB_EETNODE_ATTR:
+      if (0 != ((db_eetnode_attr_t *)cursor)->tuple_pos ||
+          (db_uint8)DB_INT !=
+              gettypebypos(hp, ((db_eetnode_attr_t *)cursor)->pos))
+        return 0;
+      depth++;
+      break;
+    case (db_uint8)DB_EETNODE_CONST_NULL:
+    case (db_uint8)DB_EETNODE_CONST_DBINT:
+      depth++;
+      break;
+    case (db_uint8)DB_EETNODE_OP_UNARYNEG:
+    case (db_uint8)DB_EETNODE_OP_NOT:
+    case (db_uint8)DB_EETNODE_OP_ISNULL:
+      if (depth < 1)
+        return 0;
+      break;
+    case (db_uint8)DB_EETNODE_OP_BAND:
+    case (db_uint8)DB_EETNODE_OP_BOR:
+    case (db_uint8)DB_EETNODE_OP_BXOR:
+    case (db_uint8)DB_EETNODE_OP_AND:
+    case (db_uint8)DB_EETNODE_OP_OR:
+    case (db_uint8)DB_EETNODE_OP_XOR:
+    case (db_uint8)DB_EETNODE_OP_MOD:
+    case (db_uint8)DB_EETNODE_OP_ADD:
+    case (db_uint8)DB_EETNODE_OP_SUB:
+    case (db_uint8)DB_EETNODE_OP_MULT:
+    case (db_uint8)DB_EETNODE_OP_DIV:
+    case (db_uint8)DB_EETNODE_OP_LT:
+    case (db_uint8)DB_EETNODE_OP_GT:
+    case (db_uint8)DB_EETNODE_OP_LTE:
+    case (db_uint8)DB_EETNODE_OP_GTE:
+    case (db_uint8)DB_EETNODE_OP_NEQ:
+    case (db_uint8)DB_EETNODE_OP_EQ:
+      if (depth < 2)
+        return 0;
+      depth--;
+      break;
+    default:
+      return 0;
+    }
+    if (depth > maxdepth)
+      maxdepth = depth;
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  return 1 == depth ? maxdepth : 0;
+}
+
+/* Evaluate an expression a tuple at a time over the selected tuples of a
+   batch, through its program if it has one. */
+static db_int eet_batchpertuple(db_eetprog_t *progp, db_eet_t *exprp,
+                                db_tuplebatch_t *bp, relation_header_t *hp,
+                                db_uint8 *selected, db_query_mm_t *mmp) {
+  db_int i, result, retval;
+  db_tuple_t t;
+  db_tuple_t *tp = &t;
+
+  for (i = 0; i < bp->count; ++i) {
+    if (0 == (selected[i / 8] & (1 << (i % 8))))
+      continue;
+    viewbatchtuple(bp, i, &t);
+    if (NULL != progp)
+      retval = evaluate_eet_compiled(progp, exprp, &result, &tp, &hp, mmp);
+    else
+      retval = evaluate_eet(exprp, &result, &tp, &hp, 0, mmp);
+    if (1 != retval || 1 != result)
+      selected[i / 8] &= ~(1 << (i % 8));
+  }
+  return 1;
+}
+
+/* Evaluate an expression over a whole batch at once.  Each node is applied to
+   a column of values, one per tuple, with a parallel column of NULL flags.
+   The loops are kept simple enough for the compiler to vectorize, and follow
+   the same NULL rules as eet_evaloporfunc. */
+db_int evaluate_eet_batch(db_eetprog_t *progp, db_eet_t *exprp,
+                          db_tuplebatch_t *bp, relation_header_t *hp,
+                          db_uint8 *selected, db_query_mm_t *mmp) {
+  db_int n = bp->count;
+  db_int depth, top, i, pos;
+  db_int *values, *a, *b;
+  db_uint8 *nulls, *an, *bn, f, t;
+  db_uint8 offset;
+  unsigned char *record;
+  db_eetnode_t *cursor;
+
+  if (n < 1)
+    return 1;
+
+  depth = eet_batchdepth(exprp, hp);
+  values = NULL;
+  if (depth > 0)
+    values =
+        db_qmm_balloc(mmp, (size_t)(depth * n) * (sizeof(db_int) + 1));
+  if (NULL == values)
+    return eet_batchpertuple(progp, exprp, bp, hp, selected, mmp);
+  nulls = (db_uint8 *)(values + depth * n);
+
+  top = -1;
+  cursor = exprp->nodes;
+  while (POINTERBYTEDIST(cursor, exprp->nodes) < exprp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type) {
+      top++;
+      a = values + top * n;
+      an = nulls + top * n;
+      pos = (db_int)(((db_eetnode_attr_t *)cursor)->pos);
+      offset = getoffsetbypos(hp, pos);
+      record = bp->records;
+      for (i = 0; i < n; ++i, record += bp->recordsize) {
+        an[i] = (record[pos / 8] >> (pos % 8)) & 1;
+        if (an[i])
+          a[i] = 0;
+        else
+          memcpy(a + i, record + bp->isnullsize + offset, sizeof(db_int));
+      }
+    } else if ((db_uint8)DB_EETNODE_CONST_NULL == cursor->type ||
+               (db_uint8)DB_EETNODE_CONST_DBINT == cursor->type) {
+      top++;
+      a = values + top * n;
+      an = nulls + top * n;
+      if ((db_uint8)DB_EETNODE_CONST_NULL == cursor->type) {
+        for (i = 0; i < n; ++i)
+          a[i] = 0;
+        memset(an, 1, (size_t)n);
+      } else {
+        for (i = 0; i < n; ++i)
+          a[i] = ((db_eetnode_dbint_t *)cursor)->integer;
+        memset(an, 0, (size_t)n);
+      }
+    } else if (1 == eet_numrequiredvals(cursor->type)) {
+      a = values + top * n;
+      an = nulls + top * n;
+      switch (cursor->type) {
+      case (db_uint8)DB_EETNODE_OP_UNARYNEG:
+        for (i = 0; i < n; ++i)
+          a[i] = -a[i];
+        break;
+      case (db_uint8)DB_EETNODE_OP_NOT:
+        for (i = 0; i < n; ++i)
+          a[i] = !a[i];
+        break;
+      default: /* DB_EETNODE_OP_ISNULL */
+        for (i = 0; i < n; ++i) {
+          a[i] = an[i];
+          an[i] = 0;
+        }
+        break;
+      }
+    } else {
+      top--;
+      a = values + top * n;
+      an = nulls + top * n;
+      b = a + n;
+      bn = an + n;
+      switch (cursor->type) {
+      case (db_uint8)DB_EETNODE_OP_AND:
+        /* False if either side is false, otherwise NULL if either side is. */
+        for (i = 0; i < n; ++i) {
+          f = (!an[i] & (0 == a[i])) | (!bn[i] & (0 == b[i]));
+          an[i] = (an[i] | bn[i]) & !f;
+          a[i] = !f & !an[i];
+        }
+        break;
+      case (db_uint8)DB_EETNODE_OP_OR:
+        /* True if either side is true, otherwise NULL if either side is. */
+        for (i = 0; i < n; ++i) {
+          t = (!an[i] & (1 == a[i])) | (!bn[i] & (1 == b[i]));
+          an[i] = (an[i] | bn[i]) & !t;
+          a[i] = !an[i] && (t || 0 != a[i] || 0 != b[i]);
+        }
+        break;
+      case (db_uint8)DB_EETNODE_OP_MOD:
+      case (db_uint8)DB_EETNODE_OP_DIV:
+        for (i = 0; i < n; ++i) {
+          an[i] |= bn[i] | (0 == b[i]);
+          if (an[i])
+            a[i] = 0;
+          else if ((db_uint8)DB_EETNODE_OP_MOD == cursor->type)
+            a[i] = a[i] % b[i];
+          else
+            a[i] = a[i] / b[i];
+        }
+        break;
+      default:
+        for (i = 0; i < n; ++i)
+          an[i] |= bn[i];
+        switch (cursor->type) {
+        case (db_uint8)DB_EETNODE_OP_BAND:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] & b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_BOR:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] | b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_BXOR:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] ^ b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_XOR:
+          for (i = 0; i < n; ++i)
+            a[i] = (0 != (a[i] | b[i])) & (a[i] != b[i]);
+          break;
+        case (db_uint8)DB_EETNODE_OP_ADD:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] + b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_SUB:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] - b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_MULT:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] * b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_LT:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] < b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_GT:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] > b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_LTE:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] <= b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_GTE:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] >= b[i];
+          break;
+        case (db_uint8)DB_EETNODE_OP_NEQ:
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] != b[i];
+          break;
+        default: /* DB_EETNODE_OP_EQ */
+          for (i = 0; i < n; ++i)
+            a[i] = a[i] == b[i];
+          break;
+        }
+        break;
+      }
+    }
+
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  /* Only tuples for which the expression is exactly 1 pass, as in
+     next_select. */
+  for (i = 0; i < n; ++i)
+    if (nulls[i] || 1 != values[i])
+      selected[i / 8] &= ~(1 << (i % 8));
+
+  db_qmm_bfree(mmp, values);
+  return 1;
+}
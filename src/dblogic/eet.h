@@ -283,6 +283,133 @@ typedef struct {
   db_int offset;            /**< Offset in query string. */
 } db_eetnode_placeholder_t;
 
+/*** Compiled expressions. ***/
+/**
+@enum		db_eetprog_op
+@brief		Instructions of a compiled expression.
+@details	Each instruction works on values of a single type, known when
+                the expression is compiled, so no promotion is done while it
+                runs.  Integer, decimal and string operators are listed in
+                the same order as their @ref db_eetnode_type counterparts.
+*/
+typedef enum {
+  DB_EETPROG_NULL = 0,     /**< Push a @c NULL. */
+  DB_EETPROG_INT,          /**< Push an integer constant. */
+  DB_EETPROG_DECIMAL,      /**< Push a decimal constant. */
+  DB_EETPROG_STRING,       /**< Push a string constant. */
+  DB_EETPROG_INTATTR,      /**< Push an integer attribute. */
+  DB_EETPROG_DECIMALATTR,  /**< Push a decimal attribute. */
+  DB_EETPROG_STRINGATTR,   /**< Push a string attribute. */
+  DB_EETPROG_POP,          /**< Drop the top value, leaving a @c NULL
+                                below it as the result. */
+  DB_EETPROG_ISNULL,       /**< @c NULL check, of any type. */
+  DB_EETPROG_INT_ANDJUMP,  /**< Jump past the rest of an @c AND if its
+                                left operand, on top, is a @c 0. */
+  DB_EETPROG_INT_ORJUMP,   /**< Jump past the rest of an @c OR if its
+                                left operand, on top, is a @c 1. */
+  DB_EETPROG_DECIMAL_ANDJUMP,
+  DB_EETPROG_DECIMAL_ORJUMP,
+  DB_EETPROG_INT_UNARYNEG, /**< Integer operators. */
+  DB_EETPROG_INT_NOT,
+  DB_EETPROG_INT_BAND,
+  DB_EETPROG_INT_BOR,
+  DB_EETPROG_INT_BXOR,
+  DB_EETPROG_INT_AND,
+  DB_EETPROG_INT_OR,
+  DB_EETPROG_INT_XOR,
+  DB_EETPROG_INT_MOD,
+  DB_EETPROG_INT_ADD,
+  DB_EETPROG_INT_SUB,
+  DB_EETPROG_INT_MULT,
+  DB_EETPROG_INT_DIV,
+  DB_EETPROG_INT_LT,
+  DB_EETPROG_INT_GT,
+  DB_EETPROG_INT_LTE,
+  DB_EETPROG_INT_GTE,
+  DB_EETPROG_INT_NEQ,
+  DB_EETPROG_INT_EQ,
+  DB_EETPROG_DECIMAL_UNARYNEG, /**< Decimal operators. */
+  DB_EETPROG_DECIMAL_NOT,
+  DB_EETPROG_DECIMAL_AND,
+  DB_EETPROG_DECIMAL_OR,
+  DB_EETPROG_DECIMAL_XOR,
+  DB_EETPROG_DECIMAL_ADD,
+  DB_EETPROG_DECIMAL_SUB,
+  DB_EETPROG_DECIMAL_MULT,
+  DB_EETPROG_DECIMAL_DIV,
+  DB_EETPROG_DECIMAL_LT,
+  DB_EETPROG_DECIMAL_GT,
+  DB_EETPROG_DECIMAL_LTE,
+  DB_EETPROG_DECIMAL_GTE,
+  DB_EETPROG_DECIMAL_NEQ,
+  DB_EETPROG_DECIMAL_EQ,
+  DB_EETPROG_STRING_LENGTH, /**< String functions and operators. */
+  DB_EETPROG_STRING_LT,
+  DB_EETPROG_STRING_GT,
+  DB_EETPROG_STRING_LTE,
+  DB_EETPROG_STRING_GTE,
+  DB_EETPROG_STRING_NEQ,
+  DB_EETPROG_STRING_EQ
+} db_eetprog_op;
+
+/**
+@struct		db_eetinstr_t
+@brief		A single instruction of a compiled expression.
+*/
+typedef struct {
+  /*@{*/
+  db_uint8 op;        /**< The @ref db_eetprog_op to carry out. */
+  db_uint8 tuple_pos; /**< Which tuple an attribute is read from. */
+  db_uint8 pos;       /**< The attribute's position, for its
+                           @c NULL bit. */
+  db_uint8 offset;    /**< The attribute's offset in the tuple. */
+  union {
+    db_int integer;
+    db_decimal decimal;
+    char *string;
+  } value;            /**< The value of a constant, or the number of
+                           instructions a jump skips. */
+                      /*@}*/
+} db_eetinstr_t;
+
+/**
+@struct		db_eetvalue_t
+@brief		A value on the stack of a running compiled expression.
+*/
+typedef struct {
+  /*@{*/
+  db_uint8 isnull; /**< @c 1 if the value is @c NULL. */
+  union {
+    db_int integer;
+    db_decimal decimal;
+    char *string;
+  } value;         /**< The value itself. */
+                   /*@}*/
+} db_eetvalue_t;
+
+/**
+@struct		db_eetprog_t
+@brief		An expression compiled for the schemas it will be evaluated
+                against.
+@details	Attribute types and offsets are looked up, and the type every
+                operator works on is settled, once, when the expression is
+                compiled.  The program and its value stack are allocated
+                together, so evaluating it takes no memory from the query
+                memory manager.
+*/
+typedef struct {
+  /*@{*/
+  db_eetinstr_t *code;  /**< The instructions, or @c NULL if the
+                             expression has not been compiled. */
+  db_eetvalue_t *stack; /**< The value stack. */
+  db_int length;        /**< The number of instructions, or @c -1
+                             if the expression could not be
+                             compiled. */
+  db_uint8 type;        /**< The @ref db_eetnode_type of constant
+                             the expression evaluates to. */
+                        /*@}*/
+} db_eetprog_t;
+
 /* Construct a new relation header an array of attribute positions. */
 /**
 @brief		Creates a new relation header from an array of projecting
@@ -309,6 +436,15 @@ detect here.
 */
 db_int advanceeetnodepointer(db_eetnode_t **npp, db_int num_times);
 
+/* Get the number of values an operator or function node consumes. */
+/**
+@brief		Get the number of arguments an operator or function node of
+		a given type takes.
+@param		type		The type of the node.
+@returns	@c 2 for binary operators, @c 1 otherwise.
+*/
+db_int eet_numrequiredvals(db_uint8 type);
+
 /* This function will return the type of the node at position pos in the
    expression. */
 /**
@@ -378,6 +514,10 @@ db_int subexpr_type_addr(db_eetnode_t *np, db_uint8 *type,
 /* Evaluate the tree and put result in rp. */
 /**
 @brief		Evaluate an expression and get its final value.
+@details	An aggregate function node takes the place of its argument
+                with the value pointed to by its @c value_p, or @c NULL if its
+                @c aggr_isnull flag is set.  It is an error to evaluate one
+                whose @c value_p has not been set.
 @param		eet		Pointer to the EET control structure
                                 representing the expression of interest.
 @param		rp		A pointer to a memory location where we wish
@@ -413,6 +553,129 @@ db_int evaluate_eet(db_eet_t *eet, void *rp, db_tuple_t **tp,
                     relation_header_t **hp, db_uint8 start_from,
                     db_query_mm_t *mmp);
 
+/* Decide a predicate that does not depend on any tuple. */
+/**
+@brief		Decide a predicate that is a single constant.
+@details	Folded predicates, such as @c WHERE @c 1 @c = @c 2, are reduced
+                to a single constant node, so whether any tuple passes is
+                known before any are read.
+@param		eet		Pointer to the EET control structure
+                                representing the predicate.
+@param		mmp		A pointer to the memory manager being used
+                                to allocate memory for query this expression
+                                is owned by.
+@returns	@c -1 if the predicate is not a single constant, @c 1 if every
+                tuple passes it, @c 0 if none do.
+*/
+db_int evaluate_eet_constant(db_eet_t *eet, db_query_mm_t *mmp);
+
+/* Mark an expression program as not yet compiled. */
+/**
+@brief		Initialize an expression program, without compiling anything.
+@param		progp		A pointer to the program.
+*/
+void init_eetprog(db_eetprog_t *progp);
+
+/* Compile an expression for a given set of schemas. */
+/**
+@brief		Compile an expression into a program.
+@details	Expressions whose operands do not all have the same type
+                (aside from @c NULL), or that contain aggregates or operators
+                not defined for their operands' type, are not compiled, and
+                must be evaluated with @ref evaluate_eet.
+
+                The right operand of an @c AND or @c OR is jumped over
+                whenever the left operand alone decides the result.
+@param		progp		A pointer to the program to compile into.
+@param		eet		Pointer to the EET control structure
+                                representing the expression of interest.
+@param		hp		An array of relation header pointers, as for
+                                @ref evaluate_eet.
+@param		mmp		A pointer to the memory manager being used
+                                to allocate memory for query this expression
+                                is owned by.
+@returns	@c 1 if the expression was compiled, @c 0 if it could not
+                be, or there was not enough memory to do so.
+*/
+db_int compile_eet(db_eetprog_t *progp, db_eet_t *eet, relation_header_t **hp,
+                   db_query_mm_t *mmp);
+
+/* Run a compiled expression. */
+/**
+@brief		Evaluate a compiled expression and get its final value.
+@param		progp		A pointer to a program built by
+                                @ref compile_eet.
+@param		rp		A pointer to a memory location where the
+                                result will be put, as for @ref evaluate_eet.
+@param		tp		An array of tuple pointers, as for
+                                @ref evaluate_eet.
+@returns	@c 2 if the expression returns @c NULL, @c 1 otherwise.
+*/
+db_int evaluate_eetprog(db_eetprog_t *progp, void *rp, db_tuple_t **tp);
+
+/* Evaluate an expression through its program, if it has one. */
+/**
+@brief		Evaluate an expression through its program, if it has been
+                compiled.
+@details	Operators keep a program for each expression they evaluate
+                for every tuple.  Nothing is compiled here, since memory taken
+                while the query is running would sit above whatever the
+                operators above have already taken; programs are instead
+                compiled once the plan is complete, by
+                @ref compileexecutiontree.  An expression without a program is
+                evaluated with @ref evaluate_eet.
+@param		progp		A pointer to the program, which must have been
+                                initialized with @ref init_eetprog.
+@returns	The same as @ref evaluate_eet.
+@see		For the other parameters, see @ref evaluate_eet.
+*/
+db_int evaluate_eet_compiled(db_eetprog_t *progp, db_eet_t *eet, void *rp,
+                             db_tuple_t **tp, relation_header_t **hp,
+                             db_query_mm_t *mmp);
+
+/* Free a compiled expression. */
+/**
+@brief		Free the memory held by an expression program, and mark it as
+                not yet compiled.
+@param		progp		A pointer to the program.
+@param		mmp		A pointer to the memory manager the program
+                                was compiled with.
+*/
+void close_eetprog(db_eetprog_t *progp, db_query_mm_t *mmp);
+
+/* Evaluate a predicate over a batch of tuples. */
+/**
+@brief		Evaluate a predicate over every selected tuple of a batch.
+@details	A tuple passes if the expression evaluates to exactly @c 1 for
+                it, as in @ref next_select.  Expressions made up only of
+                integer attributes, integer and @c NULL constants, and the
+                operators on integers are evaluated a node at a time across the
+                whole batch.  Anything else, or a batch too large for the
+                memory that is left, is evaluated a tuple at a time with
+                @ref evaluate_eet_compiled.
+@param		progp		A pointer to the predicate's program, or
+                                @c NULL to evaluate it with
+                                @ref evaluate_eet.
+@param		eet		Pointer to the EET control structure
+                                representing the predicate.
+@param		bp		A pointer to the batch of tuples.  Every
+                                attribute node must have a @p tuple_pos of
+                                @c 0.
+@param		hp		A pointer to the header describing the tuples
+                                in the batch.
+@param		selected	The selection bitmap, with bit @c i%8 of byte
+                                @c i/8 standing for tuple @c i.  Only tuples
+                                whose bits are set need pass; the bits of the
+                                tuples that do not pass are cleared.
+@param		mmp		A pointer to the memory manager being used
+                                to allocate memory for query this expression
+                                is owned by.
+@returns	@c 1.
+*/
+db_int evaluate_eet_batch(db_eetprog_t *progp, db_eet_t *eet,
+                          db_tuplebatch_t *bp, relation_header_t *hp,
+                          db_uint8 *selected, db_query_mm_t *mmp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,7 +31,7 @@ db_int getposbyname(relation_header_t *hp, char *attr_name) {
   db_int i = 0;
   /* Find the position by linear search. */
   for (i = 0; i < (db_int)hp->num_attr; ++i) {
-    if (strcmp(hp->names[i], attr_name) == 0) {
+    if (NULL != hp->names[i] && strcmp(hp->names[i], attr_name) == 0) {
       toRet = i;
       break;
     }
@@ -58,6 +58,15 @@ db_uint8 gettypebypos(relation_header_t *hp, db_int pos) {
   return hp->types[pos];
 }
 
+/* Return the offset of a relation's first tuple record in its file. */
+long gettuplestart(relation_header_t *hp) {
+  long start = 1;
+  db_int i;
+  for (i = 0; i < (db_int)hp->num_attr; ++i)
+    start += 4 + (long)(hp->size_name[i]);
+  return start;
+}
+
 db_int getrelationheader(relation_header_t **hpp, char *relationname,
                          db_query_mm_t *mmp) {
   db_fileref_t relation = db_openreadfile(relationname);
@@ -128,3 +137,133 @@ db_int freerelationheader(relation_header_t *hp, db_query_mm_t *mmp) {
 
   return 1;
 }
+
+/* Size of a relation's file, or -1 if it can not be opened. */
+static long relation_filesize(char *relationname) {
+  db_fileref_t relation = db_openreadfile(relationname);
+  long size;
+
+  if (DB_STORAGE_NOFILE == relation)
+    return -1;
+  size = db_filesize(relation);
+  db_fileclose(relation);
+  return size;
+}
+
+/* Write out a relation's statistics, after the size of its file when they
+   were taken. */
+static db_int relation_writestats(char *relationname, db_int num_tuples,
+                                  db_uint8 num_attr, db_uint8 *bounds,
+                                  db_int *min, db_int *max) {
+  char statsname[9 + strlen(relationname)];
+  long size = relation_filesize(relationname);
+  db_fileref_t stats;
+  db_int i, written;
+
+  if (size < 0)
+    return 0;
+  sprintf(statsname, "DB_STAT_%s", relationname);
+  stats = db_openwritefile(statsname);
+  if (DB_STORAGE_NOFILE == stats)
+    return 0;
+
+  written = sizeof(long) == db_filewrite(stats, &size, sizeof(long)) &&
+            sizeof(db_int) ==
+                db_filewrite(stats, &num_tuples, sizeof(db_int)) &&
+            1 == db_filewrite(stats, &num_attr, 1);
+  for (i = 0; written && i < (db_int)num_attr; ++i) {
+    written =
+        1 == db_filewrite(stats, &(bounds[i]), 1) &&
+        sizeof(db_int) == db_filewrite(stats, &(min[i]), sizeof(db_int)) &&
+        sizeof(db_int) == db_filewrite(stats, &(max[i]), sizeof(db_int));
+  }
+  db_fileclose(stats);
+
+  if (!written)
+    db_fileremove(statsname);
+  return written;
+}
+
+db_int createrelationstats(char *relationname, db_uint8 num_attr) {
+  db_uint8 bounds[(db_int)num_attr + 1];
+  db_int values[(db_int)num_attr + 1];
+  db_int i;
+
+  /* A new relation has no values at all. */
+  for (i = 0; i < (db_int)num_attr; ++i) {
+    bounds[i] = DB_RELSTATS_EMPTY;
+    values[i] = 0;
+  }
+  return relation_writestats(relationname, 0, num_attr, bounds, values,
+                             values);
+}
+
+db_int getrelationstats(relation_stats_t *sp, char *relationname,
+                        db_query_mm_t *mmp) {
+  char statsname[9 + strlen(relationname)];
+  db_fileref_t stats;
+  long size;
+  db_int i, valid;
+
+  sprintf(statsname, "DB_STAT_%s", relationname);
+  stats = db_openreadfile(statsname);
+  if (DB_STORAGE_NOFILE == stats)
+    return 0;
+
+  /* A relation written to some other way has statistics that don't hold. */
+  if (sizeof(long) != db_fileread(stats, (unsigned char *)&size,
+                                  sizeof(long)) ||
+      size != relation_filesize(relationname) ||
+      sizeof(db_int) != db_fileread(stats, (unsigned char *)&(sp->num_tuples),
+                                    sizeof(db_int)) ||
+      1 != db_fileread(stats, &(sp->num_attr), 1)) {
+    db_fileclose(stats);
+    return 0;
+  }
+
+  sp->bounds = DB_QMM_BALLOC(mmp, (size_t)(sp->num_attr));
+  sp->min = DB_QMM_BALLOC(mmp, ((size_t)(sp->num_attr)) * sizeof(db_int));
+  sp->max = DB_QMM_BALLOC(mmp, ((size_t)(sp->num_attr)) * sizeof(db_int));
+  valid = NULL != sp->bounds && NULL != sp->min && NULL != sp->max;
+  for (i = 0; valid && i < (db_int)(sp->num_attr); ++i) {
+    valid = 1 == db_fileread(stats, &(sp->bounds[i]), 1) &&
+            sizeof(db_int) == db_fileread(stats, (unsigned char *)&(sp->min[i]),
+                                          sizeof(db_int)) &&
+            sizeof(db_int) == db_fileread(stats, (unsigned char *)&(sp->max[i]),
+                                          sizeof(db_int));
+  }
+  db_fileclose(stats);
+
+  if (!valid) {
+    freerelationstats(sp, mmp);
+    return 0;
+  }
+  return 1;
+}
+
+db_int putrelationstats(relation_stats_t *sp, char *relationname) {
+  return relation_writestats(relationname, sp->num_tuples, sp->num_attr,
+                             sp->bounds, sp->min, sp->max);
+}
+
+db_int removerelationstats(char *relationname) {
+  char statsname[9 + strlen(relationname)];
+
+  sprintf(statsname, "DB_STAT_%s", relationname);
+  if (1 != db_fileexists(statsname))
+    return 1;
+  return db_fileremove(statsname);
+}
+
+void freerelationstats(relation_stats_t *sp, db_query_mm_t *mmp) {
+  if (NULL != sp->max)
+    DB_QMM_BFREE(mmp, sp->max);
+  if (NULL != sp->min)
+    DB_QMM_BFREE(mmp, sp->min);
+  if (NULL != sp->bounds)
+    DB_QMM_BFREE(mmp, sp->bounds);
+  sp->bounds = NULL;
+  sp->min = NULL;
+  sp->max = NULL;
+  sp->num_attr = 0;
+}
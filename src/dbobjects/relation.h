@@ -126,6 +126,16 @@ db_uint8 gettypebypos(relation_header_t *hp,	/* Pointer to relaiton header
 		db_int pos);			/* Position of attribute to
 						   return the type of. */
 
+/* Return the offset of a relation's first tuple record in its file. */
+/**
+@brief		Find where a relation's tuple records start in its file.
+@details	Records follow the relation's schema information, each
+		being the tuple's null bits followed by its bytes.
+@param		hp		Pointer to the schema of the relation.
+@return		The offset of the first record in the relation's file.
+*/
+long gettuplestart(relation_header_t *hp);
+
 /* Get relation header information for a relation. */
 /**
 @brief		Create in memory copy of relation meta data information.
@@ -158,6 +168,104 @@ db_int getrelationheader(relation_header_t **hpp,
 db_int freerelationheader(relation_header_t *hp,
 		db_query_mm_t *mmp);
 
+/* What is known about the values of an attribute. */
+/**
+@enum		relation_stats_bound_t
+@brief		What a relation's statistics know about the values of one of
+		its attributes.
+*/
+typedef enum
+{
+	DB_RELSTATS_UNKNOWN = 0,	/**< The smallest and largest values
+					     are not known. */
+	DB_RELSTATS_EMPTY,		/**< Every value is @c NULL. */
+	DB_RELSTATS_BOUNDED		/**< The smallest and largest values
+					     are known. */
+} relation_stats_bound_t;
+
+/* Relation statistics. */
+/**
+@struct		relation_stats_t
+@brief		Statistics about the tuples of a relation, kept up as tuples
+		are written to it.
+@details	Tuples whose @c __delete attribute is set are not counted.
+		Only the bounds of integer attributes are kept.  Once a tuple
+		holding the smallest or largest value of an attribute is
+		deleted or changed, that attribute's bounds are no longer
+		known.
+*/
+typedef struct
+{
+	/*@{*/
+	db_int num_tuples;	/**< The number of tuples in the relation. */
+	db_uint8 num_attr;	/**< The number of attributes in the
+				     relation. */
+	db_uint8 *bounds;	/**< A @ref relation_stats_bound_t for each
+				     attribute. */
+	db_int *min;		/**< The smallest value of each attribute. */
+	db_int *max;		/**< The largest value of each attribute. */
+	/*@}*/
+} relation_stats_t;
+
+/* Write out the statistics of a new relation. */
+/**
+@brief		Write out the statistics of a relation with no tuples.
+@param		relationname	The name of the relation.
+@param		num_attr	The number of attributes in the relation.
+@returns	@c 1 if the statistics were written, @c 0 otherwise.
+*/
+db_int createrelationstats(char *relationname,
+		db_uint8 num_attr);
+
+/* Read in the statistics of a relation. */
+/**
+@brief		Create an in memory copy of a relation's statistics.
+@details	Statistics are only kept for relations made by a CREATE
+		statement.  If the relation's file has been written to other
+		than by this library's statements since, its statistics are
+		not read.
+@param		sp		A pointer to the statistics to fill in.
+@param		relationname	The name of the relation.
+@param		mmp		A pointer to the per-query memory manager
+				instance that will be used to allocate
+				memory from.
+@returns	@c 1 if the statistics were read, @c 0 if the relation has
+		none that can be trusted, or they could not be read.
+*/
+db_int getrelationstats(relation_stats_t *sp,
+		char *relationname,
+		db_query_mm_t *mmp);
+
+/* Write out the statistics of a relation. */
+/**
+@brief		Write out a relation's statistics, once its tuples have been
+		written.
+@param		sp		A pointer to the statistics.
+@param		relationname	The name of the relation.
+@returns	@c 1 if the statistics were written, @c 0 otherwise.
+*/
+db_int putrelationstats(relation_stats_t *sp,
+		char *relationname);
+
+/* Throw away the statistics of a relation. */
+/**
+@brief		Throw away a relation's statistics, once they no longer hold.
+@param		relationname	The name of the relation.
+@returns	@c 1 if the relation has no statistics left, @c 0 otherwise.
+*/
+db_int removerelationstats(char *relationname);
+
+/* Remove relation statistics from memory. */
+/**
+@brief		Remove the statistics read by @ref getrelationstats from
+		memory.
+@param		sp		A pointer to the statistics.
+@param		mmp		The per-query memory manager used to allocate
+				memory for the statistics.
+*/
+void freerelationstats(relation_stats_t *sp,
+		db_query_mm_t *mmp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -113,13 +113,23 @@ db_int init_tuple(db_tuple_t *tp, db_uint8 tuple_size, db_uint8 num_attr,
   tp->isnull = DB_QMM_BALLOC(mmp, SIZE_BYTE * ((size_t)toalloc));
   tp->offset_r = 0;
 
+  if (NULL == tp->bytes || NULL == tp->isnull) {
+    if (NULL != tp->isnull)
+      DB_QMM_BFREE(mmp, tp->isnull);
+    if (NULL != tp->bytes)
+      DB_QMM_BFREE(mmp, tp->bytes);
+    tp->bytes = NULL;
+    tp->isnull = NULL;
+    return -1;
+  }
+
   /* Write 0's in bit array to avoid confusion with garbage. */
   db_int i = 0;
   for (; i < toalloc; i++)
     tp->isnull[i] = 0;
 
   // printf("tp->bytes (after malloc): %p\n", tp->bytes);
-  return 0;
+  return 1;
 }
 
 /* Destroy a tuple, specifically its bytes */
@@ -132,3 +142,114 @@ db_int close_tuple(db_tuple_t *tp, db_query_mm_t *mmp) {
 
   return 0;
 }
+
+/* Create a tuple batch. */
+db_int init_tuplebatch(db_tuplebatch_t *bp, db_int capacity,
+                       db_uint8 tuple_size, db_uint8 num_attr,
+                       db_query_mm_t *mmp) {
+  bp->isnullsize = ((db_int)num_attr) / 8;
+  if (((db_int)num_attr) % 8 > 0)
+    bp->isnullsize++;
+  bp->recordsize = bp->isnullsize + (db_int)tuple_size;
+  bp->count = 0;
+  bp->capacity = capacity;
+
+  bp->records = NULL;
+  bp->rows = NULL;
+  if (capacity < 1)
+    return -1;
+  bp->records = DB_QMM_BALLOC(mmp, (size_t)(capacity * bp->recordsize));
+  if (NULL == bp->records) {
+    bp->capacity = 0;
+    return -1;
+  }
+  return 1;
+}
+
+/* Keep the row offsets of a batch's tuples. */
+db_int keepbatchrows(db_tuplebatch_t *bp, db_query_mm_t *mmp) {
+  if (NULL != bp->rows)
+    return 1;
+  bp->rows = DB_QMM_BALLOC(mmp, (size_t)(bp->capacity) * sizeof(uint16_t));
+  return NULL == bp->rows ? -1 : 1;
+}
+
+/* Point a tuple at a tuple in a batch. */
+void viewbatchtuple(db_tuplebatch_t *bp, db_int i, db_tuple_t *tp) {
+  tp->isnull = (char *)(bp->records + i * bp->recordsize);
+  tp->bytes = tp->isnull + bp->isnullsize;
+  tp->offset_r = NULL == bp->rows ? 0 : bp->rows[i];
+}
+
+/* Destroy a tuple batch. */
+db_int close_tuplebatch(db_tuplebatch_t *bp, db_query_mm_t *mmp) {
+  if (NULL != bp->rows)
+    DB_QMM_BFREE(mmp, bp->rows);
+  bp->rows = NULL;
+  if (NULL != bp->records)
+    DB_QMM_BFREE(mmp, bp->records);
+  bp->records = NULL;
+  bp->capacity = 0;
+  bp->count = 0;
+  return 1;
+}
+
+/* Check if a tuple is counted in its relation's statistics, that is if it
+   has not been deleted. */
+static db_int tuple_islive(db_tuple_t *tp, relation_header_t *hp) {
+  db_int pos = getposbyname(hp, "__delete");
+  if (pos < 0 || (tp->isnull[pos / 8] & (1 << (pos % 8))))
+    return 1;
+  return 0 == getintbypos(tp, pos, hp);
+}
+
+/* Count a tuple written to a relation in its statistics. */
+void statsaddtuple(relation_stats_t *sp, db_tuple_t *tp,
+                   relation_header_t *hp) {
+  db_int i, value;
+
+  if (!tuple_islive(tp, hp))
+    return;
+  sp->num_tuples++;
+
+  for (i = 0; i < (db_int)(sp->num_attr) && i < (db_int)(hp->num_attr); ++i) {
+    if ((db_uint8)DB_RELSTATS_UNKNOWN == sp->bounds[i] ||
+        (tp->isnull[i / 8] & (1 << (i % 8))))
+      continue;
+    if (DB_INT != hp->types[i]) {
+      sp->bounds[i] = DB_RELSTATS_UNKNOWN;
+      continue;
+    }
+
+    value = getintbypos(tp, i, hp);
+    if ((db_uint8)DB_RELSTATS_EMPTY == sp->bounds[i]) {
+      sp->bounds[i] = DB_RELSTATS_BOUNDED;
+      sp->min[i] = value;
+      sp->max[i] = value;
+    } else if (value < sp->min[i]) {
+      sp->min[i] = value;
+    } else if (value > sp->max[i]) {
+      sp->max[i] = value;
+    }
+  }
+}
+
+/* Take a tuple out of the statistics of its relation. */
+void statsremovetuple(relation_stats_t *sp, db_tuple_t *tp,
+                      relation_header_t *hp) {
+  db_int i, value;
+
+  if (!tuple_islive(tp, hp))
+    return;
+  sp->num_tuples--;
+
+  /* Without the tuple, the next smallest or largest value is not known. */
+  for (i = 0; i < (db_int)(sp->num_attr) && i < (db_int)(hp->num_attr); ++i) {
+    if ((db_uint8)DB_RELSTATS_BOUNDED != sp->bounds[i] ||
+        (tp->isnull[i / 8] & (1 << (i % 8))))
+      continue;
+    value = getintbypos(tp, i, hp);
+    if (value == sp->min[i] || value == sp->max[i])
+      sp->bounds[i] = DB_RELSTATS_UNKNOWN;
+  }
+}
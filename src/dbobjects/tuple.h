@@ -69,6 +69,29 @@ typedef struct {
   /*@}*/
 } db_tuple_t;
 
+/* Tuple batch structure. */
+/**
+@struct db_tuplebatch_t
+@brief		A number of tuples of the same relation stored one after
+                another.
+@details	Each tuple is stored as a record: its bit-array of NULL flags
+                followed by its bytes, exactly as in a relation file.  Row
+                offsets are only kept for batches that ask for them with
+                @ref keepbatchrows.
+*/
+typedef struct {
+  /*@{*/
+  unsigned char *records; /**< The tuple records. */
+  db_int isnullsize;      /**< Number of bytes of NULL flags in a
+                               record. */
+  db_int recordsize;      /**< Number of bytes in a record. */
+  db_int capacity;        /**< Most tuples the batch can hold. */
+  db_int count;           /**< Number of tuples in the batch. */
+  uint16_t *rows;         /**< The row offset of each tuple, or
+                               @c NULL if they are not kept. */
+  /*@}*/
+} db_tuplebatch_t;
+
 /*** Methods for retrieving information from a tuple. */
 /* Retrieve a db_int from a tuple given its attribute name. */
 /**
@@ -245,6 +268,85 @@ db_int init_tuple(db_tuple_t *tp,      /* Pointer to tuple structure. */
 */
 db_int close_tuple(db_tuple_t *tp, db_query_mm_t *mmp);
 
+/* Create a tuple batch. */
+/**
+@brief		Initializes a tuple batch.
+@details	Memory for all of the batch's records is allocated up front.
+                The batch starts out empty.
+@param		bp		Pointer to the batch to initialize.
+@param		capacity	The most tuples the batch can hold.
+@param		tuple_size	The size, in bytes, of each tuple, not
+                                including the bit array for NULL
+                                signalling.
+@param		num_attr	The number of attributes in the relation.
+@param		mmp		A pointer to the memory manager that will be
+                                used to allocate memory. Pass NULL to use
+                                @c malloc(..).
+@return		1 on success, -1 otherwise.
+*/
+db_int init_tuplebatch(db_tuplebatch_t *bp, db_int capacity,
+                       db_uint8 tuple_size, db_uint8 num_attr,
+                       db_query_mm_t *mmp);
+
+/* Keep the row offsets of a batch's tuples. */
+/**
+@brief		Have a batch keep the row offset of each of its tuples, as
+                a tuple's @c offset_r.
+@details	Without this, the tuples of a batch have no row offsets.
+@param		bp		Pointer to the initialized batch.
+@param		mmp		A pointer to the memory manager that will be
+                                used to allocate memory. Pass NULL to use
+                                @c malloc(..).
+@return		1 on success, -1 otherwise.
+*/
+db_int keepbatchrows(db_tuplebatch_t *bp, db_query_mm_t *mmp);
+
+/* Point a tuple at a tuple in a batch. */
+/**
+@brief		Point a tuple at one of the tuples in a batch.
+@details	The tuple is not initialized with @ref init_tuple and must
+                not be closed.  It reads and writes the batch's record
+                directly.
+@param		bp		Pointer to the batch.
+@param		i		Which tuple of the batch, counting from @c 0.
+@param		tp		Pointer to the tuple to point at the record.
+*/
+void viewbatchtuple(db_tuplebatch_t *bp, db_int i, db_tuple_t *tp);
+
+/* Destroy a tuple batch. */
+/**
+@brief		Closes a tuple batch.
+@param		bp		Pointer to the batch to close.
+@param		mmp		A pointer to the memory manager that will be
+                                used to de-allocate memory.
+@return		1 on success, -1 otherwise.
+*/
+db_int close_tuplebatch(db_tuplebatch_t *bp, db_query_mm_t *mmp);
+
+/* Count a tuple written to a relation in its statistics. */
+/**
+@brief		Bring a relation's statistics up to date with a tuple written
+                to it.
+@param		sp		Pointer to the relation's statistics.
+@param		tp		Pointer to the tuple written.
+@param		hp		Pointer to the schema of the relation.
+*/
+void statsaddtuple(relation_stats_t *sp, db_tuple_t *tp,
+                   relation_header_t *hp);
+
+/* Take a tuple out of the statistics of its relation. */
+/**
+@brief		Bring a relation's statistics up to date with a tuple that is
+                overwritten.
+@details	Deleting a tuple is overwriting it with one whose
+                @c __delete attribute is set.
+@param		sp		Pointer to the relation's statistics.
+@param		tp		Pointer to the tuple as it was before.
+@param		hp		Pointer to the schema of the relation.
+*/
+void statsremovetuple(relation_stats_t *sp, db_tuple_t *tp,
+                      relation_header_t *hp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,18 +24,53 @@
 
 #include "aggregate.h"
 #include "../db_ctconf.h"
+#include "../dbmacros.h"
+#include "../dbstorage/dbstorage.h"
+#include <string.h>
 
 /*TODO: DB_DECIMAL functionality is not implemented here on a par with DB_INT
  * and DB_STRING. If this code will be used, add DB_DECIMAL.*/
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
 
+/* How an aggregate operator finds its groups. */
+#define DB_AGGREGATE_MODE_RESCAN 0
+#define DB_AGGREGATE_MODE_HASH 1
+#define DB_AGGREGATE_MODE_STREAM 2
+#define DB_AGGREGATE_MODE_SIMPLE 3
+
+/* Hash and streaming aggregation states. */
+#define DB_AGGREGATE_STATE_UNBUILT 0
+#define DB_AGGREGATE_STATE_BUILT 1
+#define DB_AGGREGATE_STATE_DONE 2
+
+/* Most partitions the child's tuples are split into when their groups do not
+   all fit in memory.  Each one is written through its own open file. */
+#define DB_AGGREGATE_MAXPARTS 8
+
+/* Most tuples read from the child at a time when there is no GROUP BY
+   clause. */
+#define DB_AGGREGATE_BATCHSIZE 16
+
+/* Enough to hold "DB_HA_<id>_<file>". */
+#define DB_AGGREGATE_NAMELENGTH 24
+
+/* Used to give each hash aggregate operator its own temporary files. */
+static db_uint8 db_aggregate_nextid = 0;
+
+static db_int aggregate_findaggrs(aggregate_t *ap, db_eet_t *eetp,
+                                  db_query_mm_t *mmp);
+
 /* Initialize the aggregate operator. */
 db_int init_aggregate(aggregate_t *ap, db_op_base_t *child, db_eet_t *exprs,
                       db_uint8 num_expr, db_eet_t *groupby_exprs,
                       db_uint8 num_groupby_expr, db_eet_t *having_expr,
                       db_query_mm_t *mmp) {
-  db_int i, j;
+  db_int i, j, type;
+  ap->mode = DB_AGGREGATE_MODE_RESCAN;
+  ap->aggrs = NULL;
+  ap->aggr_args = NULL;
+  ap->num_aggr = 0;
 
   /** Determine the aggregate locations, build array. **/
   /* Count the number of aggregates in each exprs[i]. */
@@ -43,7 +78,7 @@ db_int init_aggregate(aggregate_t *ap, db_op_base_t *child, db_eet_t *exprs,
   for (i = 0; i < (db_int)num_expr; ++i) {
     num_aggr[i] = 0;
     db_eetnode_t *np = exprs[i].nodes;
-    while ((db_uint8)DB_EETNODE_COUNT != np->type) {
+    while (POINTERBYTEDIST(np, exprs[i].nodes) < exprs[i].size) {
       if ((db_uint8)(DB_EETNODE_AGGR_TEMP) == np->type) {
         num_aggr[i]++;
       }
@@ -60,7 +95,7 @@ db_int init_aggregate(aggregate_t *ap, db_op_base_t *child, db_eet_t *exprs,
       db_int pos = 0;
       ap->aggr_locs[i] = DB_QMM_BALLOC(mmp, (db_int)(num_aggr[i]) + 1);
       db_eetnode_t *np = exprs[i].nodes;
-      while ((db_uint8)DB_EETNODE_COUNT != np->type) {
+      while (POINTERBYTEDIST(np, exprs[i].nodes) < exprs[i].size) {
         if ((db_uint8)DB_EETNODE_AGGR_TEMP == np->type) {
           ap->aggr_locs[i][j] = pos;
           j++;
@@ -70,34 +105,33 @@ db_int init_aggregate(aggregate_t *ap, db_op_base_t *child, db_eet_t *exprs,
       }
       ap->aggr_locs[i][j] = -1;
       /* The end marker. */ // TODO: This is clearly broken for uint8.
+      ap->num_aggr += num_aggr[i];
     }
   }
 
-  /* We will pre-compute types and jump_p's for all of the aggregate sub
-   * expressions.
-   */
-  for (i = 0; i < (db_int)num_expr; ++i) {
-    for (j = 0;; ++j) {
-      if (ap->aggr_locs[i] != NULL && ap->aggr_locs[i][j] > -1) {
-        db_eetnode_t *np =
-            geteetnodebypos(&exprs[i], (db_int)(ap->aggr_locs[i][j]));
-        if (np->type != (db_uint8)DB_EETNODE_AGGR_TEMP) {
-          return -1;
-        }
-        np = ((db_eetnode_t *)(((db_eetnode_aggr_temp_t *)np) + 1));
-        if (1 != subexpr_type_addr(
-                     np,
-                     &(((((db_eetnode_aggr_temp_t *)np) - 1))->subexpr_type),
-                     &((((db_eetnode_aggr_temp_t *)np) - 1)->jump_p),
-                     (exprs[i].size / sizeof(db_eetnode_t *)) + 1,
-                     &(child->header), mmp)) {
-          return -1;
-        }
-      } else {
-        break;
-      }
+  /* Find the argument of each aggregate, in the order of aggr_locs, and
+     pre-compute its type. */
+  if (ap->num_aggr > 0) {
+    ap->aggrs = DB_QMM_BALLOC(mmp, ((size_t)(ap->num_aggr)) *
+                                       sizeof(db_eetnode_aggr_temp_t *));
+    ap->aggr_args =
+        DB_QMM_BALLOC(mmp, ((size_t)(ap->num_aggr)) * sizeof(db_eet_t));
+    if (NULL == ap->aggrs || NULL == ap->aggr_args)
+      return -1;
+    ap->num_aggr = 0;
+    for (i = 0; i < (db_int)num_expr; ++i) {
+      if (ap->aggr_locs[i] != NULL &&
+          1 != aggregate_findaggrs(ap, &(exprs[i]), mmp))
+        return -1;
     }
   }
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i) {
+    type = evaluate_eet(&(ap->aggr_args[i]), NULL, NULL, &(child->header), 0,
+                        mmp);
+    if (-1 == type)
+      return -1;
+    ap->aggrs[i]->subexpr_type = (db_uint8)type;
+  }
 
   ap->base.type = DB_AGGREGATE;
   ap->base.header = DB_QMM_BALLOC(mmp, sizeof(relation_header_t));
@@ -124,8 +158,1018 @@ db_int init_aggregate(aggregate_t *ap, db_op_base_t *child, db_eet_t *exprs,
   return 1;
 }
 
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int aggregate_isnullsize(relation_header_t *hp) {
+  db_int size = ((db_int)(hp->num_attr)) / 8;
+  if (((db_int)(hp->num_attr)) % 8 > 0)
+    size++;
+  return size;
+}
+
+/* Number of bytes in a group record.  Each one holds the hash value of the
+   group, the value of each aggregate, a byte that is 1 if the slot is used,
+   a byte that is 1 if each aggregate is NULL, and the first tuple of the
+   group. */
+static db_int aggregate_slotsize(aggregate_t *ap) {
+  return (db_int)sizeof(db_uint32) +
+         ((db_int)(ap->num_aggr)) * (db_int)(sizeof(db_int) + 1) + 1 +
+         aggregate_isnullsize(ap->child->header) +
+         (db_int)(ap->child->header->tuple_size);
+}
+
+static db_int *aggregate_slotvalues(unsigned char *slot) {
+  return (db_int *)(slot + sizeof(db_uint32));
+}
+
+/* The flags of a group record, whether it is used and then whether each
+   aggregate is NULL. */
+static unsigned char *aggregate_slotflags(aggregate_t *ap,
+                                          unsigned char *slot) {
+  return slot + sizeof(db_uint32) + ((size_t)(ap->num_aggr)) * sizeof(db_int);
+}
+
+/* Point a tuple at the first tuple of a group record. */
+static void aggregate_viewslot(aggregate_t *ap, db_tuple_t *tp,
+                               unsigned char *slot) {
+  tp->isnull = (char *)(aggregate_slotflags(ap, slot) + 1 + ap->num_aggr);
+  tp->bytes = tp->isnull + aggregate_isnullsize(ap->child->header);
+  tp->offset_r = 0;
+}
+
+/* Find the aggregate function nodes of an expression, and the argument of
+   each.  The expression is in postfix order, so its shape is recovered with
+   a stack holding the node each subexpression starts at.  If aggrs has not
+   been allocated, the aggregates are only counted. */
+static db_int aggregate_findaggrs(aggregate_t *ap, db_eet_t *eetp,
+                                  db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  db_eetnode_t **stack;
+  db_int count = 0, top = 0, numvals, result = 1;
+
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    count++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  stack = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_eetnode_t *));
+  if (NULL == stack)
+    return -1;
+
+  cursor = eetp->nodes;
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_AGGR_TEMP == cursor->type) {
+      if (top < 1) {
+        result = -1;
+        break;
+      }
+      /* The aggregate's value takes the place of its argument's. */
+      if (NULL != ap->aggrs) {
+        ap->aggrs[ap->num_aggr] = (db_eetnode_aggr_temp_t *)cursor;
+        ap->aggr_args[ap->num_aggr].nodes = stack[top - 1];
+        ap->aggr_args[ap->num_aggr].size =
+            POINTERBYTEDIST(cursor, stack[top - 1]);
+        ap->aggr_args[ap->num_aggr].stack_size = eetp->stack_size;
+      }
+      ap->num_aggr++;
+    } else if ((db_uint8)DB_EETNODE_OP_UNARYNEG > cursor->type ||
+               (db_uint8)DB_EETNODE_PLACEHOLDER == cursor->type) {
+      stack[top++] = cursor;
+    } else {
+      numvals = eet_numrequiredvals(cursor->type);
+      if (top < numvals) {
+        result = -1;
+        break;
+      }
+      /* The result starts where the first operand does. */
+      top -= numvals - 1;
+    }
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  db_qmm_ffree(mmp, stack);
+  return result;
+}
+
+/* Check that an aggregate can be computed by the hash mode, noting the type
+   of its argument. */
+static db_int aggregate_checkaggr(aggregate_t *ap, db_int which,
+                                  db_query_mm_t *mmp) {
+  db_eetnode_aggr_temp_t *np = ap->aggrs[which];
+  db_eet_t *argp = &(ap->aggr_args[which]);
+  db_eetnode_t *cursor = argp->nodes;
+  db_int type;
+
+  /* Aggregates of aggregates make no sense. */
+  while (POINTERBYTEDIST(cursor, argp->nodes) < argp->size) {
+    if ((db_uint8)DB_EETNODE_AGGR_TEMP == cursor->type)
+      return -1;
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  type = evaluate_eet(argp, NULL, NULL, &(ap->child->header), 0, mmp);
+  if (-1 == type || np->aggr_type > (db_uint8)DB_AGGR_LAST)
+    return -1;
+  /* Anything can be counted, but the other aggregates are only computed over
+     integers. */
+  if ((db_uint8)DB_AGGR_COUNTROWS != np->aggr_type &&
+      (db_uint8)DB_EETNODE_CONST_DBINT != type &&
+      (db_uint8)DB_EETNODE_CONST_NULL != type)
+    return -1;
+
+  np->subexpr_type = (db_uint8)type;
+  np->value_p = NULL;
+  np->aggr_isnull = 1;
+  return 1;
+}
+
+/* Number of bytes free in the query memory right now, less what evaluating
+   the expressions takes. */
+static db_int aggregate_available(aggregate_t *ap, db_query_mm_t *mmp) {
+  db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+  db_int stack_size = 0;
+  db_int i;
+  for (i = 0; i < (db_int)(ap->num_expr); ++i)
+    if (ap->exprs[i].stack_size > stack_size)
+      stack_size = ap->exprs[i].stack_size;
+  for (i = 0; i < (db_int)(ap->num_groupby_expr); ++i)
+    if (ap->groupby_exprs[i].stack_size > stack_size)
+      stack_size = ap->groupby_exprs[i].stack_size;
+  if (NULL != ap->having_expr && ap->having_expr->stack_size > stack_size)
+    stack_size = ap->having_expr->stack_size;
+  reserve += stack_size + (db_int)sizeof(db_int);
+
+  db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+  if (avail < reserve)
+    return 0;
+  return avail - reserve;
+}
+
+/* Number of group records that fit in the query memory right now. */
+static db_int aggregate_capacity(aggregate_t *ap, db_query_mm_t *mmp) {
+  return aggregate_available(ap, mmp) / aggregate_slotsize(ap);
+}
+
+/* Hash the grouping values of a tuple.  Integers are hashed
+   multiplicatively, strings with FNV-1a, and the values are combined as the
+   bytes of a string are. */
+static db_int aggregate_hash(aggregate_t *ap, db_tuple_t *tp, db_uint32 *hashp,
+                             db_query_mm_t *mmp) {
+  db_uint32 hash = 2166136261UL, value;
+  db_int i, j, result, integer;
+  char *string;
+
+  for (i = 0; i < (db_int)(ap->num_groupby_expr); ++i) {
+    value = 0;
+    if ((db_uint8)DB_EETNODE_CONST_DBSTRING == ap->groupby_types[i]) {
+      result = evaluate_eet(&(ap->groupby_exprs[i]), &string, &tp,
+                            &(ap->child->header), 0, mmp);
+      if (1 == result) {
+        value = 2166136261UL;
+        for (j = 0; '\0' != string[j]; ++j) {
+          value ^= (db_uint32)((unsigned char)string[j]);
+          value *= 16777619UL;
+        }
+      }
+    } else if ((db_uint8)DB_EETNODE_CONST_DBINT == ap->groupby_types[i]) {
+      result = evaluate_eet(&(ap->groupby_exprs[i]), &integer, &tp,
+                            &(ap->child->header), 0, mmp);
+      if (1 == result)
+        value = ((db_uint32)integer) * 2654435761UL;
+    } else {
+      /* Grouping on NULL puts every tuple in the same group. */
+      result = 2;
+    }
+
+    if (-1 == result)
+      return -1;
+    hash = (hash ^ value) * 16777619UL;
+  }
+
+  *hashp = hash;
+  return 1;
+}
+
+/* Find the record of a tuple's group, or the empty slot it would take.  The
+   table is never full, so one is always found.  Returns 1 if the group was
+   found, 0 if not. */
+static db_int aggregate_probe(aggregate_t *ap, db_tuple_t *tp, db_uint32 hash,
+                              db_uint8 *orderings, unsigned char **slotp,
+                              db_query_mm_t *mmp) {
+  db_int slotsize = aggregate_slotsize(ap);
+  db_int i = (db_int)(hash % (db_uint32)(ap->num_slots));
+  unsigned char *slot;
+  db_tuple_t gt;
+
+  while (1) {
+    slot = ap->slots + i * slotsize;
+    *slotp = slot;
+    if (0 == aggregate_slotflags(ap, slot)[0])
+      return 0;
+
+    if (*((db_uint32 *)slot) == hash) {
+      aggregate_viewslot(ap, &gt, slot);
+      if (0 == cmp_tuple(&gt, tp, ap->child->header, ap->child->header,
+                         ap->groupby_exprs, ap->groupby_exprs,
+                         ap->num_groupby_expr, orderings, 1, mmp))
+        return 1;
+    }
+    i = (i + 1) % ap->num_slots;
+  }
+}
+
+/* Start a new group in an empty slot, with a tuple as its first.  With no
+   tuple, every attribute of the group's first tuple is NULL. */
+static void aggregate_newgroup(aggregate_t *ap, unsigned char *slot,
+                               db_uint32 hash, db_tuple_t *tp) {
+  relation_header_t *hp = ap->child->header;
+  db_int *values = aggregate_slotvalues(slot);
+  unsigned char *flags = aggregate_slotflags(ap, slot);
+  db_tuple_t gt;
+  db_int i;
+
+  *((db_uint32 *)slot) = hash;
+  flags[0] = 1;
+  /* Counts start at 0, the other aggregates are NULL until they see a
+     value. */
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i) {
+    values[i] = 0;
+    flags[i + 1] =
+        (db_uint8)DB_AGGR_COUNTROWS == ap->aggrs[i]->aggr_type ? 0 : 1;
+  }
+
+  aggregate_viewslot(ap, &gt, slot);
+  if (NULL == tp) {
+    memset(gt.isnull, 0xFF, (size_t)aggregate_isnullsize(hp));
+    memset(gt.bytes, 0, (size_t)(hp->tuple_size));
+  } else {
+    memcpy(gt.isnull, tp->isnull, (size_t)aggregate_isnullsize(hp));
+    memcpy(gt.bytes, tp->bytes, (size_t)(hp->tuple_size));
+  }
+  ap->num_groups++;
+}
+
+/* Fold a tuple into the aggregates of its group.  NULLs are left out of
+   every aggregate.  Arguments are evaluated through their compiled form, if
+   they have one. */
+static db_int aggregate_accumulate(aggregate_t *ap, unsigned char *slot,
+                                   db_tuple_t *tp, db_query_mm_t *mmp) {
+  db_int *values = aggregate_slotvalues(slot);
+  unsigned char *isnull = aggregate_slotflags(ap, slot) + 1;
+  db_eetnode_aggr_temp_t *np;
+  db_int i, result, value;
+  /* Whatever the argument's type, its value fits. */
+  union {
+    db_int integer;
+    db_decimal decimal;
+    char *string;
+  } arg;
+
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i) {
+    np = ap->aggrs[i];
+    if (NULL != ap->progs)
+      result = evaluate_eet_compiled(&(ap->progs[i]), &(ap->aggr_args[i]),
+                                     &arg, &tp, &(ap->child->header), mmp);
+    else
+      result = evaluate_eet(&(ap->aggr_args[i]), &arg, &tp,
+                            &(ap->child->header), 0, mmp);
+    value = arg.integer;
+    if (-1 == result)
+      return -1;
+    else if (1 != result)
+      continue;
+
+    if ((db_uint8)DB_AGGR_COUNTROWS == np->aggr_type) {
+      values[i]++;
+    } else if (1 == isnull[i]) {
+      values[i] = value;
+      isnull[i] = 0;
+    } else {
+      switch (np->aggr_type) {
+      case DB_AGGR_BAND:
+        values[i] &= value;
+        break;
+      case DB_AGGR_BOR:
+        values[i] |= value;
+        break;
+      case DB_AGGR_BXOR:
+        values[i] ^= value;
+        break;
+      case DB_AGGR_SUM:
+        values[i] += value;
+        break;
+      case DB_AGGR_MAX:
+        if (value > values[i])
+          values[i] = value;
+        break;
+      case DB_AGGR_MIN:
+        if (value < values[i])
+          values[i] = value;
+        break;
+      case DB_AGGR_LAST:
+        values[i] = value;
+        break;
+      default: /* DB_AGGR_FIRST */
+        break;
+      }
+    }
+  }
+  return 1;
+}
+
+static void aggregate_filename(aggregate_t *ap, db_int which, char *name) {
+  sprintf(name, "DB_HA_%d_%d", (int)(ap->hashid), (int)which);
+}
+
+/* Read a tuple record from a temporary file.  Returns 1 if a record was
+   read, 0 at the end of the file, -1 on error. */
+static db_int aggregate_readrecord(db_fileref_t f, db_tuple_t *tp,
+                                   relation_header_t *hp) {
+  size_t isnullsize = (size_t)aggregate_isnullsize(hp);
+  if (isnullsize != db_fileread(f, (unsigned char *)tp->isnull, isnullsize))
+    return 0;
+  if ((size_t)(hp->tuple_size) !=
+      db_fileread(f, (unsigned char *)tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+static db_int aggregate_writerecord(db_fileref_t f, db_tuple_t *tp,
+                                    relation_header_t *hp) {
+  size_t isnullsize = (size_t)aggregate_isnullsize(hp);
+  if (isnullsize != db_filewrite(f, tp->isnull, isnullsize) ||
+      (size_t)(hp->tuple_size) !=
+          db_filewrite(f, tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+/* Read the next tuple to aggregate, from the child or from a temporary
+   file. */
+static db_int aggregate_nexttuple(aggregate_t *ap, db_fileref_t input,
+                                  db_query_mm_t *mmp) {
+  if (DB_STORAGE_NOFILE == input)
+    return next(ap->child, &(ap->src_t), mmp);
+  return aggregate_readrecord(input, &(ap->src_t), ap->child->header);
+}
+
+/* Mark every slot of the table as empty. */
+static void aggregate_cleartable(aggregate_t *ap) {
+  db_int slotsize = aggregate_slotsize(ap);
+  db_int i;
+  for (i = 0; i < ap->num_slots; ++i)
+    aggregate_slotflags(ap, ap->slots + i * slotsize)[0] = 0;
+  ap->num_groups = 0;
+  ap->position = 0;
+}
+
+/* Aggregate the tuples of the child, or of a temporary file, into the table,
+   starting with the one already read.  Once the table is full, the tuples of
+   groups not in it are written out to new temporary files to be aggregated
+   later.  Those from the child are split by hash value into partitions, but
+   those from a temporary file all share a partition, so they are written to
+   a single file. */
+static db_int aggregate_build(aggregate_t *ap, db_fileref_t input,
+                              db_query_mm_t *mmp) {
+  relation_header_t *hp = ap->child->header;
+  db_tuple_t *tp = &(ap->src_t);
+  db_uint8 orderings[(db_int)(ap->num_groupby_expr) + 1];
+  char name[DB_AGGREGATE_NAMELENGTH];
+  db_int num_parts = 0, part, result, i;
+  unsigned char *slot;
+  db_uint32 hash;
+
+  for (i = 0; i < (db_int)(ap->num_groupby_expr); ++i)
+    orderings[i] = (db_uint8)DB_TUPLE_ORDER_ASC;
+
+  do {
+    if (1 != aggregate_hash(ap, tp, &hash, mmp)) {
+      result = -1;
+      break;
+    }
+
+    if (0 == aggregate_probe(ap, tp, hash, orderings, &slot, mmp)) {
+      if (ap->num_groups < 3 * ap->num_slots / 4) {
+        aggregate_newgroup(ap, slot, hash, tp);
+      } else {
+        /* There is no room for another group, so the tuple must wait. */
+        if (0 == num_parts) {
+          num_parts = DB_STORAGE_NOFILE == input ? DB_AGGREGATE_MAXPARTS : 1;
+          for (i = 0; i < num_parts; ++i) {
+            aggregate_filename(ap, ap->num_files, name);
+            db_fileremove(name);
+            ap->parts[i] = db_openwritefile(name);
+            ap->num_files++;
+            if (DB_STORAGE_NOFILE == ap->parts[i])
+              break;
+          }
+          if (i < num_parts) {
+            result = -1;
+            break;
+          }
+        }
+
+        part = (db_int)((hash >> 16) % (db_uint32)num_parts);
+        if (1 != aggregate_writerecord(ap->parts[part], tp, hp)) {
+          result = -1;
+          break;
+        }
+        continue;
+      }
+    }
+
+    if (1 != aggregate_accumulate(ap, slot, tp, mmp)) {
+      result = -1;
+      break;
+    }
+  } while (1 == (result = aggregate_nexttuple(ap, input, mmp)));
+
+  for (i = 0; i < DB_AGGREGATE_MAXPARTS; ++i) {
+    if (DB_STORAGE_NOFILE != ap->parts[i])
+      db_fileclose(ap->parts[i]);
+    ap->parts[i] = DB_STORAGE_NOFILE;
+  }
+  return -1 == result ? -1 : 1;
+}
+
+/* Once every group is in the table, move them to the end of it, one after
+   another, and give back the empty slots before them.  Only the groups are
+   read from the table after this. */
+static void aggregate_packtable(aggregate_t *ap, db_query_mm_t *mmp) {
+  db_int slotsize = aggregate_slotsize(ap);
+  db_int i, empty = ap->num_slots;
+
+  for (i = ap->num_slots - 1; i >= 0; --i) {
+    if (0 == aggregate_slotflags(ap, ap->slots + i * slotsize)[0])
+      continue;
+    empty--;
+    if (empty != i)
+      memmove(ap->slots + empty * slotsize, ap->slots + i * slotsize,
+              (size_t)slotsize);
+  }
+
+  ap->slots = db_qmm_bextend(mmp, -1 * empty * slotsize);
+  ap->num_slots -= empty;
+}
+
+/* Take the memory for the table and aggregate the child into it. */
+static db_int aggregate_start(aggregate_t *ap, db_query_mm_t *mmp) {
+  relation_header_t *hp = ap->child->header;
+  db_int capacity, result, i;
+
+  init_tuple(&(ap->src_t), hp->tuple_size, hp->num_attr, mmp);
+  ap->parts = db_qmm_balloc(
+      mmp, ((size_t)DB_AGGREGATE_MAXPARTS) * sizeof(db_fileref_t));
+  /* From here on, closing frees the memory taken. */
+  ap->state = DB_AGGREGATE_STATE_BUILT;
+  if (NULL == ap->parts)
+    return -1;
+  for (i = 0; i < DB_AGGREGATE_MAXPARTS; ++i)
+    ap->parts[i] = DB_STORAGE_NOFILE;
+
+  /* The child's first tuple is read before the table takes the free memory,
+     so an operator below that holds memory between calls, like a sort, has
+     already taken it. */
+  result = aggregate_nexttuple(ap, DB_STORAGE_NOFILE, mmp);
+  if (1 != result)
+    return result;
+
+  capacity = aggregate_capacity(ap, mmp);
+  if (capacity < 2)
+    return -1;
+  ap->slots = db_qmm_balloc(mmp, (size_t)(capacity * aggregate_slotsize(ap)));
+  if (NULL == ap->slots)
+    return -1;
+  ap->num_slots = capacity;
+  aggregate_cleartable(ap);
+
+  result = aggregate_build(ap, DB_STORAGE_NOFILE, mmp);
+
+  /* If every group fit, what the table does not need is left for the
+     operators above, such as a sort of the groups. */
+  if (1 == result && 0 == ap->num_files && ap->num_groups > 0 &&
+      POINTERATNBYTES(ap->slots, -1 * ((db_int)sizeof(db_int)), void *) ==
+          mmp->last_back)
+    aggregate_packtable(ap, mmp);
+  return result;
+}
+
+/* Aggregate the next temporary file into the table.  Returns 1 if there was
+   one, 0 if every file has been aggregated, -1 on error. */
+static db_int aggregate_nextfile(aggregate_t *ap, db_query_mm_t *mmp) {
+  char name[DB_AGGREGATE_NAMELENGTH];
+  db_fileref_t input;
+  db_int result;
+
+  if (ap->file >= ap->num_files)
+    return 0;
+
+  aggregate_filename(ap, ap->file, name);
+  input = db_openreadfile(name);
+  if (DB_STORAGE_NOFILE == input)
+    return -1;
+
+  aggregate_cleartable(ap);
+  result = aggregate_nexttuple(ap, input, mmp);
+  if (1 == result)
+    result = aggregate_build(ap, input, mmp);
+
+  db_fileclose(input);
+  db_fileremove(name);
+  ap->file++;
+  return -1 == result ? -1 : 1;
+}
+
+/* Free the table and remove any temporary files left. */
+static void aggregate_freebuffers(aggregate_t *ap, db_query_mm_t *mmp) {
+  char name[DB_AGGREGATE_NAMELENGTH];
+  db_int i;
+
+  if (DB_AGGREGATE_STATE_UNBUILT == ap->state)
+    return;
+
+  for (i = ap->file; i < ap->num_files; ++i) {
+    aggregate_filename(ap, i, name);
+    db_fileremove(name);
+  }
+  if (NULL != ap->slots)
+    db_qmm_bfree(mmp, ap->slots);
+  if (NULL != ap->parts)
+    db_qmm_bfree(mmp, ap->parts);
+  if (DB_AGGREGATE_MODE_SIMPLE == ap->mode) {
+    for (i = 0; NULL != ap->progs && i < (db_int)(ap->num_aggr); ++i)
+      close_eetprog(&(ap->progs[i]), mmp);
+  } else {
+    close_tuple(&(ap->src_t), mmp);
+  }
+
+  ap->slots = NULL;
+  ap->parts = NULL;
+  ap->num_slots = 0;
+  ap->num_groups = 0;
+  ap->position = 0;
+  ap->file = 0;
+  ap->num_files = 0;
+  ap->state = DB_AGGREGATE_STATE_UNBUILT;
+}
+
+/* Write out the result for a group, if it passes the HAVING clause.  Returns
+   1 if it was written, 0 if it did not pass, -1 on error. */
+static db_int aggregate_writegroup(aggregate_t *ap, unsigned char *slot,
+                                   db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  relation_header_t *hp = ap->base.header;
+  db_int *values = aggregate_slotvalues(slot);
+  unsigned char *isnull = aggregate_slotflags(ap, slot) + 1;
+  db_tuple_t gt, *gtp = &gt;
+  db_int i, j, result, value;
+  db_decimal decimal;
+  char *string;
+
+  /* Every other expression is evaluated on the group's first tuple. */
+  aggregate_viewslot(ap, &gt, slot);
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i) {
+    ap->aggrs[i]->value_p = &(values[i]);
+    ap->aggrs[i]->aggr_isnull = isnull[i];
+  }
+
+  if (NULL != ap->having_expr) {
+    result = evaluate_eet(ap->having_expr, &value, &gtp, &(ap->child->header),
+                          0, mmp);
+    if (-1 == result)
+      return -1;
+    else if (1 != result || 0 == value)
+      return 0;
+  }
+
+  for (i = 0; i < (db_int)(ap->num_expr); ++i) {
+    if (DB_STRING == hp->types[i]) {
+      result = evaluate_eet(&(ap->exprs[i]), &string, &gtp,
+                            &(ap->child->header), 0, mmp);
+      if (1 == result) {
+        for (j = 0; j < (db_int)(hp->sizes[i]) - 1 && '\0' != string[j]; ++j)
+          next_tp->bytes[(db_int)(hp->offsets[i]) + j] = string[j];
+        for (; j < (db_int)(hp->sizes[i]); ++j)
+          next_tp->bytes[(db_int)(hp->offsets[i]) + j] = '\0';
+      }
+    } else if (DB_DECIMAL == hp->types[i]) {
+      result = evaluate_eet(&(ap->exprs[i]), &decimal, &gtp,
+                            &(ap->child->header), 0, mmp);
+      if (1 == result)
+        *((db_decimal *)(&(next_tp->bytes[(db_int)(hp->offsets[i])]))) =
+            decimal;
+    } else {
+      result = evaluate_eet(&(ap->exprs[i]), &value, &gtp,
+                            &(ap->child->header), 0, mmp);
+      if (1 == result && DB_INT == hp->types[i])
+        *((db_int *)(&(next_tp->bytes[(db_int)(hp->offsets[i])]))) = value;
+    }
+
+    if (-1 == result)
+      return -1;
+    else if (1 == result && DB_NULL != hp->types[i])
+      next_tp->isnull[i / 8] &= ~(1 << (i % 8));
+    else
+      next_tp->isnull[i / 8] |= (1 << (i % 8));
+  }
+  return 1;
+}
+
+/* Return the next group from a hash aggregate operator. */
+static db_int aggregate_nexthash(aggregate_t *ap, db_tuple_t *next_tp,
+                                 db_query_mm_t *mmp) {
+  db_int slotsize, result;
+  unsigned char *slot;
+
+  if (DB_AGGREGATE_STATE_UNBUILT == ap->state &&
+      -1 == aggregate_start(ap, mmp))
+    return -1;
+
+  slotsize = aggregate_slotsize(ap);
+  while (1) {
+    while (ap->position < ap->num_slots) {
+      slot = ap->slots + ap->position * slotsize;
+      ap->position++;
+      if (0 == aggregate_slotflags(ap, slot)[0])
+        continue;
+
+      result = aggregate_writegroup(ap, slot, next_tp, mmp);
+      if (0 != result)
+        return result;
+    }
+
+    /* Every group in memory has been returned, so those that did not fit
+       come next. */
+    result = aggregate_nextfile(ap, mmp);
+    if (1 != result)
+      return result;
+  }
+}
+
+/* Start the first group of a streaming aggregate operator with the child's
+   first tuple. */
+static db_int aggregate_startstream(aggregate_t *ap, db_query_mm_t *mmp) {
+  relation_header_t *hp = ap->child->header;
+  db_int result;
+
+  init_tuple(&(ap->src_t), hp->tuple_size, hp->num_attr, mmp);
+  /* From here on, closing frees the memory taken. */
+  ap->state = DB_AGGREGATE_STATE_BUILT;
+
+  /* Only one group is ever kept, so its slot is taken before the child
+     takes whatever memory it wants. */
+  if (aggregate_capacity(ap, mmp) < 1)
+    return -1;
+  ap->slots = db_qmm_balloc(mmp, (size_t)aggregate_slotsize(ap));
+  if (NULL == ap->slots)
+    return -1;
+  ap->num_slots = 1;
+
+  result = next(ap->child, &(ap->src_t), mmp);
+  if (0 == result)
+    ap->state = DB_AGGREGATE_STATE_DONE;
+  if (1 != result)
+    return result;
+
+  aggregate_newgroup(ap, ap->slots, 0, &(ap->src_t));
+  return aggregate_accumulate(ap, ap->slots, &(ap->src_t), mmp);
+}
+
+/* Return the next group from a streaming aggregate operator.  The child
+   returns the tuples of each group one after another, so only the group
+   being aggregated is kept, and a group ends at the first tuple that is not
+   in it. */
+static db_int aggregate_nextstream(aggregate_t *ap, db_tuple_t *next_tp,
+                                   db_query_mm_t *mmp) {
+  db_uint8 orderings[(db_int)(ap->num_groupby_expr) + 1];
+  db_int result, i;
+  db_tuple_t gt;
+
+  if (DB_AGGREGATE_STATE_UNBUILT == ap->state) {
+    result = aggregate_startstream(ap, mmp);
+    if (1 != result)
+      return result;
+  }
+
+  for (i = 0; i < (db_int)(ap->num_groupby_expr); ++i)
+    orderings[i] = (db_uint8)DB_TUPLE_ORDER_ASC;
+
+  while (DB_AGGREGATE_STATE_BUILT == ap->state) {
+    result = next(ap->child, &(ap->src_t), mmp);
+    if (-1 == result)
+      return -1;
+    else if (0 == result) {
+      ap->state = DB_AGGREGATE_STATE_DONE;
+      return aggregate_writegroup(ap, ap->slots, next_tp, mmp);
+    }
+
+    aggregate_viewslot(ap, &gt, ap->slots);
+    if (0 == cmp_tuple(&gt, &(ap->src_t), ap->child->header,
+                       ap->child->header, ap->groupby_exprs,
+                       ap->groupby_exprs, ap->num_groupby_expr, orderings, 1,
+                       mmp)) {
+      if (1 != aggregate_accumulate(ap, ap->slots, &(ap->src_t), mmp))
+        return -1;
+      continue;
+    }
+
+    /* The tuple starts the next group, so the current one is done. */
+    result = aggregate_writegroup(ap, ap->slots, next_tp, mmp);
+    aggregate_newgroup(ap, ap->slots, 0, &(ap->src_t));
+    if (1 != aggregate_accumulate(ap, ap->slots, &(ap->src_t), mmp))
+      return -1;
+    if (0 != result)
+      return result;
+  }
+  return 0;
+}
+
+/* Count the attribute nodes of an expression. */
+static db_int aggregate_countattrs(db_eet_t *eetp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  db_int count = 0;
+
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type)
+      count++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  return count;
+}
+
+/* Answer the aggregates of the one group from the statistics of the child's
+   relation.  Every aggregate is checked before any is written, so the group
+   is left as it was if they cannot all be answered.  Returns 1 if they were
+   answered, 0 if not. */
+static db_int aggregate_fromstats(aggregate_t *ap, unsigned char *slot) {
+  relation_stats_t *sp = ap->stats;
+  db_int *values = aggregate_slotvalues(slot);
+  unsigned char *isnull = aggregate_slotflags(ap, slot) + 1;
+  db_eetnode_t *np, *cursor;
+  db_eetnode_attr_t *attrp;
+  db_eet_t *eetp;
+  db_uint8 type;
+  db_int i, j, numattrs = 0;
+
+  /* There is no tuple to evaluate anything outside of an aggregate on. */
+  for (i = 0; i <= (db_int)(ap->num_expr); ++i) {
+    eetp = i < (db_int)(ap->num_expr) ? &(ap->exprs[i]) : ap->having_expr;
+    if (NULL != eetp)
+      numattrs += aggregate_countattrs(eetp);
+  }
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i)
+    numattrs -= aggregate_countattrs(&(ap->aggr_args[i]));
+  if (0 != numattrs)
+    return 0;
+
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < (db_int)(ap->num_aggr); ++i) {
+      /* Only a lone constant or attribute is answered. */
+      np = ap->aggr_args[i].nodes;
+      cursor = np;
+      advanceeetnodepointer(&cursor, 1);
+      if (POINTERBYTEDIST(cursor, np) != ap->aggr_args[i].size)
+        return 0;
+
+      type = ap->aggrs[i]->aggr_type;
+      if ((db_uint8)DB_AGGR_COUNTROWS == type) {
+        if ((db_uint8)DB_EETNODE_CONST_DBINT > np->type ||
+            (db_uint8)DB_EETNODE_CONST_DBSTRING < np->type)
+          return 0;
+        if (1 == j)
+          values[i] = sp->num_tuples;
+      } else if ((db_uint8)DB_AGGR_MIN == type ||
+                 (db_uint8)DB_AGGR_MAX == type) {
+        attrp = (db_eetnode_attr_t *)np;
+        if ((db_uint8)DB_EETNODE_ATTR != np->type || 0 != attrp->tuple_pos ||
+            attrp->pos >= sp->num_attr ||
+            (db_uint8)DB_RELSTATS_UNKNOWN == sp->bounds[attrp->pos])
+          return 0;
+        /* With no values at all, the aggregate stays NULL. */
+        if (1 == j && (db_uint8)DB_RELSTATS_BOUNDED == sp->bounds[attrp->pos]) {
+          values[i] = (db_uint8)DB_AGGR_MIN == type ? sp->min[attrp->pos]
+                                                    : sp->max[attrp->pos];
+          isnull[i] = 0;
+        }
+      } else {
+        return 0;
+      }
+    }
+  }
+  return 1;
+}
+
+/* Aggregate every tuple of the child into the one group, unless the
+   statistics of the child's relation answer the aggregates. */
+static db_int aggregate_startsimple(aggregate_t *ap, db_query_mm_t *mmp) {
+  relation_header_t *hp = ap->child->header;
+  db_int capacity, result = 0, i;
+  db_uint8 first = 1;
+  db_tuplebatch_t batch;
+  db_tuple_t t;
+
+  /* From here on, closing frees the memory taken. */
+  ap->state = DB_AGGREGATE_STATE_BUILT;
+  if (aggregate_capacity(ap, mmp) < 1)
+    return -1;
+  ap->slots = db_qmm_balloc(mmp, (size_t)aggregate_slotsize(ap));
+  if (NULL == ap->slots)
+    return -1;
+  ap->num_slots = 1;
+  aggregate_newgroup(ap, ap->slots, 0, NULL);
+
+  if (NULL != ap->stats && 1 == aggregate_fromstats(ap, ap->slots))
+    return 1;
+
+  /* The arguments are compiled before the batch takes its memory.  The batch
+     is kept small, since the child may still want memory of its own. */
+  for (i = 0; NULL != ap->progs && i < (db_int)(ap->num_aggr); ++i)
+    compile_eet(&(ap->progs[i]), &(ap->aggr_args[i]), &(ap->child->header),
+                mmp);
+  capacity = aggregate_available(ap, mmp) /
+             (aggregate_isnullsize(hp) + (db_int)(hp->tuple_size));
+  if (capacity > DB_AGGREGATE_BATCHSIZE)
+    capacity = DB_AGGREGATE_BATCHSIZE;
+  if (capacity < 1 || 1 != init_tuplebatch(&batch, capacity, hp->tuple_size,
+                                           hp->num_attr, mmp))
+    return -1;
+
+  while (1 == (result = next_batch(ap->child, &batch, mmp))) {
+    for (i = 0; i < batch.count; ++i) {
+      viewbatchtuple(&batch, i, &t);
+      /* Expressions outside of the aggregates see the first tuple. */
+      if (first) {
+        aggregate_newgroup(ap, ap->slots, 0, &t);
+        first = 0;
+      }
+      if (1 != aggregate_accumulate(ap, ap->slots, &t, mmp)) {
+        result = -1;
+        break;
+      }
+    }
+    if (-1 == result)
+      break;
+  }
+  close_tuplebatch(&batch, mmp);
+  return -1 == result ? -1 : 1;
+}
+
+/* Return the one group of an aggregate operator with no GROUP BY clause. */
+static db_int aggregate_nextsimple(aggregate_t *ap, db_tuple_t *next_tp,
+                                   db_query_mm_t *mmp) {
+  if (DB_AGGREGATE_STATE_UNBUILT == ap->state &&
+      1 != aggregate_startsimple(ap, mmp))
+    return -1;
+  if (DB_AGGREGATE_STATE_BUILT != ap->state)
+    return 0;
+
+  ap->state = DB_AGGREGATE_STATE_DONE;
+  return aggregate_writegroup(ap, ap->slots, next_tp, mmp);
+}
+
+/* Set up the aggregate operator for the hash, streaming or simple mode. */
+static db_int aggregate_setup(aggregate_t *ap, db_op_base_t *child,
+                              db_eet_t *exprs, db_uint8 num_expr,
+                              db_eet_t *groupby_exprs,
+                              db_uint8 num_groupby_expr, db_eet_t *having_expr,
+                              db_uint8 mode, db_query_mm_t *mmp) {
+  db_eet_t *eetp;
+  db_int i, j;
+
+  ap->base.type = DB_AGGREGATE;
+  ap->base.header = NULL;
+  ap->mode = mode;
+  ap->child = child;
+  ap->previous_tp = NULL;
+  ap->next_count = 0;
+  ap->exprs = exprs;
+  ap->aggr_locs = NULL;
+  ap->num_expr = num_expr;
+  ap->groupby_exprs = groupby_exprs;
+  ap->num_groupby_expr = num_groupby_expr;
+  ap->having_expr = having_expr;
+  ap->tuples_seen = 0;
+  ap->aggrs = NULL;
+  ap->aggr_args = NULL;
+  ap->num_aggr = 0;
+  ap->groupby_types = NULL;
+  ap->slots = NULL;
+  ap->parts = NULL;
+  ap->num_slots = 0;
+  ap->num_groups = 0;
+  ap->position = 0;
+  ap->file = 0;
+  ap->num_files = 0;
+  ap->hashid = db_aggregate_nextid++;
+  ap->state = DB_AGGREGATE_STATE_UNBUILT;
+  ap->progs = NULL;
+  ap->stats = NULL;
+
+  /* Count the aggregates of the projecting expressions and the HAVING
+     clause, then find them. */
+  for (j = 0; j < 2; ++j) {
+    if (1 == j && ap->num_aggr > 0) {
+      ap->aggrs = DB_QMM_BALLOC(mmp, ((size_t)(ap->num_aggr)) *
+                                         sizeof(db_eetnode_aggr_temp_t *));
+      ap->aggr_args =
+          DB_QMM_BALLOC(mmp, ((size_t)(ap->num_aggr)) * sizeof(db_eet_t));
+      if (NULL == ap->aggrs || NULL == ap->aggr_args)
+        return -1;
+      ap->num_aggr = 0;
+    } else if (1 == j) {
+      break;
+    }
+
+    for (i = 0; i <= (db_int)num_expr; ++i) {
+      eetp = i < (db_int)num_expr ? &(exprs[i]) : having_expr;
+      if (NULL == eetp)
+        continue;
+      if (NULL == eetp->nodes || 1 != aggregate_findaggrs(ap, eetp, mmp))
+        return -1;
+    }
+  }
+
+  for (i = 0; i < (db_int)(ap->num_aggr); ++i)
+    if (1 != aggregate_checkaggr(ap, i, mmp))
+      return -1;
+
+  if (DB_AGGREGATE_MODE_SIMPLE == mode && ap->num_aggr > 0) {
+    ap->progs =
+        DB_QMM_BALLOC(mmp, ((size_t)(ap->num_aggr)) * sizeof(db_eetprog_t));
+    if (NULL == ap->progs)
+      return -1;
+    for (i = 0; i < (db_int)(ap->num_aggr); ++i)
+      init_eetprog(&(ap->progs[i]));
+  }
+
+  if (num_groupby_expr > 0) {
+    ap->groupby_types = DB_QMM_BALLOC(mmp, (size_t)num_groupby_expr);
+    if (NULL == ap->groupby_types)
+      return -1;
+  }
+  for (i = 0; i < (db_int)num_groupby_expr; ++i) {
+    ap->groupby_types[i] = (db_uint8)evaluate_eet(
+        &(groupby_exprs[i]), NULL, NULL, &(child->header), 0, mmp);
+    if ((db_uint8)DB_EETNODE_CONST_DBINT != ap->groupby_types[i] &&
+        (db_uint8)DB_EETNODE_CONST_DBSTRING != ap->groupby_types[i] &&
+        (db_uint8)DB_EETNODE_CONST_NULL != ap->groupby_types[i])
+      return -1;
+  }
+
+  ap->base.header = DB_QMM_BALLOC(mmp, sizeof(relation_header_t));
+  if (NULL == ap->base.header)
+    return -1;
+  return createnewheader(ap->base.header, child->header, exprs, num_expr, mmp);
+}
+
+/* Initialize the aggregate operator in the hash mode. */
+db_int init_hashaggregate(aggregate_t *ap, db_op_base_t *child,
+                          db_eet_t *exprs, db_uint8 num_expr,
+                          db_eet_t *groupby_exprs, db_uint8 num_groupby_expr,
+                          db_eet_t *having_expr, db_query_mm_t *mmp) {
+  return aggregate_setup(ap, child, exprs, num_expr, groupby_exprs,
+                         num_groupby_expr, having_expr,
+                         DB_AGGREGATE_MODE_HASH, mmp);
+}
+
+/* Initialize the aggregate operator in the streaming mode. */
+db_int init_streamaggregate(aggregate_t *ap, db_op_base_t *child,
+                            db_eet_t *exprs, db_uint8 num_expr,
+                            db_eet_t *groupby_exprs, db_uint8 num_groupby_expr,
+                            db_eet_t *having_expr, db_query_mm_t *mmp) {
+  return aggregate_setup(ap, child, exprs, num_expr, groupby_exprs,
+                         num_groupby_expr, having_expr,
+                         DB_AGGREGATE_MODE_STREAM, mmp);
+}
+
+/* Initialize the aggregate operator for a query with no GROUP BY clause. */
+db_int init_simpleaggregate(aggregate_t *ap, db_op_base_t *child,
+                            db_eet_t *exprs, db_uint8 num_expr,
+                            db_eet_t *having_expr, relation_stats_t *statsp,
+                            db_query_mm_t *mmp) {
+  db_int result = aggregate_setup(ap, child, exprs, num_expr, NULL, 0,
+                                  having_expr, DB_AGGREGATE_MODE_SIMPLE, mmp);
+  ap->stats = statsp;
+  return result;
+}
+
 /* Rewind the aggregate operator. */
 db_int rewind_aggregate(aggregate_t *ap, db_query_mm_t *mmp) {
+  /* The one group is kept until the operator is closed. */
+  if (DB_AGGREGATE_MODE_SIMPLE == ap->mode) {
+    if (DB_AGGREGATE_STATE_UNBUILT != ap->state)
+      ap->state = DB_AGGREGATE_STATE_BUILT;
+    return 1;
+  }
+  if (DB_AGGREGATE_MODE_RESCAN != ap->mode) {
+    /* If every group fit in memory, they are all still there. */
+    if (DB_AGGREGATE_MODE_HASH == ap->mode &&
+        DB_AGGREGATE_STATE_BUILT == ap->state && 0 == ap->num_files) {
+      ap->position = 0;
+      return 1;
+    }
+    aggregate_freebuffers(ap, mmp);
+    return rewind_dbop(ap->child, mmp);
+  }
+
   switch (rewind_dbop(ap->child, mmp)) {
   case 1:
     if (ap->previous_tp != NULL) {
@@ -162,14 +1206,7 @@ db_int aggr_prepare_expressions(aggregate_t *ap, db_eet_t *exprs,
       }
       /* If there isn't an aggregate in this expression... */
       else if (NULL == aggr_locs[i]) {
-        db_uint8 node_type = exprs[i].nodes->type;
-        if ((node_type == DB_EETNODE_ATTR &&
-             gettypebypos(ap->child->header,
-                          ((db_eetnode_attr_t *)(exprs[i].nodes))->pos) ==
-                 DB_INT) ||
-            node_type == DB_EETNODE_CONST_DBINT ||
-            (node_type >= DB_EETNODE_OP_NOT &&
-             node_type <= DB_EETNODE_FUNC_LENGTH_DBSTRING)) {
+        if (DB_INT == gettypebypos(ap->base.header, i)) {
           db_int result;
           switch (evaluate_eet(&(exprs[i]), &result, &src_tp,
                                &(ap->child->header), 0, mmp)) {
@@ -189,12 +1226,7 @@ db_int aggr_prepare_expressions(aggregate_t *ap, db_eet_t *exprs,
             // TODO: Might need to do more things here to prevent memory
             // leaks?!?
           }
-        } else if ((node_type == DB_EETNODE_ATTR &&
-                    gettypebypos(
-                        ap->child->header,
-                        ((db_eetnode_attr_t *)(exprs[i].nodes))->pos) ==
-                        DB_STRING) ||
-                   node_type == DB_EETNODE_CONST_DBSTRING) {
+        } else if (DB_STRING == gettypebypos(ap->base.header, i)) {
           char *result;
           db_int retval = evaluate_eet(&(exprs[i]), &result, &src_tp,
                                        &(ap->child->header), 0, mmp);
@@ -263,7 +1295,8 @@ db_int aggr_prepare_expressions(aggregate_t *ap, db_eet_t *exprs,
         aggr_np->aggr_isnull = 1;
         /* Do not need to check if aggr_type >= 0 since always positive. */
         if (aggr_np->aggr_type <= DB_AGGR_LAST) {
-          if ((db_uint8)DB_EETNODE_CONST_DBINT == aggr_np->subexpr_type) {
+          if ((db_uint8)DB_EETNODE_CONST_DBINT == aggr_np->subexpr_type ||
+              (db_uint8)DB_AGGR_COUNTROWS == aggr_np->aggr_type) {
             aggr_np->value_p = DB_QMM_BALLOC(mmp, sizeof(db_int));
             *((db_int *)(aggr_np->value_p)) = 0;
 
@@ -293,6 +1326,12 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
     return -1;
   if (tp->bytes == NULL)
     return -1;
+  if (DB_AGGREGATE_MODE_HASH == ap->mode)
+    return aggregate_nexthash(ap, tp, mmp);
+  else if (DB_AGGREGATE_MODE_STREAM == ap->mode)
+    return aggregate_nextstream(ap, tp, mmp);
+  else if (DB_AGGREGATE_MODE_SIMPLE == ap->mode)
+    return aggregate_nextsimple(ap, tp, mmp);
 
   db_int i;
   db_uint8 orderings[(db_int)(ap->num_groupby_expr)];
@@ -404,11 +1443,13 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
                             ap->groupby_exprs, ap->num_groupby_expr, orderings,
                             1, mmp)))) {
       /* For each attribute... */
+      db_int which = 0;
       for (i = 0; i < ap->num_expr; i++) {
         if (ap->aggr_locs[i] != NULL) {
           db_int j = 0;
           for (; ap->aggr_locs[i][j] > -1; ++j) {
             void *temp_p = NULL;
+            char *string_p = NULL;
 
             /* Get the type of the expression just after the aggregate, malloc
              * appropriately. */
@@ -419,15 +1460,16 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
               temp_p = DB_QMM_BALLOC(mmp, sizeof(db_int));
             } else if ((db_uint8)DB_EETNODE_CONST_DBSTRING ==
                        aggr_np->subexpr_type) {
-              /* Do nothing, we will just use pointer instead. */
+              /* Just point at the string instead. */
+              temp_p = &string_p;
             }
 
-            // printf("starting eet evaluation from: %d\n",
-            // (db_int)(ap->aggr_locs[i][j])+1);
+            /* The aggregate's argument, found when the operator was
+               initialized. */
             db_tuple_t *src_tp = &src_t;
-            db_int retval = evaluate_eet(
-                &(ap->exprs[i]), temp_p, &src_tp, &(ap->child->header),
-                (db_uint8)(ap->aggr_locs[i][j] + 1), mmp);
+            db_int retval =
+                evaluate_eet(&(ap->aggr_args[which++]), temp_p, &src_tp,
+                             &(ap->child->header), 0, mmp);
 
             if (-1 == retval) {
               db_int k, l;
@@ -550,7 +1592,7 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
             }
 
             /* Free the temporary variable, if necessary. */
-            if (temp_p != NULL) {
+            if (temp_p != NULL && temp_p != (void *)&string_p) {
               DB_QMM_BFREE(mmp, temp_p);
               temp_p = NULL;
             }
@@ -625,103 +1667,40 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /* For each expresion... */
     for (i = 0; i < ap->num_expr; ++i) {
+      /* Expressions without aggregates have already been handled. */
       if (ap->aggr_locs[i] != NULL) {
-        db_uint8 node_type = geteetnodetypebypos(&(ap->exprs[i]), 0);
-        if ((db_uint8)(DB_EETNODE_AGGR_TEMP) != node_type) {
-          if (node_type == DB_EETNODE_CONST_DBINT ||
-              node_type == DB_EETNODE_CONST_DBSTRING ||
-              node_type ==
-                  DB_EETNODE_ATTR) /* TODO: Implement future types here. */
-          {
-            /* Error out.  We have constructed a clause that does not make
-             * sense. */
-            db_int k, l;
-            for (k = 0; k < i; ++k) {
-              for (l = 0; ap->aggr_locs[k] != NULL && ap->aggr_locs[k][l] > -1;
-                   ++l) {
-                DB_QMM_BFREE(
-                    mmp, ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                              &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                             ->value_p);
-                ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                     &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                    ->value_p = NULL;
-              }
-            }
-            close_tuple(&src_t, mmp);
-            return -1;
-          } else if (node_type >= DB_EETNODE_OP_NOT &&
-                     (node_type <= DB_EETNODE_FUNC_LENGTH_DBSTRING)) {
-            db_int result, retval;
-            db_tuple_t *src_tp = &src_t;
-            retval = evaluate_eet(&(ap->exprs[i]), &result, &src_tp,
-                                  &(ap->child->header), 0, mmp);
-            if (-1 == retval) {
-              db_int k, l;
-              for (k = 0; k < i; ++k) {
-                for (l = 0;
-                     ap->aggr_locs[k] != NULL && ap->aggr_locs[k][l] > -1;
-                     ++l) {
-                  DB_QMM_BFREE(
-                      mmp, ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                                &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                               ->value_p);
-                  ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                       &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                      ->value_p = NULL;
-                }
-              }
-              close_tuple(&src_t, mmp);
-              return -1;
-            } else if (2 == retval) {
-              /* Set this tuples attribute null bit to 1. */
-              // puts("result: NULL");
-              tp->isnull[i / 8] |= (1 << (i % 8));
-            } else {
-              tp->isnull[i / 8] &= ~(1 << (i % 8));
-              // printf("result: %d\n", result);
-              *((db_int *)(&(tp->bytes[ap->base.header->offsets[i]]))) = result;
-            }
-          }
-        } else if (ap->aggr_locs[i] != NULL &&
-                   (db_uint8)(DB_EETNODE_AGGR_TEMP) == node_type) {
-          db_eetnode_aggr_temp_t *aggr_np = (db_eetnode_aggr_temp_t *)((
-              db_eetnode_aggr_temp_t *)geteetnodebypos(&(ap->exprs[i]),
-                                                       (db_int)0));
-          if (aggr_np->aggr_type <= DB_AGGR_LAST) {
-            db_int result, retval;
-            db_tuple_t *src_tp = &src_t;
-            retval = evaluate_eet(&(ap->exprs[i]), &result, &src_tp,
-                                  &(ap->child->header), 0, mmp);
-            if (-1 == retval) {
-              db_int k, l;
-              for (k = 0; k < i; ++k) {
-                for (l = 0;
-                     ap->aggr_locs[k] != NULL && ap->aggr_locs[k][l] > -1;
-                     ++l) {
-                  DB_QMM_BFREE(
-                      mmp, ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                                &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                               ->value_p);
-                  ((db_eetnode_aggr_temp_t *)geteetnodebypos(
-                       &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
-                      ->value_p = NULL;
-                }
-              }
-              close_tuple(&src_t, mmp);
-              return -1;
-            } else if (2 == retval) {
-              /* Set this tuples attribute null bit to 1. */
-              // puts("result: NULL");
-              tp->isnull[i / 8] |= (1 << (i % 8));
-            } else {
-              tp->isnull[i / 8] &= ~(1 << (i % 8));
-              // printf("result: %d\n", result);
-              *((db_int *)(&(tp->bytes[ap->base.header->offsets[i]]))) = result;
+        db_int result, retval;
+        db_tuple_t *src_tp = &src_t;
+        /* In postfix order, each aggregate's argument is evaluated before
+           the aggregate replaces it with the value computed above. */
+        if (DB_INT != gettypebypos(ap->base.header, i))
+          retval = -1;
+        else
+          retval = evaluate_eet(&(ap->exprs[i]), &result, &src_tp,
+                                &(ap->child->header), 0, mmp);
+        if (-1 == retval) {
+          db_int k, l;
+          for (k = 0; k < i; ++k) {
+            for (l = 0; ap->aggr_locs[k] != NULL && ap->aggr_locs[k][l] > -1;
+                 ++l) {
+              DB_QMM_BFREE(
+                  mmp, ((db_eetnode_aggr_temp_t *)geteetnodebypos(
+                            &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
+                           ->value_p);
+              ((db_eetnode_aggr_temp_t *)geteetnodebypos(
+                   &(ap->exprs[k]), (db_int)(ap->aggr_locs[k][l])))
+                  ->value_p = NULL;
             }
           }
+          close_tuple(&src_t, mmp);
+          return -1;
+        } else if (2 == retval) {
+          /* Set this tuples attribute null bit to 1. */
+          tp->isnull[i / 8] |= (1 << (i % 8));
+        } else {
+          tp->isnull[i / 8] &= ~(1 << (i % 8));
+          *((db_int *)(&(tp->bytes[ap->base.header->offsets[i]]))) = result;
         }
-        /* Otherwise, do nothing. These attributes have already been handled. */
       }
     }
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -790,23 +1769,39 @@ db_int next_aggregate(aggregate_t *ap, db_tuple_t *tp, db_query_mm_t *mmp) {
 
 /* Close the aggregate operator. */
 db_int close_aggregate(aggregate_t *ap, db_query_mm_t *mmp) {
-  /* Free memory used by previous tuple, if it was initialized. */
-  if (ap->previous_tp != NULL) {
-    close_tuple(ap->previous_tp, mmp);
-    DB_QMM_BFREE(mmp, ap->previous_tp);
-  }
-  db_int i;
-  for (i = 0; i < (db_int)(ap->num_expr); ++i) {
-    if (ap->aggr_locs[i] != NULL)
-      DB_QMM_BFREE(mmp, ap->aggr_locs[i]);
+  if (DB_AGGREGATE_MODE_RESCAN != ap->mode) {
+    aggregate_freebuffers(ap, mmp);
+  } else {
+    /* Free memory used by previous tuple, if it was initialized. */
+    if (ap->previous_tp != NULL) {
+      close_tuple(ap->previous_tp, mmp);
+      DB_QMM_BFREE(mmp, ap->previous_tp);
+    }
+    db_int i;
+    for (i = 0; i < (db_int)(ap->num_expr); ++i) {
+      if (ap->aggr_locs[i] != NULL)
+        DB_QMM_BFREE(mmp, ap->aggr_locs[i]);
+    }
+    DB_QMM_BFREE(mmp, ap->aggr_locs);
   }
-  DB_QMM_BFREE(mmp, ap->aggr_locs);
   DB_QMM_BFREE(mmp, ap->base.header->size_name);
   DB_QMM_BFREE(mmp, ap->base.header->names);
   DB_QMM_BFREE(mmp, ap->base.header->types);
   DB_QMM_BFREE(mmp, ap->base.header->offsets);
   DB_QMM_BFREE(mmp, ap->base.header->sizes);
   DB_QMM_BFREE(mmp, ap->base.header);
+  if (DB_AGGREGATE_MODE_RESCAN != ap->mode) {
+    if (NULL != ap->stats)
+      freerelationstats(ap->stats, mmp);
+    if (NULL != ap->progs)
+      DB_QMM_BFREE(mmp, ap->progs);
+    if (NULL != ap->groupby_types)
+      DB_QMM_BFREE(mmp, ap->groupby_types);
+  }
+  if (NULL != ap->aggr_args)
+    DB_QMM_BFREE(mmp, ap->aggr_args);
+  if (NULL != ap->aggrs)
+    DB_QMM_BFREE(mmp, ap->aggrs);
   return 1;
 }
 
@@ -72,6 +72,89 @@ db_int init_aggregate(aggregate_t *ap,
 		db_eet_t *having_expr,
 		db_query_mm_t *mmp);
 
+/* Initialize the aggregate operator in the hash mode. */
+/**
+@brief		Initialize an aggregate operator that groups its child's tuples
+		in a hash table, reading the child once.
+@details	The aggregate function nodes of @p exprs and @p having_expr are
+		in postfix order, after their argument, as the parser emits
+		them.  Only COUNT, SUM, MIN, MAX, FIRST, LAST and the bitwise
+		aggregates are supported, and only COUNT over anything other
+		than integers.  The memory for the table is only taken on the
+		first call to @ref next, from whatever is free at that point.
+		Groups are returned in no particular order.
+@param		ap			A pointer to the aggregate operator to
+					initialize.
+@param		child			A pointer to the child operator.
+@param		exprs			The projecting expressions.
+@param		num_expr		The number of elements in @p exprs.
+@param		groupby_exprs		An array of expressions that determine
+					how the tuples are grouped, each an
+					integer or a string.
+@param		num_groupby_expr	The number of elements in
+					@p groupby_exprs.
+@param		having_expr		The bytecode expression generated
+					from the HAVING clause, or @c NULL.
+@param		mmp			The per-query memory manager being used
+					to allocate memory for this query.
+@returns	@c 1 if the operator was initialized, @c -1 if an error occured
+		or an expression is not supported.
+*/
+db_int init_hashaggregate(aggregate_t *ap,
+		db_op_base_t *child,
+		db_eet_t *exprs,
+		db_uint8 num_expr,
+		db_eet_t *groupby_exprs,
+		db_uint8 num_groupby_expr,
+		db_eet_t *having_expr,
+		db_query_mm_t *mmp);
+
+/* Initialize the aggregate operator in the streaming mode. */
+/**
+@brief		Initialize an aggregate operator over a child that returns the
+		tuples of each group one after another, such as one ordered on
+		the grouping expressions.
+@details	The child is read once, keeping only the group being
+		aggregated.  Groups are returned in the order the child returns
+		them.  The expressions are as for @ref init_hashaggregate.
+@see		For more information, reference @ref init_hashaggregate.
+*/
+db_int init_streamaggregate(aggregate_t *ap,
+		db_op_base_t *child,
+		db_eet_t *exprs,
+		db_uint8 num_expr,
+		db_eet_t *groupby_exprs,
+		db_uint8 num_groupby_expr,
+		db_eet_t *having_expr,
+		db_query_mm_t *mmp);
+
+/* Initialize the aggregate operator for a query with no GROUP BY clause. */
+/**
+@brief		Initialize an aggregate operator that puts every tuple of its
+		child in one group, returning exactly one tuple.
+@details	The arguments of the aggregates are compiled and evaluated
+		over batches of the child's tuples.  If the child has no
+		tuples, every aggregate other than COUNT is @c NULL.  The
+		expressions are as for @ref init_hashaggregate.
+
+		If @p statsp is not @c NULL, it must hold the statistics of the
+		relation the child scans in full.  COUNT of a constant, and MIN
+		and MAX of an attribute whose bounds are known, are then
+		answered from them without reading the child at all, so long as
+		no attribute is used outside of an aggregate.  The operator
+		frees the statistics when it is closed.
+@param		statsp			A pointer to the statistics of the
+					child's relation, or @c NULL.
+@see		For the other parameters, reference @ref init_hashaggregate.
+*/
+db_int init_simpleaggregate(aggregate_t *ap,
+		db_op_base_t *child,
+		db_eet_t *exprs,
+		db_uint8 num_expr,
+		db_eet_t *having_expr,
+		relation_stats_t *statsp,
+		db_query_mm_t *mmp);
+
 /* Rewind the aggregate operator. */
 /**
 @brief		Rewind the aggregate operator.
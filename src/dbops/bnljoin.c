@@ -0,0 +1,285 @@
+/******************************************************************************/
+/**
+@file		bnljoin.c
+@author		Graeme Douglas
+@brief		Implementation of the block nested-loop join operator.
+@see		For more information, reference @ref bnljoin.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "bnljoin.h"
+#include "../db_ctconf.h"
+#include "../dblogic/eet.h"
+#include "../dbmacros.h"
+#include "db_ops.h"
+#include <string.h>
+
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int bnljoin_isnullsize(relation_header_t *hp) {
+  db_int size = ((db_int)(hp->num_attr)) / 8;
+  if (((db_int)(hp->num_attr)) % 8 > 0)
+    size++;
+  return size;
+}
+
+/* Number of bytes in a tuple record, nullity information included. */
+static db_int bnljoin_recordsize(relation_header_t *hp) {
+  return bnljoin_isnullsize(hp) + (db_int)(hp->tuple_size);
+}
+
+/* Point a tuple at a record so it can be read or written in place. */
+static void bnljoin_viewrecord(relation_header_t *hp, db_tuple_t *tp,
+                               unsigned char *record) {
+  tp->isnull = (char *)record;
+  tp->bytes = (char *)(record + bnljoin_isnullsize(hp));
+  tp->offset_r = 0;
+}
+
+/* Number of left tuple records that fit in the query memory right now. */
+static db_int bnljoin_capacity(bnljoin_t *jp, db_query_mm_t *mmp) {
+  db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+  if (NULL != jp->tree)
+    reserve += jp->tree->stack_size;
+  reserve += (db_int)sizeof(db_int);
+
+  db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+  if (avail < reserve)
+    return 0;
+  return (avail - reserve) / bnljoin_recordsize(jp->lchild->header);
+}
+
+/* Fill the block with the next left tuples, then start the right child over
+   for them.  Returns 1 if any were loaded, 0 if the left child had none left,
+   -1 on error. */
+static db_int bnljoin_loadblock(bnljoin_t *jp, db_query_mm_t *mmp) {
+  relation_header_t *hp = jp->lchild->header;
+  db_int recsize = bnljoin_recordsize(hp);
+  db_int result = 1;
+  db_uint8 first = 0;
+  db_tuplebatch_t batch;
+
+  /* Memory is only taken once the children have taken theirs.  The join
+     condition is compiled before the block takes what is left. */
+  if (NULL == jp->records) {
+    first = 1;
+    if (NULL != jp->tree && NULL != jp->tree->nodes && 0 == jp->prog.length) {
+      relation_header_t *hpa[2];
+      hpa[0] = jp->lchild->header;
+      hpa[1] = jp->rchild->header;
+      compile_eet(&(jp->prog), jp->tree, hpa, mmp);
+    }
+    jp->capacity = bnljoin_capacity(jp, mmp);
+    if (jp->capacity < 1)
+      return -1;
+    jp->records = db_qmm_balloc(mmp, (size_t)(jp->capacity * recsize));
+    if (NULL == jp->records)
+      return -1;
+  }
+
+  /* The block's records are laid out as a batch's are, so the rest of the
+     block is filled as a batch. */
+  batch.isnullsize = bnljoin_isnullsize(hp);
+  batch.recordsize = recsize;
+  batch.rows = NULL;
+  jp->num_records = 0;
+  while (jp->num_records < jp->capacity) {
+    batch.records = jp->records + jp->num_records * recsize;
+    batch.capacity = jp->capacity - jp->num_records;
+    result = next_batch(jp->lchild, &batch, mmp);
+    if (1 != result)
+      break;
+    jp->num_records += batch.count;
+  }
+  if (-1 == result)
+    return -1;
+  jp->ldone = 0 == result;
+
+  /* The whole left input fit in the first block.  Give back the memory the
+     block didn't use, if we can. */
+  if (first && jp->ldone && jp->num_records < jp->capacity &&
+      POINTERATNBYTES(jp->records, -1 * ((db_int)sizeof(db_int)), void *) ==
+          mmp->last_back) {
+    memmove(jp->records + (jp->capacity - jp->num_records) * recsize,
+            jp->records, (size_t)(jp->num_records * recsize));
+    jp->records = db_qmm_bextend(
+        mmp, -1 * (jp->capacity - jp->num_records) * recsize);
+    jp->capacity = jp->num_records;
+  }
+
+  if (0 == jp->num_records)
+    return 0;
+
+  rewind_dbop(jp->rchild, mmp);
+  result = next(jp->rchild, &(jp->rt), mmp);
+  if (-1 == result)
+    return -1;
+  jp->rvalid = 1 == result;
+  jp->match = 0;
+  return 1;
+}
+
+/* Write out the joined tuple of a left and a right tuple. */
+static void bnljoin_combine(bnljoin_t *jp, db_tuple_t *next_tp, db_tuple_t *lt,
+                            db_tuple_t *rt) {
+  copytuplebytes(next_tp, lt, 0, 0, jp->lchild->header->tuple_size);
+  copytupleisnull(next_tp, lt, 0, 0, bnljoin_isnullsize(jp->lchild->header));
+
+  /* Write out right tuples bytes directly after left tuples bytes. */
+  copytuplebytes(next_tp, rt, jp->lchild->header->tuple_size, 0,
+                 jp->rchild->header->tuple_size);
+
+  /* Write out right tuples isnull into new tuple. */
+  db_int i;
+  db_int j = (db_int)(jp->lchild->header->num_attr);
+  for (i = 0; i < (db_int)(jp->rchild->header->num_attr); ++i) {
+    /* If this bit is 0 ... */
+    if (0 == (rt->isnull[i / 8] & (1 << (i % 8)))) {
+      next_tp->isnull[j / 8] &= ~(1 << (j % 8));
+    } else {
+      next_tp->isnull[j / 8] |= (1 << (j % 8));
+    }
+    j++;
+  }
+}
+
+/* Initialize the operator. */
+db_int init_bnljoin(bnljoin_t *jp, db_eet_t *ep, db_op_base_t *lchild,
+                    db_op_base_t *rchild, db_query_mm_t *mmp) {
+  init_ntjoin((ntjoin_t *)jp, ep, lchild, rchild, mmp);
+  return setup_bnljoin(jp, mmp);
+}
+
+/* Setup a block nested-loop join from a nested tuple join. */
+db_int setup_bnljoin(bnljoin_t *jp, db_query_mm_t *mmp) {
+  /* Left tuples are read straight into the block, so the nested-tuple join's
+     left tuple is replaced by one for the right child. */
+  close_tuple(&(jp->rt), mmp);
+  init_tuple(&(jp->rt), jp->rchild->header->tuple_size,
+             jp->rchild->header->num_attr, mmp);
+  rewind_dbop(jp->lchild, mmp);
+
+  jp->rvalid = 0;
+  jp->records = NULL;
+  jp->capacity = 0;
+  jp->num_records = 0;
+  jp->match = 0;
+  jp->ldone = 0;
+  init_eetprog(&(jp->prog));
+  jp->base.type = DB_BNLJOIN;
+  return 1;
+}
+
+/* Re-start the operator from the beginning. This assumes the operator has
+ * been initialized. */
+db_int rewind_bnljoin(bnljoin_t *jp, db_query_mm_t *mmp) {
+  rewind_dbop(jp->lchild, mmp);
+  rewind_dbop(jp->rchild, mmp);
+
+  /* The block's memory is kept for reuse. */
+  jp->rvalid = 0;
+  jp->num_records = 0;
+  jp->match = 0;
+  jp->ldone = 0;
+  return 1;
+}
+
+/* Find next tuple that passes the join condition.
+   -This assumes that the evaluation tree will always reduce to either 0 or 1
+    for all tuples.
+   -The algorithm used is the following:
+                while there are tuples left in lchild
+                        fill block with as many tuples of lchild as fit
+                        for each tuple rt in rchild
+                                for each tuple lt in block
+                                        if rt joins lt
+                                                return joined tuple
+                        rewind rchild
+*/
+db_int next_bnljoin(bnljoin_t *jp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  /* Create necessary result variable. */
+  db_int result = 0, retval;
+  relation_header_t *lhp = jp->lchild->header;
+  db_int recsize = bnljoin_recordsize(lhp);
+  db_tuple_t lt;
+
+  /* Build arrays to be passed to eet evaluation engine. */
+  relation_header_t *hpa[2];
+  hpa[0] = jp->lchild->header;
+  hpa[1] = jp->rchild->header;
+  db_tuple_t *tpa[2];
+  tpa[0] = &lt;
+  tpa[1] = &(jp->rt);
+
+  while (1) {
+    while (1 == jp->rvalid) {
+      while (jp->match < jp->num_records) {
+        bnljoin_viewrecord(lhp, &lt, jp->records + jp->match * recsize);
+        jp->match++;
+
+        /* Evaluate join condition eet on this tuple, if it
+           exists.  If its NULL, all tuples pass (cross prod). */
+        if (jp->tree != NULL && jp->tree->nodes != NULL) {
+          retval = evaluate_eet_compiled(&(jp->prog), jp->tree, &result, tpa,
+                                         hpa, mmp);
+        } else {
+          retval = 1;
+          result = 1;
+        }
+
+        if (1 == result && 1 == retval) {
+          bnljoin_combine(jp, next_tp, &lt, &(jp->rt));
+          return 1;
+        }
+      }
+
+      retval = next(jp->rchild, &(jp->rt), mmp);
+      if (-1 == retval)
+        return -1;
+      jp->rvalid = 1 == retval;
+      jp->match = 0;
+    }
+
+    /* The right child is done with this block. */
+    if (jp->ldone)
+      return 0;
+    retval = bnljoin_loadblock(jp, mmp);
+    if (1 != retval)
+      return retval;
+  }
+}
+
+/* Close the operator. */
+db_int close_bnljoin(bnljoin_t *jp, db_query_mm_t *mmp) {
+  if (NULL != jp->records)
+    db_qmm_bfree(mmp, jp->records);
+  jp->records = NULL;
+  close_eetprog(&(jp->prog), mmp);
+
+  close_tuple(&(jp->rt), mmp);
+
+  /* Free all header properties that were allocated */
+  DB_QMM_BFREE(mmp, jp->base.header->size_name);
+  DB_QMM_BFREE(mmp, jp->base.header->names);
+  DB_QMM_BFREE(mmp, jp->base.header->types);
+  DB_QMM_BFREE(mmp, jp->base.header->offsets);
+  DB_QMM_BFREE(mmp, jp->base.header->sizes);
+
+  /* Free the header itself. */
+  DB_QMM_BFREE(mmp, jp->base.header);
+
+  return 1;
+}
@@ -9,6 +9,7 @@ notes.
 
 #include "db_ops.h"
 #include "../db_ctconf.h"
+#include "../dbindex/dbindex.h"
 
 db_int8 findindexon(scan_t *sp, db_eetnode_attr_t *attrp) {
   db_int8 i = 0;
@@ -31,6 +32,127 @@ db_int8 findindexon(scan_t *sp, db_eetnode_attr_t *attrp) {
   return -1;
 }
 
+/* Estimate how many tuples an operator will produce. */
+db_int estimatenumtuples(db_op_base_t *op) {
+  if (DB_SCAN == op->type) {
+    scan_t *sp = (scan_t *)op;
+    db_int recordsize = ((db_int)(op->header->num_attr)) / 8;
+    if (((db_int)(op->header->num_attr)) % 8 > 0)
+      recordsize++;
+    recordsize += (db_int)(op->header->tuple_size);
+
+    long size = db_filesize(sp->relation);
+    if (size < 0)
+      return -1;
+    if (size <= sp->tuple_start)
+      return 0;
+    return (db_int)((size - sp->tuple_start) / recordsize);
+  } else if (1 == numopchildren(op)) {
+    return estimatenumtuples(((db_op_onechild_t *)op)->child);
+  } else if (2 == numopchildren(op)) {
+    db_int lcount = estimatenumtuples(((ntjoin_t *)op)->lchild);
+    db_int rcount = estimatenumtuples(((ntjoin_t *)op)->rchild);
+    if (lcount < 0 || rcount < 0)
+      return -1;
+    if (0 == lcount || 0 == rcount)
+      return 0;
+    if (lcount > DB_INT_MAX / rcount)
+      return DB_INT_MAX;
+    return lcount * rcount;
+  } else {
+    return -1;
+  }
+}
+
+/* Check if an operator produces its tuples in order of an attribute. */
+db_uint8 isorderedon(db_op_base_t *op, db_uint8 pos) {
+  if (DB_SCAN == op->type) {
+    scan_t *sp = (scan_t *)op;
+    db_eetnode_attr_t attr;
+    db_index_t index;
+    db_uint8 ordered;
+    attr.pos = pos;
+
+    /* Inline indexes keep the relation itself sorted. */
+    db_int8 whichindex = findindexon(sp, &attr);
+    if (-1 == whichindex ||
+        1 != init_index(&index, sp->idx_meta_data.names[whichindex]))
+      return 0;
+    ordered = DB_INDEX_TYPE_INLINE == index.type;
+    close_index(&index);
+    return ordered;
+  } else if (DB_SELECT == op->type) {
+    return isorderedon(((select_t *)op)->child, pos);
+  } else if (DB_SORT == op->type) {
+    sort_t *sp = (sort_t *)op;
+    return sp->num_expr > 0 && DB_TUPLE_ORDER_ASC == sp->order[0] &&
+           sizeof(db_eetnode_attr_t) == sp->sort_exprs[0].size &&
+           DB_EETNODE_ATTR == sp->sort_exprs[0].nodes->type &&
+           pos == ((db_eetnode_attr_t *)(sp->sort_exprs[0].nodes))->pos;
+  } else if (DB_TOPN == op->type) {
+    topn_t *tp = (topn_t *)op;
+    if (0 == tp->num_expr)
+      return isorderedon(tp->child, pos);
+    return DB_TUPLE_ORDER_ASC == tp->order[0] &&
+           sizeof(db_eetnode_attr_t) == tp->sort_exprs[0].size &&
+           DB_EETNODE_ATTR == tp->sort_exprs[0].nodes->type &&
+           pos == ((db_eetnode_attr_t *)(tp->sort_exprs[0].nodes))->pos;
+  } else {
+    return 0;
+  }
+}
+
+/* The position of the attribute an expression is, or -1 if it is not a lone
+   attribute. */
+static db_int attrexprpos(db_eet_t *eetp) {
+  if (NULL == eetp->nodes || sizeof(db_eetnode_attr_t) != eetp->size ||
+      DB_EETNODE_ATTR != eetp->nodes->type)
+    return -1;
+  return (db_int)(((db_eetnode_attr_t *)(eetp->nodes))->pos);
+}
+
+/* Check if an operator produces the tuples of each group together. */
+db_uint8 isgroupedon(db_op_base_t *op, db_eet_t *exprs, db_uint8 num_expr) {
+  db_eet_t *sort_exprs;
+  db_uint8 num_sort_expr;
+  db_int i, j;
+
+  for (i = 0; i < (db_int)num_expr; ++i)
+    if (-1 == attrexprpos(&(exprs[i])))
+      return 0;
+
+  if (DB_SELECT == op->type) {
+    return isgroupedon(((select_t *)op)->child, exprs, num_expr);
+  } else if (DB_TOPN == op->type) {
+    /* A group may be cut off by the limit. */
+    return 0;
+  } else if (DB_SORT == op->type) {
+    sort_exprs = ((sort_t *)op)->sort_exprs;
+    num_sort_expr = ((sort_t *)op)->num_expr;
+    if (num_sort_expr < num_expr)
+      return 0;
+
+    /* The first attributes sorted on must be the grouping attributes. */
+    for (i = 0; i < (db_int)num_expr; ++i) {
+      for (j = 0; j < (db_int)num_expr; ++j)
+        if (attrexprpos(&(sort_exprs[i])) == attrexprpos(&(exprs[j])))
+          break;
+      if (j == (db_int)num_expr)
+        return 0;
+      for (j = 0; j < (db_int)num_expr; ++j)
+        if (attrexprpos(&(exprs[i])) == attrexprpos(&(sort_exprs[j])))
+          break;
+      if (j == (db_int)num_expr)
+        return 0;
+    }
+    return 1;
+  } else if (1 == num_expr) {
+    return isorderedon(op, (db_uint8)attrexprpos(&(exprs[0])));
+  } else {
+    return 0;
+  }
+}
+
 /* A generic next method that can be called on any operator. */
 db_int next(db_op_base_t *op, db_tuple_t *next_tp, db_query_mm_t *mmp) {
   if (op->type == DB_SCAN) {
@@ -43,8 +165,16 @@ db_int next(db_op_base_t *op, db_tuple_t *next_tp, db_query_mm_t *mmp) {
     return next_ntjoin((ntjoin_t *)op, next_tp, mmp);
   } else if (op->type == DB_OSIJOIN) {
     return next_osijoin((osijoin_t *)op, next_tp, mmp);
+  } else if (op->type == DB_HASHJOIN) {
+    return next_hashjoin((hashjoin_t *)op, next_tp, mmp);
+  } else if (op->type == DB_SMJOIN) {
+    return next_smjoin((smjoin_t *)op, next_tp, mmp);
+  } else if (op->type == DB_BNLJOIN) {
+    return next_bnljoin((bnljoin_t *)op, next_tp, mmp);
   } else if (op->type == DB_SORT) {
     return next_sort((sort_t *)op, next_tp, mmp);
+  } else if (op->type == DB_TOPN) {
+    return next_topn((topn_t *)op, next_tp, mmp);
   }
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
@@ -57,6 +187,59 @@ db_int next(db_op_base_t *op, db_tuple_t *next_tp, db_query_mm_t *mmp) {
     return -1;
 }
 
+/* A generic method for getting a batch of tuples from any operator. */
+db_int next_batch(db_op_base_t *op, db_tuplebatch_t *bp, db_query_mm_t *mmp) {
+  if (op->type == DB_SCAN) {
+    return next_batch_scan((scan_t *)op, bp, mmp);
+  } else if (op->type == DB_PROJECT) {
+    return next_batch_project((project_t *)op, bp, mmp);
+  } else if (op->type == DB_SELECT) {
+    return next_batch_select((select_t *)op, bp, mmp);
+  } else {
+    return fillbatch(op, bp, mmp);
+  }
+}
+
+/* Fill a batch with tuples from an operator, one at a time. */
+db_int fillbatch(db_op_base_t *op, db_tuplebatch_t *bp, db_query_mm_t *mmp) {
+  db_tuple_t t;
+  db_int result = 0;
+
+  bp->count = 0;
+  while (bp->count < bp->capacity) {
+    viewbatchtuple(bp, bp->count, &t);
+    result = next(op, &t, mmp);
+    if (1 != result)
+      break;
+    if (NULL != bp->rows)
+      bp->rows[bp->count] = t.offset_r;
+    bp->count++;
+  }
+
+  if (-1 == result)
+    return -1;
+  return bp->count > 0 ? 1 : result;
+}
+
+/* Initialize a batch for an operator's tuples, sized to free memory. */
+db_int init_opbatch(db_op_base_t *op, db_tuplebatch_t *bp,
+                    db_query_mm_t *mmp) {
+  relation_header_t *hp = op->header;
+  db_int capacity = DB_CTCONF_SETTING_BATCH_SIZE;
+  db_int recordsize =
+      ((db_int)(hp->num_attr) + 7) / 8 + (db_int)(hp->tuple_size);
+
+  if (NULL != mmp && recordsize > 0) {
+    db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front) -
+                   DB_CTCONF_SETTING_OPERATOR_RESERVE;
+    if (avail / (8 * recordsize) < capacity)
+      capacity = avail / (8 * recordsize);
+  }
+  if (capacity < 1)
+    capacity = 1;
+  return init_tuplebatch(bp, capacity, hp->tuple_size, hp->num_attr, mmp);
+}
+
 /* A generic rewind method. */
 db_int rewind_dbop(db_op_base_t *op, db_query_mm_t *mmp) {
   if (op->type == DB_SCAN) {
@@ -69,8 +252,16 @@ db_int rewind_dbop(db_op_base_t *op, db_query_mm_t *mmp) {
     return rewind_ntjoin((ntjoin_t *)op, mmp);
   } else if (op->type == DB_OSIJOIN) {
     return rewind_osijoin((osijoin_t *)op, mmp);
+  } else if (op->type == DB_HASHJOIN) {
+    return rewind_hashjoin((hashjoin_t *)op, mmp);
+  } else if (op->type == DB_SMJOIN) {
+    return rewind_smjoin((smjoin_t *)op, mmp);
+  } else if (op->type == DB_BNLJOIN) {
+    return rewind_bnljoin((bnljoin_t *)op, mmp);
   } else if (op->type == DB_SORT) {
     return rewind_sort((sort_t *)op, mmp);
+  } else if (op->type == DB_TOPN) {
+    return rewind_topn((topn_t *)op, mmp);
   }
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
@@ -96,8 +287,16 @@ void close(db_op_base_t *op, db_query_mm_t *mmp) {
     close_ntjoin((ntjoin_t *)op, mmp);
   } else if (op->type == DB_OSIJOIN) {
     close_osijoin((osijoin_t *)op, mmp);
+  } else if (op->type == DB_HASHJOIN) {
+    close_hashjoin((hashjoin_t *)op, mmp);
+  } else if (op->type == DB_SMJOIN) {
+    close_smjoin((smjoin_t *)op, mmp);
+  } else if (op->type == DB_BNLJOIN) {
+    close_bnljoin((bnljoin_t *)op, mmp);
   } else if (op->type == DB_SORT) {
     close_sort((sort_t *)op, mmp);
+  } else if (op->type == DB_TOPN) {
+    close_topn((topn_t *)op, mmp);
   }
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
@@ -113,20 +312,84 @@ db_int numopchildren(db_op_base_t *op) {
   if (op->type == DB_SCAN) {
     return 0;
   } else if (DB_PROJECT == op->type || DB_SELECT == op->type ||
-             DB_SORT == op->type || DB_AGGREGATE == op->type) {
+             DB_SORT == op->type || DB_TOPN == op->type ||
+             DB_AGGREGATE == op->type) {
     return 1;
-  } else if (DB_NTJOIN == op->type || DB_OSIJOIN == op->type) {
+  } else if (DB_NTJOIN == op->type || DB_OSIJOIN == op->type ||
+             DB_HASHJOIN == op->type || DB_SMJOIN == op->type ||
+             DB_BNLJOIN == op->type) {
     return 2;
   } else {
     return -1;
   }
 }
 
+/* Compile the expressions of an entire execution tree. */
+void compileexecutiontree(db_op_base_t *op, db_query_mm_t *mmp) {
+  db_int i;
+
+  if (NULL == op)
+    return;
+
+  /* Parents compile before their children, so the children's programs are
+     on top of the back stack when the tree is closed. */
+  if (DB_SELECT == op->type) {
+    select_t *sp = (select_t *)op;
+    if (NULL != sp->tree && NULL != sp->tree->nodes && 0 == sp->prog.length)
+      compile_eet(&(sp->prog), sp->tree, &(sp->base.header), mmp);
+  } else if (DB_PROJECT == op->type) {
+    project_t *pp = (project_t *)op;
+    for (i = 0; NULL != pp->progs && i < (db_int)(pp->num_exprs); ++i)
+      if (NULL != pp->exprs[i].nodes && 0 == pp->progs[i].length)
+        compile_eet(&(pp->progs[i]), &(pp->exprs[i]), &(pp->child->header),
+                    mmp);
+  } else if (DB_BNLJOIN == op->type) {
+    bnljoin_t *jp = (bnljoin_t *)op;
+    relation_header_t *hpa[2];
+    hpa[0] = jp->lchild->header;
+    hpa[1] = jp->rchild->header;
+    if (NULL != jp->tree && NULL != jp->tree->nodes && 0 == jp->prog.length)
+      compile_eet(&(jp->prog), jp->tree, hpa, mmp);
+  }
+
+  if (2 == numopchildren(op)) {
+    compileexecutiontree(((ntjoin_t *)op)->lchild, mmp);
+    compileexecutiontree(((ntjoin_t *)op)->rchild, mmp);
+  } else if (1 == numopchildren(op)) {
+    compileexecutiontree(((db_op_onechild_t *)op)->child, mmp);
+  }
+}
+
+/* Set up the batches of an entire execution tree. */
+db_int initexecutionbatches(db_op_base_t *op, db_query_mm_t *mmp) {
+  if (NULL == op)
+    return 1;
+
+  if (DB_SELECT == op->type) {
+    if (1 != init_batch_select((select_t *)op, mmp))
+      return -1;
+  } else if (DB_PROJECT == op->type) {
+    if (1 != init_batch_project((project_t *)op, mmp))
+      return -1;
+  }
+
+  if (2 == numopchildren(op))
+    return 1 == initexecutionbatches(((ntjoin_t *)op)->lchild, mmp) &&
+                   1 == initexecutionbatches(((ntjoin_t *)op)->rchild, mmp)
+               ? 1
+               : -1;
+  else if (1 == numopchildren(op))
+    return initexecutionbatches(((db_op_onechild_t *)op)->child, mmp);
+  return 1;
+}
+
 /* Close an entire execution tree recursively. */
 db_int closeexecutiontree(db_op_base_t *op, db_query_mm_t *mmp) {
   if (NULL == op) {
     return 1;
-  } else if (DB_NTJOIN == op->type || DB_OSIJOIN == op->type) {
+  } else if (DB_NTJOIN == op->type || DB_OSIJOIN == op->type ||
+             DB_HASHJOIN == op->type || DB_SMJOIN == op->type ||
+             DB_BNLJOIN == op->type) {
     switch (closeexecutiontree(((ntjoin_t *)op)->lchild, mmp)) {
     case 1:
       break;
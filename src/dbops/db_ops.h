@@ -43,7 +43,11 @@ extern "C" {
 #include "select.h"
 #include "ntjoin.h"
 #include "osijoin.h"
+#include "hashjoin.h"
+#include "smjoin.h"
+#include "bnljoin.h"
 #include "sort.h"
+#include "topn.h"
 #include "aggregate.h"
 
 /**
@@ -54,6 +58,51 @@ extern "C" {
 */
 db_int8 findindexon(scan_t *sp, db_eetnode_attr_t *attrp);
 
+/* Estimate how many tuples an operator will produce. */
+/**
+@brief		Estimate the number of tuples an operator will produce.
+@details	Scans are estimated from the size of their relation's file.
+		Operators with one child are assumed to pass every tuple
+		through and joins are assumed to produce the cross product of
+		their children, so this is only ever an upper bound useful for
+		comparing the sizes of inputs.
+@param		op		Pointer to the operator.
+@returns	The estimated number of tuples, or @c -1 if an error occurs.
+*/
+db_int estimatenumtuples(db_op_base_t *op);
+
+/* Check if an operator produces its tuples in order of an attribute. */
+/**
+@brief		Check if an operator is known to produce its tuples in
+		ascending order of one of its attributes.
+@details	Scans are ordered by an inline index on the attribute,
+		selections keep the order of their child, and sorts and top-N
+		operators are ordered by their first expression if it is a lone
+		attribute sorted in ascending order.  Tuples that are @c NULL on the attribute come
+		first, as in @ref cmp_tuple.
+@param		op		Pointer to the operator.
+@param		pos		The position of the attribute in the
+				operator's tuples.
+@returns	@c 1 if the order is known, @c 0 otherwise.
+*/
+db_uint8 isorderedon(db_op_base_t *op, db_uint8 pos);
+
+/* Check if an operator produces the tuples of each group together. */
+/**
+@brief		Check if an operator is known to produce tuples that are equal
+		on some expressions one after another.
+@details	Only lone attributes are recognized.  Sorts group the tuples on
+		their first expressions, in either order, selections keep the
+		grouping of their child, and a single attribute is grouped
+		wherever it is ordered, by @ref isorderedon.  A top-N operator
+		never is, since it may return only part of a group.
+@param		op		Pointer to the operator.
+@param		exprs		The expressions the tuples are grouped on.
+@param		num_expr	The number of elements in @p exprs.
+@returns	@c 1 if the grouping is known, @c 0 otherwise.
+*/
+db_uint8 isgroupedon(db_op_base_t *op, db_eet_t *exprs, db_uint8 num_expr);
+
 /*
 A generic next method that can be called on any operator.
 	-It is assumed that next always returns 1 on success,
@@ -71,6 +120,49 @@ A generic next method that can be called on any operator.
 */
 db_int next(db_op_base_t *op, db_tuple_t *next_tp, db_query_mm_t *mmp);
 
+/* A generic method for getting a batch of tuples from any operator. */
+/**
+@brief		Get the next tuples from the operator, as many as fit in a
+		batch.
+@details	The batch's tuples are replaced.  Scans, selections and
+		projections produce whole batches at a time.  Every other
+		operator's tuples are gathered one at a time by
+		@ref fillbatch.  A batch may come back less than full even when
+		there are more tuples to come.
+@param		op		Pointer to the operator.
+@param		bp		Pointer to the initialized batch to place the
+				results in.  It must be for tuples of the
+				operator's relation.
+@param		mmp		A pointer to the memory manager pointer
+				that will allocate memory for the operator.
+@returns	@c 0 if no more tuples to return, @c -1 if an error occurs,
+		@c 1 if at least one tuple was placed in the batch.
+*/
+db_int next_batch(db_op_base_t *op, db_tuplebatch_t *bp, db_query_mm_t *mmp);
+
+/**
+@brief		Fill a batch by calling @ref next on an operator until it is
+		full or the operator has no more tuples.
+@see		Reference @ref next_batch for the arguments and return values.
+*/
+db_int fillbatch(db_op_base_t *op, db_tuplebatch_t *bp, db_query_mm_t *mmp);
+
+/**
+@brief		Initialize a batch for an operator's tuples.
+@details	The batch holds at most @ref DB_CTCONF_SETTING_BATCH_SIZE
+		tuples, and takes no more than an eighth of the free query
+		memory, so that operators sizing their buffers from free memory
+		are left most of it.  It always holds at least one tuple.
+@param		op		Pointer to the operator whose tuples the
+				batch is for.
+@param		bp		Pointer to the batch to initialize.
+@param		mmp		A pointer to the memory manager that will
+				allocate memory for the batch.
+@returns	@c 1 if the batch was initialized, @c -1 otherwise.
+*/
+db_int init_opbatch(db_op_base_t *op, db_tuplebatch_t *bp,
+                    db_query_mm_t *mmp);
+
 /* A generic rewind method. */
 /**
 @brief		Allow the operator to be re-used.  Rewind is recursive.
@@ -101,6 +193,37 @@ void close(db_op_base_t *op, db_query_mm_t *mmp);
 */
 db_int numopchildren(db_op_base_t *op);
 
+/* Compile the expressions of an entire execution tree. */
+/**
+@brief		Compile every expression in an execution tree that is
+		evaluated once per tuple.
+@details	This must only be called once the tree will no longer change,
+		and before any tuples are fetched from it.  Expressions that
+		cannot be compiled are simply interpreted.
+@param		op		Pointer to the root operator in the execution
+				tree.
+@param		mmp		A pointer to the memory manager that will
+				allocate memory for the programs.
+*/
+void compileexecutiontree(db_op_base_t *op, db_query_mm_t *mmp);
+
+/* Set up the batches of an entire execution tree. */
+/**
+@brief		Set up the batches that the selections and projections of an
+		execution tree keep their children's tuples in.
+@details	Like @ref compileexecutiontree, this must be called once the
+		tree will no longer change and before any tuples are fetched
+		from it, so that the batches lie beneath any memory the
+		operators take while running.  Batches that are not set up
+		here are set up when the first tuple is asked for.
+@param		op		Pointer to the root operator in the execution
+				tree.
+@param		mmp		A pointer to the memory manager that will
+				allocate memory for the batches.
+@returns	@c 1 if every batch was set up, @c -1 otherwise.
+*/
+db_int initexecutionbatches(db_op_base_t *op, db_query_mm_t *mmp);
+
 /* Close an entire execution tree recursively. */
 /**
 @brief		Close the entire execution tree.
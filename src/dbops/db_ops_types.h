@@ -61,7 +61,12 @@ typedef enum {
   DB_SELECT,    /**< Relational selection operator. */
   DB_NTJOIN,    /**< Relational inner join operator. */
   DB_OSIJOIN,   /**< Relational inner join operator. */
+  DB_HASHJOIN,  /**< Relational inner equi-join operator. */
+  DB_SMJOIN,    /**< Relational inner sort-merge join operator. */
+  DB_BNLJOIN,   /**< Relational inner block nested-loop join operator. */
   DB_SORT,      /**< Relaitonal sort operator. */
+  DB_TOPN,      /**< Relational sort operator returning only the first
+                     few tuples. */
   DB_AGGREGATE, /**< Relational aggregate operator. */
   DB_OP_COUNT   /**< Number of enumerated values/types. */
 } db_op_type;
@@ -110,10 +115,25 @@ typedef struct {
   db_int fname_start; /**< First character in relation name.*/
   db_int fname_end;   /**< First character following relation name. */
   long tuple_start;   /**< Offset of first tuple record. */
+  long tuple_end;     /**< Offset past the last tuple record to read, or
+                           -1 to read to the end of the relation. */
+  long first_record;  /**< Offset of the relation's first tuple record,
+                           even if the scan starts further on. */
   db_index_meta_t idx_meta_data; /**< File containing metadata for index. */
   db_fileref_t relation;         /**< File pointer to relation file. */
-  db_int8 indexon;               /**< Which index attribute index scan from. */
-  db_int stopat;                 /**< Value to stop scanning at. */
+  db_index_cursor_t cursor;      /**< The index being followed, if the
+                                      scan was pointed at a range of an
+                                      index's entries. */
+  db_uint8 indexonly;            /**< 1 if the index being followed
+                                      holds every attribute the query
+                                      needs, so tuples are made from its
+                                      entries, 0 otherwise. */
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  unsigned char *map; /**< The relation file mapped into memory, or
+                           @c NULL if it is read from storage. */
+  long map_size;      /**< Number of bytes mapped. */
+#endif
+  long position;      /**< Offset of the next tuple record to read. */
   /*@}*/
 } scan_t;
 
@@ -141,6 +161,13 @@ typedef struct {
                             members memory.
                        */
   db_uint8 num_exprs;
+  db_tuplebatch_t batch; /**< The child's tuples that are being
+                              projected. */
+  db_int position;       /**< The next tuple of @c batch to be
+                              returned by @ref next_project. */
+  db_eetprog_t *progs;   /**< The compiled form of each of
+                              @c exprs, or @c NULL if there was no
+                              memory for them. */
   /*@}*/
 } project_t;
 
@@ -161,7 +188,13 @@ typedef struct {
                             expression tree that describes
                             the predicate to match tuples on.
                        */
-                       /*@}*/
+  db_eetprog_t prog;   /**< The compiled form of @c tree. */
+  db_tuplebatch_t batch; /**< The tuples that passed, waiting to be
+                              returned by @ref next_select. */
+  db_int position;       /**< The next tuple of @c batch to be
+                              returned. */
+  db_uint8 *selected;    /**< Which tuples of @c batch pass. */
+                         /*@}*/
 } select_t;
 
 /* Join struct. */
@@ -224,6 +257,232 @@ typedef struct {
                         /*@}*/
 } osijoin_t;
 
+/**
+@struct		hashjoin_t
+@brief		The relational (hash) equi-join operator.
+@details	A join for conditions that equate an attribute of the left
+                relation with an attribute of the right relation.  The
+                smaller of the two inputs, by estimate, is the build side: on
+                the first call to next its tuples are loaded into the free
+                space of the query memory manager and hashed on their join
+                attribute.  Tuples from the other input, the probe side, are
+                then hashed the same way and only compared against the build
+                tuples in the same bucket.  The whole join condition is still
+                checked for each such pair, so any other conjuncts are
+                honoured.
+
+                If the build side does not fit in memory, both inputs are
+                first split by hash value into partitions written to
+                temporary files, Grace-style, and each pair of partitions is
+                joined in turn.  A build partition that still does not fit is
+                joined a piece at a time, rescanning its probe partition for
+                each piece.
+
+                The first members of this struct are laid out exactly as those
+                of @ref ntjoin_t, so a nested-tuple join can be converted into
+                a hash join in place.
+*/
+typedef struct {
+  /*@{*/
+  db_op_base_t base;      /**< The supertype of this struct. */
+  db_eet_t *tree;         /**< The condition that must be met
+                               in order for the tuples to join.
+                          */
+  db_eet_t *uexpr;        /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_uint8 indexon;       /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_op_base_t *lchild;   /**< This operator's left child in the
+                               query execution tree. */
+  db_op_base_t *rchild;   /**< This operator's right child in the
+                               query execution tree. */
+  db_tuple_t pt;          /**< The currently considered tuple of
+                               the probe child. */
+  db_uint8 pvalid;        /**< A flag that signals if @c pt holds
+                               a tuple that may still have matches.
+                          */
+  unsigned char *records; /**< Build tuple records, hashed into
+                               buckets.  FOR INTERNAL USE ONLY. */
+  db_int *buckets;        /**< Index of the first record in each
+                               bucket, or @c -1.  FOR INTERNAL USE
+                               ONLY. */
+  db_int *chain;          /**< Index of the next record in the
+                               same bucket as each record, or
+                               @c -1.  FOR INTERNAL USE ONLY. */
+  db_fileref_t *parts;    /**< Temporary partition files, or
+                               @c NULL if the build side fit in
+                               memory.  FOR INTERNAL USE ONLY. */
+  db_int num_buckets;     /**< The number of elements of
+                               buckets. */
+  db_int capacity;        /**< The most build tuple records that
+                               fit in memory at once. */
+  db_int num_records;     /**< The number of build tuple records
+                               currently in memory. */
+  db_int match;           /**< Index of the next record to
+                               compare against @c pt, or @c -1.
+                               FOR INTERNAL USE ONLY. */
+  db_uint8 lkey;          /**< Position of the join attribute in
+                               the left child's tuples. */
+  db_uint8 rkey;          /**< Position of the join attribute in
+                               the right child's tuples. */
+  db_uint8 keytype;       /**< The type of the join attribute. */
+  db_uint8 buildright;    /**< @c 1 if the right child is the
+                               build side, @c 0 if the left is. */
+  db_uint8 num_parts;     /**< The number of partitions each input
+                               was split into, or @c 0. */
+  db_uint8 part;          /**< The partition currently being
+                               joined.  FOR INTERNAL USE ONLY. */
+  db_uint8 hashid;        /**< Identifier used to name this
+                               operator's temporary files. */
+  db_uint8 state;         /**< Whether the build side has been
+                               loaded, and how.  FOR INTERNAL USE
+                               ONLY. */
+                          /*@}*/
+} hashjoin_t;
+
+/**
+@struct		smjoin_t
+@brief		The relational (sort-merge) join operator.
+@details	A join for conditions that bound an attribute of one input,
+                the window side, between expressions over an attribute of
+                the other input, the driving side.  Equi-joins
+                (@c a.x @c = @c b.y) and band joins
+                (@c a.x @c >= @c b.y @c - @c 5 @c AND @c a.x @c <= @c b.y
+                @c + @c 5) are both of this form.  Both inputs must come
+                out in ascending order of their join attribute, either
+                because they are read through an index or because they pass
+                through a sort operator.
+
+                The inputs are merged in a single pass.  For each driving
+                tuple the operator holds, in key order, the window of tuples
+                from the other input that fall between its bounds.  Since
+                both inputs are ordered, the window only ever slides
+                forward: tuples below the lower bound are dropped from its
+                front and tuples up to the upper bound are read onto its
+                back.  Duplicate keys on either side simply leave the window
+                in place for several driving tuples.  The window is held in
+                the free space of the query memory manager and spills onto
+                a temporary file if it outgrows it.  The whole join
+                condition is still checked for each pair considered.
+
+                The first members of this struct are laid out exactly as those
+                of @ref ntjoin_t, so a nested-tuple join can be converted into
+                a sort-merge join in place.
+*/
+typedef struct {
+  /*@{*/
+  db_op_base_t base;      /**< The supertype of this struct. */
+  db_eet_t *tree;         /**< The condition that must be met
+                               in order for the tuples to join.
+                          */
+  db_eet_t *uexpr;        /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_uint8 indexon;       /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_op_base_t *lchild;   /**< This operator's left child in the
+                               query execution tree. */
+  db_op_base_t *rchild;   /**< This operator's right child in the
+                               query execution tree. */
+  db_tuple_t dt;          /**< The currently considered tuple of
+                               the driving child. */
+  db_uint8 dvalid;        /**< A flag that signals if @c dt holds
+                               a tuple that may still have matches.
+                          */
+  db_tuple_t wt;          /**< The next tuple of the window child,
+                               read but not yet in the window. */
+  db_eet_t *keyexpr;      /**< The join attribute of the window
+                               child. */
+  db_eet_t *lowexpr;      /**< Lower bound on @c keyexpr, over the
+                               driving child's tuples. */
+  db_eet_t *highexpr;     /**< Upper bound on @c keyexpr, over the
+                               driving child's tuples. */
+  unsigned char *records; /**< The in-memory front of the window,
+                               followed by one spare record.  FOR
+                               INTERNAL USE ONLY. */
+  db_fileref_t spill;     /**< Temporary file holding the back of
+                               the window, once it no longer fits in
+                               memory.  FOR INTERNAL USE ONLY. */
+  db_int capacity;        /**< The most window tuple records that
+                               fit in memory at once. */
+  db_int head;            /**< Index of the first in-memory record
+                               still in the window. */
+  db_int num_records;     /**< The number of records in memory,
+                               dropped ones included. */
+  db_int spill_head;      /**< Index of the first record in the
+                               spill file still in the window. */
+  db_int spill_count;     /**< The number of records in the spill
+                               file. */
+  db_int match;           /**< Position in the window of the next
+                               record to compare against @c dt.  FOR
+                               INTERNAL USE ONLY. */
+  db_uint8 dkey;          /**< Position of the join attribute in
+                               the driving child's tuples. */
+  db_uint8 windowright;   /**< @c 1 if the right child is the window
+                               side, @c 0 if the left is. */
+  db_uint8 lowstrict;     /**< @c 1 if the window key must be
+                               strictly greater than @c lowexpr. */
+  db_uint8 highstrict;    /**< @c 1 if the window key must be
+                               strictly less than @c highexpr. */
+  db_uint8 wvalid;        /**< A flag that signals if @c wt holds
+                               a tuple. */
+  db_uint8 smid;          /**< Identifier used to name this
+                               operator's temporary file. */
+  db_uint8 state;         /**< Whether the merge has started.  FOR
+                               INTERNAL USE ONLY. */
+                          /*@}*/
+} smjoin_t;
+
+/**
+@struct		bnljoin_t
+@brief		The relational (block nested-loop) join operator.
+@details	A join for any condition, needing no index and no particular
+                order from its inputs.  Rather than rescanning the right
+                child once for every left tuple, as @ref ntjoin_t does, as
+                many left tuples as fit are loaded into the free space of
+                the query memory manager as a block.  The right child is
+                then scanned once per block, each of its tuples being
+                compared against every tuple in the block.  The right input
+                is thus read once for every block instead of once for every
+                left tuple.
+
+                The first members of this struct are laid out exactly as those
+                of @ref ntjoin_t, so a nested-tuple join can be converted into
+                a block nested-loop join in place.
+*/
+typedef struct {
+  /*@{*/
+  db_op_base_t base;      /**< The supertype of this struct. */
+  db_eet_t *tree;         /**< The condition that must be met
+                               in order for the tuples to join.
+                          */
+  db_eet_t *uexpr;        /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_uint8 indexon;       /**< Unused, kept for compatibility with
+                               @ref ntjoin_t. */
+  db_op_base_t *lchild;   /**< This operator's left child in the
+                               query execution tree. */
+  db_op_base_t *rchild;   /**< This operator's right child in the
+                               query execution tree. */
+  db_tuple_t rt;          /**< The currently considered tuple of
+                               the right child. */
+  db_uint8 rvalid;        /**< A flag that signals if @c rt holds
+                               a tuple that may still have matches.
+                          */
+  unsigned char *records; /**< The block of left tuple records.
+                               FOR INTERNAL USE ONLY. */
+  db_int capacity;        /**< The most left tuple records that
+                               fit in a block. */
+  db_int num_records;     /**< The number of records in the current
+                               block. */
+  db_int match;           /**< Index of the next record to compare
+                               against @c rt.  FOR INTERNAL USE ONLY.
+                          */
+  db_uint8 ldone;         /**< @c 1 if the current block holds the
+                               last of the left child's tuples. */
+  db_eetprog_t prog;      /**< The compiled form of @c tree. */
+                          /*@}*/
+} bnljoin_t;
+
 /* Sort struct. */
 /**
 @struct		sort_t
@@ -233,23 +492,47 @@ typedef struct {
                 this operator correlates to the "ORDER BY <ordering-list>"
                 clause, but it could be used in other places to speed up
                 other operators, such as joins and aggregates, in the future.
-@todo		This operator currently utilizes a selection sorting algorithm,
-                which is O(n^2).  Work should be done to try and improve this to
-                some O(nlogn) algorithm, although this could be challenging
-                given out limited RAM and write-time constraints.
+
+                The operator is an external merge sort.  The first call to
+                next pulls as many tuples from the child as fit in the free
+                space of the query memory manager, sorts them in place and,
+                if the child still has tuples left, writes them out as a
+                sorted run to a temporary file.  Runs are then merged as many
+                at a time as memory permits until few enough remain to be
+                merged on the fly while returning tuples.  If the entire
+                input fits in memory, no files are ever written.
 */
 typedef struct {
   /*@{*/
   db_op_base_t base;       /**< The supertype of this struct. */
   db_op_base_t *child;     /**< Pointer to this operator's child
                                 in the query exectuion tree. */
-  db_tuple_t *previous_tp; /**< Pointer to a copy of the previous
-                        tuple returned by this operator.
-                   */
-  db_int next_count;       /**< The number of duplicate tuples
-                                to return.  While this is greater
-                                than 0, the same tuple is returned.
-                           */
+  unsigned char *buffer;   /**< In-memory sorted tuple records, or
+                                the current head record of each
+                                run being merged.  FOR INTERNAL USE
+                                ONLY. */
+  db_fileref_t *runs;      /**< Open run file for each merge way.
+                                FOR INTERNAL USE ONLY. */
+  db_int *remaining;       /**< Number of tuple records left in each
+                                merge way.  FOR INTERNAL USE ONLY. */
+  db_int num_tuples;       /**< The number of tuples sorted. */
+  db_int position;         /**< Index of the next in-memory record to
+                                return.  FOR INTERNAL USE ONLY. */
+  db_int run_length;       /**< The number of tuple records in each
+                                run on disk, or @c 0 if the sorted
+                                tuples are all in memory. */
+  db_uint8 num_ways;       /**< The number of runs being merged
+                                while returning tuples. */
+  db_uint8 sortid;         /**< Identifier used to name this
+                                operator's temporary files. */
+  db_uint8 state;          /**< Whether the input has been
+                                sorted, and which temporary file holds
+                                the runs.  FOR INTERNAL USE ONLY. */
+  db_int keysize;          /**< The number of bytes of sort key
+                                at the front of each tuple record, or
+                                @c 0 if records are compared by
+                                evaluating the sort expressions.  FOR
+                                INTERNAL USE ONLY. */
   db_eet_t *sort_exprs;    /**< Array of expressions to sort the
                                 relation on.
                            */
@@ -267,6 +550,52 @@ typedef struct {
                            /*@}*/
 } sort_t;
 
+/* Top-N struct. */
+/**
+@struct		topn_t
+@brief		The relational top-N operator.
+@details	Returns only the first few tuples of its child, in the order
+                given by some set of keys.  In SQL terms, this operator
+                correlates to "ORDER BY <ordering-list> LIMIT <n>".
+
+                Rather than ordering its entire input as @ref sort_t does,
+                the first call to next makes a single pass over the child,
+                keeping the best tuples seen so far in a heap in the free
+                space of the query memory manager.  The root of the heap is
+                the worst tuple kept, so each new tuple either replaces it or
+                is dropped.  Only as many tuple records as the limit are ever
+                held, however large the input.  Once the child is exhausted,
+                the heap is sorted in place.
+
+                With no keys, the child's first tuples are returned as they
+                come, and nothing is held in memory.
+*/
+typedef struct {
+  /*@{*/
+  db_op_base_t base;       /**< The supertype of this struct. */
+  db_op_base_t *child;     /**< Pointer to this operator's child
+                                in the query exectuion tree. */
+  unsigned char *records;  /**< The heap of kept tuple records,
+                                followed by one spare record to read
+                                the child's tuples into.  FOR INTERNAL
+                                USE ONLY. */
+  db_int limit;            /**< The most tuples to return. */
+  db_int num_records;      /**< The number of records kept. */
+  db_int position;         /**< The number of tuples returned so
+                                far.  FOR INTERNAL USE ONLY. */
+  db_uint8 state;          /**< Whether the kept records have been
+                                sorted.  FOR INTERNAL USE ONLY. */
+  db_eet_t *sort_exprs;    /**< Array of expressions to order the
+                                relation on. */
+  db_uint8 num_expr;       /**< The number of elements of
+                                sort_exprs. */
+  db_uint8 *order;         /**< For each expression, either
+                                DB_TUPLE_ORDER_ASC or
+                                DB_TUPLE_ORDER_DESC, as for
+                                @ref sort_t. */
+                           /*@}*/
+} topn_t;
+
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
 /* Aggregation struct. */
@@ -276,6 +605,17 @@ typedef struct {
 @details	Aggregation applies some function over a set of values and
                 returns the result.  This correlates to the
                 "GROUP BY <group-list>" in an SQL query.
+
+                By default, each group is found by rescanning the child.  An
+                aggregate operator initialized with @ref init_hashaggregate
+                instead reads its child once, keeping a record for each group
+                in an open-addressing hash table in the free space of the
+                query memory manager.  When the table is full, tuples of groups
+                not in it are split by hash value into temporary files, and
+                each file is aggregated in turn once the groups in memory have
+                been returned.  One initialized with @ref init_streamaggregate
+                relies on its child returning each group's tuples together,
+                and keeps only the group being aggregated.
 */
 typedef struct {
   /*@{*/
@@ -313,6 +653,47 @@ typedef struct {
   db_int tuples_seen;        /**< The total number of tuples
                                   processed. This is needed for
                                   computing AVG, etc. */
+  db_eetnode_aggr_temp_t **aggrs; /**< The aggregate function nodes
+                                       of exprs and having_expr, in
+                                       the hash and streaming
+                                       modes. */
+  db_eet_t *aggr_args;       /**< The argument of each element of
+                                  aggrs, as an expression of its
+                                  own. */
+  db_uint8 num_aggr;         /**< The number of elements of aggrs
+                                  and aggr_args. */
+  db_uint8 *groupby_types;   /**< The type of each grouping
+                                  expression. */
+  db_tuple_t src_t;          /**< Holds the child's tuples.  FOR
+                                  INTERNAL USE ONLY. */
+  unsigned char *slots;      /**< The open-addressing table of group
+                                  records.  FOR INTERNAL USE
+                                  ONLY. */
+  db_fileref_t *parts;       /**< Temporary files being written to,
+                                  or @c NULL.  FOR INTERNAL USE
+                                  ONLY. */
+  db_int num_slots;          /**< The number of elements of slots. */
+  db_int num_groups;         /**< The number of groups in slots. */
+  db_int position;           /**< The next slot to return a group
+                                  from.  FOR INTERNAL USE ONLY. */
+  db_int file;               /**< The next temporary file to
+                                  aggregate.  FOR INTERNAL USE
+                                  ONLY. */
+  db_int num_files;          /**< The number of temporary files
+                                  created so far. */
+  db_uint8 hashid;           /**< Identifier used to name this
+                                  operator's temporary files. */
+  db_uint8 mode;             /**< How groups are found.  FOR
+                                  INTERNAL USE ONLY. */
+  db_uint8 state;            /**< Whether the groups have been
+                                  built, and how.  FOR INTERNAL USE
+                                  ONLY. */
+  db_eetprog_t *progs;       /**< The compiled form of each of
+                                  aggr_args, when there is no GROUP
+                                  BY clause. */
+  relation_stats_t *stats;   /**< Statistics of the child's
+                                  relation that may answer the
+                                  query, or @c NULL. */
                              /*@}*/
 } aggregate_t;
 #endif
@@ -0,0 +1,740 @@
+/******************************************************************************/
+/**
+@file		hashjoin.c
+@author		Graeme Douglas
+@brief		Implementation of the hash join operator.
+@see		For more information, reference @ref hashjoin.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "hashjoin.h"
+#include "../db_ctconf.h"
+#include "../dblogic/eet.h"
+#include "../dbmacros.h"
+#include "../dbstorage/dbstorage.h"
+#include "db_ops.h"
+#include <string.h>
+
+/* Hash join operator states. */
+#define DB_HASHJOIN_STATE_UNBUILT 0
+#define DB_HASHJOIN_STATE_INMEMORY 1
+#define DB_HASHJOIN_STATE_PARTITIONED 2
+
+/* Most partitions an input will be split into.  Each one is written through
+   its own open file.  Build partitions that are still too large to fit in
+   memory are joined a piece at a time, so this only limits speed. */
+#define DB_HASHJOIN_MAXPARTS 16
+
+/* Enough to hold "DB_HJ_<id>_<side><partition>". */
+#define DB_HASHJOIN_NAMELENGTH 16
+
+/* Used to give each hash join operator its own temporary files. */
+static db_uint8 db_hashjoin_nextid = 0;
+
+static db_op_base_t *hashjoin_buildchild(hashjoin_t *jp) {
+  return jp->buildright ? jp->rchild : jp->lchild;
+}
+
+static db_op_base_t *hashjoin_probechild(hashjoin_t *jp) {
+  return jp->buildright ? jp->lchild : jp->rchild;
+}
+
+static db_uint8 hashjoin_buildkey(hashjoin_t *jp) {
+  return jp->buildright ? jp->rkey : jp->lkey;
+}
+
+static db_uint8 hashjoin_probekey(hashjoin_t *jp) {
+  return jp->buildright ? jp->lkey : jp->rkey;
+}
+
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int hashjoin_isnullsize(relation_header_t *hp) {
+  db_int size = ((db_int)(hp->num_attr)) / 8;
+  if (((db_int)(hp->num_attr)) % 8 > 0)
+    size++;
+  return size;
+}
+
+/* Number of bytes in a tuple record, nullity information included. */
+static db_int hashjoin_recordsize(relation_header_t *hp) {
+  return hashjoin_isnullsize(hp) + (db_int)(hp->tuple_size);
+}
+
+/* Point a tuple at a record so it can be read or written in place. */
+static void hashjoin_viewrecord(relation_header_t *hp, db_tuple_t *tp,
+                                unsigned char *record) {
+  tp->isnull = (char *)record;
+  tp->bytes = (char *)(record + hashjoin_isnullsize(hp));
+  tp->offset_r = 0;
+}
+
+static db_uint8 hashjoin_keyisnull(db_tuple_t *tp, db_uint8 pos) {
+  return 0 != (tp->isnull[pos / 8] & (1 << (pos % 8)));
+}
+
+/* Hash the join attribute of a tuple.  Integers are hashed
+   multiplicatively, strings with FNV-1a. */
+static db_uint32 hashjoin_hash(hashjoin_t *jp, db_tuple_t *tp, db_uint8 pos,
+                               relation_header_t *hp) {
+  db_uint32 hash;
+  if (DB_INT == jp->keytype) {
+    hash = ((db_uint32)getintbypos(tp, pos, hp)) * 2654435761UL;
+  } else {
+    char *s = getstringbypos(tp, pos, hp);
+    db_int i;
+    hash = 2166136261UL;
+    for (i = 0; i < (db_int)(hp->sizes[pos]) && '\0' != s[i]; ++i) {
+      hash ^= (db_uint32)((unsigned char)s[i]);
+      hash *= 16777619UL;
+    }
+  }
+  return hash;
+}
+
+static db_uint8 hashjoin_keysequal(hashjoin_t *jp, db_tuple_t *bt,
+                                   db_tuple_t *pt) {
+  relation_header_t *bhp = hashjoin_buildchild(jp)->header;
+  relation_header_t *php = hashjoin_probechild(jp)->header;
+  if (DB_INT == jp->keytype)
+    return getintbypos(bt, hashjoin_buildkey(jp), bhp) ==
+           getintbypos(pt, hashjoin_probekey(jp), php);
+  else
+    return 0 == strcmp(getstringbypos(bt, hashjoin_buildkey(jp), bhp),
+                       getstringbypos(pt, hashjoin_probekey(jp), php));
+}
+
+/* Check if an equality between two nodes can be used to hash the join on. */
+static db_uint8 hashjoin_usablekey(hashjoin_t *jp, db_eetnode_t *a,
+                                   db_eetnode_t *b) {
+  if (NULL == a || NULL == b || DB_EETNODE_ATTR != a->type ||
+      DB_EETNODE_ATTR != b->type)
+    return 0;
+
+  db_eetnode_attr_t *lattrp = (db_eetnode_attr_t *)a;
+  db_eetnode_attr_t *rattrp = (db_eetnode_attr_t *)b;
+  if (1 == lattrp->tuple_pos && 0 == rattrp->tuple_pos) {
+    lattrp = (db_eetnode_attr_t *)b;
+    rattrp = (db_eetnode_attr_t *)a;
+  } else if (0 != lattrp->tuple_pos || 1 != rattrp->tuple_pos) {
+    return 0;
+  }
+
+  db_uint8 type = jp->lchild->header->types[lattrp->pos];
+  return type == jp->rchild->header->types[rattrp->pos] &&
+         (DB_INT == type || DB_STRING == type);
+}
+
+/* Find an equality between an attribute of each child that must hold for
+   the whole join condition to hold, that is, one joined to the rest of the
+   condition only by ANDs.  The expression is in postfix order, so its shape
+   is recovered with a stack holding, for each subexpression, the attribute
+   node if it is a lone attribute, a usable equality node if it is one or is
+   an AND over one, and NULL otherwise. */
+static db_eetnode_t *hashjoin_findkey(hashjoin_t *jp, db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = jp->tree->nodes;
+  db_eetnode_t **stack, *a, *b, *found = NULL;
+  db_int count = 0, top = 0, numvals;
+
+  while (POINTERBYTEDIST(cursor, jp->tree->nodes) < jp->tree->size) {
+    count++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  stack = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_eetnode_t *));
+  if (NULL == stack)
+    return NULL;
+
+  cursor = jp->tree->nodes;
+  while (POINTERBYTEDIST(cursor, jp->tree->nodes) < jp->tree->size) {
+    if ((db_uint8)DB_EETNODE_OP_UNARYNEG > cursor->type ||
+        (db_uint8)DB_EETNODE_PLACEHOLDER == cursor->type) {
+      stack[top++] = DB_EETNODE_ATTR == cursor->type ? cursor : NULL;
+    } else {
+      numvals = eet_numrequiredvals(cursor->type);
+      if (top < numvals) {
+        top = 0;
+        break;
+      }
+      b = stack[--top];
+      a = 2 == numvals ? stack[--top] : NULL;
+
+      if (DB_EETNODE_OP_AND == cursor->type) {
+        if (NULL != a && DB_EETNODE_OP_EQ == a->type)
+          stack[top++] = a;
+        else if (NULL != b && DB_EETNODE_OP_EQ == b->type)
+          stack[top++] = b;
+        else
+          stack[top++] = NULL;
+      } else if (DB_EETNODE_OP_EQ == cursor->type &&
+                 hashjoin_usablekey(jp, a, b)) {
+        stack[top++] = cursor;
+      } else {
+        stack[top++] = NULL;
+      }
+    }
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  if (1 == top && NULL != stack[0] && DB_EETNODE_OP_EQ == stack[0]->type)
+    found = stack[0];
+
+  db_qmm_ffree(mmp, stack);
+  return found;
+}
+
+/* Number of build tuple records that fit in the query memory right now. */
+static db_int hashjoin_capacity(hashjoin_t *jp, db_query_mm_t *mmp) {
+  db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+  if (NULL != jp->tree)
+    reserve += jp->tree->stack_size;
+  /* The buckets, chain and records are each allocated separately. */
+  reserve += 3 * (db_int)sizeof(db_int);
+
+  db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+  if (avail < reserve)
+    return 0;
+
+  /* Each record also needs a link in the chain and, at most, a bucket. */
+  return (avail - reserve) /
+         (hashjoin_recordsize(hashjoin_buildchild(jp)->header) +
+          2 * (db_int)sizeof(db_int));
+}
+
+static db_int hashjoin_allocbuffers(hashjoin_t *jp, db_int capacity,
+                                    db_query_mm_t *mmp) {
+  db_int recsize = hashjoin_recordsize(hashjoin_buildchild(jp)->header);
+
+  /* Allocate the arrays before the records, so they stay aligned. */
+  jp->buckets = db_qmm_balloc(mmp, ((size_t)capacity) * sizeof(db_int));
+  jp->chain = db_qmm_balloc(mmp, ((size_t)capacity) * sizeof(db_int));
+  jp->records = db_qmm_balloc(mmp, (size_t)(capacity * recsize));
+  if (NULL == jp->buckets || NULL == jp->chain || NULL == jp->records)
+    return -1;
+
+  jp->capacity = capacity;
+  jp->num_buckets = capacity;
+  jp->num_records = 0;
+  return 1;
+}
+
+static void hashjoin_freebuffers(hashjoin_t *jp, db_query_mm_t *mmp) {
+  if (NULL != jp->records)
+    db_qmm_bfree(mmp, jp->records);
+  if (NULL != jp->chain)
+    db_qmm_bfree(mmp, jp->chain);
+  if (NULL != jp->buckets)
+    db_qmm_bfree(mmp, jp->buckets);
+  if (NULL != jp->parts)
+    db_qmm_bfree(mmp, jp->parts);
+  jp->records = NULL;
+  jp->chain = NULL;
+  jp->buckets = NULL;
+  jp->parts = NULL;
+  jp->num_records = 0;
+}
+
+/* Link the records in memory into their buckets.  Records are linked last to
+   first so that each bucket lists its records in the order they were read. */
+static void hashjoin_hashrecords(hashjoin_t *jp) {
+  relation_header_t *hp = hashjoin_buildchild(jp)->header;
+  db_int recsize = hashjoin_recordsize(hp);
+  db_uint8 key = hashjoin_buildkey(jp);
+  db_uint32 bucket;
+  db_tuple_t bt;
+  db_int i;
+
+  for (i = 0; i < jp->num_buckets; ++i)
+    jp->buckets[i] = -1;
+
+  for (i = jp->num_records - 1; i >= 0; --i) {
+    hashjoin_viewrecord(hp, &bt, jp->records + i * recsize);
+    bucket = hashjoin_hash(jp, &bt, key, hp) % (db_uint32)(jp->num_buckets);
+    jp->chain[i] = jp->buckets[bucket];
+    jp->buckets[bucket] = i;
+  }
+}
+
+/* Read the build child's tuples into memory.  The last record slot is only
+   used to find out whether the child has run out of tuples.  Returns 1 if
+   they all fit, 0 if they did not, -1 on error. */
+static db_int hashjoin_loadchild(hashjoin_t *jp, db_query_mm_t *mmp) {
+  db_op_base_t *build = hashjoin_buildchild(jp);
+  db_int recsize = hashjoin_recordsize(build->header);
+  db_uint8 key = hashjoin_buildkey(jp);
+  db_int result;
+  db_tuple_t bt;
+
+  jp->num_records = 0;
+  while (jp->num_records < jp->capacity) {
+    hashjoin_viewrecord(build->header, &bt,
+                        jp->records + jp->num_records * recsize);
+    result = next(build, &bt, mmp);
+    if (0 == result)
+      return 1;
+    else if (1 != result)
+      return -1;
+
+    /* Tuples that are NULL on the join attribute never join. */
+    if (!hashjoin_keyisnull(&bt, key))
+      jp->num_records++;
+  }
+  return 0;
+}
+
+static void hashjoin_filename(hashjoin_t *jp, char side, db_uint8 part,
+                              char *name) {
+  sprintf(name, "DB_HJ_%d_%c%d", (int)(jp->hashid), side, (int)part);
+}
+
+/* Read a tuple record from a partition file.  Returns 1 if a record was
+   read, 0 at the end of the file, -1 on error. */
+static db_int hashjoin_readrecord(db_fileref_t f, db_tuple_t *tp,
+                                  relation_header_t *hp) {
+  size_t isnullsize = (size_t)hashjoin_isnullsize(hp);
+  if (isnullsize != db_fileread(f, (unsigned char *)tp->isnull, isnullsize))
+    return 0;
+  if ((size_t)(hp->tuple_size) !=
+      db_fileread(f, (unsigned char *)tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+static db_int hashjoin_writerecord(db_fileref_t f, db_tuple_t *tp,
+                                   relation_header_t *hp) {
+  size_t isnullsize = (size_t)hashjoin_isnullsize(hp);
+  if (isnullsize != db_filewrite(f, tp->isnull, isnullsize) ||
+      (size_t)(hp->tuple_size) !=
+          db_filewrite(f, tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+/* Close the partition files currently being joined. */
+static void hashjoin_closeparts(hashjoin_t *jp) {
+  db_int i;
+  for (i = 0; i < 2; ++i) {
+    if (DB_STORAGE_NOFILE != jp->parts[i])
+      db_fileclose(jp->parts[i]);
+    jp->parts[i] = DB_STORAGE_NOFILE;
+  }
+}
+
+/* Split all of a child's tuples by hash value, writing each to the temporary
+   file for its partition. */
+static db_int hashjoin_partition(hashjoin_t *jp, db_op_base_t *child,
+                                 db_uint8 key, char side, db_tuple_t *tp,
+                                 db_query_mm_t *mmp) {
+  char name[DB_HASHJOIN_NAMELENGTH];
+  db_uint32 part;
+  db_int i, result = 0;
+
+  for (i = 0; i < (db_int)(jp->num_parts); ++i) {
+    hashjoin_filename(jp, side, (db_uint8)i, name);
+    db_fileremove(name);
+    jp->parts[i] = db_openwritefile(name);
+    if (DB_STORAGE_NOFILE == jp->parts[i]) {
+      result = -1;
+      break;
+    }
+  }
+
+  if (0 == result) {
+    rewind_dbop(child, mmp);
+    while (1 == (result = next(child, tp, mmp))) {
+      if (hashjoin_keyisnull(tp, key))
+        continue;
+
+      part = (hashjoin_hash(jp, tp, key, child->header) >> 16) %
+             (db_uint32)(jp->num_parts);
+      if (1 != hashjoin_writerecord(jp->parts[part], tp, child->header)) {
+        result = -1;
+        break;
+      }
+    }
+  }
+
+  for (i = 0; i < (db_int)(jp->num_parts); ++i) {
+    if (DB_STORAGE_NOFILE != jp->parts[i])
+      db_fileclose(jp->parts[i]);
+    jp->parts[i] = DB_STORAGE_NOFILE;
+  }
+
+  return 0 == result ? 1 : -1;
+}
+
+/* Load the next piece of the current build partition into memory, moving on
+   through the partitions until one has records left.  Each piece is joined
+   against the whole of its probe partition.  Returns 1 if records were
+   loaded, 0 if every partition has been joined, -1 on error. */
+static db_int hashjoin_nextpiece(hashjoin_t *jp, db_query_mm_t *mmp) {
+  relation_header_t *hp = hashjoin_buildchild(jp)->header;
+  db_int recsize = hashjoin_recordsize(hp);
+  char name[DB_HASHJOIN_NAMELENGTH];
+  db_int result = 1;
+  db_tuple_t bt;
+
+  while (jp->part < jp->num_parts) {
+    if (DB_STORAGE_NOFILE == jp->parts[0]) {
+      hashjoin_filename(jp, 'b', jp->part, name);
+      jp->parts[0] = db_openreadfile(name);
+      hashjoin_filename(jp, 'p', jp->part, name);
+      jp->parts[1] = db_openreadfile(name);
+      if (DB_STORAGE_NOFILE == jp->parts[0] ||
+          DB_STORAGE_NOFILE == jp->parts[1])
+        return -1;
+    } else {
+      db_filerewind(jp->parts[1]);
+    }
+
+    jp->num_records = 0;
+    while (jp->num_records < jp->capacity) {
+      hashjoin_viewrecord(hp, &bt, jp->records + jp->num_records * recsize);
+      result = hashjoin_readrecord(jp->parts[0], &bt, hp);
+      if (1 != result)
+        break;
+      jp->num_records++;
+    }
+    if (-1 == result)
+      return -1;
+
+    if (jp->num_records > 0) {
+      hashjoin_hashrecords(jp);
+      return 1;
+    }
+
+    hashjoin_closeparts(jp);
+    jp->part++;
+  }
+  return 0;
+}
+
+/* Load the build side, partitioning both inputs first if it will not fit in
+   memory. */
+static db_int hashjoin_build(hashjoin_t *jp, db_query_mm_t *mmp) {
+  db_op_base_t *build = hashjoin_buildchild(jp);
+  db_int recsize = hashjoin_recordsize(build->header);
+  db_int capacity = hashjoin_capacity(jp, mmp);
+  db_int estimate = estimatenumtuples(build);
+  db_int result, i;
+  db_tuple_t bt;
+
+  if (capacity < 1)
+    return -1;
+
+  /* Unless we already know better, hope the build side fits in memory. */
+  if (estimate < capacity) {
+    if (1 != hashjoin_allocbuffers(jp, capacity, mmp))
+      return -1;
+
+    result = hashjoin_loadchild(jp, mmp);
+    if (-1 == result)
+      return -1;
+    if (1 == result) {
+      /* Give back the memory the records didn't use, if we can. */
+      if (POINTERATNBYTES(jp->records, -1 * ((db_int)sizeof(db_int)),
+                          void *) == mmp->last_back &&
+          jp->num_records < capacity) {
+        memmove(jp->records + (capacity - jp->num_records) * recsize,
+                jp->records, jp->num_records * recsize);
+        jp->records =
+            db_qmm_bextend(mmp, -1 * (capacity - jp->num_records) * recsize);
+      }
+      hashjoin_hashrecords(jp);
+      jp->state = DB_HASHJOIN_STATE_INMEMORY;
+      return 1;
+    }
+
+    /* The estimate was wrong, start over. */
+    hashjoin_freebuffers(jp, mmp);
+    estimate = capacity;
+  }
+
+  jp->num_parts = DB_HASHJOIN_MAXPARTS;
+  if (estimate / capacity + 1 < DB_HASHJOIN_MAXPARTS)
+    jp->num_parts = (db_uint8)(estimate / capacity + 1);
+  if (jp->num_parts < 2)
+    jp->num_parts = 2;
+
+  jp->parts =
+      db_qmm_balloc(mmp, ((size_t)(jp->num_parts)) * sizeof(db_fileref_t));
+  if (NULL == jp->parts)
+    return -1;
+  for (i = 0; i < (db_int)(jp->num_parts); ++i)
+    jp->parts[i] = DB_STORAGE_NOFILE;
+  /* From here on, closing cleans up the files. */
+  jp->state = DB_HASHJOIN_STATE_PARTITIONED;
+
+  init_tuple(&bt, build->header->tuple_size, build->header->num_attr, mmp);
+  result = hashjoin_partition(jp, build, hashjoin_buildkey(jp), 'b', &bt, mmp);
+  close_tuple(&bt, mmp);
+  if (1 != result ||
+      1 != hashjoin_partition(jp, hashjoin_probechild(jp),
+                              hashjoin_probekey(jp), 'p', &(jp->pt), mmp))
+    return -1;
+
+  capacity = hashjoin_capacity(jp, mmp);
+  if (capacity < 1 || 1 != hashjoin_allocbuffers(jp, capacity, mmp))
+    return -1;
+
+  jp->part = 0;
+  if (-1 == hashjoin_nextpiece(jp, mmp))
+    return -1;
+  return 1;
+}
+
+/* Fetch the next probe tuple that is not NULL on the join attribute and find
+   the bucket it hashes to.  Returns 1 if there was one, 0 if there are no
+   more, -1 on error. */
+static db_int hashjoin_nextprobe(hashjoin_t *jp, db_query_mm_t *mmp) {
+  db_op_base_t *probe = hashjoin_probechild(jp);
+  db_uint8 key = hashjoin_probekey(jp);
+  db_int result;
+
+  jp->pvalid = 0;
+  jp->match = -1;
+  while (1) {
+    if (DB_HASHJOIN_STATE_INMEMORY == jp->state) {
+      /* Nothing can join an empty build side. */
+      if (0 == jp->num_records)
+        return 0;
+      result = next(probe, &(jp->pt), mmp);
+    } else if (jp->part >= jp->num_parts) {
+      return 0;
+    } else {
+      result = hashjoin_readrecord(jp->parts[1], &(jp->pt), probe->header);
+      if (0 == result) {
+        /* This piece of the build partition has seen every tuple of its
+           probe partition. */
+        result = hashjoin_nextpiece(jp, mmp);
+        if (1 != result)
+          return result;
+        continue;
+      }
+    }
+
+    if (1 != result)
+      return result;
+    if (!hashjoin_keyisnull(&(jp->pt), key))
+      break;
+  }
+
+  jp->pvalid = 1;
+  jp->match = jp->buckets[hashjoin_hash(jp, &(jp->pt), key, probe->header) %
+                          (db_uint32)(jp->num_buckets)];
+  return 1;
+}
+
+/* Write out the joined tuple of a left and a right tuple. */
+static void hashjoin_combine(hashjoin_t *jp, db_tuple_t *next_tp,
+                             db_tuple_t *lt, db_tuple_t *rt) {
+  copytuplebytes(next_tp, lt, 0, 0, jp->lchild->header->tuple_size);
+  copytupleisnull(next_tp, lt, 0, 0, hashjoin_isnullsize(jp->lchild->header));
+
+  /* Write out right tuples bytes directly after left tuples bytes. */
+  copytuplebytes(next_tp, rt, jp->lchild->header->tuple_size, 0,
+                 jp->rchild->header->tuple_size);
+
+  /* Write out right tuples isnull into new tuple. */
+  db_int i;
+  db_int j = (db_int)(jp->lchild->header->num_attr);
+  for (i = 0; i < (db_int)(jp->rchild->header->num_attr); ++i) {
+    /* If this bit is 0 ... */
+    if (0 == (rt->isnull[i / 8] & (1 << (i % 8)))) {
+      next_tp->isnull[j / 8] &= ~(1 << (j % 8));
+    } else {
+      next_tp->isnull[j / 8] |= (1 << (j % 8));
+    }
+    j++;
+  }
+}
+
+/* Initialize the operator. */
+db_int init_hashjoin(hashjoin_t *jp, db_eet_t *ep, db_op_base_t *lchild,
+                     db_op_base_t *rchild, db_query_mm_t *mmp) {
+  init_ntjoin((ntjoin_t *)jp, ep, lchild, rchild, mmp);
+  return setup_hashjoin(jp, mmp);
+}
+
+/* Setup a hash join from a nested tuple join. */
+db_int setup_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp) {
+  if (NULL == jp->tree || NULL == jp->tree->nodes)
+    return 0;
+
+  db_eetnode_t *eq = hashjoin_findkey(jp, mmp);
+  if (NULL == eq)
+    return 0;
+
+  /* Both sides of the equality are lone attributes, so they are the two
+     nodes right before it. */
+  db_eetnode_attr_t *a = POINTERATNBYTES(
+      eq, -2 * ((db_int)sizeof(db_eetnode_attr_t)), db_eetnode_attr_t *);
+  db_eetnode_attr_t *b = POINTERATNBYTES(
+      eq, -1 * ((db_int)sizeof(db_eetnode_attr_t)), db_eetnode_attr_t *);
+  if (0 == a->tuple_pos) {
+    jp->lkey = a->pos;
+    jp->rkey = b->pos;
+  } else {
+    jp->lkey = b->pos;
+    jp->rkey = a->pos;
+  }
+  jp->keytype = jp->lchild->header->types[jp->lkey];
+
+  /* Build on the smaller input. */
+  db_int lcount = estimatenumtuples(jp->lchild);
+  db_int rcount = estimatenumtuples(jp->rchild);
+  jp->buildright = (lcount < 0 || rcount <= lcount) ? 1 : 0;
+
+  /* The probe tuple takes the place of the nested-tuple join's left tuple.
+   */
+  if (!(jp->buildright)) {
+    close_tuple(&(jp->pt), mmp);
+    init_tuple(&(jp->pt), jp->rchild->header->tuple_size,
+               jp->rchild->header->num_attr, mmp);
+  }
+  rewind_dbop(jp->lchild, mmp);
+
+  jp->pvalid = 0;
+  jp->records = NULL;
+  jp->buckets = NULL;
+  jp->chain = NULL;
+  jp->parts = NULL;
+  jp->num_buckets = 0;
+  jp->capacity = 0;
+  jp->num_records = 0;
+  jp->match = -1;
+  jp->num_parts = 0;
+  jp->part = 0;
+  jp->hashid = db_hashjoin_nextid++;
+  jp->state = DB_HASHJOIN_STATE_UNBUILT;
+  jp->base.type = DB_HASHJOIN;
+  return 1;
+}
+
+/* Re-start the operator from the beginning. This assumes the operator has
+ * been initialized. */
+db_int rewind_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp) {
+  jp->pvalid = 0;
+  jp->match = -1;
+
+  if (DB_HASHJOIN_STATE_INMEMORY == jp->state) {
+    return rewind_dbop(hashjoin_probechild(jp), mmp);
+  } else if (DB_HASHJOIN_STATE_PARTITIONED == jp->state) {
+    hashjoin_closeparts(jp);
+    jp->part = 0;
+    return -1 == hashjoin_nextpiece(jp, mmp) ? -1 : 1;
+  }
+
+  rewind_dbop(jp->lchild, mmp);
+  rewind_dbop(jp->rchild, mmp);
+  return 1;
+}
+
+/* Find next tuple that passes the join condition.
+   -This assumes that the evaluation tree will always reduce to either 0 or 1
+    for all tuples.
+   -The algorithm used is the following:
+                build the hash table on the build side, if not yet built
+                while pt is a valid tuple from the probe side
+                        for each tuple bt in pt's bucket
+                                if bt joins pt
+                                        return joined tuple
+                        pt <- next tuple from the probe side
+*/
+db_int next_hashjoin(hashjoin_t *jp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  /* Create necessary result variable. */
+  db_int result = 0, retval;
+  relation_header_t *bhp = hashjoin_buildchild(jp)->header;
+  db_int recsize = hashjoin_recordsize(bhp);
+  db_tuple_t bt;
+
+  /* Build arrays to be passed to eet evaluation engine. */
+  relation_header_t *hpa[2];
+  hpa[0] = jp->lchild->header;
+  hpa[1] = jp->rchild->header;
+  db_tuple_t *tpa[2];
+  if (jp->buildright) {
+    tpa[0] = &(jp->pt);
+    tpa[1] = &bt;
+  } else {
+    tpa[0] = &bt;
+    tpa[1] = &(jp->pt);
+  }
+
+  if (DB_HASHJOIN_STATE_UNBUILT == jp->state &&
+      1 != hashjoin_build(jp, mmp)) {
+    return -1;
+  }
+
+  while (1) {
+    while (1 == jp->pvalid && jp->match >= 0) {
+      hashjoin_viewrecord(bhp, &bt, jp->records + jp->match * recsize);
+      jp->match = jp->chain[jp->match];
+
+      /* Different keys can share a bucket. */
+      if (!hashjoin_keysequal(jp, &bt, &(jp->pt)))
+        continue;
+
+      /* The rest of the join condition must hold too. */
+      if (jp->tree != NULL && jp->tree->nodes != NULL) {
+        retval = evaluate_eet(jp->tree, &result, tpa, hpa, 0, mmp);
+      } else {
+        retval = 1;
+        result = 1;
+      }
+
+      if (1 == result && 1 == retval) {
+        hashjoin_combine(jp, next_tp, tpa[0], tpa[1]);
+        return 1;
+      }
+    }
+
+    retval = hashjoin_nextprobe(jp, mmp);
+    if (1 != retval)
+      return retval;
+  }
+}
+
+/* Close the operator. */
+db_int close_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp) {
+  char name[DB_HASHJOIN_NAMELENGTH];
+  db_int i;
+
+  if (DB_HASHJOIN_STATE_PARTITIONED == jp->state) {
+    hashjoin_closeparts(jp);
+    for (i = 0; i < (db_int)(jp->num_parts); ++i) {
+      hashjoin_filename(jp, 'b', (db_uint8)i, name);
+      db_fileremove(name);
+      hashjoin_filename(jp, 'p', (db_uint8)i, name);
+      db_fileremove(name);
+    }
+  }
+  hashjoin_freebuffers(jp, mmp);
+  jp->state = DB_HASHJOIN_STATE_UNBUILT;
+
+  close_tuple(&(jp->pt), mmp);
+  /* Free all header properties that were allocated */
+  DB_QMM_BFREE(mmp, jp->base.header->size_name);
+  DB_QMM_BFREE(mmp, jp->base.header->names);
+  DB_QMM_BFREE(mmp, jp->base.header->types);
+  DB_QMM_BFREE(mmp, jp->base.header->offsets);
+  DB_QMM_BFREE(mmp, jp->base.header->sizes);
+
+  /* Free the header itself. */
+  DB_QMM_BFREE(mmp, jp->base.header);
+
+  return 1;
+}
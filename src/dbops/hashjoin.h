@@ -0,0 +1,108 @@
+/******************************************************************************/
+/**
+@file		hashjoin.h
+@author		Graeme Douglas
+@brief		The relational equi-join, implemented as a hash join.
+@details	A join that requires its condition equate an attribute of
+		the left relation with an attribute of the right relation.
+		Neither input needs to be indexed.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef HASHJOIN_H
+#define HASHJOIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "db_ops_types.h"
+#include "../dbobjects/relation.h"
+#include "../dbobjects/tuple.h"
+#include <stdio.h>
+
+/* Initialize the operator. */
+/**
+@brief		Attempt to initialize a hash join.
+@details	This first initializes an @ref ntjoin_t object, then tries
+		to convert it to a @ref hashjoin_t object.  If this method
+		returns @c 0, the operator still functions as a nested-tuple
+		join.
+@param		jp	A pointer to the join object to initialize.
+@param		ep	A pointer to the join expression to initalize on.
+@param		lchild	A pointer to the left child of the join operator.
+@param		rchild	A pointer to the right child of the join operator.
+@param		mmp	A pointer to the memory manager instance variable
+			used to allocate memory for this query.
+@returns	@c 1 if a hash join was properly initialized, @c 0
+		otherwise.
+@see		For more information, reference @ref setup_hashjoin.
+*/
+db_int init_hashjoin(hashjoin_t *jp,
+		db_eet_t *ep,
+		db_op_base_t *lchild,
+		db_op_base_t *rchild,
+		db_query_mm_t *mmp);
+
+/* Setup a hash join from a nested tuple join. */
+/**
+@brief		Convert a nested-tuple join into a hash join.
+@details	The join condition must contain, as a top-level conjunct, an
+		equality between an attribute of the left child and an
+		attribute of the right child of the same integer or string
+		type.
+@param		jp	A pointer to an already initialized instance
+			of an @ref ntjoin_t object, with enough space to hold a
+			@ref hashjoin_t object.  If this method returns @c 0,
+			it is fine to assume that the object will still function
+			as an @ref ntjoin_t operator.
+@param		mmp	A pointer to the memory manager instance variable
+			that will be used for allocating memory in this
+			query.
+@returns	@c 1 if @c jp was converted, @c 0 otherwise.
+*/
+db_int setup_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp);
+
+/* Re-start the operator from the beginning. This assumes the operator has
+   been initialized. */
+/**
+@brief		Rewind a hash join operator.
+@details	Once built, the hash table (or the partition files) are
+		kept, so only the probe side is read again.
+@see		For more information, please reference @ref rewind_dbop.
+*/
+db_int rewind_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp);
+
+/* Find next tuple that passes the join condition. */
+/**
+@brief		Produce the next tuple from a hash join operator.
+@see		For more information, please reference @ref next.
+*/
+db_int next_hashjoin(hashjoin_t *jp, db_tuple_t *next_tp, db_query_mm_t *mmp);
+
+/* Close the operator. */
+/**
+@brief		Cleanly deconstruct a hash join operator, removing any
+		temporary files it created.
+@see		For more information, please reference @ref close.
+*/
+db_int close_hashjoin(hashjoin_t *jp, db_query_mm_t *mmp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,130 +36,213 @@ db_int init_project(project_t *pp, db_op_base_t *childop_p, db_eet_t *exprs,
   db_int result = createnewheader(pp->base.header, childop_p->header, exprs,
                                   num_exprs, mmp);
   pp->child = childop_p;
+  pp->batch.records = NULL;
+  pp->batch.rows = NULL;
+  pp->batch.capacity = 0;
+  pp->batch.count = 0;
+  pp->position = 0;
+
+  /* Expressions are compiled once the whole plan is built. */
+  pp->progs = DB_QMM_BALLOC(mmp, num_exprs * sizeof(db_eetprog_t));
+  if (NULL != pp->progs) {
+    db_int i;
+    for (i = 0; i < (db_int)num_exprs; ++i)
+      init_eetprog(&(pp->progs[i]));
+  }
   return result;
 }
 
 /* This method assumes the scan is already initialized */
 db_int rewind_project(project_t *pp, db_query_mm_t *mmp) {
+  pp->batch.count = 0;
+  pp->position = 0;
   rewind_dbop(pp->child, mmp);
   return 1;
 }
 
+/* Evaluate one of the projected expressions on a tuple. */
+static db_int project_evaluate(project_t *pp, db_int i, void *rp,
+                               db_tuple_t *temp_tp, db_query_mm_t *mmp) {
+  if (NULL == pp->progs)
+    return evaluate_eet(&(pp->exprs[i]), rp, &temp_tp, &(pp->child->header), 0,
+                        mmp);
+  return evaluate_eet_compiled(&(pp->progs[i]), &(pp->exprs[i]), rp, &temp_tp,
+                               &(pp->child->header), mmp);
+}
+
+/* Write out the projection of one of the child's tuples. */
+static db_int project_tuple(project_t *pp, db_tuple_t *temp_tp,
+                            db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  /* For each byte in the old tuple, if it belongs to an
+   * attribute in the new tuple, copy it.
+   */
+  db_int i = 0, k = 0; /* k for attributes, i for expressions. */
+  for (; i < (db_int)(pp->num_exprs); ++k, ++i) {
+    if (NULL == pp->exprs[i].nodes) {
+      db_int j_a, j_bytes;
+      for (j_a = pp->exprs[i].stack_size;
+           j_a < pp->exprs[i].stack_size + pp->exprs[i].size; ++j_a) {
+        for (j_bytes = 0; j_bytes < (db_int)(pp->base.header->sizes[k]);
+             ++j_bytes) {
+          next_tp->bytes[pp->base.header->offsets[k] + j_bytes] =
+              temp_tp
+                  ->bytes[(db_int)(pp->child->header->offsets[j_a]) + j_bytes];
+        }
+
+        if (1 ==
+            (((temp_tp->isnull[j_a / 8]) & (1 << (j_a % 8))) >> (j_a % 8))) {
+          next_tp->isnull[(k / 8)] |= (1 << (k % 8));
+        } else {
+          next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
+        }
+        ++k;
+      }
+
+      /* Since we increment k below, must decrement now. */
+      k--;
+
+    } else if (pp->base.header->types[k] == DB_INT) {
+      db_int value;
+      switch (project_evaluate(pp, i, &value, temp_tp, mmp)) {
+      case 2:
+        /* Set this attributes isnull bit to 1. */
+        next_tp->isnull[(k / 8)] |= (1 << (k % 8));
+        break;
+      case 1:
+        /* Make sure this attributes isnull bit is 0. */
+        next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
+        *((db_int *)(&next_tp->bytes[pp->base.header->offsets[k]])) = value;
+        break;
+      case -1:
+      default:
+        return -1;
+      }
+    } else if (pp->base.header->types[k] == DB_DECIMAL) {
+      db_decimal value;
+      switch (project_evaluate(pp, i, &value, temp_tp, mmp)) {
+      case 2:
+        /* Set this attributes isnull bit to 1. */
+        next_tp->isnull[(k / 8)] |= (1 << (k % 8));
+        break;
+      case 1:
+        /* Make sure this attributes isnull bit is 0. */
+        next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
+        *((db_decimal *)(&next_tp->bytes[pp->base.header->offsets[k]])) =
+            value;
+        break;
+      case -1:
+      default:
+        return -1;
+      }
+    } else if (pp->base.header->types[k] == DB_STRING) {
+      db_int j;
+      char *value;
+      switch (project_evaluate(pp, i, &value, temp_tp, mmp)) {
+      case 2:
+        /* Set this attributes isnull bit to 1. */
+        next_tp->isnull[(k / 8)] |= (1 << (k % 8));
+        break;
+      case 1:
+        /* Make sure this attributes isnull bit is 0. */
+        next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
+        for (j = 0; j < strlen(value); j++) {
+          next_tp->bytes[pp->base.header->offsets[k] + j] = (value[j]);
+        }
+        next_tp->bytes[pp->base.header->offsets[k] + strlen(value)] = '\0';
+        break;
+      case -1:
+      default:
+        return -1;
+      }
+    }
+    /* TODO: Implement future types here. */
+  }
+  return 1;
+}
+
+/* Set up the batch the projection operator keeps its child's tuples in. */
+db_int init_batch_project(project_t *pp, db_query_mm_t *mmp) {
+  if (NULL != pp->batch.records)
+    return 1;
+  return init_opbatch(pp->child, &(pp->batch), mmp);
+}
+
+/* Make sure there are tuples from the child waiting to be projected. */
+static db_int project_refill(project_t *pp, db_query_mm_t *mmp) {
+  db_int i, j;
+  if (pp->position < pp->batch.count)
+    return 1;
+
+  /* The child's batch is kept from call to call.  An operator below that
+     holds memory between calls, like a sort, would otherwise strand the
+     memory of each batch freed underneath it. */
+  if (1 != init_batch_project(pp, mmp))
+    return -1;
+  for (i = 0; i < pp->batch.capacity; ++i)
+    for (j = 0; j < pp->batch.isnullsize; ++j)
+      pp->batch.records[i * pp->batch.recordsize + j] = 0;
+
+  pp->position = 0;
+  pp->batch.count = 0;
+  return next_batch(pp->child, &(pp->batch), mmp);
+}
+
 /* Retrieve next tuple.
    This assumes a properly initialized tuple with apropriate number of bytes
    is passed in.
 */
 db_int next_project(project_t *pp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
   db_tuple_t temp_t;
-  init_tuple(&temp_t, pp->child->header->tuple_size,
-             pp->child->header->num_attr, mmp);
 
-  /* Get the next tuple from the child */
-  db_int result = next(pp->child, &temp_t, mmp);
-  if (1 != result) {
-    close_tuple(&temp_t, mmp);
+  /* The child's tuples are fetched a batch at a time, and handed out one
+     at a time from there. */
+  db_int result = project_refill(pp, mmp);
+  if (1 != result)
     return result;
-  } else {
-    /* For each byte in the old tuple, if it belongs to an
-     * attribute in the new tuple, copy it.
-     */
-    db_int i = 0, k = 0; /* k for attributes, i for expressions. */
-    for (; i < (db_int)(pp->num_exprs); ++k, ++i) {
-      if (NULL == pp->exprs[i].nodes) {
-        db_int j_a, j_bytes;
-        for (j_a = pp->exprs[i].stack_size;
-             j_a < pp->exprs[i].stack_size + pp->exprs[i].size; ++j_a) {
-          for (j_bytes = 0; j_bytes < (db_int)(pp->base.header->sizes[k]);
-               ++j_bytes) {
-            next_tp->bytes[pp->base.header->offsets[k] + j_bytes] =
-                temp_t
-                    .bytes[(db_int)(pp->child->header->offsets[j_a]) + j_bytes];
-          }
-
-          if (1 ==
-              (((temp_t.isnull[j_a / 8]) & (1 << (j_a % 8))) >> (j_a % 8))) {
-            next_tp->isnull[(k / 8)] |= (1 << (k % 8));
-          } else {
-            next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
-          }
-          ++k;
-        }
+  viewbatchtuple(&(pp->batch), pp->position, &temp_t);
+  pp->position++;
+  return project_tuple(pp, &temp_t, next_tp, mmp);
+}
 
-        /* Since we increment k below, must decrement now. */
-        k--;
+/* Retrieve the next batch of tuples. */
+db_int next_batch_project(project_t *pp, db_tuplebatch_t *bp,
+                          db_query_mm_t *mmp) {
+  db_tuple_t temp_t, next_t;
+  db_int result = 0;
 
-      } else if (pp->base.header->types[k] == DB_INT) {
-        db_int value;
-        db_tuple_t *temp_tp = &temp_t;
-        switch (evaluate_eet(&(pp->exprs[i]), &value, &temp_tp,
-                             &(pp->child->header), 0, mmp)) {
-        case 2:
-          /* Set this attributes isnull bit to 1. */
-          next_tp->isnull[(k / 8)] |= (1 << (k % 8));
-          break;
-        case 1:
-          /* Make sure this attributes isnull bit is 0. */
-          next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
-          *((db_int *)(&next_tp->bytes[pp->base.header->offsets[k]])) = value;
-          break;
-        case -1:
-        default:
-          close_tuple(&temp_t, mmp);
-          return -1;
-        }
-      } else if (pp->base.header->types[k] == DB_DECIMAL) {
-        db_decimal value;
-        db_tuple_t *temp_tp = &temp_t;
-        switch (evaluate_eet(&(pp->exprs[i]), &value, &temp_tp,
-                             &(pp->child->header), 0, mmp)) {
-        case 2:
-          /* Set this attributes isnull bit to 1. */
-          next_tp->isnull[(k / 8)] |= (1 << (k % 8));
-          break;
-        case 1:
-          /* Make sure this attributes isnull bit is 0. */
-          next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
-          *((db_decimal *)(&next_tp->bytes[pp->base.header->offsets[k]])) =
-              value;
-          break;
-        case -1:
-        default:
-          close_tuple(&temp_t, mmp);
-          return -1;
-        }
-      } else if (pp->base.header->types[k] == DB_STRING) {
-        db_int j;
-        char *value;
-        db_tuple_t *temp_tp = &temp_t;
-        switch (evaluate_eet(&(pp->exprs[i]), &value, &temp_tp,
-                             &(pp->child->header), 0, mmp)) {
-        case 2:
-          /* Set this attributes isnull bit to 1. */
-          next_tp->isnull[(k / 8)] |= (1 << (k % 8));
-          break;
-        case 1:
-          /* Make sure this attributes isnull bit is 0. */
-          next_tp->isnull[(k / 8)] &= ~(1 << (k % 8));
-          for (j = 0; j < strlen(value); j++) {
-            next_tp->bytes[pp->base.header->offsets[k] + j] = (value[j]);
-          }
-          next_tp->bytes[pp->base.header->offsets[k] + strlen(value)] = '\0';
-          break;
-        case -1:
-        default:
-          close_tuple(&temp_t, mmp);
-          return -1;
-        }
-      }
-      /* TODO: Implement future types here. */
+  bp->count = 0;
+  while (bp->count < bp->capacity) {
+    result = project_refill(pp, mmp);
+    if (1 != result)
+      break;
+
+    for (; bp->count < bp->capacity && pp->position < pp->batch.count;
+         bp->count++, pp->position++) {
+      viewbatchtuple(&(pp->batch), pp->position, &temp_t);
+      viewbatchtuple(bp, bp->count, &next_t);
+      if (1 != project_tuple(pp, &temp_t, &next_t, mmp))
+        return -1;
+      if (NULL != bp->rows)
+        bp->rows[bp->count] = temp_t.offset_r;
     }
-    close_tuple(&temp_t, mmp);
-    return 1;
   }
+
+  if (-1 == result)
+    return -1;
+  return bp->count > 0 ? 1 : result;
 }
 
 /* Close the projection operator. */
 void close_project(project_t *pp, db_query_mm_t *mmp) {
+  close_tuplebatch(&(pp->batch), mmp);
+  if (NULL != pp->progs) {
+    db_int i;
+    for (i = 0; i < (db_int)(pp->num_exprs); ++i)
+      close_eetprog(&(pp->progs[i]), mmp);
+    DB_QMM_BFREE(mmp, pp->progs);
+    pp->progs = NULL;
+  }
+
   /* Free up header's properties */
   DB_QMM_BFREE(mmp, pp->base.header->size_name);
   DB_QMM_BFREE(mmp, pp->base.header->names);
@@ -59,13 +59,39 @@ db_int init_project(project_t *pp,
 */
 db_int rewind_project(project_t *pp, db_query_mm_t *mmp);
 
+/* Set up the projection operator's batch. */
+/**
+@brief		Set up the batch a projection operator keeps its child's
+		tuples in.
+@details	This is done by the first call to @ref next_project or
+		@ref next_batch_project if it has not been done already.
+@param		pp		A pointer to the projection operator.
+@param		mmp		Pointer to the per-query memory manager that is
+				being used to allocate memory for the query.
+@returns	@c 1 if the batch is set up, @c -1 otherwise.
+*/
+db_int init_batch_project(project_t *pp,
+		db_query_mm_t *mmp);
+
 /* Retrieve next tuple. */
 /**
 @brief		Retrieve the next tuple from the projection operator.
+@details	The child's tuples are fetched a batch at a time, into a batch
+		kept by the operator, and projected one at a time from there.
 @see		Reference @ref next for documentation.
 */
 db_int next_project(project_t *pp, db_tuple_t *next_tp, db_query_mm_t *mmp);
 
+/* Retrieve the next batch of tuples. */
+/**
+@brief		Retrieve the next batch of tuples from the projection operator.
+@details	The child's tuples are fetched a batch at a time, into a batch
+		kept by the operator, and @p bp is filled from there.
+@see		Reference @ref next_batch for documentation.
+*/
+db_int next_batch_project(project_t *pp, db_tuplebatch_t *bp,
+		db_query_mm_t *mmp);
+
 /* Close the projection operator. */
 /**
 @brief		Safely destroy a projection operator.
@@ -25,6 +25,7 @@
 #include "scan.h"
 #include "../dbstorage/dbstorage.h"
 #include "db_ops.h"
+#include "../dbindex/dbindex.h"
 
 /* Initialize the scan operator. */
 db_int init_scan(scan_t *sp, char *relationName, db_query_mm_t *mmp) {
@@ -34,64 +35,23 @@ db_int init_scan(scan_t *sp, char *relationName, db_query_mm_t *mmp) {
 
   sp->base.type = DB_SCAN;
 
-  sp->indexon = -1;
+  sp->tuple_end = -1;
+  sp->cursor.indexref = DB_STORAGE_NOFILE;
+  sp->cursor.indexon = -1;
+  sp->indexonly = 0;
 
-  sp->tuple_start = 1;
-  int i;
-  for (i = 0; i < (db_int)sp->base.header->num_attr; ++i) {
-    sp->tuple_start += 4; /* constant sized info */
-    sp->tuple_start += (long)(sp->base.header->size_name[i]);
-  }
+  sp->tuple_start = gettuplestart(sp->base.header);
+  sp->first_record = sp->tuple_start;
 
   sp->relation = db_openreadfile(relationName);
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  sp->map_size = 0;
+  sp->map = db_filemap(sp->relation, &(sp->map_size));
+#endif
   rewind_scan(sp, mmp);
 
   /* Build up index info. */
-  char metaname[9 + strlen(relationName)];
-  sprintf(metaname, "DB_IDXM_%s", relationName);
-  db_fileref_t idxmetafile = db_openreadfile(metaname);
-
-  if (DB_STORAGE_NOFILE == idxmetafile) {
-    sp->idx_meta_data.num_idx = 0;
-    return 1;
-  }
-
-  db_fileread(idxmetafile, &(sp->idx_meta_data.num_idx), sizeof(db_uint8));
-  sp->idx_meta_data.len_names =
-      DB_QMM_BALLOC(mmp, sizeof(db_uint8) * (sp->idx_meta_data.num_idx));
-  sp->idx_meta_data.names =
-      DB_QMM_BALLOC(mmp, sizeof(char *) * (sp->idx_meta_data.num_idx));
-  sp->idx_meta_data.num_expr =
-      DB_QMM_BALLOC(mmp, sizeof(db_uint8) * (sp->idx_meta_data.num_idx));
-  sp->idx_meta_data.exprs =
-      DB_QMM_BALLOC(mmp, sizeof(db_eet_t *) * (sp->idx_meta_data.num_idx));
-
-  int j;
-  for (i = 0; i < sp->idx_meta_data.num_idx; ++i) {
-    // TODO: Make sure all pointers passed to read function make sense.
-    db_fileread(idxmetafile, &(sp->idx_meta_data.len_names[i]),
-                sizeof(db_uint8));
-    sp->idx_meta_data.names[i] =
-        DB_QMM_BALLOC(mmp, sp->idx_meta_data.len_names[i]);
-    db_fileread(idxmetafile, (unsigned char *)(sp->idx_meta_data.names[i]),
-                sp->idx_meta_data.len_names[i]);
-    db_fileread(idxmetafile, &(sp->idx_meta_data.num_expr[i]),
-                sizeof(db_uint8));
-    sp->idx_meta_data.exprs[i] =
-        DB_QMM_BALLOC(mmp, sizeof(db_eet_t) * (sp->idx_meta_data.num_expr[i]));
-    db_fileread(idxmetafile, (unsigned char *)(sp->idx_meta_data.exprs[i]),
-                sizeof(db_eet_t) * (sp->idx_meta_data.num_expr[i]));
-
-    for (j = 0; j < sp->idx_meta_data.num_expr[i]; ++j) {
-      sp->idx_meta_data.exprs[i][j].nodes =
-          DB_QMM_BALLOC(mmp, (sp->idx_meta_data.exprs[i][j].size));
-      db_fileread(idxmetafile,
-                  (unsigned char *)(sp->idx_meta_data.exprs[i][j].nodes),
-                  (sp->idx_meta_data.exprs[i][j].size));
-    }
-  }
-
-  db_fileclose(idxmetafile);
+  db_index_readmeta(&(sp->idx_meta_data), relationName, mmp);
 
   return 1;
 }
@@ -99,10 +59,42 @@ db_int init_scan(scan_t *sp, char *relationName, db_query_mm_t *mmp) {
 /* This method assumes the scan is already initialized */
 db_int rewind_scan(scan_t *sp, db_query_mm_t *mmp) {
   /* Go to beginning, skip over header information. */
+  seek_scan(sp, sp->tuple_start);
+  /* A scan following an index starts its range over. */
+  if (DB_STORAGE_NOFILE != sp->cursor.indexref)
+    return db_index_seekcursor(&(sp->cursor), mmp);
+  return 1;
+}
+
+/* Move to the tuple record at some offset. */
+db_int seek_scan(scan_t *sp, long offset) {
+  sp->position = offset;
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  /* The file is only positioned when the mapping runs out. */
+  if (NULL != sp->map)
+    return 1;
+#endif
   db_filerewind(sp->relation);
-  db_fileseek(sp->relation, sp->tuple_start);
+  db_fileseek(sp->relation, offset);
+  return 1;
+}
+
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+/* Copy the next tuple record out of the mapped relation file, if it is
+   there.  Returns 1 if it was, 0 if it lies past the end of the mapping. */
+static db_int scan_mapped(scan_t *sp, db_tuple_t *next_tp,
+                          db_int bit_arr_size) {
+  db_int size = bit_arr_size + (db_int)(sp->base.header->tuple_size);
+  if (NULL == sp->map || sp->position + size > sp->map_size)
+    return 0;
+
+  memcpy(next_tp->isnull, sp->map + sp->position, (size_t)bit_arr_size);
+  memcpy(next_tp->bytes, sp->map + sp->position + bit_arr_size,
+         (size_t)(sp->base.header->tuple_size));
+  sp->position += size;
   return 1;
 }
+#endif
 
 /* Retrieve the next tuple from the relation. */
 db_int next_scan(scan_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
@@ -110,21 +102,54 @@ db_int next_scan(scan_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
   if (((db_int)(sp->base.header->num_attr)) % 8 > 0)
     bit_arr_size++;
 
-  if (bit_arr_size == db_fileread(sp->relation,
-                                  (unsigned char *)next_tp->isnull,
-                                  SIZE_BYTE * bit_arr_size)) {
-    next_tp->offset_r++;
-    if ((size_t)(sp->base.header->tuple_size) ==
-        db_fileread(sp->relation, (unsigned char *)next_tp->bytes,
-                    SIZE_BYTE * (db_int)(sp->base.header->tuple_size))) {
-      // TODO: Right now, this assumes we only use ints for index.
-      /* Only check stop condition if it exists. */
-      if (sp->indexon > -1) {
-        db_int val;
-        val = getintbypos(next_tp, sp->indexon, sp->base.header);
-        if (val >= sp->stopat)
-          return 0;
-      }
+  if (DB_STORAGE_NOFILE != sp->cursor.indexref) {
+    db_index_offset_t offset;
+    /* An index holding all the query needs makes the tuple itself. */
+    if (sp->indexonly) {
+      if (1 != db_index_nextcovered(sp, next_tp, &offset))
+        return 0;
+      next_tp->offset_r =
+          (uint16_t)((offset - sp->first_record) /
+                         (bit_arr_size + (long)(sp->base.header->tuple_size)) +
+                     1);
+      return 1;
+    }
+    if (1 != db_index_nextoffset(&(sp->cursor), &offset))
+      return 0;
+    seek_scan(sp, offset);
+  }
+  long record = sp->position;
+
+  /* A scan of a range of an ordered relation stops where the range does. */
+  if (sp->tuple_end > -1 && record >= sp->tuple_end)
+    return 0;
+
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  db_int mapped = scan_mapped(sp, next_tp, bit_arr_size);
+
+  /* Anything written after the file was mapped is read from storage. */
+  if (!mapped && NULL != sp->map) {
+    db_filerewind(sp->relation);
+    db_fileseek(sp->relation, sp->position);
+  }
+#else
+  db_int mapped = 0;
+#endif
+
+  if (mapped || bit_arr_size == db_fileread(sp->relation,
+                                            (unsigned char *)next_tp->isnull,
+                                            SIZE_BYTE * bit_arr_size)) {
+    /* Rows are numbered by where they are, however the scan got there. */
+    next_tp->offset_r =
+        (uint16_t)((record - sp->first_record) /
+                       (bit_arr_size + (long)(sp->base.header->tuple_size)) +
+                   1);
+    if (mapped ||
+        (size_t)(sp->base.header->tuple_size) ==
+            db_fileread(sp->relation, (unsigned char *)next_tp->bytes,
+                        SIZE_BYTE * (db_int)(sp->base.header->tuple_size))) {
+      if (!mapped)
+        sp->position += bit_arr_size + (db_int)(sp->base.header->tuple_size);
       return 1;
     } else {
       return 0;
@@ -134,25 +159,48 @@ db_int next_scan(scan_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
   }
 }
 
+/* Retrieve the next batch of tuples from the relation. */
+db_int next_batch_scan(scan_t *sp, db_tuplebatch_t *bp, db_query_mm_t *mmp) {
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  /* Records in the file are laid out just as in a batch, so a whole batch
+     comes out of the mapping at once, up to where the scan stops.  Scans
+     following an index jump around. */
+  if (NULL != sp->map && DB_STORAGE_NOFILE == sp->cursor.indexref) {
+    long end = sp->map_size;
+    db_int i;
+    if (sp->tuple_end > -1 && sp->tuple_end < end)
+      end = sp->tuple_end;
+    db_int count = (db_int)((end - sp->position) / bp->recordsize);
+    if (count > bp->capacity)
+      count = bp->capacity;
+    if (count > 0) {
+      memcpy(bp->records, sp->map + sp->position,
+             (size_t)(count * bp->recordsize));
+      for (i = 0; NULL != bp->rows && i < count; ++i)
+        bp->rows[i] = (uint16_t)((sp->position - sp->first_record) /
+                                     bp->recordsize +
+                                 i + 1);
+      sp->position += count * bp->recordsize;
+      bp->count = count;
+      return 1;
+    }
+  }
+#endif
+  return fillbatch((db_op_base_t *)sp, bp, mmp);
+}
+
 /* Close the operator. */
 void close_scan(scan_t *sp, db_query_mm_t *mmp) {
   /* Close the file stream. */
+  db_index_closecursor(&(sp->cursor));
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  db_fileunmap(sp->map, sp->map_size);
+  sp->map = NULL;
+#endif
   db_fileclose(sp->relation);
 
   freerelationheader(sp->base.header, mmp);
 
   /* Free indexing information, if necessary. */
-  if (sp->idx_meta_data.num_idx > 0) {
-    int i, j;
-    for (i = 0; i < (db_int)sp->idx_meta_data.num_idx; i++) {
-      DB_QMM_BFREE(mmp, sp->idx_meta_data.names[i]);
-      for (j = 0; j < (db_int)sp->idx_meta_data.num_expr[i]; j++)
-        DB_QMM_BFREE(mmp, sp->idx_meta_data.exprs[i][j].nodes);
-      DB_QMM_BFREE(mmp, sp->idx_meta_data.exprs[i]);
-    }
-    DB_QMM_BFREE(mmp, sp->idx_meta_data.len_names);
-    DB_QMM_BFREE(mmp, sp->idx_meta_data.names);
-    DB_QMM_BFREE(mmp, sp->idx_meta_data.num_expr);
-    DB_QMM_BFREE(mmp, sp->idx_meta_data.exprs);
-  }
+  db_index_freemeta(&(sp->idx_meta_data), mmp);
 }
@@ -68,6 +68,21 @@ db_int rewind_scan(scan_t *sp, db_query_mm_t *mmp);
 */
 db_int next_scan(scan_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp);
 
+/**
+@brief		Move the scan to a given tuple record.
+@param		sp		A pointer to the scan operator.
+@param		offset		The offset of the record in the relation file.
+@returns	@c 1 if the scan was moved, @c 0 otherwise.
+*/
+db_int seek_scan(scan_t *sp, long offset);
+
+/* Retrieve the next batch of tuples from the relation. */
+/**
+@brief		Retrieve the next batch of tuples from storage mechanism.
+@see		Reference @ref next_batch for more information.
+*/
+db_int next_batch_scan(scan_t *sp, db_tuplebatch_t *bp, db_query_mm_t *mmp);
+
 /* Close scan. */
 /**
 @brief		Safely deconstruct the scan operator.
@@ -33,43 +33,143 @@ db_int init_select(select_t *sp, db_eet_t *ep, db_op_base_t *child,
   sp->base.header = child->header;
   sp->tree = ep;
   sp->child = child;
+  init_eetprog(&(sp->prog));
+  sp->batch.records = NULL;
+  sp->batch.rows = NULL;
+  sp->batch.capacity = 0;
+  sp->batch.count = 0;
+  sp->position = 0;
+  sp->selected = NULL;
   return 1;
 }
 
 /* This method assumes the scan is already initialized */
 db_int rewind_select(select_t *sp, db_query_mm_t *mmp) {
+  sp->batch.count = 0;
+  sp->position = 0;
   rewind_dbop(sp->child, mmp);
   return 1;
 }
 
+/* Set up the batch the selection operator checks its child's tuples in. */
+db_int init_batch_select(select_t *sp, db_query_mm_t *mmp) {
+  if (NULL == sp->batch.records &&
+      1 != init_opbatch(sp->child, &(sp->batch), mmp))
+    return -1;
+  if (1 != keepbatchrows(&(sp->batch), mmp))
+    return -1;
+  if (NULL == sp->selected)
+    sp->selected =
+        DB_QMM_BALLOC(mmp, (size_t)((sp->batch.capacity + 7) / 8));
+  return NULL == sp->selected ? -1 : 1;
+}
+
+/* Fill a batch with tuples that pass the selection condition.  The
+   condition is evaluated over the child's whole batch, and the tuples that
+   pass are then moved to the front. */
+static db_int select_fill(select_t *sp, db_tuplebatch_t *bp,
+                          db_uint8 *selected, db_query_mm_t *mmp) {
+  db_int i, kept, retval;
+
+  while (1) {
+    retval = next_batch(sp->child, bp, mmp);
+    if (1 != retval)
+      break;
+
+    memset(selected, 0xFF, (size_t)((bp->count + 7) / 8));
+    evaluate_eet_batch(&(sp->prog), sp->tree, bp, sp->base.header, selected,
+                       mmp);
+
+    kept = 0;
+    for (i = 0; i < bp->count; ++i) {
+      if (selected[i / 8] & (1 << (i % 8))) {
+        if (kept != i) {
+          memmove(bp->records + kept * bp->recordsize,
+                  bp->records + i * bp->recordsize, (size_t)bp->recordsize);
+          if (NULL != bp->rows)
+            bp->rows[kept] = bp->rows[i];
+        }
+        kept++;
+      }
+    }
+    bp->count = kept;
+
+    if (kept > 0)
+      break;
+  }
+  return retval;
+}
+
 /* Find next tuple that passes the selection condition.
    -This assumes that the evaluation tree will alway s reduce to either 0 or 1
     all tuples. */
 db_int next_select(select_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
-  /* Create necessary result variable. */
-  db_int result, retval = 0;
-  while (1) {
-    /* Get next tuple from operator below. */
-    result = next(sp->child, next_tp, mmp);
-    /* Evaluate select eet on this tuple.
-       -Note that we can make the assumption that the header and
-        tuple arrays will be only one attribute big, hence why
-        the following code works. */
-    if (1 == result) {
-      retval =
-          evaluate_eet(sp->tree, &result, &next_tp, &(sp->base.header), 0, mmp);
-      if (1 == result && 1 == retval) {
-        break;
-      }
-    } else {
-      break;
-    }
+  db_tuple_t temp_t;
+  db_int result;
+
+  /* A folded predicate may not depend on the tuples at all. */
+  switch (evaluate_eet_constant(sp->tree, mmp)) {
+  case 0:
+    return 0;
+  case 1:
+    return next(sp->child, next_tp, mmp);
+  default:
+    break;
+  }
+
+  /* The condition is checked a batch of the child's tuples at a time, and
+     the tuples that pass are handed out one at a time from there.  The
+     batch keeps row offsets, since the rows a query finds are what an
+     UPDATE rewrites. */
+  if (sp->position >= sp->batch.count) {
+    if (1 != init_batch_select(sp, mmp))
+      return -1;
+    sp->position = 0;
+    sp->batch.count = 0;
+    result = select_fill(sp, &(sp->batch), sp->selected, mmp);
+    if (1 != result)
+      return result;
   }
-  return result;
+
+  viewbatchtuple(&(sp->batch), sp->position, &temp_t);
+  sp->position++;
+  copytupleisnull(next_tp, &temp_t, 0, 0, sp->batch.isnullsize);
+  copytuplebytes(next_tp, &temp_t, 0, 0,
+                 (db_int)(sp->base.header->tuple_size));
+  next_tp->offset_r = temp_t.offset_r;
+  return 1;
+}
+
+/* Find the next batch of tuples that pass the selection condition. */
+db_int next_batch_select(select_t *sp, db_tuplebatch_t *bp,
+                         db_query_mm_t *mmp) {
+  db_int retval;
+  db_uint8 *selected;
+
+  switch (evaluate_eet_constant(sp->tree, mmp)) {
+  case 0:
+    bp->count = 0;
+    return 0;
+  case 1:
+    return next_batch(sp->child, bp, mmp);
+  default:
+    break;
+  }
+
+  selected = DB_QMM_BALLOC(mmp, (size_t)((bp->capacity + 7) / 8));
+  if (NULL == selected)
+    return -1;
+  retval = select_fill(sp, bp, selected, mmp);
+  DB_QMM_BFREE(mmp, selected);
+  return retval;
 }
 
 /* Close the selection operator. */
 db_int close_select(select_t *sp, db_query_mm_t *mmp) {
-  /* For the time being, do nothing! */
+  if (NULL != sp->selected)
+    DB_QMM_BFREE(mmp, sp->selected);
+  sp->selected = NULL;
+  close_tuplebatch(&(sp->batch), mmp);
+  close_eetprog(&(sp->prog), mmp);
   return 1;
 }
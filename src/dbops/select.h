@@ -50,15 +50,44 @@ db_int init_select(select_t *sp,
 		db_op_base_t *child,
 		db_query_mm_t *mmp);
 
+/* Set up the selection operator's batch. */
+/**
+@brief		Set up the batch a selection operator keeps its child's
+		tuples in.
+@details	This is done by the first call to @ref next_select if it has
+		not been done already.  Doing it before any tuples are
+		fetched keeps the batch beneath the memory of the operators
+		below.
+@param		sp		A pointer to the selection operator.
+@param		mmp		A pointer to the per-query memory manager that
+				will be used to allocate memory for this query.
+@returns	@c 1 if the batch is set up, @c -1 otherwise.
+*/
+db_int init_batch_select(select_t *sp,
+		db_query_mm_t *mmp);
+
 /* Find next tuple that passes the selection condition. */
 /**
 @brief		Retrieve the next tuple from a selection operator.
 @details	This assumes that the filtering expression will always
-		reduce to either @c 0 or @c 1 (@c false / @c true).
+		reduce to either @c 0 or @c 1 (@c false / @c true).  The
+		expression is evaluated over a batch of the child's tuples at
+		a time, kept by the operator, and the tuples that pass are
+		returned one at a time from there.
 @see		For more information, reference @ref next.
 */
 db_int next_select(select_t *sp, db_tuple_t *next_tp, db_query_mm_t *mmp);
 
+/* Find the next batch of tuples that pass the selection condition. */
+/**
+@brief		Retrieve the next batch of tuples from a selection operator.
+@details	Batches are taken from the child and the tuples that do not
+		pass are removed, so a batch may come back less than full.
+@see		For more information, reference @ref next_batch.
+*/
+db_int next_batch_select(select_t *sp, db_tuplebatch_t *bp,
+		db_query_mm_t *mmp);
+
 /* Rewind the selection operator. */
 /**
 @brief		Rewind the selection operator.
@@ -0,0 +1,752 @@
+/******************************************************************************/
+/**
+@file		smjoin.c
+@author		Graeme Douglas
+@brief		Implementation of the sort-merge join operator.
+@see		For more information, reference @ref smjoin.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "smjoin.h"
+#include "../db_ctconf.h"
+#include "../dblogic/compare_tuple.h"
+#include "../dblogic/eet.h"
+#include "../dbmacros.h"
+#include "../dbstorage/dbstorage.h"
+#include "db_ops.h"
+#include <string.h>
+
+/* Sort-merge join operator states. */
+#define DB_SMJOIN_STATE_UNSTARTED 0
+#define DB_SMJOIN_STATE_MERGING 1
+
+/* Enough to hold "DB_SMJ_<id>". */
+#define DB_SMJOIN_NAMELENGTH 12
+
+/* Used to give each sort-merge join operator its own temporary file. */
+static db_uint8 db_smjoin_nextid = 0;
+
+static db_op_base_t *smjoin_windowchild(smjoin_t *jp) {
+  return jp->windowright ? jp->rchild : jp->lchild;
+}
+
+static db_op_base_t *smjoin_drivingchild(smjoin_t *jp) {
+  return jp->windowright ? jp->lchild : jp->rchild;
+}
+
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int smjoin_isnullsize(relation_header_t *hp) {
+  db_int size = ((db_int)(hp->num_attr)) / 8;
+  if (((db_int)(hp->num_attr)) % 8 > 0)
+    size++;
+  return size;
+}
+
+/* Number of bytes in a tuple record, nullity information included. */
+static db_int smjoin_recordsize(relation_header_t *hp) {
+  return smjoin_isnullsize(hp) + (db_int)(hp->tuple_size);
+}
+
+/* Point a tuple at a record so it can be read or written in place. */
+static void smjoin_viewrecord(relation_header_t *hp, db_tuple_t *tp,
+                              unsigned char *record) {
+  tp->isnull = (char *)record;
+  tp->bytes = (char *)(record + smjoin_isnullsize(hp));
+  tp->offset_r = 0;
+}
+
+static db_uint8 smjoin_keyisnull(db_tuple_t *tp, db_uint8 pos) {
+  return 0 != (tp->isnull[pos / 8] & (1 << (pos % 8)));
+}
+
+/* Compare the join attribute of a window tuple against one of the bounds
+   given by the current driving tuple. */
+static db_int8 smjoin_cmpbound(smjoin_t *jp, db_tuple_t *wtp, db_eet_t *bound,
+                               db_query_mm_t *mmp) {
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  return cmp_tuple(wtp, &(jp->dt), smjoin_windowchild(jp)->header,
+                   smjoin_drivingchild(jp)->header, jp->keyexpr, bound, 1,
+                   &order, 1, mmp);
+}
+
+/* Check if a window tuple is below the lower bound, in which case it cannot
+   join the current driving tuple or any that follow it.  Tuples that are
+   NULL on the join attribute always are. */
+static db_uint8 smjoin_belowlow(smjoin_t *jp, db_tuple_t *wtp,
+                                db_query_mm_t *mmp) {
+  db_int8 result = smjoin_cmpbound(jp, wtp, jp->lowexpr, mmp);
+  return result < 0 || (0 == result && jp->lowstrict);
+}
+
+/* Check if a window tuple is above the upper bound, in which case it cannot
+   join the current driving tuple, but might join one that follows it. */
+static db_uint8 smjoin_abovehigh(smjoin_t *jp, db_tuple_t *wtp,
+                                 db_query_mm_t *mmp) {
+  db_int8 result = smjoin_cmpbound(jp, wtp, jp->highexpr, mmp);
+  return result > 0 || (0 == result && jp->highstrict);
+}
+
+/* Find the lone attribute an expression bounding the window is made from.
+   Only expressions that never decrease as that attribute increases are
+   usable: the attribute itself, or the attribute plus or minus an integer
+   constant.  The expression is made up of the nodes from first to last. */
+static db_eetnode_attr_t *smjoin_boundattr(db_eetnode_t **nodes, db_int first,
+                                           db_int last) {
+  if (first == last && DB_EETNODE_ATTR == nodes[first]->type)
+    return (db_eetnode_attr_t *)nodes[first];
+  if (first + 2 != last)
+    return NULL;
+
+  if (DB_EETNODE_ATTR == nodes[first]->type &&
+      DB_EETNODE_CONST_DBINT == nodes[first + 1]->type &&
+      (DB_EETNODE_OP_ADD == nodes[last]->type ||
+       DB_EETNODE_OP_SUB == nodes[last]->type))
+    return (db_eetnode_attr_t *)nodes[first];
+  if (DB_EETNODE_CONST_DBINT == nodes[first]->type &&
+      DB_EETNODE_ATTR == nodes[first + 1]->type &&
+      DB_EETNODE_OP_ADD == nodes[last]->type)
+    return (db_eetnode_attr_t *)nodes[first + 1];
+  return NULL;
+}
+
+/* Work out how the comparison at node cmp bounds the window, taking one of
+   its operands to be a lone attribute of the window side, the bare
+   attribute, and the other to be the bound.  Returns the type of the
+   comparison as if the bare attribute were written on its left, or
+   DB_EETNODE_COUNT if the comparison cannot be used this way around. */
+static db_uint8 smjoin_bound(smjoin_t *jp, db_eetnode_t **nodes,
+                             db_int *starts, db_int cmp, db_uint8 bareleft,
+                             db_eetnode_attr_t **barepp,
+                             db_eetnode_attr_t **boundpp, db_int *firstp,
+                             db_int *lastp) {
+  db_int rlast = cmp - 1;
+  db_int llast = starts[rlast] - 1;
+  db_int barelast = bareleft ? llast : rlast;
+  db_uint8 type = nodes[cmp]->type;
+  relation_header_t *whp, *dhp;
+
+  *lastp = bareleft ? rlast : llast;
+  *firstp = starts[*lastp];
+  if (starts[barelast] != barelast ||
+      DB_EETNODE_ATTR != nodes[barelast]->type)
+    return DB_EETNODE_COUNT;
+
+  *barepp = (db_eetnode_attr_t *)nodes[barelast];
+  *boundpp = smjoin_boundattr(nodes, *firstp, *lastp);
+  if (NULL == *boundpp || 1 < (*barepp)->tuple_pos ||
+      1 - (*barepp)->tuple_pos != (*boundpp)->tuple_pos)
+    return DB_EETNODE_COUNT;
+
+  /* Strings can only be bounded by other strings, as they are. */
+  whp = 1 == (*barepp)->tuple_pos ? jp->rchild->header : jp->lchild->header;
+  dhp = 1 == (*barepp)->tuple_pos ? jp->lchild->header : jp->rchild->header;
+  if (whp->types[(*barepp)->pos] != dhp->types[(*boundpp)->pos] ||
+      (DB_INT != whp->types[(*barepp)->pos] &&
+       (DB_STRING != whp->types[(*barepp)->pos] || *firstp != *lastp)))
+    return DB_EETNODE_COUNT;
+
+  if (!bareleft) {
+    if (DB_EETNODE_OP_LT == type)
+      type = DB_EETNODE_OP_GT;
+    else if (DB_EETNODE_OP_GT == type)
+      type = DB_EETNODE_OP_LT;
+    else if (DB_EETNODE_OP_LTE == type)
+      type = DB_EETNODE_OP_GTE;
+    else if (DB_EETNODE_OP_GTE == type)
+      type = DB_EETNODE_OP_LTE;
+  }
+  return type;
+}
+
+/* Look through the comparisons for a lower and an upper bound on the
+   attribute at wpos of the window side, wside, both given by the attribute
+   at dpos of the driving side.  The nodes making up each bound are written
+   to bounds as first and last of the lower, then first and last of the
+   upper.  Returns 1 if both were found, 0 otherwise. */
+static db_uint8 smjoin_findbounds(smjoin_t *jp, db_eetnode_t **nodes,
+                                  db_int *starts, db_int *cmps,
+                                  db_int numcmps, db_uint8 wside,
+                                  db_uint8 wpos, db_uint8 dpos,
+                                  db_int *bounds) {
+  db_eetnode_attr_t *bare, *bound;
+  db_int i, first, last;
+  db_uint8 bareleft, type;
+
+  bounds[1] = -1;
+  bounds[3] = -1;
+  for (i = 0; i < numcmps; ++i) {
+    for (bareleft = 0; bareleft < 2; ++bareleft) {
+      type = smjoin_bound(jp, nodes, starts, cmps[i], bareleft, &bare, &bound,
+                          &first, &last);
+      if (DB_EETNODE_COUNT == type || wside != bare->tuple_pos ||
+          wpos != bare->pos || dpos != bound->pos)
+        continue;
+
+      if (bounds[1] < 0 &&
+          (DB_EETNODE_OP_GTE == type || DB_EETNODE_OP_GT == type ||
+           DB_EETNODE_OP_EQ == type)) {
+        bounds[0] = first;
+        bounds[1] = last;
+        jp->lowstrict = DB_EETNODE_OP_GT == type;
+      }
+      if (bounds[3] < 0 &&
+          (DB_EETNODE_OP_LTE == type || DB_EETNODE_OP_LT == type ||
+           DB_EETNODE_OP_EQ == type)) {
+        bounds[2] = first;
+        bounds[3] = last;
+        jp->highstrict = DB_EETNODE_OP_LT == type;
+      }
+      break;
+    }
+  }
+  return bounds[1] >= 0 && bounds[3] >= 0;
+}
+
+/* Copy the nodes from first to last into a new expression over a single
+   tuple. */
+static db_eet_t *smjoin_copyexpr(db_eetnode_t **nodes, db_int first,
+                                 db_int last, db_query_mm_t *mmp) {
+  db_eet_t *ep = DB_QMM_BALLOC(mmp, sizeof(db_eet_t));
+  db_eetnode_t *cursor;
+  if (NULL == ep)
+    return NULL;
+
+  /* The last node is always followed by the comparison using it. */
+  ep->size = POINTERBYTEDIST(nodes[last + 1], nodes[first]);
+  ep->stack_size = 2 * ep->size;
+  ep->nodes = DB_QMM_BALLOC(mmp, ep->size);
+  if (NULL == ep->nodes)
+    return NULL;
+  memcpy(ep->nodes, nodes[first], (size_t)(ep->size));
+
+  cursor = ep->nodes;
+  while (POINTERBYTEDIST(cursor, ep->nodes) < ep->size) {
+    if (DB_EETNODE_ATTR == cursor->type)
+      ((db_eetnode_attr_t *)cursor)->tuple_pos = 0;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  return ep;
+}
+
+static void smjoin_freeexpr(db_eet_t *ep, db_query_mm_t *mmp) {
+  if (NULL == ep)
+    return;
+  if (NULL != ep->nodes)
+    DB_QMM_BFREE(mmp, ep->nodes);
+  DB_QMM_BFREE(mmp, ep);
+}
+
+/* Find the bounds on the window in the join condition and set the operator
+   up to use them.  Returns 1 if it was, 0 if the condition or the order of
+   the children does not allow it, -1 on error. */
+static db_int smjoin_analyze(smjoin_t *jp, db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = jp->tree->nodes;
+  db_eetnode_t **nodes;
+  db_int *starts, *stack, *cmps;
+  db_eetnode_attr_t *bare, *bound;
+  db_int bounds[4], first, last;
+  db_int count = 0, top = 0, numcmps = 0, numvals, i;
+  db_uint8 bareleft, found = 0;
+
+  while (POINTERBYTEDIST(cursor, jp->tree->nodes) < jp->tree->size) {
+    count++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  nodes = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_eetnode_t *));
+  starts = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_int));
+  stack = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_int));
+  cmps = db_qmm_falloc(mmp, ((size_t)count) * sizeof(db_int));
+
+  /* The expression is in postfix order, so first recover where the
+     subexpression rooted at each node starts. */
+  cursor = jp->tree->nodes;
+  for (i = 0; NULL != nodes && NULL != starts && NULL != stack &&
+              NULL != cmps && i < count;
+       ++i) {
+    nodes[i] = cursor;
+    if ((db_uint8)DB_EETNODE_OP_UNARYNEG > cursor->type ||
+        (db_uint8)DB_EETNODE_PLACEHOLDER == cursor->type) {
+      starts[i] = i;
+    } else {
+      numvals = eet_numrequiredvals(cursor->type);
+      if (top < numvals) {
+        top = 0;
+        break;
+      }
+      top -= numvals;
+      starts[i] = stack[top];
+    }
+    stack[top++] = starts[i];
+    advanceeetnodepointer(&cursor, 1);
+  }
+
+  /* Then collect the comparisons joined to the rest of the condition only
+     by ANDs, left to right. */
+  if (1 == top) {
+    stack[0] = count - 1;
+    while (top > 0) {
+      i = stack[--top];
+      if (DB_EETNODE_OP_AND == nodes[i]->type) {
+        stack[top++] = i - 1;
+        stack[top++] = starts[i - 1] - 1;
+      } else if (DB_EETNODE_OP_LT == nodes[i]->type ||
+                 DB_EETNODE_OP_GT == nodes[i]->type ||
+                 DB_EETNODE_OP_LTE == nodes[i]->type ||
+                 DB_EETNODE_OP_GTE == nodes[i]->type ||
+                 DB_EETNODE_OP_EQ == nodes[i]->type) {
+        cmps[numcmps++] = i;
+      }
+    }
+  }
+
+  /* Let each comparison in turn decide which attributes to merge on. */
+  for (i = 0; !found && i < numcmps; ++i) {
+    for (bareleft = 0; !found && bareleft < 2; ++bareleft) {
+      if (DB_EETNODE_COUNT != smjoin_bound(jp, nodes, starts, cmps[i],
+                                           bareleft, &bare, &bound, &first,
+                                           &last) &&
+          1 == smjoin_findbounds(jp, nodes, starts, cmps, numcmps,
+                                 bare->tuple_pos, bare->pos, bound->pos,
+                                 bounds)) {
+        jp->windowright = bare->tuple_pos;
+        jp->dkey = bound->pos;
+        found = isorderedon(smjoin_windowchild(jp), bare->pos) &&
+                isorderedon(smjoin_drivingchild(jp), bound->pos);
+      }
+    }
+  }
+
+  if (found) {
+    jp->lowexpr = smjoin_copyexpr(nodes, bounds[0], bounds[1], mmp);
+    jp->highexpr = smjoin_copyexpr(nodes, bounds[2], bounds[3], mmp);
+    jp->keyexpr = DB_QMM_BALLOC(mmp, sizeof(db_eet_t));
+    if (NULL != jp->keyexpr) {
+      jp->keyexpr->size = sizeof(db_eetnode_attr_t);
+      jp->keyexpr->stack_size = 2 * sizeof(db_eetnode_attr_t);
+      jp->keyexpr->nodes = DB_QMM_BALLOC(mmp, sizeof(db_eetnode_attr_t));
+      if (NULL != jp->keyexpr->nodes) {
+        *((db_eetnode_attr_t *)(jp->keyexpr->nodes)) = *bare;
+        ((db_eetnode_attr_t *)(jp->keyexpr->nodes))->tuple_pos = 0;
+      }
+    }
+  }
+
+  if (NULL != cmps)
+    db_qmm_ffree(mmp, cmps);
+  if (NULL != stack)
+    db_qmm_ffree(mmp, stack);
+  if (NULL != starts)
+    db_qmm_ffree(mmp, starts);
+  if (NULL != nodes)
+    db_qmm_ffree(mmp, nodes);
+
+  if (found && (NULL == jp->lowexpr || NULL == jp->highexpr ||
+                NULL == jp->keyexpr || NULL == jp->keyexpr->nodes))
+    return -1;
+  return found ? 1 : 0;
+}
+
+static void smjoin_filename(smjoin_t *jp, char *name) {
+  sprintf(name, "DB_SMJ_%d", (int)(jp->smid));
+}
+
+/* Read a tuple record from the spill file.  Returns 1 if a record was read,
+   -1 otherwise. */
+static db_int smjoin_readrecord(db_fileref_t f, db_tuple_t *tp,
+                                relation_header_t *hp) {
+  size_t isnullsize = (size_t)smjoin_isnullsize(hp);
+  if (isnullsize != db_fileread(f, (unsigned char *)tp->isnull, isnullsize) ||
+      (size_t)(hp->tuple_size) !=
+          db_fileread(f, (unsigned char *)tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+static db_int smjoin_writerecord(db_fileref_t f, db_tuple_t *tp,
+                                 relation_header_t *hp) {
+  size_t isnullsize = (size_t)smjoin_isnullsize(hp);
+  if (isnullsize != db_filewrite(f, tp->isnull, isnullsize) ||
+      (size_t)(hp->tuple_size) !=
+          db_filewrite(f, tp->bytes, (size_t)(hp->tuple_size)))
+    return -1;
+  return 1;
+}
+
+/* Move to a record of the spill file.  The file is both read and written,
+   so this must come between any read and write. */
+static void smjoin_seekspill(smjoin_t *jp, db_int record) {
+  db_filerewind(jp->spill);
+  db_fileseek(jp->spill,
+              (size_t)(record *
+                       smjoin_recordsize(smjoin_windowchild(jp)->header)));
+}
+
+/* Number of tuple records in the window. */
+static db_int smjoin_windowsize(smjoin_t *jp) {
+  return (jp->num_records - jp->head) + (jp->spill_count - jp->spill_head);
+}
+
+/* Number of window tuple records that fit in the query memory right now.
+   One more is kept spare for reading back the spill file. */
+static db_int smjoin_capacity(smjoin_t *jp, db_query_mm_t *mmp) {
+  db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+  if (NULL != jp->tree)
+    reserve += jp->tree->stack_size;
+  reserve += jp->keyexpr->stack_size + jp->lowexpr->stack_size +
+             jp->highexpr->stack_size + (db_int)sizeof(db_int);
+
+  db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+  if (avail < reserve)
+    return 0;
+  return (avail - reserve) /
+             smjoin_recordsize(smjoin_windowchild(jp)->header) -
+         1;
+}
+
+/* Add the tuple read ahead from the window child to the back of the
+   window.  Records only go in memory while none are waiting on storage, so
+   the window stays in order. */
+static db_int smjoin_push(smjoin_t *jp, db_query_mm_t *mmp) {
+  relation_header_t *hp = smjoin_windowchild(jp)->header;
+  db_int recsize = smjoin_recordsize(hp);
+  char name[DB_SMJOIN_NAMELENGTH];
+  db_tuple_t t;
+
+  /* Memory is only taken once the children have taken theirs. */
+  if (NULL == jp->records) {
+    jp->capacity = smjoin_capacity(jp, mmp);
+    if (jp->capacity < 1)
+      return -1;
+    jp->records = db_qmm_balloc(mmp, (size_t)((jp->capacity + 1) * recsize));
+    if (NULL == jp->records)
+      return -1;
+  }
+
+  if (0 == jp->spill_count) {
+    if (jp->num_records == jp->capacity && jp->head > 0) {
+      memmove(jp->records, jp->records + jp->head * recsize,
+              (size_t)((jp->num_records - jp->head) * recsize));
+      jp->num_records -= jp->head;
+      jp->head = 0;
+    }
+    if (jp->num_records < jp->capacity) {
+      smjoin_viewrecord(hp, &t, jp->records + jp->num_records * recsize);
+      memcpy(t.isnull, jp->wt.isnull, (size_t)smjoin_isnullsize(hp));
+      memcpy(t.bytes, jp->wt.bytes, (size_t)(hp->tuple_size));
+      jp->num_records++;
+      return 1;
+    }
+
+    if (DB_STORAGE_NOFILE == jp->spill) {
+      smjoin_filename(jp, name);
+      db_fileremove(name);
+      jp->spill = db_openwritefile(name);
+      if (DB_STORAGE_NOFILE == jp->spill)
+        return -1;
+      db_fileclose(jp->spill);
+      jp->spill = db_openreadfile_plus(name);
+      if (DB_STORAGE_NOFILE == jp->spill)
+        return -1;
+    }
+  }
+
+  smjoin_seekspill(jp, jp->spill_count);
+  if (1 != smjoin_writerecord(jp->spill, &(jp->wt), hp))
+    return -1;
+  jp->spill_count++;
+  return 1;
+}
+
+/* Drop the tuples below the lower bound from the front of the window. */
+static db_int smjoin_dropfront(smjoin_t *jp, db_query_mm_t *mmp) {
+  relation_header_t *hp = smjoin_windowchild(jp)->header;
+  db_int recsize = smjoin_recordsize(hp);
+  db_tuple_t t;
+
+  while (1) {
+    if (jp->head < jp->num_records) {
+      smjoin_viewrecord(hp, &t, jp->records + jp->head * recsize);
+      if (!smjoin_belowlow(jp, &t, mmp))
+        return 1;
+      jp->head++;
+    } else if (jp->spill_head < jp->spill_count) {
+      /* Memory has emptied, so bring in the next records from storage. */
+      jp->head = 0;
+      jp->num_records = 0;
+      smjoin_seekspill(jp, jp->spill_head);
+      while (jp->num_records < jp->capacity &&
+             jp->spill_head < jp->spill_count) {
+        smjoin_viewrecord(hp, &t, jp->records + jp->num_records * recsize);
+        if (1 != smjoin_readrecord(jp->spill, &t, hp))
+          return -1;
+        jp->num_records++;
+        jp->spill_head++;
+      }
+      if (jp->spill_head == jp->spill_count) {
+        jp->spill_head = 0;
+        jp->spill_count = 0;
+      }
+    } else {
+      jp->head = 0;
+      jp->num_records = 0;
+      return 1;
+    }
+  }
+}
+
+/* Read tuples from the window child onto the back of the window until one is
+   above the upper bound. */
+static db_int smjoin_fillback(smjoin_t *jp, db_query_mm_t *mmp) {
+  db_op_base_t *window = smjoin_windowchild(jp);
+  db_int result;
+
+  while (jp->wvalid && !smjoin_abovehigh(jp, &(jp->wt), mmp)) {
+    if (!smjoin_belowlow(jp, &(jp->wt), mmp) && 1 != smjoin_push(jp, mmp))
+      return -1;
+
+    result = next(window, &(jp->wt), mmp);
+    if (-1 == result)
+      return -1;
+    jp->wvalid = 1 == result;
+  }
+  return 1;
+}
+
+/* Fetch the next driving tuple that is not NULL on the join attribute and
+   slide the window along to it.  Returns 1 if there was one, 0 if there are
+   no more that could join, -1 on error. */
+static db_int smjoin_nextdriving(smjoin_t *jp, db_query_mm_t *mmp) {
+  db_op_base_t *driving = smjoin_drivingchild(jp);
+  db_int result;
+
+  jp->dvalid = 0;
+  jp->match = 0;
+  do {
+    /* Nothing is left to join with. */
+    if (!(jp->wvalid) && 0 == smjoin_windowsize(jp))
+      return 0;
+
+    result = next(driving, &(jp->dt), mmp);
+    if (1 != result)
+      return result;
+  } while (smjoin_keyisnull(&(jp->dt), jp->dkey));
+
+  if (1 != smjoin_dropfront(jp, mmp) || 1 != smjoin_fillback(jp, mmp))
+    return -1;
+  jp->dvalid = 1;
+  return 1;
+}
+
+/* Write out the joined tuple of a left and a right tuple. */
+static void smjoin_combine(smjoin_t *jp, db_tuple_t *next_tp, db_tuple_t *lt,
+                           db_tuple_t *rt) {
+  copytuplebytes(next_tp, lt, 0, 0, jp->lchild->header->tuple_size);
+  copytupleisnull(next_tp, lt, 0, 0, smjoin_isnullsize(jp->lchild->header));
+
+  /* Write out right tuples bytes directly after left tuples bytes. */
+  copytuplebytes(next_tp, rt, jp->lchild->header->tuple_size, 0,
+                 jp->rchild->header->tuple_size);
+
+  /* Write out right tuples isnull into new tuple. */
+  db_int i;
+  db_int j = (db_int)(jp->lchild->header->num_attr);
+  for (i = 0; i < (db_int)(jp->rchild->header->num_attr); ++i) {
+    /* If this bit is 0 ... */
+    if (0 == (rt->isnull[i / 8] & (1 << (i % 8)))) {
+      next_tp->isnull[j / 8] &= ~(1 << (j % 8));
+    } else {
+      next_tp->isnull[j / 8] |= (1 << (j % 8));
+    }
+    j++;
+  }
+}
+
+/* Initialize the operator. */
+db_int init_smjoin(smjoin_t *jp, db_eet_t *ep, db_op_base_t *lchild,
+                   db_op_base_t *rchild, db_query_mm_t *mmp) {
+  init_ntjoin((ntjoin_t *)jp, ep, lchild, rchild, mmp);
+  return setup_smjoin(jp, mmp);
+}
+
+/* Setup a sort-merge join from a nested tuple join. */
+db_int setup_smjoin(smjoin_t *jp, db_query_mm_t *mmp) {
+  if (NULL == jp->tree || NULL == jp->tree->nodes)
+    return 0;
+
+  jp->keyexpr = NULL;
+  jp->lowexpr = NULL;
+  jp->highexpr = NULL;
+  if (1 != smjoin_analyze(jp, mmp)) {
+    smjoin_freeexpr(jp->keyexpr, mmp);
+    smjoin_freeexpr(jp->highexpr, mmp);
+    smjoin_freeexpr(jp->lowexpr, mmp);
+    return 0;
+  }
+
+  /* The driving tuple takes the place of the nested-tuple join's left
+     tuple. */
+  if (!(jp->windowright)) {
+    close_tuple(&(jp->dt), mmp);
+    init_tuple(&(jp->dt), jp->rchild->header->tuple_size,
+               jp->rchild->header->num_attr, mmp);
+  }
+  init_tuple(&(jp->wt), smjoin_windowchild(jp)->header->tuple_size,
+             smjoin_windowchild(jp)->header->num_attr, mmp);
+  rewind_dbop(jp->lchild, mmp);
+
+  jp->dvalid = 0;
+  jp->wvalid = 0;
+  jp->records = NULL;
+  jp->spill = DB_STORAGE_NOFILE;
+  jp->capacity = 0;
+  jp->head = 0;
+  jp->num_records = 0;
+  jp->spill_head = 0;
+  jp->spill_count = 0;
+  jp->match = 0;
+  jp->smid = db_smjoin_nextid++;
+  jp->state = DB_SMJOIN_STATE_UNSTARTED;
+  jp->base.type = DB_SMJOIN;
+  return 1;
+}
+
+/* Re-start the operator from the beginning. This assumes the operator has
+ * been initialized. */
+db_int rewind_smjoin(smjoin_t *jp, db_query_mm_t *mmp) {
+  rewind_dbop(jp->lchild, mmp);
+  rewind_dbop(jp->rchild, mmp);
+
+  /* Any memory and spill file are kept for reuse. */
+  jp->dvalid = 0;
+  jp->wvalid = 0;
+  jp->head = 0;
+  jp->num_records = 0;
+  jp->spill_head = 0;
+  jp->spill_count = 0;
+  jp->match = 0;
+  jp->state = DB_SMJOIN_STATE_UNSTARTED;
+  return 1;
+}
+
+/* Find next tuple that passes the join condition.
+   -This assumes that the evaluation tree will always reduce to either 0 or 1
+    for all tuples.
+   -The algorithm used is the following:
+                while dt is a valid tuple from the driving side
+                        for each tuple wt in the window
+                                if wt joins dt
+                                        return joined tuple
+                        dt <- next tuple from the driving side
+                        drop tuples below dt's lower bound from the window
+                        add tuples up to dt's upper bound to the window
+*/
+db_int next_smjoin(smjoin_t *jp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  /* Create necessary result variable. */
+  db_int result = 0, retval, memcount;
+  relation_header_t *whp = smjoin_windowchild(jp)->header;
+  db_int recsize = smjoin_recordsize(whp);
+  db_tuple_t t;
+
+  /* Build arrays to be passed to eet evaluation engine. */
+  relation_header_t *hpa[2];
+  hpa[0] = jp->lchild->header;
+  hpa[1] = jp->rchild->header;
+  db_tuple_t *tpa[2];
+  if (jp->windowright) {
+    tpa[0] = &(jp->dt);
+    tpa[1] = &t;
+  } else {
+    tpa[0] = &t;
+    tpa[1] = &(jp->dt);
+  }
+
+  if (DB_SMJOIN_STATE_UNSTARTED == jp->state) {
+    retval = next(smjoin_windowchild(jp), &(jp->wt), mmp);
+    if (-1 == retval)
+      return -1;
+    jp->wvalid = 1 == retval;
+    jp->state = DB_SMJOIN_STATE_MERGING;
+
+    retval = smjoin_nextdriving(jp, mmp);
+    if (1 != retval)
+      return retval;
+  }
+
+  while (1) {
+    while (1 == jp->dvalid && jp->match < smjoin_windowsize(jp)) {
+      memcount = jp->num_records - jp->head;
+      if (jp->match < memcount) {
+        smjoin_viewrecord(whp, &t,
+                          jp->records + (jp->head + jp->match) * recsize);
+      } else {
+        /* The back of the window is read from storage in order. */
+        if (jp->match == memcount)
+          smjoin_seekspill(jp, jp->spill_head);
+        smjoin_viewrecord(whp, &t, jp->records + jp->capacity * recsize);
+        if (1 != smjoin_readrecord(jp->spill, &t, whp))
+          return -1;
+      }
+      jp->match++;
+
+      /* The rest of the join condition must hold too. */
+      retval = evaluate_eet(jp->tree, &result, tpa, hpa, 0, mmp);
+      if (1 == result && 1 == retval) {
+        smjoin_combine(jp, next_tp, tpa[0], tpa[1]);
+        return 1;
+      }
+    }
+
+    retval = smjoin_nextdriving(jp, mmp);
+    if (1 != retval)
+      return retval;
+  }
+}
+
+/* Close the operator. */
+db_int close_smjoin(smjoin_t *jp, db_query_mm_t *mmp) {
+  char name[DB_SMJOIN_NAMELENGTH];
+
+  if (DB_STORAGE_NOFILE != jp->spill) {
+    db_fileclose(jp->spill);
+    jp->spill = DB_STORAGE_NOFILE;
+    smjoin_filename(jp, name);
+    db_fileremove(name);
+  }
+  if (NULL != jp->records)
+    db_qmm_bfree(mmp, jp->records);
+  jp->records = NULL;
+  jp->state = DB_SMJOIN_STATE_UNSTARTED;
+
+  close_tuple(&(jp->wt), mmp);
+  close_tuple(&(jp->dt), mmp);
+  smjoin_freeexpr(jp->keyexpr, mmp);
+  smjoin_freeexpr(jp->highexpr, mmp);
+  smjoin_freeexpr(jp->lowexpr, mmp);
+
+  /* Free all header properties that were allocated */
+  DB_QMM_BFREE(mmp, jp->base.header->size_name);
+  DB_QMM_BFREE(mmp, jp->base.header->names);
+  DB_QMM_BFREE(mmp, jp->base.header->types);
+  DB_QMM_BFREE(mmp, jp->base.header->offsets);
+  DB_QMM_BFREE(mmp, jp->base.header->sizes);
+
+  /* Free the header itself. */
+  DB_QMM_BFREE(mmp, jp->base.header);
+
+  return 1;
+}
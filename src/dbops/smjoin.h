@@ -0,0 +1,111 @@
+/******************************************************************************/
+/**
+@file		smjoin.h
+@author		Graeme Douglas
+@brief		The relational equi-join and band join, implemented as a
+		sort-merge join.
+@details	A join over two inputs already ordered on their join
+		attributes, such as indexed relations or sorted results.  Each
+		input is read exactly once.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef SMJOIN_H
+#define SMJOIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "db_ops_types.h"
+#include "../dbobjects/relation.h"
+#include "../dbobjects/tuple.h"
+#include <stdio.h>
+
+/* Initialize the operator. */
+/**
+@brief		Attempt to initialize a sort-merge join.
+@details	This first initializes an @ref ntjoin_t object, then tries
+		to convert it to a @ref smjoin_t object.  If this method
+		returns @c 0, the operator still functions as a nested-tuple
+		join.
+@param		jp	A pointer to the join object to initialize.
+@param		ep	A pointer to the join expression to initalize on.
+@param		lchild	A pointer to the left child of the join operator.
+@param		rchild	A pointer to the right child of the join operator.
+@param		mmp	A pointer to the memory manager instance variable
+			used to allocate memory for this query.
+@returns	@c 1 if a sort-merge join was properly initialized, @c 0
+		otherwise.
+@see		For more information, reference @ref setup_smjoin.
+*/
+db_int init_smjoin(smjoin_t *jp,
+		db_eet_t *ep,
+		db_op_base_t *lchild,
+		db_op_base_t *rchild,
+		db_query_mm_t *mmp);
+
+/* Setup a sort-merge join from a nested tuple join. */
+/**
+@brief		Convert a nested-tuple join into a sort-merge join.
+@details	The join condition must contain, as top-level conjuncts, a
+		lower and an upper bound on an attribute of one child, each
+		given by the other child's join attribute, possibly plus or
+		minus an integer constant.  An equality between two attributes
+		of the same integer or string type is both bounds at once.
+		Both children must be known to produce their tuples in
+		ascending order of their join attribute, as determined by
+		@ref isorderedon.
+@param		jp	A pointer to an already initialized instance
+			of an @ref ntjoin_t object, with enough space to hold a
+			@ref smjoin_t object.  If this method returns @c 0,
+			it is fine to assume that the object will still function
+			as an @ref ntjoin_t operator.
+@param		mmp	A pointer to the memory manager instance variable
+			that will be used for allocating memory in this
+			query.
+@returns	@c 1 if @c jp was converted, @c 0 otherwise.
+*/
+db_int setup_smjoin(smjoin_t *jp, db_query_mm_t *mmp);
+
+/* Re-start the operator from the beginning. This assumes the operator has
+   been initialized. */
+/**
+@brief		Rewind a sort-merge join operator.
+@see		For more information, please reference @ref rewind_dbop.
+*/
+db_int rewind_smjoin(smjoin_t *jp, db_query_mm_t *mmp);
+
+/* Find next tuple that passes the join condition. */
+/**
+@brief		Produce the next tuple from a sort-merge join operator.
+@see		For more information, please reference @ref next.
+*/
+db_int next_smjoin(smjoin_t *jp, db_tuple_t *next_tp, db_query_mm_t *mmp);
+
+/* Close the operator. */
+/**
+@brief		Cleanly deconstruct a sort-merge join operator, removing any
+		temporary file it created.
+@see		For more information, please reference @ref close.
+*/
+db_int close_smjoin(smjoin_t *jp, db_query_mm_t *mmp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
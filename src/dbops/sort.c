@@ -24,6 +24,542 @@
 #include "sort.h"
 #include "db_ops.h"
 #include "../dblogic/compare_tuple.h"
+#include "../dbstorage/dbstorage.h"
+#include "../dbmacros.h"
+#include "../db_ctconf.h"
+#include <string.h>
+
+/* Sort operator states. */
+#define DB_SORT_STATE_UNSORTED	0
+#define DB_SORT_STATE_INMEMORY	1
+#define DB_SORT_STATE_ONDISK	2	/* Plus the number of the temporary
+					   file that holds the runs. */
+
+/* Most runs that will be merged at once. */
+#define DB_SORT_MAXWAYS		255
+
+/* Enough to hold "DB_SORT_<id>_<file>". */
+#define DB_SORT_NAMELENGTH	16
+
+/* Used to give each sort operator its own temporary files. */
+static db_uint8 db_sort_nextid = 0;
+
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int sort_isnullsize(sort_t *sp)
+{
+	db_int size = ((db_int)(sp->base.header->num_attr)) / 8;
+	if (((db_int)(sp->base.header->num_attr)) % 8 > 0)
+		size++;
+	return size;
+}
+
+/* Number of bytes in a tuple record, sort key and nullity information
+   included. */
+static db_int sort_recordsize(sort_t *sp)
+{
+	return sp->keysize + sort_isnullsize(sp) +
+		(db_int)(sp->base.header->tuple_size);
+}
+
+/* Point a tuple at a record so it can be read or written in place. */
+static void sort_viewrecord(sort_t *sp, db_tuple_t *tp, unsigned char *record)
+{
+	tp->isnull = (char*)(record + sp->keysize);
+	tp->bytes = (char*)(record + sp->keysize + sort_isnullsize(sp));
+	tp->offset_r = 0;
+}
+
+/* Number of bytes an expression takes up in the sort key, or 0 if its
+   values can't be put in one.  Each value is led by a byte that is 0 if
+   it is NULL, so NULLs come first, as in cmp_tuple. */
+static db_int sort_keywidth(sort_t *sp, db_int i, db_int *typep,
+		db_query_mm_t *mmp)
+{
+	db_eet_t *eetp = &(sp->sort_exprs[i]);
+	db_int type = evaluate_eet(eetp, NULL, NULL, &(sp->base.header), 0,
+			mmp);
+	*typep = type;
+	
+	if (DB_EETNODE_CONST_DBINT == type)
+	{
+		return 1 + (db_int)sizeof(db_int);
+	}
+	/* Only a string attribute's values are known to fit. */
+	else if (DB_EETNODE_CONST_DBSTRING == type &&
+		sizeof(db_eetnode_attr_t) == eetp->size &&
+		DB_EETNODE_ATTR == eetp->nodes->type)
+	{
+		return 1 + (db_int)(sp->base.header->sizes[
+			((db_eetnode_attr_t*)(eetp->nodes))->pos]);
+	}
+	return 0;
+}
+
+/* Write the sort key of a record's tuple to the front of the record, so
+   that records compare the same under memcmp as under cmp_tuple.  Integers
+   are written most significant byte first with the sign bit flipped,
+   strings are padded with zeros and descending values have every bit
+   flipped. */
+static db_int sort_makekey(sort_t *sp, unsigned char *record,
+		db_query_mm_t *mmp)
+{
+	unsigned char *key = record;
+	db_tuple_t t, *tp = &t;
+	db_int i, j, width, type, result;
+	db_int intvalue;
+	db_uint32 bits;
+	char *strvalue;
+	
+	sort_viewrecord(sp, &t, record);
+	for (i = 0; i < (db_int)(sp->num_expr); ++i)
+	{
+		width = sort_keywidth(sp, i, &type, mmp);
+		memset(key, 0, (size_t)width);
+		if (DB_EETNODE_CONST_DBINT == type)
+		{
+			result = evaluate_eet(&(sp->sort_exprs[i]), &intvalue,
+				&tp, &(sp->base.header), 0, mmp);
+			if (1 == result)
+			{
+				key[0] = 1;
+				bits = ((db_uint32)intvalue) ^
+					(((db_uint32)1) << (8*sizeof(db_int)-1));
+				for (j = (db_int)sizeof(db_int); j > 0; --j)
+				{
+					key[j] = (unsigned char)(bits & 0xff);
+					bits >>= 8;
+				}
+			}
+		}
+		else
+		{
+			result = evaluate_eet(&(sp->sort_exprs[i]), &strvalue,
+				&tp, &(sp->base.header), 0, mmp);
+			if (1 == result)
+			{
+				key[0] = 1;
+				for (j = 1; j < width && '\0' != strvalue[j-1]; ++j)
+					key[j] = (unsigned char)(strvalue[j-1]);
+			}
+		}
+		if (-1 == result)
+			return -1;
+		
+		if (DB_TUPLE_ORDER_DESC == sp->order[i])
+		{
+			for (j = 0; j < width; ++j)
+				key[j] = ~key[j];
+		}
+		key += width;
+	}
+	return 1;
+}
+
+/* Number of bytes of query memory the sort may use right now. */
+static db_int sort_freebytes(sort_t *sp, db_query_mm_t *mmp)
+{
+	db_int i;
+	db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+	for (i = 0; i < (db_int)(sp->num_expr); ++i)
+	{
+		reserve += sp->sort_exprs[i].stack_size;
+	}
+	
+	db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+	if (avail < reserve)
+		return 0;
+	return avail - reserve;
+}
+
+static db_int8 sort_cmprecords(sort_t *sp, unsigned char *a, unsigned char *b,
+		db_query_mm_t *mmp)
+{
+	db_tuple_t ta, tb;
+	sort_viewrecord(sp, &ta, a);
+	sort_viewrecord(sp, &tb, b);
+	if (0 == sp->keysize)
+		return cmp_tuple(&ta, &tb, sp->base.header, sp->base.header,
+			sp->sort_exprs, sp->sort_exprs, sp->num_expr,
+			sp->order, 0, mmp);
+	
+	/* Keys only tie when the expressions do, so the rest of the tuples
+	   are compared just as cmp_tuple would. */
+	int result = memcmp(a, b, (size_t)(sp->keysize));
+	if (result < 0)
+		return -1;
+	else if (result > 0)
+		return 1;
+	return cmp_tuple(&ta, &tb, sp->base.header, sp->base.header, NULL,
+		NULL, 0, sp->order, 0, mmp);
+}
+
+static void sort_swaprecords(unsigned char *a, unsigned char *b, db_int size)
+{
+	unsigned char temp;
+	for (; size > 0; --size, ++a, ++b)
+	{
+		temp = *a;
+		*a = *b;
+		*b = temp;
+	}
+}
+
+/* Move a record down a max-heap of records until the heap is valid again. */
+static void sort_siftdown(sort_t *sp, unsigned char *records, db_int root,
+		db_int count, db_query_mm_t *mmp)
+{
+	db_int recsize = sort_recordsize(sp);
+	db_int child;
+	while ((child = 2*root + 1) < count)
+	{
+		if (child + 1 < count &&
+			sort_cmprecords(sp, records + child*recsize,
+				records + (child+1)*recsize, mmp) < 0)
+		{
+			child++;
+		}
+		if (sort_cmprecords(sp, records + root*recsize,
+				records + child*recsize, mmp) >= 0)
+		{
+			return;
+		}
+		sort_swaprecords(records + root*recsize,
+				records + child*recsize, recsize);
+		root = child;
+	}
+}
+
+/* Heapsort an array of records in place.  No memory beyond the records
+   themselves is required, which is what we want when every byte of the
+   query memory is already being used to hold tuples. */
+static void sort_records(sort_t *sp, unsigned char *records, db_int count,
+		db_query_mm_t *mmp)
+{
+	db_int recsize = sort_recordsize(sp);
+	db_int i;
+	for (i = count/2 - 1; i >= 0; --i)
+	{
+		sort_siftdown(sp, records, i, count, mmp);
+	}
+	for (i = count - 1; i > 0; --i)
+	{
+		sort_swaprecords(records, records + i*recsize, recsize);
+		sort_siftdown(sp, records, 0, i, mmp);
+	}
+}
+
+static void sort_filename(sort_t *sp, db_uint8 which, char *name)
+{
+	sprintf(name, "DB_SORT_%d_%d", (int)(sp->sortid), (int)which);
+}
+
+/* Number of runs currently on disk. */
+static db_int sort_numruns(sort_t *sp)
+{
+	return (sp->num_tuples + sp->run_length - 1) / sp->run_length;
+}
+
+/* Allocate space to merge some number of runs at once. */
+static db_int sort_allocways(sort_t *sp, db_int ways, db_query_mm_t *mmp)
+{
+	/* Allocate the arrays before the records, so they stay aligned. */
+	sp->runs = db_qmm_balloc(mmp, ways*sizeof(db_fileref_t));
+	sp->remaining = db_qmm_balloc(mmp, ways*sizeof(db_int));
+	sp->buffer = db_qmm_balloc(mmp, ways*sort_recordsize(sp));
+	if (NULL == sp->runs || NULL == sp->remaining || NULL == sp->buffer)
+		return -1;
+	return 1;
+}
+
+static void sort_freebuffers(sort_t *sp, db_query_mm_t *mmp)
+{
+	if (NULL != sp->buffer)
+		db_qmm_bfree(mmp, sp->buffer);
+	if (NULL != sp->remaining)
+		db_qmm_bfree(mmp, sp->remaining);
+	if (NULL != sp->runs)
+		db_qmm_bfree(mmp, sp->runs);
+	sp->buffer = NULL;
+	sp->remaining = NULL;
+	sp->runs = NULL;
+}
+
+/* Open up to ways runs, starting at run first, and read in the first
+   record of each. */
+static db_int sort_openways(sort_t *sp, db_uint8 which, db_int first,
+		db_int ways)
+{
+	db_int recsize = sort_recordsize(sp);
+	char name[DB_SORT_NAMELENGTH];
+	db_int i, start;
+	
+	sort_filename(sp, which, name);
+	sp->num_ways = 0;
+	for (i = 0; i < ways; ++i)
+	{
+		start = (first + i) * sp->run_length;
+		if (start >= sp->num_tuples)
+			break;
+		
+		sp->runs[i] = db_openreadfile(name);
+		if (DB_STORAGE_NOFILE == sp->runs[i])
+			return -1;
+		sp->num_ways++;
+		
+		db_fileseek(sp->runs[i], ((size_t)start)*((size_t)recsize));
+		sp->remaining[i] = sp->num_tuples - start;
+		if (sp->remaining[i] > sp->run_length)
+			sp->remaining[i] = sp->run_length;
+		if ((size_t)recsize != db_fileread(sp->runs[i],
+				sp->buffer + i*recsize, (size_t)recsize))
+			return -1;
+	}
+	return 1;
+}
+
+static void sort_closeways(sort_t *sp)
+{
+	db_int i;
+	for (i = 0; i < (db_int)(sp->num_ways); ++i)
+	{
+		db_fileclose(sp->runs[i]);
+	}
+	sp->num_ways = 0;
+}
+
+/* Find the way whose current record comes first, or -1 if all are empty. */
+static db_int sort_minway(sort_t *sp, db_query_mm_t *mmp)
+{
+	db_int recsize = sort_recordsize(sp);
+	db_int i, min = -1;
+	for (i = 0; i < (db_int)(sp->num_ways); ++i)
+	{
+		if (sp->remaining[i] > 0 && (min < 0 ||
+			sort_cmprecords(sp, sp->buffer + i*recsize,
+				sp->buffer + min*recsize, mmp) < 0))
+		{
+			min = i;
+		}
+	}
+	return min;
+}
+
+/* Drop the current record of a way and read in its next, if any. */
+static db_int sort_advanceway(sort_t *sp, db_int way)
+{
+	db_int recsize = sort_recordsize(sp);
+	sp->remaining[way]--;
+	if (sp->remaining[way] > 0 && (size_t)recsize !=
+		db_fileread(sp->runs[way], sp->buffer + way*recsize,
+			(size_t)recsize))
+	{
+		return -1;
+	}
+	return 1;
+}
+
+/* Read the child's tuples into memory as sorted runs.  If they don't all
+   fit, the runs are written one after another into the first temporary
+   file. */
+static db_int sort_makeruns(sort_t *sp, db_query_mm_t *mmp)
+{
+	db_int recsize = sort_recordsize(sp);
+	db_int capacity, count, result;
+	db_fileref_t out = DB_STORAGE_NOFILE;
+	char name[DB_SORT_NAMELENGTH];
+	db_tuple_t t;
+	unsigned char *first;
+	
+	/* A child such as an aggregate only takes its memory once it is
+	   asked for a tuple, so the first tuple is read into a record of its
+	   own before the sort takes what is left. */
+	first = db_qmm_balloc(mmp, recsize);
+	if (NULL == first)
+		return -1;
+	sort_viewrecord(sp, &t, first);
+	result = next(sp->child, &t, mmp);
+	if (-1 == result || (1 == result && sp->keysize > 0 &&
+		1 != sort_makekey(sp, first, mmp)))
+	{
+		db_qmm_bfree(mmp, first);
+		return -1;
+	}
+	
+	/* If the child took nothing, the record is grown into the buffer.
+	   Otherwise, it is copied to the start of the buffer, leaving a gap
+	   that is given back along with the buffer. */
+	if (POINTERATNBYTES(first, -1*((db_int)sizeof(db_int)), void*) ==
+		mmp->last_back)
+	{
+		capacity = sort_freebytes(sp, mmp) / recsize + 1;
+		/* Even the smallest merge needs room for two records. */
+		if (capacity < 2)
+		{
+			db_qmm_bfree(mmp, first);
+			return -1;
+		}
+		sp->buffer = db_qmm_bextend(mmp, (capacity-1)*recsize);
+		memmove(sp->buffer, sp->buffer + (capacity-1)*recsize, recsize);
+	}
+	else
+	{
+		capacity = (sort_freebytes(sp, mmp) - (db_int)sizeof(db_int)) /
+				recsize;
+		sp->buffer = capacity < 2 ? NULL :
+				db_qmm_balloc(mmp, capacity*recsize);
+		if (NULL != sp->buffer)
+			memcpy(sp->buffer, first, recsize);
+		db_qmm_bfree(mmp, first);
+		if (NULL == sp->buffer)
+			return -1;
+	}
+	sp->num_tuples = 0;
+	sp->run_length = capacity;
+	count = 1 == result ? 1 : 0;
+	
+	do
+	{
+		while (1 == result && count < capacity)
+		{
+			sort_viewrecord(sp, &t, sp->buffer + count*recsize);
+			result = next(sp->child, &t, mmp);
+			if (1 != result)
+				break;
+			if (sp->keysize > 0 && 1 != sort_makekey(sp,
+				sp->buffer + count*recsize, mmp))
+			{
+				result = -1;
+				break;
+			}
+			count++;
+		}
+		if (-1 == result)
+			break;
+		
+		sort_records(sp, sp->buffer, count, mmp);
+		sp->num_tuples += count;
+		
+		/* Everything fit, so no need to touch storage.  Give back
+		   the memory the tuples didn't use, if we can. */
+		if (0 == result && DB_STORAGE_NOFILE == out)
+		{
+			if (POINTERATNBYTES(sp->buffer, -1*((db_int)sizeof(db_int)), void*)
+				== mmp->last_back && count < capacity)
+			{
+				memmove(sp->buffer + (capacity-count)*recsize,
+					sp->buffer, count*recsize);
+				sp->buffer = db_qmm_bextend(mmp,
+					-1*(capacity-count)*recsize);
+			}
+			sp->run_length = 0;
+			sp->position = 0;
+			sp->state = DB_SORT_STATE_INMEMORY;
+			return 1;
+		}
+		
+		if (DB_STORAGE_NOFILE == out)
+		{
+			sort_filename(sp, 0, name);
+			db_fileremove(name);
+			out = db_openwritefile(name);
+			if (DB_STORAGE_NOFILE == out)
+			{
+				result = -1;
+				break;
+			}
+			/* From here on, closing cleans up the file. */
+			sp->state = DB_SORT_STATE_ONDISK;
+		}
+		
+		if ((size_t)(count*recsize) !=
+			db_filewrite(out, sp->buffer, (size_t)(count*recsize)))
+		{
+			result = -1;
+			break;
+		}
+		count = 0;
+	} while (1 == result);
+	
+	if (DB_STORAGE_NOFILE != out)
+		db_fileclose(out);
+	db_qmm_bfree(mmp, sp->buffer);
+	sp->buffer = NULL;
+	
+	if (-1 == result)
+		return -1;
+	return 1;
+}
+
+/* Merge runs on disk until there are few enough to merge while tuples are
+   returned, then open them for just that. */
+static db_int sort_mergeruns(sort_t *sp, db_query_mm_t *mmp)
+{
+	db_int recsize = sort_recordsize(sp);
+	db_int numruns = sort_numruns(sp);
+	db_int ways = (sort_freebytes(sp, mmp) - 3*((db_int)sizeof(db_int))) /
+			(recsize + (db_int)(sizeof(db_fileref_t) + sizeof(db_int)));
+	db_uint8 which = sp->state - DB_SORT_STATE_ONDISK;
+	char name[DB_SORT_NAMELENGTH];
+	db_fileref_t out;
+	db_int first, way;
+	db_int result = 1;
+	
+	if (ways > DB_SORT_MAXWAYS)
+		ways = DB_SORT_MAXWAYS;
+	if (ways < 2)
+		return -1;
+	
+	if (numruns > ways)
+	{
+		if (1 != sort_allocways(sp, ways, mmp))
+			return -1;
+		
+		while (numruns > ways)
+		{
+			sort_filename(sp, 1 - which, name);
+			db_fileremove(name);
+			out = db_openwritefile(name);
+			if (DB_STORAGE_NOFILE == out)
+				return -1;
+			
+			for (first = 0; 1 == result && first < numruns;
+					first += ways)
+			{
+				result = sort_openways(sp, which, first, ways);
+				while (1 == result &&
+					(way = sort_minway(sp, mmp)) >= 0)
+				{
+					if ((size_t)recsize != db_filewrite(out,
+						sp->buffer + way*recsize,
+						(size_t)recsize))
+						result = -1;
+					else
+						result = sort_advanceway(sp, way);
+				}
+				sort_closeways(sp);
+			}
+			db_fileclose(out);
+			if (1 != result)
+			{
+				db_fileremove(name);
+				return -1;
+			}
+			
+			sort_filename(sp, which, name);
+			db_fileremove(name);
+			which = 1 - which;
+			sp->state = DB_SORT_STATE_ONDISK + which;
+			sp->run_length *= ways;
+			numruns = sort_numruns(sp);
+		}
+		sort_freebuffers(sp, mmp);
+	}
+	
+	/* Only keep as much memory as the final merge needs. */
+	if (1 != sort_allocways(sp, numruns, mmp))
+		return -1;
+	return sort_openways(sp, which, 0, numruns);
+}
 
 /* Initialize the sort operator. */
 db_int init_sort(sort_t *sp, db_op_base_t *child, db_eet_t *sort_exprs,
@@ -32,34 +568,56 @@ db_int init_sort(sort_t *sp, db_op_base_t *child, db_eet_t *sort_exprs,
 	sp->base.type = DB_SORT;
 	sp->base.header = child->header;
 	
-	/* Allocate memory for the previous tuple. */
-	sp->previous_tp = NULL;
+	/* Nothing is sorted until the first tuple is asked for. */
+	sp->buffer = NULL;
+	sp->runs = NULL;
+	sp->remaining = NULL;
+	sp->num_tuples = 0;
+	sp->position = 0;
+	sp->run_length = 0;
+	sp->num_ways = 0;
+	sp->sortid = db_sort_nextid++;
+	sp->state = DB_SORT_STATE_UNSORTED;
 	
-	sp->next_count = 0;
 	sp->child = child;
 	sp->sort_exprs = sort_exprs;
 	sp->num_expr = num_expr;
 	sp->order = order;
+	
+	/* If every expression can be put in a key, each is evaluated once
+	   per tuple instead of once per comparison. */
+	db_int i, width, type;
+	sp->keysize = 0;
+	for (i = 0; i < (db_int)num_expr; ++i)
+	{
+		width = sort_keywidth(sp, i, &type, mmp);
+		if (0 == width)
+		{
+			sp->keysize = 0;
+			break;
+		}
+		sp->keysize += width;
+	}
 	return 1;
 }
 
 /* Rewind the sort operator. */
 db_int rewind_sort(sort_t *sp, db_query_mm_t *mmp)
 {
-	switch (rewind_dbop(sp->child, mmp))
+	switch (sp->state)
 	{
-		case 1:
-			if (sp->previous_tp != NULL)
-			{
-				close_tuple(sp->previous_tp, mmp);
-				DB_QMM_BFREE(mmp, sp->previous_tp);
-			}
-			sp->previous_tp = NULL;
+		case DB_SORT_STATE_UNSORTED:
+			return rewind_dbop(sp->child, mmp);
+		case DB_SORT_STATE_INMEMORY:
+			sp->position = 0;
 			return 1;
-		case 0:
-			return 0;
 		default:
-			return -1;	/* Error out. */
+			/* The sorted runs are kept until the operator is
+			   closed, so just start merging them again. */
+			sort_closeways(sp);
+			return sort_openways(sp,
+				sp->state - DB_SORT_STATE_ONDISK, 0,
+				sort_numruns(sp));
 	}
 }
 
@@ -73,68 +631,54 @@ db_int next_sort(sort_t *sp, db_tuple_t *tp, db_query_mm_t *mmp)
 	if (tp->bytes == NULL)
 		return -1;
 	
-	db_int i;
-	if (sp->next_count > 0)
+	if (DB_SORT_STATE_UNSORTED == sp->state)
 	{
-		if (sp->previous_tp == NULL)
+		if (1 != sort_makeruns(sp, mmp))
 			return -1;
-		if (sp->previous_tp->bytes == NULL)
+		if (DB_SORT_STATE_INMEMORY != sp->state &&
+			1 != sort_mergeruns(sp, mmp))
 			return -1;
-		
-		/* Copy out previous's bytes to next. */
-		for (i = 0; i < (db_int)(sp->base.header->tuple_size); ++i)
-		{
-			tp->bytes[i] = sp->previous_tp->bytes[i];
-		}
-		for (i = 0; i < (db_int)(sp->base.header->num_attr); ++i)
-		{
-			tp->isnull[i/8] = sp->previous_tp->isnull[i/8];
-		}
-		sp->next_count--;
-		return 1;
 	}
-	switch (next_inorder_tuple(tp, sp->previous_tp, &(sp->next_count),
-		sp->child, (sp->sort_exprs), sp->num_expr, sp->order, mmp))
+	
+	db_int recsize = sort_recordsize(sp);
+	db_int isnullsize = sort_isnullsize(sp);
+	db_int way = -1;
+	unsigned char *record;
+	if (DB_SORT_STATE_INMEMORY == sp->state)
 	{
-		case 1:
-			if (sp->previous_tp == NULL)
-			{
-				sp->previous_tp = DB_QMM_BALLOC(mmp, sizeof(db_tuple_t));
-				init_tuple(sp->previous_tp,
-					sp->base.header->tuple_size,
-					sp->base.header->num_attr, mmp);
-			}
-			/* Decrement the count by 1. */
-			(sp->next_count)--;
-			/* Copy out next's bytes to previous. */
-			for (i = 0; i < (db_int)sp->base.header->tuple_size; ++i)
-			{
-				sp->previous_tp->bytes[i] = tp->bytes[i];
-			}
-			for (i = 0; i < (db_int)(sp->base.header->num_attr); ++i)
-			{
-				sp->previous_tp->isnull[i/8] = tp->isnull[i/8];
-			}
-			return 1;
-		case 0:
-			/* Decrement the count by 1. */
-			(sp->next_count)--;
+		if (sp->position >= sp->num_tuples)
 			return 0;
-		default:
-			/* Decrement the count by 1. */
-			(sp->next_count)--;
-			return -1;	/* Error out. */
+		record = sp->buffer + sp->position*recsize;
+		sp->position++;
 	}
+	else
+	{
+		way = sort_minway(sp, mmp);
+		if (way < 0)
+			return 0;
+		record = sp->buffer + way*recsize;
+	}
+	
+	memcpy(tp->isnull, record + sp->keysize, isnullsize);
+	memcpy(tp->bytes, record + sp->keysize + isnullsize,
+		sp->base.header->tuple_size);
+	
+	if (way >= 0 && 1 != sort_advanceway(sp, way))
+		return -1;
+	return 1;
 }
 
 /* Close the sort operator. */
 db_int close_sort(sort_t *sp, db_query_mm_t *mmp)
 {
-	/* Free memory used by previous tuple, if it was initialized. */
-	if (sp->previous_tp != NULL)
+	char name[DB_SORT_NAMELENGTH];
+	sort_closeways(sp);
+	if (sp->state >= DB_SORT_STATE_ONDISK)
 	{
-		close_tuple(sp->previous_tp, mmp);
-		DB_QMM_BFREE(mmp, sp->previous_tp);
+		sort_filename(sp, sp->state - DB_SORT_STATE_ONDISK, name);
+		db_fileremove(name);
 	}
+	sort_freebuffers(sp, mmp);
+	sp->state = DB_SORT_STATE_UNSORTED;
 	return 1;
 }
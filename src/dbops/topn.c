@@ -0,0 +1,281 @@
+/******************************************************************************/
+/**
+@file		topn.c
+@author		Graeme Douglas
+@brief		Implementation of the top-N operator.
+@see		For more information, reference @ref topn.h.
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+/******************************************************************************/
+
+#include "topn.h"
+#include "../db_ctconf.h"
+#include "../dblogic/compare_tuple.h"
+#include "../dbmacros.h"
+#include "db_ops.h"
+#include <string.h>
+
+/* Top-N operator states. */
+#define DB_TOPN_STATE_UNSORTED 0
+#define DB_TOPN_STATE_SORTED 1
+
+/* Number of bytes in the nullity information of a tuple record. */
+static db_int topn_isnullsize(relation_header_t *hp) {
+  db_int size = ((db_int)(hp->num_attr)) / 8;
+  if (((db_int)(hp->num_attr)) % 8 > 0)
+    size++;
+  return size;
+}
+
+/* Number of bytes in a tuple record, nullity information included. */
+static db_int topn_recordsize(relation_header_t *hp) {
+  return topn_isnullsize(hp) + (db_int)(hp->tuple_size);
+}
+
+/* Point a tuple at a record so it can be read or written in place. */
+static void topn_viewrecord(relation_header_t *hp, db_tuple_t *tp,
+                            unsigned char *record) {
+  tp->isnull = (char *)record;
+  tp->bytes = (char *)(record + topn_isnullsize(hp));
+  tp->offset_r = 0;
+}
+
+/* Number of tuple records that fit in the query memory right now. */
+static db_int topn_capacity(topn_t *tp, db_query_mm_t *mmp) {
+  db_int reserve = DB_CTCONF_SETTING_OPERATOR_RESERVE;
+  db_int i;
+  for (i = 0; i < (db_int)(tp->num_expr); ++i)
+    reserve += tp->sort_exprs[i].stack_size;
+  reserve += (db_int)sizeof(db_int);
+
+  db_int avail = POINTERBYTEDIST(mmp->last_back, mmp->next_front);
+  if (avail < reserve)
+    return 0;
+  return (avail - reserve) / topn_recordsize(tp->base.header);
+}
+
+/* Number of tuple records the heap needs.  No more are kept than the child
+   can produce. */
+static db_int topn_numkept(topn_t *tp) {
+  db_int estimate = estimatenumtuples(tp->child);
+  if (estimate >= 0 && estimate < tp->limit)
+    return estimate;
+  return tp->limit;
+}
+
+/* Make room for one more record in the heap, moving the spare record after
+   it.  This only works while the heap is the last thing on the back
+   stack. */
+static db_int topn_grow(topn_t *tp, db_int *numkeptp, db_query_mm_t *mmp) {
+  db_int recsize = topn_recordsize(tp->base.header);
+  unsigned char *records;
+
+  if (POINTERATNBYTES(tp->records, -1 * ((db_int)sizeof(db_int)), void *) !=
+          mmp->last_back ||
+      topn_capacity(tp, mmp) < 1)
+    return -1;
+  records = db_qmm_bextend(mmp, recsize);
+  if (NULL == records)
+    return -1;
+  memmove(records, tp->records, (size_t)((*numkeptp + 1) * recsize));
+  memcpy(records + (*numkeptp + 1) * recsize, records + *numkeptp * recsize,
+         (size_t)recsize);
+  tp->records = records;
+  (*numkeptp)++;
+  return 1;
+}
+
+static db_int8 topn_cmprecords(topn_t *tp, unsigned char *a, unsigned char *b,
+                               db_query_mm_t *mmp) {
+  db_tuple_t ta, tb;
+  topn_viewrecord(tp->base.header, &ta, a);
+  topn_viewrecord(tp->base.header, &tb, b);
+  return cmp_tuple(&ta, &tb, tp->base.header, tp->base.header, tp->sort_exprs,
+                   tp->sort_exprs, tp->num_expr, tp->order, 0, mmp);
+}
+
+static void topn_swaprecords(unsigned char *a, unsigned char *b,
+                             db_int size) {
+  unsigned char temp;
+  for (; size > 0; --size, ++a, ++b) {
+    temp = *a;
+    *a = *b;
+    *b = temp;
+  }
+}
+
+/* Move a record down the heap, whose root is the record that comes last,
+   until the heap is valid again. */
+static void topn_siftdown(topn_t *tp, db_int root, db_int count,
+                          db_query_mm_t *mmp) {
+  db_int recsize = topn_recordsize(tp->base.header);
+  unsigned char *records = tp->records;
+  db_int child;
+  while ((child = 2 * root + 1) < count) {
+    if (child + 1 < count &&
+        topn_cmprecords(tp, records + child * recsize,
+                        records + (child + 1) * recsize, mmp) < 0)
+      child++;
+    if (topn_cmprecords(tp, records + root * recsize,
+                        records + child * recsize, mmp) >= 0)
+      return;
+    topn_swaprecords(records + root * recsize, records + child * recsize,
+                     recsize);
+    root = child;
+  }
+}
+
+/* Move a record up the heap until the heap is valid again. */
+static void topn_siftup(topn_t *tp, db_int child, db_query_mm_t *mmp) {
+  db_int recsize = topn_recordsize(tp->base.header);
+  unsigned char *records = tp->records;
+  db_int parent;
+  while (child > 0) {
+    parent = (child - 1) / 2;
+    if (topn_cmprecords(tp, records + parent * recsize,
+                        records + child * recsize, mmp) >= 0)
+      return;
+    topn_swaprecords(records + parent * recsize, records + child * recsize,
+                     recsize);
+    child = parent;
+  }
+}
+
+/* Keep the first tuples of the child in a heap, then sort them. */
+static db_int topn_fill(topn_t *tp, db_query_mm_t *mmp) {
+  relation_header_t *hp = tp->base.header;
+  db_int recsize = topn_recordsize(hp);
+  db_int numkept = topn_numkept(tp);
+  db_int result, i;
+  db_tuple_t t;
+
+  /* The heap and the spare record are taken in one piece, once the child
+     has taken its memory. */
+  if (topn_capacity(tp, mmp) <= numkept)
+    return -1;
+  tp->records = db_qmm_balloc(mmp, (size_t)((numkept + 1) * recsize));
+  if (NULL == tp->records)
+    return -1;
+
+  tp->num_records = 0;
+  topn_viewrecord(hp, &t, tp->records + numkept * recsize);
+  while (1 == (result = next(tp->child, &t, mmp))) {
+    /* The child had more tuples than it was thought to. */
+    if (tp->num_records == numkept && numkept < tp->limit) {
+      if (1 != topn_grow(tp, &numkept, mmp)) {
+        result = -1;
+        break;
+      }
+      topn_viewrecord(hp, &t, tp->records + numkept * recsize);
+    }
+
+    unsigned char *spare = tp->records + numkept * recsize;
+    if (tp->num_records < tp->limit) {
+      memcpy(tp->records + tp->num_records * recsize, spare, (size_t)recsize);
+      topn_siftup(tp, tp->num_records, mmp);
+      tp->num_records++;
+    } else if (topn_cmprecords(tp, spare, tp->records, mmp) < 0) {
+      /* Better than the worst tuple kept, so it takes that one's place. */
+      memcpy(tp->records, spare, (size_t)recsize);
+      topn_siftdown(tp, 0, tp->num_records, mmp);
+    }
+  }
+  if (-1 == result)
+    return -1;
+
+  for (i = tp->num_records - 1; i > 0; --i) {
+    topn_swaprecords(tp->records, tp->records + i * recsize, recsize);
+    topn_siftdown(tp, 0, i, mmp);
+  }
+  tp->state = DB_TOPN_STATE_SORTED;
+  return 1;
+}
+
+/* Check if the tuples a top-N operator keeps fit in memory. */
+db_uint8 topn_fits(topn_t *tp, db_query_mm_t *mmp) {
+  return topn_capacity(tp, mmp) > topn_numkept(tp);
+}
+
+/* Initialize the top-N operator. */
+db_int init_topn(topn_t *tp, db_op_base_t *child, db_eet_t *sort_exprs,
+                 db_uint8 num_expr, db_uint8 *order, db_int limit,
+                 db_query_mm_t *mmp) {
+  if (limit < 0)
+    return -1;
+
+  tp->base.type = DB_TOPN;
+  tp->base.header = child->header;
+  tp->child = child;
+  tp->records = NULL;
+  tp->limit = limit;
+  tp->num_records = 0;
+  tp->position = 0;
+  tp->state = DB_TOPN_STATE_UNSORTED;
+  tp->sort_exprs = sort_exprs;
+  tp->num_expr = num_expr;
+  tp->order = order;
+  return 1;
+}
+
+/* Rewind the top-N operator. */
+db_int rewind_topn(topn_t *tp, db_query_mm_t *mmp) {
+  tp->position = 0;
+  if (DB_TOPN_STATE_SORTED == tp->state)
+    return 1;
+  return rewind_dbop(tp->child, mmp);
+}
+
+/* Return the next tuple from the top-N operator. */
+db_int next_topn(topn_t *tp, db_tuple_t *next_tp, db_query_mm_t *mmp) {
+  db_int result;
+  if (NULL == tp || NULL == next_tp || NULL == next_tp->bytes)
+    return -1;
+  if (tp->position >= tp->limit)
+    return 0;
+
+  /* Unordered, the child's tuples are passed through until enough have
+     been returned. */
+  if (0 == tp->num_expr) {
+    result = next(tp->child, next_tp, mmp);
+    if (1 == result)
+      tp->position++;
+    return result;
+  }
+
+  if (DB_TOPN_STATE_UNSORTED == tp->state && 1 != topn_fill(tp, mmp))
+    return -1;
+  if (tp->position >= tp->num_records)
+    return 0;
+
+  relation_header_t *hp = tp->base.header;
+  db_int isnullsize = topn_isnullsize(hp);
+  unsigned char *record = tp->records + tp->position * topn_recordsize(hp);
+  memcpy(next_tp->isnull, record, (size_t)isnullsize);
+  memcpy(next_tp->bytes, record + isnullsize, (size_t)(hp->tuple_size));
+  tp->position++;
+  return 1;
+}
+
+/* Close the top-N operator. */
+db_int close_topn(topn_t *tp, db_query_mm_t *mmp) {
+  if (NULL != tp->records)
+    db_qmm_bfree(mmp, tp->records);
+  tp->records = NULL;
+  tp->num_records = 0;
+  tp->position = 0;
+  tp->state = DB_TOPN_STATE_UNSORTED;
+  return 1;
+}
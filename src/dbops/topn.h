@@ -0,0 +1,109 @@
+/******************************************************************************/
+/**
+@file		topn.h
+@author		Graeme Douglas
+@brief		The relational top-N operator.
+@details	This is the relational operator behind an ORDER BY clause
+		with a LIMIT.  It returns the first tuples of its child in
+		order, holding no more of them in memory than it returns.
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+		you may not use this file except in compliance with the License.
+		You may obtain a copy of the License at
+			http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+		Unless required by applicable law or agreed to in writing,
+		software distributed under the License is distributed on an
+		"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+		either express or implied. See the License for the specific
+		language governing permissions and limitations under the
+		License.
+*/
+/******************************************************************************/
+
+#ifndef TOPN_H
+#define TOPN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "db_ops_types.h"
+#include "../dbobjects/relation.h"
+#include "../dbobjects/tuple.h"
+#include "../ref.h"
+
+/* Initialize the top-N operator. */
+/**
+@brief		Initialize a relational top-N operator.
+@details	The memory for the kept tuples is only taken on the first call
+		to @ref next, from whatever is free at that point.
+@param		tp		A pointer to the top-N operator to be
+				initialized.
+@param		child		A pointer to the operator that will
+				pass tuples into the top-N operator.
+@param		sort_exprs	An array of bytecode expressions that
+				determine how to order the tuples, or @c NULL
+				to return the child's first tuples in the order
+				they come.
+@param		num_expr	The number of expressions in @p sort_exprs.
+@param		order		An array of integers determining what order to
+				sort the tuples for each expression.  This
+				should have exactly @p num_expr integers.
+@param		limit		The most tuples to return.
+@param		mmp		A pointer to the memory manager pointer to be
+				used to allocate memory for this query.
+@returns	@c 1 if the operator was initialized, @c -1 if @p limit is
+		negative.
+*/
+db_int init_topn(topn_t *tp,
+		db_op_base_t *child,
+		db_eet_t *sort_exprs,
+		db_uint8 num_expr,
+		db_uint8 *order,
+		db_int limit,
+		db_query_mm_t *mmp);
+
+/* Check if the tuples a top-N operator keeps fit in memory. */
+/**
+@brief		Check if the tuples a top-N operator would keep fit in the
+		memory that is free right now.
+@details	No more tuples are kept than the operator's child is estimated
+		to produce, so a large limit over a small relation still fits.
+@param		tp		A pointer to the top-N operator, with its
+				ordering expressions set.
+@param		mmp		A pointer to the memory manager pointer used
+				for this query.
+@returns	@c 1 if they fit, @c 0 otherwise.
+*/
+db_uint8 topn_fits(topn_t *tp, db_query_mm_t *mmp);
+
+/* Rewind the top-N operator. */
+/**
+@brief		Rewind a top-N operator.
+@details	Once the child has been read, the kept tuples are returned
+		again without reading it a second time.
+@see		For more information, reference @ref rewind_dbop.
+*/
+db_int rewind_topn(topn_t *tp, db_query_mm_t *mmp);
+
+/* Return the next tuple from the top-N operator. */
+/**
+@brief		Retrieve the next tuple from a top-N operator.
+@see		For more information, reference @ref next.
+*/
+db_int next_topn(topn_t *tp, db_tuple_t *next_tp, db_query_mm_t *mmp);
+
+/* Close the top-N operator. */
+/**
+@brief		Cleanly deconstruct a top-N operator.
+@see		For more information, reference @ref close.
+*/
+db_int close_topn(topn_t *tp, db_query_mm_t *mmp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -56,20 +56,27 @@ db_int numdbintdigits(db_int value) {
   return width;
 }
 
-/* Get the size of the query. */
-db_int sizeQuery(db_op_base_t *op, db_tuple_t *next_t, db_query_mm_t *mmp) {
-  db_int *widths = calloc((db_int)(op->header->num_attr), sizeof(db_int));
-  computeWidths(op, widths);
+/* Get the size of the formatted query, less its rows. */
+static db_int sizeQueryHeader(db_op_base_t *op, db_int *widths) {
   db_int i;
-  int sizeRow = sizeOfRow(op, widths);
 
-  db_int requiredMem = 1 + 3 * sizeRow; /* Null-byte + first row
-                                           separator, attribute names row,
-                                           last row separatr.*/
+  /* Null-byte + first row separator, attribute names row, last row
+     separatr. */
+  db_int requiredMem = 1 + 3 * sizeOfRow(op, widths);
   for (i = 0; i < (db_int)op->header->num_attr; ++i) {
     requiredMem += widths[i];
   }
 
+  return requiredMem;
+}
+
+/* Get the size of the query. */
+db_int sizeQuery(db_op_base_t *op, db_tuple_t *next_t, db_query_mm_t *mmp) {
+  db_int *widths = calloc((db_int)(op->header->num_attr), sizeof(db_int));
+  computeWidths(op, widths);
+  int sizeRow = sizeOfRow(op, widths);
+  db_int requiredMem = sizeQueryHeader(op, widths);
+
   while (1 == next(op, next_t, mmp)) {
     requiredMem += 2 * sizeRow; /* Row separator and actual row. */
   }
@@ -79,19 +86,62 @@ db_int sizeQuery(db_op_base_t *op, db_tuple_t *next_t, db_query_mm_t *mmp) {
   return requiredMem;
 }
 
+/* Get the size of the query, pulling its tuples a batch at a time. */
+static db_int sizeQueryBatch(db_op_base_t *op, db_tuplebatch_t *bp,
+                             db_query_mm_t *mmp) {
+  db_int *widths = calloc((db_int)(op->header->num_attr), sizeof(db_int));
+  computeWidths(op, widths);
+  int sizeRow = sizeOfRow(op, widths);
+  db_int requiredMem = sizeQueryHeader(op, widths);
+
+  while (1 == next_batch(op, bp, mmp)) {
+    requiredMem += 2 * sizeRow * bp->count; /* Row separator and actual row. */
+  }
+  free(widths);
+  rewind_dbop(op, mmp);
+
+  return requiredMem;
+}
+
+/* Add a formatted tuple and the row separator after it to the output. */
+static void formatQueryRow(char *out, db_tuple_t *toprint, db_op_base_t *op,
+                           db_int *widths) {
+  char *temp = formatTuple(toprint, op, widths);
+  strcat(out, temp);
+  free(temp);
+  /** Print row separator. **/
+  temp = formatRowSeparator(op, widths);
+  strcat(out, temp);
+  free(temp);
+}
+
 void printQuery(db_op_base_t *op, db_query_mm_t *mmp) {
   char *output = formatQuery(op, mmp);
+  if (NULL == output) {
+    PRINTF("Not enough memory to output the query.\n");
+    return;
+  }
   PRINTF("%s\n", output);
   free(output);
 }
 
 char *formatQuery(db_op_base_t *op, db_query_mm_t *mmp) {
+  db_tuplebatch_t batch;
   db_tuple_t next_t;
-  init_tuple(&next_t, op->header->tuple_size, op->header->num_attr, mmp);
-  db_int i;
+  db_int i, j;
+  db_int requiredMem;
+  /* If there is no room for a batch, pull one tuple at a time instead. */
+  db_int usebatch = (1 == init_opbatch(op, &batch, mmp));
+  if (usebatch) {
+    requiredMem = sizeQueryBatch(op, &batch, mmp);
+  } else if (1 == init_tuple(&next_t, op->header->tuple_size,
+                             op->header->num_attr, mmp)) {
+    requiredMem = sizeQuery(op, &next_t, mmp);
+  } else {
+    return NULL;
+  }
   db_int *widths = calloc((db_int)(op->header->num_attr), sizeof(db_int));
   computeWidths(op, widths);
-  db_int requiredMem = sizeQuery(op, &next_t, mmp);
   char *out = calloc(requiredMem, sizeof(char));
 
   /** Print row separator. **/
@@ -133,18 +183,24 @@ char *formatQuery(db_op_base_t *op, db_query_mm_t *mmp) {
   temp = formatRowSeparator(op, widths);
   strcat(out, temp);
   free(temp);
-  while (1 == next(op, &next_t, mmp)) {
-    temp = formatTuple(&next_t, op, widths);
-    strcat(out, temp);
-    free(temp);
-    /** Print row separator. **/
-    temp = formatRowSeparator(op, widths);
-    strcat(out, temp);
-    free(temp);
+  if (usebatch) {
+    while (1 == next_batch(op, &batch, mmp)) {
+      for (j = 0; j < batch.count; ++j) {
+        viewbatchtuple(&batch, j, &next_t);
+        formatQueryRow(out, &next_t, op, widths);
+      }
+    }
+  } else {
+    while (1 == next(op, &next_t, mmp)) {
+      formatQueryRow(out, &next_t, op, widths);
+    }
   }
 
   free(widths);
-  close_tuple(&next_t, mmp);
+  if (usebatch)
+    close_tuplebatch(&batch, mmp);
+  else
+    close_tuple(&next_t, mmp);
   return out;
 }
 
@@ -53,12 +53,14 @@ void printQuery(db_op_base_t *op,
 @brief		Format the query results into a stirng.
 @details	If your system does not have enough memory to format the
 		results into a string, do not call this method.  The result
-		must be freed!
+		must be freed!  The results are pulled a batch at a time, or
+		one tuple at a time if the query memory cannot hold a batch.
 @param		op	A pointer to the root operator for the query's
 			execution tree.
 @param		mmp	A pointer to the per-query memory manager used
 			to allocate memory for the query.
-@returns	The formatted query.
+@returns	The formatted query, or @c NULL if the query memory cannot
+		hold even one tuple of the results.
 */
 char* formatQuery(db_op_base_t *op,
 		db_query_mm_t *mmp);
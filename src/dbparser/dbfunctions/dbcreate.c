@@ -23,6 +23,9 @@
 
 #include "dbcreate.h"
 #include "../db_ctconf.h"
+#include "../../dbindex/dbindex.h"
+#include "../../dbops/scan.h"
+#include "../dbparseexpr.h"
 
 #if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
     1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
@@ -164,6 +167,7 @@ db_int createTable(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
   }
 
   /* Build out the new relation file. */
+  db_uint8 num_attr = attrcount;
   db_filewrite(newtable, &attrcount, sizeof(db_uint8));
   db_uint8 offset = 0;
   db_uint8 temp;
@@ -210,11 +214,392 @@ db_int createTable(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
     return -1;
   }
 
+  /* The relation's statistics are kept up from here on. */
+  createrelationstats(tablename, num_attr);
+
   db_qmm_ffree(mmp, tablename);
   return 1;
 }
 #endif
 
+/**
+@brief		Find the end of one of the expressions of a CREATE INDEX
+		statement.
+@details	The lexer is left at the ',' or ')' after the expression.
+@param		lexerp		A pointer to the lexer instance variable that
+                                is generating the token stream.
+@param		end		The index of the first character in the command
+                                being lexed that is not part of the CREATE
+                                statement.
+@returns	The index of the first character after the expression, or
+		@c -1 if it has no end.
+*/
+static db_int findIndexExprEnd(db_lexer_t *lexerp, db_int end) {
+  db_int depth = 0;
+  while (end > lexerp->offset && 1 == lexer_next(lexerp)) {
+    if (DB_LEXER_TT_LPAREN == lexerp->token.type)
+      depth++;
+    else if (DB_LEXER_TT_RPAREN == lexerp->token.type && depth > 0)
+      depth--;
+    else if (0 == depth && (DB_LEXER_TT_RPAREN == lexerp->token.type ||
+                            DB_LEXER_TT_COMMA == lexerp->token.type))
+      return lexerp->token.start;
+  }
+  return -1;
+}
+
+/**
+@brief		Parse the attributes a CREATE INDEX statement stores with each
+		of the index's keys.
+@details	The lexer is left at the ')' after the attributes.  The
+		attribute marking deleted tuples is always included, if the
+		table has one.
+@param		lexerp		A pointer to the lexer instance variable that
+                                is generating the token stream.  The next
+                                token to process is the '(' before the
+                                attributes.
+@param		end		The index of the first character in the command
+                                being lexed that is not part of the CREATE
+                                statement.
+@param		sp		A pointer to a scan of the table.
+@param		include		Where the positions of the attributes will be
+				written.  It must have room for each of the
+				table's attributes.
+@param		num_includep	A pointer to where the number of attributes
+				will be written.
+@returns	@c 1 if the attributes were parsed successfully, @c -1 if an
+                error occurred.
+*/
+static db_int parseIndexIncludes(db_lexer_t *lexerp, db_int end, scan_t *sp,
+                                 db_uint8 *include, db_uint8 *num_includep) {
+  db_int pos, i;
+
+  *num_includep = 0;
+  if (1 != lexer_next(lexerp) || DB_LEXER_TT_LPAREN != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing '('", lexerp->offset, lexerp->command);
+    return -1;
+  }
+  do {
+    if (end <= lexerp->offset || 1 != lexer_next(lexerp) ||
+        DB_LEXER_TT_IDENT != lexerp->token.type) {
+      DB_ERROR_MESSAGE("missing attribute name", lexerp->offset,
+                       lexerp->command);
+      return -1;
+    }
+    char name[gettokenlength(&(lexerp->token)) + 1];
+    gettokenstring(&(lexerp->token), name, lexerp);
+    pos = getposbyname(sp->base.header, name);
+    for (i = 0; i < (db_int)*num_includep && pos != (db_int)include[i]; ++i)
+      ;
+    if (-1 == pos || i < (db_int)*num_includep) {
+      DB_ERROR_MESSAGE(-1 == pos ? "unknown attribute" : "duplicate attribute",
+                       lexerp->token.start, lexerp->command);
+      return -1;
+    }
+    include[(*num_includep)++] = (db_uint8)pos;
+
+    if (end <= lexerp->offset || 1 != lexer_next(lexerp)) {
+      DB_ERROR_MESSAGE("missing ')'", lexerp->offset, lexerp->command);
+      return -1;
+    }
+  } while (DB_LEXER_TT_COMMA == lexerp->token.type);
+
+  if (DB_LEXER_TT_RPAREN != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing ')'", lexerp->token.start, lexerp->command);
+    return -1;
+  }
+
+  /* Queries only see tuples not marked deleted, so the mark is stored too. */
+  pos = getposbyname(sp->base.header, "__delete");
+  for (i = 0; i < (db_int)*num_includep && pos != (db_int)include[i]; ++i)
+    ;
+  if (-1 != pos && i == (db_int)*num_includep)
+    include[(*num_includep)++] = (db_uint8)pos;
+  return 1;
+}
+
+/**
+@brief		Parse the expressions and type of a CREATE INDEX statement,
+		then build the index and add it to its table's index metadata.
+@param		lexerp		A pointer to the lexer instance variable that
+                                is generating the token stream.  The next
+                                token to process is the '(' before the
+                                expressions.
+@param		end		The index of the first character in the command
+                                being lexed that is not part of the CREATE
+                                statement.
+@param		indexname	The name of the index.
+@param		tablename	The name of the table.
+@param		sp		A pointer to a scan of the table.
+@param		mmp		A pointer to the per-query memory manager being
+                                used to process this query.
+@returns	@c 1 if the index was created successfully, @c -1 if an error
+                occurred.
+*/
+static db_int buildIndex(db_lexer_t *lexerp, db_int end, char *indexname,
+                         char *tablename, scan_t *sp, db_query_mm_t *mmp) {
+  db_uint8 type = DB_INDEX_TYPE_BTREE;
+  db_uint8 num_expr = 0, numparsed = 0, num_include = 0, more;
+  db_uint8 include[sp->base.header->num_attr];
+  db_int start, exprend, next, retval = 1;
+
+  /* Throw away the bracket, then count the expressions. */
+  if (1 != lexer_next(lexerp) || DB_LEXER_TT_LPAREN != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing '('", lexerp->offset, lexerp->command);
+    return -1;
+  }
+  start = lexerp->offset;
+  do {
+    if (-1 == findIndexExprEnd(lexerp, end) || 255 == num_expr) {
+      DB_ERROR_MESSAGE("missing ')'", lexerp->offset, lexerp->command);
+      return -1;
+    }
+    num_expr++;
+  } while (DB_LEXER_TT_COMMA == lexerp->token.type);
+  next = lexerp->offset;
+
+  /* Read the attributes stored with each key, then the index's type. */
+  more = end > lexerp->offset;
+  if (more && 1 == lexer_next(lexerp) &&
+      DB_LEXER_TT_IDENT == lexerp->token.type &&
+      token_stringequal(&(lexerp->token), "INCLUDE", 7, lexerp, 0)) {
+    if (1 != parseIndexIncludes(lexerp, end, sp, include, &num_include))
+      return -1;
+    more = end > lexerp->offset;
+    if (more)
+      lexer_next(lexerp);
+  }
+  if (more) {
+    if (DB_LEXER_TOKENINFO_LITERAL_USING != lexerp->token.info ||
+        1 != lexer_next(lexerp) || DB_LEXER_TT_IDENT != lexerp->token.type) {
+      DB_ERROR_MESSAGE("malformed statement", lexerp->token.start,
+                       lexerp->command);
+      return -1;
+    } else if (token_stringequal(&(lexerp->token), "BTREE", 5, lexerp, 0)) {
+      type = DB_INDEX_TYPE_BTREE;
+    } else if (token_stringequal(&(lexerp->token), "SKIPLIST", 8, lexerp,
+                                 0)) {
+      type = DB_INDEX_TYPE_SKIPLIST;
+    } else if (token_stringequal(&(lexerp->token), "HASH", 4, lexerp, 0)) {
+      type = DB_INDEX_TYPE_HASH;
+    } else if (token_stringequal(&(lexerp->token), "INLINE", 6, lexerp, 0)) {
+      type = DB_INDEX_TYPE_INLINE;
+    } else {
+      DB_ERROR_MESSAGE("unknown index type", lexerp->token.start,
+                       lexerp->command);
+      return -1;
+    }
+
+    if (end > lexerp->offset) {
+      DB_ERROR_MESSAGE("malformed statement", lexerp->offset,
+                       lexerp->command);
+      return -1;
+    }
+  }
+
+  if (DB_INDEX_TYPE_INLINE != type && 1 != num_expr) {
+    DB_ERROR_MESSAGE("only inline indexes have several keys", next,
+                     lexerp->command);
+    return -1;
+  }
+  if (DB_INDEX_TYPE_INLINE == type && num_include > 0) {
+    DB_ERROR_MESSAGE("inline indexes store no attributes", next,
+                     lexerp->command);
+    return -1;
+  }
+
+  /* Parse each expression over the table. */
+  db_eet_t exprs[(int)num_expr];
+  lexerp->offset = start;
+  while (numparsed < num_expr && 1 == retval) {
+    exprend = findIndexExprEnd(lexerp, end);
+    next = lexerp->offset;
+    if (1 != parseexpression(&(exprs[numparsed].nodes), lexerp, start, exprend,
+                             mmp, 0)) {
+      DB_ERROR_MESSAGE("bad index expression", start, lexerp->command);
+      retval = -1;
+      break;
+    }
+    exprs[numparsed].size = DB_QMM_SIZEOF_FTOP(mmp);
+    exprs[numparsed].stack_size = 2 * exprs[numparsed].size;
+    numparsed++;
+
+    if (0 == exprs[numparsed - 1].size) {
+      DB_ERROR_MESSAGE("missing expression", start, lexerp->command);
+      retval = -1;
+    } else if (0 == (retval = verifysetupattributes(&(exprs[numparsed - 1]),
+                                                    lexerp, (db_op_base_t *)sp,
+                                                    sp, 1, 0))) {
+      DB_ERROR_MESSAGE("could not verify identifiers", start,
+                       lexerp->command);
+      retval = -1;
+    }
+    start = next;
+    lexerp->offset = next;
+  }
+
+  if (1 == retval && DB_INDEX_TYPE_INLINE != type &&
+      0 == db_index_keysize(&(exprs[0]), sp->base.header, mmp)) {
+    if (sizeof(db_eetnode_attr_t) == exprs[0].size &&
+        (db_uint8)DB_EETNODE_ATTR == exprs[0].nodes->type &&
+        DB_STRING == sp->base.header->types[((db_eetnode_attr_t *)(
+                         exprs[0].nodes))->pos])
+      DB_ERROR_MESSAGE("index key is too long", 0, lexerp->command);
+    else
+      DB_ERROR_MESSAGE("index key must be an integer or a string attribute",
+                       0, lexerp->command);
+    retval = -1;
+  }
+
+  if (1 == retval) {
+    switch (db_index_build(indexname, type, sp, exprs, num_expr, include,
+                           num_include, mmp)) {
+    case 1:
+      if (1 != db_index_register(tablename, indexname, exprs, num_expr,
+                                 include, num_include, mmp)) {
+        DB_ERROR_MESSAGE("could not register index", 0, lexerp->command);
+        db_index_remove(indexname);
+        retval = -1;
+      }
+      break;
+    case -1:
+      DB_ERROR_MESSAGE("table is not in index order", 0, lexerp->command);
+      retval = -1;
+      break;
+    default:
+      DB_ERROR_MESSAGE("could not build index", 0, lexerp->command);
+      retval = -1;
+      break;
+    }
+  }
+
+  while (numparsed > 0) {
+    numparsed--;
+    db_qmm_ffree(mmp, exprs[numparsed].nodes);
+  }
+  return retval;
+}
+
+/**
+@brief		Create an index.
+@details	This function builds an index from a
+                CREATE INDEX name ON table (expr, ...)
+                [INCLUDE (attr, ...)] [USING type]
+                statement and adds it to the table's index metadata.  The
+                type may be BTREE, the default, SKIPLIST, HASH, or INLINE.
+                Only an inline index may have more than one expression, and
+                only if the table is already in order on them.  The
+                attributes listed after INCLUDE are stored with each key of
+                any other index, so that queries needing only them and the
+                key can be answered from the index alone.  This function
+                assumes that the 'CREATE' and 'INDEX' tokens have been thrown
+                away; that is, the next token to process is the index's name.
+@param		lexerp		A pointer to the lexer instance variable that
+                                is generating the token stream.
+@param		end		The index of the first character in the command
+                                being lexed that is not part of the CREATE
+                                statement.
+@param		mmp		A pointer to the per-query memory manager being
+                                used to process this query.
+@returns	@c 1 if the index was created successfully, @c -1 if an error
+                occurred, @c 0 otherwise.
+*/
+db_int createIndex(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
+  char *indexname, *tablename;
+  scan_t scan;
+  db_int retval;
+
+  if (1 != lexer_next(lexerp) || DB_LEXER_TT_IDENT != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing index name", lexerp->offset, lexerp->command);
+    return -1;
+  }
+  indexname = db_qmm_falloc(mmp, gettokenlength(&(lexerp->token)) + 1);
+  gettokenstring(&(lexerp->token), indexname, lexerp);
+
+  if (db_index_exists(indexname)) {
+    DB_ERROR_MESSAGE("duplicate index name", lexerp->token.start,
+                     lexerp->command);
+    db_qmm_ffree(mmp, indexname);
+    return -1;
+  }
+
+  if (1 != lexer_next(lexerp) ||
+      DB_LEXER_TOKENINFO_JOINON != lexerp->token.info ||
+      1 != lexer_next(lexerp) || DB_LEXER_TT_IDENT != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing table name", lexerp->offset, lexerp->command);
+    db_qmm_ffree(mmp, indexname);
+    return -1;
+  }
+  tablename = db_qmm_falloc(mmp, gettokenlength(&(lexerp->token)) + 1);
+  gettokenstring(&(lexerp->token), tablename, lexerp);
+
+  if (1 != init_scan(&scan, tablename, mmp)) {
+    DB_ERROR_MESSAGE("table does not exist", lexerp->token.start,
+                     lexerp->command);
+    db_qmm_ffree(mmp, tablename);
+    db_qmm_ffree(mmp, indexname);
+    return -1;
+  }
+  scan.start = lexerp->token.start;
+
+  retval = buildIndex(lexerp, end, indexname, tablename, &scan, mmp);
+
+  close_scan(&scan, mmp);
+  db_qmm_ffree(mmp, tablename);
+  db_qmm_ffree(mmp, indexname);
+  return retval;
+}
+
+/**
+@brief		Drop an index.
+@details	This function removes the index named by a
+                DROP INDEX name ON table statement from the table's index
+                metadata, then deletes it.  This function assumes that the
+                'DROP' and 'INDEX' tokens have been thrown away.
+@param		lexerp		A pointer to the lexer instance variable that
+                                is generating the token stream.
+@param		end		The index of the first character in the command
+                                being lexed that is not part of the DROP
+                                statement.
+@param		mmp		A pointer to the per-query memory manager being
+                                used to process this query.
+@returns	@c 1 if the index was dropped successfully, @c -1 if an error
+                occurred, @c 0 otherwise.
+*/
+db_int dropIndex(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
+  char *indexname, *tablename;
+  db_int retval = 1;
+
+  if (1 != lexer_next(lexerp) || DB_LEXER_TT_IDENT != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing index name", lexerp->offset, lexerp->command);
+    return -1;
+  }
+  indexname = db_qmm_falloc(mmp, gettokenlength(&(lexerp->token)) + 1);
+  gettokenstring(&(lexerp->token), indexname, lexerp);
+
+  if (1 != lexer_next(lexerp) ||
+      DB_LEXER_TOKENINFO_JOINON != lexerp->token.info ||
+      1 != lexer_next(lexerp) || DB_LEXER_TT_IDENT != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing table name", lexerp->offset, lexerp->command);
+    db_qmm_ffree(mmp, indexname);
+    return -1;
+  }
+  tablename = db_qmm_falloc(mmp, gettokenlength(&(lexerp->token)) + 1);
+  gettokenstring(&(lexerp->token), tablename, lexerp);
+
+  if (end > lexerp->offset) {
+    DB_ERROR_MESSAGE("malformed statement", lexerp->offset, lexerp->command);
+    retval = -1;
+  } else if (1 != db_index_drop(tablename, indexname, mmp)) {
+    DB_ERROR_MESSAGE("no such index", 0, lexerp->command);
+    retval = -1;
+  }
+
+  db_qmm_ffree(mmp, tablename);
+  db_qmm_ffree(mmp, indexname);
+  return retval;
+}
+
 db_int processCreate(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
   lexer_next(lexerp);
   switch (lexerp->token.info) {
@@ -225,6 +610,18 @@ db_int processCreate(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
 #else
     return -1;
 #endif
+  case DB_LEXER_TOKENINFO_LITERAL_INDEX:
+    return createIndex(lexerp, end, mmp);
+  default:
+    return -1;
+  }
+}
+
+db_int processDrop(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
+  lexer_next(lexerp);
+  switch (lexerp->token.info) {
+  case DB_LEXER_TOKENINFO_LITERAL_INDEX:
+    return dropIndex(lexerp, end, mmp);
   default:
     return -1;
   }
@@ -44,6 +44,19 @@ extern "C" {
 */
 db_int processCreate(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp);
 
+/**
+@brief		Process the different DROP statements for the database.
+@param		lexerp		A pointer to the lexer instance variable
+				that is generating the token stream.
+@param		end		The first index of a character in the
+				command being lexed not in this statement.
+@param		mmp		The per-query memory manager being used
+				to allocate memory for this statement.
+@returns	@c 1 if the statement was successful, @c -1 if an error occured,
+		@c 0 otherwise.
+*/
+db_int processDrop(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,7 @@
 /******************************************************************************/
 #include "dbinsert.h"
 #include "../../db_ctconf.h"
+#include "../../dbindex/dbindex.h"
 
 db_int insert_command(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
   lexer_next(lexerp);
@@ -46,6 +47,10 @@ db_int insert_command(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
       return 0;
   }
 
+  /* The name is needed again to update the relation's indexes. */
+  char relationname[tempsize];
+  strcpy(relationname, tempstring);
+
   db_fileref_t relation = db_openappendfile(tempstring);
   db_qmm_ffree(mmp, tempstring);
   struct insert_elem *toinsert =
@@ -243,44 +248,54 @@ db_int insert_command(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
   // TODO: Make sure keys are not set to NULL.
   /* From here on out, we are good. */
 
-  /* Write out nullity information. */
+  /* Build the tuple, so it is written out at once and can be indexed. */
+  db_tuple_t tuple;
+  init_tuple(&tuple, hp->tuple_size, hp->num_attr, mmp);
+
   j = (hp->num_attr) / 8;
   if ((hp->num_attr) % 8 > 0)
     j++;
 
-  db_uint8 isnull[j];
-  for (i = 0; i < j; ++i)
-    isnull[i] = 0;
-
-  for (i = 0; i < hp->num_attr; ++i)
-    if (DB_NULL == toinsert[i].type)
-      isnull[i / 8] |= (1 << (i % 8));
-
-  db_uint8 zero = 0;
-
-  db_filewrite(relation, isnull, j);
-
-  /* Write out tuple data. */
   for (i = 0; i < hp->num_attr; ++i) {
-    if (DB_NULL == toinsert[i].type)
-      for (j = 0; j < hp->sizes[i]; ++j)
-        db_filewrite(relation, &zero, sizeof(char));
-    else if (DB_INT == toinsert[i].type)
-      db_filewrite(relation, &(toinsert[i].val.integer), hp->sizes[i]);
+    char *dest = tuple.bytes + hp->offsets[i];
+    if (DB_NULL == toinsert[i].type) {
+      tuple.isnull[i / 8] |= (1 << (i % 8));
+      memset(dest, 0, hp->sizes[i]);
+    } else if (DB_INT == toinsert[i].type)
+      memcpy(dest, &(toinsert[i].val.integer), hp->sizes[i]);
     else if (DB_DECIMAL == toinsert[i].type)
-      db_filewrite(relation, &(toinsert[i].val.decimal), hp->sizes[i]);
+      memcpy(dest, &(toinsert[i].val.decimal), hp->sizes[i]);
     else if (DB_STRING == toinsert[i].type) {
       int strlength = strlen(toinsert[i].val.string) + 1;
-      db_filewrite(relation, toinsert[i].val.string, strlength);
-      strlength = hp->sizes[i] - strlength;
-      for (j = 0; j < strlength; ++j)
-        db_filewrite(relation, &zero, sizeof(char));
+      memcpy(dest, toinsert[i].val.string, strlength);
+      memset(dest + strlength, 0, hp->sizes[i] - strlength);
     }
   }
 
+  /* Statistics are read while they still match the relation's file. */
+  relation_stats_t stats;
+  db_int hasstats = getrelationstats(&stats, relationname, mmp);
+
+  /* The tuple's record starts where the file ends. */
+  long offset = db_filesize(relation);
+  db_filewrite(relation, tuple.isnull, j);
+  db_filewrite(relation, tuple.bytes, hp->tuple_size);
+  db_fileclose(relation);
+
+  db_int retval = db_index_addtuple(relationname, hp, &tuple, offset, mmp);
+
+  if (1 == hasstats) {
+    statsaddtuple(&stats, &tuple, hp);
+    putrelationstats(&stats, relationname);
+    freerelationstats(&stats, mmp);
+  }
+
+  close_tuple(&tuple, mmp);
   db_qmm_ffree(mmp, insertorder);
   db_qmm_ffree(mmp, toinsert);
   mmp->last_back = freeto;
-  db_fileclose(relation);
-  return 1;
+  if (1 != retval)
+    DB_ERROR_MESSAGE("could not update indexes", lexerp->offset,
+                     lexerp->command);
+  return retval;
 }
@@ -278,8 +278,21 @@ db_int select_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
     return -1;
   }
 
-  if (0 == numexpressions || (1 == numexpressions && NULL == eetarr[0].nodes &&
-                              -1 == eetarr[0].size)) {
+  db_int aggregated = 0;
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+  aggregated = groupby_command(lexerp, rootpp, mmp, eetarr, numexpressions,
+                               tables, numtables);
+  if (-1 == aggregated)
+    return -1;
+#endif
+#endif
+
+  if (1 == aggregated) {
+    /* The aggregate operator projects the expressions itself. */
+  } else if (0 == numexpressions ||
+             (1 == numexpressions && NULL == eetarr[0].nodes &&
+              -1 == eetarr[0].size)) {
     db_qmm_ffree(mmp, eetarr);
     return 1;
   } else if (numexpressions >
@@ -1,6 +1,7 @@
 #include "dbupdate.h"
 
 #include "../dbparser/dbparser.h"
+#include "../../dbindex/dbindex.h"
 
 // ---Assembling struct update_elem---
 void assembling_struct(db_lexer_t *lexerp, struct update_elem *toinsert,
@@ -66,29 +67,71 @@ void assembling_struct(db_lexer_t *lexerp, struct update_elem *toinsert,
   }
 }
 
-// ---Update one element---
-void update_element(relation_header_t *hp, int16_t offset_row, char *tabname,
-                    struct update_elem *elements) {
-  db_fileref_t relatiwrite = db_openreadfile_plus(tabname);
-  db_fileseek(relatiwrite, sizeof(db_uint8));
-  int i = 0;
-  for (; i < hp->num_attr; i++)
-    db_fileseek(relatiwrite, hp->size_name[i] + 4);
+/* The number of matched records kept in memory before their offsets are
+   written out to a temporary file. */
+#define DB_UPDATE_BATCHSIZE 16
 
-  db_fileseek(relatiwrite, offset_row + ((offset_row - 1) * hp->tuple_size));
+// ---Update one tuple---
+/* Put an update's values into a tuple. */
+static void update_tuple(relation_header_t *hp, db_tuple_t *tp,
+                         struct update_elem *elements) {
   for (int i = 0; i < hp->num_attr; i++) {
-    if (elements[i].use == 1) {
-      if (hp->types[i] == DB_INT)
-        db_filewrite(relatiwrite, &elements[i].val.integer, hp->sizes[i]);
-      else if (hp->types[i] == DB_STRING)
-        db_filewrite(relatiwrite, elements[i].val.string, hp->sizes[i]);
-      else if (hp->types[i] == DB_DECIMAL)
-        db_filewrite(relatiwrite, &elements[i].val.decimal, hp->sizes[i]);
-    } else
-      db_fileseek(relatiwrite, hp->sizes[i]);
+    if (elements[i].use != 1)
+      continue;
+    char *dest = tp->bytes + hp->offsets[i];
+    tp->isnull[i / 8] &= ~(1 << (i % 8));
+    if (hp->types[i] == DB_INT)
+      memcpy(dest, &elements[i].val.integer, hp->sizes[i]);
+    else if (hp->types[i] == DB_DECIMAL)
+      memcpy(dest, &elements[i].val.decimal, hp->sizes[i]);
+    else if (hp->types[i] == DB_STRING) {
+      size_t length = strlen(elements[i].val.string) + 1;
+      if (length > hp->sizes[i])
+        length = hp->sizes[i];
+      memcpy(dest, elements[i].val.string, length);
+      memset(dest + length, 0, hp->sizes[i] - length);
+    }
   }
+}
+
+// ---Update a batch of records---
+/* Rewrite the records at some offsets, bringing the relation's indexes and
+   statistics, if it has any, up to date as each is written. */
+static db_int update_records(db_fileref_t relation, db_index_writer_t *wp,
+                             relation_stats_t *statsp,
+                             struct update_elem *elements, long *offsets,
+                             db_int count, db_tuple_t *oldtp,
+                             db_tuple_t *newtp, db_query_mm_t *mmp) {
+  relation_header_t *hp = wp->hp;
+  size_t isnullsize = (size_t)wp->recordsize - hp->tuple_size;
+
+  for (db_int i = 0; i < count; i++) {
+    db_filerewind(relation);
+    db_fileseek(relation, offsets[i]);
+    if (isnullsize != db_fileread(relation, (unsigned char *)oldtp->isnull,
+                                  isnullsize) ||
+        hp->tuple_size != db_fileread(relation, (unsigned char *)oldtp->bytes,
+                                      hp->tuple_size))
+      return 0;
+
+    memcpy(newtp->isnull, oldtp->isnull, isnullsize);
+    memcpy(newtp->bytes, oldtp->bytes, hp->tuple_size);
+    update_tuple(hp, newtp, elements);
+
+    db_filerewind(relation);
+    db_fileseek(relation, offsets[i]);
+    if (isnullsize != db_filewrite(relation, newtp->isnull, isnullsize) ||
+        hp->tuple_size != db_filewrite(relation, newtp->bytes, hp->tuple_size))
+      return 0;
 
-  db_fileclose(relatiwrite);
+    if (1 != db_index_writetuple(wp, oldtp, newtp, offsets[i], mmp))
+      return 0;
+    if (NULL != statsp) {
+      statsremovetuple(statsp, oldtp, hp);
+      statsaddtuple(statsp, newtp, hp);
+    }
+  }
+  return 1;
 }
 
 db_int update_command(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
@@ -158,19 +201,117 @@ db_int update_command(db_lexer_t *lexerp, db_int end, db_query_mm_t *mmp) {
   // TODO: Obligatory to improvement. You need to pull some of the parse
   // functionality inside UPDATE.
   db_op_base_t *root = parse(s_parse, mmp);
+  db_int retval = 1;
   if (root == NULL)
     printf("NULL root UPDATE\n");
   else {
-    init_tuple(&tuple, root->header->tuple_size, root->header->num_attr, mmp);
+    /* Records are only rewritten once the query is done with, so changing
+       an indexed attribute can not make the query meet a record again.
+       Past a batch, the offsets wait in a temporary file. */
+    long pending[DB_UPDATE_BATCHSIZE];
+    db_int numpending = 0;
+    long numspilled = 0;
+    char spillname[11 + strlen(tablename)];
+    db_fileref_t spill = DB_STORAGE_NOFILE;
+    long tuple_start = gettuplestart(hp);
+    long recordsize = (hp->num_attr) / 8 + hp->tuple_size;
+    if ((hp->num_attr) % 8 > 0)
+      recordsize++;
+    sprintf(spillname, "DB_UPDATE_%s", tablename);
 
-    while (next(root, &tuple, mmp) == 1)
-      update_element(root->header, tuple.offset_r, tablename, toinsert);
+    init_tuple(&tuple, root->header->tuple_size, root->header->num_attr, mmp);
+    while (retval == 1 && next(root, &tuple, mmp) == 1) {
+      if (numpending == DB_UPDATE_BATCHSIZE) {
+        if (spill == DB_STORAGE_NOFILE)
+          spill = db_openwritefile(spillname);
+        if (spill == DB_STORAGE_NOFILE ||
+            sizeof(pending) != db_filewrite(spill, pending, sizeof(pending)))
+          retval = 0;
+        numspilled += numpending;
+        numpending = 0;
+      }
+      pending[numpending++] =
+          tuple_start + (long)(tuple.offset_r - 1) * recordsize;
+    }
+    close_tuple(&tuple, mmp);
     closeexecutiontree(root, mmp);
+
+    if (spill != DB_STORAGE_NOFILE) {
+      if (numpending > 0 &&
+          numpending * sizeof(long) !=
+              db_filewrite(spill, pending, numpending * sizeof(long)))
+        retval = 0;
+      numspilled += numpending;
+      db_fileclose(spill);
+      spill = db_openreadfile(spillname);
+      if (spill == DB_STORAGE_NOFILE)
+        retval = 0;
+      numpending = 0;
+    }
+
+    /* Rewriting records leaves the relation's file the same size, so its
+       statistics still match it. */
+    relation_stats_t stats;
+    relation_stats_t *statsp = NULL;
+    if (retval == 1 && 1 == getrelationstats(&stats, tablename, mmp))
+      statsp = &stats;
+
+    db_fileref_t relation = db_openreadfile_plus(tablename);
+    db_index_writer_t writer;
+    db_tuple_t newtuple;
+    if (retval == 1 && relation != DB_STORAGE_NOFILE &&
+        1 == init_index_writer(&writer, tablename, hp, mmp)) {
+      init_tuple(&tuple, hp->tuple_size, hp->num_attr, mmp);
+      init_tuple(&newtuple, hp->tuple_size, hp->num_attr, mmp);
+
+      while (retval == 1 && numspilled > 0) {
+        numpending = numspilled < DB_UPDATE_BATCHSIZE ? (db_int)numspilled
+                                                      : DB_UPDATE_BATCHSIZE;
+        numspilled -= numpending;
+        if (numpending * sizeof(long) !=
+            db_fileread(spill, (unsigned char *)pending,
+                        numpending * sizeof(long)))
+          retval = 0;
+        else
+          retval = update_records(relation, &writer, statsp, toinsert,
+                                  pending, numpending, &tuple, &newtuple, mmp);
+        numpending = 0;
+      }
+      if (retval == 1)
+        retval = update_records(relation, &writer, statsp, toinsert, pending,
+                                numpending, &tuple, &newtuple, mmp);
+
+      close_tuple(&newtuple, mmp);
+      close_tuple(&tuple, mmp);
+      /* Indexes may be rebuilt from the relation, so it must be written
+         out first. */
+      db_fileclose(relation);
+      relation = DB_STORAGE_NOFILE;
+      if (1 != close_index_writer(&writer, mmp))
+        retval = 0;
+    } else
+      retval = 0;
+
+    if (relation != DB_STORAGE_NOFILE)
+      db_fileclose(relation);
+    if (NULL != statsp) {
+      /* Some records may have been rewritten without being counted. */
+      if (retval != 1 || 1 != putrelationstats(statsp, tablename))
+        removerelationstats(tablename);
+      freerelationstats(statsp, mmp);
+    }
+    if (spill != DB_STORAGE_NOFILE) {
+      db_fileclose(spill);
+      db_fileremove(spillname);
+    }
+    if (retval != 1)
+      DB_ERROR_MESSAGE("could not update records", lexerp->offset,
+                       lexerp->command);
   }
 
   db_qmm_ffree(mmp, tablename);
   db_qmm_ffree(mmp, toinsert);
   db_qmm_ffree(mmp, str_where);
   db_qmm_ffree(mmp, s_parse);
-  return 1;
-}
\ No newline at end of file
+  return retval;
+}
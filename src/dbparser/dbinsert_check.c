@@ -62,6 +62,7 @@ db_int insert_check_command(db_lexer_t *lexerp, db_int start, db_int end,
   init_tuple(&tuple, root->header->tuple_size, root->header->num_attr, mmp);
   if (next(root, &tuple, mmp) == 1) {
     int id = getintbyname(&tuple, "id", root->header);
+    close_tuple(&tuple, mmp);
     char *n_command =
         db_qmm_falloc(mmp, strlen("UPDATE TABLE  SET  WHERE id = ;") +
                                strlen(table_name) + strlen(val_table) + 2);
@@ -76,6 +77,7 @@ db_int insert_check_command(db_lexer_t *lexerp, db_int start, db_int end,
 
     retval = update_command(lexerp, end, mmp);
   } else {
+    close_tuple(&tuple, mmp);
     closeexecutiontree(root, mmp);
     db_qmm_ffree(mmp, val_table);
     db_qmm_ffree(mmp, table_name);
@@ -130,7 +130,7 @@ static struct keyword clauses[] = {
     {"INSERT", DB_LEXER_TOKENINFO_COMMANDCLAUSE,
      DB_LEXER_TOKENBCODE_CLAUSE_INSERT},
     {"DROP", DB_LEXER_TOKENINFO_COMMANDCLAUSE,
-     DB_LEXER_TOKENBCODE_UNIMPLEMENTED},
+     DB_LEXER_TOKENBCODE_CLAUSE_DROP},
     {"DELETE", DB_LEXER_TOKENINFO_COMMANDCLAUSE,
      DB_LEXER_TOKENBCODE_CLAUSE_DELETE},
     {"UPDATE", DB_LEXER_TOKENINFO_COMMANDCLAUSE,
@@ -143,6 +143,7 @@ static struct keyword clauses[] = {
      DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY},
     {"HAVING", DB_LEXER_TOKENINFO_UNIMPORTANT,
      DB_LEXER_TOKENBCODE_CLAUSE_HAVING},
+    {"LIMIT", DB_LEXER_TOKENINFO_UNIMPORTANT, DB_LEXER_TOKENBCODE_CLAUSE_LIMIT},
     {"ORDER", DB_LEXER_TOKENINFO_UNIMPORTANT,
      DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY},
     {"SELECT", DB_LEXER_TOKENINFO_COMMANDCLAUSE,
@@ -190,7 +191,11 @@ static struct keyword reservedwords[] = {
      DB_LEXER_TOKENBCODE_UNIMPORTANT},
     {"VALUES", DB_LEXER_TOKENINFO_LITERAL_VALUES,
      DB_LEXER_TOKENBCODE_UNIMPORTANT},
-    {"SET", DB_LEXER_TOKENINFO_LITERAL_SET, DB_LEXER_TOKENBCODE_UNIMPORTANT}};
+    {"SET", DB_LEXER_TOKENINFO_LITERAL_SET, DB_LEXER_TOKENBCODE_UNIMPORTANT},
+    {"INDEX", DB_LEXER_TOKENINFO_LITERAL_INDEX,
+     DB_LEXER_TOKENBCODE_UNIMPORTANT},
+    {"USING", DB_LEXER_TOKENINFO_LITERAL_USING,
+     DB_LEXER_TOKENBCODE_UNIMPORTANT}};
 
 /**
 @brief		Keyword lookup for operators.
@@ -753,7 +758,7 @@ db_int add_delete(db_lexer_t *lexerp, char *command, char *del,
 
   if (type == 1) {// Insert
     for (; i >= 0;) {
-      if (command[--i] == ')')
+      if (--i < 0 || command[i] == ')')
         break;
     }
     if (i != -1) {
@@ -761,7 +766,7 @@ db_int add_delete(db_lexer_t *lexerp, char *command, char *del,
       com_f_del = db_qmm_falloc(mmp, strlength(com_s) + strlength(del_int) + 1);
       com_f_del[0] = '\0';
       strncpy(com_f_del, com_s, i);
-      com_s[i] = '\0';
+      com_f_del[i] = '\0';
       strcat(com_f_del, del_int);
       strcat(com_f_del, &com_s[++i]);
     }
@@ -779,21 +784,50 @@ db_int add_delete(db_lexer_t *lexerp, char *command, char *del,
   return 0;
 }
 
+// Add a condition on __delete to a SELECT, where its conditions end
 static void add_delete_select(db_lexer_t *lexerp, char *command, char *del,
-                              db_query_mm_t *mmp) {
-  db_int n_len = strlength(command) - 1;
-  char c[n_len];
-  strncpy(c, command, n_len);
-  c[n_len] = '\0';
-  char *n_com = db_qmm_falloc(mmp, strlength(del) +
-                                    n_len);
-  sprintf(n_com, "%s%s", c, del);
-
-  command = n_com;
-  lexerp->command = command;
+                              db_int at, db_query_mm_t *mmp) {
+  char *n_com = db_qmm_falloc(mmp, strlength(command) + strlength(del) + 1);
+  strncpy(n_com, command, at);
+  n_com[at] = '\0';
+  strcat(n_com, del);
+  strcat(n_com, command + at);
+
+  lexerp->command = n_com;
   lexerp->length = strlength(n_com);
 }
 
+/* Find where the conditions of a SELECT end.  That is before any clause
+   that is applied after the selection, or else at the end of the command.
+   Whether there is a WHERE clause is set to 0 if there is none, 1 if it is
+   empty and 2 if it has a condition. */
+static db_int select_conditions_end(char *command, db_uint8 *wherep) {
+  db_lexer_t lexer;
+  lexer.command = command;
+  lexer.length = strlength(command);
+  lexer.offset = 0;
+
+  *wherep = 0;
+  while (1 == lexer_next(&lexer)) {
+    if ((db_uint8)DB_LEXER_TT_TERMINATOR == lexer.token.type)
+      return lexer.token.start;
+    if ((db_uint8)DB_LEXER_TT_RESERVED != lexer.token.type ||
+        -1 == whichclause(&(lexer.token), &lexer)) {
+      if (1 == *wherep)
+        *wherep = 2;
+      continue;
+    }
+    if (DB_LEXER_TOKENBCODE_CLAUSE_WHERE == lexer.token.bcode)
+      *wherep = 1;
+    else if (DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY == lexer.token.bcode ||
+             DB_LEXER_TOKENBCODE_CLAUSE_HAVING == lexer.token.bcode ||
+             DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY == lexer.token.bcode ||
+             DB_LEXER_TOKENBCODE_CLAUSE_LIMIT == lexer.token.bcode)
+      return lexer.token.start;
+  }
+  return lexer.length;
+}
+
 static int check_word(char *command, char *word) {
   int j = 0;
   for(int i = 0; i < strlen(command) - 1 && j < strlen(word) - 1; i++)
@@ -803,23 +837,37 @@ static int check_word(char *command, char *word) {
   return -1;
 }
 
+/* Check if a CREATE command makes an index, whose columns are not the
+   relation's. */
+static int is_create_index(char *command) {
+  char *word = command + strlen("CREATE");
+  while (' ' == *word || '\t' == *word || '\n' == *word)
+    word++;
+  return strncmp(word, "INDEX", strlen("INDEX")) == 0;
+}
+
 /*** External functions ***/
 /* Initialize the lexer */
 void lexer_init(db_lexer_t *lexerp, char *command, db_query_mm_t *mmp) {
 #if USE_DELETE_FUNCTIONAL == 1
   db_int checkDel = 0;
-  if (strncmp(command, "CREATE", strlen("CREATE")) == 0) {
+  if (strncmp(command, "CREATE", strlen("CREATE")) == 0 &&
+      !is_create_index(command)) {
     checkDel = add_delete(lexerp, command, ", __delete INT)", 0, mmp);
   } else if (strncmp(command, "INSERT", strlen("INSERT")) == 0) {
     checkDel = add_delete(lexerp, command, ", 0)", 1, mmp);
   } else if (strncmp(command, "SELECT", strlen("SELECT")) == 0 &&
       check_word(command, "__delete") == -1) {
-    if(check_word(command, "WHERE") == -1) {
-      if(command[strlength(command)] != ' ')
-        add_delete_select(lexerp, command, " WHERE __delete = 0;", mmp);
-    } else if(check_word(command, "WHERE") == 0) {
-      if(command[strlength(command)] != ' ')
-        add_delete_select(lexerp, command, " AND __delete = 0;", mmp);
+    db_uint8 where;
+    db_int at = select_conditions_end(command, &where);
+    if (0 == where) {
+      add_delete_select(lexerp, command, " WHERE __delete = 0 ", at, mmp);
+    } else if (2 == where) {
+      add_delete_select(lexerp, command, " AND __delete = 0 ", at, mmp);
+    } else {
+      /* Leave an empty WHERE clause for the parser to report. */
+      lexerp->command = command;
+      lexerp->length = strlength(command);
     }
   } else {
     lexerp->command = command;
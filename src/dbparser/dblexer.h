@@ -137,6 +137,8 @@ typedef enum db_lexer_token_info {
   DB_LEXER_TOKENINFO_LITERAL_VALUES,     /**< @c VALUES keyword. */
   DB_LEXER_TOKENINFO_LITERAL_SET,        /**< @c SET keyword. */
   DB_LEXER_TOKENINFO_LITERAL_INTO,       /**< @c INTO keyword. */
+  DB_LEXER_TOKENINFO_LITERAL_INDEX,      /**< @c INDEX keyword. */
+  DB_LEXER_TOKENINFO_LITERAL_USING,      /**< @c USING keyword. */
   DB_LEXER_TOKENINFO_TYPE_DBINT,         /**< @c INT keyword. */
   DB_LEXER_TOKENINFO_TYPE_DBDECIMAL,     /**< @c DECIMAL keyword. */
   DB_LEXER_TOKENINFO_TYPE_DBSTRING,      /**< @c STRING keyword. */
@@ -155,11 +157,13 @@ typedef enum db_lexer_token_bcode {
   DB_LEXER_TOKENBCODE_CLAUSE_UPDATE,         /**< @c UPDATE command */
   DB_LEXER_TOKENBCODE_CLAUSE_DELETE,         /**< @c DELETE command */
   DB_LEXER_TOKENBCODE_CLAUSE_INSERT,         /**< @c INSERT command */
+  DB_LEXER_TOKENBCODE_CLAUSE_DROP,           /**< @c DROP command */
   DB_LEXER_TOKENBCODE_CLAUSE_FROM,           /**< @c FROM clause. */
   DB_LEXER_TOKENBCODE_CLAUSE_WHERE,          /**< @c WHERE clause. */
   DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY,        /**< @c GROUP @c BY clause. */
   DB_LEXER_TOKENBCODE_CLAUSE_HAVING,         /**< @c HAVING clause.*/
   DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY,        /**< @c ORDER @c BY clause. */
+  DB_LEXER_TOKENBCODE_CLAUSE_LIMIT,          /**< @c LIMIT clause. */
   DB_LEXER_TOKENBCODE_CLAUSE_SELECT,         /**< @c SELECT command. */
   DB_LEXER_TOKENBCODE_JOIN_ABSOLUTE,         /**< @c JOIN keyword. */
   DB_LEXER_TOKENBCODE_JOINDECORATOR_LEFT,    /**< @c LEFT keyword. */
@@ -163,6 +163,28 @@ db_int parseexpr_pop(db_int type, db_eetnode_t **exprp, db_eetnode_t *stack,
 #error "MACRO NAME CLASH ON ISFUNC!"
 #endif
 
+/* Check if a '*' is the only argument of a COUNT, as in COUNT(*).  The
+   COUNT's node lies on the stack right under the '(' it was given. */
+static db_uint8 parseexpr_iscountall(db_lexer_t *lexerp, db_int end,
+                                     db_eetnode_t *stack,
+                                     db_eetnode_t *stack_top) {
+  db_lexer_t peek = *lexerp;
+  db_eetnode_aggr_temp_t *aggrp;
+
+  if ((db_uint8)DB_EETNODE_OP_MULT != lexerp->token.bcode ||
+      (db_uint8)DB_EETNODE_LPAREN != stack_top->type ||
+      POINTERBYTEDIST(stack, stack_top) <= (db_int)sizeof(db_eetnode_t))
+    return 0;
+  aggrp = POINTERATNBYTES(stack_top, sizeof(db_eetnode_t),
+                          db_eetnode_aggr_temp_t *);
+  if ((db_uint8)DB_EETNODE_AGGR_TEMP != aggrp->base.type ||
+      (db_uint8)DB_AGGR_COUNTROWS != aggrp->aggr_type)
+    return 0;
+  return peek.offset < end && 1 == lexer_next(&peek) &&
+         peek.token.start < end &&
+         (db_uint8)DB_LEXER_TT_RPAREN == peek.token.type;
+}
+
 // TODO: Error messages.
 db_int parseexpression(db_eetnode_t **exprp, db_lexer_t *lexerp, db_int start,
                        db_int end, db_query_mm_t *mmp, db_uint8 jointolast) {
@@ -294,6 +316,20 @@ db_int parseexpression(db_eetnode_t **exprp, db_lexer_t *lexerp, db_int start,
         newnodep->tokenstart = attr_s;
         newnodep->pos = 1;
       }
+    } else if ((db_uint8)DB_LEXER_TT_OP == lexerp->token.type &&
+               DB_EETNODE_LPAREN == lasttype &&
+               1 == parseexpr_iscountall(lexerp, end, stack, stack_top)) {
+      /* Every tuple is counted, just as by COUNT(1). */
+      if (1 != db_qmm_fextend(mmp, sizeof(db_eetnode_dbint_t))) {
+        return -1;
+      }
+      db_eetnode_dbint_t *newnodep =
+          POINTERATNBYTES(*exprp, size, db_eetnode_dbint_t *);
+      size += sizeof(db_eetnode_dbint_t);
+
+      newnodep->base.type = DB_EETNODE_CONST_DBINT;
+      newnodep->integer = 1;
+      lasttype = DB_EETNODE_CONST_DBINT;
     } else if ((db_uint8)DB_LEXER_TT_OP == lexerp->token.type) {
       db_int type = lexerp->token.bcode;
 
@@ -364,6 +400,9 @@ db_int parseexpression(db_eetnode_t **exprp, db_lexer_t *lexerp, db_int start,
       }
       stack_top->type = DB_EETNODE_AGGR_TEMP;
       ((db_eetnode_aggr_temp_t *)stack_top)->aggr_type = lexerp->token.bcode;
+      /* There is no value until an aggregate operator supplies one. */
+      ((db_eetnode_aggr_temp_t *)stack_top)->value_p = NULL;
+      ((db_eetnode_aggr_temp_t *)stack_top)->aggr_isnull = 0;
 
       if (lexerp->offset < end && 1 == lexer_next(lexerp) &&
           lexerp->token.start < end &&
@@ -499,7 +538,9 @@ db_int setupattribute(db_eetnode_attr_t *attrnodep, db_lexer_t *lexerp,
                       db_op_base_t *evalpoint, scan_t *scans, db_uint8 numscans,
                       int depth) {
   /* Walk the query tree, from given point. */
-  if (DB_NTJOIN == evalpoint->type || DB_OSIJOIN == evalpoint->type) {
+  if (DB_NTJOIN == evalpoint->type || DB_OSIJOIN == evalpoint->type ||
+      DB_HASHJOIN == evalpoint->type || DB_SMJOIN == evalpoint->type ||
+      DB_BNLJOIN == evalpoint->type) {
     db_int retval;
 
     /* Try left child. */
@@ -527,7 +568,30 @@ db_int setupattribute(db_eetnode_attr_t *attrnodep, db_lexer_t *lexerp,
   } else if ((DB_PROJECT == evalpoint->type ||
               DB_AGGREGATE == evalpoint->type) &&
              depth > 0) {
-    // TODO What to do here?  Simply error?  Not clear.
+    /* Only the columns it outputs can be named, by the names or aliases it
+       gives them.  A table name before the column's is passed over. */
+    db_lexer_token_t temptoken;
+    if (2 == attrnodep->pos) {
+      gettokenat(&temptoken, *lexerp, attrnodep->tokenstart, 2);
+      attrnodep->tokenstart = temptoken.start;
+    } else if (1 != attrnodep->pos) {
+      DB_ERROR_MESSAGE("unsupported - database identifier",
+                       attrnodep->tokenstart, lexerp->command);
+      return -1;
+    }
+
+    gettokenat(&temptoken, *lexerp, attrnodep->tokenstart, 0);
+    char attrname[gettokenlength(&temptoken) + 1];
+    gettokenstring(&temptoken, attrname, lexerp);
+
+    db_int retval = getposbyname(evalpoint->header, attrname);
+    if (-1 == retval) {
+      DB_ERROR_MESSAGE("attribute does not exist", attrnodep->tokenstart,
+                       lexerp->command);
+      return -1;
+    }
+    attrnodep->pos = (db_uint8)retval;
+    attrnodep->tuple_pos = 0;
   } else if (1 == numopchildren(evalpoint)) {
     db_int retval = setupattribute(attrnodep, lexerp,
                                    ((db_op_onechild_t *)evalpoint)->child,
@@ -628,3 +692,175 @@ db_int verifysetupattributes(db_eet_t *eetp, db_lexer_t *lexerp,
 
   return 1;
 }
+
+/* Check if an expression has an aggregate function in it. */
+db_uint8 hasaggregate(db_eet_t *eetp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  if (NULL == cursor)
+    return 0;
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_AGGR_TEMP == cursor->type)
+      return 1;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  return 0;
+}
+
+/* A subexpression seen while folding. */
+typedef struct {
+  db_int start;      /* Byte offset of its first node. */
+  db_uint8 isconst;  /* 1 if it has only integer or NULL constants. */
+  db_uint8 roottype; /* The type of its last node. */
+} db_foldentry_t;
+
+/* Check if a subexpression can only be 0, 1 or NULL. */
+static db_uint8 foldisboolean(db_uint8 type) {
+  return (db_uint8)DB_EETNODE_OP_NOT == type ||
+         ((db_uint8)DB_EETNODE_OP_AND <= type &&
+          (db_uint8)DB_EETNODE_OP_XOR >= type) ||
+         ((db_uint8)DB_EETNODE_OP_LT <= type &&
+          (db_uint8)DB_EETNODE_OP_ISNULL >= type);
+}
+
+/* Find the integer a subexpression is, if it is a single integer node. */
+static db_uint8 foldintvalue(db_eetnode_t *nodes, db_foldentry_t *entryp,
+                             db_int end, db_int *valuep) {
+  db_eetnode_t *nodep = POINTERATNBYTES(nodes, entryp->start, db_eetnode_t *);
+  if ((db_uint8)DB_EETNODE_CONST_DBINT != nodep->type ||
+      (db_int)sizeof(db_eetnode_dbint_t) != end - entryp->start)
+    return 0;
+  *valuep = ((db_eetnode_dbint_t *)nodep)->integer;
+  return 1;
+}
+
+db_int foldexpression(db_eet_t *eetp, db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  db_eetnode_t *next, *nodep;
+  db_foldentry_t *entries, *left, *right;
+  db_int numnodes = 0, depth = 0, top = 0, write = 0, read, numreqvals;
+  db_int value, end;
+  db_eet_t sub;
+
+  /* Only fold expressions made of nodes we understand, so that nothing
+     is changed if the expression is not well formed. */
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type ||
+        ((db_uint8)DB_EETNODE_CONST_NULL <= cursor->type &&
+         (db_uint8)DB_EETNODE_CONST_DBSTRING >= cursor->type)) {
+      depth++;
+    } else if ((db_uint8)DB_EETNODE_OP_UNARYNEG <= cursor->type &&
+               (db_uint8)DB_EETNODE_FUNC_LENGTH_DBSTRING >= cursor->type) {
+      numreqvals = eet_numrequiredvals(cursor->type);
+      if (numreqvals > depth)
+        return 0;
+      depth = depth - numreqvals + 1;
+    } else {
+      return 0;
+    }
+    numnodes++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  if (1 != depth)
+    return 0;
+
+  entries = DB_QMM_BALLOC(mmp, (size_t)numnodes * sizeof(db_foldentry_t));
+  if (NULL == entries)
+    return 0;
+
+  /* Nodes are moved down over the ones folded away, so the write offset never
+     passes the read offset. */
+  cursor = eetp->nodes;
+  while ((read = POINTERBYTEDIST(cursor, eetp->nodes)) < eetp->size) {
+    next = cursor;
+    advanceeetnodepointer(&next, 1);
+    nodep = POINTERATNBYTES(eetp->nodes, write, db_eetnode_t *);
+    memmove(nodep, cursor, (size_t)POINTERBYTEDIST(next, cursor));
+    end = write + POINTERBYTEDIST(next, cursor);
+
+    if ((db_uint8)DB_EETNODE_OP_UNARYNEG > nodep->type) {
+      entries[top].start = write;
+      entries[top].isconst =
+          ((db_uint8)DB_EETNODE_CONST_NULL == nodep->type ||
+           (db_uint8)DB_EETNODE_CONST_DBINT == nodep->type);
+      entries[top].roottype = nodep->type;
+      top++;
+      write = end;
+      cursor = next;
+      continue;
+    }
+
+    numreqvals = eet_numrequiredvals(nodep->type);
+    left = &(entries[top - numreqvals]);
+    right = &(entries[top - 1]);
+    top = top - numreqvals + 1;
+    left->roottype = nodep->type;
+
+    if (left->isconst && right->isconst &&
+        (db_uint8)DB_EETNODE_FUNC_LENGTH_DBSTRING != nodep->type) {
+      /* Every operand is constant, so evaluate it now. */
+      sub.nodes = POINTERATNBYTES(eetp->nodes, left->start, db_eetnode_t *);
+      sub.size = end - left->start;
+      sub.stack_size = 2 * sub.size;
+      switch (evaluate_eet(&sub, &value, NULL, NULL, 0, mmp)) {
+      case 1:
+        if ((db_int)sizeof(db_eetnode_dbint_t) <= sub.size) {
+          sub.nodes->type = DB_EETNODE_CONST_DBINT;
+          ((db_eetnode_dbint_t *)sub.nodes)->integer = value;
+          left->roottype = DB_EETNODE_CONST_DBINT;
+          end = left->start + (db_int)sizeof(db_eetnode_dbint_t);
+        }
+        break;
+      case 2:
+        sub.nodes->type = DB_EETNODE_CONST_NULL;
+        left->roottype = DB_EETNODE_CONST_NULL;
+        end = left->start + (db_int)sizeof(db_eetnode_t);
+        break;
+      default:
+        left->isconst = 0;
+        break;
+      }
+    } else if ((db_uint8)DB_EETNODE_OP_AND == nodep->type ||
+               (db_uint8)DB_EETNODE_OP_OR == nodep->type) {
+      /* A constant side can decide the result, or be dropped. */
+      db_foldentry_t *other = NULL;
+      db_uint8 decides = (db_uint8)DB_EETNODE_OP_OR == nodep->type;
+
+      if (foldintvalue(eetp->nodes, left, right->start, &value))
+        other = right;
+      else if (foldintvalue(eetp->nodes, right, write, &value))
+        other = left;
+
+      if (NULL != other && decides == value) {
+        nodep = POINTERATNBYTES(eetp->nodes, left->start, db_eetnode_t *);
+        nodep->type = DB_EETNODE_CONST_DBINT;
+        ((db_eetnode_dbint_t *)nodep)->integer = value;
+        left->isconst = 1;
+        left->roottype = DB_EETNODE_CONST_DBINT;
+        end = left->start + (db_int)sizeof(db_eetnode_dbint_t);
+      } else if (NULL != other && (!decides) == value &&
+                 foldisboolean(other->roottype)) {
+        if (other == right) {
+          memmove(POINTERATNBYTES(eetp->nodes, left->start, db_eetnode_t *),
+                  POINTERATNBYTES(eetp->nodes, right->start, db_eetnode_t *),
+                  (size_t)(write - right->start));
+          end = left->start + (write - right->start);
+        } else {
+          end = right->start;
+        }
+        left->isconst = 0;
+        left->roottype = other->roottype;
+      } else {
+        left->isconst = 0;
+      }
+    } else {
+      left->isconst = 0;
+    }
+
+    write = end;
+    cursor = next;
+  }
+
+  eetp->size = write;
+  DB_QMM_BFREE(mmp, entries);
+  return 1;
+}
@@ -92,6 +92,30 @@ db_int verifysetupattributes(db_eet_t *eetp,
 				db_uint8 numscans,
 				int startdepth);
 
+/**
+@brief		Check if an expression has an aggregate function in it.
+@param		eetp		A pointer to the expression.
+@returns	@c 1 if it does, @c 0 otherwise.
+*/
+db_uint8 hasaggregate(db_eet_t *eetp);
+
+/**
+@brief		Fold the constant parts of an expression.
+@details	Operators whose operands are all integer or @c NULL constants
+		are evaluated once, here, and replaced by their result.  An
+		@c AND with a constant @c 0 side, or an @c OR with a constant
+		@c 1 side, is replaced by that constant, and a constant side
+		that cannot change the result of a condition is dropped.  The
+		expression is rewritten in place and only ever shrinks.
+@param		eetp		A pointer to the expression to be folded.  Its
+				attributes must already be set up.
+@param		mmp		A pointer to the per-query memory manager that
+				is being used for this query.
+@returns	@c 1 if the expression was folded, @c 0 if it was left as it
+		was.
+*/
+db_int foldexpression(db_eet_t *eetp, db_query_mm_t *mmp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -99,6 +99,21 @@ size_t queryTreeToStringSize(db_op_base_t *root, int depth) {
     size += queryTreeToStringSize(((ntjoin_t *)root)->lchild, depth + 1);
     size += queryTreeToStringSize(((ntjoin_t *)root)->rchild, depth + 1);
     break;
+  case DB_HASHJOIN:
+    size += (8 + depth + 2);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->lchild, depth + 1);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->rchild, depth + 1);
+    break;
+  case DB_SMJOIN:
+    size += (6 + depth + 2);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->lchild, depth + 1);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->rchild, depth + 1);
+    break;
+  case DB_BNLJOIN:
+    size += (7 + depth + 2);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->lchild, depth + 1);
+    size += queryTreeToStringSize(((ntjoin_t *)root)->rchild, depth + 1);
+    break;
   case DB_SCAN:
     size += (4 + depth + 2);
     break;
@@ -114,6 +129,10 @@ size_t queryTreeToStringSize(db_op_base_t *root, int depth) {
     size += (4 + depth + 2);
     size += queryTreeToStringSize(((sort_t *)root)->child, depth + 1);
     break;
+  case DB_TOPN:
+    size += (4 + depth + 2);
+    size += queryTreeToStringSize(((topn_t *)root)->child, depth + 1);
+    break;
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
   case DB_AGGREGATE:
@@ -150,6 +169,21 @@ void queryTreeToStringHelper(db_op_base_t *root, char **strp, int depth) {
     queryTreeToStringHelper(((ntjoin_t *)root)->lchild, strp, depth + 1);
     queryTreeToStringHelper(((ntjoin_t *)root)->rchild, strp, depth + 1);
     break;
+  case DB_HASHJOIN:
+    strcat(*strp, "HASHJOIN\n");
+    queryTreeToStringHelper(((ntjoin_t *)root)->lchild, strp, depth + 1);
+    queryTreeToStringHelper(((ntjoin_t *)root)->rchild, strp, depth + 1);
+    break;
+  case DB_SMJOIN:
+    strcat(*strp, "SMJOIN\n");
+    queryTreeToStringHelper(((ntjoin_t *)root)->lchild, strp, depth + 1);
+    queryTreeToStringHelper(((ntjoin_t *)root)->rchild, strp, depth + 1);
+    break;
+  case DB_BNLJOIN:
+    strcat(*strp, "BNLJOIN\n");
+    queryTreeToStringHelper(((ntjoin_t *)root)->lchild, strp, depth + 1);
+    queryTreeToStringHelper(((ntjoin_t *)root)->rchild, strp, depth + 1);
+    break;
   case DB_SCAN:
     strcat(*strp, "SCAN\n");
     break;
@@ -165,6 +199,10 @@ void queryTreeToStringHelper(db_op_base_t *root, char **strp, int depth) {
     strcat(*strp, "SORT\n");
     queryTreeToStringHelper(((sort_t *)root)->child, strp, depth + 1);
     break;
+  case DB_TOPN:
+    strcat(*strp, "TOPN\n");
+    queryTreeToStringHelper(((topn_t *)root)->child, strp, depth + 1);
+    break;
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
   case DB_AGGREGATE:
@@ -221,14 +259,57 @@ db_int lasttoken(db_lexer_t lexer, db_int end) {
 }
 /******************************************************************************/
 
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+/* Check if a query aggregates its tuples. */
+/**
+@brief		Check if a query groups its tuples or has an aggregate function
+		in its SELECT clause.
+@param		lexer		The lexer for the query.
+@param		clausestack_bottom	The bottom of the clause stack.
+@param		clausestack_top		The top of the clause stack.
+@returns	@c 1 if the query aggregates its tuples, @c 0 otherwise.
+*/
+static db_uint8 isaggregated(db_lexer_t lexer,
+                             struct clausenode *clausestack_bottom,
+                             struct clausenode *clausestack_top) {
+  struct clausenode *np;
+  for (np = clausestack_top; np != clausestack_bottom; ++np) {
+    if (DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY == np->bcode ||
+        DB_LEXER_TOKENBCODE_CLAUSE_HAVING == np->bcode)
+      return 1;
+    if (DB_LEXER_TOKENBCODE_CLAUSE_SELECT == np->bcode) {
+      lexer.offset = np->start;
+      while (np->end > lexer.offset && 1 == lexer_next(&lexer))
+        if ((db_uint8)DB_LEXER_TT_AGGRFUNC == lexer.token.type)
+          return 1;
+    }
+  }
+  return 0;
+}
+#endif
+#endif
+
+/* The order in which a clause is processed.  The LIMIT and ORDER BY clauses
+   of a query that aggregates apply to the groups, so they come after the
+   SELECT clause that builds the aggregate, and after every other clause. */
+static db_int clauserank(struct clausenode *np, db_uint8 aggregated) {
+  if (aggregated && (DB_LEXER_TOKENBCODE_CLAUSE_LIMIT == np->bcode ||
+                     DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY == np->bcode))
+    return 0x100 + (db_int)np->clause_i;
+  return (db_int)np->clause_i;
+}
+
 void sort_clauses(struct clausenode *clausestack_bottom,
-                  struct clausenode *clausestack_top) {
+                  struct clausenode *clausestack_top, db_uint8 aggregated) {
   /* Sort clauses. TODO: Better sorting algorithm? Does it matter? */
-  for (db_int j = 1; j < clausestack_bottom - clausestack_top; ++j) {
-    for (db_int i = j; i < clausestack_bottom - clausestack_top; ++i) {
-      if (clausestack_top[i - 1].clause_i > clausestack_top[i].clause_i) {
-        symswapbytes((char *)clausestack_top, (char *)&clausestack_top[i],
-                     sizeof(struct clausenode));
+  db_int n = clausestack_bottom - clausestack_top;
+  for (db_int j = 1; j < n; ++j) {
+    for (db_int i = 1; i < n - j + 1; ++i) {
+      if (clauserank(&clausestack_top[i - 1], aggregated) >
+          clauserank(&clausestack_top[i], aggregated)) {
+        symswapbytes((char *)&clausestack_top[i - 1],
+                     (char *)&clausestack_top[i], sizeof(struct clausenode));
       }
     }
   }
@@ -281,6 +362,22 @@ void process_next_clause(db_lexer_t *lexer, db_op_base_t **rootp,
     *retval = select_command(lexer, rootp, mmp, top->start, top->end, *tables,
                              *numtables);
     break;
+  case DB_LEXER_TOKENBCODE_CLAUSE_LIMIT:
+    *retval = limit_command(lexer, rootp, mmp, top->start, top->end);
+    break;
+  case DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY:
+    *retval = orderby_command(lexer, rootp, mmp, top->start, top->end, *tables,
+                              *numtables);
+    break;
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+  case DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY:
+  case DB_LEXER_TOKENBCODE_CLAUSE_HAVING:
+    /* These are parsed along with the SELECT clause. */
+    *retval = 1;
+    break;
+#endif
+#endif
   //#if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
   //    1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
   case DB_LEXER_TOKENBCODE_CLAUSE_CREATE:
@@ -289,6 +386,12 @@ void process_next_clause(db_lexer_t *lexer, db_op_base_t **rootp,
     if(*retval == 1)
       *rootp = DB_PARSER_OP_NONE;
     break;
+  case DB_LEXER_TOKENBCODE_CLAUSE_DROP:
+    lexer->offset = top->start;
+    *retval = processDrop(lexer, top->end, mmp);
+    if(*retval == 1)
+      *rootp = DB_PARSER_OP_NONE;
+    break;
   case DB_LEXER_TOKENBCODE_CLAUSE_INSERT:
 #if USE_DELETE_FUNCTIONAL == 1
     *retval = insert_check_command(lexer, top->start, top->end, mmp);
@@ -303,7 +406,7 @@ void process_next_clause(db_lexer_t *lexer, db_op_base_t **rootp,
     lexer_next(lexer);
     *retval = update_command(lexer, top->end, mmp);
     if(*retval == 1)
-      rootp = DB_PARSER_OP_NONE;
+      *rootp = DB_PARSER_OP_NONE;
     break;
   case DB_LEXER_TOKENBCODE_CLAUSE_DELETE:
     lexer->offset = top->start;
@@ -316,6 +419,484 @@ void process_next_clause(db_lexer_t *lexer, db_op_base_t **rootp,
   //#endif
 }
 
+/* Find a bound on an attribute in a comparison with a constant. */
+/**
+@brief		Find the bound a comparison between an attribute and a
+		constant puts on the attribute.
+@details	An integer attribute may be bounded by any comparison with
+		an integer, but a string attribute only by being equal to a
+		string.  A string attribute said to equal two different strings
+		is given an empty range.
+@param		nodes		The nodes of the expression, in order.
+@param		start		For each node, the first node of the
+				expression it is the root of.
+@param		relop		Which node is the comparison.
+@param		hp		The relation's header.
+@param		attrpp		A pointer to where the compared attribute will
+				be written.
+@param		lowp		A pointer to the lower bound to narrow.
+@param		highp		A pointer to the upper bound to narrow.
+@param		stringp		A pointer to the string a string attribute
+				equals, or @c NULL if none is known yet.
+@returns	@c 1 if the comparison bounds the attribute, @c 0 otherwise.
+*/
+static db_int indexbound(db_eetnode_t **nodes, db_int *start, db_int relop,
+                         relation_header_t *hp, db_eetnode_attr_t **attrpp,
+                         db_int *lowp, db_int *highp, char **stringp) {
+  db_eetnode_t *left, *right;
+  db_uint8 type = nodes[relop]->type;
+  db_int value;
+  char *string;
+
+  if ((db_uint8)DB_EETNODE_OP_LT != type &&
+      (db_uint8)DB_EETNODE_OP_GT != type &&
+      (db_uint8)DB_EETNODE_OP_LTE != type &&
+      (db_uint8)DB_EETNODE_OP_GTE != type && (db_uint8)DB_EETNODE_OP_EQ != type)
+    return 0;
+
+  /* The right operand is just before the comparison, the left just before
+     that. */
+  right = nodes[relop - 1];
+  if (start[relop - 1] < 1)
+    return 0;
+  left = nodes[start[relop - 1] - 1];
+
+  /* Put the attribute on the left, turning the comparison around. */
+  if (((db_uint8)DB_EETNODE_CONST_DBINT == left->type ||
+       (db_uint8)DB_EETNODE_CONST_DBSTRING == left->type) &&
+      (db_uint8)DB_EETNODE_ATTR == right->type) {
+    db_eetnode_t *temp = left;
+    left = right;
+    right = temp;
+    if ((db_uint8)DB_EETNODE_OP_LT == type)
+      type = (db_uint8)DB_EETNODE_OP_GT;
+    else if ((db_uint8)DB_EETNODE_OP_GT == type)
+      type = (db_uint8)DB_EETNODE_OP_LT;
+    else if ((db_uint8)DB_EETNODE_OP_LTE == type)
+      type = (db_uint8)DB_EETNODE_OP_GTE;
+    else if ((db_uint8)DB_EETNODE_OP_GTE == type)
+      type = (db_uint8)DB_EETNODE_OP_LTE;
+  }
+  if ((db_uint8)DB_EETNODE_ATTR == left->type &&
+      (db_uint8)DB_EETNODE_CONST_DBSTRING == right->type &&
+      (db_uint8)DB_EETNODE_OP_EQ == type &&
+      DB_STRING == hp->types[((db_eetnode_attr_t *)left)->pos]) {
+    string = ((db_eetnode_dbstring_t *)right)->string;
+    *attrpp = (db_eetnode_attr_t *)left;
+    if (NULL == *stringp) {
+      *stringp = string;
+    } else if (0 != strcmp(*stringp, string)) {
+      *lowp = DB_INT_MAX;
+      *highp = DB_INT_MIN;
+    }
+    return 1;
+  }
+  if ((db_uint8)DB_EETNODE_ATTR != left->type ||
+      (db_uint8)DB_EETNODE_CONST_DBINT != right->type ||
+      DB_INT != hp->types[((db_eetnode_attr_t *)left)->pos])
+    return 0;
+
+  /* Nothing is bigger than the biggest integer, or smaller than the
+     smallest, so those comparisons are left for the selection. */
+  value = ((db_eetnode_dbint_t *)right)->integer;
+  if (((db_uint8)DB_EETNODE_OP_GT == type && DB_INT_MAX == value) ||
+      ((db_uint8)DB_EETNODE_OP_LT == type && DB_INT_MIN == value))
+    return 0;
+
+  *attrpp = (db_eetnode_attr_t *)left;
+  if ((db_uint8)DB_EETNODE_OP_GT == type)
+    value++;
+  else if ((db_uint8)DB_EETNODE_OP_LT == type)
+    value--;
+  if ((db_uint8)DB_EETNODE_OP_LT != type && (db_uint8)DB_EETNODE_OP_LTE != type &&
+      value > *lowp)
+    *lowp = value;
+  if ((db_uint8)DB_EETNODE_OP_GT != type && (db_uint8)DB_EETNODE_OP_GTE != type &&
+      value < *highp)
+    *highp = value;
+  return 1;
+}
+
+/* Find the bounds a selection puts on the key of an index. */
+/**
+@brief		Find the bounds a selection puts on the key of an index.
+@param		sp		The scan whose relation the index is on.
+@param		indexon		Which index.
+@param		nodes		The nodes of the selection's condition, in
+				order.
+@param		start		For each node, the first node of the
+				expression it is the root of.
+@param		bound		For each node, the attribute it bounds, or
+				@c -1.
+@param		numnodes	The number of nodes.
+@param		values		Where the value of each leading key
+				expression bound to a single integer will be
+				written, or @c NULL.
+@param		strings		Where the value of each leading key
+				expression bound to a single string will be
+				written, or @c NULL.
+@param		lowp		A pointer to where the lower bound on the key
+				expression after those will be written.
+@param		highp		A pointer to where the upper bound on the key
+				expression after those will be written.
+@returns	The number of leading key expressions bound to a single value.
+*/
+static db_int keybounds(scan_t *sp, db_uint8 indexon, db_eetnode_t **nodes,
+                        db_int *start, db_int *bound, db_int numnodes,
+                        db_int *values, char **strings, db_int *lowp,
+                        db_int *highp) {
+  db_eet_t *exprs = sp->idx_meta_data.exprs[indexon];
+  db_eetnode_attr_t *attrp;
+  db_int numeq, i, pos;
+  char *string;
+
+  for (numeq = 0; numeq < sp->idx_meta_data.num_expr[indexon]; ++numeq) {
+    *lowp = DB_INT_MIN;
+    *highp = DB_INT_MAX;
+    string = NULL;
+
+    /* Only keys made of attributes can be bound. */
+    if (sizeof(db_eetnode_attr_t) != exprs[numeq].size ||
+        (db_uint8)DB_EETNODE_ATTR != exprs[numeq].nodes->type)
+      break;
+    pos = ((db_eetnode_attr_t *)(exprs[numeq].nodes))->pos;
+    for (i = 0; i < numnodes; ++i)
+      if (pos == bound[i])
+        indexbound(nodes, start, i, sp->base.header, &attrp, lowp, highp,
+                   &string);
+
+    /* A string is only bound if it is said to equal one string, short
+       enough to be stored. */
+    if (DB_STRING == sp->base.header->types[pos]) {
+      if (NULL == string || *lowp > *highp ||
+          strlen(string) >= (size_t)(sp->base.header->sizes[pos])) {
+        *lowp = DB_INT_MIN;
+        *highp = DB_INT_MAX;
+        break;
+      }
+      if (NULL != strings)
+        strings[numeq] = string;
+      continue;
+    }
+    if (*lowp != *highp)
+      break;
+    if (NULL != values)
+      values[numeq] = *lowp;
+  }
+  return numeq;
+}
+
+/* Setup an indexed scan from the conditions of a selection. */
+/**
+@brief		Setup a scan to read only the tuples an index finds for the
+		bounds a selection puts on the index's key.
+@details	Each comparison between an attribute and an integer constant
+		that must hold for the whole condition to hold bounds the
+		attribute, as does a string attribute being equal to a string
+		constant, and the bounds on an attribute are combined, so
+		@c a @c >= @c 3 @c AND @c a @c < @c 7 reads only the tuples
+		whose @c a is between @c 3 and @c 6.  A key of several
+		attributes is bound by single values on its first few, and
+		a range on the one after, like @c d @c = @c 2 @c AND
+		@c ts @c >= @c 100 for a key on @c (d, @c ts).  The index
+		whose key is bound tightest, and that can be used, is picked.
+		If the index finds exactly the tuples in the bounds, the
+		comparisons it took care of are taken out of the condition,
+		and what is left is checked by the selection as before.  A
+		relation kept in order by an inline index is instead read
+		from the first tuple in the bounds until the last, and the
+		condition is left as it is.
+@param		sp		A pointer to the scan to setup.
+@param		eetp		A pointer to the selection's condition.
+@param		mmp		A pointer to the memory manager instance being
+				used to allocate memory for this query.
+@returns	@c 1 if an index is used, @c 0 otherwise.
+*/
+static db_int setupindexedscan(scan_t *sp, db_eet_t *eetp,
+                               db_query_mm_t *mmp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  db_int numnodes = 0, depth = 0, i, j, k, numreqvals;
+
+  /* Only plan for expressions made of nodes we understand. */
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type ||
+        ((db_uint8)DB_EETNODE_CONST_NULL <= cursor->type &&
+         (db_uint8)DB_EETNODE_CONST_DBSTRING >= cursor->type)) {
+      depth++;
+    } else if ((db_uint8)DB_EETNODE_OP_UNARYNEG <= cursor->type &&
+               (db_uint8)DB_EETNODE_FUNC_LENGTH_DBSTRING >= cursor->type) {
+      numreqvals = eet_numrequiredvals(cursor->type);
+      if (numreqvals > depth)
+        return 0;
+      depth = depth - numreqvals + 1;
+    } else {
+      return 0;
+    }
+    numnodes++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  if (1 != depth)
+    return 0;
+
+  db_eetnode_t *nodes[numnodes + 1];
+  db_int start[numnodes], parent[numnodes], stack[numnodes];
+  db_int bound[numnodes]; /* The attribute a node bounds, or -1. */
+  db_uint8 present[numnodes];
+  db_uint8 tried[sp->idx_meta_data.num_idx + 1];
+  db_int top = 0;
+
+  /* Find where each node's operands start, and which node each is an
+     operand of. */
+  cursor = eetp->nodes;
+  for (i = 0; i < numnodes; ++i) {
+    nodes[i] = cursor;
+    parent[i] = -1;
+    start[i] = i;
+    if ((db_uint8)DB_EETNODE_OP_UNARYNEG <= cursor->type) {
+      numreqvals = eet_numrequiredvals(cursor->type);
+      for (j = 0; j < numreqvals; ++j) {
+        top--;
+        parent[stack[top]] = i;
+        start[i] = start[stack[top]];
+      }
+    }
+    stack[top] = i;
+    top++;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  nodes[numnodes] = cursor;
+
+  /* Only comparisons that everything above is an AND of must hold. */
+  for (i = 0; i < numnodes; ++i) {
+    db_eetnode_attr_t *attrp;
+    db_int low = DB_INT_MIN, high = DB_INT_MAX;
+    char *string = NULL;
+    bound[i] = -1;
+    for (j = parent[i];
+         -1 != j && (db_uint8)DB_EETNODE_OP_AND == nodes[j]->type;
+         j = parent[j])
+      ;
+    if (-1 == j && 1 == indexbound(nodes, start, i, sp->base.header, &attrp,
+                                   &low, &high, &string))
+      bound[i] = attrp->pos;
+  }
+
+  for (i = 0; i < sp->idx_meta_data.num_idx; ++i)
+    tried[i] = 0;
+
+  while (1) {
+    db_int low, high, best = -1, bestscore = 0, score, numeq;
+    db_uint8 numlow, numhigh;
+
+    /* Pick the index whose key is bound tightest.  Each leading key
+       expression bound to a single value beats any range on the one after
+       them, and a range beats a single bound. */
+    for (i = 0; i < sp->idx_meta_data.num_idx; ++i) {
+      if (tried[i])
+        continue;
+      score = 4 * keybounds(sp, (db_uint8)i, nodes, start, bound, numnodes,
+                            NULL, NULL, &low, &high);
+      score += (DB_INT_MIN != low) + (DB_INT_MAX != high);
+      if (score > bestscore) {
+        best = i;
+        bestscore = score;
+      }
+    }
+    if (-1 == best)
+      return 0;
+    tried[best] = 1;
+
+    db_int values[sp->idx_meta_data.num_expr[best]];
+    char *strings[sp->idx_meta_data.num_expr[best]];
+    db_eet_t *exprs = sp->idx_meta_data.exprs[best];
+    db_index_key_t lowkey, highkey;
+    relation_header_t *hp = sp->base.header;
+    numeq = keybounds(sp, (db_uint8)best, nodes, start, bound, numnodes,
+                      values, strings, &low, &high);
+    j = ((db_eetnode_attr_t *)(exprs[0].nodes))->pos;
+    if (DB_STRING == hp->types[j]) {
+      db_index_stringkey(&lowkey, strings[0], hp->sizes[j]);
+      highkey = lowkey;
+    } else {
+      db_index_intkey(&lowkey, low);
+      db_index_intkey(&highkey, high);
+    }
+
+    /* Indexes that do not keep the relation in order are followed by the
+       scan itself, and find exactly the tuples in the bounds. */
+    if (1 == sp->idx_meta_data.num_expr[best] &&
+        1 == scan_findrange(sp, (db_uint8)best, &lowkey, &highkey, mmp)) {
+      db_int pos = j;
+      db_int write = 0;
+      top = 0;
+
+      /* Rebuild the condition without the comparisons, and without the ANDs
+         left with a single operand. */
+      for (i = 0; i < numnodes; ++i) {
+        for (j = parent[i]; -1 != j && pos != bound[j]; j = parent[j])
+          ;
+        if (-1 != j)
+          continue;
+        if (pos == bound[i]) {
+          present[top] = 0;
+          top++;
+          continue;
+        }
+        k = (db_int)POINTERBYTEDIST(nodes[i + 1], nodes[i]);
+        if ((db_uint8)DB_EETNODE_OP_AND == nodes[i]->type) {
+          top -= 2;
+          if (present[top] && present[top + 1]) {
+            memmove(((char *)eetp->nodes) + write, nodes[i], (size_t)k);
+            write += k;
+          }
+          present[top] = present[top] || present[top + 1];
+        } else {
+          memmove(((char *)eetp->nodes) + write, nodes[i], (size_t)k);
+          write += k;
+          if ((db_uint8)DB_EETNODE_OP_UNARYNEG <= nodes[i]->type)
+            top -= eet_numrequiredvals(nodes[i]->type);
+          present[top] = 1;
+        }
+        top++;
+      }
+
+      /* If nothing is left, every tuple the index finds is selected. */
+      if (0 == write) {
+        ((db_eetnode_dbint_t *)(eetp->nodes))->base.type =
+            (db_uint8)DB_EETNODE_CONST_DBINT;
+        ((db_eetnode_dbint_t *)(eetp->nodes))->integer = 1;
+        write = (db_int)sizeof(db_eetnode_dbint_t);
+      }
+      eetp->size = write;
+      return 1;
+    }
+
+    /* A relation kept in order is read from the first tuple in the bounds
+       until past the last.  The key's leading values are the same at both
+       ends, and the range on the expression after them is added where
+       there is one. */
+    db_tuple_t lowtp, hightp;
+    init_tuple(&lowtp, hp->tuple_size, hp->num_attr, mmp);
+    init_tuple(&hightp, hp->tuple_size, hp->num_attr, mmp);
+    for (i = 0; i <= numeq && i < sp->idx_meta_data.num_expr[best]; ++i) {
+      if (i == numeq && sizeof(db_eetnode_attr_t) != exprs[i].size)
+        break;
+      j = ((db_eetnode_attr_t *)(exprs[i].nodes))->pos;
+      if (DB_STRING == hp->types[j]) {
+        /* Strings are only ever bound to a single value. */
+        if (i == numeq)
+          break;
+        memset(lowtp.bytes + hp->offsets[j], 0, (size_t)(hp->sizes[j]));
+        strcpy((char *)(lowtp.bytes + hp->offsets[j]), strings[i]);
+        memcpy(hightp.bytes + hp->offsets[j], lowtp.bytes + hp->offsets[j],
+               (size_t)(hp->sizes[j]));
+        continue;
+      }
+      memcpy(lowtp.bytes + hp->offsets[j], i < numeq ? &values[i] : &low,
+             sizeof(db_int));
+      memcpy(hightp.bytes + hp->offsets[j], i < numeq ? &values[i] : &high,
+             sizeof(db_int));
+    }
+    numlow = (db_uint8)numeq;
+    numhigh = (db_uint8)numeq;
+    if (numeq < sp->idx_meta_data.num_expr[best]) {
+      numlow += (DB_INT_MIN != low);
+      numhigh += (DB_INT_MAX != high);
+    }
+    k = scan_findkeyrange(sp, (db_uint8)best, &lowtp, numlow, &hightp,
+                          numhigh, mmp);
+    close_tuple(&hightp, mmp);
+    close_tuple(&lowtp, mmp);
+    if (1 == k)
+      return 1;
+  }
+}
+
+/* Check if the index a scan follows holds what an expression reads. */
+/**
+@brief		Check if the index a scan follows holds every attribute an
+		expression over the scan's tuples reads.
+@param		sp		A pointer to the scan.
+@param		eetp		A pointer to the expression.  An expression
+				without nodes stands for all of the scan's
+				attributes.
+@returns	@c 1 if the index holds them all, @c 0 otherwise.
+*/
+static db_int indexcovers(scan_t *sp, db_eet_t *eetp) {
+  db_eetnode_t *cursor = eetp->nodes;
+  db_int pos;
+
+  if (NULL == cursor) {
+    for (pos = 0; pos < (db_int)(sp->base.header->num_attr); ++pos)
+      if (1 != db_index_covers(&(sp->idx_meta_data),
+                               (db_uint8)(sp->cursor.indexon), (db_uint8)pos))
+        return 0;
+    return 1;
+  }
+  while (POINTERBYTEDIST(cursor, eetp->nodes) < eetp->size) {
+    if ((db_uint8)DB_EETNODE_ATTR == cursor->type &&
+        1 != db_index_covers(&(sp->idx_meta_data),
+                             (db_uint8)(sp->cursor.indexon),
+                             ((db_eetnode_attr_t *)cursor)->pos))
+      return 0;
+    advanceeetnodepointer(&cursor, 1);
+  }
+  return 1;
+}
+
+/* Make a scan read only the entries of the index it follows, if it can. */
+/**
+@brief		Make a scan following an index make its tuples from the
+		index's entries, without reading its relation.
+@details	This is only done when the index holds every attribute read
+		by the projection, selections, sorts and top-N operators above
+		the scan.  Only those operators are looked through, and without
+		a projection every attribute is needed.
+@param		rootp		A pointer to the root of the query's
+				operators.
+@param		sp		A pointer to the query's only scan.
+*/
+static void setupindexonlyscan(db_op_base_t *rootp, scan_t *sp) {
+  db_op_base_t *op = rootp;
+  project_t *projectp;
+  db_eet_t all;
+  db_int i;
+
+  if (DB_STORAGE_NOFILE == sp->cursor.indexref)
+    return;
+  all.nodes = NULL;
+  if (DB_PROJECT != op->type && 1 != indexcovers(sp, &all))
+    return;
+
+  while ((db_op_base_t *)sp != op) {
+    if (DB_PROJECT == op->type) {
+      projectp = (project_t *)op;
+      for (i = 0; i < (db_int)(projectp->num_exprs); ++i)
+        if (1 != indexcovers(sp, &(projectp->exprs[i])))
+          return;
+      op = projectp->child;
+    } else if (DB_SELECT == op->type) {
+      if (1 != indexcovers(sp, ((select_t *)op)->tree))
+        return;
+      op = ((select_t *)op)->child;
+    } else if (DB_SORT == op->type) {
+      for (i = 0; i < (db_int)(((sort_t *)op)->num_expr); ++i)
+        if (1 != indexcovers(sp, &(((sort_t *)op)->sort_exprs[i])))
+          return;
+      op = ((sort_t *)op)->child;
+    } else if (DB_TOPN == op->type) {
+      for (i = 0; i < (db_int)(((topn_t *)op)->num_expr); ++i)
+        if (1 != indexcovers(sp, &(((topn_t *)op)->sort_exprs[i])))
+          return;
+      op = ((topn_t *)op)->child;
+    } else {
+      return;
+    }
+  }
+  sp->indexonly = 1;
+}
+/******************************************************************************/
+
 /*** External functions *******************************************************/
 /* Returns the root operator in the parse tree. */
 db_op_base_t *parse(char *command, db_query_mm_t *mmp) {
@@ -334,7 +915,13 @@ db_op_base_t *parse(char *command, db_query_mm_t *mmp) {
 
   struct clausenode *clausestack_top = check_clauses(&lexer, mmp);
 
-  sort_clauses(clausestack_bottom, clausestack_top);
+  db_uint8 aggregated = 0;
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+  aggregated = isaggregated(lexer, clausestack_bottom, clausestack_top);
+#endif
+#endif
+  sort_clauses(clausestack_bottom, clausestack_top, aggregated);
 
   /* Re-init the lexer.  We will jump around now. */
   lexer_init(&lexer, command, mmp);
@@ -373,7 +960,7 @@ db_op_base_t *parse(char *command, db_query_mm_t *mmp) {
 
     /* If we now can, build out a selection clause from parsed expressions. */
     // TODO: move this to where_command, optimize joins, something. :)
-    if (!builtselect && rootp &&
+    if (!builtselect && rootp && clausestack_top != clausestack_bottom &&
         DB_LEXER_TOKENBCODE_CLAUSE_WHERE < clausestack_top->bcode) {
       if (NULL == expr)
         builtselect = 1;
@@ -436,88 +1023,70 @@ db_op_base_t *parse(char *command, db_query_mm_t *mmp) {
           return NULL;
         }
 
-        /* Check to see if we can initialize an indexed join. */
-        if (!builtselect)
-          setup_osijoin((osijoin_t *)rootp, mmp);
+        /* Evaluate what does not depend on the tuples once, up front.  A
+           condition that folds to a constant is decided by the selection
+           before anything is read. */
+        foldexpression(eetp, mmp);
 
-        // TODO: This is crude.  Very crude.  Only supports val {<, >, >=, <=,
-        // =} attr (or vice/versa) at this point.
-        /* Setup indexed scan, if we can. */
-        if (1 == numtables && NULL != eetp && NULL != eetp->nodes) {
-          db_eetnode_t *cursor = eetp->nodes;
-          db_uint8 valid = 1;
-          db_eetnode_t *attr = NULL, *val = NULL, *relop = NULL;
-
-          while (POINTERBYTEDIST(cursor, eetp->nodes) != eetp->size) {
-            if (DB_EETNODE_CONST_DBINT == cursor->type) {
-              if (NULL != val) {
-                valid = 0;
-                break;
-              }
-
-              val = cursor;
-            } else if (DB_EETNODE_ATTR == cursor->type) {
-              if (NULL != attr) {
-                valid = 0;
-                break;
-              }
-
-              attr = cursor;
-            } else if (DB_EETNODE_OP_LT == cursor->type ||
-                       DB_EETNODE_OP_LTE == cursor->type ||
-                       DB_EETNODE_OP_GT == cursor->type ||
-                       DB_EETNODE_OP_GTE == cursor->type ||
-                       DB_EETNODE_OP_EQ == cursor->type) {
-              if (NULL != relop) {
-                valid = 0;
-                break;
-              }
-
-              relop = cursor;
-            }
-            advanceeetnodepointer(&cursor, 1);
+        /* If both inputs are already ordered on the join attributes, merge
+           them.  Otherwise, check to see if we can initialize an indexed
+           join.  Failing that, an equi-join can still be hashed, and any
+           other join is done a block of left tuples at a time. */
+        if (!builtselect) {
+          smjoin_t *smjoinp = db_qmm_falloc(mmp, sizeof(smjoin_t));
+          if (NULL != smjoinp) {
+            *((ntjoin_t *)smjoinp) = *((ntjoin_t *)rootp);
+            if (1 == setup_smjoin(smjoinp, mmp))
+              rootp = (db_op_base_t *)smjoinp;
+            else
+              db_qmm_ffree(mmp, smjoinp);
           }
-
-          /* If valid expression, perform setup work for indexing scans. */
-          if (1 == valid && NULL != val && NULL != relop && NULL != attr) {
-            // TODO: Move this function from osijoin to a better place.
-            db_int8 whichindex = findindexon(tables, (db_eetnode_attr_t *)attr);
-            if (-1 != whichindex) {
-              /* Setup pre-condition. */
-              // TODO: In future, we might need to skip single tuple if
-              // condition is not met.  Maybe.
-              if (DB_EETNODE_OP_GTE == relop->type ||
-                  DB_EETNODE_OP_EQ == relop->type) {
-                tables->tuple_start = db_index_getoffset(
-                    tables, whichindex, ((db_eetnode_attr_t *)attr)->pos,
-                    ((db_eetnode_dbint_t *)val)->integer, NULL, mmp);
-                rewind_scan(tables, mmp);
-              } else if (DB_EETNODE_OP_GT == relop->type) {
-                tables->tuple_start = db_index_getoffset(
-                    tables, whichindex, ((db_eetnode_attr_t *)attr)->pos,
-                    ((db_eetnode_dbint_t *)val)->integer + 1, NULL, mmp);
-                rewind_scan(tables, mmp);
-              }
-
-              /* Setup end condition. */
-              if (DB_EETNODE_OP_LTE == relop->type ||
-                  DB_EETNODE_OP_EQ == relop->type) {
-                // TODO: Need to make sure no int overflow.
-                tables->stopat = ((db_eetnode_dbint_t *)val)->integer + 1;
-                tables->indexon = whichindex;
-              } else if (DB_EETNODE_OP_LT == relop->type) {
-                tables->stopat = ((db_eetnode_dbint_t *)val)->integer;
-                tables->indexon = whichindex;
-              }
-            }
+        }
+        if (!builtselect && DB_NTJOIN == rootp->type &&
+            1 != setup_osijoin((osijoin_t *)rootp, mmp)) {
+          hashjoin_t *hashjoinp = db_qmm_falloc(mmp, sizeof(hashjoin_t));
+          if (NULL != hashjoinp) {
+            *((ntjoin_t *)hashjoinp) = *((ntjoin_t *)rootp);
+            if (1 == setup_hashjoin(hashjoinp, mmp))
+              rootp = (db_op_base_t *)hashjoinp;
+            else
+              db_qmm_ffree(mmp, hashjoinp);
+          }
+        }
+        if (!builtselect && DB_NTJOIN == rootp->type) {
+          bnljoin_t *bnljoinp = db_qmm_falloc(mmp, sizeof(bnljoin_t));
+          if (NULL != bnljoinp) {
+            *((ntjoin_t *)bnljoinp) = *((ntjoin_t *)rootp);
+            if (1 == setup_bnljoin(bnljoinp, mmp))
+              rootp = (db_op_base_t *)bnljoinp;
+            else
+              db_qmm_ffree(mmp, bnljoinp);
           }
         }
 
+        /* Setup indexed scan, if we can. */
+        if (1 == numtables && NULL != eetp && NULL != eetp->nodes)
+          setupindexedscan(tables, eetp, mmp);
+
         builtselect = 1;
       }
     }
   }
 
+  /* Once every operator is in place, see if an index can stand in for the
+     relation it indexes. */
+  if (1 == numtables && NULL != rootp)
+    setupindexonlyscan(rootp, tables);
+
+  /* The plan is final, so its expressions can be compiled and its batches
+     set up before the operators start taking memory of their own.  A batch
+     that does not fit now is tried again when its first tuple is asked
+     for. */
+  if (DB_PARSER_OP_NONE != rootp) {
+    compileexecutiontree(rootp, mmp);
+    initexecutionbatches(rootp, mmp);
+  }
+
   return rootp;
 }
 
@@ -40,6 +40,9 @@ extern "C" {
 #include "dblexer.h"
 #include "dbparseexpr.h"
 #include "dbpoints/dbfrom.h"
+#include "dbpoints/dbgroupby.h"
+#include "dbpoints/dblimit.h"
+#include "dbpoints/dborderby.h"
 #include "dbpoints/dbwhere.h"
 #if defined(DB_CTCONF_SETTING_TARGET) &&                                       \
     DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -193,7 +193,7 @@ db_int from_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
       db_int size = tempscanp->end - tempscanp->start;
       if (size < tablename_end - tablename_start)
         size = tablename_end - tablename_start;
-      char tempstring[size];
+      char tempstring[size + 1];
 
       tempscanp->fname_start = tablename_start;
       tempscanp->fname_end = tablename_end;
@@ -0,0 +1,313 @@
+#include "dbgroupby.h"
+
+#include "../dbparser.h"
+
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+
+/* Find where a clause of the command starts, after its keyword, and ends. */
+static db_int findclause(db_lexer_t *lexerp, db_int bcode, db_int *startp,
+                         db_int *endp) {
+  db_lexer_t lexer = *lexerp;
+  db_int found = 0;
+
+  lexer.offset = 0;
+  while (1 == lexer_next(&lexer) &&
+         (db_uint8)DB_LEXER_TT_TERMINATOR != lexer.token.type) {
+    if ((db_uint8)DB_LEXER_TT_RESERVED == lexer.token.type &&
+        -1 != whichclause(&(lexer.token), &lexer)) {
+      if (found)
+        break;
+      if (bcode == lexer.token.bcode) {
+        found = 1;
+        *startp = lexer.token.end;
+        *endp = lexer.token.end;
+      }
+    } else if (found) {
+      *endp = lexer.token.end;
+    }
+  }
+  return found;
+}
+
+/* Check if an operator returns every live tuple of a scanned relation, as a
+   full scan does, possibly under the selection that leaves out deleted
+   tuples. */
+static db_uint8 scansall(db_op_base_t *op, scan_t *sp) {
+  db_eetnode_t *cursor;
+  db_eetnode_attr_t *attrp;
+  db_eet_t *eetp;
+
+  if (DB_SELECT == op->type) {
+    eetp = ((select_t *)op)->tree;
+    if (NULL == eetp || NULL == eetp->nodes ||
+        (db_int)(sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) +
+                 sizeof(db_eetnode_t)) != eetp->size)
+      return 0;
+
+    /* Only "__delete = 0" is looked through. */
+    cursor = eetp->nodes;
+    attrp = (db_eetnode_attr_t *)cursor;
+    if ((db_uint8)DB_EETNODE_ATTR != cursor->type || 0 != attrp->tuple_pos ||
+        0 != strcmp("__delete", op->header->names[attrp->pos]))
+      return 0;
+    advanceeetnodepointer(&cursor, 1);
+    if ((db_uint8)DB_EETNODE_CONST_DBINT != cursor->type ||
+        0 != ((db_eetnode_dbint_t *)cursor)->integer)
+      return 0;
+    advanceeetnodepointer(&cursor, 1);
+    if ((db_uint8)DB_EETNODE_OP_EQ != cursor->type)
+      return 0;
+    op = ((select_t *)op)->child;
+  }
+
+  return (db_op_base_t *)sp == op && sp->tuple_start == sp->first_record &&
+         -1 == sp->tuple_end && DB_STORAGE_NOFILE == sp->cursor.indexref;
+}
+
+/* Check if an ORDER BY clause names each grouping attribute once, and
+   nothing else. */
+/**
+@brief		Check if an ORDER BY clause orders on just the attributes
+		grouped on, so that the tuples may be ordered before they are
+		aggregated.
+@details	Each expression of the clause must be a lone attribute, with or
+		without the name of its table, and optionally followed by
+		@c ASC or @c DESC.  Only the names of the attributes are
+		compared, so it is still up to @ref isgroupedon to confirm the
+		order groups the tuples.
+*/
+static db_uint8 ordersgroups(db_lexer_t *lexerp, db_op_base_t *rootp,
+                             db_eet_t *groupby, db_uint8 numgroupby,
+                             db_int start, db_int end) {
+  db_lexer_t lexer = *lexerp;
+  db_lexer_token_t name;
+  db_uint8 named[numgroupby];
+  db_uint8 numnamed = 0, state = 0, i;
+  db_eetnode_attr_t *attrp;
+
+  for (i = 0; i < numgroupby; ++i)
+    named[i] = 0;
+
+  lexer.offset = start;
+  if (!(end > lexer.offset && 1 == lexer_next(&lexer)) ||
+      DB_LEXER_TT_RESERVED != lexer.token.type ||
+      1 != token_stringequal(&(lexer.token), "BY", 2, &lexer, 0))
+    return 0;
+
+  /* The state is 0 before an expression, 1 after an attribute's name, 2
+     after a table's name and 3 after the order. */
+  while (1) {
+    if (end > lexer.offset && 1 == lexer_next(&lexer) &&
+        DB_LEXER_TT_COMMA != lexer.token.type) {
+      if (DB_LEXER_TT_IDENT == lexer.token.type && (0 == state || 2 == state)) {
+        name = lexer.token;
+        state = 1;
+      } else if (DB_LEXER_TT_IDENTCONJ == lexer.token.type && 1 == state) {
+        state = 2;
+      } else if (DB_LEXER_TT_RESERVED == lexer.token.type && 1 == state &&
+                 (1 == token_stringequal(&(lexer.token), "ASC", 3, &lexer, 0) ||
+                  1 == token_stringequal(&(lexer.token), "DESC", 4, &lexer,
+                                         0))) {
+        state = 3;
+      } else {
+        return 0;
+      }
+      continue;
+    }
+
+    /* The expression has ended, so find which attribute it names. */
+    if (1 != state && 3 != state)
+      return 0;
+    for (i = 0; i < numgroupby; ++i) {
+      attrp = (db_eetnode_attr_t *)(groupby[i].nodes);
+      if (0 == named[i] && sizeof(db_eetnode_attr_t) == groupby[i].size &&
+          (db_uint8)DB_EETNODE_ATTR == attrp->base.type &&
+          NULL != rootp->header->names[attrp->pos] &&
+          1 == token_stringequal(
+                   &name, rootp->header->names[attrp->pos],
+                   (db_int)(rootp->header->size_name[attrp->pos] - 1), &lexer,
+                   0))
+        break;
+    }
+    if (i == numgroupby)
+      return 0;
+    named[i] = 1;
+    numnamed++;
+    state = 0;
+
+    if (DB_LEXER_TT_COMMA != lexer.token.type || end <= lexer.offset)
+      break;
+  }
+
+  return numgroupby == numnamed;
+}
+
+/* Parse an expression of the GROUP BY or HAVING clause. */
+static db_int groupby_expression(db_lexer_t *lexerp, db_op_base_t *rootp,
+                                 db_query_mm_t *mmp, db_eet_t *eetp,
+                                 db_int start, db_int end, scan_t *tables,
+                                 db_uint8 numtables) {
+  db_eetnode_t *expr = NULL;
+  if (1 != where_command(lexerp, mmp, start, end, &tables, &expr))
+    return -1;
+
+  eetp->nodes = expr;
+  eetp->size = DB_QMM_SIZEOF_FTOP(mmp);
+  eetp->stack_size = 2 * eetp->size;
+
+  switch (verifysetupattributes(eetp, lexerp, rootp, tables, numtables, 1)) {
+  case 1:
+    return 1; /* Verified successfully. */
+  case 0:
+    DB_ERROR_MESSAGE("could not verify identifiers", start, lexerp->command);
+    return -1;
+  default:
+    return -1;
+  }
+}
+
+db_int groupby_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                       db_query_mm_t *mmp, db_eet_t *exprs, db_uint8 num_expr,
+                       scan_t *tables, db_uint8 numtables) {
+  db_int8 brackets = 0;
+  db_uint8 numgroupby = 0, aggregates = 0, i;
+  db_int start, end, exprstart, exprend, next;
+  db_eet_t *groupby = NULL, *having = NULL;
+
+  start = lexerp->offset;
+  for (i = 0; i < num_expr; ++i)
+    if (1 == hasaggregate(exprs + i))
+      aggregates = 1;
+
+  if (1 == findclause(lexerp, DB_LEXER_TOKENBCODE_CLAUSE_GROUPBY, &start,
+                      &end)) {
+    lexerp->offset = start;
+    if (!(end > lexerp->offset && 1 == lexer_next(lexerp)) ||
+        DB_LEXER_TT_RESERVED != lexerp->token.type ||
+        1 != token_stringequal(&(lexerp->token), "BY", 2, lexerp, 0)) {
+      DB_ERROR_MESSAGE("missing 'BY'", lexerp->token.start, lexerp->command);
+      return -1;
+    }
+    exprstart = lexerp->offset;
+    if (lasttoken(*lexerp, end)) {
+      DB_ERROR_MESSAGE("nothing to group by", exprstart, lexerp->command);
+      return -1;
+    }
+
+    /* Determine the number of expressions to group on. */
+    numgroupby = 1;
+    while (end > lexerp->offset && 1 == lexer_next(lexerp)) {
+      if (DB_LEXER_TT_LPAREN == lexerp->token.type)
+        brackets++;
+      else if (DB_LEXER_TT_RPAREN == lexerp->token.type)
+        brackets--;
+      else if (DB_LEXER_TT_COMMA == lexerp->token.type && 0 == brackets)
+        numgroupby++;
+    }
+
+    groupby = db_qmm_falloc(mmp, ((int)numgroupby) * sizeof(db_eet_t));
+    if (NULL == groupby) {
+      DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+      return -1;
+    }
+
+    /* Process each expression. */
+    next = exprstart;
+    for (i = 0; i < numgroupby; ++i) {
+      exprstart = next;
+      exprend = end;
+      next = end;
+      brackets = 0;
+
+      /* Find the end of the expression. */
+      lexerp->offset = exprstart;
+      while (end > lexerp->offset && 1 == lexer_next(lexerp)) {
+        if (DB_LEXER_TT_LPAREN == lexerp->token.type) {
+          brackets++;
+        } else if (DB_LEXER_TT_RPAREN == lexerp->token.type) {
+          brackets--;
+        } else if (DB_LEXER_TT_COMMA == lexerp->token.type && 0 == brackets) {
+          exprend = lexerp->token.start;
+          next = lexerp->offset;
+          break;
+        }
+      }
+
+      if (1 != groupby_expression(lexerp, *rootpp, mmp, groupby + i,
+                                  exprstart, exprend, tables, numtables))
+        return -1;
+    }
+  } else if (!aggregates) {
+    return 0;
+  }
+
+  /* Ordering the groups on the attributes grouped on may as well be done
+     before they are aggregated, so that only one group is kept at a time.
+     The ORDER BY clause then has nothing left to do. */
+  if (numgroupby > 0 && 1 != isgroupedon(*rootpp, groupby, numgroupby) &&
+      1 == findclause(lexerp, DB_LEXER_TOKENBCODE_CLAUSE_ORDERBY, &start,
+                      &end) &&
+      1 == ordersgroups(lexerp, *rootpp, groupby, numgroupby, start, end) &&
+      1 != orderby_command(lexerp, rootpp, mmp, start, end, tables,
+                           numtables))
+    return -1;
+
+  if (1 == findclause(lexerp, DB_LEXER_TOKENBCODE_CLAUSE_HAVING, &start,
+                      &end)) {
+    having = db_qmm_falloc(mmp, sizeof(db_eet_t));
+    if (NULL == having) {
+      DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+      return -1;
+    }
+    if (1 != groupby_expression(lexerp, *rootpp, mmp, having, start, end,
+                                tables, numtables))
+      return -1;
+  }
+
+  /* Without grouping, a query over a whole relation may be answered from
+     the relation's statistics. */
+  relation_stats_t *statsp = NULL;
+  if (0 == numgroupby && 1 == numtables && 1 == scansall(*rootpp, tables)) {
+    db_lexer_token_t token;
+    token.start = tables[0].fname_start;
+    token.end = tables[0].fname_end;
+    char relationname[gettokenlength(&token) + 1];
+    gettokenstring(&token, relationname, lexerp);
+
+    statsp = db_qmm_falloc(mmp, sizeof(relation_stats_t));
+    if (NULL != statsp && 1 != getrelationstats(statsp, relationname, mmp)) {
+      db_qmm_ffree(mmp, statsp);
+      statsp = NULL;
+    }
+  }
+
+  aggregate_t *aggregatep = db_qmm_falloc(mmp, sizeof(aggregate_t));
+  if (NULL == aggregatep) {
+    DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+    return -1;
+  }
+
+  /* Tuples that come grouped already need only be compared with the group
+     before them.  With no grouping at all, there is only one group. */
+  db_int result;
+  if (0 == numgroupby)
+    result = init_simpleaggregate(aggregatep, *rootpp, exprs, num_expr, having,
+                                  statsp, mmp);
+  else if (1 == isgroupedon(*rootpp, groupby, numgroupby))
+    result = init_streamaggregate(aggregatep, *rootpp, exprs, num_expr,
+                                  groupby, numgroupby, having, mmp);
+  else
+    result = init_hashaggregate(aggregatep, *rootpp, exprs, num_expr, groupby,
+                                numgroupby, having, mmp);
+  if (1 != result) {
+    DB_ERROR_MESSAGE("failed to create aggregate", start, lexerp->command);
+    return -1;
+  }
+
+  *rootpp = (db_op_base_t *)aggregatep;
+  return 1;
+}
+
+#endif
+#endif
@@ -0,0 +1,45 @@
+#ifndef DBGROUPBY_H
+#define DBGROUPBY_H
+
+#include "../../db_ctconf.h"
+#include "../../dbmm/db_query_mm.h"
+#include "../../dbops/db_ops_types.h"
+#include "../../ref.h"
+#include "../dblexer.h"
+
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+
+/* Parse the GROUP BY and HAVING clauses. */
+/**
+@brief		Parse the GROUP BY and HAVING clauses of a query, putting an
+                aggregate operator on top of the query built so far.
+@details	This is done along with the SELECT clause, whose expressions
+                the aggregate operator projects.  If the query's tuples are
+                already ordered on the grouping attributes, as by an ORDER
+                BY clause or an inline index, they are aggregated in a single
+                streaming pass.  Otherwise, they are aggregated in a hash
+                table.  Without a GROUP BY clause, every tuple is aggregated
+                into one group, and a query over the whole of one relation
+                may be answered from that relation's statistics instead.
+@param		lexerp		A pointer to the lexer instance variable
+                                being used to generate tokens for the
+                                parser.
+@param		rootpp		A pointer to the root operator pointer.
+@param		mmp		A pointer to the per-query memory manager
+                                allocating space for this query.
+@param		exprs		The expressions of the SELECT clause.
+@param		num_expr	The number of elements in @p exprs.
+@param		tables		The array of scan operators.
+@param		numtables	The number of scan operators in @p tables.
+@return		@c 1 if an aggregate operator was added, @c 0 if the query
+                neither groups nor aggregates, @c -1 if an error occured.
+*/
+db_int groupby_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                       db_query_mm_t *mmp, db_eet_t *exprs, db_uint8 num_expr,
+                       scan_t *tables, db_uint8 numtables);
+
+#endif
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+#include "dblimit.h"
+
+#include "../dbparser.h"
+
+db_int limit_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                     db_query_mm_t *mmp, db_int start, db_int end) {
+  lexerp->offset = start;
+
+  if (NULL == *rootpp) {
+    DB_ERROR_MESSAGE("no relation to limit", start, lexerp->command);
+    return -1;
+  }
+
+  /* The clause is a single, non-negative integer. */
+  if (!(end > lexerp->offset && 1 == lexer_next(lexerp)) ||
+      DB_LEXER_TT_INT != lexerp->token.type) {
+    DB_ERROR_MESSAGE("missing number of tuples", lexerp->token.start,
+                     lexerp->command);
+    return -1;
+  }
+  db_int limit = getintegerfromtoken(&(lexerp->token), lexerp);
+  if (!lasttoken(*lexerp, end)) {
+    DB_ERROR_MESSAGE("invalid tokens after number of tuples", lexerp->offset,
+                     lexerp->command);
+    return -1;
+  }
+
+  topn_t *topnp = db_qmm_falloc(mmp, sizeof(topn_t));
+  if (NULL == topnp) {
+    DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+    return -1;
+  }
+  if (1 != init_topn(topnp, *rootpp, NULL, 0, NULL, limit, mmp)) {
+    DB_ERROR_MESSAGE("failed to create limit", start, lexerp->command);
+    return -1;
+  }
+  *rootpp = (db_op_base_t *)topnp;
+
+  return 1;
+}
@@ -0,0 +1,29 @@
+#ifndef DBLIMIT_H
+#define DBLIMIT_H
+
+#include "../../dbmm/db_query_mm.h"
+#include "../../dbops/db_ops_types.h"
+#include "../../ref.h"
+#include "../dblexer.h"
+
+/* Parse the LIMIT clause. */
+/**
+@brief		Parse a LIMIT clause, putting a top-N operator on top of the
+                query built so far.
+@details	The operator returns tuples in the order they come, until an
+                @c ORDER @c BY clause gives it an order.
+@param		lexerp		A pointer to the lexer instance variable
+                                being used to generate tokens for the
+                                parser.
+@param		rootpp		A pointer to the root operator pointer.
+@param		mmp		A pointer to the per-query memory manager
+                                allocating space for this query.
+@param		start		The starting offset of the LIMIT clause.
+@param		end		The first offset _NOT_ in the LIMIT clause.
+@return		@c 1 if the LIMIT clause parsed succesfully, @c -1 if an error
+                occured.
+*/
+db_int limit_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                     db_query_mm_t *mmp, db_int start, db_int end);
+
+#endif
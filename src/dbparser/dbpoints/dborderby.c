@@ -0,0 +1,247 @@
+#include "dborderby.h"
+
+#include "../dbparser.h"
+
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+/* Check if two expressions are made of the same nodes. */
+static db_uint8 sameexpression(db_eet_t *ap, db_eet_t *bp) {
+  db_eetnode_t *acursor = ap->nodes, *bcursor = bp->nodes;
+  if (NULL == acursor || NULL == bcursor || ap->size != bp->size)
+    return 0;
+
+  while (POINTERBYTEDIST(acursor, ap->nodes) < ap->size) {
+    if (acursor->type != bcursor->type)
+      return 0;
+    if ((db_uint8)DB_EETNODE_ATTR == acursor->type) {
+      if (((db_eetnode_attr_t *)acursor)->pos !=
+              ((db_eetnode_attr_t *)bcursor)->pos ||
+          ((db_eetnode_attr_t *)acursor)->tuple_pos !=
+              ((db_eetnode_attr_t *)bcursor)->tuple_pos)
+        return 0;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBINT == acursor->type) {
+      if (((db_eetnode_dbint_t *)acursor)->integer !=
+          ((db_eetnode_dbint_t *)bcursor)->integer)
+        return 0;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBDECIMAL == acursor->type) {
+      if (((db_eetnode_dbdecimal_t *)acursor)->decimal !=
+          ((db_eetnode_dbdecimal_t *)bcursor)->decimal)
+        return 0;
+    } else if ((db_uint8)DB_EETNODE_CONST_DBSTRING == acursor->type) {
+      if (0 != strcmp(((db_eetnode_dbstring_t *)acursor)->string,
+                      ((db_eetnode_dbstring_t *)bcursor)->string))
+        return 0;
+    } else if ((db_uint8)DB_EETNODE_AGGR_TEMP == acursor->type) {
+      if (((db_eetnode_aggr_temp_t *)acursor)->aggr_type !=
+          ((db_eetnode_aggr_temp_t *)bcursor)->aggr_type)
+        return 0;
+    }
+    advanceeetnodepointer(&acursor, 1);
+    advanceeetnodepointer(&bcursor, 1);
+  }
+  return 1;
+}
+
+/* Make an expression with aggregates in it name the column of the aggregate
+   operator that computes the same expression.  Aggregates only have values
+   inside of that operator. */
+static db_int aggregatecolumn(db_lexer_t *lexerp, aggregate_t *ap,
+                              db_eet_t *eetp, db_int start, scan_t *tables,
+                              db_uint8 numtables) {
+  db_int i, pos = 0, retval;
+
+  retval = verifysetupattributes(eetp, lexerp, ap->child, tables, numtables, 1);
+  if (1 != retval)
+    return retval;
+
+  for (i = 0; i < (db_int)(ap->num_expr); ++i) {
+    if (1 == sameexpression(eetp, ap->exprs + i)) {
+      db_eetnode_attr_t *attrp = (db_eetnode_attr_t *)(eetp->nodes);
+      attrp->base.type = DB_EETNODE_ATTR;
+      attrp->pos = (db_uint8)pos;
+      attrp->tuple_pos = 0;
+      attrp->tokenstart = start;
+      eetp->size = sizeof(db_eetnode_attr_t);
+      eetp->stack_size = 2 * eetp->size;
+      return 1;
+    }
+    pos += NULL == ap->exprs[i].nodes ? ap->exprs[i].size : 1;
+  }
+
+  DB_ERROR_MESSAGE("aggregate in ORDER BY not in SELECT", start,
+                   lexerp->command);
+  return -1;
+}
+#endif
+#endif
+
+db_int orderby_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                       db_query_mm_t *mmp, db_int start, db_int end,
+                       scan_t *tables, db_uint8 numtables) {
+  db_int8 brackets = 0;
+  db_uint8 numexpressions = 1, i;
+  db_int exprstart, exprend, next;
+  db_lexer_token_t last;
+
+  lexerp->offset = start;
+
+  if (NULL == *rootpp) {
+    DB_ERROR_MESSAGE("no relation to order", start, lexerp->command);
+    return -1;
+  }
+  if (!(end > lexerp->offset && 1 == lexer_next(lexerp)) ||
+      DB_LEXER_TT_RESERVED != lexerp->token.type ||
+      1 != token_stringequal(&(lexerp->token), "BY", 2, lexerp, 0)) {
+    DB_ERROR_MESSAGE("missing 'BY'", lexerp->token.start, lexerp->command);
+    return -1;
+  }
+  exprstart = lexerp->offset;
+
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+  /* The groups are ordered after they are aggregated, and limited before
+     that, if at all. */
+  aggregate_t *aggregatep = NULL;
+  if (DB_AGGREGATE == (*rootpp)->type)
+    aggregatep = (aggregate_t *)*rootpp;
+  else if (DB_TOPN == (*rootpp)->type &&
+           DB_AGGREGATE == ((topn_t *)*rootpp)->child->type)
+    aggregatep = (aggregate_t *)(((topn_t *)*rootpp)->child);
+
+  /* If the tuples were sorted on the grouping attributes to be aggregated,
+     the groups are already in order. */
+  if (NULL != aggregatep && aggregatep->num_groupby_expr > 0 &&
+      DB_SORT == aggregatep->child->type &&
+      1 == isgroupedon(aggregatep->child, aggregatep->groupby_exprs,
+                       aggregatep->num_groupby_expr))
+    return 1;
+#endif
+#endif
+
+  /* Determine the number of expressions to order on. */
+  while (end > lexerp->offset && 1 == lexer_next(lexerp)) {
+    if (DB_LEXER_TT_LPAREN == lexerp->token.type)
+      brackets++;
+    else if (DB_LEXER_TT_RPAREN == lexerp->token.type)
+      brackets--;
+    else if (DB_LEXER_TT_COMMA == lexerp->token.type && 0 == brackets)
+      numexpressions++;
+  }
+
+  db_eet_t *exprs =
+      db_qmm_falloc(mmp, ((int)numexpressions) * sizeof(db_eet_t));
+  db_uint8 *order = db_qmm_falloc(mmp, (int)numexpressions);
+  if (NULL == exprs || NULL == order) {
+    DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+    return -1;
+  }
+
+  /* Process each expression. */
+  next = exprstart;
+  for (i = 0; i < numexpressions; ++i) {
+    exprstart = next;
+    exprend = end;
+    next = end;
+    brackets = 0;
+    last.type = DB_LEXER_TT_COUNT;
+
+    /* Find the end of the expression, and the order after it. */
+    lexerp->offset = exprstart;
+    while (end > lexerp->offset && 1 == lexer_next(lexerp)) {
+      if (DB_LEXER_TT_LPAREN == lexerp->token.type) {
+        brackets++;
+      } else if (DB_LEXER_TT_RPAREN == lexerp->token.type) {
+        brackets--;
+      } else if (DB_LEXER_TT_COMMA == lexerp->token.type && 0 == brackets) {
+        exprend = lexerp->token.start;
+        next = lexerp->offset;
+        break;
+      }
+      last = lexerp->token;
+    }
+
+    order[i] = DB_TUPLE_ORDER_ASC;
+    if (DB_LEXER_TT_RESERVED == last.type &&
+        1 == token_stringequal(&last, "ASC", 3, lexerp, 0)) {
+      exprend = last.start;
+    } else if (DB_LEXER_TT_RESERVED == last.type &&
+               1 == token_stringequal(&last, "DESC", 4, lexerp, 0)) {
+      order[i] = DB_TUPLE_ORDER_DESC;
+      exprend = last.start;
+    }
+
+    db_eetnode_t *expr = NULL;
+    if (1 != where_command(lexerp, mmp, exprstart, exprend, &tables, &expr))
+      return -1;
+
+    exprs[i].nodes = expr;
+    exprs[i].size = DB_QMM_SIZEOF_FTOP(mmp);
+    exprs[i].stack_size = 2 * exprs[i].size;
+
+    /* Aggregates only have values once an aggregate operator has
+       computed them. */
+    db_int retval;
+    if (1 != hasaggregate(exprs + i)) {
+      retval = verifysetupattributes(exprs + i, lexerp, *rootpp, tables,
+                                     numtables, 1);
+    }
+#ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
+#if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
+    else if (NULL != aggregatep) {
+      retval = aggregatecolumn(lexerp, aggregatep, exprs + i, exprstart,
+                               tables, numtables);
+    }
+#endif
+#endif
+    else {
+      DB_ERROR_MESSAGE("aggregate not allowed in ORDER BY", exprstart,
+                       lexerp->command);
+      return -1;
+    }
+
+    switch (retval) {
+    case 1:
+      break; /* Verified successfully. */
+    case 0:
+      DB_ERROR_MESSAGE("could not verify identifiers", exprstart,
+                       lexerp->command);
+      return -1;
+    default:
+      return -1;
+    }
+  }
+
+  /* A LIMIT only needs to keep the first tuples in this order, if they all
+     fit in memory at once. */
+  db_op_base_t **sortedpp = rootpp;
+  if (DB_TOPN == (*rootpp)->type && 0 == ((topn_t *)*rootpp)->num_expr) {
+    topn_t *topnp = (topn_t *)*rootpp;
+    topnp->sort_exprs = exprs;
+    topnp->num_expr = numexpressions;
+    topnp->order = order;
+    if (1 == topn_fits(topnp, mmp))
+      return 1;
+
+    /* Otherwise, everything is sorted and the LIMIT takes the first. */
+    topnp->sort_exprs = NULL;
+    topnp->num_expr = 0;
+    topnp->order = NULL;
+    sortedpp = &(topnp->child);
+  }
+
+  sort_t *sortp = db_qmm_falloc(mmp, sizeof(sort_t));
+  if (NULL == sortp) {
+    DB_ERROR_MESSAGE("out of memory", start, lexerp->command);
+    return -1;
+  }
+  switch (init_sort(sortp, *sortedpp, exprs, numexpressions, order, mmp)) {
+  case 1:
+    *sortedpp = (db_op_base_t *)sortp;
+    break;
+  default:
+    DB_ERROR_MESSAGE("failed to create sort", start, lexerp->command);
+    return -1;
+  }
+
+  return 1;
+}
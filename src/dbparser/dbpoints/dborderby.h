@@ -0,0 +1,34 @@
+#ifndef DBORDERBY_H
+#define DBORDERBY_H
+
+#include "../../dbmm/db_query_mm.h"
+#include "../../dbops/db_ops_types.h"
+#include "../../ref.h"
+#include "../dblexer.h"
+
+/* Parse the ORDER BY clause. */
+/**
+@brief		Parse an ORDER BY clause, ordering the tuples of the query
+                built so far.
+@details	Each expression may be followed by @c ASC or @c DESC, and is
+                sorted in ascending order otherwise.  If a LIMIT clause has
+                already put a top-N operator on top of the query, that operator
+                is given the order.  Otherwise, a sort operator is added.
+@param		lexerp		A pointer to the lexer instance variable
+                                being used to generate tokens for the
+                                parser.
+@param		rootpp		A pointer to the root operator pointer.
+@param		mmp		A pointer to the per-query memory manager
+                                allocating space for this query.
+@param		start		The starting offset of the ORDER BY clause.
+@param		end		The first offset _NOT_ in the ORDER BY clause.
+@param		tables		The array of scan operators.
+@param		numtables	The number of scan operators in @p tables.
+@return		@c 1 if the ORDER BY clause parsed succesfully, @c -1 if an
+                error occured.
+*/
+db_int orderby_command(db_lexer_t *lexerp, db_op_base_t **rootpp,
+                       db_query_mm_t *mmp, db_int start, db_int end,
+                       scan_t *tables, db_uint8 numtables);
+
+#endif
@@ -75,6 +75,11 @@ unsigned long SD_File_Position(SD_File *file)
 	return (file) ? file->f.position() : 0;
 }
 
+unsigned long SD_File_Size(SD_File *file)
+{
+	return (file) ? file->f.size() : 0;
+}
+
 void SD_File_Close(SD_File *file)
 {
 	if (file) file->f.close();
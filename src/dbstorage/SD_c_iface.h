@@ -104,6 +104,14 @@ int SD_File_Seek(SD_File *file, unsigned long pos);
 */
 unsigned long SD_File_Position(SD_File *file);
 
+/**
+@brief		Wrapper around Arduino SD file size method.
+@param		file	Pointer to C file struct type associated with an SD
+			file object.
+@returns	The number of bytes in the file.
+*/
+unsigned long SD_File_Size(SD_File *file);
+
 /**
 @brief		Wrapper around Arduino SD file close method.
 @param		file	Pointer to C file struct type associated with an SD
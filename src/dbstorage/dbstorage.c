@@ -23,6 +23,271 @@
 
 #include "dbstorage.h"
 #include "../db_ctconf.h"
+#include <string.h>
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+/* A page of the buffer pool. */
+typedef struct {
+  char name[DB_CTCONF_SETTING_BUFFERPOOL_NAMELENGTH]; /* Empty if the frame
+                                                        holds no page. */
+  long pageno;
+  db_int length; /* Bytes of the page that are in the file. */
+  db_uint8 pins;
+  db_uint8 referenced; /* Cleared as the clock hand passes. */
+} db_storage_frame_t;
+
+/* An open file whose reads and writes go through the buffer pool. */
+typedef struct {
+  db_fileref_t f;
+  char name[DB_CTCONF_SETTING_BUFFERPOOL_NAMELENGTH];
+  long position; /* Where the next read or write starts. */
+  db_uint8 append;
+  db_uint8 used;
+} db_storage_file_t;
+
+static unsigned char db_storage_pages[DB_CTCONF_SETTING_BUFFERPOOL_PAGES]
+                                     [DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE];
+static db_storage_frame_t db_storage_frames[DB_CTCONF_SETTING_BUFFERPOOL_PAGES];
+static db_storage_file_t
+    db_storage_files[DB_CTCONF_SETTING_BUFFERPOOL_MAXFILES];
+static db_int db_storage_hand = 0;
+static long db_storage_misses = 0;
+
+/* Move a file's real position to an absolute offset. */
+static db_int db_storage_rawseek(db_fileref_t f, long position) {
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+  return position == (long)cfs_seek(f, position, CFS_SEEK_SET);
+#elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+  return SD_File_Seek(f, (unsigned long)position);
+#else
+  /* Drop whatever the stream has buffered, so the bytes come from the file
+     and not from before some other handle last wrote to it. */
+  fflush(f);
+  return 0 == fseek(f, position, SEEK_SET);
+#endif
+}
+
+/* Read from a file's real position, returning the number of bytes read. */
+static size_t db_storage_rawread(db_fileref_t f, unsigned char *dest,
+                                 size_t numbytes) {
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+  int result = cfs_read(f, dest, numbytes);
+  return result < 0 ? 0 : (size_t)result;
+#elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+  int result = SD_File_Read(f, dest, numbytes);
+  return result < 0 ? 0 : (size_t)result;
+#else
+  return fread(dest, 1, numbytes, f);
+#endif
+}
+
+/* Write at a file's real position, returning the number of bytes written. */
+static size_t db_storage_rawwrite(db_fileref_t f, void *towrite,
+                                  size_t numbytes) {
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+  int result = cfs_write(f, towrite, numbytes);
+  return result < 0 ? 0 : (size_t)result;
+#elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+  return SD_File_Write(f, towrite, numbytes);
+#else
+  return fwrite(towrite, 1, numbytes, f);
+#endif
+}
+
+/* The standard target only reports whole reads and writes. */
+static size_t db_storage_transferred(size_t done, size_t numbytes) {
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI ||            \
+    DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+  return done;
+#else
+  return done == numbytes ? numbytes : 0;
+#endif
+}
+
+static db_storage_file_t *db_storage_findfile(db_fileref_t f) {
+  db_int i;
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_MAXFILES; ++i) {
+    if (db_storage_files[i].used && f == db_storage_files[i].f)
+      return db_storage_files + i;
+  }
+  return NULL;
+}
+
+/* Start sending a newly opened file's reads and writes through the pool, if
+   there is room to track it. */
+static void db_storage_addfile(db_fileref_t f, char *filename,
+                               db_uint8 append) {
+  db_storage_file_t *fp;
+  db_int i;
+  if (DB_STORAGE_NOFILE == f ||
+      strlen(filename) >= DB_CTCONF_SETTING_BUFFERPOOL_NAMELENGTH)
+    return;
+
+  /* A file closed without this layer may have left the same reference. */
+  fp = db_storage_findfile(f);
+  for (i = 0; NULL == fp && i < DB_CTCONF_SETTING_BUFFERPOOL_MAXFILES; ++i) {
+    if (!(db_storage_files[i].used))
+      fp = db_storage_files + i;
+  }
+  if (NULL == fp)
+    return;
+
+  fp->f = f;
+  strcpy(fp->name, filename);
+  fp->position = 0;
+  fp->append = append;
+  fp->used = 1;
+}
+
+/* Drop the cached pages of a file whose contents were replaced. */
+static void db_storage_dropfile(char *filename) {
+  db_int i;
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_PAGES; ++i) {
+    if (0 == strcmp(db_storage_frames[i].name, filename))
+      db_storage_frames[i].name[0] = '\0';
+  }
+}
+
+/* Find the frame holding a page of a file, loading it if it is not in the
+   pool, and pin it.  Returns -1 if the page is past the end of the file or
+   could not be loaded. */
+static db_int db_storage_pin(db_storage_file_t *fp, long pageno) {
+  db_storage_frame_t *frame;
+  db_int i, steps;
+  size_t length;
+
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_PAGES; ++i) {
+    frame = db_storage_frames + i;
+    if (pageno == frame->pageno && 0 == strcmp(frame->name, fp->name)) {
+      frame->pins++;
+      frame->referenced = 1;
+      return i;
+    }
+  }
+
+  /* Go around the clock, giving recently used pages a second chance. */
+  for (steps = 0; steps < 2 * DB_CTCONF_SETTING_BUFFERPOOL_PAGES; ++steps) {
+    i = db_storage_hand;
+    frame = db_storage_frames + i;
+    db_storage_hand =
+        (db_storage_hand + 1) % DB_CTCONF_SETTING_BUFFERPOOL_PAGES;
+    if (frame->pins > 0)
+      continue;
+    if ('\0' != frame->name[0] && frame->referenced) {
+      frame->referenced = 0;
+      continue;
+    }
+
+    frame->name[0] = '\0';
+    if (1 != db_storage_rawseek(fp->f,
+                                pageno * DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE))
+      return -1;
+    length = db_storage_rawread(fp->f, db_storage_pages[i],
+                                DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE);
+    if (0 == length)
+      return -1;
+    db_storage_misses++;
+
+    strcpy(frame->name, fp->name);
+    frame->pageno = pageno;
+    frame->length = (db_int)length;
+    frame->pins = 1;
+    frame->referenced = 1;
+    return i;
+  }
+  return -1;
+}
+
+static size_t db_storage_read(db_storage_file_t *fp, unsigned char *dest,
+                              size_t numbytes) {
+  size_t done = 0, chunk;
+  db_int i, offset;
+
+  while (done < numbytes) {
+    i = db_storage_pin(fp,
+                       fp->position / DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE);
+    if (i < 0)
+      break;
+    offset = (db_int)(fp->position % DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE);
+    chunk = 0;
+    if (offset < db_storage_frames[i].length)
+      chunk = (size_t)(db_storage_frames[i].length - offset);
+    if (chunk > numbytes - done)
+      chunk = numbytes - done;
+    memcpy(dest + done, db_storage_pages[i] + offset, chunk);
+    db_storage_frames[i].pins--;
+
+    done += chunk;
+    fp->position += (long)chunk;
+    if (0 == chunk)
+      break;
+  }
+
+  /* Whatever could not come through the pool, such as when every page is
+     pinned, is read directly. */
+  if (done < numbytes && 1 == db_storage_rawseek(fp->f, fp->position)) {
+    chunk = db_storage_rawread(fp->f, dest + done, numbytes - done);
+    done += chunk;
+    fp->position += (long)chunk;
+  }
+  return done;
+}
+
+static size_t db_storage_write(db_storage_file_t *fp, void *towrite,
+                               size_t numbytes) {
+  db_storage_frame_t *frame;
+  long start, end, pagestart;
+  db_int i;
+  size_t done;
+
+  /* Appends always land at the end, wherever the position is. */
+  start = fp->position;
+  if (fp->append) {
+    start = db_filesize(fp->f);
+    if (start < 0)
+      return 0;
+  } else if (1 != db_storage_rawseek(fp->f, start)) {
+    return 0;
+  }
+
+  done = db_storage_rawwrite(fp->f, towrite, numbytes);
+  end = start + (long)done;
+  fp->position = end;
+
+  /* Bring any cached copies of what was written up to date. */
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_PAGES; ++i) {
+    frame = db_storage_frames + i;
+    if ('\0' == frame->name[0] || 0 != strcmp(frame->name, fp->name))
+      continue;
+    pagestart = frame->pageno * DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE;
+    if (end <= pagestart ||
+        start >= pagestart + DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE)
+      continue;
+
+    /* A page can only grow by bytes that directly follow it. */
+    if (start > pagestart + frame->length) {
+      if (0 == frame->pins)
+        frame->name[0] = '\0';
+      continue;
+    }
+
+    long first = start > pagestart ? start : pagestart;
+    long last = end < pagestart + DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE
+                    ? end
+                    : pagestart + DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE;
+    memcpy(db_storage_pages[i] + (first - pagestart),
+           ((unsigned char *)towrite) + (first - start),
+           (size_t)(last - first));
+    if (last - pagestart > frame->length)
+      frame->length = (db_int)(last - pagestart);
+  }
+  return done;
+}
+#endif
 
 db_int db_fileexists(char *filename) {
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
@@ -45,60 +310,84 @@ db_int db_fileexists(char *filename) {
 }
 
 db_fileref_t db_openreadfile(char *filename) {
+  db_fileref_t toret;
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
-  return cfs_open(filename, CFS_READ);
+  toret = cfs_open(filename, CFS_READ);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
-  db_fileref_t toret;
   if (1 != SD_File_Open(&toret, filename, SD_FILE_MODE_READ))
     return DB_STORAGE_NOFILE;
-  return toret;
 #else
-  return fopen(filename, "rb");
+  toret = fopen(filename, "rb");
+#endif
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_addfile(toret, filename, 0);
 #endif
+  return toret;
 }
 
 db_fileref_t db_openwritefile(char *filename) {
+  db_fileref_t toret;
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_dropfile(filename);
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
-  return cfs_open(filename, CFS_READ | CFS_WRITE);
+  toret = cfs_open(filename, CFS_READ | CFS_WRITE);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
   SD_File_Remove(filename);
-  db_fileref_t toret;
   if (1 != SD_File_Open(&toret, filename, SD_FILE_MODE_WRITE))
     return DB_STORAGE_NOFILE;
-  return toret;
 #else
-  return fopen(filename, "wb");
+  toret = fopen(filename, "wb");
+#endif
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_addfile(toret, filename, 0);
 #endif
+  return toret;
 }
 
 db_fileref_t db_openreadfile_plus(char *filename) {
+  db_fileref_t toret;
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
-  return cfs_open(filename, CFS_READ | CFS_WRITE);
+  toret = cfs_open(filename, CFS_READ | CFS_WRITE);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_dropfile(filename);
+#endif
   SD_File_Remove(filename);
-  db_fileref_t toret;
   if (1 != SD_File_Open(&toret, filename, SD_FILE_MODE_WRITE))
     return DB_STORAGE_NOFILE;
-  return toret;
 #else
-  return fopen(filename, "r+b");
+  toret = fopen(filename, "r+b");
+#endif
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_addfile(toret, filename, 0);
 #endif
+  return toret;
 }
 
 db_fileref_t db_openappendfile(char *filename) {
+  db_fileref_t toret;
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
-  return cfs_open(filename, CFS_READ | CFS_WRITE | CFS_APPEND);
+  toret = cfs_open(filename, CFS_READ | CFS_WRITE | CFS_APPEND);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
-  db_fileref_t toret;
   if (1 != SD_File_Open(&toret, filename, SD_FILE_MODE_WRITE))
     return DB_STORAGE_NOFILE;
-  return toret;
 #else
-  return fopen(filename, "ab");
+  toret = fopen(filename, "ab");
+#endif
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_addfile(toret, filename, 1);
 #endif
+  return toret;
 }
 
 size_t db_fileread(db_fileref_t f, unsigned char *dest, size_t numbytes) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_file_t *fp = db_storage_findfile(f);
+  if (NULL != fp)
+    return db_storage_transferred(db_storage_read(fp, dest, numbytes),
+                                  numbytes);
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   return (size_t)cfs_read(f, dest, numbytes);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -109,6 +398,15 @@ size_t db_fileread(db_fileref_t f, unsigned char *dest, size_t numbytes) {
 }
 
 size_t db_filewrite(db_fileref_t f, void *towrite, size_t numbytes) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_file_t *fp = db_storage_findfile(f);
+  if (NULL != fp)
+    return db_storage_transferred(db_storage_write(fp, towrite, numbytes),
+                                  numbytes);
+
+  /* There is no telling which cached pages this write makes stale. */
+  db_filepoolclear();
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   return (size_t)cfs_write(f, towrite, numbytes);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -119,6 +417,17 @@ size_t db_filewrite(db_fileref_t f, void *towrite, size_t numbytes) {
 }
 
 db_int db_filerewind(db_fileref_t f) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_file_t *fp = db_storage_findfile(f);
+  if (NULL != fp) {
+    fp->position = 0;
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+    return 0;
+#else
+    return 1;
+#endif
+  }
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   return cfs_seek(f, 0, CFS_SEEK_SET);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -130,6 +439,19 @@ db_int db_filerewind(db_fileref_t f) {
 }
 
 db_int db_fileseek(db_fileref_t f, size_t size) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_file_t *fp = db_storage_findfile(f);
+  if (NULL != fp) {
+    fp->position += (long)size;
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+    return (db_int)(fp->position);
+#elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+    return 1;
+#else
+    return 0;
+#endif
+  }
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   return cfs_seek(f, size, CFS_SEEK_CUR);
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -140,7 +462,30 @@ db_int db_fileseek(db_fileref_t f, size_t size) {
 #endif
 }
 
+long db_filesize(db_fileref_t f) {
+#if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
+  cfs_offset_t pos = cfs_seek(f, 0, CFS_SEEK_CUR);
+  cfs_offset_t size = cfs_seek(f, 0, CFS_SEEK_END);
+  cfs_seek(f, pos, CFS_SEEK_SET);
+  return (long)size;
+#elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
+  return (long)SD_File_Size(f);
+#else
+  long pos = ftell(f);
+  if (-1 == pos || 0 != fseek(f, 0, SEEK_END))
+    return -1;
+  long size = ftell(f);
+  fseek(f, pos, SEEK_SET);
+  return size;
+#endif
+}
+
 db_int db_fileclose(db_fileref_t f) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_file_t *fp = db_storage_findfile(f);
+  if (NULL != fp)
+    fp->used = 0;
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   cfs_close(f);
   return 1;
@@ -153,6 +498,9 @@ db_int db_fileclose(db_fileref_t f) {
 }
 
 db_int db_fileremove(char *filename) {
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  db_storage_dropfile(filename);
+#endif
 #if DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_CONTIKI
   return (0 == cfs_remove(filename));
 #elif DB_CTCONF_SETTING_TARGET == DB_CTCONF_OPTION_TARGET_ARDUINO
@@ -161,3 +509,57 @@ db_int db_fileremove(char *filename) {
   return (0 == remove(filename));
 #endif
 }
+
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+unsigned char *db_filepin(db_fileref_t f, long pageno, db_int *lengthp) {
+  db_storage_file_t *fp = db_storage_findfile(f);
+  db_int i;
+  if (NULL == fp)
+    return NULL;
+
+  i = db_storage_pin(fp, pageno);
+  if (i < 0)
+    return NULL;
+  *lengthp = db_storage_frames[i].length;
+  return db_storage_pages[i];
+}
+
+void db_fileunpin(unsigned char *page) {
+  db_int i = (db_int)((page - db_storage_pages[0]) /
+                      DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE);
+  if (i >= 0 && i < DB_CTCONF_SETTING_BUFFERPOOL_PAGES &&
+      db_storage_frames[i].pins > 0)
+    db_storage_frames[i].pins--;
+}
+
+void db_filepoolclear(void) {
+  db_int i;
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_PAGES; ++i) {
+    if (0 == db_storage_frames[i].pins)
+      db_storage_frames[i].name[0] = '\0';
+  }
+}
+
+long db_filepoolmisses(void) { return db_storage_misses; }
+#endif
+
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+unsigned char *db_filemap(db_fileref_t f, long *sizep) {
+  struct stat st;
+  void *map;
+  if (DB_STORAGE_NOFILE == f || 0 != fstat(fileno(f), &st) ||
+      st.st_size <= 0)
+    return NULL;
+
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fileno(f), 0);
+  if (MAP_FAILED == map)
+    return NULL;
+  *sizep = (long)st.st_size;
+  return (unsigned char *)map;
+}
+
+void db_fileunmap(unsigned char *map, long size) {
+  if (NULL != map)
+    munmap(map, (size_t)size);
+}
+#endif
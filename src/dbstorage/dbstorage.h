@@ -151,6 +151,15 @@ db_int db_filerewind(db_fileref_t f);
 */
 db_int db_fileseek(db_fileref_t f, size_t size);
 
+/**
+@brief		Find the size of an open file.
+@details	The file's internal position is left where it was.
+@param		f	A reference to the file whose size is wanted.
+@returns	The number of bytes in the file, or @c -1 if it could not be
+		determined.
+*/
+long db_filesize(db_fileref_t f);
+
 /**
 @brief		Close a file.
 @param		f	A reference to the file to close.
@@ -165,6 +174,74 @@ db_int db_fileclose(db_fileref_t f);
 */
 db_int db_fileremove(char *filename);
 
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+/**
+@brief		Pin a page of an open file in the buffer pool.
+@details	Files are split into pages of
+		@ref DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE bytes.  All reads
+		and writes of a file opened through this layer go through the
+		pool: reads are copied out of cached pages, loading them on a
+		miss, and writes go straight to the file while also updating
+		any cached copy, so the file is always current.  When a page
+		must be loaded and the pool is full, the least recently used
+		unpinned page, by the clock algorithm, is evicted.
+
+		A pinned page is never evicted, so its bytes may be read in
+		place until it is unpinned.  Writes through this layer still
+		update it.
+@param		f		A reference to the file.
+@param		pageno		Which page of the file to pin, counting
+				from @c 0.
+@param		lengthp		A pointer to where the number of bytes of
+				the page that are in the file will be
+				written.  This is less than a full page at
+				the end of the file.
+@returns	A pointer to the page's bytes, or @c NULL if the page
+		could not be pinned.
+*/
+unsigned char *db_filepin(db_fileref_t f, long pageno, db_int *lengthp);
+
+/**
+@brief		Unpin a page pinned by @ref db_filepin.
+@param		page		The pointer returned by @ref db_filepin.
+*/
+void db_fileunpin(unsigned char *page);
+
+/**
+@brief		Drop every unpinned page from the buffer pool.
+*/
+void db_filepoolclear(void);
+
+/**
+@brief		Find how many pages have been loaded into the buffer pool
+		from storage.
+@returns	The number of buffer pool misses so far.
+*/
+long db_filepoolmisses(void);
+#endif
+
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+/**
+@brief		Map the whole of an open file into memory, read-only.
+@details	The mapping is shared with the file, so writes made to the
+		file afterwards are seen through it, but it does not grow
+		with the file.
+@param		f		A reference to the file.
+@param		sizep		A pointer to where the number of bytes mapped
+				will be written.
+@returns	A pointer to the first byte of the file, or @c NULL if the
+		file could not be mapped, as when it is empty.
+*/
+unsigned char *db_filemap(db_fileref_t f, long *sizep);
+
+/**
+@brief		Remove a mapping made by @ref db_filemap.
+@param		map		The pointer returned by @ref db_filemap.
+@param		size		The number of bytes that were mapped.
+*/
+void db_fileunmap(unsigned char *map, long size);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
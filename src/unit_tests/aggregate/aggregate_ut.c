@@ -31,8 +31,12 @@
 #include "../../dbops/select.h"
 #include "../../dbops/sort.h"
 #include "../../dbops/aggregate.h"
+#include "../../dbparser/dbparser.h"
 #include "../../db_ctconf.h"
 
+/* These tests are only built when aggregation is enabled, for instance with
+   CFLAGS=-DDB_CTCONF_SETTING_FEATURE_AGGREGATION=1 make tests
+   and they read the relations made by make init-test-db. */
 #ifdef DB_CTCONF_SETTING_FEATURE_AGGREGATION
 #if DB_CTCONF_SETTING_FEATURE_AGGREGATION == 1
 
@@ -62,25 +66,22 @@ void test_aggregate_1(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 1: Sum all numbers in first attribute of fruit relation.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (1*sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_dbint_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -90,7 +91,7 @@ void test_aggregate_1(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -154,25 +155,22 @@ void test_aggregate_2(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 2: Sum all numbers in third attribute of fruit relation.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (1*sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_dbint_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -182,7 +180,7 @@ void test_aggregate_2(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -245,25 +243,22 @@ void test_aggregate_3(CuTest *tc)
 	puts("Test 3: Sum all numbers in third attribute of fruit relation, with\nnull GROUP BY clause.");
 	fflush(stdout);
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -327,25 +322,22 @@ void test_aggregate_4(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 4: Sum all numbers in third attribute of fruit relation, grouping\non the first attribute.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_attr_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -356,7 +348,7 @@ void test_aggregate_4(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -447,25 +439,22 @@ void test_aggregate_5(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 5: Sum all numbers in first attribute of fruit relation, grouping\non the third attribute.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -476,7 +465,7 @@ void test_aggregate_5(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -560,25 +549,22 @@ void test_aggregate_6(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 6: Sum all numbers in first attribute of fruit relation, grouping\non the 4th attribute.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -589,7 +575,7 @@ void test_aggregate_6(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -673,25 +659,22 @@ void test_aggregate_7(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 7: Sum all numbers in first attribute of fruit relation, grouping\non the second attribute.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -702,7 +685,7 @@ void test_aggregate_7(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -788,33 +771,28 @@ void test_aggregate_8(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 8: Sum all numbers in third attribute of fruit relation, grouping\non the second attribute, having sum > 10.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -825,24 +803,24 @@ void test_aggregate_8(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 0;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 10;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), oneExpr, 1, oneGroupExpr, 1, &havingExpr, &mm);
@@ -906,33 +884,28 @@ void test_aggregate_9(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 9: Sum all numbers in third attribute of fruit relation, grouping\non the fourth attribute, having sum > 15.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -943,24 +916,24 @@ void test_aggregate_9(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 0;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 15;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), oneExpr, 1, oneGroupExpr, 1, &havingExpr, &mm);
@@ -1017,33 +990,28 @@ void test_aggregate_10(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 10: Sum all numbers in fourth attribute of fruit relation, grouping\non the third attribute, having sum > 1000.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 3;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -1054,24 +1022,24 @@ void test_aggregate_10(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 0;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 1000;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), oneExpr, 1, oneGroupExpr, 1, &havingExpr, &mm);
@@ -1114,8 +1082,6 @@ void test_aggregate_11(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	char* strResult;
@@ -1123,26 +1089,23 @@ void test_aggregate_11(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 11: Sum all numbers in third attribute of fruit relation and also\nselect second attribute, grouping on the second attribute,\nhaving sum > 11.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t) + sizeof(db_eetnode_t));
+	twoExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 1;
@@ -1150,11 +1113,8 @@ void test_aggregate_11(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -1165,24 +1125,24 @@ void test_aggregate_11(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 0;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 11;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	CuAssertTrue(tc, 1 == init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, oneGroupExpr, 1, &havingExpr, &mm));
@@ -1258,8 +1218,6 @@ void test_aggregate_12(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	char* strResult;
@@ -1267,26 +1225,23 @@ void test_aggregate_12(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 12: Sum all numbers in third attribute of fruit relation and also\nselect second attribute, grouping on the second attribute,\nhaving sum > 11 and name != 'Orange'.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t) + sizeof(db_eetnode_t));
+	twoExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 1;
@@ -1294,11 +1249,8 @@ void test_aggregate_12(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbstring_t) + sizeof(db_eetnode_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -1309,30 +1261,21 @@ void test_aggregate_12(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (4*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + 2*sizeof(db_eetnode_dbint_t) +
-				sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbstring_t));
+	havingExpr.size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_dbstring_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_AND;
-	*arr_p = opNode;
-	arr_p++;
-	
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 0;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 11;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	opNode.type = DB_EETNODE_OP_NEQ;
+	opNode.type = DB_EETNODE_OP_GT;
 	*arr_p = opNode;
 	arr_p++;
 	
@@ -1345,6 +1288,14 @@ void test_aggregate_12(CuTest *tc)
 	*((db_eetnode_dbstring_t*)arr_p) = dbstringNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbstring_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_NEQ;
+	*arr_p = opNode;
+	arr_p++;
+	
+	opNode.type = DB_EETNODE_OP_AND;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, oneGroupExpr, 1, &havingExpr, &mm);
@@ -1408,19 +1359,17 @@ void test_aggregate_13(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 13: Select third attribute and sum of first attribute, grouping\non the third and fourth attributes,\nhaving sum > 2.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[1].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
@@ -1430,28 +1379,22 @@ void test_aggregate_13(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
@@ -1468,24 +1411,24 @@ void test_aggregate_13(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 2;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -1560,27 +1503,21 @@ void test_aggregate_14(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 14: Select 7 + third attribute and sum(first attribute) * 5,\ngrouping on the third+10 and fourth attributes,\nhaving sum > 7.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_attr_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)(twoExpr[0].size));
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -1590,44 +1527,38 @@ void test_aggregate_14(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
+	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -1637,7 +1568,8 @@ void test_aggregate_14(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
 	arr_p++;
 	
 	arr_p = twoGroupExpr[1].nodes;
@@ -1646,28 +1578,25 @@ void test_aggregate_14(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -1752,27 +1681,21 @@ void test_aggregate_15(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 15: Select 7 + third attribute and 5*sum(first attribute),\ngrouping on the third+10 and fourth attributes,\nhaving sum > 7.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -1782,44 +1705,38 @@ void test_aggregate_15(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -1829,6 +1746,10 @@ void test_aggregate_15(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 3;
 	attrNode.tuple_pos = 0;
@@ -1836,24 +1757,24 @@ void test_aggregate_15(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -1938,19 +1859,17 @@ void test_aggregate_16(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 16: Select 7 (constant) and 5*sum(first attribute),\ngrouping on the third+10 and fourth attributes,\nhaving sum > 7, also testing rewind.");
 	// Build projecting expression.
-	twoExpr[0].size = (sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
@@ -1959,44 +1878,34 @@ void test_aggregate_16(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2006,6 +1915,10 @@ void test_aggregate_16(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 3;
 	attrNode.tuple_pos = 0;
@@ -2013,24 +1926,24 @@ void test_aggregate_16(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -2158,27 +2071,21 @@ void test_aggregate_17(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 17: Select 7 + third attribute and 5*count(first attribute),\ngrouping on the third+10 and third attributes,\nhaving count > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -2188,44 +2095,38 @@ void test_aggregate_17(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2235,6 +2136,10 @@ void test_aggregate_17(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -2242,24 +2147,24 @@ void test_aggregate_17(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -2344,27 +2249,21 @@ void test_aggregate_18(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 18: Select 7 + third attribute and 5*min(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -2374,44 +2273,38 @@ void test_aggregate_18(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_MIN;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_MIN;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2421,6 +2314,10 @@ void test_aggregate_18(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -2428,24 +2325,24 @@ void test_aggregate_18(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -2530,27 +2427,21 @@ void test_aggregate_19(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 19: Select 7 + third attribute and 5*max(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -2560,44 +2451,38 @@ void test_aggregate_19(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_MAX;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_MAX;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2607,6 +2492,10 @@ void test_aggregate_19(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -2614,24 +2503,24 @@ void test_aggregate_19(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -2716,27 +2605,21 @@ void test_aggregate_20(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 20: Select 7 + third attribute and 5*first(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -2746,44 +2629,38 @@ void test_aggregate_20(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_FIRST;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_FIRST;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2793,6 +2670,10 @@ void test_aggregate_20(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -2800,24 +2681,24 @@ void test_aggregate_20(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -2902,27 +2783,21 @@ void test_aggregate_21(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 21: Select 7 + third attribute and 5*last(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -2932,44 +2807,38 @@ void test_aggregate_21(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_LAST;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_LAST;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -2979,6 +2848,10 @@ void test_aggregate_21(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -2986,24 +2859,24 @@ void test_aggregate_21(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -3088,27 +2961,21 @@ void test_aggregate_22(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 22: Select 7 + third attribute and 5*AND(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -3118,44 +2985,38 @@ void test_aggregate_22(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_BAND;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_BAND;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -3165,6 +3026,10 @@ void test_aggregate_22(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -3172,24 +3037,24 @@ void test_aggregate_22(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -3274,27 +3139,21 @@ void test_aggregate_23(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 23: Select 7 + third attribute and 5*OR(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -3304,44 +3163,38 @@ void test_aggregate_23(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_BOR;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_BOR;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -3351,6 +3204,10 @@ void test_aggregate_23(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -3358,24 +3215,24 @@ void test_aggregate_23(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -3460,27 +3317,21 @@ void test_aggregate_24(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 24: Select 7 + third attribute and 5*XOR(first attribute),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -3490,44 +3341,38 @@ void test_aggregate_24(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_BXOR;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	aggrTNode.aggr_type = DB_AGGR_BXOR;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -3537,6 +3382,10 @@ void test_aggregate_24(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -3544,24 +3393,24 @@ void test_aggregate_24(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_1", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -3652,26 +3501,23 @@ void test_aggregate_26(CuTest *tc)
 	puts("Test 26: Sum all numbers in third attribute of fruit relation and also\nselect fourth attribute, grouping on the fourth attribute.");
 	// Build projecting expression.
 	
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 3;
@@ -3679,11 +3525,8 @@ void test_aggregate_26(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -3694,7 +3537,7 @@ void test_aggregate_26(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -3817,26 +3660,23 @@ void test_aggregate_27(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 27: Sum all numbers in third attribute of fruit relation and also\nselect first attribute, grouping on the first attribute.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 0;
@@ -3844,11 +3684,8 @@ void test_aggregate_27(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -3858,11 +3695,8 @@ void test_aggregate_27(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -3973,22 +3807,19 @@ void test_aggregate_28(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 28: Count all rows in fruit_stock_2.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 3;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
 	oneGroupExpr[0].size = (sizeof(db_eetnode_dbint_t));
@@ -4001,7 +3832,7 @@ void test_aggregate_28(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -4066,25 +3897,22 @@ void test_aggregate_29(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 29: Count rows of tenattrtable, grouping\non the third attribute.");
 	// Build projecting expression.
-	oneExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	oneExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
 	oneExpr[0].stack_size = oneExpr[0].size;
 
 	arr_p = oneExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 3;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -4095,7 +3923,7 @@ void test_aggregate_29(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -4196,26 +4024,23 @@ void test_aggregate_30(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 30: Count rows, grouping on the 10th attribute.");
 	// Build projecting expression.
-	twoExpr[0].size = (2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_t));
+	twoExpr[0].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 9;
@@ -4223,11 +4048,8 @@ void test_aggregate_30(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
 	// Build GROUP BY expression.
-	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	oneGroupExpr[0].size = (sizeof(db_eetnode_attr_t));
 	oneGroupExpr[0].nodes = malloc((size_t)oneGroupExpr[0].size);
 	oneGroupExpr[0].stack_size = oneGroupExpr[0].size;
 	
@@ -4238,7 +4060,7 @@ void test_aggregate_30(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (1*sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -4311,27 +4133,21 @@ void test_aggregate_31(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 31: Select 7 + third attribute and SUM(5 * (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4341,18 +4157,11 @@ void test_aggregate_31(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_MULT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4362,23 +4171,24 @@ void test_aggregate_31(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -4388,6 +4198,10 @@ void test_aggregate_31(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -4395,24 +4209,24 @@ void test_aggregate_31(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -4492,27 +4306,21 @@ void test_aggregate_32(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 32: Select 7 + third attribute and SUM(5 + (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4522,18 +4330,11 @@ void test_aggregate_32(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
 	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4543,23 +4344,24 @@ void test_aggregate_32(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -4569,6 +4371,10 @@ void test_aggregate_32(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -4576,24 +4382,24 @@ void test_aggregate_32(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -4673,27 +4479,21 @@ void test_aggregate_33(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 33: Select 7 + third attribute and SUM(5 - (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4703,44 +4503,38 @@ void test_aggregate_33(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
 	arr_p++;
 	
 	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_SUB;
-	*arr_p = opNode;
-	arr_p++;
-	
-	dbintNode.integer = 5;
-	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
+	dbintNode.integer = 5;
+	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_SUB;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -4750,6 +4544,10 @@ void test_aggregate_33(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -4757,24 +4555,24 @@ void test_aggregate_33(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -4842,27 +4640,21 @@ void test_aggregate_34(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 34: Select 7 + third attribute and SUM(5 / (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4872,18 +4664,11 @@ void test_aggregate_34(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_DIV;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -4893,23 +4678,24 @@ void test_aggregate_34(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_DIV;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -4919,6 +4705,10 @@ void test_aggregate_34(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -4926,24 +4716,24 @@ void test_aggregate_34(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -5023,27 +4813,21 @@ void test_aggregate_35(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 35: Select 7 + third attribute and SUM(5 % (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5053,18 +4837,11 @@ void test_aggregate_35(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_MOD;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5074,23 +4851,24 @@ void test_aggregate_35(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_MOD;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5100,6 +4878,10 @@ void test_aggregate_35(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5107,24 +4889,24 @@ void test_aggregate_35(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -5204,27 +4986,21 @@ void test_aggregate_36(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 36: Select 7 + third attribute and SUM(5 AND (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5234,18 +5010,11 @@ void test_aggregate_36(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_AND;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5255,23 +5024,24 @@ void test_aggregate_36(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_AND;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5281,6 +5051,10 @@ void test_aggregate_36(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5288,24 +5062,24 @@ void test_aggregate_36(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -5385,27 +5159,21 @@ void test_aggregate_37(CuTest *tc)
 	db_eetnode_aggr_temp_t aggrTNode;
 	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
 	aggrTNode.value_p = NULL;
-	db_eetnode_aggr_attr_t aggrANode;
-	aggrANode.base.type = DB_EETNODE_AGGR_ATTR;
 	db_eetnode_t *arr_p;
 	db_int intResult;
 	
 	puts("**********************************************************************");
 	puts("Test 37: Select 7 + third attribute and SUM(5 = (attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5415,18 +5183,11 @@ void test_aggregate_37(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_EQ;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5436,23 +5197,24 @@ void test_aggregate_37(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_EQ;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5462,6 +5224,10 @@ void test_aggregate_37(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5469,24 +5235,24 @@ void test_aggregate_37(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
 	arr_p = havingExpr.nodes;
-	opNode.type = DB_EETNODE_OP_GT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrANode.pos = 1;
-	aggrANode.tuple_pos = 0;
-	*((db_eetnode_aggr_attr_t*)arr_p) = aggrANode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_attr_t*)arr_p)+1));
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	dbintNode.integer = 0;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_GT;
+	*arr_p = opNode;
+	arr_p++;
+	
 	// Initialize operators.
 	init_scan(&scan, "fruit_stock_2", &mm);
 	init_aggregate(&aggr, ((db_op_base_t*)&scan), twoExpr, 2, twoGroupExpr, 2, &havingExpr, &mm);
@@ -5548,19 +5314,15 @@ void test_aggregate_38(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 38: Select 7 + third attribute and SUM(!(attr(0)),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5570,39 +5332,33 @@ void test_aggregate_38(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_NOT;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	dbintNode.integer = 5;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_NOT;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5612,6 +5368,10 @@ void test_aggregate_38(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5619,7 +5379,7 @@ void test_aggregate_38(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -5737,19 +5497,15 @@ void test_aggregate_39(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 39: Select 7 + third attribute and SUM((attr(0) ISNULL),\ngrouping on the third+10 and third attributes,\nhaving aggregate > 0.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5759,40 +5515,34 @@ void test_aggregate_39(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_OP_ISNULL;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = twoExpr[1].nodes;
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_ISNULL;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5802,6 +5552,10 @@ void test_aggregate_39(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5809,7 +5563,7 @@ void test_aggregate_39(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -5927,19 +5681,15 @@ void test_aggregate_40(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 40: Select 7 + third attribute and SUM(length(attr(1)),\ngrouping on the third+10 and third attributes.");
 	// Build projecting expression.
-	twoExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	twoExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
 	twoExpr[0].stack_size = twoExpr[0].size;
 	
-	twoExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoExpr[1].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
 	twoExpr[1].stack_size = twoExpr[1].size;
 	
 	arr_p = twoExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -5949,40 +5699,34 @@ void test_aggregate_40(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
 	arr_p++;
 	
 	arr_p = twoExpr[1].nodes;
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_FUNC_LENGTH_DBSTRING;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 1;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
+	opNode.type = DB_EETNODE_FUNC_LENGTH_DBSTRING;
+	*arr_p = opNode;
 	arr_p++;
 	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
+	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -5992,6 +5736,10 @@ void test_aggregate_40(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -5999,7 +5747,7 @@ void test_aggregate_40(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -6117,23 +5865,19 @@ void test_aggregate_41(CuTest *tc)
 	puts("**********************************************************************");
 	puts("Test 41: Select 7 + third attribute and SUM(length(attr(1))*count(*))\nand max(attr(0)), grouping on the third+10 and third attributes.");
 	// Build projecting expression.
-	threeExpr[0].size = (3*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	threeExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	threeExpr[0].nodes = malloc((size_t)threeExpr[0].size);
 	threeExpr[0].stack_size = threeExpr[0].size;
 	
-	threeExpr[1].size = (4*sizeof(db_eetnode_t) + 3*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + 3*sizeof(db_eetnode_dbint_t));
+	threeExpr[1].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	threeExpr[1].nodes = malloc((size_t)threeExpr[1].size);
 	threeExpr[1].stack_size = threeExpr[1].size;
 	
-	threeExpr[2].size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	threeExpr[2].size = (sizeof(db_eetnode_aggr_temp_t) + sizeof(db_eetnode_attr_t));
 	threeExpr[2].nodes = malloc((size_t)threeExpr[2].size);
 	threeExpr[2].stack_size = threeExpr[2].size;
 	
 	arr_p = threeExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	dbintNode.integer = 7;
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
@@ -6143,28 +5887,21 @@ void test_aggregate_41(CuTest *tc)
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = threeExpr[1].nodes;
-	opNode.type = DB_EETNODE_OP_MULT;
-	*arr_p = opNode;
-	arr_p++;
-	
-	aggrTNode.aggr_type = DB_AGGR_SUM;
-	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
-	
-	opNode.type = DB_EETNODE_FUNC_LENGTH_DBSTRING;
+	opNode.type = DB_EETNODE_OP_ADD;
 	*arr_p = opNode;
 	arr_p++;
 	
+	arr_p = threeExpr[1].nodes;
 	attrNode.pos = 1;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
+	opNode.type = DB_EETNODE_FUNC_LENGTH_DBSTRING;
+	*arr_p = opNode;
+	arr_p++;
+	
+	aggrTNode.aggr_type = DB_AGGR_SUM;
 	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
@@ -6172,38 +5909,36 @@ void test_aggregate_41(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
-	
-	arr_p = threeExpr[2].nodes;
-	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
-	aggrTNode.aggr_type = DB_AGGR_MAX;
+	aggrTNode.aggr_type = DB_AGGR_COUNTROWS;
 	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
-	arr_p->type = DB_EETNODE_AGGR_TEMP;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_MULT;
+	*arr_p = opNode;
+	arr_p++;
+	
+	arr_p = threeExpr[2].nodes;
 	attrNode.pos = 0;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
-	arr_p->type = DB_EETNODE_COUNT;
-	arr_p++;
+	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
+	aggrTNode.aggr_type = DB_AGGR_MAX;
+	*((db_eetnode_aggr_temp_t*)arr_p) = aggrTNode;
+	arr_p->type = DB_EETNODE_AGGR_TEMP;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_aggr_temp_t*)arr_p)+1));
 	
 	// Build GROUP BY expression.
-	twoGroupExpr[0].size = (2*sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + 2*sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[0].size = (sizeof(db_eetnode_t) + sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
 	twoGroupExpr[0].nodes = malloc((size_t)twoGroupExpr[0].size);
 	twoGroupExpr[0].stack_size = twoGroupExpr[0].size;
 	
-	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_dbint_t));
+	twoGroupExpr[1].size = (sizeof(db_eetnode_attr_t));
 	twoGroupExpr[1].nodes = malloc((size_t)twoGroupExpr[1].size);
 	twoGroupExpr[1].stack_size = twoGroupExpr[1].size;
 	
 	arr_p = twoGroupExpr[0].nodes;
-	opNode.type = DB_EETNODE_OP_ADD;
-	*arr_p = opNode;
-	arr_p++;
-	
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
 	*((db_eetnode_attr_t*)arr_p) = attrNode;
@@ -6213,6 +5948,10 @@ void test_aggregate_41(CuTest *tc)
 	*((db_eetnode_dbint_t*)arr_p) = dbintNode;
 	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
 	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*arr_p = opNode;
+	arr_p++;
+	
 	arr_p = twoGroupExpr[1].nodes;
 	attrNode.pos = 2;
 	attrNode.tuple_pos = 0;
@@ -6220,7 +5959,7 @@ void test_aggregate_41(CuTest *tc)
 	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
 	
 	// Build the HAVING expression.
-	havingExpr.size = (2*sizeof(db_eetnode_t) + 2*sizeof(db_eetnode_aggr_attr_t) + sizeof(db_eetnode_dbint_t));
+	havingExpr.size = (sizeof(db_eetnode_dbint_t));
 	havingExpr.nodes = malloc((size_t)havingExpr.size);
 	havingExpr.stack_size = havingExpr.size;
 	
@@ -6329,6 +6068,745 @@ void test_aggregate_41(CuTest *tc)
 	puts("**********************************************************************");
 }
 
+/* Append a node to a postfix expression being built by hand. */
+static void hashaggr_ut_push(db_eet_t *eetp, void *node_p, db_int size)
+{
+	eetp->nodes = realloc(eetp->nodes, (size_t)(eetp->size + size));
+	memcpy(((char*)(eetp->nodes)) + eetp->size, node_p, (size_t)size);
+	eetp->size += size;
+	eetp->stack_size = eetp->size;
+}
+
+static void hashaggr_ut_attr(db_eet_t *eetp, db_uint8 pos)
+{
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	attrNode.pos = pos;
+	attrNode.tuple_pos = 0;
+	hashaggr_ut_push(eetp, &attrNode, sizeof(db_eetnode_attr_t));
+}
+
+static void hashaggr_ut_dbint(db_eet_t *eetp, db_int integer)
+{
+	db_eetnode_dbint_t dbintNode;
+	dbintNode.base.type = DB_EETNODE_CONST_DBINT;
+	dbintNode.integer = integer;
+	hashaggr_ut_push(eetp, &dbintNode, sizeof(db_eetnode_dbint_t));
+}
+
+static void hashaggr_ut_op(db_eet_t *eetp, db_uint8 type)
+{
+	db_eetnode_t opNode;
+	opNode.type = type;
+	hashaggr_ut_push(eetp, &opNode, sizeof(db_eetnode_t));
+}
+
+static void hashaggr_ut_aggr(db_eet_t *eetp, db_uint8 aggr_type)
+{
+	db_eetnode_aggr_temp_t aggrTNode;
+	aggrTNode.base.type = DB_EETNODE_AGGR_TEMP;
+	aggrTNode.aggr_type = aggr_type;
+	aggrTNode.aggr_isnull = 1;
+	aggrTNode.value_p = NULL;
+	aggrTNode.jump_p = NULL;
+	aggrTNode.subexpr_type = 0;
+	hashaggr_ut_push(eetp, &aggrTNode, sizeof(db_eetnode_aggr_temp_t));
+}
+
+/* Build aggr_type(attribute pos), or just the attribute if aggr_type is
+   negative. */
+static void hashaggr_ut_expr(db_eet_t *eetp, db_uint8 pos, db_int aggr_type)
+{
+	eetp->nodes = NULL;
+	eetp->size = 0;
+	hashaggr_ut_attr(eetp, pos);
+	if (aggr_type >= 0)
+		hashaggr_ut_aggr(eetp, (db_uint8)aggr_type);
+}
+
+/* Build attribute pos % modulus. */
+static void hashaggr_ut_mod(db_eet_t *eetp, db_uint8 pos, db_int modulus)
+{
+	eetp->nodes = NULL;
+	eetp->size = 0;
+	hashaggr_ut_attr(eetp, pos);
+	hashaggr_ut_dbint(eetp, modulus);
+	hashaggr_ut_op(eetp, DB_EETNODE_OP_MOD);
+}
+
+void test_aggregate_42(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t scan;
+	aggregate_t aggr;
+	db_tuple_t t;
+	db_eet_t exprs[5];
+	db_eet_t groupExpr;
+	db_int intResult, i, j, key;
+	db_int seen[5];
+	db_int counts[] = {3, 5, 4, 4, 4};
+	db_int sums[] = {40, 45, 38, 32, 46};
+	db_int mins[] = {5, 1, 2, 3, 4};
+	db_int maxs[] = {20, 16, 17, 18, 19};
+	
+	puts("**********************************************************************");
+	puts("Test 42: Hash aggregate shuffled_rel grouped by a % 5.");
+	hashaggr_ut_mod(&exprs[0], 0, 5);
+	hashaggr_ut_expr(&exprs[1], 0, DB_AGGR_COUNTROWS);
+	hashaggr_ut_expr(&exprs[2], 0, DB_AGGR_SUM);
+	hashaggr_ut_expr(&exprs[3], 0, DB_AGGR_MIN);
+	hashaggr_ut_expr(&exprs[4], 0, DB_AGGR_MAX);
+	hashaggr_ut_mod(&groupExpr, 0, 5);
+	
+	// Initialize operators.
+	init_scan(&scan, "shuffled_rel", &mm);
+	intResult = init_hashaggregate(&aggr, ((db_op_base_t*)&scan), exprs, 5, &groupExpr, 1, NULL, &mm);
+	CuAssertTrue(tc, 1 == intResult);
+	CuAssertTrue(tc, 4 == aggr.num_aggr);
+	CuAssertTrue(tc, 5 == aggr.base.header->num_attr);
+	init_tuple(&t, aggr.base.header->tuple_size, aggr.base.header->num_attr, &mm);
+	
+	// Run the test, twice to make sure rewinding works.
+	for (j = 0; j < 2; ++j)
+	{
+		for (i = 0; i < 5; ++i)
+			seen[i] = 0;
+		for (i = 0; i < 5; ++i)
+		{
+			intResult = next((db_op_base_t*)&aggr, &t, &mm);
+			CuAssertTrue(tc, 1 == intResult);
+			key = getintbypos(&t, 0, aggr.base.header);
+			printf("Group %d: count %d, sum %d, min %d, max %d\n", key,
+				getintbypos(&t, 1, aggr.base.header),
+				getintbypos(&t, 2, aggr.base.header),
+				getintbypos(&t, 3, aggr.base.header),
+				getintbypos(&t, 4, aggr.base.header));
+			CuAssertTrue(tc, key >= 0 && key < 5 && 0 == seen[key]);
+			seen[key] = 1;
+			CuAssertTrue(tc, counts[key] == getintbypos(&t, 1, aggr.base.header));
+			CuAssertTrue(tc, sums[key] == getintbypos(&t, 2, aggr.base.header));
+			CuAssertTrue(tc, mins[key] == getintbypos(&t, 3, aggr.base.header));
+			CuAssertTrue(tc, maxs[key] == getintbypos(&t, 4, aggr.base.header));
+		}
+		intResult = next((db_op_base_t*)&aggr, &t, &mm);
+		CuAssertTrue(tc, 0 == intResult);
+		/* Every group fit, so nothing was written out. */
+		CuAssertTrue(tc, 0 == aggr.num_files);
+		CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)&aggr, &mm));
+	}
+	
+	close((db_op_base_t*)&aggr, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	for (i = 0; i < 5; ++i)
+		free(exprs[i].nodes);
+	free(groupExpr.nodes);
+	puts("**********************************************************************");
+}
+
+void test_aggregate_43(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[1200];
+	init_query_mm(&mm, segment, 1200);
+	
+	scan_t scan;
+	aggregate_t aggr;
+	db_tuple_t t;
+	db_eet_t exprs[2];
+	db_eet_t groupExpr;
+	db_int intResult, i, j, key, count;
+	db_int seen[21];
+	db_int numGroups, totalCount, weightedSum;
+	
+	puts("**********************************************************************");
+	puts("Test 43: Hash aggregate shuffled_rel grouped by a, with too little memory for every group.");
+	hashaggr_ut_expr(&exprs[0], 0, -1);
+	hashaggr_ut_expr(&exprs[1], 0, DB_AGGR_COUNTROWS);
+	hashaggr_ut_expr(&groupExpr, 0, -1);
+	
+	// Initialize operators.
+	init_scan(&scan, "shuffled_rel", &mm);
+	intResult = init_hashaggregate(&aggr, ((db_op_base_t*)&scan), exprs, 2, &groupExpr, 1, NULL, &mm);
+	CuAssertTrue(tc, 1 == intResult);
+	init_tuple(&t, aggr.base.header->tuple_size, aggr.base.header->num_attr, &mm);
+	
+	// Run the test, twice to make sure rewinding works.
+	for (j = 0; j < 2; ++j)
+	{
+		for (i = 0; i < 21; ++i)
+			seen[i] = 0;
+		numGroups = 0;
+		totalCount = 0;
+		weightedSum = 0;
+		while (1 == (intResult = next((db_op_base_t*)&aggr, &t, &mm)))
+		{
+			key = getintbypos(&t, 0, aggr.base.header);
+			count = getintbypos(&t, 1, aggr.base.header);
+			CuAssertTrue(tc, key > 0 && key < 21 && 0 == seen[key]);
+			seen[key] = 1;
+			numGroups++;
+			totalCount += count;
+			weightedSum += key * count;
+		}
+		CuAssertTrue(tc, 0 == intResult);
+		printf("Groups: %d, tuples: %d, sum: %d, files: %d\n", numGroups, totalCount, weightedSum, aggr.num_files);
+		CuAssertTrue(tc, 18 == numGroups);
+		CuAssertTrue(tc, 20 == totalCount);
+		CuAssertTrue(tc, 201 == weightedSum);
+		/* Some groups had to wait for a later pass. */
+		CuAssertTrue(tc, aggr.num_files > 0);
+		CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)&aggr, &mm));
+	}
+	
+	close((db_op_base_t*)&aggr, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	for (i = 0; i < 2; ++i)
+		free(exprs[i].nodes);
+	free(groupExpr.nodes);
+	puts("**********************************************************************");
+}
+
+void test_aggregate_44(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t scan;
+	aggregate_t aggr;
+	db_tuple_t t;
+	db_eet_t exprs[4];
+	db_eet_t groupExpr;
+	db_int intResult, i, numGroups = 0;
+	char *name;
+	
+	puts("**********************************************************************");
+	puts("Test 44: Hash aggregate fruit_stock_2 grouped by name, with NULLs.");
+	hashaggr_ut_expr(&exprs[0], 1, -1);
+	hashaggr_ut_expr(&exprs[1], 0, DB_AGGR_COUNTROWS);
+	hashaggr_ut_expr(&exprs[2], 3, DB_AGGR_SUM);
+	hashaggr_ut_expr(&exprs[3], 0, DB_AGGR_MIN);
+	hashaggr_ut_expr(&groupExpr, 1, -1);
+	
+	// Initialize operators.
+	init_scan(&scan, "fruit_stock_2", &mm);
+	intResult = init_hashaggregate(&aggr, ((db_op_base_t*)&scan), exprs, 4, &groupExpr, 1, NULL, &mm);
+	CuAssertTrue(tc, 1 == intResult);
+	init_tuple(&t, aggr.base.header->tuple_size, aggr.base.header->num_attr, &mm);
+	
+	// Run the test.
+	while (1 == (intResult = next((db_op_base_t*)&aggr, &t, &mm)))
+	{
+		numGroups++;
+		if ((1 << 0) & t.isnull[0])
+		{
+			/* All the tuples without a name are one group. */
+			CuAssertTrue(tc, 2 == getintbypos(&t, 1, aggr.base.header));
+			CuAssertTrue(tc, 14 == getintbypos(&t, 2, aggr.base.header));
+			CuAssertTrue(tc, 3 == getintbypos(&t, 3, aggr.base.header));
+			continue;
+		}
+		name = getstringbypos(&t, 0, aggr.base.header);
+		printf("Group %s: count %d, sum %d\n", name,
+			getintbypos(&t, 1, aggr.base.header),
+			getintbypos(&t, 2, aggr.base.header));
+		if (0 == strcmp(name, "Lemon"))
+		{
+			/* Nothing to count, and no minimum. */
+			CuAssertTrue(tc, 0 == getintbypos(&t, 1, aggr.base.header));
+			CuAssertTrue(tc, 4 == getintbypos(&t, 2, aggr.base.header));
+			CuAssertTrue(tc, (1 << 3) & t.isnull[0]);
+		}
+		else if (0 == strcmp(name, "Orange"))
+		{
+			CuAssertTrue(tc, 1 == getintbypos(&t, 1, aggr.base.header));
+			CuAssertTrue(tc, 3 == getintbypos(&t, 2, aggr.base.header));
+			CuAssertTrue(tc, 2 == getintbypos(&t, 3, aggr.base.header));
+		}
+	}
+	CuAssertTrue(tc, 0 == intResult);
+	CuAssertTrue(tc, 5 == numGroups);
+	
+	close((db_op_base_t*)&aggr, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	for (i = 0; i < 4; ++i)
+		free(exprs[i].nodes);
+	free(groupExpr.nodes);
+	puts("**********************************************************************");
+}
+
+void test_aggregate_45(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t scan;
+	aggregate_t aggr;
+	db_tuple_t t;
+	db_eet_t exprs[2];
+	db_eet_t groupExpr;
+	db_eet_t havingExpr;
+	db_int intResult, i;
+	
+	puts("**********************************************************************");
+	puts("Test 45: Hash aggregate shuffled_rel grouped by a % 5 having COUNT(a) > 4.");
+	hashaggr_ut_mod(&exprs[0], 0, 5);
+	hashaggr_ut_expr(&exprs[1], 0, DB_AGGR_SUM);
+	hashaggr_ut_mod(&groupExpr, 0, 5);
+	hashaggr_ut_expr(&havingExpr, 0, DB_AGGR_COUNTROWS);
+	hashaggr_ut_dbint(&havingExpr, 4);
+	hashaggr_ut_op(&havingExpr, DB_EETNODE_OP_GT);
+	
+	// Initialize operators.
+	init_scan(&scan, "shuffled_rel", &mm);
+	intResult = init_hashaggregate(&aggr, ((db_op_base_t*)&scan), exprs, 2, &groupExpr, 1, &havingExpr, &mm);
+	CuAssertTrue(tc, 1 == intResult);
+	CuAssertTrue(tc, 2 == aggr.num_aggr);
+	init_tuple(&t, aggr.base.header->tuple_size, aggr.base.header->num_attr, &mm);
+	
+	// Run the test.
+	intResult = next((db_op_base_t*)&aggr, &t, &mm);
+	CuAssertTrue(tc, 1 == intResult);
+	CuAssertTrue(tc, 1 == getintbypos(&t, 0, aggr.base.header));
+	CuAssertTrue(tc, 45 == getintbypos(&t, 1, aggr.base.header));
+	intResult = next((db_op_base_t*)&aggr, &t, &mm);
+	CuAssertTrue(tc, 0 == intResult);
+	
+	close((db_op_base_t*)&aggr, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	for (i = 0; i < 2; ++i)
+		free(exprs[i].nodes);
+	free(groupExpr.nodes);
+	free(havingExpr.nodes);
+	puts("**********************************************************************");
+}
+
+void test_aggregate_46(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	scan_t scan;
+	aggregate_t aggr;
+	db_eet_t expr;
+	db_eet_t groupExpr;
+	db_int intResult;
+	
+	puts("**********************************************************************");
+	puts("Test 46: Hash aggregates only sum integers.");
+	hashaggr_ut_expr(&expr, 1, DB_AGGR_SUM);
+	hashaggr_ut_expr(&groupExpr, 0, -1);
+	
+	init_scan(&scan, "shuffled_rel", &mm);
+	intResult = init_hashaggregate(&aggr, ((db_op_base_t*)&scan), &expr, 1, &groupExpr, 1, NULL, &mm);
+	CuAssertTrue(tc, -1 == intResult);
+	
+	close((db_op_base_t*)&scan, &mm);
+	free(expr.nodes);
+	free(groupExpr.nodes);
+	puts("**********************************************************************");
+}
+
+/* Parse a grouped query, checking its plan, and return its root. */
+static db_op_base_t *hashaggr_ut_parse(CuTest *tc, char *command, char *expectedtree, db_query_mm_t *mmp)
+{
+	char *output;
+	db_op_base_t *rootp = parse(command, mmp);
+	CuAssertTrue(tc, NULL != rootp);
+	
+	queryTreeToString(rootp, &output);
+	puts(output);
+	CuAssertTrue(tc, 0 == strcmp(expectedtree, output));
+	free(output);
+	CuAssertTrue(tc, DB_AGGREGATE == rootp->type);
+	return rootp;
+}
+
+void test_aggregate_47(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	db_int intResult, i, key;
+	db_int seen[5] = {0, 0, 0, 0, 0};
+	db_int counts[] = {3, 5, 4, 4, 4};
+	db_int sums[] = {40, 45, 38, 32, 46};
+	
+	puts("**********************************************************************");
+	puts("Test 47: Parse a GROUP BY on an expression, aggregated in a hash table.");
+	rootp = hashaggr_ut_parse(tc, "SELECT a % 5, COUNT(a), SUM(a) FROM shuffled_rel GROUP BY a % 5;", "+AGGREGATE\n++SELECT\n+++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	
+	for (i = 0; i < 5; ++i)
+	{
+		intResult = next(rootp, &t, &mm);
+		CuAssertTrue(tc, 1 == intResult);
+		key = getintbypos(&t, 0, rootp->header);
+		printf("Group %d: count %d, sum %d\n", key,
+			getintbypos(&t, 1, rootp->header),
+			getintbypos(&t, 2, rootp->header));
+		CuAssertTrue(tc, key >= 0 && key < 5 && 0 == seen[key]);
+		seen[key] = 1;
+		CuAssertTrue(tc, counts[key] == getintbypos(&t, 1, rootp->header));
+		CuAssertTrue(tc, sums[key] == getintbypos(&t, 2, rootp->header));
+	}
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	/* The groups were kept in a table. */
+	CuAssertTrue(tc, ((aggregate_t*)rootp)->num_slots > 1);
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+void test_aggregate_48(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[6000];
+	init_query_mm(&mm, segment, 6000);
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	db_int intResult, key, last = 0, numGroups = 0, totalCount = 0;
+	
+	puts("**********************************************************************");
+	puts("Test 48: Parse a GROUP BY on sorted tuples, aggregated in a single pass.");
+	rootp = hashaggr_ut_parse(tc, "SELECT a, COUNT(b), MAX(a) FROM shuffled_rel GROUP BY a ORDER BY a;", "+AGGREGATE\n++SORT\n+++SELECT\n++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	
+	while (1 == (intResult = next(rootp, &t, &mm)))
+	{
+		key = getintbypos(&t, 0, rootp->header);
+		printf("Group %d: count %d\n", key, getintbypos(&t, 1, rootp->header));
+		/* Each group is returned once, in order. */
+		CuAssertTrue(tc, key > last);
+		CuAssertTrue(tc, key == getintbypos(&t, 2, rootp->header));
+		CuAssertTrue(tc, (3 == key || 11 == key ? 2 : 1) == getintbypos(&t, 1, rootp->header));
+		last = key;
+		numGroups++;
+		totalCount += getintbypos(&t, 1, rootp->header);
+	}
+	CuAssertTrue(tc, 0 == intResult);
+	CuAssertTrue(tc, 18 == numGroups);
+	CuAssertTrue(tc, 20 == totalCount);
+	/* Only the group being aggregated was kept. */
+	CuAssertTrue(tc, 1 == ((aggregate_t*)rootp)->num_slots);
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+void test_aggregate_49(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	
+	puts("**********************************************************************");
+	puts("Test 49: Parse a GROUP BY with a HAVING clause.");
+	rootp = hashaggr_ut_parse(tc, "SELECT a % 5, SUM(a) FROM shuffled_rel GROUP BY a % 5 HAVING COUNT(a) > 4;", "+AGGREGATE\n++SELECT\n+++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 1 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 45 == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+void test_aggregate_50(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	scan_t scan;
+	db_tuple_t t;
+	db_int count = 0, min = 0, max = 0, value;
+	
+	puts("**********************************************************************");
+	puts("Test 50: Parse COUNT(*), MIN and MAX over a whole relation, with no GROUP BY.");
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_tuple(&t, scan.base.header->tuple_size, scan.base.header->num_attr, &mm);
+	while (1 == next((db_op_base_t*)&scan, &t, &mm))
+	{
+		value = getintbypos(&t, 0, scan.base.header);
+		if (0 == count || value < min)
+			min = value;
+		if (0 == count || value > max)
+			max = value;
+		count++;
+	}
+	close_tuple(&t, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	CuAssertTrue(tc, 20 == count);
+	
+	init_query_mm(&mm, segment, 3000);
+	rootp = hashaggr_ut_parse(tc, "SELECT COUNT(*), MIN(a), MAX(a) FROM shuffled_rel;", "+AGGREGATE\n++SELECT\n+++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, count == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, min == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, max == getintbypos(&t, 2, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	/* There is only ever one group. */
+	CuAssertTrue(tc, 1 == ((aggregate_t*)rootp)->num_slots);
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+void test_aggregate_51(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	
+	puts("**********************************************************************");
+	puts("Test 51: Aggregates with no GROUP BY over no tuples return one tuple.");
+	rootp = hashaggr_ut_parse(tc, "SELECT COUNT(*), MAX(a) FROM shuffled_rel WHERE a > 1000;", "+AGGREGATE\n++SELECT\n+++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 0 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 0 == (t.isnull[0] & 1));
+	CuAssertTrue(tc, 0 != (t.isnull[0] & 2));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+/* Run a query with no GROUP BY over aggregate_ut_rel, returning the root of
+   its plan once its one tuple has been read. */
+static db_op_base_t *simpleaggr_ut_run(CuTest *tc, char *command, db_tuple_t *tp, db_query_mm_t *mmp)
+{
+	db_op_base_t *rootp = hashaggr_ut_parse(tc, command, "+AGGREGATE\n++SELECT\n+++SCAN\n", mmp);
+	init_tuple(tp, rootp->header->tuple_size, rootp->header->num_attr, mmp);
+	CuAssertTrue(tc, 1 == next(rootp, tp, mmp));
+	return rootp;
+}
+
+void test_aggregate_52(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	
+	db_op_base_t *rootp;
+	scan_t *scanp;
+	db_tuple_t t;
+	
+	puts("**********************************************************************");
+	puts("Test 52: COUNT(*), MIN and MAX answered from a relation's statistics.");
+	db_fileremove("aggregate_ut_rel");
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("CREATE TABLE aggregate_ut_rel (a INT, b INT);", &mm));
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("INSERT INTO aggregate_ut_rel VALUES (5, 1);", &mm));
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("INSERT INTO aggregate_ut_rel VALUES (2, 2);", &mm));
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("INSERT INTO aggregate_ut_rel VALUES (9, 3);", &mm));
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("INSERT INTO aggregate_ut_rel VALUES (7, 4);", &mm));
+	
+	init_query_mm(&mm, segment, 3000);
+	rootp = simpleaggr_ut_run(tc, "SELECT COUNT(*), MIN(a), MAX(a), MAX(b) FROM aggregate_ut_rel;", &t, &mm);
+	CuAssertTrue(tc, 4 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 2 == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 9 == getintbypos(&t, 2, rootp->header));
+	CuAssertTrue(tc, 4 == getintbypos(&t, 3, rootp->header));
+	/* Not one tuple was read. */
+	scanp = (scan_t*)(((select_t*)(((aggregate_t*)rootp)->child))->child);
+	CuAssertTrue(tc, NULL != ((aggregate_t*)rootp)->stats);
+	CuAssertTrue(tc, scanp->first_record == scanp->position);
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	/* An attribute outside of an aggregate needs a tuple. */
+	init_query_mm(&mm, segment, 3000);
+	rootp = simpleaggr_ut_run(tc, "SELECT a, COUNT(*) FROM aggregate_ut_rel;", &t, &mm);
+	CuAssertTrue(tc, 5 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 4 == getintbypos(&t, 1, rootp->header));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	/* Deleting the largest value loses the bounds of a, but not the count. */
+	init_query_mm(&mm, segment, 3000);
+	parse("DELETE FROM aggregate_ut_rel WHERE a = 9;", &mm);
+	init_query_mm(&mm, segment, 3000);
+	rootp = simpleaggr_ut_run(tc, "SELECT COUNT(*), MIN(a), MAX(a), MIN(b) FROM aggregate_ut_rel;", &t, &mm);
+	CuAssertTrue(tc, 3 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 2 == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 7 == getintbypos(&t, 2, rootp->header));
+	CuAssertTrue(tc, 1 == getintbypos(&t, 3, rootp->header));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	init_query_mm(&mm, segment, 3000);
+	rootp = simpleaggr_ut_run(tc, "SELECT COUNT(*), MIN(b) FROM aggregate_ut_rel;", &t, &mm);
+	CuAssertTrue(tc, 3 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 1 == getintbypos(&t, 1, rootp->header));
+	scanp = (scan_t*)(((select_t*)(((aggregate_t*)rootp)->child))->child);
+	CuAssertTrue(tc, scanp->first_record == scanp->position);
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	db_fileremove("DB_STAT_aggregate_ut_rel");
+	db_fileremove("aggregate_ut_rel");
+	puts("**********************************************************************");
+}
+
+
+/* Parse a query that is not answered by an aggregate operator at its root. */
+static db_op_base_t *aggrabove_ut_parse(CuTest *tc, char *command, char *expectedtree, db_query_mm_t *mmp)
+{
+	char *output;
+	db_op_base_t *rootp = parse(command, mmp);
+	CuAssertTrue(tc, NULL != rootp);
+	
+	queryTreeToString(rootp, &output);
+	puts(output);
+	CuAssertTrue(tc, 0 == strcmp(expectedtree, output));
+	free(output);
+	return rootp;
+}
+
+void test_aggregate_53(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	db_int key;
+	db_int counts[] = {3, 5, 4, 4, 4};
+	
+	puts("**********************************************************************");
+	puts("Test 53: LIMIT keeps the first groups, not the first tuples.");
+	init_query_mm(&mm, segment, 3000);
+	rootp = aggrabove_ut_parse(tc, "SELECT COUNT(a) FROM shuffled_rel LIMIT 1;", "+TOPN\n++AGGREGATE\n+++SELECT\n++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 20 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	init_query_mm(&mm, segment, 3000);
+	rootp = aggrabove_ut_parse(tc, "SELECT a % 5, COUNT(a) FROM shuffled_rel GROUP BY a % 5 LIMIT 1;", "+TOPN\n++AGGREGATE\n+++SELECT\n++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	key = getintbypos(&t, 0, rootp->header);
+	CuAssertTrue(tc, key >= 0 && key < 5);
+	/* The group was counted in full. */
+	CuAssertTrue(tc, counts[key] == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	/* Grouping on the ordered attribute still reads one group at a time,
+	   and the groups are limited after. */
+	init_query_mm(&mm, segment, 3000);
+	rootp = aggrabove_ut_parse(tc, "SELECT a, COUNT(b) FROM shuffled_rel GROUP BY a ORDER BY a DESC LIMIT 2;", "+TOPN\n++AGGREGATE\n+++SORT\n++++SELECT\n+++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 20 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 19 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	puts("**********************************************************************");
+}
+
+void test_aggregate_54(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	
+	db_op_base_t *rootp;
+	db_tuple_t t;
+	db_int i;
+	db_int keys[] = {1, 2, 3, 4, 0};
+	db_int counts[] = {5, 4, 4, 4, 3};
+	
+	puts("**********************************************************************");
+	puts("Test 54: ORDER BY orders the groups, by their columns or aggregates.");
+	init_query_mm(&mm, segment, 3000);
+	rootp = aggrabove_ut_parse(tc, "SELECT a % 5 AS m, COUNT(a) AS c FROM shuffled_rel GROUP BY a % 5 ORDER BY c DESC, m;", "+SORT\n++AGGREGATE\n+++SELECT\n++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	for (i = 0; i < 5; ++i)
+	{
+		CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+		CuAssertTrue(tc, keys[i] == getintbypos(&t, 0, rootp->header));
+		CuAssertTrue(tc, counts[i] == getintbypos(&t, 1, rootp->header));
+	}
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	init_query_mm(&mm, segment, 3000);
+	rootp = aggrabove_ut_parse(tc, "SELECT a % 5, SUM(a) FROM shuffled_rel GROUP BY a % 5 ORDER BY SUM(a) DESC LIMIT 2;", "+TOPN\n++AGGREGATE\n+++SELECT\n++++SCAN\n", &mm);
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 4 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 46 == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 1 == next(rootp, &t, &mm));
+	CuAssertTrue(tc, 1 == getintbypos(&t, 0, rootp->header));
+	CuAssertTrue(tc, 45 == getintbypos(&t, 1, rootp->header));
+	CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	
+	/* Only what the aggregate outputs can be ordered on. */
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, NULL == parse("SELECT a % 5, SUM(a) FROM shuffled_rel GROUP BY a % 5 ORDER BY MAX(a);", &mm));
+	init_query_mm(&mm, segment, 3000);
+	CuAssertTrue(tc, NULL == parse("SELECT a % 5, SUM(a) FROM shuffled_rel GROUP BY a % 5 ORDER BY b;", &mm));
+	puts("**********************************************************************");
+}
+
 #endif
 #endif
 
@@ -6379,6 +6857,19 @@ CuSuite *DBAggregateGetSuite()
 	SUITE_ADD_TEST(suite, test_aggregate_39);
 	SUITE_ADD_TEST(suite, test_aggregate_40);
 	SUITE_ADD_TEST(suite, test_aggregate_41);
+	SUITE_ADD_TEST(suite, test_aggregate_42);
+	SUITE_ADD_TEST(suite, test_aggregate_43);
+	SUITE_ADD_TEST(suite, test_aggregate_44);
+	SUITE_ADD_TEST(suite, test_aggregate_45);
+	SUITE_ADD_TEST(suite, test_aggregate_46);
+	SUITE_ADD_TEST(suite, test_aggregate_47);
+	SUITE_ADD_TEST(suite, test_aggregate_48);
+	SUITE_ADD_TEST(suite, test_aggregate_49);
+	SUITE_ADD_TEST(suite, test_aggregate_50);
+	SUITE_ADD_TEST(suite, test_aggregate_51);
+	SUITE_ADD_TEST(suite, test_aggregate_52);
+	SUITE_ADD_TEST(suite, test_aggregate_53);
+	SUITE_ADD_TEST(suite, test_aggregate_54);
 
 #endif
 #endif
@@ -0,0 +1,343 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dblogic/eet.h"
+#include "../../dbmacros.h"
+#include "../../dbobjects/relation.h"
+#include "../../dbobjects/tuple.h"
+#include "../../dbops/bnljoin.h"
+#include "../../dbops/db_ops.h"
+#include "../../dbops/scan.h"
+#include "../../dbparser/dbparser.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Build the condition "left <op> right" over the attributes at the given
+   positions. */
+static void bnljoin_ut_cmp(db_eet_t *eetp, db_uint8 lpos, db_uint8 op,
+                           db_uint8 rpos) {
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+
+  eetp->size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eetp->nodes = malloc((size_t)eetp->size);
+  eetp->stack_size = eetp->size;
+  arr_p = eetp->nodes;
+
+  attrnode.pos = lpos;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = rpos;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = op;
+  *(arr_p) = opnode;
+  arr_p++;
+}
+
+void test_bnljoin_1(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_int intResult, i, j;
+  char *strResult;
+  scan_t lscan, rscan;
+  bnljoin_t bnljoin;
+  db_tuple_t t;
+  db_int expectedIds[] = {2, 3, 5};
+  char *expectedNames[] = {"Orange", "Pear", "Lime"};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: Block join fruit_stock_1 with fruit_stock_2 on id.");
+
+  bnljoin_ut_cmp(&eet, 0, DB_EETNODE_OP_EQ, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_bnljoin(&bnljoin, &eet, (db_op_base_t *)&lscan,
+                           (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, DB_BNLJOIN == bnljoin.base.type);
+  init_tuple(&t, bnljoin.base.header->tuple_size,
+             bnljoin.base.header->num_attr, &mm);
+
+  /* Carry out test, twice to make sure rewinding works.  All of
+     fruit_stock_1 fits in one block, so fruit_stock_2 is read once and
+     the tuples come out in its order. */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < 3; ++i) {
+      intResult = next((db_op_base_t *)&bnljoin, &t, &mm);
+      CuAssertTrue(tc, 1 == intResult);
+      intResult = getintbypos(&t, 0, bnljoin.base.header);
+      printf("The db_int value at position %d in the returned tuple is: %d\n",
+             0, intResult);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      intResult = getintbypos(&t, 5, bnljoin.base.header);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      strResult = getstringbypos(&t, 1, bnljoin.base.header);
+      printf("The string value at position %d in the returned tuple is: %s\n",
+             1, strResult);
+      CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+    }
+
+    intResult = next((db_op_base_t *)&bnljoin, &t, &mm);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 1 == bnljoin.ldone);
+    /* The block was shrunk to fit the five tuples. */
+    CuAssertTrue(tc, 5 == bnljoin.capacity);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&bnljoin, &mm));
+  }
+
+  close((db_op_base_t *)&bnljoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_bnljoin_2(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_int intResult, count;
+  scan_t lscan, rscan;
+  bnljoin_t bnljoin;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Block join fruit_stock_1 with fruit_stock_2 with no "
+       "condition.");
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_bnljoin(&bnljoin, NULL, (db_op_base_t *)&lscan,
+                           (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, bnljoin.base.header->tuple_size,
+             bnljoin.base.header->num_attr, &mm);
+
+  count = 0;
+  while (1 == (intResult = next((db_op_base_t *)&bnljoin, &t, &mm)))
+    count++;
+  printf("Joined %d tuples.\n", count);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, estimatenumtuples((db_op_base_t *)&bnljoin) == count);
+
+  close((db_op_base_t *)&bnljoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_bnljoin_3(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_int intResult, j, l, r, count, lsum, rsum, recsize;
+  scan_t lscan, rscan;
+  bnljoin_t bnljoin;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: Block join shuffled_rel with itself on a < a, with very little "
+       "memory.");
+
+  bnljoin_ut_cmp(&eet, 0, DB_EETNODE_OP_LT, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "shuffled_rel", &mm);
+  init_scan(&rscan, "shuffled_rel", &mm);
+  intResult = init_bnljoin(&bnljoin, &eet, (db_op_base_t *)&lscan,
+                           (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, bnljoin.base.header->tuple_size,
+             bnljoin.base.header->num_attr, &mm);
+
+  /* Leave only enough memory for blocks of at most three tuples, so the right
+     input is read many times over. */
+  recsize =
+      lscan.base.header->tuple_size + (lscan.base.header->num_attr + 7) / 8;
+  void *filler = db_qmm_balloc(
+      &mm, POINTERBYTEDIST(mm.last_back, mm.next_front) - sizeof(db_int) -
+               DB_CTCONF_SETTING_OPERATOR_RESERVE - eet.stack_size -
+               sizeof(db_int) - 3 * recsize);
+  CuAssertTrue(tc, NULL != filler);
+
+  for (j = 0; j < 2; ++j) {
+    count = 0;
+    lsum = 0;
+    rsum = 0;
+    while (1 == (intResult = next((db_op_base_t *)&bnljoin, &t, &mm))) {
+      l = getintbypos(&t, 0, bnljoin.base.header);
+      r = getintbypos(&t, 3, bnljoin.base.header);
+      CuAssertTrue(tc, l < r);
+      count++;
+      lsum += l;
+      rsum += r;
+    }
+    printf("Joined %d tuples in blocks of %d.\n", count,
+           (int)bnljoin.capacity);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 0 < bnljoin.capacity && bnljoin.capacity <= 3);
+    CuAssertTrue(tc, 188 == count);
+    CuAssertTrue(tc, 1210 == lsum);
+    CuAssertTrue(tc, 2581 == rsum);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&bnljoin, &mm));
+  }
+
+  close((db_op_base_t *)&bnljoin, &mm);
+  db_qmm_bfree(&mm, filler);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_bnljoin_4(CuTest *tc) {
+  char command[] = "SELECT * FROM fruit_stock_2, shuffled_rel WHERE "
+                   "fruit_stock_2.qty < shuffled_rel.a AND "
+                   "fruit_stock_2.__delete = 0 AND shuffled_rel.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: The parser falls back on a block join.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc, 0 == strcmp("+BNLJOIN\n++SCAN\n++SCAN\n", output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc, getintbypos(&t, 2, rootp->header) <
+                         getintbypos(&t, 5, rootp->header));
+    count++;
+  }
+  printf("Joined %d tuples.\n", count);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 10 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_bnljoin_5(CuTest *tc) {
+  char command[] = "SELECT shuffled_rel.a, fruit_stock_2.qty FROM "
+                   "fruit_stock_2, shuffled_rel WHERE "
+                   "fruit_stock_2.qty < shuffled_rel.a AND "
+                   "fruit_stock_2.__delete = 0 AND shuffled_rel.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 5: Attributes can be projected out of a block join.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc,
+               0 == strcmp("+PROJECT\n++BNLJOIN\n+++SCAN\n+++SCAN\n", output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc, getintbypos(&t, 1, rootp->header) <
+                         getintbypos(&t, 0, rootp->header));
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 10 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+CuSuite *DBBNLJoinGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_bnljoin_1);
+  SUITE_ADD_TEST(suite, test_bnljoin_2);
+  SUITE_ADD_TEST(suite, test_bnljoin_3);
+  SUITE_ADD_TEST(suite, test_bnljoin_4);
+  SUITE_ADD_TEST(suite, test_bnljoin_5);
+
+  return suite;
+}
+
+void runAllTests_bnljoin() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBBNLJoinGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
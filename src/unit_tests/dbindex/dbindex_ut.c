@@ -0,0 +1,1255 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dbindex/dbindex.h"
+#include "../../dbops/osijoin.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Open a cursor over an index for some range of keys. */
+static db_int dbindex_ut_opencursor(db_index_cursor_t *cp, char *name,
+                                    db_int low, db_int high,
+                                    db_query_mm_t *mmp) {
+  db_index_t index;
+  if (1 != init_index(&index, name))
+    return 0;
+  cp->indexref = index.indexref;
+  cp->type = index.type;
+  cp->indexon = 0;
+  db_index_intkey(&(cp->low), low);
+  db_index_intkey(&(cp->high), high);
+  return db_index_seekcursor(cp, mmp);
+}
+
+/* Add an entry with an integer key to an index. */
+static db_int dbindex_ut_insert(db_index_t *indexp, db_int key,
+                                db_index_offset_t offset,
+                                db_query_mm_t *mmp) {
+  db_index_key_t indexkey;
+  db_index_intkey(&indexkey, key);
+  return db_index_insert(indexp, indexkey.bytes, offset, mmp);
+}
+
+/* Make a scan follow an index on an integer for some range of keys. */
+static db_int dbindex_ut_findrange(scan_t *sp, db_uint8 indexon, db_int low,
+                                   db_int high, db_query_mm_t *mmp) {
+  db_index_key_t lowkey, highkey;
+  db_index_intkey(&lowkey, low);
+  db_index_intkey(&highkey, high);
+  return scan_findrange(sp, indexon, &lowkey, &highkey, mmp);
+}
+
+/* Write index metadata for a relation with one index on its first
+   attribute. */
+static void dbindex_ut_writemeta(char *relationname, char *indexname) {
+  char metaname[9 + strlen(relationname)];
+  db_fileref_t f;
+  db_eet_t eet;
+  db_eetnode_attr_t attr;
+  db_uint8 byte;
+
+  sprintf(metaname, "DB_IDXM_%s", relationname);
+  f = db_openwritefile(metaname);
+  byte = 1;
+  db_filewrite(f, &byte, 1);
+  byte = (db_uint8)(strlen(indexname) + 1);
+  db_filewrite(f, &byte, 1);
+  db_filewrite(f, indexname, byte);
+  byte = 1;
+  db_filewrite(f, &byte, 1);
+  eet.size = sizeof(db_eetnode_attr_t);
+  eet.stack_size = sizeof(db_eetnode_dbint_t);
+  db_filewrite(f, &eet, sizeof(db_eet_t));
+  attr.base.type = DB_EETNODE_ATTR;
+  attr.pos = 0;
+  attr.tuple_pos = 0;
+  db_filewrite(f, &attr, sizeof(db_eetnode_attr_t));
+  byte = 0;
+  db_filewrite(f, &byte, 1);
+  db_fileclose(f);
+}
+
+/* Add keys to an index out of order and read them back. */
+static void dbindex_ut_checkorder(CuTest *tc, char *name, db_uint8 type) {
+  db_query_mm_t mm;
+  char segment[2000];
+  char realname[8 + strlen(name)];
+  db_index_t index;
+  db_index_cursor_t cursor;
+  db_index_offset_t offset;
+  db_int i, count, last;
+
+  init_query_mm(&mm, segment, 2000);
+  CuAssertTrue(tc, 1 == db_index_create(name, type, sizeof(db_int), 0));
+  CuAssertTrue(tc, 1 == init_index_forupdate(&index, name));
+  CuAssertTrue(tc, type == index.type);
+
+  /* Every key from 0 to 499 is added four times, out of order.  The offset
+     remembers which insert it was. */
+  for (i = 0; i < 2000; ++i)
+    CuAssertTrue(tc,
+                 1 == dbindex_ut_insert(&index, (i * 7919) % 500, i, &mm));
+  close_index(&index);
+
+  /* Everything. */
+  CuAssertTrue(tc, 1 == dbindex_ut_opencursor(&cursor, name,
+                                              DB_INT_MIN, DB_INT_MAX, &mm));
+  count = 0;
+  last = -1;
+  while (1 == db_index_nextoffset(&cursor, &offset)) {
+    CuAssertTrue(tc, (offset * 7919) % 500 >= last);
+    last = (offset * 7919) % 500;
+    count++;
+  }
+  CuAssertTrue(tc, 2000 == count);
+  CuAssertTrue(tc, 499 == last);
+  db_index_closecursor(&cursor);
+
+  /* Equality. */
+  CuAssertTrue(tc,
+               1 == dbindex_ut_opencursor(&cursor, name, 42, 42, &mm));
+  count = 0;
+  while (1 == db_index_nextoffset(&cursor, &offset)) {
+    CuAssertTrue(tc, 42 == (offset * 7919) % 500);
+    count++;
+  }
+  CuAssertTrue(tc, 4 == count);
+  db_index_closecursor(&cursor);
+
+  /* A range. */
+  CuAssertTrue(tc, 1 == dbindex_ut_opencursor(&cursor, name, 100,
+                                              149, &mm));
+  count = 0;
+  while (1 == db_index_nextoffset(&cursor, &offset)) {
+    CuAssertTrue(tc, (offset * 7919) % 500 >= 100);
+    CuAssertTrue(tc, (offset * 7919) % 500 <= 149);
+    count++;
+  }
+  CuAssertTrue(tc, 200 == count);
+  db_index_closecursor(&cursor);
+
+  /* Nothing. */
+  CuAssertTrue(tc, 1 == dbindex_ut_opencursor(&cursor, name, 500,
+                                              DB_INT_MAX, &mm));
+  CuAssertTrue(tc, 0 == db_index_nextoffset(&cursor, &offset));
+  db_index_closecursor(&cursor);
+
+  CuAssertTrue(tc, mm.last_back == mm.segment + mm.size);
+  sprintf(realname, "DB_IDX_%s", name);
+  db_fileremove(realname);
+}
+
+void test_dbindex_1(CuTest *tc) {
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: B+tree entries come back in key order after random inserts.");
+  dbindex_ut_checkorder(tc, "dbindex_ut_1", DB_INDEX_TYPE_BTREE);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_2(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[2000];
+  char command[100];
+  db_index_t index;
+  scan_t s;
+  db_tuple_t t;
+  db_int i, count, recordsize;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Scans follow a B+tree index over an unsorted relation.");
+
+  init_query_mm(&mm, segment, 2000);
+  db_fileremove("dbindex_ut_2");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_2 (a INT, b INT);", &mm));
+  for (i = 0; i < 50; ++i) {
+    init_query_mm(&mm, segment, 2000);
+    sprintf(command, "INSERT INTO dbindex_ut_2 VALUES (%d, %d);",
+            (i * 37) % 25, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  /* Index a. */
+  dbindex_ut_writemeta("dbindex_ut_2", "dbindex_ut_2");
+
+  init_query_mm(&mm, segment, 2000);
+  CuAssertTrue(tc, 1 == db_index_create("dbindex_ut_2", DB_INDEX_TYPE_BTREE,
+                                        sizeof(db_int), 0));
+  CuAssertTrue(tc, 1 == init_index_forupdate(&index, "dbindex_ut_2"));
+  CuAssertTrue(tc, 1 == init_scan(&s, "dbindex_ut_2", &mm));
+  init_tuple(&t, s.base.header->tuple_size, s.base.header->num_attr, &mm);
+  recordsize = (db_int)s.base.header->tuple_size + s.base.header->num_attr / 8;
+  if (s.base.header->num_attr % 8 > 0)
+    recordsize++;
+  i = 0;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, 1 == dbindex_ut_insert(&index,
+                                            getintbypos(&t, 0, s.base.header),
+                                            s.tuple_start + i * recordsize,
+                                            &mm));
+    i++;
+  }
+  CuAssertTrue(tc, 50 == i);
+  close_index(&index);
+
+  /* A range. */
+  CuAssertTrue(tc, 1 == dbindex_ut_findrange(&s, 0, 5, 9, &mm));
+  count = 0;
+  i = 5;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, getintbypos(&t, 0, s.base.header) >= i);
+    i = getintbypos(&t, 0, s.base.header);
+    CuAssertTrue(tc, 9 >= i);
+    CuAssertTrue(tc, i == (getintbypos(&t, 1, s.base.header) * 37) % 25);
+    count++;
+  }
+  CuAssertTrue(tc, 10 == count);
+
+  /* Rewinding starts the range over. */
+  rewind_scan(&s, &mm);
+  count = 0;
+  while (1 == next_scan(&s, &t, &mm))
+    count++;
+  CuAssertTrue(tc, 10 == count);
+
+  /* Equality, as joins look tuples up. */
+  CuAssertTrue(tc, 1 == scan_find(&s, 0, (db_eet_t *)0, (db_tuple_t *)17, NULL,
+                                  &mm));
+  count = 0;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, 17 == getintbypos(&t, 0, s.base.header));
+    count++;
+  }
+  CuAssertTrue(tc, 2 == count);
+  CuAssertTrue(tc, -1 != db_index_getoffset(&s, 0, (db_eet_t *)0,
+                                            (db_tuple_t *)17, NULL, &mm));
+  CuAssertTrue(tc, -1 == db_index_getoffset(&s, 0, (db_eet_t *)0,
+                                            (db_tuple_t *)25, NULL, &mm));
+
+  close_tuple(&t, &mm);
+  close_scan(&s, &mm);
+  db_fileremove("DB_IDX_dbindex_ut_2");
+  db_fileremove("DB_IDXM_dbindex_ut_2");
+  db_fileremove("dbindex_ut_2");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_3(CuTest *tc) {
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: Skip list entries come back in key order after random "
+       "inserts.");
+  dbindex_ut_checkorder(tc, "dbindex_ut_3", DB_INDEX_TYPE_SKIPLIST);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_4(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[2000];
+  char command[100];
+  db_fileref_t f;
+  scan_t s;
+  db_tuple_t t;
+  db_int i, count, recordsize;
+  long size;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: Inserted tuples are added to a skip list index.");
+
+  init_query_mm(&mm, segment, 2000);
+  db_fileremove("dbindex_ut_4");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_4 (a INT, b INT);", &mm));
+  dbindex_ut_writemeta("dbindex_ut_4", "dbindex_ut_4");
+  CuAssertTrue(tc,
+               1 == db_index_create("dbindex_ut_4", DB_INDEX_TYPE_SKIPLIST,
+                                    sizeof(db_int), 0));
+
+  for (i = 0; i < 50; ++i) {
+    init_query_mm(&mm, segment, 2000);
+    sprintf(command, "INSERT INTO dbindex_ut_4 VALUES (%d, %d);",
+            (i * 37) % 25, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  init_query_mm(&mm, segment, 2000);
+  CuAssertTrue(tc, 1 == init_scan(&s, "dbindex_ut_4", &mm));
+  init_tuple(&t, s.base.header->tuple_size, s.base.header->num_attr, &mm);
+
+  /* The relation is only ever appended to. */
+  recordsize = (db_int)s.base.header->tuple_size + s.base.header->num_attr / 8;
+  if (s.base.header->num_attr % 8 > 0)
+    recordsize++;
+  f = db_openreadfile("dbindex_ut_4");
+  size = db_filesize(f);
+  db_fileclose(f);
+  CuAssertTrue(tc, s.tuple_start + 50 * recordsize == size);
+  i = 0;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, i == getintbypos(&t, 1, s.base.header));
+    i++;
+  }
+  CuAssertTrue(tc, 50 == i);
+
+  /* Everything, in order. */
+  CuAssertTrue(tc,
+               1 == dbindex_ut_findrange(&s, 0, DB_INT_MIN, DB_INT_MAX, &mm));
+  count = 0;
+  i = 0;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, getintbypos(&t, 0, s.base.header) >= i);
+    i = getintbypos(&t, 0, s.base.header);
+    CuAssertTrue(tc, i == (getintbypos(&t, 1, s.base.header) * 37) % 25);
+    count++;
+  }
+  CuAssertTrue(tc, 50 == count);
+
+  /* Equality. */
+  CuAssertTrue(tc, 1 == scan_find(&s, 0, (db_eet_t *)0, (db_tuple_t *)3, NULL,
+                                  &mm));
+  count = 0;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, 3 == getintbypos(&t, 0, s.base.header));
+    count++;
+  }
+  CuAssertTrue(tc, 2 == count);
+
+  close_tuple(&t, &mm);
+  close_scan(&s, &mm);
+  db_fileremove("DB_IDX_dbindex_ut_4");
+  db_fileremove("DB_IDXM_dbindex_ut_4");
+  db_fileremove("dbindex_ut_4");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_5(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[2000];
+  db_index_t index;
+  db_index_cursor_t cursor;
+  db_index_offset_t offset;
+  db_int i, key, count;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 5: Hash index probes find every entry with a key.");
+
+  init_query_mm(&mm, segment, 2000);
+  CuAssertTrue(tc, 1 == db_index_create("dbindex_ut_5", DB_INDEX_TYPE_HASH,
+                                        sizeof(db_int), 0));
+  CuAssertTrue(tc, 1 == init_index_forupdate(&index, "dbindex_ut_5"));
+  CuAssertTrue(tc, DB_INDEX_TYPE_HASH == index.type);
+  for (i = 0; i < 2000; ++i)
+    CuAssertTrue(tc,
+                 1 == dbindex_ut_insert(&index, (i * 7919) % 500, i, &mm));
+  close_index(&index);
+
+  for (key = -1; key <= 500; ++key) {
+    CuAssertTrue(tc, 1 == dbindex_ut_opencursor(&cursor, "dbindex_ut_5", key,
+                                                key, &mm));
+    count = 0;
+    while (1 == db_index_nextoffset(&cursor, &offset)) {
+      CuAssertTrue(tc, key == (offset * 7919) % 500);
+      count++;
+    }
+    CuAssertTrue(tc, (key < 0 || key == 500 ? 0 : 4) == count);
+    db_index_closecursor(&cursor);
+  }
+
+  CuAssertTrue(tc, mm.last_back == mm.segment + mm.size);
+  db_fileremove("DB_IDX_dbindex_ut_5");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_6(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  db_eet_t eet;
+  db_eetnode_attr_t nodes[3];
+  scan_t lscan, rscan;
+  osijoin_t osijoin;
+  db_tuple_t t;
+  db_int i, count;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 6: Indexed joins probe a hash index.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_6");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_6 (a INT, b INT);", &mm));
+  dbindex_ut_writemeta("dbindex_ut_6", "dbindex_ut_6");
+  CuAssertTrue(tc, 1 == db_index_create("dbindex_ut_6", DB_INDEX_TYPE_HASH,
+                                        sizeof(db_int), 0));
+  for (i = 0; i < 50; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_6 VALUES (%d, %d);",
+            (i * 37) % 25, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  /* a = a, which every key matches twice on each side. */
+  nodes[0].base.type = DB_EETNODE_ATTR;
+  nodes[0].pos = 0;
+  nodes[0].tuple_pos = 0;
+  nodes[1] = nodes[0];
+  nodes[1].tuple_pos = 1;
+  eet.nodes = (db_eetnode_t *)nodes;
+  eet.size = 2 * sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t);
+  eet.stack_size = eet.size;
+  ((db_eetnode_t *)(nodes + 2))->type = DB_EETNODE_OP_EQ;
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 1 == init_scan(&lscan, "dbindex_ut_6", &mm));
+  CuAssertTrue(tc, 1 == init_scan(&rscan, "dbindex_ut_6", &mm));
+  CuAssertTrue(tc, 1 == init_osijoin(&osijoin, &eet, (db_op_base_t *)&lscan,
+                                     (db_op_base_t *)&rscan, &mm));
+  CuAssertTrue(tc, DB_OSIJOIN == osijoin.base.type);
+  init_tuple(&t, osijoin.base.header->tuple_size, osijoin.base.header->num_attr,
+             &mm);
+
+  count = 0;
+  while (1 == next_osijoin(&osijoin, &t, &mm)) {
+    CuAssertTrue(tc, getintbypos(&t, 0, osijoin.base.header) ==
+                         getintbypos(&t, lscan.base.header->num_attr,
+                                     osijoin.base.header));
+    count++;
+  }
+  CuAssertTrue(tc, 100 == count);
+
+  close_tuple(&t, &mm);
+  close_osijoin(&osijoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  db_fileremove("DB_IDX_dbindex_ut_6");
+  db_fileremove("DB_IDXM_dbindex_ut_6");
+  db_fileremove("dbindex_ut_6");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_7(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  scan_t s;
+  db_tuple_t t;
+  db_int i, count;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 7: CREATE INDEX builds indexes that scans use, and DROP INDEX "
+       "removes them.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_7");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_7 (a INT, b INT);", &mm));
+  for (i = 0; i < 50; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_7 VALUES (%d, %d);",
+            (i * 37) % 25, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_7a ON dbindex_ut_7 (a);",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_7b ON dbindex_ut_7 "
+                             "(b * 2) USING HASH;",
+                             &mm));
+  CuAssertTrue(tc, db_fileexists("DB_IDX_dbindex_ut_7a"));
+  CuAssertTrue(tc, db_fileexists("DB_IDX_dbindex_ut_7b"));
+
+  /* Names are unique, only inline indexes have several keys, and only
+     integers are keys. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_7a ON dbindex_ut_7 "
+                                 "(b);",
+                                 &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_7c ON dbindex_ut_7 "
+                                 "(a, b) USING HASH;",
+                                 &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_7c ON dbindex_ut_7 "
+                                 "(c);",
+                                 &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_7c"));
+
+  /* Later inserts are added to both. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("INSERT INTO dbindex_ut_7 VALUES (7, 50);", &mm));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 1 == init_scan(&s, "dbindex_ut_7", &mm));
+  CuAssertTrue(tc, 2 == s.idx_meta_data.num_idx);
+  init_tuple(&t, s.base.header->tuple_size, s.base.header->num_attr, &mm);
+
+  CuAssertTrue(tc, 1 == dbindex_ut_findrange(&s, 0, 5, 9, &mm));
+  count = 0;
+  i = 5;
+  while (1 == next_scan(&s, &t, &mm)) {
+    CuAssertTrue(tc, getintbypos(&t, 0, s.base.header) >= i);
+    i = getintbypos(&t, 0, s.base.header);
+    CuAssertTrue(tc, 9 >= i);
+    count++;
+  }
+  CuAssertTrue(tc, 11 == count);
+
+  for (i = 0; i <= 50; ++i) {
+    CuAssertTrue(tc, 1 == scan_find(&s, 1, (db_eet_t *)0,
+                                    (db_tuple_t *)(long)(2 * i), NULL, &mm));
+    CuAssertTrue(tc, 1 == next_scan(&s, &t, &mm));
+    CuAssertTrue(tc, i == getintbypos(&t, 1, s.base.header));
+    CuAssertTrue(tc, 0 == next_scan(&s, &t, &mm));
+  }
+
+  close_tuple(&t, &mm);
+  close_scan(&s, &mm);
+
+  /* Dropping both leaves no index files behind. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_7a ON dbindex_ut_7;", &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_7a"));
+  CuAssertTrue(tc, db_fileexists("DB_IDXM_dbindex_ut_7"));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 1 == init_scan(&s, "dbindex_ut_7", &mm));
+  CuAssertTrue(tc, 1 == s.idx_meta_data.num_idx);
+  CuAssertTrue(tc, 0 == strcmp("dbindex_ut_7b", s.idx_meta_data.names[0]));
+  close_scan(&s, &mm);
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("DROP INDEX dbindex_ut_7a ON dbindex_ut_7;",
+                                 &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_7b ON dbindex_ut_7;", &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_7b"));
+  CuAssertTrue(tc, !db_fileexists("DB_IDXM_dbindex_ut_7"));
+
+  db_fileremove("dbindex_ut_7");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_8(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  scan_t s;
+  db_tuple_t t;
+  db_int i, count;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 8: Inline indexes are only created over relations in order.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_8");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_8 (a INT, b INT);", &mm));
+  for (i = 0; i < 50; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_8 VALUES (%d, %d);", i / 2,
+            49 - i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_8 ON dbindex_ut_8 "
+                                 "(b) USING INLINE;",
+                                 &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_8"));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_8 ON dbindex_ut_8 "
+                                 "(a, b) USING INLINE;",
+                                 &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_8 ON dbindex_ut_8 "
+                             "(a, 0 - b) USING INLINE;",
+                             &mm));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 1 == init_scan(&s, "dbindex_ut_8", &mm));
+  init_tuple(&t, s.base.header->tuple_size, s.base.header->num_attr, &mm);
+  CuAssertTrue(tc, 1 == scan_find(&s, 0, (db_eet_t *)0, (db_tuple_t *)17, NULL,
+                                  &mm));
+  count = 0;
+  while (1 == next_scan(&s, &t, &mm) &&
+         17 == getintbypos(&t, 0, s.base.header))
+    count++;
+  CuAssertTrue(tc, 2 == count);
+  close_tuple(&t, &mm);
+  close_scan(&s, &mm);
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_8 ON dbindex_ut_8;", &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_8"));
+  db_fileremove("dbindex_ut_8");
+  puts("***********************************************************************"
+       "*********");
+}
+
+/* Count the tuples a scan finds through an index for some range of keys,
+   checking each key is in the range. */
+static db_int dbindex_ut_countrange(CuTest *tc, char *relationname,
+                                    db_uint8 indexon, db_int pos, db_int low,
+                                    db_int high, db_query_mm_t *mmp) {
+  scan_t s;
+  db_tuple_t t;
+  db_int key, count = 0;
+
+  CuAssertTrue(tc, 1 == init_scan(&s, relationname, mmp));
+  init_tuple(&t, s.base.header->tuple_size, s.base.header->num_attr, mmp);
+  CuAssertTrue(tc, 1 == dbindex_ut_findrange(&s, indexon, low, high, mmp));
+  while (1 == next_scan(&s, &t, mmp)) {
+    key = getintbypos(&t, pos, s.base.header);
+    CuAssertTrue(tc, key >= low && key <= high);
+    count++;
+  }
+  close_tuple(&t, mmp);
+  close_scan(&s, mmp);
+  return count;
+}
+
+void test_dbindex_9(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  db_fileref_t f;
+  db_uint8 type;
+  long count;
+  db_int i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 9: INSERT and UPDATE keep every index up to date.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_9");
+  db_fileremove("DB_IDXM_dbindex_ut_9");
+  for (i = 0; i < 4; ++i) {
+    sprintf(command, "DB_IDX_dbindex_ut_9%c", "bsha"[i]);
+    db_fileremove(command);
+  }
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_9 (a INT, b INT);", &mm));
+  for (i = 0; i < 40; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_9 VALUES (%d, %d);", i, i % 10);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_9b ON dbindex_ut_9 (b);",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_9s ON dbindex_ut_9 (b) "
+                             "USING SKIPLIST;",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_9h ON dbindex_ut_9 (b) "
+                             "USING HASH;",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_9a ON dbindex_ut_9 (a) "
+                             "USING INLINE;",
+                             &mm));
+
+  /* More records match than are kept in memory at once. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("UPDATE TABLE dbindex_ut_9 SET b = 50 WHERE b < 5;",
+                             &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_UPDATE_dbindex_ut_9"));
+  for (i = 0; i < 3; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 0 == dbindex_ut_countrange(tc, "dbindex_ut_9", i, 1, 3,
+                                                3, &mm));
+    CuAssertTrue(tc, 20 == dbindex_ut_countrange(tc, "dbindex_ut_9", i, 1, 50,
+                                                 50, &mm));
+    CuAssertTrue(tc, 4 == dbindex_ut_countrange(tc, "dbindex_ut_9", i, 1, 7,
+                                                7, &mm));
+  }
+  for (i = 0; i < 2; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 40 == dbindex_ut_countrange(tc, "dbindex_ut_9", i, 1,
+                                                 -100, 100, &mm));
+  }
+
+  /* An insert in order extends the inline index. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("INSERT INTO dbindex_ut_9 VALUES (40, 7);", &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 5 == dbindex_ut_countrange(tc, "dbindex_ut_9", 2, 1, 7, 7,
+                                              &mm));
+  f = db_openreadfile("DB_IDX_dbindex_ut_9a");
+  CuAssertTrue(tc, 1 == db_fileread(f, &type, 1));
+  CuAssertTrue(tc, sizeof(long) ==
+                       db_fileread(f, (unsigned char *)&count, sizeof(long)));
+  db_fileclose(f);
+  CuAssertTrue(tc, DB_INDEX_TYPE_INLINE == type);
+  CuAssertTrue(tc, 41 == count);
+
+  /* Once the relation is out of order, the inline index becomes a B+tree. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("UPDATE TABLE dbindex_ut_9 SET a = 5 WHERE a = 30;",
+                             &mm));
+  f = db_openreadfile("DB_IDX_dbindex_ut_9a");
+  CuAssertTrue(tc, 1 == db_fileread(f, &type, 1));
+  db_fileclose(f);
+  CuAssertTrue(tc, DB_INDEX_TYPE_BTREE == type);
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 2 == dbindex_ut_countrange(tc, "dbindex_ut_9", 3, 0, 5, 5,
+                                              &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 0 == dbindex_ut_countrange(tc, "dbindex_ut_9", 3, 0, 30,
+                                              30, &mm));
+
+  for (i = 0; i < 4; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "DROP INDEX dbindex_ut_9%c ON dbindex_ut_9;", "bsha"[i]);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+  db_fileremove("dbindex_ut_9");
+  puts("***********************************************************************"
+       "*********");
+}
+
+/* Count the tuples a query finds, checking how its scan was setup.  The scan
+   should follow an index if follows is 1, and stop before the end of the
+   relation if stops is 1. */
+static db_int dbindex_ut_countquery(CuTest *tc, char *command, db_uint8 follows,
+                                    db_uint8 stops, db_query_mm_t *mmp) {
+  db_op_base_t *rootp = parse(command, mmp);
+  db_op_base_t *op = rootp;
+  db_tuple_t t;
+  db_int count = 0;
+
+  CuAssertTrue(tc, NULL != rootp);
+  while (DB_SCAN != op->type) {
+    CuAssertTrue(tc, 1 == numopchildren(op));
+    op = ((db_op_onechild_t *)op)->child;
+  }
+  CuAssertTrue(tc, follows ==
+                       (DB_STORAGE_NOFILE != ((scan_t *)op)->cursor.indexref));
+  CuAssertTrue(tc, stops == (-1 != ((scan_t *)op)->tuple_end));
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, mmp);
+  while (1 == next(rootp, &t, mmp))
+    count++;
+  close_tuple(&t, mmp);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, mmp));
+  return count;
+}
+
+void test_dbindex_10(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  db_int i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 10: Selections combine their bounds to scan through an index.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_10");
+  db_fileremove("DB_IDXM_dbindex_ut_10");
+  db_fileremove("DB_IDX_dbindex_ut_10a");
+  db_fileremove("DB_IDX_dbindex_ut_10b");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_10 (a INT, b INT, c INT);",
+                             &mm));
+  for (i = 0; i < 40; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_10 VALUES (%d, %d, %d);", i,
+            i % 10, i % 2);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_10a ON dbindex_ut_10 (a) "
+                             "USING INLINE;",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_10b ON dbindex_ut_10 (b);",
+                             &mm));
+
+  /* Both bounds go to the B+tree, whichever side the constant is on. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 12 == dbindex_ut_countquery(
+                             tc,
+                             "SELECT * FROM dbindex_ut_10 WHERE b >= 3 AND "
+                             "6 > b;",
+                             1, 0, &mm));
+
+  /* What the index can not check is left for the selection. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 8 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_10 WHERE c = 1 AND b > 2 "
+                            "AND b <= 5;",
+                            1, 0, &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 0 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_10 WHERE b > 5 AND "
+                            "b < 3;",
+                            1, 0, &mm));
+
+  /* An equality beats a range. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 2 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_10 WHERE a < 20 AND "
+                            "b = 3;",
+                            1, 0, &mm));
+
+  /* The inline index reads only from the first tuple in range to the last. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 10 == dbindex_ut_countquery(
+                             tc,
+                             "SELECT * FROM dbindex_ut_10 WHERE a > 10 AND "
+                             "a <= 20;",
+                             0, 1, &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 5 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_10 WHERE 35 <= a;", 0,
+                            0, &mm));
+
+  /* Bounds that need not hold can not be used. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 36 == dbindex_ut_countquery(
+                             tc,
+                             "SELECT * FROM dbindex_ut_10 WHERE a >= 5 OR "
+                             "b = 1;",
+                             0, 0, &mm));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_10a ON dbindex_ut_10;",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_10b ON dbindex_ut_10;",
+                             &mm));
+  db_fileremove("dbindex_ut_10");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_11(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  db_op_base_t *rootp, *op;
+  db_tuple_t t;
+  db_int i, count;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 11: A key of many attributes is searched on a prefix and a range.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_11");
+  db_fileremove("DB_IDXM_dbindex_ut_11");
+  db_fileremove("DB_IDX_dbindex_ut_11");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_11 (d INT, ts INT, v "
+                             "INT);",
+                             &mm));
+  for (i = 0; i < 40; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_11 VALUES (%d, %d, %d);", i / 10,
+            i % 10, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_11 ON dbindex_ut_11 "
+                             "(d, ts) USING INLINE;",
+                             &mm));
+
+  /* The scan reads only one device's readings over the range. */
+  init_query_mm(&mm, segment, 3000);
+  rootp = parse("SELECT * FROM dbindex_ut_11 WHERE ts < 7 AND d = 2 AND "
+                "ts >= 3;",
+                &mm);
+  CuAssertTrue(tc, NULL != rootp);
+  for (op = rootp; DB_SCAN != op->type; op = ((db_op_onechild_t *)op)->child)
+    ;
+  init_tuple(&t, op->header->tuple_size, op->header->num_attr, &mm);
+  count = 0;
+  while (1 == next(op, &t, &mm)) {
+    CuAssertTrue(tc, 2 == getintbypos(&t, 0, op->header));
+    CuAssertTrue(tc, 3 + count == getintbypos(&t, 1, op->header));
+    count++;
+  }
+  CuAssertTrue(tc, 4 == count);
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+
+  /* A prefix alone, the whole key, and a range on the first attribute. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 10 == dbindex_ut_countquery(
+                             tc, "SELECT * FROM dbindex_ut_11 WHERE d = 1;", 0,
+                             1, &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 1 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_11 WHERE d = 3 AND "
+                            "ts = 5;",
+                            0, 1, &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 2 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_11 WHERE d >= 1 AND "
+                            "d <= 2 AND ts = 0;",
+                            0, 1, &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 0 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_11 WHERE d = 4 AND "
+                            "ts > 2;",
+                            0, 1, &mm));
+
+  /* Without the first attribute, the key is of no use. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 4 == dbindex_ut_countquery(
+                            tc, "SELECT * FROM dbindex_ut_11 WHERE ts = 5;", 0,
+                            0, &mm));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_11 ON dbindex_ut_11;",
+                             &mm));
+  db_fileremove("dbindex_ut_11");
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbindex_12(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  char *types[] = {"BTREE", "SKIPLIST", "HASH"};
+  db_int i, j;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 12: Every index type can be searched on a string.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_12");
+  db_fileremove("DB_IDXM_dbindex_ut_12");
+  db_fileremove("DB_IDX_dbindex_ut_12");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_12 (name STRING(8), v "
+                             "INT, note STRING(40));",
+                             &mm));
+  for (i = 0; i < 30; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_12 VALUES ('pump%d', %d, 'x');",
+            i % 10, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  /* Keys wider than an index allows, and strings that are not attributes,
+     are turned away. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_12 ON dbindex_ut_12 "
+                                 "(note);",
+                                 &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_12"));
+
+  for (j = 0; j < 3; ++j) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command,
+            "CREATE INDEX dbindex_ut_12 ON dbindex_ut_12 (name) USING %s;",
+            types[j]);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 3 == dbindex_ut_countquery(
+                              tc,
+                              "SELECT * FROM dbindex_ut_12 WHERE name = "
+                              "'pump7';",
+                              1, 0, &mm));
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 2 == dbindex_ut_countquery(
+                              tc,
+                              "SELECT * FROM dbindex_ut_12 WHERE v > 10 AND "
+                              "'pump7' = name;",
+                              1, 0, &mm));
+
+    /* No stored name can be this long, or two names at once. */
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 0 == dbindex_ut_countquery(
+                              tc,
+                              "SELECT * FROM dbindex_ut_12 WHERE name = "
+                              "'pumpstation7';",
+                              0, 0, &mm));
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 0 == dbindex_ut_countquery(
+                              tc,
+                              "SELECT * FROM dbindex_ut_12 WHERE name = "
+                              "'pump7' AND name = 'pump8';",
+                              0, 0, &mm));
+
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                         parse("DROP INDEX dbindex_ut_12 ON dbindex_ut_12;",
+                               &mm));
+  }
+
+  /* New tuples are added to the index as they are inserted. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_12 ON dbindex_ut_12 "
+                             "(name);",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("INSERT INTO dbindex_ut_12 VALUES ('pump7', 30, "
+                             "'y');",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 4 == dbindex_ut_countquery(
+                            tc,
+                            "SELECT * FROM dbindex_ut_12 WHERE name = 'pump7';",
+                            1, 0, &mm));
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_12 ON dbindex_ut_12;",
+                             &mm));
+  db_fileremove("dbindex_ut_12");
+  puts("***********************************************************************"
+       "*********");
+}
+
+/* Run a query over a relation with an index on ts storing v, where each v is
+   three times its ts, and count its tuples. */
+static db_int dbindex_ut_coveredquery(CuTest *tc, char *command,
+                                      db_uint8 indexonly, db_int *sump,
+                                      db_query_mm_t *mmp) {
+  db_op_base_t *rootp = parse(command, mmp);
+  db_op_base_t *op = rootp;
+  db_tuple_t t;
+  db_int count = 0;
+
+  CuAssertTrue(tc, NULL != rootp);
+  while (DB_SCAN != op->type)
+    op = ((db_op_onechild_t *)op)->child;
+  CuAssertTrue(tc, DB_STORAGE_NOFILE != ((scan_t *)op)->cursor.indexref);
+  CuAssertTrue(tc, indexonly == ((scan_t *)op)->indexonly);
+
+  *sump = 0;
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, mmp);
+  while (1 == next(rootp, &t, mmp)) {
+    if (indexonly)
+      *sump += getintbypos(&t, 0, rootp->header);
+    count++;
+  }
+  close_tuple(&t, mmp);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, mmp));
+  return count;
+}
+
+void test_dbindex_13(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[3000];
+  char command[100];
+  char *types[] = {"BTREE", "SKIPLIST", "HASH"};
+  db_int i, j, sum;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 13: Indexes storing attributes answer queries on their own.");
+
+  init_query_mm(&mm, segment, 3000);
+  db_fileremove("dbindex_ut_13");
+  db_fileremove("DB_IDXM_dbindex_ut_13");
+  db_fileremove("DB_IDX_dbindex_ut_13");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE dbindex_ut_13 (ts INT, v INT, note "
+                             "STRING(40));",
+                             &mm));
+  for (i = 0; i < 40; ++i) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command, "INSERT INTO dbindex_ut_13 VALUES (%d, %d, 'n%d');", i,
+            3 * i, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+
+  /* Only attributes of the table can be stored, and not in inline
+     indexes. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_13 ON dbindex_ut_13 "
+                                 "(ts) INCLUDE (v, w);",
+                                 &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, NULL == parse("CREATE INDEX dbindex_ut_13 ON dbindex_ut_13 "
+                                 "(ts) INCLUDE (v) USING INLINE;",
+                                 &mm));
+  CuAssertTrue(tc, !db_fileexists("DB_IDX_dbindex_ut_13"));
+
+  for (j = 0; j < 3; ++j) {
+    init_query_mm(&mm, segment, 3000);
+    sprintf(command,
+            "CREATE INDEX dbindex_ut_13 ON dbindex_ut_13 (ts) INCLUDE (v) "
+            "USING %s;",
+            types[j]);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+
+    init_query_mm(&mm, segment, 3000);
+    if (2 == j) {
+      CuAssertTrue(tc, 1 == dbindex_ut_coveredquery(
+                                tc,
+                                "SELECT v, ts FROM dbindex_ut_13 WHERE ts = "
+                                "35;",
+                                1, &sum, &mm));
+      CuAssertTrue(tc, 105 == sum);
+    } else {
+      CuAssertTrue(tc, 5 == dbindex_ut_coveredquery(
+                                tc,
+                                "SELECT v, ts FROM dbindex_ut_13 WHERE ts >= "
+                                "35 AND v > ts;",
+                                1, &sum, &mm));
+      CuAssertTrue(tc, 555 == sum);
+    }
+
+    /* Anything else the query needs is read from the table. */
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 1 == dbindex_ut_coveredquery(
+                              tc,
+                              "SELECT note FROM dbindex_ut_13 WHERE ts = 35;",
+                              0, &sum, &mm));
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, 1 == dbindex_ut_coveredquery(
+                              tc,
+                              "SELECT * FROM dbindex_ut_13 WHERE ts = 35;", 0,
+                              &sum, &mm));
+
+    init_query_mm(&mm, segment, 3000);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                         parse("DROP INDEX dbindex_ut_13 ON dbindex_ut_13;",
+                               &mm));
+  }
+
+  /* Attributes stored with a key are kept up as they change, and deleted
+     tuples are left out. */
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE INDEX dbindex_ut_13 ON dbindex_ut_13 "
+                             "(ts) INCLUDE (v);",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("UPDATE TABLE dbindex_ut_13 SET v = 0 WHERE ts = "
+                             "36;",
+                             &mm));
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 5 == dbindex_ut_coveredquery(
+                            tc,
+                            "SELECT v, ts FROM dbindex_ut_13 WHERE ts >= 35;",
+                            1, &sum, &mm));
+  CuAssertTrue(tc, 447 == sum);
+  init_query_mm(&mm, segment, 3000);
+  parse("DELETE FROM dbindex_ut_13 WHERE ts = 38;", &mm);
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, 4 == dbindex_ut_coveredquery(
+                            tc,
+                            "SELECT v, ts FROM dbindex_ut_13 WHERE ts >= 35;",
+                            1, &sum, &mm));
+  CuAssertTrue(tc, 333 == sum);
+
+  init_query_mm(&mm, segment, 3000);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("DROP INDEX dbindex_ut_13 ON dbindex_ut_13;",
+                             &mm));
+  db_fileremove("dbindex_ut_13");
+  puts("***********************************************************************"
+       "*********");
+}
+
+CuSuite *DBIndexGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_dbindex_1);
+  SUITE_ADD_TEST(suite, test_dbindex_2);
+  SUITE_ADD_TEST(suite, test_dbindex_3);
+  SUITE_ADD_TEST(suite, test_dbindex_4);
+  SUITE_ADD_TEST(suite, test_dbindex_5);
+  SUITE_ADD_TEST(suite, test_dbindex_6);
+  SUITE_ADD_TEST(suite, test_dbindex_7);
+  SUITE_ADD_TEST(suite, test_dbindex_8);
+  SUITE_ADD_TEST(suite, test_dbindex_9);
+  SUITE_ADD_TEST(suite, test_dbindex_10);
+  SUITE_ADD_TEST(suite, test_dbindex_11);
+  SUITE_ADD_TEST(suite, test_dbindex_12);
+  SUITE_ADD_TEST(suite, test_dbindex_13);
+
+  return suite;
+}
+
+void runAllTests_dbindex() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBIndexGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
@@ -3146,6 +3146,105 @@ void testParser_95(CuTest *tc) {
   CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
 }
 
+/* Test folding constants out of a condition. */
+void testParser_96(CuTest *tc) {
+  char command[] = "SELECT * FROM shuffled_rel WHERE a > 2*5 AND 1 = 1;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  db_op_base_t *rootp = parse(command, &mm);
+
+  // Complete the tests.
+  CuAssertTrue(tc, NULL != rootp);
+  char *output;
+  queryTreeToString(rootp, &output);
+  CuAssertTrue(tc, 0 == strcmp("+SELECT\n++SCAN\n", output));
+  puts(output);
+  free(output);
+
+  /* Only a > 10 is left, and the check for deleted tuples. */
+  db_eet_t *eetp = ((select_t *)rootp)->tree;
+  CuAssertTrue(tc, (db_int)(2 * sizeof(db_eetnode_attr_t) +
+                            2 * sizeof(db_eetnode_dbint_t) +
+                            3 * sizeof(db_eetnode_t)) == eetp->size);
+  CuAssertTrue(tc, DB_EETNODE_OP_GT == geteetnodetypebypos(eetp, 2));
+  CuAssertTrue(tc, 10 == ((db_eetnode_dbint_t *)geteetnodebypos(eetp, 1))
+                             ->integer);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc, getintbypos(&t, 0, rootp->header) > 10);
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 10 == count);
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+}
+
+/* Test a condition that folds to false. */
+void testParser_97(CuTest *tc) {
+  char command[] = "SELECT * FROM shuffled_rel WHERE a > 5 AND 1 = 2;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_tuple_t t;
+
+  db_op_base_t *rootp = parse(command, &mm);
+
+  // Complete the tests.
+  CuAssertTrue(tc, NULL != rootp);
+  db_eet_t *eetp = ((select_t *)rootp)->tree;
+  CuAssertTrue(tc, (db_int)sizeof(db_eetnode_dbint_t) == eetp->size);
+  CuAssertTrue(tc, 0 == evaluate_eet_constant(eetp, &mm));
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+}
+
+/* Test formatting a query when the query memory cannot hold its results. */
+void testParser_98(CuTest *tc) {
+  char command[] = "SELECT * FROM fruit_stock_1 WHERE id > 3;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  /* Leave too little memory for even one tuple. */
+  db_int avail = POINTERBYTEDIST(mm.last_back, mm.next_front);
+  void *fillp = db_qmm_falloc(&mm, avail - (db_int)(sizeof(db_int) +
+                                                    sizeof(void *) + 1));
+  CuAssertTrue(tc, NULL != fillp);
+  CuAssertTrue(tc, NULL == formatQuery(rootp, &mm));
+  db_qmm_ffree(&mm, fillp);
+
+  /* With the memory back, the same operators still give every tuple. */
+  char *output = formatQuery(rootp, &mm);
+  char expectedOutput[] =
+      "+-------------+---------------------+-------------+-------------+-------------+\n\
+|          id |                name |         qty |       price |    __delete |\n\
++-------------+---------------------+-------------+-------------+-------------+\n\
+|           4 |               Lemon |          12 |           4 |           0 |\n\
++-------------+---------------------+-------------+-------------+-------------+\n\
+|           5 |                Lime |          10 |           3 |           0 |\n\
++-------------+---------------------+-------------+-------------+-------------+\n";
+
+  CuAssertTrue(tc, NULL != output);
+  CuAssertTrue(tc, 0 == strcmp(expectedOutput, output));
+  free(output);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+}
+
 #if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
     1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
 /* Test lexing a simple statement. */
@@ -3263,6 +3362,9 @@ CuSuite *ParserGetSuite() {
   SUITE_ADD_TEST(suite, testParser_93);
   SUITE_ADD_TEST(suite, testParser_94);
   SUITE_ADD_TEST(suite, testParser_95);
+  SUITE_ADD_TEST(suite, testParser_96);
+  SUITE_ADD_TEST(suite, testParser_97);
+  SUITE_ADD_TEST(suite, testParser_98);
 #if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
     1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
   SUITE_ADD_TEST(suite, testParser_createTable_1);
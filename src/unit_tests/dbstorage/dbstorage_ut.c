@@ -0,0 +1,254 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Write a file whose byte at position i is i % 251. */
+static void dbstorage_ut_makefile(char *filename, db_int numbytes) {
+  db_fileref_t f = db_openwritefile(filename);
+  unsigned char c;
+  db_int i;
+  for (i = 0; i < numbytes; ++i) {
+    c = (unsigned char)(i % 251);
+    db_filewrite(f, &c, 1);
+  }
+  db_fileclose(f);
+}
+
+void test_dbstorage_1(CuTest *tc) {
+  char filename[] = "dbstorage_ut_1";
+  unsigned char bytes[100];
+  unsigned char marks[10];
+  db_fileref_t rf, wf;
+  db_int i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: Reads see writes made through another handle.");
+
+  dbstorage_ut_makefile(filename, 1500);
+
+  rf = db_openreadfile(filename);
+  CuAssertTrue(tc, DB_STORAGE_NOFILE != rf);
+  CuAssertTrue(tc, 100 == db_fileread(rf, bytes, 100));
+  for (i = 0; i < 100; ++i)
+    CuAssertTrue(tc, (unsigned char)i == bytes[i]);
+
+  /* Overwrite bytes 600 to 609, which straddle no page the reader has seen. */
+  memset(marks, 0xFF, 10);
+  wf = db_openreadfile_plus(filename);
+  CuAssertTrue(tc, DB_STORAGE_NOFILE != wf);
+  db_fileseek(wf, 600);
+  CuAssertTrue(tc, 10 == db_filewrite(wf, marks, 10));
+  db_fileclose(wf);
+
+  db_fileseek(rf, 495);
+  CuAssertTrue(tc, 20 == db_fileread(rf, bytes, 20));
+  for (i = 0; i < 5; ++i)
+    CuAssertTrue(tc, (unsigned char)((595 + i) % 251) == bytes[i]);
+  for (i = 5; i < 15; ++i)
+    CuAssertTrue(tc, 0xFF == bytes[i]);
+  for (i = 15; i < 20; ++i)
+    CuAssertTrue(tc, (unsigned char)((595 + i) % 251) == bytes[i]);
+
+  /* Overwrite a page the reader already has cached. */
+  wf = db_openreadfile_plus(filename);
+  db_fileseek(wf, 10);
+  CuAssertTrue(tc, 10 == db_filewrite(wf, marks, 10));
+  db_fileclose(wf);
+
+  CuAssertTrue(tc, 1 == db_filerewind(rf));
+  CuAssertTrue(tc, 30 == db_fileread(rf, bytes, 30));
+  for (i = 0; i < 30; ++i) {
+    if (i >= 10 && i < 20)
+      CuAssertTrue(tc, 0xFF == bytes[i]);
+    else
+      CuAssertTrue(tc, (unsigned char)i == bytes[i]);
+  }
+
+  /* Reading past the end fails as it would without the pool. */
+  db_fileseek(rf, 1460);
+  CuAssertTrue(tc, 0 == db_fileread(rf, bytes, 20));
+
+  db_fileclose(rf);
+  db_fileremove(filename);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbstorage_2(CuTest *tc) {
+  char filename[] = "dbstorage_ut_2";
+  unsigned char bytes[100];
+  db_fileref_t f;
+  db_int i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Opening a file for writing discards its old contents.");
+
+  dbstorage_ut_makefile(filename, 1000);
+  f = db_openreadfile(filename);
+  CuAssertTrue(tc, 100 == db_fileread(f, bytes, 100));
+  db_fileclose(f);
+
+  f = db_openwritefile(filename);
+  memset(bytes, 7, 10);
+  CuAssertTrue(tc, 10 == db_filewrite(f, bytes, 10));
+  db_fileclose(f);
+
+  f = db_openreadfile(filename);
+  CuAssertTrue(tc, 10 == db_filesize(f));
+  memset(bytes, 0, 100);
+  CuAssertTrue(tc, 0 == db_fileread(f, bytes, 20));
+  CuAssertTrue(tc, 1 == db_filerewind(f));
+  CuAssertTrue(tc, 10 == db_fileread(f, bytes, 10));
+  for (i = 0; i < 10; ++i)
+    CuAssertTrue(tc, 7 == bytes[i]);
+  db_fileclose(f);
+
+  /* Appending lands after the end, and is read back. */
+  f = db_openappendfile(filename);
+  memset(bytes, 9, 10);
+  CuAssertTrue(tc, 10 == db_filewrite(f, bytes, 10));
+  db_fileclose(f);
+
+  f = db_openreadfile(filename);
+  CuAssertTrue(tc, 20 == db_fileread(f, bytes, 20));
+  for (i = 0; i < 20; ++i)
+    CuAssertTrue(tc, (i < 10 ? 7 : 9) == bytes[i]);
+  db_fileclose(f);
+
+  db_fileremove(filename);
+  puts("***********************************************************************"
+       "*********");
+}
+
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+void test_dbstorage_3(CuTest *tc) {
+  char filename[] = "dbstorage_ut_3";
+  unsigned char bytes[DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE];
+  db_fileref_t f;
+  db_int i, j;
+  long misses;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: Pages stay cached after their file is closed.");
+
+  dbstorage_ut_makefile(filename, 2 * DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE);
+  db_filepoolclear();
+
+  for (j = 0; j < 3; ++j) {
+    misses = db_filepoolmisses();
+    f = db_openreadfile(filename);
+    for (i = 0; i < 2; ++i)
+      CuAssertTrue(tc, DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE ==
+                           db_fileread(f, bytes,
+                                       DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE));
+    db_fileclose(f);
+    printf("Pass %d loaded %ld pages.\n", (int)j,
+           db_filepoolmisses() - misses);
+    CuAssertTrue(tc, (0 == j ? 2 : 0) == db_filepoolmisses() - misses);
+  }
+
+  db_fileremove(filename);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_dbstorage_4(CuTest *tc) {
+  char filename[] = "dbstorage_ut_4";
+  db_int numpages = DB_CTCONF_SETTING_BUFFERPOOL_PAGES + 2;
+  unsigned char bytes[DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE];
+  unsigned char *page;
+  unsigned char c = 0xFF;
+  db_fileref_t f, wf;
+  db_int i, length;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: A pinned page is not evicted.");
+
+  dbstorage_ut_makefile(filename,
+                        numpages * DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE + 7);
+
+  f = db_openreadfile(filename);
+  page = db_filepin(f, 0, &length);
+  CuAssertTrue(tc, NULL != page);
+  CuAssertTrue(tc, DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE == length);
+
+  /* Reading the whole file cycles every other frame in the pool. */
+  for (i = 0; i < numpages; ++i)
+    CuAssertTrue(tc, DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE ==
+                         db_fileread(f, bytes,
+                                     DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE));
+  for (i = 0; i < DB_CTCONF_SETTING_BUFFERPOOL_PAGESIZE; ++i)
+    CuAssertTrue(tc, (unsigned char)(i % 251) == page[i]);
+
+  /* Writes still reach the pinned copy. */
+  wf = db_openreadfile_plus(filename);
+  db_fileseek(wf, 3);
+  CuAssertTrue(tc, 1 == db_filewrite(wf, &c, 1));
+  db_fileclose(wf);
+  CuAssertTrue(tc, 0xFF == page[3]);
+  db_fileunpin(page);
+
+  /* The last page is partly filled, and there is none after it. */
+  page = db_filepin(f, numpages, &length);
+  CuAssertTrue(tc, NULL != page);
+  CuAssertTrue(tc, 7 == length);
+  db_fileunpin(page);
+  CuAssertTrue(tc, NULL == db_filepin(f, numpages + 1, &length));
+
+  db_fileclose(f);
+  db_fileremove(filename);
+  puts("***********************************************************************"
+       "*********");
+}
+#endif
+
+CuSuite *DBStorageGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_dbstorage_1);
+  SUITE_ADD_TEST(suite, test_dbstorage_2);
+#if DB_CTCONF_SETTING_BUFFERPOOL_PAGES > 0
+  SUITE_ADD_TEST(suite, test_dbstorage_3);
+  SUITE_ADD_TEST(suite, test_dbstorage_4);
+#endif
+
+  return suite;
+}
+
+void runAllTests_dbstorage() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBStorageGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
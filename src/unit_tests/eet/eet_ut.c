@@ -2370,6 +2370,345 @@ void test_eet_27(CuTest *tc)
 }
 
 
+/* Build an expression from pairs of node types and values.  The value is the
+   position of an attribute, the integer of a constant, and unused otherwise. */
+static void eet_ut_build(db_eet_t *eetp, db_int *spec, db_int numnodes)
+{
+	db_eetnode_t *arr_p;
+	db_eetnode_attr_t attrnode;
+	db_eetnode_dbint_t dbintnode;
+	db_int i;
+	
+	eetp->size = 0;
+	for (i = 0; i < numnodes; ++i)
+	{
+		if (DB_EETNODE_ATTR == spec[2*i])
+			eetp->size += sizeof(db_eetnode_attr_t);
+		else if (DB_EETNODE_CONST_DBINT == spec[2*i])
+			eetp->size += sizeof(db_eetnode_dbint_t);
+		else
+			eetp->size += sizeof(db_eetnode_t);
+	}
+	eetp->nodes = malloc((size_t)eetp->size);
+	eetp->stack_size = eetp->size;
+	arr_p = eetp->nodes;
+	
+	for (i = 0; i < numnodes; ++i)
+	{
+		if (DB_EETNODE_ATTR == spec[2*i])
+		{
+			attrnode.base.type = DB_EETNODE_ATTR;
+			attrnode.pos = (db_uint8)spec[2*i+1];
+			attrnode.tuple_pos = 0;
+			*((db_eetnode_attr_t*)arr_p) = attrnode;
+			arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+		}
+		else if (DB_EETNODE_CONST_DBINT == spec[2*i])
+		{
+			dbintnode.base.type = DB_EETNODE_CONST_DBINT;
+			dbintnode.integer = spec[2*i+1];
+			*((db_eetnode_dbint_t*)arr_p) = dbintnode;
+			arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
+		}
+		else
+		{
+			arr_p->type = (db_uint8)spec[2*i];
+			arr_p++;
+		}
+	}
+}
+
+/* Evaluate an expression over a batch with every tuple but the one at skip
+   selected, and check that exactly the tuples that evaluate_eet passes one at
+   a time stay selected.  Returns how many do. */
+static db_int eet_ut_checkbatch(CuTest *tc, db_int *spec, db_int numnodes, db_int skip, db_tuplebatch_t *bp, relation_header_t *hp, db_query_mm_t *mmp)
+{
+	db_eet_t eet;
+	db_uint8 selected[8];
+	db_tuple_t t;
+	db_tuple_t *tap[1];
+	relation_header_t *hap[1];
+	db_int i, retval, result, count = 0;
+	
+	eet_ut_build(&eet, spec, numnodes);
+	tap[0] = &t;
+	hap[0] = hp;
+	
+	memset(selected, 0xFF, sizeof(selected));
+	selected[skip/8] &= ~(1 << (skip%8));
+	CuAssertTrue(tc, 1 == evaluate_eet_batch(NULL, &eet, bp, hp, selected, mmp));
+	
+	for (i = 0; i < bp->count; ++i)
+	{
+		viewbatchtuple(bp, i, &t);
+		retval = evaluate_eet(&eet, &result, tap, hap, 0, mmp);
+		if (skip != i && 1 == retval && 1 == result)
+		{
+			CuAssertTrue(tc, 0 != (selected[i/8] & (1 << (i%8))));
+			count++;
+		}
+		else
+		{
+			CuAssertTrue(tc, 0 == (selected[i/8] & (1 << (i%8))));
+		}
+	}
+	
+	free(eet.nodes);
+	return count;
+}
+
+void test_eet_28(CuTest *tc)
+{
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t s;
+	db_tuplebatch_t batch;
+	db_int count;
+	
+	/* (a % 3 = 0) OR (15 < a) */
+	db_int spec1[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 3, DB_EETNODE_OP_MOD, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_EQ, 0, DB_EETNODE_CONST_DBINT, 15, DB_EETNODE_ATTR, 0, DB_EETNODE_OP_LT, 0, DB_EETNODE_OP_OR, 0};
+	/* (a / (a - 3) = 1) AND (a * 2 < 30), where a - 3 is sometimes 0. */
+	db_int spec2[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 3, DB_EETNODE_OP_SUB, 0, DB_EETNODE_OP_DIV, 0, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_OP_EQ, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 2, DB_EETNODE_OP_MULT, 0, DB_EETNODE_CONST_DBINT, 30, DB_EETNODE_OP_LT, 0, DB_EETNODE_OP_AND, 0};
+	/* NULL OR a = 11 */
+	db_int spec3[] = {DB_EETNODE_CONST_NULL, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 11, DB_EETNODE_OP_EQ, 0, DB_EETNODE_OP_OR, 0};
+	/* LENGTH(b) > 5, which is evaluated a tuple at a time. */
+	db_int spec4[] = {DB_EETNODE_ATTR, 1, DB_EETNODE_FUNC_LENGTH_DBSTRING, 0, DB_EETNODE_CONST_DBINT, 5, DB_EETNODE_OP_GT, 0};
+	/* (a0 = 0) OR (a1 = 1) */
+	db_int spec5[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_EQ, 0, DB_EETNODE_ATTR, 1, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_OP_EQ, 0, DB_EETNODE_OP_OR, 0};
+	/* (a0 < 5) AND NOT (a9 IS NULL) */
+	db_int spec6[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 5, DB_EETNODE_OP_LT, 0, DB_EETNODE_ATTR, 9, DB_EETNODE_OP_ISNULL, 0, DB_EETNODE_OP_NOT, 0, DB_EETNODE_OP_AND, 0};
+	
+	puts("********************************************************************************");
+	puts("Batch Test 1: Predicates over a whole batch match evaluating them a tuple at a time.");
+	
+	init_scan(&s, "shuffled_rel", &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 20, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 20 == batch.count);
+	
+	count = eet_ut_checkbatch(tc, spec1, 9, 1, &batch, s.base.header, &mm);
+	printf("Selected %d tuples.\n", count);
+	CuAssertTrue(tc, 10 == count);
+	count = eet_ut_checkbatch(tc, spec2, 13, 1, &batch, s.base.header, &mm);
+	printf("Selected %d tuples.\n", count);
+	CuAssertTrue(tc, 7 == count);
+	count = eet_ut_checkbatch(tc, spec3, 5, 1, &batch, s.base.header, &mm);
+	printf("Selected %d tuples.\n", count);
+	CuAssertTrue(tc, 2 == count);
+	count = eet_ut_checkbatch(tc, spec4, 4, 1, &batch, s.base.header, &mm);
+	printf("Selected %d tuples.\n", count);
+	CuAssertTrue(tc, 11 == count);
+	
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	
+	/* The second tuple of tenattrtable has NULLs in it. */
+	init_scan(&s, "tenattrtable", &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 4, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 2 == batch.count);
+	
+	count = eet_ut_checkbatch(tc, spec5, 7, 2, &batch, s.base.header, &mm);
+	CuAssertTrue(tc, 2 == count);
+	count = eet_ut_checkbatch(tc, spec6, 7, 2, &batch, s.base.header, &mm);
+	CuAssertTrue(tc, 1 == count);
+	
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	puts("********************************************************************************");
+}
+
+/* Compile an expression, and check that the program evaluates to the same
+   thing evaluate_eet does for every tuple of a batch.  Expressions that are
+   not meant to compile are not evaluated. */
+static void eet_ut_checkprog(CuTest *tc, db_int *spec, db_int numnodes, db_int compiles, db_tuplebatch_t *bp, relation_header_t *hp, db_query_mm_t *mmp)
+{
+	db_eet_t eet;
+	db_eetprog_t prog;
+	db_tuple_t t;
+	db_tuple_t *tap[1];
+	relation_header_t *hap[1];
+	db_int i, retval, progretval, result, progresult;
+	
+	eet_ut_build(&eet, spec, numnodes);
+	tap[0] = &t;
+	hap[0] = hp;
+	
+	CuAssertTrue(tc, compiles == compile_eet(&prog, &eet, hap, mmp));
+	for (i = 0; 1 == compiles && i < bp->count; ++i)
+	{
+		viewbatchtuple(bp, i, &t);
+		result = -1;
+		progresult = -1;
+		retval = evaluate_eet(&eet, &result, tap, hap, 0, mmp);
+		progretval = evaluate_eet_compiled(&prog, &eet, &progresult, tap, hap, mmp);
+		CuAssertTrue(tc, retval == progretval);
+		if (1 == retval)
+			CuAssertTrue(tc, result == progresult);
+	}
+	
+	close_eetprog(&prog, mmp);
+	free(eet.nodes);
+}
+
+void test_eet_29(CuTest *tc)
+{
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t s;
+	db_tuplebatch_t batch;
+	
+	/* (a % 3 = 0) OR (15 < a) */
+	db_int spec1[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 3, DB_EETNODE_OP_MOD, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_EQ, 0, DB_EETNODE_CONST_DBINT, 15, DB_EETNODE_ATTR, 0, DB_EETNODE_OP_LT, 0, DB_EETNODE_OP_OR, 0};
+	/* -(a / (a - 3)) * 7 */
+	db_int spec2[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 3, DB_EETNODE_OP_SUB, 0, DB_EETNODE_OP_DIV, 0, DB_EETNODE_OP_UNARYNEG, 0, DB_EETNODE_CONST_DBINT, 7, DB_EETNODE_OP_MULT, 0};
+	/* (LENGTH(b) > 5) XOR (b = b) */
+	db_int spec3[] = {DB_EETNODE_ATTR, 1, DB_EETNODE_FUNC_LENGTH_DBSTRING, 0, DB_EETNODE_CONST_DBINT, 5, DB_EETNODE_OP_GT, 0, DB_EETNODE_ATTR, 1, DB_EETNODE_ATTR, 1, DB_EETNODE_OP_EQ, 0, DB_EETNODE_OP_XOR, 0};
+	/* NULL + a, and NOT NULL AND NULL. */
+	db_int spec4[] = {DB_EETNODE_CONST_NULL, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_OP_ADD, 0};
+	db_int spec5[] = {DB_EETNODE_CONST_NULL, 0, DB_EETNODE_OP_NOT, 0, DB_EETNODE_CONST_NULL, 0, DB_EETNODE_OP_AND, 0};
+	/* a < b, which mixes types, is not compiled. */
+	db_int spec6[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_ATTR, 1, DB_EETNODE_OP_LT, 0};
+	/* (a0 = 0) OR (a1 = 1), and (a0 < 5) AND NOT (a9 IS NULL) */
+	db_int spec7[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_EQ, 0, DB_EETNODE_ATTR, 1, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_OP_EQ, 0, DB_EETNODE_OP_OR, 0};
+	db_int spec8[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 5, DB_EETNODE_OP_LT, 0, DB_EETNODE_ATTR, 9, DB_EETNODE_OP_ISNULL, 0, DB_EETNODE_OP_NOT, 0, DB_EETNODE_OP_AND, 0};
+	
+	puts("********************************************************************************");
+	puts("Compiled Test 1: Compiled expressions evaluate as the trees they came from.");
+	
+	init_scan(&s, "shuffled_rel", &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 20, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 20 == batch.count);
+	
+	eet_ut_checkprog(tc, spec1, 9, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec2, 8, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec3, 8, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec4, 3, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec5, 4, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec6, 3, 0, &batch, s.base.header, &mm);
+	
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	
+	init_scan(&s, "tenattrtable", &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 4, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 2 == batch.count);
+	
+	eet_ut_checkprog(tc, spec7, 7, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec8, 7, 1, &batch, s.base.header, &mm);
+	
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	puts("********************************************************************************");
+}
+
+void test_eet_30(CuTest *tc)
+{
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	scan_t s;
+	db_tuplebatch_t batch;
+	db_eet_t eet;
+	db_eetprog_t prog;
+	relation_header_t *hap[1];
+	
+	/* ((a < 5) AND (a > 1)) OR ((a % 2 = 0) AND (15 < a)) */
+	db_int spec1[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 5, DB_EETNODE_OP_LT, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_OP_GT, 0, DB_EETNODE_OP_AND, 0, DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 2, DB_EETNODE_OP_MOD, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_EQ, 0, DB_EETNODE_CONST_DBINT, 15, DB_EETNODE_ATTR, 0, DB_EETNODE_OP_LT, 0, DB_EETNODE_OP_AND, 0, DB_EETNODE_OP_OR, 0};
+	/* (a0 = 1) AND (a1 + a9 > 0), and (a0 IS NULL) OR (a9 < 1 + a1) */
+	db_int spec2[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_OP_EQ, 0, DB_EETNODE_ATTR, 1, DB_EETNODE_ATTR, 9, DB_EETNODE_OP_ADD, 0, DB_EETNODE_CONST_DBINT, 0, DB_EETNODE_OP_GT, 0, DB_EETNODE_OP_AND, 0};
+	db_int spec3[] = {DB_EETNODE_ATTR, 0, DB_EETNODE_OP_ISNULL, 0, DB_EETNODE_ATTR, 9, DB_EETNODE_CONST_DBINT, 1, DB_EETNODE_ATTR, 1, DB_EETNODE_OP_ADD, 0, DB_EETNODE_OP_LT, 0, DB_EETNODE_OP_OR, 0};
+	
+	puts("********************************************************************************");
+	puts("Compiled Test 2: AND and OR jump over operands they do not need.");
+	
+	init_scan(&s, "shuffled_rel", &mm);
+	hap[0] = s.base.header;
+	eet_ut_build(&eet, spec1, 17);
+	CuAssertTrue(tc, 1 == compile_eet(&prog, &eet, hap, &mm));
+	CuAssertTrue(tc, 20 == prog.length);
+	CuAssertTrue(tc, DB_EETPROG_INT_ANDJUMP == prog.code[3].op);
+	CuAssertTrue(tc, 4 == prog.code[3].value.integer);
+	CuAssertTrue(tc, DB_EETPROG_INT_ORJUMP == prog.code[8].op);
+	CuAssertTrue(tc, 11 == prog.code[8].value.integer);
+	CuAssertTrue(tc, DB_EETPROG_INT_ANDJUMP == prog.code[14].op);
+	CuAssertTrue(tc, 4 == prog.code[14].value.integer);
+	close_eetprog(&prog, &mm);
+	free(eet.nodes);
+	
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 20, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 20 == batch.count);
+	eet_ut_checkprog(tc, spec1, 17, 1, &batch, s.base.header, &mm);
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	
+	init_scan(&s, "tenattrtable", &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 4, s.base.header->tuple_size, s.base.header->num_attr, &mm));
+	CuAssertTrue(tc, 1 == next_batch((db_op_base_t*)&s, &batch, &mm));
+	CuAssertTrue(tc, 2 == batch.count);
+	eet_ut_checkprog(tc, spec2, 9, 1, &batch, s.base.header, &mm);
+	eet_ut_checkprog(tc, spec3, 8, 1, &batch, s.base.header, &mm);
+	close_tuplebatch(&batch, &mm);
+	close_scan(&s, &mm);
+	puts("********************************************************************************");
+}
+
+void test_eet_31(CuTest *tc)
+{
+	db_query_mm_t mm;
+	char segment[1000];
+	init_query_mm(&mm, segment, 1000);
+	
+	db_eet_t eet;
+	db_eetnode_dbint_t argnode;
+	db_eetnode_aggr_temp_t aggrnode;
+	db_int value = 7;
+	db_int result;
+	
+	puts("********************************************************************************");
+	puts("Test 31: An aggregate node without a value is not evaluated.");
+	
+	/* SUM(3) */
+	eet.size = sizeof(db_eetnode_dbint_t) + sizeof(db_eetnode_aggr_temp_t);
+	eet.nodes = malloc((size_t)eet.size);
+	eet.stack_size = eet.size;
+	argnode.base.type = DB_EETNODE_CONST_DBINT;
+	argnode.integer = 3;
+	*((db_eetnode_dbint_t*)eet.nodes) = argnode;
+	memset(&aggrnode, 0, sizeof(db_eetnode_aggr_temp_t));
+	aggrnode.base.type = DB_EETNODE_AGGR_TEMP;
+	aggrnode.aggr_type = DB_AGGR_SUM;
+	aggrnode.value_p = NULL;
+	aggrnode.aggr_isnull = 0;
+	*((db_eetnode_aggr_temp_t*)(((db_eetnode_dbint_t*)eet.nodes)+1)) = aggrnode;
+	
+	CuAssertTrue(tc, -1 == evaluate_eet(&eet, &result, NULL, NULL, 0, &mm));
+	CuAssertTrue(tc, DB_EETNODE_CONST_DBINT == evaluate_eet(&eet, NULL, NULL, NULL, 0, &mm));
+	
+	aggrnode.aggr_isnull = 1;
+	*((db_eetnode_aggr_temp_t*)(((db_eetnode_dbint_t*)eet.nodes)+1)) = aggrnode;
+	CuAssertTrue(tc, 2 == evaluate_eet(&eet, &result, NULL, NULL, 0, &mm));
+	
+	aggrnode.aggr_isnull = 0;
+	aggrnode.value_p = &value;
+	*((db_eetnode_aggr_temp_t*)(((db_eetnode_dbint_t*)eet.nodes)+1)) = aggrnode;
+	CuAssertTrue(tc, 1 == evaluate_eet(&eet, &result, NULL, NULL, 0, &mm));
+	CuAssertTrue(tc, 7 == result);
+	
+	/* Nothing is left behind on the stack. */
+	CuAssertTrue(tc, 1000 == POINTERBYTEDIST(mm.last_back, mm.next_front));
+	free(eet.nodes);
+	puts("********************************************************************************");
+}
+
 CuSuite *DBEETGetSuite()
 {
 	CuSuite *suite = CuSuiteNew();
@@ -2401,6 +2740,10 @@ CuSuite *DBEETGetSuite()
 	SUITE_ADD_TEST(suite, test_eet_25);
 	SUITE_ADD_TEST(suite, test_eet_26);
 	SUITE_ADD_TEST(suite, test_eet_27);
+	SUITE_ADD_TEST(suite, test_eet_28);
+	SUITE_ADD_TEST(suite, test_eet_29);
+	SUITE_ADD_TEST(suite, test_eet_30);
+	SUITE_ADD_TEST(suite, test_eet_31);
 #if 0
 #endif
 	
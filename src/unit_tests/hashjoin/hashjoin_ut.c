@@ -0,0 +1,585 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dblogic/eet.h"
+#include "../../dbmacros.h"
+#include "../../dbobjects/relation.h"
+#include "../../dbobjects/tuple.h"
+#include "../../dbops/db_ops.h"
+#include "../../dbops/hashjoin.h"
+#include "../../dbops/scan.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+void test_hashjoin_1(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  db_int intResult, i, j;
+  char *strResult;
+  scan_t lscan, rscan;
+  hashjoin_t hashjoin;
+  db_tuple_t t;
+  db_int expectedIds[] = {2, 3, 5};
+  char *expectedNames[] = {"Orange", "Pear", "Lime"};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: Hash join fruit_stock_1 with fruit_stock_2 on id.");
+
+  /* Variable delcaration */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  /* Build the expression tree, in evaluable form. */
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, DB_HASHJOIN == hashjoin.base.type);
+  /* fruit_stock_1 is the smaller relation. */
+  CuAssertTrue(tc, 0 == hashjoin.buildright);
+  init_tuple(&t, hashjoin.base.header->tuple_size,
+             hashjoin.base.header->num_attr, &mm);
+
+  /* Carry out test, twice to make sure rewinding works. */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < 3; ++i) {
+      intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+      CuAssertTrue(tc, 1 == intResult);
+      intResult = getintbypos(&t, 0, hashjoin.base.header);
+      printf("The db_int value at position %d in the returned tuple is: %d\n",
+             0, intResult);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      intResult = getintbypos(&t, 5, hashjoin.base.header);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      strResult = getstringbypos(&t, 1, hashjoin.base.header);
+      printf("The string value at position %d in the returned tuple is: %s\n",
+             1, strResult);
+      CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+    }
+
+    intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&hashjoin, &mm));
+  }
+
+  close((db_op_base_t *)&hashjoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_2(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  db_int intResult, i;
+  char *strResult;
+  scan_t lscan, rscan;
+  hashjoin_t hashjoin;
+  db_tuple_t t;
+  char *expectedNames[] = {"Orange", "Lemon", "Lime"};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Hash join fruit_stock_2 with fruit_stock_1 on name.");
+
+  /* Variable delcaration */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  /* Build the expression tree, in evaluable form. */
+  attrnode.pos = 1;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 1;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_2", &mm);
+  init_scan(&rscan, "fruit_stock_1", &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, 1 == hashjoin.buildright);
+  init_tuple(&t, hashjoin.base.header->tuple_size,
+             hashjoin.base.header->num_attr, &mm);
+
+  /* Carry out test.  Tuples with NULL names never join. */
+  for (i = 0; i < 3; ++i) {
+    intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+    CuAssertTrue(tc, 1 == intResult);
+    strResult = getstringbypos(&t, 1, hashjoin.base.header);
+    printf("The string value at position %d in the returned tuple is: %s\n", 1,
+           strResult);
+    CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+    strResult = getstringbypos(&t, 6, hashjoin.base.header);
+    CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+  }
+
+  intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+
+  close((db_op_base_t *)&hashjoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_3(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  db_eetnode_dbint_t intnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  intnode.base.type = DB_EETNODE_CONST_DBINT;
+  db_int intResult;
+  scan_t lscan, rscan;
+  hashjoin_t hashjoin;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: Hash join on id, keeping only ids greater than 2.");
+
+  /* Variable delcaration */
+  eet.size = (3 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_dbint_t) +
+              3 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  /* Build the expression tree, in evaluable form.  The equality is the
+     second argument of the AND. */
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  intnode.integer = 2;
+  *((db_eetnode_dbint_t *)arr_p) = intnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_dbint_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_GT;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  opnode.type = DB_EETNODE_OP_AND;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, 0 == hashjoin.lkey);
+  CuAssertTrue(tc, 0 == hashjoin.rkey);
+  init_tuple(&t, hashjoin.base.header->tuple_size,
+             hashjoin.base.header->num_attr, &mm);
+
+  /* Carry out test. */
+  intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  intResult = getintbypos(&t, 0, hashjoin.base.header);
+  printf("The db_int value at position %d in the returned tuple is: %d\n", 0,
+         intResult);
+  CuAssertTrue(tc, 3 == intResult);
+
+  intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  intResult = getintbypos(&t, 0, hashjoin.base.header);
+  printf("The db_int value at position %d in the returned tuple is: %d\n", 0,
+         intResult);
+  CuAssertTrue(tc, 5 == intResult);
+
+  intResult = next((db_op_base_t *)&hashjoin, &t, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+
+  close((db_op_base_t *)&hashjoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_4(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  db_eetnode_dbint_t intnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  intnode.base.type = DB_EETNODE_CONST_DBINT;
+  db_int intResult;
+  scan_t lscan, rscan;
+  hashjoin_t hashjoin;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: Conditions that can not be hashed on.");
+
+  /* Variable delcaration */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_dbint_t) +
+              2 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  /* Build the expression tree, in evaluable form.  The equality need not
+     hold for a tuple to join. */
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  intnode.integer = 1;
+  *((db_eetnode_dbint_t *)arr_p) = intnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_dbint_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_OR;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, DB_NTJOIN == hashjoin.base.type);
+  close((db_op_base_t *)&hashjoin, &mm);
+
+  /* An integer can't be hashed against a string. */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  arr_p = eet.nodes;
+  ((db_eetnode_attr_t *)arr_p)->pos = 1;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+
+  rewind_scan(&lscan, &mm);
+  rewind_scan(&rscan, &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, DB_NTJOIN == hashjoin.base.type);
+  close((db_op_base_t *)&hashjoin, &mm);
+
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_5(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  db_int intResult, i, j, count, sum;
+  scan_t lscan, rscan;
+  hashjoin_t hashjoin;
+  db_tuple_t t;
+  char tempname[16];
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 5: Hash join shuffled_rel with itself with very little memory.");
+
+  /* Variable delcaration */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  /* Build the expression tree, in evaluable form. */
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  /* Build up query tree. */
+  init_scan(&lscan, "shuffled_rel", &mm);
+  init_scan(&rscan, "shuffled_rel", &mm);
+  intResult = init_hashjoin(&hashjoin, &eet, (db_op_base_t *)&lscan,
+                            (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, hashjoin.base.header->tuple_size,
+             hashjoin.base.header->num_attr, &mm);
+
+  /* Leave only enough memory to hold a few tuples at a time, forcing both
+     inputs to be partitioned. */
+  void *filler = db_qmm_balloc(
+      &mm, POINTERBYTEDIST(mm.last_back, mm.next_front) - sizeof(db_int) -
+               DB_CTCONF_SETTING_OPERATOR_RESERVE - eet.stack_size -
+               3 * sizeof(db_int) - 300);
+  CuAssertTrue(tc, NULL != filler);
+
+  /* Each of the 18 distinct values joins with itself, but the duplicated 3
+     and 11 each join four times. */
+  for (j = 0; j < 2; ++j) {
+    count = 0;
+    sum = 0;
+    while (1 == (intResult = next((db_op_base_t *)&hashjoin, &t, &mm))) {
+      i = getintbypos(&t, 0, hashjoin.base.header);
+      CuAssertTrue(tc, i == getintbypos(&t, 3, hashjoin.base.header));
+      count++;
+      sum += i;
+    }
+    printf("Joined %d tuples using %d partitions.\n", count,
+           (int)hashjoin.num_parts);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 24 == count);
+    CuAssertTrue(tc, 210 - 10 - 13 + 3 * 3 + 11 * 3 == sum);
+    CuAssertTrue(tc, hashjoin.num_parts >= 2);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&hashjoin, &mm));
+  }
+
+  close((db_op_base_t *)&hashjoin, &mm);
+  sprintf(tempname, "DB_HJ_%d_b0", (int)hashjoin.hashid);
+  CuAssertTrue(tc, 1 != db_fileexists(tempname));
+  sprintf(tempname, "DB_HJ_%d_p0", (int)hashjoin.hashid);
+  CuAssertTrue(tc, 1 != db_fileexists(tempname));
+
+  db_qmm_bfree(&mm, filler);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_6(CuTest *tc) {
+  char command[] = "SELECT * FROM fruit_stock_1, fruit_stock_2 WHERE "
+                   "fruit_stock_1.id = fruit_stock_2.id AND "
+                   "fruit_stock_1.__delete = 0 AND fruit_stock_2.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 6: The parser plans an unindexed equi-join as a hash join.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc, 0 == strcmp("+HASHJOIN\n++SCAN\n++SCAN\n", output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc, getintbypos(&t, 0, rootp->header) ==
+                         getintbypos(&t, 5, rootp->header));
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 3 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_hashjoin_7(CuTest *tc) {
+  char command[] = "SELECT fruit_stock_2.price, fruit_stock_1.id, "
+                   "fruit_stock_1.qty FROM fruit_stock_1, fruit_stock_2 WHERE "
+                   "fruit_stock_1.id = fruit_stock_2.id AND "
+                   "fruit_stock_1.__delete = 0 AND fruit_stock_2.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0, id;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 7: Attributes are projected out of a hash join.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc,
+               0 == strcmp("+PROJECT\n++HASHJOIN\n+++SCAN\n+++SCAN\n", output));
+  free(output);
+
+  /* Ids 2, 3 and 5 match, each projected with attributes of both sides. */
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    id = getintbypos(&t, 1, rootp->header);
+    CuAssertTrue(tc, 2 == id || 3 == id || 5 == id);
+    CuAssertTrue(tc, (3 == id ? 1 : 3) == getintbypos(&t, 0, rootp->header));
+    CuAssertTrue(tc, (2 == id ? 29 : 3 == id ? 17 : 10) ==
+                         getintbypos(&t, 2, rootp->header));
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 3 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+CuSuite *DBHashJoinGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_hashjoin_1);
+  SUITE_ADD_TEST(suite, test_hashjoin_2);
+  SUITE_ADD_TEST(suite, test_hashjoin_3);
+  SUITE_ADD_TEST(suite, test_hashjoin_4);
+  SUITE_ADD_TEST(suite, test_hashjoin_5);
+  SUITE_ADD_TEST(suite, test_hashjoin_6);
+  SUITE_ADD_TEST(suite, test_hashjoin_7);
+
+  return suite;
+}
+
+void runAllTests_hashjoin() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBHashJoinGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
@@ -428,6 +428,167 @@ void test_project_4(CuTest *tc)
 	puts("*************************************************************");
 }
 
+void test_project_5(CuTest *tc)
+{
+	/* Variable declarations */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	project_t p;
+	scan_t s;
+	db_eet_t twoExpr[2];
+	db_eetnode_t *arr_p;
+	db_eetnode_t opNode;
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	db_tuple_t next_t;
+	db_tuplebatch_t batch;
+	db_int result, i, count, lengths, sums;
+	
+	puts("*************************************************************");
+	puts("Testing shuffled_rel, projecting length(b) and a + a a batch at a time.");
+	init_scan(&s, "shuffled_rel", &mm);
+	
+	twoExpr[0].size = (db_uint8)(1*sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[0].nodes = malloc((size_t)(twoExpr[0].size));
+	twoExpr[0].stack_size = twoExpr[0].size;
+	
+	twoExpr[1].size = (db_uint8)(2*sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
+	twoExpr[1].stack_size = twoExpr[1].size;
+	
+	arr_p = twoExpr[0].nodes;
+	
+	attrNode.pos = 1;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_FUNC_LENGTH_DBSTRING;
+	*(arr_p) = opNode;
+	arr_p++;
+	
+	arr_p = twoExpr[1].nodes;
+	
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*(arr_p) = opNode;
+	arr_p++;
+	
+	init_project(&p, (db_op_base_t*)(&s), twoExpr, 2, &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 6, p.base.header->tuple_size, p.base.header->num_attr, &mm));
+	
+	/* Twenty tuples come out as three full batches and one of two. */
+	count = 0;
+	lengths = 0;
+	sums = 0;
+	while (1 == (result = next_batch((db_op_base_t*)(&p), &batch, &mm)))
+	{
+		CuAssertTrue(tc, (count < 18 ? 6 : 2) == batch.count);
+		for (i = 0; i < batch.count; ++i)
+		{
+			viewbatchtuple(&batch, i, &next_t);
+			lengths += getintbypos(&next_t, 0, p.base.header);
+			sums += getintbypos(&next_t, 1, p.base.header);
+		}
+		count += batch.count;
+	}
+	printf("Projected %d tuples in batches.\n", count);
+	CuAssertTrue(tc, 0 == result);
+	CuAssertTrue(tc, 20 == count);
+	CuAssertTrue(tc, 128 == lengths);
+	CuAssertTrue(tc, 402 == sums);
+	
+	close_tuplebatch(&batch, &mm);
+	close_project(&p, &mm);
+	close_scan(&s, &mm);
+	free(twoExpr[0].nodes);
+	free(twoExpr[1].nodes);
+	puts("*************************************************************");
+}
+
+void test_project_6(CuTest *tc)
+{
+	/* Variable declarations */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	project_t p;
+	scan_t s;
+	db_eet_t oneExpr[1];
+	db_eetnode_t *arr_p;
+	db_eetnode_t opNode;
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	db_tuple_t next_t;
+	db_int result, count, sums;
+	
+	puts("*************************************************************");
+	puts("Testing shuffled_rel, projecting a + a a tuple at a time from batches.");
+	init_scan(&s, "shuffled_rel", &mm);
+	
+	oneExpr[0].size = (db_uint8)(2*sizeof(db_eetnode_attr_t) + sizeof(db_eetnode_t));
+	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
+	oneExpr[0].stack_size = oneExpr[0].size;
+	
+	arr_p = oneExpr[0].nodes;
+	
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	*((db_eetnode_attr_t*)arr_p) = attrNode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	
+	opNode.type = DB_EETNODE_OP_ADD;
+	*(arr_p) = opNode;
+	arr_p++;
+	
+	init_project(&p, (db_op_base_t*)(&s), oneExpr, 1, &mm);
+	init_tuple(&next_t, p.base.header->tuple_size, p.base.header->num_attr, &mm);
+	
+	/* The first call takes a whole batch of the scan's tuples. */
+	CuAssertTrue(tc, 1 == next((db_op_base_t*)(&p), &next_t, &mm));
+	CuAssertTrue(tc, 1 < p.batch.count);
+	CuAssertTrue(tc, 1 == p.position);
+	
+	count = 1;
+	sums = getintbypos(&next_t, 0, p.base.header);
+	while (1 == (result = next((db_op_base_t*)(&p), &next_t, &mm)))
+	{
+		sums += getintbypos(&next_t, 0, p.base.header);
+		count++;
+	}
+	printf("Projected %d tuples one at a time.\n", count);
+	CuAssertTrue(tc, 0 == result);
+	CuAssertTrue(tc, 20 == count);
+	CuAssertTrue(tc, 402 == sums);
+	
+	/* Rewinding part way through drops the tuples left in the batch. */
+	CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)(&p), &mm));
+	CuAssertTrue(tc, 1 == next((db_op_base_t*)(&p), &next_t, &mm));
+	CuAssertTrue(tc, 1 == next((db_op_base_t*)(&p), &next_t, &mm));
+	CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)(&p), &mm));
+	count = 0;
+	while (1 == next((db_op_base_t*)(&p), &next_t, &mm))
+		count++;
+	CuAssertTrue(tc, 20 == count);
+	
+	close_tuple(&next_t, &mm);
+	close_project(&p, &mm);
+	close_scan(&s, &mm);
+	free(oneExpr[0].nodes);
+	puts("*************************************************************");
+}
+
 CuSuite *DBProjectGetSuite()
 {
 	CuSuite *suite = CuSuiteNew();
@@ -437,6 +598,8 @@ CuSuite *DBProjectGetSuite()
 	SUITE_ADD_TEST(suite, test_project_2);
 	SUITE_ADD_TEST(suite, test_project_3);
 	SUITE_ADD_TEST(suite, test_project_4);
+	SUITE_ADD_TEST(suite, test_project_5);
+	SUITE_ADD_TEST(suite, test_project_6);
 	
 	return suite;
 }
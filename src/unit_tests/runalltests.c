@@ -24,11 +24,16 @@
 
 /*CuSuite *DBAggregateGetSuite();
 CuSuite *DBQueryMMGetSuite();
+CuSuite *DBStorageGetSuite();
+CuSuite *DBIndexGetSuite();
 CuSuite *LexerGetSuite();
 CuSuite *DBParseExprGetSuite();
 CuSuite *DBEETGetSuite();
 CuSuite *DBNTJoinGetSuite();
 CuSuite *DBOSIJoinGetSuite();
+CuSuite *DBHashJoinGetSuite();
+CuSuite *DBSMJoinGetSuite();
+CuSuite *DBBNLJoinGetSuite();
 CuSuite *DBProjectGetSuite();
 CuSuite *DBScanGetSuite();
 CuSuite *DBSelectGetSuite();
@@ -41,11 +46,16 @@ void runAllTests(void) {
   // Create suites from other tests.
   // CuSuite *agg_suite = DBAggregateGetSuite();
   CuSuite *dbqmm_suite = DBQueryMMGetSuite();
+  CuSuite *dbstorage_suite = DBStorageGetSuite();
+  CuSuite *dbindex_suite = DBIndexGetSuite();
   CuSuite *lex_suite = LexerGetSuite();
   CuSuite *dbparseexpr_suite = DBParseExprGetSuite();
   CuSuite *eet_suite = DBEETGetSuite();
   CuSuite *ntjoin_suite = DBNTJoinGetSuite();
   CuSuite *osijoin_suite = DBOSIJoinGetSuite();
+  CuSuite *hashjoin_suite = DBHashJoinGetSuite();
+  CuSuite *smjoin_suite = DBSMJoinGetSuite();
+  CuSuite *bnljoin_suite = DBBNLJoinGetSuite();
   CuSuite *project_suite = DBProjectGetSuite();
   CuSuite *scan_suite = DBScanGetSuite();
   CuSuite *select_suite = DBSelectGetSuite();
@@ -53,11 +63,16 @@ void runAllTests(void) {
 
   // CuSuiteAddSuite(suite, agg_suite);
   CuSuiteAddSuite(suite, dbqmm_suite);
+  CuSuiteAddSuite(suite, dbstorage_suite);
+  CuSuiteAddSuite(suite, dbindex_suite);
   CuSuiteAddSuite(suite, lex_suite);
   CuSuiteAddSuite(suite, dbparseexpr_suite);
   CuSuiteAddSuite(suite, eet_suite);
   CuSuiteAddSuite(suite, ntjoin_suite);
   CuSuiteAddSuite(suite, osijoin_suite);
+  CuSuiteAddSuite(suite, hashjoin_suite);
+  CuSuiteAddSuite(suite, smjoin_suite);
+  CuSuiteAddSuite(suite, bnljoin_suite);
   CuSuiteAddSuite(suite, project_suite);
   CuSuiteAddSuite(suite, scan_suite);
   CuSuiteAddSuite(suite, select_suite);
@@ -70,11 +85,16 @@ void runAllTests(void) {
 
   // CuSuiteDelete(agg_suite);
   CuSuiteDelete(dbqmm_suite);
+  CuSuiteDelete(dbstorage_suite);
+  CuSuiteDelete(dbindex_suite);
   CuSuiteDelete(lex_suite);
   CuSuiteDelete(dbparseexpr_suite);
   CuSuiteDelete(eet_suite);
   CuSuiteDelete(ntjoin_suite);
   CuSuiteDelete(osijoin_suite);
+  CuSuiteDelete(hashjoin_suite);
+  CuSuiteDelete(smjoin_suite);
+  CuSuiteDelete(bnljoin_suite);
   CuSuiteDelete(project_suite);
   CuSuiteDelete(scan_suite);
   CuSuiteDelete(select_suite);
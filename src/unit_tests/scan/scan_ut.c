@@ -20,6 +20,8 @@
 /* The unit tests for scan operator. */
 #include "../../dbmacros.h"
 #include "../../dbops/scan.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
 #include "../CuTest.h"
 #include <stdio.h>
 #include <string.h>
@@ -301,6 +303,64 @@ void test_scan_4(CuTest *tc) {
   puts("*************************************************************");
 }
 
+#if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
+    1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
+/* Append a live tuple to scan_growing. */
+static void scan_ut_append(db_int a) {
+  db_fileref_t relation = db_openappendfile("scan_growing");
+  unsigned char isnull = 0;
+  db_int deleted = 0;
+  db_filewrite(relation, &isnull, 1);
+  db_filewrite(relation, &a, sizeof(db_int));
+  db_filewrite(relation, &deleted, sizeof(db_int));
+  db_fileclose(relation);
+}
+
+void test_scan_5(CuTest *tc) {
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  scan_t s;
+  db_tuple_t next;
+
+  puts("*************************************************************");
+  puts("Testing scanning of a relation that grows while it is scanned.\n");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE scan_growing (a INT);", &mm));
+  scan_ut_append(1);
+  scan_ut_append(2);
+
+  CuAssertTrue(tc, 1 == init_scan(&s, "scan_growing", &mm));
+#if DB_CTCONF_SETTING_FEATURE_MMAP
+  CuAssertTrue(tc, NULL != s.map);
+#endif
+  init_tuple(&next, s.base.header->tuple_size, s.base.header->num_attr, &mm);
+
+  CuAssertTrue(tc, 1 == next_scan(&s, &next, &mm));
+  CuAssertTrue(tc, 1 == getintbypos(&next, 0, s.base.header));
+
+  /* This tuple lands past the end of what was mapped. */
+  scan_ut_append(3);
+
+  CuAssertTrue(tc, 1 == next_scan(&s, &next, &mm));
+  CuAssertTrue(tc, 2 == getintbypos(&next, 0, s.base.header));
+  CuAssertTrue(tc, 1 == next_scan(&s, &next, &mm));
+  CuAssertTrue(tc, 3 == getintbypos(&next, 0, s.base.header));
+  CuAssertTrue(tc, 0 == next_scan(&s, &next, &mm));
+
+  /* Rewinding goes back to the mapping. */
+  CuAssertTrue(tc, 1 == rewind_scan(&s, &mm));
+  CuAssertTrue(tc, 1 == next_scan(&s, &next, &mm));
+  CuAssertTrue(tc, 1 == getintbypos(&next, 0, s.base.header));
+
+  close_tuple(&next, &mm);
+  close_scan(&s, &mm);
+  CuAssertTrue(tc, 1 == db_fileremove("scan_growing"));
+  puts("*************************************************************");
+}
+#endif
+
 CuSuite *DBScanGetSuite() {
   CuSuite *suite = CuSuiteNew();
 
@@ -309,6 +369,10 @@ CuSuite *DBScanGetSuite() {
   SUITE_ADD_TEST(suite, test_scan_2);
   SUITE_ADD_TEST(suite, test_scan_3);
   SUITE_ADD_TEST(suite, test_scan_4);
+#if defined(DB_CTCONF_SETTING_FEATURE_CREATE_TABLE) &&                         \
+    1 == DB_CTCONF_SETTING_FEATURE_CREATE_TABLE
+  SUITE_ADD_TEST(suite, test_scan_5);
+#endif
 
   return suite;
 }
@@ -28,6 +28,7 @@
 #include "../../dbops/scan.h"
 #include "../../dbops/project.h"
 #include "../../dbops/select.h"
+#include "../../dbparser/dbparser.h"
 
 void test_select_0(CuTest *tc)
 {
@@ -581,6 +582,292 @@ void test_select_6(CuTest *tc)
 	puts("********************************************************************************");
 }
 
+void test_select_7(CuTest *tc)
+{
+	/* General variable declaration */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_eet_t eet;
+	db_eetnode_t *arr_p;
+	db_eetnode_t opnode;
+	db_eetnode_attr_t attrnode;
+	attrnode.base.type = DB_EETNODE_ATTR;
+	db_eetnode_dbint_t dbintnode;
+	dbintnode.base.type = DB_EETNODE_CONST_DBINT;
+	db_int intResult, i, count, sum, batchcount, batchsum;
+	scan_t scan;
+	select_t select;
+	db_tuple_t t, bt;
+	db_tuplebatch_t batch;
+	
+	puts("********************************************************************************");
+	puts("Test 8: shuffled_rel, select where 10 < a a batch at a time.");
+	
+	eet.size = (1*sizeof(db_eetnode_dbint_t) + 1*sizeof(db_eetnode_attr_t) + 1*sizeof(db_eetnode_t));
+	eet.nodes = malloc((size_t)eet.size);
+	eet.stack_size = eet.size;
+	arr_p = eet.nodes;
+	
+	dbintnode.integer = 10;
+	*((db_eetnode_dbint_t*)arr_p) = dbintnode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
+	
+	attrnode.pos = 0;
+	attrnode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrnode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	
+	opnode.type = DB_EETNODE_OP_LT;
+	*(arr_p) = opnode;
+	arr_p++;
+	
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_select(&select, &eet, (db_op_base_t*)&scan, &mm);
+	init_tuple(&t, select.base.header->tuple_size, select.base.header->num_attr, &mm);
+	
+	/* First, a tuple at a time. */
+	count = 0;
+	sum = 0;
+	while (1 == next((db_op_base_t*)&select, &t, &mm))
+	{
+		count++;
+		sum += getintbypos(&t, 0, select.base.header);
+	}
+	printf("Selected %d tuples one at a time.\n", count);
+	CuAssertTrue(tc, 10 == count);
+	CuAssertTrue(tc, 153 == sum);
+	close_tuple(&t, &mm);
+	
+	/* Then in batches of seven, which some tuples of every batch fail. */
+	rewind_dbop((db_op_base_t*)&select, &mm);
+	CuAssertTrue(tc, 1 == init_tuplebatch(&batch, 7, select.base.header->tuple_size, select.base.header->num_attr, &mm));
+	batchcount = 0;
+	batchsum = 0;
+	while (1 == (intResult = next_batch((db_op_base_t*)&select, &batch, &mm)))
+	{
+		CuAssertTrue(tc, 0 < batch.count && batch.count <= 7);
+		for (i = 0; i < batch.count; ++i)
+		{
+			viewbatchtuple(&batch, i, &bt);
+			batchcount++;
+			batchsum += getintbypos(&bt, 0, select.base.header);
+		}
+	}
+	printf("Selected %d tuples in batches.\n", batchcount);
+	CuAssertTrue(tc, 0 == intResult);
+	CuAssertTrue(tc, 0 == batch.count);
+	CuAssertTrue(tc, count == batchcount);
+	CuAssertTrue(tc, sum == batchsum);
+	
+	close_tuplebatch(&batch, &mm);
+	close_scan(&scan, &mm);
+	close_select(&select, &mm);
+	free(eet.nodes);
+	puts("********************************************************************************");
+}
+
+void test_select_8(CuTest *tc)
+{
+	/* General variable declaration */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	select_t *selectp;
+	scan_t scan;
+	db_tuple_t t;
+	db_int count, sum, i;
+	db_int offsets[20], values[20];
+	
+	puts("********************************************************************************");
+	puts("Test 9: shuffled_rel, a parsed selection checks its tuples a batch at a time.");
+	
+	rootp = parse("SELECT * FROM shuffled_rel WHERE 10 < a;", &mm);
+	CuAssertTrue(tc, NULL != rootp && DB_SELECT == rootp->type);
+	selectp = (select_t*)rootp;
+	
+	/* The batch is set up along with the plan. */
+	CuAssertTrue(tc, 1 < selectp->batch.capacity);
+	CuAssertTrue(tc, NULL != selectp->batch.rows);
+	CuAssertTrue(tc, NULL != selectp->selected);
+	
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	count = 0;
+	sum = 0;
+	while (1 == next(rootp, &t, &mm))
+	{
+		/* Later tuples are served from the batch the first one came in. */
+		if (0 == count)
+		{
+			CuAssertTrue(tc, 1 < selectp->batch.count);
+			CuAssertTrue(tc, 1 == selectp->position);
+		}
+		CuAssertTrue(tc, count < 20);
+		offsets[count] = t.offset_r;
+		values[count] = getintbypos(&t, 0, rootp->header);
+		sum += values[count];
+		count++;
+	}
+	printf("Selected %d tuples through the parser.\n", count);
+	CuAssertTrue(tc, 10 == count);
+	CuAssertTrue(tc, 153 == sum);
+	close_tuple(&t, &mm);
+	closeexecutiontree(rootp, &mm);
+	
+	/* Each tuple keeps the offset of the record it came from. */
+	init_query_mm(&mm, segment, 3000);
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_tuple(&t, scan.base.header->tuple_size, scan.base.header->num_attr, &mm);
+	i = 0;
+	while (1 == next_scan(&scan, &t, &mm))
+	{
+		if (i < count && offsets[i] == t.offset_r)
+		{
+			CuAssertTrue(tc, values[i] == getintbypos(&t, 0, scan.base.header));
+			i++;
+		}
+	}
+	CuAssertTrue(tc, count == i);
+	
+	close_tuple(&t, &mm);
+	close_scan(&scan, &mm);
+	puts("********************************************************************************");
+}
+
+void test_select_9(CuTest *tc)
+{
+	/* General variable declaration */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_op_base_t *rootp;
+	select_t *selectp;
+	db_eetnode_t *cursor, *comparison;
+	db_tuple_t t;
+	db_int count, sum;
+	
+	puts("********************************************************************************");
+	puts("Test 10: shuffled_rel, a string predicate is checked through its program.");
+	
+	rootp = parse("SELECT * FROM shuffled_rel WHERE LENGTH(b) > 10;", &mm);
+	CuAssertTrue(tc, NULL != rootp && DB_SELECT == rootp->type);
+	selectp = (select_t*)rootp;
+	CuAssertTrue(tc, NULL != selectp->prog.code);
+	
+	/* Turn the tree's comparison around.  Only the program still asks for
+	   the longer strings. */
+	cursor = selectp->tree->nodes;
+	comparison = NULL;
+	while (POINTERBYTEDIST(cursor, selectp->tree->nodes) < selectp->tree->size)
+	{
+		if (DB_EETNODE_OP_GT == cursor->type)
+			comparison = cursor;
+		advanceeetnodepointer(&cursor, 1);
+	}
+	CuAssertTrue(tc, NULL != comparison);
+	comparison->type = DB_EETNODE_OP_LTE;
+	
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	count = 0;
+	sum = 0;
+	while (1 == next(rootp, &t, &mm))
+	{
+		count++;
+		sum += getintbypos(&t, 0, rootp->header);
+	}
+	printf("Selected %d tuples through the program.\n", count);
+	CuAssertTrue(tc, 2 == count);
+	CuAssertTrue(tc, 14 == sum);
+	
+	close_tuple(&t, &mm);
+	closeexecutiontree(rootp, &mm);
+	puts("********************************************************************************");
+}
+
+void test_select_10(CuTest *tc)
+{
+	/* General variable declaration */
+	db_query_mm_t mm;
+	char segment[3000];
+	init_query_mm(&mm, segment, 3000);
+	
+	db_eet_t eet;
+	db_eetnode_t *arr_p;
+	db_eetnode_t opnode;
+	db_eetnode_attr_t attrnode;
+	attrnode.base.type = DB_EETNODE_ATTR;
+	db_eetnode_dbint_t dbintnode;
+	dbintnode.base.type = DB_EETNODE_CONST_DBINT;
+	db_int retval, result, count, sum, expectedcount, expectedsum;
+	scan_t scan;
+	select_t select;
+	db_tuple_t t;
+	db_tuple_t *tp = &t;
+	relation_header_t *hp;
+	
+	puts("********************************************************************************");
+	puts("Test 11: shuffled_rel, select where a XOR 2 passes what evaluate_eet does.");
+	
+	eet.size = (1*sizeof(db_eetnode_dbint_t) + 1*sizeof(db_eetnode_attr_t) + 1*sizeof(db_eetnode_t));
+	eet.nodes = malloc((size_t)eet.size);
+	eet.stack_size = eet.size;
+	arr_p = eet.nodes;
+	
+	attrnode.pos = 0;
+	attrnode.tuple_pos = 0;
+	*((db_eetnode_attr_t*)arr_p) = attrnode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_attr_t*)arr_p)+1));
+	
+	dbintnode.integer = 2;
+	*((db_eetnode_dbint_t*)arr_p) = dbintnode;
+	arr_p = ((db_eetnode_t*)(((db_eetnode_dbint_t*)arr_p)+1));
+	
+	opnode.type = DB_EETNODE_OP_XOR;
+	*(arr_p) = opnode;
+	arr_p++;
+	
+	/* First, every tuple is checked on its own. */
+	init_scan(&scan, "shuffled_rel", &mm);
+	hp = scan.base.header;
+	init_tuple(&t, hp->tuple_size, hp->num_attr, &mm);
+	expectedcount = 0;
+	expectedsum = 0;
+	while (1 == next_scan(&scan, &t, &mm))
+	{
+		retval = evaluate_eet(&eet, &result, &tp, &hp, 0, &mm);
+		if (1 == retval && 1 == result)
+		{
+			expectedcount++;
+			expectedsum += getintbypos(&t, 0, hp);
+		}
+	}
+	CuAssertTrue(tc, 19 == expectedcount);
+	
+	/* Then the selection checks them a batch at a time. */
+	rewind_dbop((db_op_base_t*)&scan, &mm);
+	init_select(&select, &eet, (db_op_base_t*)&scan, &mm);
+	count = 0;
+	sum = 0;
+	while (1 == next_select(&select, &t, &mm))
+	{
+		count++;
+		sum += getintbypos(&t, 0, hp);
+	}
+	printf("Selected %d tuples, %d expected.\n", count, expectedcount);
+	CuAssertTrue(tc, expectedcount == count);
+	CuAssertTrue(tc, expectedsum == sum);
+	
+	close_select(&select, &mm);
+	close_tuple(&t, &mm);
+	close_scan(&scan, &mm);
+	free(eet.nodes);
+	puts("********************************************************************************");
+}
+
 CuSuite *DBSelectGetSuite()
 {
 	CuSuite *suite = CuSuiteNew();
@@ -592,6 +879,10 @@ CuSuite *DBSelectGetSuite()
 	SUITE_ADD_TEST(suite, test_select_4);
 	SUITE_ADD_TEST(suite, test_select_5);
 	SUITE_ADD_TEST(suite, test_select_6);
+	SUITE_ADD_TEST(suite, test_select_7);
+	SUITE_ADD_TEST(suite, test_select_8);
+	SUITE_ADD_TEST(suite, test_select_9);
+	SUITE_ADD_TEST(suite, test_select_10);
 	
 	return suite;
 }
@@ -0,0 +1,657 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dblogic/compare_tuple.h"
+#include "../../dblogic/eet.h"
+#include "../../dbmacros.h"
+#include "../../dbobjects/relation.h"
+#include "../../dbobjects/tuple.h"
+#include "../../dbops/db_ops.h"
+#include "../../dbops/smjoin.h"
+#include "../../dbops/scan.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Build the condition "bare >= bound - width AND bare <= bound + width",
+   where bare is the first attribute of the tuple at bareside and bound the
+   first attribute of the other. */
+static void smjoin_ut_band(db_eet_t *eetp, db_uint8 bareside, db_int width) {
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  db_eetnode_dbint_t intnode;
+  db_int i;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  attrnode.pos = 0;
+  intnode.base.type = DB_EETNODE_CONST_DBINT;
+  intnode.integer = width;
+
+  eetp->size = (4 * sizeof(db_eetnode_attr_t) + 2 * sizeof(db_eetnode_dbint_t) +
+                5 * sizeof(db_eetnode_t));
+  eetp->nodes = malloc((size_t)eetp->size);
+  eetp->stack_size = eetp->size;
+  arr_p = eetp->nodes;
+
+  for (i = 0; i < 2; ++i) {
+    attrnode.tuple_pos = bareside;
+    *((db_eetnode_attr_t *)arr_p) = attrnode;
+    arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+    attrnode.tuple_pos = 1 - bareside;
+    *((db_eetnode_attr_t *)arr_p) = attrnode;
+    arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+    *((db_eetnode_dbint_t *)arr_p) = intnode;
+    arr_p = ((db_eetnode_t *)(((db_eetnode_dbint_t *)arr_p) + 1));
+
+    opnode.type = 0 == i ? DB_EETNODE_OP_SUB : DB_EETNODE_OP_ADD;
+    *(arr_p) = opnode;
+    arr_p++;
+
+    opnode.type = 0 == i ? DB_EETNODE_OP_GTE : DB_EETNODE_OP_LTE;
+    *(arr_p) = opnode;
+    arr_p++;
+  }
+
+  opnode.type = DB_EETNODE_OP_AND;
+  *(arr_p) = opnode;
+  arr_p++;
+}
+
+/* Build the condition "left = right" over attributes at the given
+   positions. */
+static void smjoin_ut_equi(db_eet_t *eetp, db_uint8 lpos, db_uint8 rpos) {
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+
+  eetp->size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eetp->nodes = malloc((size_t)eetp->size);
+  eetp->stack_size = eetp->size;
+  arr_p = eetp->nodes;
+
+  attrnode.pos = lpos;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = rpos;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_EQ;
+  *(arr_p) = opnode;
+  arr_p++;
+}
+
+/* Build the expression for sorting on the attribute at pos. */
+static void smjoin_ut_sortexpr(db_eet_t *eetp, db_uint8 pos) {
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  attrnode.pos = pos;
+  attrnode.tuple_pos = 0;
+
+  eetp->size = sizeof(db_eetnode_attr_t);
+  eetp->nodes = malloc((size_t)eetp->size);
+  eetp->stack_size = eetp->size;
+  *((db_eetnode_attr_t *)(eetp->nodes)) = attrnode;
+}
+
+void test_smjoin_1(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet, sortexpr;
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  db_int intResult, i, j;
+  char *strResult;
+  scan_t lscan, rscan;
+  sort_t rsort;
+  smjoin_t smjoin;
+  db_tuple_t t;
+  db_int expectedIds[] = {2, 3, 5};
+  char *expectedNames[] = {"Orange", "Pear", "Lime"};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: Merge join indexed fruit_stock_1 with sorted fruit_stock_2 on "
+       "id.");
+
+  smjoin_ut_equi(&eet, 0, 0);
+  smjoin_ut_sortexpr(&sortexpr, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  init_sort(&rsort, (db_op_base_t *)&rscan, &sortexpr, 1, &order, &mm);
+  CuAssertTrue(tc, 1 == isorderedon((db_op_base_t *)&lscan, 0));
+  CuAssertTrue(tc, 0 == isorderedon((db_op_base_t *)&lscan, 1));
+  CuAssertTrue(tc, 0 == isorderedon((db_op_base_t *)&rscan, 0));
+  CuAssertTrue(tc, 1 == isorderedon((db_op_base_t *)&rsort, 0));
+
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lscan,
+                          (db_op_base_t *)&rsort, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, DB_SMJOIN == smjoin.base.type);
+  init_tuple(&t, smjoin.base.header->tuple_size, smjoin.base.header->num_attr,
+             &mm);
+
+  /* Carry out test, twice to make sure rewinding works. */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < 3; ++i) {
+      intResult = next((db_op_base_t *)&smjoin, &t, &mm);
+      CuAssertTrue(tc, 1 == intResult);
+      intResult = getintbypos(&t, 0, smjoin.base.header);
+      printf("The db_int value at position %d in the returned tuple is: %d\n",
+             0, intResult);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      intResult = getintbypos(&t, 5, smjoin.base.header);
+      CuAssertTrue(tc, expectedIds[i] == intResult);
+      strResult = getstringbypos(&t, 1, smjoin.base.header);
+      printf("The string value at position %d in the returned tuple is: %s\n",
+             1, strResult);
+      CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+    }
+
+    intResult = next((db_op_base_t *)&smjoin, &t, &mm);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&smjoin, &mm));
+  }
+
+  close((db_op_base_t *)&smjoin, &mm);
+  close_sort(&rsort, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(sortexpr.nodes);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_2(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet, lsortexpr, rsortexpr;
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  db_int intResult, i;
+  char *strResult;
+  scan_t lscan, rscan;
+  sort_t lsort, rsort;
+  smjoin_t smjoin;
+  db_tuple_t t;
+  char *expectedNames[] = {"Lemon", "Lime", "Orange"};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Merge join fruit_stock_2 with fruit_stock_1 on name.");
+
+  smjoin_ut_equi(&eet, 1, 1);
+  smjoin_ut_sortexpr(&lsortexpr, 1);
+  smjoin_ut_sortexpr(&rsortexpr, 1);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "fruit_stock_2", &mm);
+  init_scan(&rscan, "fruit_stock_1", &mm);
+  init_sort(&lsort, (db_op_base_t *)&lscan, &lsortexpr, 1, &order, &mm);
+  init_sort(&rsort, (db_op_base_t *)&rscan, &rsortexpr, 1, &order, &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lsort,
+                          (db_op_base_t *)&rsort, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, DB_SMJOIN == smjoin.base.type);
+  init_tuple(&t, smjoin.base.header->tuple_size, smjoin.base.header->num_attr,
+             &mm);
+
+  /* The NULL names of fruit_stock_2 join nothing. */
+  for (i = 0; i < 3; ++i) {
+    intResult = next((db_op_base_t *)&smjoin, &t, &mm);
+    CuAssertTrue(tc, 1 == intResult);
+    strResult = getstringbypos(&t, 1, smjoin.base.header);
+    printf("The string value at position %d in the returned tuple is: %s\n", 1,
+           strResult);
+    CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+    strResult = getstringbypos(&t, 6, smjoin.base.header);
+    CuAssertTrue(tc, 0 == strcmp(strResult, expectedNames[i]));
+  }
+
+  intResult = next((db_op_base_t *)&smjoin, &t, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+
+  close((db_op_base_t *)&smjoin, &mm);
+  close_sort(&rsort, &mm);
+  close_sort(&lsort, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(rsortexpr.nodes);
+  free(lsortexpr.nodes);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_3(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_eetnode_t *arr_p;
+  db_eetnode_t opnode;
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  db_int intResult;
+  scan_t lscan, rscan;
+  smjoin_t smjoin;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: Sort-merge joins need ordered inputs and bounded keys.");
+
+  /* Neither input is ordered on the join attribute. */
+  smjoin_ut_equi(&eet, 2, 2);
+  init_scan(&lscan, "fruit_stock_1", &mm);
+  init_scan(&rscan, "fruit_stock_2", &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lscan,
+                          (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, DB_NTJOIN == smjoin.base.type);
+  close((db_op_base_t *)&smjoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  free(eet.nodes);
+
+  /* Both inputs are ordered, but there is no upper bound. */
+  eet.size = (2 * sizeof(db_eetnode_attr_t) + 1 * sizeof(db_eetnode_t));
+  eet.nodes = malloc((size_t)eet.size);
+  eet.stack_size = eet.size;
+  arr_p = eet.nodes;
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 0;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  attrnode.pos = 0;
+  attrnode.tuple_pos = 1;
+  *((db_eetnode_attr_t *)arr_p) = attrnode;
+  arr_p = ((db_eetnode_t *)(((db_eetnode_attr_t *)arr_p) + 1));
+
+  opnode.type = DB_EETNODE_OP_GTE;
+  *(arr_p) = opnode;
+  arr_p++;
+
+  init_scan(&lscan, "test_rel3", &mm);
+  init_scan(&rscan, "fruit_stock_1", &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lscan,
+                          (db_op_base_t *)&rscan, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, DB_NTJOIN == smjoin.base.type);
+  close((db_op_base_t *)&smjoin, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_4(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[5000];
+  init_query_mm(&mm, segment, 5000);
+
+  db_eet_t eet, lsortexpr, rsortexpr;
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  db_int intResult, i, j, count, sum, previous;
+  scan_t lscan, rscan;
+  sort_t lsort, rsort;
+  smjoin_t smjoin;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: Merge join shuffled_rel with itself, with duplicates on both "
+       "sides.");
+
+  smjoin_ut_equi(&eet, 0, 0);
+  smjoin_ut_sortexpr(&lsortexpr, 0);
+  smjoin_ut_sortexpr(&rsortexpr, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "shuffled_rel", &mm);
+  init_scan(&rscan, "shuffled_rel", &mm);
+  init_sort(&lsort, (db_op_base_t *)&lscan, &lsortexpr, 1, &order, &mm);
+  init_sort(&rsort, (db_op_base_t *)&rscan, &rsortexpr, 1, &order, &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lsort,
+                          (db_op_base_t *)&rsort, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, smjoin.base.header->tuple_size, smjoin.base.header->num_attr,
+             &mm);
+
+  /* Each of the 18 distinct values joins with itself, but the duplicated 3
+     and 11 each join four times.  The result comes out in order. */
+  for (j = 0; j < 2; ++j) {
+    count = 0;
+    sum = 0;
+    previous = 0;
+    while (1 == (intResult = next((db_op_base_t *)&smjoin, &t, &mm))) {
+      i = getintbypos(&t, 0, smjoin.base.header);
+      CuAssertTrue(tc, i == getintbypos(&t, 3, smjoin.base.header));
+      CuAssertTrue(tc, previous <= i);
+      previous = i;
+      count++;
+      sum += i;
+    }
+    printf("Joined %d tuples.\n", count);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 24 == count);
+    CuAssertTrue(tc, 210 - 10 - 13 + 3 * 3 + 11 * 3 == sum);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&smjoin, &mm));
+  }
+
+  close((db_op_base_t *)&smjoin, &mm);
+  close_sort(&rsort, &mm);
+  close_sort(&lsort, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(rsortexpr.nodes);
+  free(lsortexpr.nodes);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_5(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[5000];
+  init_query_mm(&mm, segment, 5000);
+
+  db_eet_t eet, lsortexpr, rsortexpr;
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  db_int intResult, l, r, count, lsum, rsum;
+  scan_t lscan, rscan;
+  sort_t lsort, rsort;
+  smjoin_t smjoin;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 5: Band join shuffled_rel with itself, within 1.");
+
+  /* shuffled_rel.a >= shuffled_rel.a - 1 AND ... <= ... + 1, where the lone
+     attributes are from the left input. */
+  smjoin_ut_band(&eet, 0, 1);
+  smjoin_ut_sortexpr(&lsortexpr, 0);
+  smjoin_ut_sortexpr(&rsortexpr, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "shuffled_rel", &mm);
+  init_scan(&rscan, "shuffled_rel", &mm);
+  init_sort(&lsort, (db_op_base_t *)&lscan, &lsortexpr, 1, &order, &mm);
+  init_sort(&rsort, (db_op_base_t *)&rscan, &rsortexpr, 1, &order, &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lsort,
+                          (db_op_base_t *)&rsort, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  /* The right input drives, the left is windowed. */
+  CuAssertTrue(tc, 0 == smjoin.windowright);
+  init_tuple(&t, smjoin.base.header->tuple_size, smjoin.base.header->num_attr,
+             &mm);
+
+  count = 0;
+  lsum = 0;
+  rsum = 0;
+  while (1 == (intResult = next((db_op_base_t *)&smjoin, &t, &mm))) {
+    l = getintbypos(&t, 0, smjoin.base.header);
+    r = getintbypos(&t, 3, smjoin.base.header);
+    CuAssertTrue(tc, l >= r - 1 && l <= r + 1);
+    count++;
+    lsum += l;
+    rsum += r;
+  }
+  printf("Joined %d tuples.\n", count);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 60 == count);
+  CuAssertTrue(tc, 571 == lsum);
+  CuAssertTrue(tc, 571 == rsum);
+
+  close((db_op_base_t *)&smjoin, &mm);
+  close_sort(&rsort, &mm);
+  close_sort(&lsort, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(rsortexpr.nodes);
+  free(lsortexpr.nodes);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_6(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[5000];
+  init_query_mm(&mm, segment, 5000);
+
+  db_eet_t eet, lsortexpr, rsortexpr;
+  db_uint8 order = DB_TUPLE_ORDER_ASC;
+  db_int intResult, j, l, r, count, lsum, rsum, recsize;
+  scan_t lscan, rscan;
+  sort_t lsort, rsort;
+  smjoin_t smjoin;
+  db_tuple_t t;
+  char tempname[12];
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 6: Band join shuffled_rel with itself, within 10, with very "
+       "little memory.");
+
+  smjoin_ut_band(&eet, 1, 10);
+  smjoin_ut_sortexpr(&lsortexpr, 0);
+  smjoin_ut_sortexpr(&rsortexpr, 0);
+
+  /* Build up query tree. */
+  init_scan(&lscan, "shuffled_rel", &mm);
+  init_scan(&rscan, "shuffled_rel", &mm);
+  init_sort(&lsort, (db_op_base_t *)&lscan, &lsortexpr, 1, &order, &mm);
+  init_sort(&rsort, (db_op_base_t *)&rscan, &rsortexpr, 1, &order, &mm);
+  intResult = init_smjoin(&smjoin, &eet, (db_op_base_t *)&lsort,
+                          (db_op_base_t *)&rsort, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, 1 == smjoin.windowright);
+  init_tuple(&t, smjoin.base.header->tuple_size, smjoin.base.header->num_attr,
+             &mm);
+
+  /* Have both sorts done before leaving only enough memory to hold three
+     tuples of the window at a time, forcing it onto storage. */
+  CuAssertTrue(tc, 1 == next((db_op_base_t *)&rsort, &t, &mm));
+  CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&rsort, &mm));
+  recsize =
+      rscan.base.header->tuple_size + (rscan.base.header->num_attr + 7) / 8;
+  void *filler = db_qmm_balloc(
+      &mm, POINTERBYTEDIST(mm.last_back, mm.next_front) - sizeof(db_int) -
+               DB_CTCONF_SETTING_OPERATOR_RESERVE - eet.stack_size -
+               smjoin.keyexpr->stack_size - smjoin.lowexpr->stack_size -
+               smjoin.highexpr->stack_size - sizeof(db_int) - 4 * recsize);
+  CuAssertTrue(tc, NULL != filler);
+
+  for (j = 0; j < 2; ++j) {
+    count = 0;
+    lsum = 0;
+    rsum = 0;
+    while (1 == (intResult = next((db_op_base_t *)&smjoin, &t, &mm))) {
+      l = getintbypos(&t, 0, smjoin.base.header);
+      r = getintbypos(&t, 3, smjoin.base.header);
+      CuAssertTrue(tc, r >= l - 10 && r <= l + 10);
+      count++;
+      lsum += l;
+      rsum += r;
+    }
+    printf("Joined %d tuples holding %d in memory.\n", count,
+           (int)smjoin.capacity);
+    CuAssertTrue(tc, 0 == intResult);
+    CuAssertTrue(tc, 300 == count);
+    CuAssertTrue(tc, 2964 == lsum);
+    CuAssertTrue(tc, 2964 == rsum);
+    CuAssertTrue(tc, 3 == smjoin.capacity);
+    CuAssertTrue(tc, DB_STORAGE_NOFILE != smjoin.spill);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&smjoin, &mm));
+  }
+
+  close((db_op_base_t *)&smjoin, &mm);
+  sprintf(tempname, "DB_SMJ_%d", (int)smjoin.smid);
+  CuAssertTrue(tc, 1 != db_fileexists(tempname));
+
+  db_qmm_bfree(&mm, filler);
+  close_sort(&rsort, &mm);
+  close_sort(&lsort, &mm);
+  close_scan(&lscan, &mm);
+  close_scan(&rscan, &mm);
+  close_tuple(&t, &mm);
+  free(rsortexpr.nodes);
+  free(lsortexpr.nodes);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_7(CuTest *tc) {
+  char command[] = "SELECT * FROM test_rel3, fruit_stock_1 WHERE "
+                   "test_rel3.A1 = fruit_stock_1.id AND "
+                   "test_rel3.__delete = 0 AND fruit_stock_1.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 7: The parser plans a join of two indexed relations as a merge.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc, 0 == strcmp("+SMJOIN\n++SCAN\n++SCAN\n", output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc, 1 == getintbypos(&t, 0, rootp->header));
+    CuAssertTrue(tc,
+                 0 == strcmp("Apple", getstringbypos(&t, 5, rootp->header)));
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 1 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_smjoin_8(CuTest *tc) {
+  char command[] = "SELECT fruit_stock_1.name, test_rel3.a2 FROM test_rel3, "
+                   "fruit_stock_1 WHERE test_rel3.A1 = fruit_stock_1.id AND "
+                   "test_rel3.__delete = 0 AND fruit_stock_1.__delete = 0;";
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, count = 0;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 8: Attributes can be projected out of a merge join.");
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc,
+               0 == strcmp("+PROJECT\n++SMJOIN\n+++SCAN\n+++SCAN\n", output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  while (1 == (intResult = next(rootp, &t, &mm))) {
+    CuAssertTrue(tc,
+                 0 == strcmp("Apple", getstringbypos(&t, 0, rootp->header)));
+    CuAssertTrue(tc, 0 == strcmp("Hi", getstringbypos(&t, 1, rootp->header)));
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 1 == count);
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+  puts("***********************************************************************"
+       "*********");
+}
+
+CuSuite *DBSMJoinGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_smjoin_1);
+  SUITE_ADD_TEST(suite, test_smjoin_2);
+  SUITE_ADD_TEST(suite, test_smjoin_3);
+  SUITE_ADD_TEST(suite, test_smjoin_4);
+  SUITE_ADD_TEST(suite, test_smjoin_5);
+  SUITE_ADD_TEST(suite, test_smjoin_6);
+  SUITE_ADD_TEST(suite, test_smjoin_7);
+  SUITE_ADD_TEST(suite, test_smjoin_8);
+
+  return suite;
+}
+
+void runAllTests_smjoin() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBSMJoinGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
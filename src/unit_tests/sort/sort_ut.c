@@ -29,6 +29,10 @@
 #include "../../dbops/project.h"
 #include "../../dbops/select.h"
 #include "../../dbops/sort.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../../dbmacros.h"
+#include "../../db_ctconf.h"
 
 void test_sort_1(CuTest *tc)
 {
@@ -1038,6 +1042,268 @@ void test_sort_12(CuTest *tc)
 	*/
 }
 
+void test_sort_13(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	scan_t scan;
+	sort_t sort;
+	db_tuple_t t;
+	db_eet_t oneExpr[1];
+	db_uint8 oneOrder[1];
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	db_int intResult, i, j, previous;
+	char tempname[16];
+	
+	puts("**********************************************************************");
+	puts("Test 13: Sort shuffled_rel on first attribute with very little memory.");
+	fflush(stdout);
+	
+	oneExpr[0].size = (1*sizeof(db_eetnode_attr_t) + 0*sizeof(db_eetnode_dbint_t));
+	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
+	oneExpr[0].stack_size = oneExpr[0].size;
+	oneOrder[0] = (db_uint8)DB_TUPLE_ORDER_ASC;
+	
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	(*((db_eetnode_attr_t*)(oneExpr[0].nodes))) = attrNode;
+	
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_sort(&sort, (db_op_base_t*)(&scan), oneExpr, 1, oneOrder, &mm);
+	init_tuple(&t, sort.base.header->tuple_size, sort.base.header->num_attr, &mm);
+	
+	/* Leave only enough memory to hold two tuples at a time, and to merge
+	   two runs at a time, forcing several merge passes. */
+	void *filler = db_qmm_balloc(&mm,
+		POINTERBYTEDIST(mm.last_back, mm.next_front) - sizeof(db_int) -
+		DB_CTCONF_SETTING_OPERATOR_RESERVE - oneExpr[0].stack_size - 150);
+	CuAssertTrue(tc, NULL != filler);
+	
+	for (j = 0; j < 2; ++j)
+	{
+		previous = -1;
+		for (i = 0; i < 20; ++i)
+		{
+			intResult = next((db_op_base_t*)&sort, &t, &mm);
+			CuAssertTrue(tc, 1 == intResult);
+			intResult = getintbypos(&t, 0, sort.base.header);
+			CuAssertTrue(tc, previous <= intResult);
+			/* Ties are broken on the remaining attributes. */
+			if (3 == intResult && 3 == previous)
+				CuAssertTrue(tc, 0 == strcmp("three", getstringbypos(&t, 1, sort.base.header)));
+			previous = intResult;
+		}
+		CuAssertTrue(tc, 20 == previous);
+		
+		intResult = next((db_op_base_t*)&sort, &t, &mm);
+		CuAssertTrue(tc, 0 == intResult);
+		
+		CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)&sort, &mm));
+	}
+	
+	close((db_op_base_t*)&sort, &mm);
+	sprintf(tempname, "DB_SORT_%d_0", (int)sort.sortid);
+	CuAssertTrue(tc, 1 != db_fileexists(tempname));
+	sprintf(tempname, "DB_SORT_%d_1", (int)sort.sortid);
+	CuAssertTrue(tc, 1 != db_fileexists(tempname));
+	
+	db_qmm_bfree(&mm, filler);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	free(oneExpr[0].nodes);
+	puts("**********************************************************************");
+}
+
+void test_sort_14(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	scan_t scan;
+	sort_t sort;
+	db_tuple_t t;
+	db_eet_t oneExpr[1];
+	db_uint8 oneOrder[1];
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	db_int intResult;
+	
+	puts("**********************************************************************");
+	puts("Test 14: Sort shuffled_rel without enough memory to merge.");
+	fflush(stdout);
+	
+	oneExpr[0].size = (1*sizeof(db_eetnode_attr_t) + 0*sizeof(db_eetnode_dbint_t));
+	oneExpr[0].nodes = malloc((size_t)oneExpr[0].size);
+	oneExpr[0].stack_size = oneExpr[0].size;
+	oneOrder[0] = (db_uint8)DB_TUPLE_ORDER_DESC;
+	
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	(*((db_eetnode_attr_t*)(oneExpr[0].nodes))) = attrNode;
+	
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_sort(&sort, (db_op_base_t*)(&scan), oneExpr, 1, oneOrder, &mm);
+	init_tuple(&t, sort.base.header->tuple_size, sort.base.header->num_attr, &mm);
+	
+	void *filler = db_qmm_balloc(&mm,
+		POINTERBYTEDIST(mm.last_back, mm.next_front) - sizeof(db_int) -
+		DB_CTCONF_SETTING_OPERATOR_RESERVE - oneExpr[0].stack_size - 60);
+	CuAssertTrue(tc, NULL != filler);
+	
+	intResult = next((db_op_base_t*)&sort, &t, &mm);
+	CuAssertTrue(tc, -1 == intResult);
+	
+	close((db_op_base_t*)&sort, &mm);
+	db_qmm_bfree(&mm, filler);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	free(oneExpr[0].nodes);
+	puts("**********************************************************************");
+}
+
+void test_sort_15(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[2000];
+	init_query_mm(&mm, segment, 2000);
+	
+	scan_t scan;
+	sort_t sort;
+	db_tuple_t t;
+	db_eet_t twoExpr[2];
+	db_uint8 twoOrder[2];
+	db_eetnode_attr_t attrNode;
+	attrNode.base.type = DB_EETNODE_ATTR;
+	db_eetnode_dbint_t intNode;
+	intNode.base.type = DB_EETNODE_CONST_DBINT;
+	db_eetnode_t opNode;
+	opNode.type = DB_EETNODE_OP_MULT;
+	db_int intResult, i, j;
+	db_int expectedInts[] = {20, 19, 18, 17, 16, 15, 14, 12, 11, 11, 9, 8, 7,
+				6, 5, 4, 3, 3, 2, 1};
+	char *strResult;
+	
+	puts("**********************************************************************");
+	puts("Test 15: Sort shuffled_rel on a*-1 ascending, then b descending.");
+	fflush(stdout);
+	
+	twoExpr[0].size = (1*sizeof(db_eetnode_attr_t) + 1*sizeof(db_eetnode_dbint_t) + 1*sizeof(db_eetnode_t));
+	twoExpr[0].nodes = malloc((size_t)twoExpr[0].size);
+	twoExpr[0].stack_size = twoExpr[0].size;
+	twoOrder[0] = (db_uint8)DB_TUPLE_ORDER_ASC;
+	
+	attrNode.pos = 0;
+	attrNode.tuple_pos = 0;
+	intNode.integer = -1;
+	(*((db_eetnode_attr_t*)(twoExpr[0].nodes))) = attrNode;
+	(*((db_eetnode_dbint_t*)(((db_eetnode_attr_t*)(twoExpr[0].nodes)) + 1))) = intNode;
+	(*((db_eetnode_t*)(((db_eetnode_dbint_t*)(((db_eetnode_attr_t*)(twoExpr[0].nodes)) + 1)) + 1))) = opNode;
+	
+	twoExpr[1].size = (1*sizeof(db_eetnode_attr_t) + 0*sizeof(db_eetnode_dbint_t));
+	twoExpr[1].nodes = malloc((size_t)twoExpr[1].size);
+	twoExpr[1].stack_size = twoExpr[1].size;
+	twoOrder[1] = (db_uint8)DB_TUPLE_ORDER_DESC;
+	
+	attrNode.pos = 1;
+	(*((db_eetnode_attr_t*)(twoExpr[1].nodes))) = attrNode;
+	
+	init_scan(&scan, "shuffled_rel", &mm);
+	init_sort(&sort, (db_op_base_t*)(&scan), twoExpr, 2, twoOrder, &mm);
+	init_tuple(&t, sort.base.header->tuple_size, sort.base.header->num_attr, &mm);
+	
+	/* Both expressions are put in the sort key. */
+	CuAssertTrue(tc, (db_int)(2 + sizeof(db_int) + sort.base.header->sizes[1]) == sort.keysize);
+	
+	for (j = 0; j < 2; ++j)
+	{
+		for (i = 0; i < 20; ++i)
+		{
+			intResult = next((db_op_base_t*)&sort, &t, &mm);
+			CuAssertTrue(tc, 1 == intResult);
+			intResult = getintbypos(&t, 0, sort.base.header);
+			printf("Int value at position %d the tuple: %d\n", 0, intResult);
+			CuAssertTrue(tc, expectedInts[i] == intResult);
+			strResult = getstringbypos(&t, 1, sort.base.header);
+			if (8 == i)
+				CuAssertTrue(tc, 0 == strcmp("eleven", strResult));
+			else if (9 == i)
+				CuAssertTrue(tc, 0 == strcmp("another eleven", strResult));
+			else if (16 == i)
+				CuAssertTrue(tc, 0 == strcmp("three", strResult));
+			else if (17 == i)
+				CuAssertTrue(tc, 0 == strcmp("another three", strResult));
+		}
+		
+		intResult = next((db_op_base_t*)&sort, &t, &mm);
+		CuAssertTrue(tc, 0 == intResult);
+		
+		CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t*)&sort, &mm));
+	}
+	
+	close((db_op_base_t*)&sort, &mm);
+	close((db_op_base_t*)&scan, &mm);
+	close_tuple(&t, &mm);
+	free(twoExpr[0].nodes);
+	free(twoExpr[1].nodes);
+	puts("**********************************************************************");
+}
+
+void test_sort_16(CuTest *tc)
+{
+	/* General variable declaration. */
+	db_query_mm_t mm;
+	char segment[3000];
+	char command[64];
+	db_tuple_t t;
+	db_int i, intResult, last = -1, count = 0;
+	
+	puts("**********************************************************************");
+	puts("Test 16: A relation sorted through the parser spills to runs.");
+	fflush(stdout);
+	
+	init_query_mm(&mm, segment, 3000);
+	db_fileremove("sort_ut_16");
+	CuAssertTrue(tc, DB_PARSER_OP_NONE == parse("CREATE TABLE sort_ut_16 (a INT, b INT);", &mm));
+	for (i = 0; i < 200; ++i)
+	{
+		init_query_mm(&mm, segment, 3000);
+		sprintf(command, "INSERT INTO sort_ut_16 VALUES (%d, %d);", (i * 37) % 200, i);
+		CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+	}
+	
+	init_query_mm(&mm, segment, 3000);
+	db_op_base_t *rootp = parse("SELECT a, b FROM sort_ut_16 ORDER BY a;", &mm);
+	CuAssertTrue(tc, NULL != rootp);
+	
+	char *output;
+	queryTreeToString(rootp, &output);
+	puts(output);
+	CuAssertTrue(tc, 0 == strcmp("+PROJECT\n++SORT\n+++SELECT\n++++SCAN\n", output));
+	free(output);
+	
+	init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+	while (1 == (intResult = next(rootp, &t, &mm)))
+	{
+		CuAssertTrue(tc, last + 1 == getintbypos(&t, 0, rootp->header));
+		last = getintbypos(&t, 0, rootp->header);
+		count++;
+	}
+	CuAssertTrue(tc, 0 == intResult);
+	CuAssertTrue(tc, 200 == count);
+	
+	close_tuple(&t, &mm);
+	CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+	db_fileremove("sort_ut_16");
+	puts("**********************************************************************");
+}
+
 CuSuite *DBSortGetSuite()
 {
 	CuSuite *suite = CuSuiteNew();
@@ -1054,6 +1320,10 @@ CuSuite *DBSortGetSuite()
 	SUITE_ADD_TEST(suite, test_sort_10);
 	SUITE_ADD_TEST(suite, test_sort_11);
 	SUITE_ADD_TEST(suite, test_sort_12);
+	SUITE_ADD_TEST(suite, test_sort_13);
+	SUITE_ADD_TEST(suite, test_sort_14);
+	SUITE_ADD_TEST(suite, test_sort_15);
+	SUITE_ADD_TEST(suite, test_sort_16);
 	
 	return suite;
 }
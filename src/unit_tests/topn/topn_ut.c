@@ -0,0 +1,405 @@
+/**
+@author		Graeme Douglas
+@brief
+@details
+@copyright	Copyright 2013 Graeme Douglas
+@license	Licensed under the Apache License, Version 2.0 (the "License");
+                you may not use this file except in compliance with the License.
+                You may obtain a copy of the License at
+                        http://www.apache.org/licenses/LICENSE-2.0
+
+@par
+                Unless required by applicable law or agreed to in writing,
+                software distributed under the License is distributed on an
+                "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+                either express or implied. See the License for the specific
+                language governing permissions and limitations under the
+                License.
+*/
+
+#include "../../db_ctconf.h"
+#include "../../dblogic/compare_tuple.h"
+#include "../../dblogic/eet.h"
+#include "../../dbmacros.h"
+#include "../../dbobjects/relation.h"
+#include "../../dbobjects/tuple.h"
+#include "../../dbops/db_ops.h"
+#include "../../dbops/scan.h"
+#include "../../dbops/topn.h"
+#include "../../dbparser/dbparser.h"
+#include "../../dbstorage/dbstorage.h"
+#include "../CuTest.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Build an expression that is just the attribute at the given position. */
+static void topn_ut_attr(db_eet_t *eetp, db_uint8 pos) {
+  db_eetnode_attr_t attrnode;
+  attrnode.base.type = DB_EETNODE_ATTR;
+  attrnode.pos = pos;
+  attrnode.tuple_pos = 0;
+
+  eetp->size = sizeof(db_eetnode_attr_t);
+  eetp->nodes = malloc((size_t)eetp->size);
+  eetp->stack_size = eetp->size;
+  *((db_eetnode_attr_t *)eetp->nodes) = attrnode;
+}
+
+/* Run a query and check the values of its first attribute, in order. */
+static void topn_ut_query(CuTest *tc, char *command, char *expectedtree,
+                          db_int *expected, db_int numexpected) {
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  init_query_mm(&mm, segment, size);
+  db_int intResult, i;
+  db_tuple_t t;
+
+  db_op_base_t *rootp = parse(command, &mm);
+  CuAssertTrue(tc, NULL != rootp);
+
+  char *output;
+  queryTreeToString(rootp, &output);
+  puts(output);
+  CuAssertTrue(tc, 0 == strcmp(expectedtree, output));
+  free(output);
+
+  init_tuple(&t, rootp->header->tuple_size, rootp->header->num_attr, &mm);
+  for (i = 0; i < numexpected; ++i) {
+    intResult = next(rootp, &t, &mm);
+    CuAssertTrue(tc, 1 == intResult);
+    intResult = getintbypos(&t, 0, rootp->header);
+    printf("The db_int value at position %d in the returned tuple is: %d\n",
+           0, intResult);
+    CuAssertTrue(tc, expected[i] == intResult);
+  }
+  CuAssertTrue(tc, 0 == next(rootp, &t, &mm));
+
+  close_tuple(&t, &mm);
+  CuAssertTrue(tc, 1 == closeexecutiontree(rootp, &mm));
+}
+
+void test_topn_1(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_uint8 order[] = {DB_TUPLE_ORDER_ASC};
+  db_int intResult, i, j;
+  char *strResult;
+  scan_t scan;
+  topn_t topn;
+  db_tuple_t t;
+  db_int expected[] = {1, 2, 3, 3, 4};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 1: Keep the 5 smallest values of a from shuffled_rel.");
+
+  topn_ut_attr(&eet, 0);
+
+  /* Build up query tree. */
+  init_scan(&scan, "shuffled_rel", &mm);
+  intResult = init_topn(&topn, (db_op_base_t *)&scan, &eet, 1, order, 5, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  CuAssertTrue(tc, DB_TOPN == topn.base.type);
+  CuAssertTrue(tc, 1 == isorderedon((db_op_base_t *)&topn, 0));
+  init_tuple(&t, topn.base.header->tuple_size, topn.base.header->num_attr,
+             &mm);
+
+  /* Carry out test, twice to make sure rewinding works. */
+  for (j = 0; j < 2; ++j) {
+    for (i = 0; i < 5; ++i) {
+      intResult = next((db_op_base_t *)&topn, &t, &mm);
+      CuAssertTrue(tc, 1 == intResult);
+      intResult = getintbypos(&t, 0, topn.base.header);
+      printf("The db_int value at position %d in the returned tuple is: %d\n",
+             0, intResult);
+      CuAssertTrue(tc, expected[i] == intResult);
+    }
+    strResult = getstringbypos(&t, 1, topn.base.header);
+    CuAssertTrue(tc, 0 == strcmp(strResult, "four"));
+
+    intResult = next((db_op_base_t *)&topn, &t, &mm);
+    CuAssertTrue(tc, 0 == intResult);
+    /* Only the tuples returned were ever kept. */
+    CuAssertTrue(tc, 5 == topn.num_records);
+    CuAssertTrue(tc, 1 == rewind_dbop((db_op_base_t *)&topn, &mm));
+  }
+
+  close((db_op_base_t *)&topn, &mm);
+  close_scan(&scan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_2(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_uint8 order[] = {DB_TUPLE_ORDER_DESC};
+  db_int intResult, count, last;
+  scan_t scan;
+  topn_t topn;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 2: Keep more tuples than shuffled_rel has, largest first.");
+
+  topn_ut_attr(&eet, 0);
+
+  /* Build up query tree. */
+  init_scan(&scan, "shuffled_rel", &mm);
+  intResult = init_topn(&topn, (db_op_base_t *)&scan, &eet, 1, order, 25, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, topn.base.header->tuple_size, topn.base.header->num_attr,
+             &mm);
+
+  count = 0;
+  last = 21;
+  while (1 == (intResult = next((db_op_base_t *)&topn, &t, &mm))) {
+    intResult = getintbypos(&t, 0, topn.base.header);
+    CuAssertTrue(tc, intResult <= last);
+    last = intResult;
+    count++;
+  }
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, 20 == count);
+  CuAssertTrue(tc, 1 == last);
+  /* Only ascending orders are known to later operators. */
+  CuAssertTrue(tc, 0 == isorderedon((db_op_base_t *)&topn, 0));
+
+  close((db_op_base_t *)&topn, &mm);
+  close_scan(&scan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_3(CuTest *tc) {
+  /* General variable declaration */
+  db_query_mm_t mm;
+  char segment[2000];
+  init_query_mm(&mm, segment, 2000);
+
+  db_eet_t eet;
+  db_uint8 order[] = {DB_TUPLE_ORDER_ASC};
+  db_int intResult;
+  scan_t scan;
+  topn_t topn;
+  db_tuple_t t;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 3: A limit of 0 returns nothing, and a negative one is refused.");
+
+  topn_ut_attr(&eet, 0);
+
+  /* Build up query tree. */
+  init_scan(&scan, "shuffled_rel", &mm);
+  intResult = init_topn(&topn, (db_op_base_t *)&scan, &eet, 1, order, -1, &mm);
+  CuAssertTrue(tc, -1 == intResult);
+  intResult = init_topn(&topn, (db_op_base_t *)&scan, &eet, 1, order, 0, &mm);
+  CuAssertTrue(tc, 1 == intResult);
+  init_tuple(&t, topn.base.header->tuple_size, topn.base.header->num_attr,
+             &mm);
+
+  intResult = next((db_op_base_t *)&topn, &t, &mm);
+  CuAssertTrue(tc, 0 == intResult);
+  CuAssertTrue(tc, NULL == topn.records);
+
+  close((db_op_base_t *)&topn, &mm);
+  close_scan(&scan, &mm);
+  close_tuple(&t, &mm);
+  free(eet.nodes);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_4(CuTest *tc) {
+  char command[] = "SELECT a FROM shuffled_rel ORDER BY a DESC LIMIT 3;";
+  db_int expected[] = {20, 19, 18};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 4: ORDER BY with a LIMIT becomes a top-N operator.");
+
+  topn_ut_query(tc, command, "+PROJECT\n++TOPN\n+++SELECT\n++++SCAN\n",
+                expected, 3);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_5(CuTest *tc) {
+  char command[] =
+      "SELECT a FROM shuffled_rel WHERE a > 5 ORDER BY a, b LIMIT 4;";
+  db_int expected[] = {6, 7, 8, 9};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 5: A selection ordered on two attributes and limited.");
+
+  topn_ut_query(tc, command, "+PROJECT\n++TOPN\n+++SELECT\n++++SCAN\n",
+                expected, 4);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_6(CuTest *tc) {
+  char command[] = "SELECT a FROM shuffled_rel LIMIT 2;";
+  db_int expected[] = {14, 3};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 6: A LIMIT alone returns the first tuples as they come.");
+
+  topn_ut_query(tc, command, "+PROJECT\n++TOPN\n+++SELECT\n++++SCAN\n",
+                expected, 2);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_7(CuTest *tc) {
+  char command[] = "SELECT a FROM shuffled_rel WHERE a < 5 ORDER BY a DESC;";
+  db_int expected[] = {4, 3, 3, 2, 1};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 7: An ORDER BY alone still sorts every tuple.");
+
+  topn_ut_query(tc, command, "+PROJECT\n++SORT\n+++SELECT\n++++SCAN\n",
+                expected, 5);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_8(CuTest *tc) {
+  char *commands[] = {
+      "SELECT a FROM shuffled_rel LIMIT;",
+      "SELECT a FROM shuffled_rel LIMIT b;",
+      "SELECT a FROM shuffled_rel LIMIT 3 4;",
+      "SELECT a FROM shuffled_rel ORDER a LIMIT 3;",
+      "SELECT a FROM shuffled_rel ORDER BY c LIMIT 3;",
+      "SELECT a FROM shuffled_rel ORDER BY COUNT(a);",
+      "SELECT a FROM shuffled_rel ORDER BY COUNT(a) LIMIT 3;",
+  };
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  db_int i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 8: Bad LIMIT and ORDER BY clauses are refused.");
+
+  for (i = 0; i < (db_int)(sizeof(commands) / sizeof(char *)); ++i) {
+    init_query_mm(&mm, segment, size);
+    puts(commands[i]);
+    CuAssertTrue(tc, NULL == parse(commands[i], &mm));
+  }
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_9(CuTest *tc) {
+  char command[] = "SELECT a FROM shuffled_rel ORDER BY a LIMIT 100;";
+  db_int expected[] = {1,  2,  3,  3,  4,  5,  6,  7,  8,  9,
+                       11, 11, 12, 14, 15, 16, 17, 18, 19, 20};
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 9: A limit larger than the relation only keeps what is there.");
+
+  topn_ut_query(tc, command, "+PROJECT\n++TOPN\n+++SELECT\n++++SCAN\n",
+                expected, 20);
+  puts("***********************************************************************"
+       "*********");
+}
+
+void test_topn_10(CuTest *tc) {
+  int size = 3000;
+  unsigned char segment[size];
+  db_query_mm_t mm;
+  char command[64];
+  db_int expected[200], i;
+
+  puts("***********************************************************************"
+       "*********");
+  puts("Test 10: Relations larger than memory are ordered, with and without "
+       "a limit.");
+
+  init_query_mm(&mm, segment, size);
+  db_fileremove("topn_ut_10");
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("CREATE TABLE topn_ut_10 (a INT, b INT);", &mm));
+  for (i = 0; i < 200; ++i) {
+    init_query_mm(&mm, segment, size);
+    sprintf(command, "INSERT INTO topn_ut_10 VALUES (%d, %d);",
+            (i * 37) % 200, i);
+    CuAssertTrue(tc, DB_PARSER_OP_NONE == parse(command, &mm));
+  }
+  /* Comparing this by subtraction would overflow. */
+  init_query_mm(&mm, segment, size);
+  CuAssertTrue(tc, DB_PARSER_OP_NONE ==
+                       parse("INSERT INTO topn_ut_10 VALUES (-2147483647, 200);",
+                             &mm));
+
+  expected[0] = -2147483647;
+  for (i = 1; i < 200; ++i)
+    expected[i] = i - 1;
+  topn_ut_query(tc, "SELECT a FROM topn_ut_10 ORDER BY a LIMIT 3;",
+                "+PROJECT\n++TOPN\n+++SELECT\n++++SCAN\n", expected, 3);
+
+  /* Too many tuples to keep in a heap, so they are all sorted. */
+  topn_ut_query(tc, "SELECT a FROM topn_ut_10 ORDER BY a LIMIT 190;",
+                "+PROJECT\n++TOPN\n+++SORT\n++++SELECT\n+++++SCAN\n",
+                expected, 190);
+
+  for (i = 0; i < 200; ++i)
+    expected[i] = 199 - i;
+  topn_ut_query(tc, "SELECT a FROM topn_ut_10 WHERE a >= 0 ORDER BY a DESC;",
+                "+PROJECT\n++SORT\n+++SELECT\n++++SCAN\n", expected, 200);
+
+  db_fileremove("topn_ut_10");
+  puts("***********************************************************************"
+       "*********");
+}
+
+CuSuite *DBTopNGetSuite() {
+  CuSuite *suite = CuSuiteNew();
+
+  SUITE_ADD_TEST(suite, test_topn_1);
+  SUITE_ADD_TEST(suite, test_topn_2);
+  SUITE_ADD_TEST(suite, test_topn_3);
+  SUITE_ADD_TEST(suite, test_topn_4);
+  SUITE_ADD_TEST(suite, test_topn_5);
+  SUITE_ADD_TEST(suite, test_topn_6);
+  SUITE_ADD_TEST(suite, test_topn_7);
+  SUITE_ADD_TEST(suite, test_topn_8);
+  SUITE_ADD_TEST(suite, test_topn_9);
+  SUITE_ADD_TEST(suite, test_topn_10);
+
+  return suite;
+}
+
+void runAllTests_topn() {
+  CuString *output = CuStringNew();
+  CuSuite *suite = DBTopNGetSuite();
+
+  CuSuiteRun(suite);
+  CuSuiteSummary(suite, output);
+  CuSuiteDetails(suite, output);
+  printf("%s\n", output->buffer);
+
+  CuSuiteDelete(suite);
+  CuStringDelete(output);
+}
@@ -72,7 +72,7 @@ db_int main(void)
 	attr.tuple_pos = 0;
 	db_filewrite(file, (unsigned char*)(&attr), sizeof(db_eetnode_attr_t));
 	
-	fclose(file);
+	db_fileclose(file);
 	
 	/**** Create DB_IDX_tr3idx ****/
 	db_fileremove("../tests/DB_IDX_tr3idx");
@@ -92,7 +92,7 @@ db_int main(void)
 	longWrite = 2;
 	db_filewrite(file, (unsigned char*)&longWrite, sizeof(long));
 	
-	fclose(file);
+	db_fileclose(file);
 	
 	/**** Create DB_IDXM_fruit_stock_1. ****/ 
 	db_fileremove("../tests/DB_IDXM_fruit_stock_1");
@@ -128,7 +128,7 @@ db_int main(void)
 	attr.tuple_pos = 0;
 	db_filewrite(file, (unsigned char*)(&attr), sizeof(db_eetnode_attr_t));
 	
-	fclose(file);
+	db_fileclose(file);
 	
 	/**** Create DB_IDX_fs1idx ****/
 	db_fileremove("../tests/DB_IDX_fs1idx");
@@ -148,7 +148,7 @@ db_int main(void)
 	longWrite = 5;
 	db_filewrite(file, (unsigned char*)&longWrite, sizeof(long));
 	
-	fclose(file);
+	db_fileclose(file);
 	
 	return 0;
 }
@@ -31,7 +31,7 @@
 db_int main(void) {
   /* General variable declaration. */
   db_query_mm_t mm;
-  int memsegsize = 2048; /* In bytes. */
+  int memsegsize = 4096; /* In bytes. */
   char memseg[memsegsize];
   init_query_mm(&mm, memseg, memsegsize);
 
@@ -149,6 +149,41 @@ db_int main(void) {
     parse(tenattrtable_iqueries[i], &mm);
   }
 
+  /**** Create shuffled_rel (Enough rows to sort in many runs). ****/
+  db_fileremove("shuffled_rel");
+  db_fileremove("../tests/shuffled_rel");
+  char *shuffled_rel_cquery =
+      "CREATE TABLE shuffled_rel (a INT, b STRING(40))";
+  char *shuffled_rel_iqueries[] = {
+      "INSERT INTO shuffled_rel VALUES (14, 'fourteen')",
+      "INSERT INTO shuffled_rel VALUES (3, 'three')",
+      "INSERT INTO shuffled_rel VALUES (19, 'nineteen')",
+      "INSERT INTO shuffled_rel VALUES (7, 'seven')",
+      "INSERT INTO shuffled_rel VALUES (11, 'eleven')",
+      "INSERT INTO shuffled_rel VALUES (3, 'another three')",
+      "INSERT INTO shuffled_rel VALUES (20, 'twenty')",
+      "INSERT INTO shuffled_rel VALUES (1, 'one')",
+      "INSERT INTO shuffled_rel VALUES (16, 'sixteen')",
+      "INSERT INTO shuffled_rel VALUES (9, 'nine')",
+      "INSERT INTO shuffled_rel VALUES (5, 'five')",
+      "INSERT INTO shuffled_rel VALUES (12, 'twelve')",
+      "INSERT INTO shuffled_rel VALUES (18, 'eighteen')",
+      "INSERT INTO shuffled_rel VALUES (2, 'two')",
+      "INSERT INTO shuffled_rel VALUES (15, 'fifteen')",
+      "INSERT INTO shuffled_rel VALUES (8, 'eight')",
+      "INSERT INTO shuffled_rel VALUES (11, 'another eleven')",
+      "INSERT INTO shuffled_rel VALUES (6, 'six')",
+      "INSERT INTO shuffled_rel VALUES (17, 'seventeen')",
+      "INSERT INTO shuffled_rel VALUES (4, 'four')",
+  };
+  init_query_mm(&mm, memseg, memsegsize);
+  parse(shuffled_rel_cquery, &mm);
+  size = sizeof(shuffled_rel_iqueries) / sizeof(char *);
+  for (i = 0; i < size; i++) {
+    init_query_mm(&mm, memseg, memsegsize);
+    parse(shuffled_rel_iqueries[i], &mm);
+  }
+
   /**** Create db_dummy (To be used for queries that do not involve a scan).
    * ****/
   db_fileremove("db_dummy");